@@ -34,6 +34,7 @@
 #include "srsran/phy/phch/pscch.h"
 #include "srsran/phy/phch/pssch.h"
 #include "srsran/phy/phch/sci.h"
+#include "srsran/phy/ue/ue_sl_tx.h"
 #include "srsran/phy/utils/debug.h"
 #include "srsran/phy/utils/vector.h"
 #include "srsran/phy/rf/rf.h"
@@ -49,6 +50,8 @@ static srsran_sl_comm_resource_pool_t sl_comm_resource_pool = {
 };
 
 static uint32_t        mcs_idx       = 4;
+static uint32_t        nof_ues       = 1; // Number of emulated UEs in TM3/4, one subchannel each
+static uint32_t        nof_workers   = 0;
 static uint32_t        prb_start_idx = 0;
 static uint32_t        sf_n_samples  = 0;
 static uint32_t        sf_n_re       = 0;
@@ -81,18 +84,20 @@ static void sig_int_handler(int signo)
 
 void usage(char* prog)
 {
-  printf("Usage: %s [emptv]\n", prog);
+  printf("Usage: %s [emptuvW]\n", prog);
   printf("\t-p nof_prb [Default %d]\n", cell.nof_prb);
   printf("\t-m mcs_idx [Default %d]\n", mcs_idx);
   printf("\t-e extended CP [Default normal]\n");
   printf("\t-t Sidelink transmission mode {1,2,3,4} [Default %d]\n", (cell.tm + 1));
+  printf("\t-u number of emulated UEs, TM3/4 only [Default %d]\n", nof_ues);
+  printf("\t-W number of encoding workers, TM3/4 only [Default %d]\n", nof_workers);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "emptv")) != -1) {
+  while ((opt = getopt(argc, argv, "emptuvW")) != -1) {
     switch (opt) {
       case 'p':
         cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -106,8 +111,14 @@ void parse_args(int argc, char** argv)
       case 't':
         cell.tm = (srsran_sl_tm_t)(strtol(argv[optind], NULL, 10) - 1);
         break;
+      case 'u':
+        nof_ues = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'W':
+        nof_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
-        srsran_verbose++;
+        increase_srsran_verbose_level();
         break;
       default:
         usage(argv[0]);
@@ -187,6 +198,96 @@ void base_free()
   }
 }
 
+/// TM3/4: every emulated UE sends its own SCI and transport block in a different subchannel of the same subframe
+static int run_tm34()
+{
+  int                     ret                    = SRSRAN_ERROR;
+  srsran_ue_sl_tx_t       ue_sl_tx               = {};
+  srsran_ue_sl_tx_grant_t grants[SRSRAN_MAX_PRB] = {};
+  uint8_t*                data[SRSRAN_MAX_PRB]   = {};
+  cf_t*                   tx_buffer              = NULL;
+  uint32_t                nof_samples            = SRSRAN_SF_LEN_PRB(cell.nof_prb);
+  bool                    rf_opened              = false;
+
+  srsran_sl_comm_resource_pool_t pool = {};
+  if (srsran_sl_comm_resource_pool_get_default_config(&pool, cell) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing sl_comm_resource_pool");
+    return SRSRAN_ERROR;
+  }
+  if (nof_ues == 0 || nof_ues > pool.num_sub_channel) {
+    ERROR("Invalid number of UEs %d, there are %d subchannels", nof_ues, pool.num_sub_channel);
+    return SRSRAN_ERROR;
+  }
+
+  tx_buffer = srsran_vec_cf_malloc(nof_samples);
+  if (!tx_buffer) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+
+  srsran_ue_sl_tx_args_t args = {.nof_workers = nof_workers};
+  if (srsran_ue_sl_tx_init(&ue_sl_tx, &cell, &pool, &args, tx_buffer) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing sidelink transmitter");
+    goto clean_exit;
+  }
+
+  if (srsran_rf_open(&rf, "uhd")) {
+    ERROR("Error opening RF device");
+    goto clean_exit;
+  }
+  rf_opened = true;
+
+  for (uint32_t i = 0; i < nof_ues; i++) {
+    grants[i].sub_channel_idx = i;
+    grants[i].L_subCH         = 1;
+    grants[i].mcs_idx         = mcs_idx;
+    grants[i].cyclic_shift    = 3 * (i % 4);
+    grants[i].resource_reserv = 1;
+    grants[i].tb_len          = srsran_ue_sl_tx_get_tb_len(&ue_sl_tx, grants[i].L_subCH, mcs_idx);
+    data[i]                   = srsran_vec_u8_malloc(grants[i].tb_len);
+    if (!data[i]) {
+      ERROR("Error allocating memory");
+      goto clean_exit;
+    }
+    grants[i].tb = data[i];
+  }
+
+  for (uint32_t tti = 0; !go_exit; tti = (tti + 1) % 10240) {
+    for (uint32_t i = 0; i < nof_ues; i++) {
+      for (uint32_t j = 0; j < grants[i].tb_len; j++) {
+        data[i][j] = rand() % 2;
+      }
+    }
+
+    if (srsran_ue_sl_tx_encode(&ue_sl_tx, grants, nof_ues, tti % SRSRAN_NOF_SF_X_FRAME) != SRSRAN_SUCCESS) {
+      ERROR("Error encoding subframe");
+      goto clean_exit;
+    }
+
+    if (srsran_rf_send(&rf, tx_buffer, nof_samples, true) < SRSRAN_SUCCESS) {
+      ERROR("Error transmitting");
+      goto clean_exit;
+    }
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  if (rf_opened) {
+    srsran_rf_close(&rf);
+  }
+  srsran_ue_sl_tx_free(&ue_sl_tx);
+  for (uint32_t i = 0; i < nof_ues && i < SRSRAN_MAX_PRB; i++) {
+    if (data[i]) {
+      free(data[i]);
+    }
+  }
+  if (tx_buffer) {
+    free(tx_buffer);
+  }
+  return ret;
+}
+
 int main(int argc, char** argv)
 {
   int ret = SRSRAN_ERROR;
@@ -196,6 +297,10 @@ int main(int argc, char** argv)
   // 设置信号处理
   signal(SIGINT, sig_int_handler);
 
+  if (cell.tm == SRSRAN_SIDELINK_TM3 || cell.tm == SRSRAN_SIDELINK_TM4) {
+    return run_tm34();
+  }
+
   if (base_init() != SRSRAN_SUCCESS) {
     ERROR("Error in base initialization");
     goto clean_exit;
@@ -275,7 +380,7 @@ int main(int argc, char** argv)
     srsran_ofdm_tx_sf(&fft);
 
     // Transmit
-    if (srsran_rf_send(&rf, sf_buffer, sf_n_samples, true) != SRSRAN_SUCCESS) {
+    if (srsran_rf_send(&rf, sf_buffer, sf_n_samples, true) < SRSRAN_SUCCESS) {
       ERROR("Error transmitting");
       goto clean_exit;
     }
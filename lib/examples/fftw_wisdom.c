@@ -0,0 +1,235 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Generates the FFTW wisdom of the transforms planned by the PHY at start-up, so eNB and UE instances load it instead
+ * of measuring plans. The PHY objects are created for every LTE bandwidth, sidelink transmission mode and NR symbol
+ * size, which plans the same transforms and buffer layouts they plan in operation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srsran/phy/common/phy_common_sl.h"
+#include "srsran/phy/sync/psss.h"
+#include "srsran/phy/sync/ssss.h"
+#include "srsran/srsran.h"
+
+#define NOF_ELEMENTS(x) (sizeof(x) / sizeof((x)[0]))
+
+static const uint32_t lte_prb[]      = {6, 15, 25, 50, 75, 100};
+static const uint32_t nr_symbol_sz[] = {128, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096};
+
+static char* output_file_name = NULL;
+static bool  all_prb          = false;
+static bool  skip_nr          = false;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [oanv]\n", prog);
+  printf("\t-o output wisdom file [Default $HOME/.srsran_fftwisdom]\n");
+  printf("\t-a plan every number of PRB from 6 to %d [Default LTE bandwidths only]\n", SRSRAN_MAX_PRB);
+  printf("\t-n skip NR symbol sizes [Default %s]\n", skip_nr ? "yes" : "no");
+  printf("\t-v srsran_verbose\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "oanv")) != -1) {
+    switch (opt) {
+      case 'o':
+        output_file_name = argv[optind];
+        break;
+      case 'a':
+        all_prb = true;
+        break;
+      case 'n':
+        skip_nr = true;
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static int plan_ofdm(uint32_t nof_prb, uint32_t symbol_sz, srsran_cp_t cp)
+{
+  int               ret    = SRSRAN_ERROR;
+  uint32_t          sf_len = SRSRAN_SF_LEN(symbol_sz);
+  cf_t*             grid   = srsran_vec_cf_malloc(sf_len);
+  cf_t*             time   = srsran_vec_cf_malloc(sf_len);
+  srsran_ofdm_t     tx     = {};
+  srsran_ofdm_t     rx     = {};
+  srsran_ofdm_cfg_t cfg    = {};
+  if (!grid || !time) {
+    perror("malloc");
+    goto clean_exit;
+  }
+
+  cfg.nof_prb    = nof_prb;
+  cfg.cp         = cp;
+  cfg.symbol_sz  = symbol_sz;
+  cfg.in_buffer  = grid;
+  cfg.out_buffer = time;
+  if (srsran_ofdm_tx_init_cfg(&tx, &cfg)) {
+    ERROR("Error initiating OFDM modulator for %d PRB, symbol size %d", nof_prb, symbol_sz);
+    goto clean_exit;
+  }
+
+  cfg.in_buffer  = time;
+  cfg.out_buffer = grid;
+  if (srsran_ofdm_rx_init_cfg(&rx, &cfg)) {
+    ERROR("Error initiating OFDM demodulator for %d PRB, symbol size %d", nof_prb, symbol_sz);
+    goto clean_exit;
+  }
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_ofdm_tx_free(&tx);
+  srsran_ofdm_rx_free(&rx);
+  free(grid);
+  free(time);
+  return ret;
+}
+
+static int plan_dft_precoding()
+{
+  // Batches of PUSCH (both slots) and PSSCH data symbols
+  const uint32_t batches[] = {2 * (SRSRAN_CP_NORM_NSYMB - 1),
+                              2 * (SRSRAN_CP_EXT_NSYMB - 1),
+                              SRSRAN_PSSCH_TM12_NUM_DATA_SYMBOLS,
+                              SRSRAN_PSSCH_TM12_NUM_DATA_SYMBOLS_CP_EXT,
+                              SRSRAN_PSSCH_TM34_NUM_DATA_SYMBOLS};
+
+  for (uint32_t is_tx = 0; is_tx < 2; is_tx++) {
+    srsran_dft_precoding_t q = {};
+    if (srsran_dft_precoding_init(&q, SRSRAN_MAX_PRB, is_tx)) {
+      ERROR("Error initiating DFT precoding");
+      return SRSRAN_ERROR;
+    }
+    for (uint32_t i = 0; i < NOF_ELEMENTS(batches); i++) {
+      if (srsran_dft_precoding_set_batch(&q, batches[i])) {
+        ERROR("Error initiating batched DFT precoding of %d symbols", batches[i]);
+        srsran_dft_precoding_free(&q);
+        return SRSRAN_ERROR;
+      }
+    }
+    srsran_dft_precoding_free(&q);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static int plan_sidelink_sync(uint32_t nof_prb, srsran_cp_t cp)
+{
+  srsran_psss_t psss = {};
+  if (srsran_psss_init(&psss, nof_prb, cp)) {
+    ERROR("Error initiating PSSS for %d PRB", nof_prb);
+    return SRSRAN_ERROR;
+  }
+  srsran_psss_free(&psss);
+
+  for (srsran_sl_tm_t tm = SRSRAN_SIDELINK_TM1; tm <= SRSRAN_SIDELINK_TM4; tm++) {
+    srsran_ssss_t ssss = {};
+    if (srsran_ssss_init(&ssss, nof_prb, cp, tm)) {
+      ERROR("Error initiating SSSS for %d PRB", nof_prb);
+      return SRSRAN_ERROR;
+    }
+    srsran_ssss_free(&ssss);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+static int plan_lte(uint32_t nof_prb)
+{
+  for (srsran_cp_t cp = SRSRAN_CP_NORM; cp <= SRSRAN_CP_EXT; cp++) {
+    if (plan_ofdm(nof_prb, srsran_symbol_sz(nof_prb), cp) || plan_sidelink_sync(nof_prb, cp)) {
+      return SRSRAN_ERROR;
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  struct timeval t[3];
+  uint32_t       nof_plans = 0;
+
+  parse_args(argc, argv);
+
+  gettimeofday(&t[1], NULL);
+
+  // Standard and reduced symbol sizes of the LTE bandwidths
+  for (uint32_t standard = 0; standard < 2; standard++) {
+    srsran_use_standard_symbol_size(standard);
+    for (uint32_t i = 0; i < (all_prb ? SRSRAN_MAX_PRB : NOF_ELEMENTS(lte_prb)); i++) {
+      uint32_t nof_prb = all_prb ? i + 1 : lte_prb[i];
+      if (nof_prb < 6) {
+        continue;
+      }
+      if (plan_lte(nof_prb)) {
+        exit(-1);
+      }
+      printf("LTE %3d PRB, symbol size %4d: done\n", nof_prb, srsran_symbol_sz(nof_prb));
+      nof_plans += srsran_dft_registry_nof_plans();
+      srsran_dft_registry_clear();
+    }
+  }
+
+  if (plan_dft_precoding()) {
+    exit(-1);
+  }
+  nof_plans += srsran_dft_registry_nof_plans();
+  srsran_dft_registry_clear();
+
+  if (!skip_nr) {
+    for (uint32_t i = 0; i < NOF_ELEMENTS(nr_symbol_sz); i++) {
+      if (plan_ofdm(nr_symbol_sz[i] / 16, nr_symbol_sz[i], SRSRAN_CP_NORM)) {
+        exit(-1);
+      }
+      printf("NR symbol size %4d: done\n", nr_symbol_sz[i]);
+      nof_plans += srsran_dft_registry_nof_plans();
+      srsran_dft_registry_clear();
+    }
+  }
+
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+
+  // The wisdom goes only to the requested file, the default one is not overwritten at exit
+  srsran_dft_save_wisdom_at_exit(false);
+  if (srsran_dft_save_wisdom(output_file_name)) {
+    ERROR("Error saving FFTW wisdom to %s", output_file_name ? output_file_name : "the default file");
+    exit(-1);
+  }
+  printf("Planned %d transforms in %.1f s, wisdom saved to %s\n",
+         nof_plans,
+         t[0].tv_sec + t[0].tv_usec * 1e-6,
+         output_file_name ? output_file_name : "$HOME/.srsran_fftwisdom");
+
+  exit(0);
+}
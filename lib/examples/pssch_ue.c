@@ -19,6 +19,7 @@
  *
  */
 
+#include <inttypes.h>
 #include <semaphore.h>
 #include <signal.h>
 #include <stdbool.h>
@@ -36,6 +37,7 @@
 #include "srsran/phy/phch/ra_sl.h"
 #include "srsran/phy/phch/sci.h"
 #include "srsran/phy/rf/rf.h"
+#include "srsran/phy/ue/ue_sl_rx.h"
 #include "srsran/phy/ue/ue_sync.h"
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
@@ -63,6 +65,12 @@ typedef struct {
   // Sidelink specific args
   uint32_t size_sub_channel;
   uint32_t num_sub_channel;
+
+  // Multi-threaded receiver, disabled if 0
+  uint32_t nof_workers;
+
+  // Threads decoding the code blocks of a TB concurrently, disabled if 0
+  uint32_t nof_cb_workers;
 } prog_args_t;
 
 void args_default(prog_args_t* args)
@@ -78,6 +86,8 @@ void args_default(prog_args_t* args)
   args->rf_gain                = 50;
   args->size_sub_channel       = 10;
   args->num_sub_channel        = 5;
+  args->nof_workers            = 0;
+  args->nof_cb_workers         = 0;
 }
 
 static srsran_pscch_t pscch = {}; // Defined global for plotting thread
@@ -148,6 +158,8 @@ void usage(prog_args_t* args, char* prog)
   printf("\t-n num_sub_channel [Default for 50 prbs %d]\n", args->num_sub_channel);
   printf("\t-t Sidelink transmission mode {1,2,3,4} [Default %d]\n", (cell_sl.tm + 1));
   printf("\t-r use_standard_lte_rates [Default %i]\n", args->use_standard_lte_rates);
+  printf("\t-W nof_workers, decode with the multi-threaded receiver if non-zero [Default %d]\n", args->nof_workers);
+  printf("\t-C nof_cb_workers, threads decoding the code blocks of a TB [Default %d]\n", args->nof_cb_workers);
 #ifdef ENABLE_GUI
   printf("\t-w disable plots [Default enabled]\n");
 #endif
@@ -159,7 +171,7 @@ void parse_args(prog_args_t* args, int argc, char** argv)
   int opt;
   args_default(args);
 
-  while ((opt = getopt(argc, argv, "acdimgpvwrxfA")) != -1) {
+  while ((opt = getopt(argc, argv, "acdimgpvwrxfACW")) != -1) {
     switch (opt) {
       case 'a':
         args->rf_args = argv[optind];
@@ -197,6 +209,12 @@ void parse_args(prog_args_t* args, int argc, char** argv)
       case 'r':
         args->use_standard_lte_rates = true;
         break;
+      case 'W':
+        args->nof_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'C':
+        args->nof_cb_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       default:
         usage(args, argv[0]);
         exit(-1);
@@ -208,6 +226,35 @@ void parse_args(prog_args_t* args, int argc, char** argv)
   }
 }
 
+static void sl_rx_write_results(FILE*                       pcap_file,
+                                const srsran_ue_sl_rx_sf_t* sf,
+                                uint32_t*                   num_decoded_sci,
+                                uint32_t*                   num_decoded_tb)
+{
+  char sci_msg[SRSRAN_SCI_MSG_MAX_LEN] = {};
+
+  for (uint32_t i = 0; i < sf->nof_grants; i++) {
+    const srsran_ue_sl_rx_grant_t* grant = &sf->grants[i];
+
+    srsran_sci_info(&grant->sci, sci_msg, sizeof(sci_msg));
+    fprintf(stdout, "%s", sci_msg);
+    (*num_decoded_sci)++;
+
+    if (grant->tb_crc) {
+      (*num_decoded_tb)++;
+      pcap_pack_and_write(pcap_file,
+                          (uint8_t*)grant->tb_packed,
+                          grant->tb_len / 8,
+                          0,
+                          true,
+                          sf->sf_idx,
+                          0x1001,
+                          DIRECTION_UPLINK,
+                          SL_RNTI);
+    }
+  }
+}
+
 #ifndef DISABLE_RF
 int srsran_rf_recv_wrapper(void* h, cf_t* data[SRSRAN_MAX_PORTS], uint32_t nsamples, srsran_timestamp_t* t)
 {
@@ -352,6 +399,10 @@ int main(int argc, char** argv)
     ERROR("Error initializing PSSCH");
     return SRSRAN_ERROR;
   }
+  if (srsran_pssch_set_cb_workers(&pssch, prog_args.nof_cb_workers) != SRSRAN_SUCCESS) {
+    ERROR("Error setting PSSCH code block workers");
+    return SRSRAN_ERROR;
+  }
 
   srsran_chest_sl_cfg_t pssch_chest_sl_cfg = {};
   srsran_chest_sl_t     pssch_chest        = {};
@@ -363,6 +414,19 @@ int main(int argc, char** argv)
   uint8_t tb[SRSRAN_SL_SCH_MAX_TB_LEN]            = {};
   uint8_t packed_tb[SRSRAN_SL_SCH_MAX_TB_LEN / 8] = {};
 
+  // Multi-threaded receiver
+  srsran_ue_sl_rx_t    sl_rx    = {};
+  srsran_ue_sl_rx_sf_t sl_rx_sf = {};
+  if (prog_args.nof_workers > 0) {
+    srsran_ue_sl_rx_args_t sl_rx_args = {};
+    sl_rx_args.nof_workers            = prog_args.nof_workers;
+    sl_rx_args.nof_cb_workers         = prog_args.nof_cb_workers;
+    if (srsran_ue_sl_rx_init(&sl_rx, &cell_sl, &sl_comm_resource_pool, &sl_rx_args) != SRSRAN_SUCCESS) {
+      ERROR("Error initializing sidelink receiver");
+      return SRSRAN_ERROR;
+    }
+  }
+
 #ifndef DISABLE_RF
   srsran_ue_sync_t ue_sync = {};
   if (!prog_args.input_file_name) {
@@ -403,8 +467,10 @@ int main(int argc, char** argv)
   uint32_t pscch_prb_start_idx = 0;
 
   uint32_t current_sf_idx = 0;
+  uint32_t current_tti    = 0; // 10 * SFN + subframe index, the workers key the retransmission soft buffers on it
   if (prog_args.input_file_name) {
     current_sf_idx = prog_args.file_start_sf_idx;
+    current_tti    = current_sf_idx;
   }
 
   while (keep_running) {
@@ -430,112 +496,137 @@ int main(int argc, char** argv)
 
       // update SF index
       current_sf_idx = srsran_ue_sync_get_sfidx(&ue_sync);
+      current_tti    = (srsran_ue_sync_get_sfn(&ue_sync) * SRSRAN_NOF_SF_X_FRAME + current_sf_idx) % 10240;
 #endif // DISABLE_RF
     }
 
+    if (prog_args.nof_workers > 0) {
+      // Collect the subframes already decoded. Replaying a file must not drop subframes, so wait for the oldest one
+      // if all buffers are in use
+      bool wait = prog_args.input_file_name != NULL && srsran_ue_sl_rx_pending(&sl_rx) >= sl_rx.nof_sf_buffers;
+      while (srsran_ue_sl_rx_pop(&sl_rx, &sl_rx_sf, wait) > 0) {
+        sl_rx_write_results(pcap_file, &sl_rx_sf, &num_decoded_sci, &num_decoded_tb);
+        wait = false;
+      }
+
+      // Hand the subframe to the workers
+      srsran_ue_sl_rx_push(&sl_rx, rx_buffer[0], current_tti);
+
+      current_sf_idx = (current_sf_idx + 1) % 10;
+      current_tti    = (current_tti + 1) % 10240;
+      subframe_count++;
+      continue;
+    }
+
     // do FFT (on first port)
     srsran_ofdm_rx_sf(&fft[0]);
 
     for (int sub_channel_idx = 0; sub_channel_idx < sl_comm_resource_pool.num_sub_channel; sub_channel_idx++) {
       pscch_prb_start_idx = sub_channel_idx * sl_comm_resource_pool.size_sub_channel;
 
-      for (uint32_t cyclic_shift = 0; cyclic_shift <= 9; cyclic_shift += 3) {
-        // PSCCH Channel estimation
-        pscch_chest_sl_cfg.cyclic_shift  = cyclic_shift;
-        pscch_chest_sl_cfg.prb_start_idx = pscch_prb_start_idx;
-        srsran_chest_sl_set_cfg(&pscch_chest, pscch_chest_sl_cfg);
-        srsran_chest_sl_ls_estimate_equalize(&pscch_chest, sf_buffer[0], equalized_sf_buffer);
+      // Single pass cyclic shift detection on the PSCCH DMRS, skip the subchannel if none is found
+      int cs = srsran_chest_sl_pscch_detect_cyclic_shift(
+          &pscch_chest, sf_buffer[0], pscch_prb_start_idx, SRSRAN_SL_PSCCH_CS_DETECT_DEFAULT_THRESHOLD);
+      if (cs < 0) {
+        continue;
+      }
+      uint32_t cyclic_shift = (uint32_t)cs;
+      // PSCCH Channel estimation
+      pscch_chest_sl_cfg.cyclic_shift  = cyclic_shift;
+      pscch_chest_sl_cfg.prb_start_idx = pscch_prb_start_idx;
+      srsran_chest_sl_set_cfg(&pscch_chest, pscch_chest_sl_cfg);
+      srsran_chest_sl_ls_estimate_equalize_compact(&pscch_chest, sf_buffer[0], equalized_sf_buffer);
 
-        if (srsran_pscch_decode(&pscch, equalized_sf_buffer, sci_rx, pscch_prb_start_idx) == SRSRAN_SUCCESS) {
-          if (srsran_sci_format1_unpack(&sci, sci_rx) == SRSRAN_SUCCESS) {
-            srsran_sci_info(&sci, sci_msg, sizeof(sci_msg));
-            fprintf(stdout, "%s", sci_msg);
+      if (srsran_pscch_decode_compact(&pscch, equalized_sf_buffer, sci_rx) == SRSRAN_SUCCESS) {
+        if (srsran_sci_format1_unpack(&sci, sci_rx) == SRSRAN_SUCCESS) {
+          srsran_sci_info(&sci, sci_msg, sizeof(sci_msg));
+          fprintf(stdout, "%s", sci_msg);
 
-            num_decoded_sci++;
+          num_decoded_sci++;
 
-            // plot PSCCH
+          // plot PSCCH
 #ifdef ENABLE_GUI
-            if (!prog_args.disable_plots) {
-              sem_post(&plot_sem);
-            }
+          if (!prog_args.disable_plots) {
+            sem_post(&plot_sem);
+          }
 #endif
 
-            // Decode PSSCH
-            uint32_t sub_channel_start_idx = 0;
-            uint32_t L_subCH               = 0;
-            srsran_ra_sl_type0_from_riv(
-                sci.riv, sl_comm_resource_pool.num_sub_channel, &L_subCH, &sub_channel_start_idx);
+          // Decode PSSCH
+          uint32_t sub_channel_start_idx = 0;
+          uint32_t L_subCH               = 0;
+          srsran_ra_sl_type0_from_riv(
+              sci.riv, sl_comm_resource_pool.num_sub_channel, &L_subCH, &sub_channel_start_idx);
 
-            // 3GPP TS 36.213 Section 14.1.1.4C
-            uint32_t pssch_prb_start_idx = (sub_channel_idx * sl_comm_resource_pool.size_sub_channel) +
-                                           pscch.pscch_nof_prb + sl_comm_resource_pool.start_prb_sub_channel;
-            uint32_t nof_prb_pssch = ((L_subCH + sub_channel_idx) * sl_comm_resource_pool.size_sub_channel) -
-                                     pssch_prb_start_idx + sl_comm_resource_pool.start_prb_sub_channel;
+          // 3GPP TS 36.213 Section 14.1.1.4C
+          uint32_t pssch_prb_start_idx = (sub_channel_idx * sl_comm_resource_pool.size_sub_channel) +
+                                         pscch.pscch_nof_prb + sl_comm_resource_pool.start_prb_sub_channel;
+          uint32_t nof_prb_pssch = ((L_subCH + sub_channel_idx) * sl_comm_resource_pool.size_sub_channel) -
+                                   pssch_prb_start_idx + sl_comm_resource_pool.start_prb_sub_channel;
 
-            // make sure PRBs are valid for DFT precoding
-            nof_prb_pssch = srsran_dft_precoding_get_valid_prb(nof_prb_pssch);
+          // make sure PRBs are valid for DFT precoding
+          nof_prb_pssch = srsran_dft_precoding_get_valid_prb(nof_prb_pssch);
 
-            uint32_t N_x_id = 0;
-            for (int j = 0; j < SRSRAN_SCI_CRC_LEN; j++) {
-              N_x_id += pscch.sci_crc[j] * exp2(SRSRAN_SCI_CRC_LEN - 1 - j);
-            }
+          uint32_t N_x_id = 0;
+          for (int j = 0; j < SRSRAN_SCI_CRC_LEN; j++) {
+            N_x_id += pscch.sci_crc[j] * exp2(SRSRAN_SCI_CRC_LEN - 1 - j);
+          }
 
-            uint32_t rv_idx = 0;
-            if (sci.retransmission == true) {
-              rv_idx = 1;
-            }
+          uint32_t rv_idx = 0;
+          if (sci.retransmission == true) {
+            rv_idx = 1;
+          }
 
-            // PSSCH Channel estimation
-            pssch_chest_sl_cfg.N_x_id        = N_x_id;
-            pssch_chest_sl_cfg.sf_idx        = current_sf_idx;
-            pssch_chest_sl_cfg.prb_start_idx = pssch_prb_start_idx;
-            pssch_chest_sl_cfg.nof_prb       = nof_prb_pssch;
-            srsran_chest_sl_set_cfg(&pssch_chest, pssch_chest_sl_cfg);
-            srsran_chest_sl_ls_estimate_equalize(&pssch_chest, sf_buffer[0], equalized_sf_buffer);
-
-            srsran_pssch_cfg_t pssch_cfg = {
-                pssch_prb_start_idx, nof_prb_pssch, N_x_id, sci.mcs_idx, rv_idx, current_sf_idx};
-            if (srsran_pssch_set_cfg(&pssch, pssch_cfg) == SRSRAN_SUCCESS) {
-              if (srsran_pssch_decode(&pssch, equalized_sf_buffer, tb, SRSRAN_SL_SCH_MAX_TB_LEN) == SRSRAN_SUCCESS) {
-                num_decoded_tb++;
-
-                // pack bit sand write to PCAP
-                srsran_bit_pack_vector(tb, packed_tb, pssch.sl_sch_tb_len);
-                pcap_pack_and_write(pcap_file,
-                                    packed_tb,
-                                    pssch.sl_sch_tb_len / 8,
-                                    0,
-                                    true,
-                                    current_sf_idx,
-                                    0x1001,
-                                    DIRECTION_UPLINK,
-                                    SL_RNTI);
+          // PSSCH Channel estimation
+          pssch_chest_sl_cfg.N_x_id        = N_x_id;
+          pssch_chest_sl_cfg.sf_idx        = current_sf_idx;
+          pssch_chest_sl_cfg.prb_start_idx = pssch_prb_start_idx;
+          pssch_chest_sl_cfg.nof_prb       = nof_prb_pssch;
+          srsran_chest_sl_set_cfg(&pssch_chest, pssch_chest_sl_cfg);
+          srsran_chest_sl_ls_estimate_equalize_compact(&pssch_chest, sf_buffer[0], equalized_sf_buffer);
+
+          srsran_pssch_cfg_t pssch_cfg = {
+              pssch_prb_start_idx, nof_prb_pssch, N_x_id, sci.mcs_idx, rv_idx, current_sf_idx, NULL};
+          if (srsran_pssch_set_cfg(&pssch, pssch_cfg) == SRSRAN_SUCCESS) {
+            if (srsran_pssch_decode_compact(&pssch, equalized_sf_buffer, tb, SRSRAN_SL_SCH_MAX_TB_LEN) ==
+                SRSRAN_SUCCESS) {
+              num_decoded_tb++;
+
+              // pack bit sand write to PCAP
+              srsran_bit_pack_vector(tb, packed_tb, pssch.sl_sch_tb_len);
+              pcap_pack_and_write(pcap_file,
+                                  packed_tb,
+                                  pssch.sl_sch_tb_len / 8,
+                                  0,
+                                  true,
+                                  current_sf_idx,
+                                  0x1001,
+                                  DIRECTION_UPLINK,
+                                  SL_RNTI);
 
 #ifdef ENABLE_GUI
-                // plot PSSCH
-                if (!prog_args.disable_plots) {
-                  sem_post(&plot_sem);
-                }
-                if (prog_args.input_file_name) {
-                  printf("Press Enter to continue ...\n");
-                  getchar();
-                }
-#endif
+              // plot PSSCH
+              if (!prog_args.disable_plots) {
+                sem_post(&plot_sem);
+              }
+              if (prog_args.input_file_name) {
+                printf("Press Enter to continue ...\n");
+                getchar();
               }
+#endif
             }
           }
         }
-        if (SRSRAN_VERBOSE_ISDEBUG()) {
-          char filename[64];
-          snprintf(filename,
-                   64,
-                   "pscch_rx_syms_sf%d_shift%d_prbidx%d.bin",
-                   subframe_count,
-                   cyclic_shift,
-                   pscch_prb_start_idx);
-          printf("Saving PSCCH symbols (%d) to %s\n", pscch.E / SRSRAN_PSCCH_QM, filename);
-          srsran_vec_save_file(filename, pscch.mod_symbols, pscch.E / SRSRAN_PSCCH_QM * sizeof(cf_t));
-        }
+      }
+      if (SRSRAN_VERBOSE_ISDEBUG()) {
+        char filename[64];
+        snprintf(filename,
+                 64,
+                 "pscch_rx_syms_sf%d_shift%d_prbidx%d.bin",
+                 subframe_count,
+                 cyclic_shift,
+                 pscch_prb_start_idx);
+        printf("Saving PSCCH symbols (%d) to %s\n", pscch.E / SRSRAN_PSCCH_QM, filename);
+        srsran_vec_save_file(filename, pscch.mod_symbols, pscch.E / SRSRAN_PSCCH_QM * sizeof(cf_t));
       }
     }
 
@@ -544,6 +635,24 @@ int main(int argc, char** argv)
   }
 
 clean_exit:
+  if (prog_args.nof_workers > 0) {
+    while (srsran_ue_sl_rx_pop(&sl_rx, &sl_rx_sf, true) > 0) {
+      sl_rx_write_results(pcap_file, &sl_rx_sf, &num_decoded_sci, &num_decoded_tb);
+    }
+
+    srsran_ue_sl_rx_metrics_t sl_rx_metrics = {};
+    srsran_ue_sl_rx_get_metrics(&sl_rx, &sl_rx_metrics);
+    printf("sl_rx: workers=%d processed=%" PRIu64 " dropped=%" PRIu64 " rate=%.1f sf/s avg_latency=%.1f us "
+           "max_latency=%" PRIu64 " us\n",
+           prog_args.nof_workers,
+           sl_rx_metrics.nof_sf_processed,
+           sl_rx_metrics.nof_sf_dropped,
+           sl_rx_metrics.sf_per_sec,
+           sl_rx_metrics.avg_latency_us,
+           sl_rx_metrics.max_latency_us);
+    srsran_ue_sl_rx_free(&sl_rx);
+  }
+
   printf("num_decoded_sci=%d num_decoded_tb=%d\n", num_decoded_sci, num_decoded_tb);
 
   if (pcap_file != NULL) {
@@ -22,10 +22,13 @@
 #ifndef SRSRAN_ID_MAP_H
 #define SRSRAN_ID_MAP_H
 
+#include "bounded_bitset.h"
 #include "detail/type_storage.h"
 #include "expected.h"
 #include "srsran/support/srsran_assert.h"
 #include <array>
+#include <memory>
+#include <vector>
 
 namespace srsran {
 
@@ -285,6 +288,305 @@ private:
   size_t                                     count = 0;
 };
 
+/**
+ * Operates like static_circular_map, but its capacity is set at runtime. The slots are allocated once, when the capacity
+ * is set, so the address of the stored objects is stable. A bitmap of occupied slots lets the iteration skip 64 empty
+ * slots at a time, so that iterating a large and mostly empty map costs about as much as a small one
+ * @tparam K type of ID/key
+ * @tparam T object being inserted
+ */
+template <typename K, typename T>
+class circular_map
+{
+  static_assert(std::is_integral<K>::value and std::is_unsigned<K>::value, "Map key must be an unsigned integer");
+
+  using obj_t  = std::pair<K, T>;
+  using word_t = uint64_t;
+
+  static const size_t bits_per_word = 8 * sizeof(word_t);
+
+public:
+  using key_type        = K;
+  using mapped_type     = T;
+  using value_type      = std::pair<K, T>;
+  using difference_type = std::ptrdiff_t;
+
+  class iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = std::pair<K, T>;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = value_type*;
+    using reference         = value_type&;
+
+    iterator() = default;
+    iterator(circular_map<K, T>* map, size_t idx_) : ptr(map), idx(map->next_present_idx(idx_)) {}
+
+    iterator& operator++()
+    {
+      idx = ptr->next_present_idx(idx + 1);
+      return *this;
+    }
+
+    obj_t& operator*()
+    {
+      srsran_assert(idx < ptr->nof_slots, "Iterator out-of-bounds (%zd >= %zd)", idx, ptr->nof_slots);
+      return ptr->get_obj_(idx);
+    }
+    obj_t* operator->()
+    {
+      srsran_assert(idx < ptr->nof_slots, "Iterator out-of-bounds (%zd >= %zd)", idx, ptr->nof_slots);
+      return &ptr->get_obj_(idx);
+    }
+    const obj_t* operator*() const
+    {
+      srsran_assert(idx < ptr->nof_slots, "Iterator out-of-bounds (%zd >= %zd)", idx, ptr->nof_slots);
+      return &ptr->get_obj_(idx);
+    }
+    const obj_t* operator->() const
+    {
+      srsran_assert(idx < ptr->nof_slots, "Iterator out-of-bounds (%zd >= %zd)", idx, ptr->nof_slots);
+      return &ptr->get_obj_(idx);
+    }
+
+    bool operator==(const iterator& other) const { return ptr == other.ptr and idx == other.idx; }
+    bool operator!=(const iterator& other) const { return not(*this == other); }
+
+  private:
+    friend class circular_map<K, T>;
+    circular_map<K, T>* ptr = nullptr;
+    size_t              idx = 0;
+  };
+  class const_iterator
+  {
+  public:
+    const_iterator() = default;
+    const_iterator(const circular_map<K, T>* map, size_t idx_) : ptr(map), idx(map->next_present_idx(idx_)) {}
+
+    const_iterator& operator++()
+    {
+      idx = ptr->next_present_idx(idx + 1);
+      return *this;
+    }
+
+    const obj_t* operator*() const { return &ptr->get_obj_(idx); }
+    const obj_t* operator->() const { return &ptr->get_obj_(idx); }
+
+    bool operator==(const const_iterator& other) const { return ptr == other.ptr and idx == other.idx; }
+    bool operator!=(const const_iterator& other) const { return not(*this == other); }
+
+  private:
+    friend class circular_map<K, T>;
+    const circular_map<K, T>* ptr = nullptr;
+    size_t                    idx = 0;
+  };
+
+  explicit circular_map(size_t max_size = 0) { set_capacity(max_size); }
+  circular_map(const circular_map<K, T>& other)
+  {
+    set_capacity(other.max_nof_elems);
+    for (const_iterator it = other.begin(); it != other.end(); ++it) {
+      insert((*it)->first, (*it)->second);
+    }
+  }
+  circular_map(circular_map<K, T>&& other) noexcept { swap(other); }
+  ~circular_map() { clear(); }
+  circular_map& operator=(const circular_map<K, T>& other)
+  {
+    if (this != &other) {
+      circular_map<K, T> tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+  circular_map& operator=(circular_map<K, T>&& other) noexcept
+  {
+    swap(other);
+    other.clear();
+    return *this;
+  }
+
+  /**
+   * Sets the maximum number of elements of the map, which must be empty. The number of slots is the next power of two,
+   * so that the slot of a key is a bit mask away
+   */
+  void set_capacity(size_t max_size)
+  {
+    srsran_assert(empty(), "The capacity of a non-empty circular map cannot be changed");
+    nof_slots = 0;
+    if (max_size > 0) {
+      nof_slots = 1;
+      while (nof_slots < max_size) {
+        nof_slots <<= 1U;
+      }
+    }
+    mask          = nof_slots > 0 ? nof_slots - 1 : 0;
+    max_nof_elems = max_size;
+    buffer.reset(nof_slots > 0 ? new detail::type_storage<obj_t>[nof_slots] : nullptr);
+    present.assign((nof_slots + bits_per_word - 1) / bits_per_word, 0);
+  }
+
+  bool contains(K id) const
+  {
+    size_t idx = id & mask;
+    return is_present(idx) and get_obj_(idx).first == id;
+  }
+
+  bool insert(K id, const T& obj)
+  {
+    srsran_assert(nof_slots > 0, "Inserting in a circular map whose capacity was not set");
+    size_t idx = id & mask;
+    if (full() or is_present(idx)) {
+      return false;
+    }
+    buffer[idx].template emplace(id, obj);
+    set_present(idx, true);
+    count++;
+    return true;
+  }
+  srsran::expected<iterator, T> insert(K id, T&& obj)
+  {
+    srsran_assert(nof_slots > 0, "Inserting in a circular map whose capacity was not set");
+    size_t idx = id & mask;
+    if (full() or is_present(idx)) {
+      return srsran::expected<iterator, T>(std::move(obj));
+    }
+    buffer[idx].template emplace(id, std::move(obj));
+    set_present(idx, true);
+    count++;
+    return iterator(this, idx);
+  }
+
+  template <typename U>
+  void overwrite(K id, U&& obj)
+  {
+    size_t idx = id & mask;
+    if (is_present(idx)) {
+      erase(buffer[idx].get().first);
+    }
+    insert(id, std::forward<U>(obj));
+  }
+
+  bool erase(K id)
+  {
+    if (not contains(id)) {
+      return false;
+    }
+    size_t idx = id & mask;
+    get_obj_(idx).~obj_t();
+    set_present(idx, false);
+    --count;
+    return true;
+  }
+
+  iterator erase(iterator it)
+  {
+    srsran_assert(it.idx < nof_slots and it.ptr == this, "Iterator out-of-bounds (%zd >= %zd)", it.idx, nof_slots);
+    iterator next = it;
+    ++next;
+    set_present(it.idx, false);
+    get_obj_(it.idx).~obj_t();
+    --count;
+    return next;
+  }
+
+  void clear()
+  {
+    for (size_t i = next_present_idx(0); i < nof_slots; i = next_present_idx(i + 1)) {
+      set_present(i, false);
+      get_obj_(i).~obj_t();
+    }
+    count = 0;
+  }
+
+  T& operator[](K id)
+  {
+    srsran_assert(contains(id), "Accessing non-existent ID=%zd", (size_t)id);
+    return get_obj_(id & mask).second;
+  }
+  const T& operator[](K id) const
+  {
+    srsran_assert(contains(id), "Accessing non-existent ID=%zd", (size_t)id);
+    return get_obj_(id & mask).second;
+  }
+
+  size_t size() const { return count; }
+  bool   empty() const { return count == 0; }
+  bool   full() const { return count >= max_nof_elems; }
+  bool   has_space(K id) { return not full() and not is_present(id & mask); }
+  size_t capacity() const { return max_nof_elems; }
+
+  iterator       begin() { return iterator(this, 0); }
+  iterator       end() { return iterator(this, nof_slots); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, nof_slots); }
+
+  iterator find(K id)
+  {
+    if (contains(id)) {
+      return iterator(this, id & mask);
+    }
+    return end();
+  }
+  const_iterator find(K id) const
+  {
+    if (contains(id)) {
+      return const_iterator(this, id & mask);
+    }
+    return end();
+  }
+
+private:
+  obj_t&       get_obj_(size_t idx) { return buffer[idx].get(); }
+  const obj_t& get_obj_(size_t idx) const { return buffer[idx].get(); }
+
+  bool is_present(size_t idx) const
+  {
+    return nof_slots > 0 and ((present[idx / bits_per_word] >> (idx % bits_per_word)) & 1U) != 0;
+  }
+  void set_present(size_t idx, bool val)
+  {
+    word_t& word = present[idx / bits_per_word];
+    word_t  bit  = static_cast<word_t>(1U) << (idx % bits_per_word);
+    word         = val ? (word | bit) : (word & ~bit);
+  }
+
+  /// Finds the first occupied slot starting from idx, or returns the number of slots if there is none
+  size_t next_present_idx(size_t idx) const
+  {
+    size_t w = idx / bits_per_word;
+    if (w >= present.size()) {
+      return nof_slots;
+    }
+    word_t bits = present[w] & (~static_cast<word_t>(0) << (idx % bits_per_word));
+    while (bits == 0) {
+      if (++w == present.size()) {
+        return nof_slots;
+      }
+      bits = present[w];
+    }
+    return w * bits_per_word + find_first_lsb_one(bits);
+  }
+
+  void swap(circular_map<K, T>& other) noexcept
+  {
+    std::swap(buffer, other.buffer);
+    std::swap(present, other.present);
+    std::swap(nof_slots, other.nof_slots);
+    std::swap(mask, other.mask);
+    std::swap(max_nof_elems, other.max_nof_elems);
+    std::swap(count, other.count);
+  }
+
+  std::unique_ptr<detail::type_storage<obj_t>[]> buffer;
+  std::vector<word_t>                            present;
+  size_t                                         nof_slots     = 0;
+  size_t                                         mask          = 0;
+  size_t                                         max_nof_elems = 0;
+  size_t                                         count         = 0;
+};
+
 /**
  * Operates like a circular map, but automatically assigns the ID/key to inserted objects in a monotonically
  * increasing way. The assigned IDs are not necessarily contiguous, as they are selected based on the available slots
@@ -331,6 +633,52 @@ private:
   K next_id = 0;
 };
 
+/**
+ * Same as static_id_obj_pool, but with a capacity set at runtime. The capacity must be set before the first insertion
+ * @tparam K type of ID/key
+ * @tparam T object being inserted
+ */
+template <typename K, typename T>
+class id_obj_pool : private circular_map<K, T>
+{
+  using base_t = circular_map<K, T>;
+
+public:
+  using iterator       = typename base_t::iterator;
+  using const_iterator = typename base_t::const_iterator;
+
+  using base_t::operator[];
+  using base_t::begin;
+  using base_t::capacity;
+  using base_t::contains;
+  using base_t::empty;
+  using base_t::end;
+  using base_t::erase;
+  using base_t::find;
+  using base_t::full;
+  using base_t::set_capacity;
+  using base_t::size;
+
+  explicit id_obj_pool(K first_id = 0) : next_id(first_id) {}
+
+  template <typename U>
+  srsran::expected<K> insert(U&& t)
+  {
+    srsran_assert(capacity() > 0, "Inserting in an id_obj_pool whose capacity was not set");
+    if (full()) {
+      return srsran::default_error_t{};
+    }
+    while (not base_t::has_space(next_id)) {
+      ++next_id;
+    }
+    base_t::insert(next_id, std::forward<U>(t));
+    return next_id++;
+  }
+
+private:
+  K next_id = 0;
+};
+
 } // namespace srsran
 
 #endif // SRSRAN_ID_MAP_H
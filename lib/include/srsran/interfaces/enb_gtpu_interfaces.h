@@ -22,6 +22,7 @@
 #ifndef SRSRAN_ENB_GTPU_INTERFACES_H
 #define SRSRAN_ENB_GTPU_INTERFACES_H
 
+#include "srsenb/hdr/common/common_enb.h"
 #include "srsran/adt/expected.h"
 #include "srsran/common/byte_buffer.h"
 
@@ -34,6 +35,7 @@ struct gtpu_args_t {
   std::string embms_m1u_if_addr;
   bool        embms_enable                 = false;
   uint32_t    indirect_tunnel_timeout_msec = 0;
+  uint32_t    max_nof_ues                  = SRSENB_MAX_UES;
 };
 
 // GTPU interface for PDCP
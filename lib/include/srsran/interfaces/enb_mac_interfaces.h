@@ -78,9 +78,10 @@ public:
     srsran_dci_ul_t         dci;
     uint32_t                pid;
     uint32_t                current_tx_nb;
-    uint8_t*                data;
+    uint8_t*                data; ///< Set to nullptr for PDCCH-only grants (e.g. UL SPS release)
     bool                    needs_pdcch;
     srsran_softbuffer_rx_t* softbuffer_rx;
+    uint16_t                sps_crnti; ///< If not zero, the PUSCH and its PDCCH use the SPS C-RNTI instead of dci.rnti
   } ul_sched_grant_t;
 
   /**
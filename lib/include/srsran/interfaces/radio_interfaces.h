@@ -136,6 +136,28 @@ public:
    */
   virtual bool rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time) = 0;
 
+  /**
+   * Indicates whether rx_now_sc16() can receive the samples as 16-bit integers, as the RF devices deliver them. Radios
+   * without integer reception do not need to override it
+   *
+   * @return true if the integer samples can be received, otherwise false
+   */
+  virtual bool has_rx_sc16() { return false; }
+
+  /**
+   * Same as rx_now() without converting the received samples to float. Each channel buffer holds 2 * nof_samples
+   * interleaved int16_t IQ components instead of cf_t samples
+   *
+   * @param buffer Is the object where the samples will be stored
+   * @param rxd_time Time at which the samples were received. Note the time is the same for all carriers
+   * @param scale Integer value of the unitary amplitude of each channel, including the RX gain (write only)
+   * @return it returns true if the reception was successful, otherwise it returns false
+   */
+  virtual bool rx_now_sc16(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time, float* scale)
+  {
+    return false;
+  }
+
   /**
    * Sets the TX frequency for all antennas in the provided carrier index
    * @param carrier_idx Index of the carrier to change the frequency
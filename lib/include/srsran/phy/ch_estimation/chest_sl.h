@@ -36,6 +36,10 @@
 #define SRSRAN_SL_BASE_SEQUENCE_NUMBER 0
 #define SRSRAN_SL_MAX_DMRS_PERIOD_LENGTH 320
 
+// PSCCH cyclic shift detection, see srsran_chest_sl_pscch_detect_cyclic_shift()
+#define SRSRAN_SL_PSCCH_CS_DETECT_WINDOW 4
+#define SRSRAN_SL_PSCCH_CS_DETECT_DEFAULT_THRESHOLD (0.5f)
+
 typedef struct SRSRAN_API {
   uint32_t prb_start_idx; // PRB start idx to map RE from RIV
   uint32_t nof_prb;       // PSSCH nof_prb, Length of continuous PRB to map RE (in the pool) from RIV
@@ -83,6 +87,8 @@ typedef struct SRSRAN_API {
   float sync_err;
   float rsrp_corr;
 
+  float cyclic_shift_metric; ///< Normalized DMRS metric of the last PSCCH cyclic shift detection
+
 } srsran_chest_sl_t;
 
 SRSRAN_API int srsran_chest_sl_init(srsran_chest_sl_t*                    q,
@@ -110,6 +116,37 @@ SRSRAN_API void srsran_chest_sl_ls_equalize(srsran_chest_sl_t* q, cf_t* sf_buffe
 
 SRSRAN_API void srsran_chest_sl_ls_estimate_equalize(srsran_chest_sl_t* q, cf_t* sf_buffer, cf_t* equalized_sf_buffer);
 
+/**
+ * @brief Detects the PSCCH DMRS cyclic shift at prb_start_idx from a single pass over the received DMRS, instead of
+ * running a full estimation and decoding for each of them. The metric of every cyclic shift available for the cell
+ * transmission mode is normalized by the DMRS energy, so 1 is a noiseless DMRS and 1/SRSRAN_SL_PSCCH_CS_DETECT_WINDOW
+ * is noise only. The best metric is kept in cyclic_shift_metric.
+ *
+ * @param threshold Minimum metric to consider the subchannel occupied, e.g. SRSRAN_SL_PSCCH_CS_DETECT_DEFAULT_THRESHOLD
+ * @return The detected cyclic shift {0, 3, 6, 9}, SRSRAN_ERROR if the metric is below the threshold
+ */
+SRSRAN_API int srsran_chest_sl_pscch_detect_cyclic_shift(srsran_chest_sl_t* q,
+                                                         cf_t*              sf_buffer,
+                                                         uint32_t           prb_start_idx,
+                                                         float              threshold);
+
+/**
+ * @brief Equalizes only the data REs allocated to the configured channel (PRB range from srsran_chest_sl_cfg_t) and
+ * writes them into a compact buffer, data symbol after data symbol, in the same order they are extracted by
+ * srsran_pscch_get() and srsran_pssch_get(). The result can be passed to srsran_pscch_decode_compact() and
+ * srsran_pssch_decode_compact(). Requires a previous estimation.
+ *
+ * @return Number of REs written, or a negative error code
+ */
+SRSRAN_API int srsran_chest_sl_ls_equalize_compact(srsran_chest_sl_t* q, cf_t* sf_buffer, cf_t* equalized_syms);
+
+/**
+ * @brief Same as srsran_chest_sl_ls_equalize_compact(), but also runs the least-squares estimation. Channel estimates
+ * outside the allocated PRBs are neither computed nor cleared.
+ */
+SRSRAN_API int
+srsran_chest_sl_ls_estimate_equalize_compact(srsran_chest_sl_t* q, cf_t* sf_buffer, cf_t* equalized_syms);
+
 SRSRAN_API void srsran_chest_sl_free(srsran_chest_sl_t* q);
 
 #endif
\ No newline at end of file
@@ -55,12 +55,11 @@ typedef struct {
   cf_t* h_tap[SRSRAN_CHANNEL_FADING_MAXTAPS]; // Static tap signal in frequency domain
 
   // Utils
-  srsran_dft_plan_t fft;             // DFT to frequency domain
-  srsran_dft_plan_t ifft;            // DFT to time domain
-  cf_t*             temp;            // Temporal buffer, length fft_size
-  cf_t*             h_freq;          // Channel frequency response, length fft_size
-  cf_t*             y_freq;          // Intermediate frequency domain buffer
-  float             sin_table[1024]; // Table of sinus values
+  srsran_dft_plan_t fft;    // DFT to frequency domain
+  srsran_dft_plan_t ifft;   // DFT to time domain
+  cf_t*             temp;   // Temporal buffer, length fft_size
+  cf_t*             h_freq; // Channel frequency response, length fft_size
+  cf_t*             y_freq; // Intermediate frequency domain buffer
 
   // State variables
   cf_t* state; // To save impulse response of the filter
@@ -74,6 +73,18 @@ SRSRAN_API int srsran_channel_fading_init(srsran_channel_fading_t* q, double sra
 
 SRSRAN_API void srsran_channel_fading_free(srsran_channel_fading_t* q);
 
+/**
+ * Changes the maximum Doppler frequency of the model, keeping the fading realization and the filter state. Used to
+ * follow the relative speed of a moving transmitter.
+ */
+SRSRAN_API void srsran_channel_fading_set_doppler(srsran_channel_fading_t* q, float doppler_hz);
+
+/**
+ * Latency in samples that the fading filter adds to the signal for a model and sampling rate, or 0 if the model is
+ * invalid. It is the path delay of an object initiated with the same parameters.
+ */
+SRSRAN_API uint32_t srsran_channel_fading_latency(double srate, const char* model);
+
 SRSRAN_API double srsran_channel_fading_execute(srsran_channel_fading_t* q,
                                                 const cf_t*              in,
                                                 cf_t*                    out,
@@ -0,0 +1,158 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**
+ *  \file multilink.h
+ *  \brief Multi-link channel emulator, mixing the signals of several transmitters into one receive stream
+ *
+ * Each link models a transmitter seen by the receiver, typically a vehicle for sidelink (V2X) testing, with its own
+ * path loss, propagation delay, relative speed and fading realization. The relative speed sets the maximum Doppler
+ * frequency of the fading model, or the Doppler shift of a line-of-sight link without fading.
+ */
+
+#ifndef SRSRAN_MULTILINK_H
+#define SRSRAN_MULTILINK_H
+
+#include "srsran/config.h"
+#include "srsran/phy/channel/ch_awgn.h"
+#include "srsran/phy/channel/fading.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * \brief Link configuration
+ */
+typedef struct {
+  float       path_loss_db; // Attenuation of the link in dB
+  float       delay_us;     // Propagation delay in microseconds, up to the maximum given at initialization
+  float       speed_kmh;    // Relative speed, positive when the transmitter approaches the receiver
+  float       cfo_hz;       // Additional frequency offset, for instance between the oscillators of both ends
+  const char* model;        // Fading model without Doppler (none, epa, eva, etu), NULL for a line-of-sight link
+  uint32_t    seed;         // Seed of the fading realization
+} srsran_channel_multilink_cfg_t;
+
+typedef struct {
+  bool                    enabled;
+  bool                    fading_enabled;
+  srsran_channel_fading_t fading;
+  float                   cfo_hz;         // Configured frequency offset
+  float                   gain;           // Linear amplitude gain
+  float                   freq_norm;      // Frequency shift normalized to the sampling rate
+  cf_t                    phase;          // Phase of the frequency shift for the next sample
+  uint32_t                delay_nsamples; // Delay line length, including the fading latency compensation
+  cf_t*                   delay_state;    // Last delay_nsamples input samples
+} srsran_channel_multilink_link_t;
+
+typedef struct {
+  double   srate;
+  double   carrier_freq_hz;
+  uint32_t max_links;
+  uint32_t max_nsamples;
+  uint32_t max_delay_nsamples;
+  uint32_t latency; // Samples of latency common to all links
+  double   time;    // Time of the next sample, drives the fading models
+
+  srsran_channel_multilink_link_t* links;
+
+  bool                  awgn_enabled;
+  srsran_channel_awgn_t awgn;
+
+  cf_t* zeros;     // Input of the links without signal
+  cf_t* delay_buf; // Delay state followed by the input, length max_delay_nsamples + max_nsamples
+  cf_t* link_buf;  // Output of the link before the gain
+  cf_t* phase_buf; // Gain and frequency shift of each sample
+} srsran_channel_multilink_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Initializes the emulator. All links start disabled
+ *
+ * @param q Emulator object
+ * @param srate Sampling rate in Hz
+ * @param carrier_freq_hz Carrier frequency, converts the relative speed of the links to Doppler frequency
+ * @param max_links Maximum number of links
+ * @param max_nsamples Maximum number of samples per execution
+ * @param max_delay_us Maximum propagation delay of the links
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_channel_multilink_init(srsran_channel_multilink_t* q,
+                                             double                      srate,
+                                             double                      carrier_freq_hz,
+                                             uint32_t                    max_links,
+                                             uint32_t                    max_nsamples,
+                                             float                       max_delay_us);
+
+SRSRAN_API void srsran_channel_multilink_free(srsran_channel_multilink_t* q);
+
+/**
+ * \brief Enables a link with a new configuration, starting a new fading realization and an empty delay line
+ *
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_channel_multilink_set_link(srsran_channel_multilink_t*           q,
+                                                 uint32_t                              link,
+                                                 const srsran_channel_multilink_cfg_t* cfg);
+
+/**
+ * \brief Updates the path loss, delay and relative speed of an enabled link as the transmitter moves. The fading
+ * realization and the signal in the delay line are kept, a longer delay inserts zeros and a shorter one drops samples
+ *
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_channel_multilink_set_geometry(srsran_channel_multilink_t* q,
+                                                     uint32_t                    link,
+                                                     float                       path_loss_db,
+                                                     float                       delay_us,
+                                                     float                       speed_kmh);
+
+SRSRAN_API void srsran_channel_multilink_disable_link(srsran_channel_multilink_t* q, uint32_t link);
+
+/**
+ * \brief Sets the noise level added to the mixed signal, in dBfs. A non-finite level disables the noise
+ */
+SRSRAN_API int srsran_channel_multilink_set_n0(srsran_channel_multilink_t* q, float n0_dBfs);
+
+/**
+ * \brief Latency in samples common to all links. It compensates the latency of the fading filters so that every link
+ * is delayed by the configured delay plus this value, whatever its model
+ */
+SRSRAN_API uint32_t srsran_channel_multilink_latency(const srsran_channel_multilink_t* q);
+
+/**
+ * \brief Runs the links on a block of samples and mixes them
+ *
+ * @param q Emulator object
+ * @param in Signal of each transmitter, max_links entries. Links with a NULL signal transmit zeros
+ * @param out Mixed signal
+ * @param nsamples Number of samples, up to max_nsamples
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int
+srsran_channel_multilink_execute(srsran_channel_multilink_t* q, const cf_t* in[], cf_t* out, uint32_t nsamples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSRAN_MULTILINK_H
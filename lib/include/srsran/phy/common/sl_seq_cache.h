@@ -0,0 +1,90 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**********************************************************************************************
+ *  File:         sl_seq_cache.h
+ *
+ *  Description:  Process-wide LRU caches of the PSSCH scrambling sequences and PSSCH DMRS
+ *                sequences. Both only depend on N_X_ID (the SCI CRC), the subframe index and
+ *                the allocation size, so repeated transmissions from the same UE become table
+ *                lookups instead of sequence generation. The caches are shared by all PSSCH
+ *                and channel estimation objects and are thread-safe.
+ *
+ *  Reference:    3GPP TS 36.211 version 15.6.0 Release 15 Sec. 9.3.1 and 9.8
+ *********************************************************************************************/
+
+#ifndef SRSRAN_SL_SEQ_CACHE_H
+#define SRSRAN_SL_SEQ_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "srsran/config.h"
+#include "srsran/phy/common/phy_common_sl.h"
+#include "srsran/phy/common/sequence.h"
+
+#define SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES 64
+
+typedef struct SRSRAN_API {
+  uint64_t nof_hits;
+  uint64_t nof_misses;
+  uint64_t nof_evictions;
+} srsran_sl_seq_cache_stats_t;
+
+/**
+ * @brief Returns the PSSCH scrambling sequence for N_x_id and sf_idx with at least len bits, generating it if it is
+ * not cached. The sequence is pinned in the cache until it is released with srsran_sl_seq_cache_scrambling_release()
+ * and must not be modified.
+ *
+ * @return The sequence, or NULL if every entry is pinned and the caller has to generate the sequence itself
+ */
+SRSRAN_API srsran_sequence_t* srsran_sl_seq_cache_scrambling_acquire(uint32_t N_x_id, uint32_t sf_idx, uint32_t len);
+
+SRSRAN_API void srsran_sl_seq_cache_scrambling_release(srsran_sequence_t* seq);
+
+/**
+ * @brief Copies the cached PSSCH DMRS sequences of nof_prb * SRSRAN_NRE samples for every DMRS symbol into r_sequence.
+ * For TM1/2 the sequences do not depend on the subframe and sf_idx is ignored.
+ *
+ * @return true on a hit, false if the sequences are not cached
+ */
+SRSRAN_API bool srsran_sl_seq_cache_dmrs_get(srsran_sl_tm_t tm,
+                                             uint32_t       N_x_id,
+                                             uint32_t       sf_idx,
+                                             uint32_t       nof_prb,
+                                             uint32_t       nof_dmrs_symbols,
+                                             cf_t**         r_sequence);
+
+/// Stores freshly generated PSSCH DMRS sequences, evicting the least recently used entry if the cache is full
+SRSRAN_API void srsran_sl_seq_cache_dmrs_put(srsran_sl_tm_t tm,
+                                             uint32_t       N_x_id,
+                                             uint32_t       sf_idx,
+                                             uint32_t       nof_prb,
+                                             uint32_t       nof_dmrs_symbols,
+                                             cf_t**         r_sequence);
+
+SRSRAN_API void srsran_sl_seq_cache_get_stats(srsran_sl_seq_cache_stats_t* scrambling,
+                                              srsran_sl_seq_cache_stats_t* dmrs);
+
+/// Frees all entries that are not pinned and resets the statistics
+SRSRAN_API void srsran_sl_seq_cache_clear(void);
+
+#endif // SRSRAN_SL_SEQ_CACHE_H
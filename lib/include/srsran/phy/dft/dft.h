@@ -24,6 +24,7 @@
 
 #include "srsran/config.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /**********************************************************************************************
  *  File:         dft.h
@@ -40,6 +41,10 @@
  *                norm   - Normalizes output (by sqrt(len) for complex, len for real).
  *                dc     - Handles insertion and removal of null DC carrier internally.
  *
+ *                FFTW plans are kept in a process-wide registry and shared by all the plans
+ *                with the same transform and buffer layout, each one running on its own
+ *                buffers. Plans no longer used stay in the registry for later objects.
+ *
  *  Reference:
  *********************************************************************************************/
 
@@ -122,8 +127,40 @@ SRSRAN_API void srsran_dft_run_c(srsran_dft_plan_t* plan, const cf_t* in, cf_t*
 
 SRSRAN_API void srsran_dft_run_guru_c(srsran_dft_plan_t* plan);
 
+/**
+ * @brief Runs a guru plan on other buffers than the ones it was created with. They must have the same layout, and the
+ * same alignment as the planned ones. They must be the same buffer if and only if the planned ones were.
+ * @return SRSRAN_SUCCESS, or SRSRAN_ERROR if the buffers can not be used with the plan
+ */
+SRSRAN_API int srsran_dft_run_guru_buffers_c(srsran_dft_plan_t* plan, const cf_t* in, cf_t* out);
+
 SRSRAN_API void srsran_dft_run_r(srsran_dft_plan_t* plan, const float* in, float* out);
 
+/* Plan registry and wisdom */
+
+/**
+ * @brief Number of FFTW plans in the registry, used or kept for later objects
+ */
+SRSRAN_API uint32_t srsran_dft_registry_nof_plans();
+
+/**
+ * @brief Destroys the FFTW plans of the registry that no DFT plan uses
+ */
+SRSRAN_API void srsran_dft_registry_clear();
+
+/**
+ * @brief Saves the FFTW wisdom of the plans created so far. It is also saved to the default file at exit, unless
+ *        disabled with srsran_dft_save_wisdom_at_exit()
+ * @param path Wisdom file, NULL for the default $HOME/.srsran_fftwisdom
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_dft_save_wisdom(const char* path);
+
+/**
+ * @brief Enables or disables saving the FFTW wisdom to the default file at exit. Enabled by default
+ */
+SRSRAN_API void srsran_dft_save_wisdom_at_exit(bool enable);
+
 #ifdef __cplusplus
 }
 #endif
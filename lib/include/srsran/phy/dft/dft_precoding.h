@@ -41,6 +41,12 @@ typedef struct SRSRAN_API {
   uint32_t          max_prb;
   srsran_dft_plan_t dft_plan[SRSRAN_MAX_PRB + 1];
 
+  // Batched transform of all the symbols at once, one guru plan per number of PRB
+  uint32_t          batch_nof_symbols;
+  srsran_dft_plan_t batch_plan[SRSRAN_MAX_PRB + 1];
+  cf_t*             batch_in;  // Buffers the batch plans are created with
+  cf_t*             batch_out; // Also holds the transform of in-place calls before normalising
+
 } srsran_dft_precoding_t;
 
 SRSRAN_API int srsran_dft_precoding_init(srsran_dft_precoding_t* q, uint32_t max_prb, bool is_tx);
@@ -55,6 +61,19 @@ SRSRAN_API bool srsran_dft_precoding_valid_prb(uint32_t nof_prb);
 
 SRSRAN_API uint32_t srsran_dft_precoding_get_valid_prb(uint32_t nof_prb);
 
+/**
+ * @brief Creates the plans that transform nof_symbols symbols in a single call, for every valid number of PRB. Calls
+ * with another number of symbols, or whose buffers do not have the alignment of the planned ones, run a transform per
+ * symbol.
+ * @param q DFT precoding object
+ * @param nof_symbols Number of symbols of the batch, 0 releases the batch plans
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_dft_precoding_set_batch(srsran_dft_precoding_t* q, uint32_t nof_symbols);
+
+/**
+ * @brief Transforms nof_symbols consecutive symbols of nof_prb PRB. The input and output may be the same buffer.
+ */
 SRSRAN_API int
 srsran_dft_precoding(srsran_dft_precoding_t* q, cf_t* input, cf_t* output, uint32_t nof_prb, uint32_t nof_symbols);
 
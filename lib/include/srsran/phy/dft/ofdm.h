@@ -62,6 +62,7 @@ typedef struct SRSRAN_API {
   bool             keep_dc;          ///< If true, it does not remove the DC
   double           phase_compensation_hz; ///< Carrier frequency in Hz for phase compensation, set to 0 to disable
   srsran_cfr_cfg_t cfr_tx_cfg;            ///< Tx CFR configuration
+  bool             rx_sc16;               ///< Plans the 16-bit integer input of srsran_ofdm_rx_sf_sc16, RX only
 } srsran_ofdm_cfg_t;
 
 /**
@@ -86,6 +87,8 @@ typedef struct SRSRAN_API {
   uint32_t          window_offset_n;
   cf_t*             shift_buffer;
   cf_t*             window_offset_buffer;
+  cf_t*             sc16_buffer;   ///< Samples of one slot without cyclic prefix, converted from 16-bit integer
+  srsran_dft_plan_t fft_plan_sc16; ///< Guru DFT of the symbols in sc16_buffer
   cf_t              phase_compensation[SRSRAN_MAX_NSYMB * SRSRAN_NOF_SLOTS_PER_SF];
   srsran_cfr_t      tx_cfr; ///< Tx CFR object
 } srsran_ofdm_t;
@@ -130,6 +133,19 @@ SRSRAN_API void srsran_ofdm_rx_sf(srsran_ofdm_t* q);
 
 SRSRAN_API void srsran_ofdm_rx_sf_ng(srsran_ofdm_t* q, cf_t* input, cf_t* output);
 
+/**
+ * @brief Demodulates a subframe of 16-bit integer IQ samples, as received from the radio, into the output buffer
+ *
+ * The integer to float conversion is done together with the cyclic prefix removal, only the samples of each DFT window
+ * are converted. MBSFN subframes, and objects initialised without rx_sc16, convert the whole subframe into the input
+ * buffer and call srsran_ofdm_rx_sf
+ *
+ * @param q OFDM object
+ * @param input Interleaved real and imaginary 16-bit samples of one subframe
+ * @param scale Integer value of the unitary amplitude, as in srsran_vec_convert_if
+ */
+SRSRAN_API void srsran_ofdm_rx_sf_sc16(srsran_ofdm_t* q, const int16_t* input, float scale);
+
 SRSRAN_API int
 srsran_ofdm_tx_init(srsran_ofdm_t* q, srsran_cp_t cp_type, cf_t* in_buffer, cf_t* out_buffer, uint32_t nof_prb);
 
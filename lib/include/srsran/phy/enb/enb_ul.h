@@ -61,6 +61,8 @@ typedef struct SRSRAN_API {
   srsran_pusch_t    pusch;
   srsran_pucch_t    pucch;
 
+  bool rx_sc16; ///< Enables srsran_enb_ul_fft_sc16, set it before srsran_enb_ul_set_cell
+
 } srsran_enb_ul_t;
 
 /* This function shall be called just after the initial synchronization */
@@ -75,6 +77,8 @@ SRSRAN_API int srsran_enb_ul_set_cell(srsran_enb_ul_t*                   q,
 
 SRSRAN_API void srsran_enb_ul_fft(srsran_enb_ul_t* q);
 
+SRSRAN_API void srsran_enb_ul_fft_sc16(srsran_enb_ul_t* q, const int16_t* input, float scale);
+
 SRSRAN_API int srsran_enb_ul_get_pucch(srsran_enb_ul_t*    q,
                                        srsran_ul_sf_cfg_t* ul_sf,
                                        srsran_pucch_cfg_t* cfg,
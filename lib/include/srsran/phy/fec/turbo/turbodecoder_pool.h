@@ -0,0 +1,116 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/**********************************************************************************************
+ *  File:         turbodecoder_pool.h
+ *
+ *  Description:  Decodes the code blocks of a transport block concurrently.
+ *                Each code block is a job that runs turbo decoder iterations until its CRC
+ *                matches or the maximum number of iterations is reached. The calling thread
+ *                decodes jobs with its own decoder while the worker threads of the pool, each
+ *                with a decoder of its own, take the remaining ones. The outcome of a job does
+ *                not depend on the thread that decoded it.
+ *********************************************************************************************/
+
+#ifndef SRSRAN_TURBODECODER_POOL_H
+#define SRSRAN_TURBODECODER_POOL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "srsran/config.h"
+#include "srsran/phy/fec/crc.h"
+#include "srsran/phy/fec/turbo/turbodecoder.h"
+
+#define SRSRAN_TDEC_POOL_MAX_WORKERS 8
+
+typedef struct SRSRAN_API {
+  void*    input;          ///< Rate matched soft bits of the code block, int16_t or int8_t
+  uint8_t* output;         ///< Decoded code block, packed, long_cb / 8 bytes
+  uint32_t long_cb;        ///< Code block length in bits
+  uint32_t crc_poly;       ///< Polynomial of the CRC checked after each iteration for early stopping
+  int      crc_order;      ///< Order of the CRC checked after each iteration
+  uint32_t crc_len;        ///< Number of bits covered by the CRC check, CRC included
+  uint32_t nof_iterations; ///< Iterations run, 0 if the job was skipped
+  bool     crc_ok;         ///< The CRC matched
+} srsran_tdec_pool_job_t;
+
+typedef struct SRSRAN_API {
+  bool     llr_is_8bit;
+  uint32_t min_iterations; ///< Iterations to run before checking the CRC
+  uint32_t max_iterations;
+  bool     stop_on_error; ///< Skip the pending jobs once a CRC failed
+} srsran_tdec_pool_cfg_t;
+
+typedef struct SRSRAN_API {
+  uint32_t nof_workers;
+  void*    workers;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t  cvar_start;
+  pthread_cond_t  cvar_done;
+
+  // Current batch, protected by mutex
+  srsran_tdec_pool_cfg_t  cfg;
+  bool                    force_not_sb; ///< Input layout of the calling thread decoder
+  srsran_tdec_pool_job_t* jobs;
+  uint32_t                nof_jobs;
+  uint32_t                next_job;
+  uint32_t                nof_busy;
+  uint32_t                batch;
+  bool                    error;
+  bool                    quit;
+} srsran_tdec_pool_t;
+
+/**
+ * @brief Initialises a turbo decoder pool and starts its worker threads. Each worker has its own turbo decoder and its
+ * own CRC24A and CRC24B objects, so jobs can only use these two CRCs
+ * @param q Turbo decoder pool
+ * @param nof_workers Number of worker threads, besides the calling thread
+ * @param max_long_cb Maximum code block length
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_tdec_pool_init(srsran_tdec_pool_t* q, uint32_t nof_workers, uint32_t max_long_cb);
+
+SRSRAN_API void srsran_tdec_pool_free(srsran_tdec_pool_t* q);
+
+/**
+ * @brief Decodes a batch of code blocks and returns once all of them are done
+ *
+ * @param q Turbo decoder pool, if NULL the jobs are decoded one after another by the calling thread
+ * @param tdec Turbo decoder of the calling thread
+ * @param crc CRC objects of the calling thread, a job uses the one matching its polynomial and order
+ * @param nof_crc Number of CRC objects
+ * @param jobs Code blocks to decode, the outputs must not overlap
+ * @param nof_jobs Number of code blocks
+ * @param cfg Decoding configuration of the batch
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_tdec_pool_run(srsran_tdec_pool_t*           q,
+                                    srsran_tdec_t*                tdec,
+                                    srsran_crc_t**                crc,
+                                    uint32_t                      nof_crc,
+                                    srsran_tdec_pool_job_t*       jobs,
+                                    uint32_t                      nof_jobs,
+                                    const srsran_tdec_pool_cfg_t* cfg);
+
+#endif // SRSRAN_TURBODECODER_POOL_H
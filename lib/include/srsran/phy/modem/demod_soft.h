@@ -23,7 +23,10 @@
  *  File:         demod_soft.h
  *
  *  Description:  Soft demodulator.
- *                Supports BPSK, QPSK, 16QAM and 64QAM.
+ *                Supports BPSK, QPSK, 16QAM, 64QAM and 256QAM.
+ *                The 16 and 8 bit demodulators of 16QAM, 64QAM and 256QAM
+ *                have SIMD implementations, the fastest one compiled in is
+ *                selected.
  *
  *  Reference:    3GPP TS 36.211 version 10.0.0 Release 10 Sec. 7.1
  *****************************************************************************/
@@ -31,15 +34,47 @@
 #ifndef SRSRAN_DEMOD_SOFT_H
 #define SRSRAN_DEMOD_SOFT_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "modem_table.h"
 #include "srsran/config.h"
 
+typedef enum SRSRAN_API {
+  SRSRAN_DEMOD_SOFT_IMPL_AUTO = 0, ///< Fastest implementation available
+  SRSRAN_DEMOD_SOFT_IMPL_GENERIC,
+  SRSRAN_DEMOD_SOFT_IMPL_SSE, ///< SSE on x86, NEON on ARM
+  SRSRAN_DEMOD_SOFT_IMPL_AVX2,
+  SRSRAN_DEMOD_SOFT_IMPL_AVX512,
+  SRSRAN_DEMOD_SOFT_IMPL_NOF
+} srsran_demod_soft_impl_t;
+
 SRSRAN_API int srsran_demod_soft_demodulate(srsran_mod_t modulation, const cf_t* symbols, float* llr, int nsymbols);
 
 SRSRAN_API int srsran_demod_soft_demodulate_s(srsran_mod_t modulation, const cf_t* symbols, short* llr, int nsymbols);
 
 SRSRAN_API int srsran_demod_soft_demodulate_b(srsran_mod_t modulation, const cf_t* symbols, int8_t* llr, int nsymbols);
 
+/**
+ * @brief Checks whether a soft demodulator implementation is compiled in
+ */
+SRSRAN_API bool srsran_demod_soft_impl_available(srsran_demod_soft_impl_t impl);
+
+/**
+ * @brief Demodulates with a given implementation. The modulations it does not accelerate use the next implementation
+ * below it. Produces the same LLR as srsran_demod_soft_demodulate_s()
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR if the implementation is not available
+ */
+SRSRAN_API int srsran_demod_soft_demodulate_s_impl(srsran_demod_soft_impl_t impl,
+                                                   srsran_mod_t             modulation,
+                                                   const cf_t*              symbols,
+                                                   short*                   llr,
+                                                   int                      nsymbols);
+
+SRSRAN_API int srsran_demod_soft_demodulate_b_impl(srsran_demod_soft_impl_t impl,
+                                                   srsran_mod_t             modulation,
+                                                   const cf_t*              symbols,
+                                                   int8_t*                  llr,
+                                                   int                      nsymbols);
+
 #endif // SRSRAN_DEMOD_SOFT_H
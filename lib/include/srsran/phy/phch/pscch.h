@@ -92,6 +92,7 @@ SRSRAN_API int  srsran_pscch_init(srsran_pscch_t* q, uint32_t max_prb);
 SRSRAN_API int  srsran_pscch_set_cell(srsran_pscch_t* q, srsran_cell_sl_t cell);
 SRSRAN_API int  srsran_pscch_encode(srsran_pscch_t* q, uint8_t* sci, cf_t* sf_buffer, uint32_t prb_start_idx);
 SRSRAN_API int  srsran_pscch_decode(srsran_pscch_t* q, cf_t* equalized_sf_syms, uint8_t* sci, uint32_t prb_start_idx);
+SRSRAN_API int  srsran_pscch_decode_compact(srsran_pscch_t* q, cf_t* equalized_syms, uint8_t* sci);
 SRSRAN_API int  srsran_pscch_put(srsran_pscch_t* q, cf_t* sf_buffer, uint32_t prb_start_idx);
 SRSRAN_API int  srsran_pscch_get(srsran_pscch_t* q, cf_t* sf_buffer, uint32_t prb_start_idx);
 SRSRAN_API void srsran_pscch_free(srsran_pscch_t* q);
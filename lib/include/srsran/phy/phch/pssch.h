@@ -25,8 +25,10 @@
 #include "srsran/phy/common/phy_common_sl.h"
 #include "srsran/phy/dft/dft_precoding.h"
 #include "srsran/phy/fec/crc.h"
+#include "srsran/phy/fec/softbuffer.h"
 #include "srsran/phy/fec/turbo/turbocoder.h"
 #include "srsran/phy/fec/turbo/turbodecoder.h"
+#include "srsran/phy/fec/turbo/turbodecoder_pool.h"
 #include "srsran/phy/modem/mod.h"
 #include "srsran/phy/scrambling/scrambling.h"
 
@@ -39,6 +41,14 @@
 // Redundancy version
 static const uint8_t srsran_pssch_rv[4] = {0, 2, 3, 1};
 
+// Turbo decoder iterations per code block, decoding stops as soon as the CRC passes
+#define SRSRAN_PSSCH_MIN_TDEC_ITERS 2
+#define SRSRAN_PSSCH_DEFAULT_MAX_TDEC_ITERS 8
+
+// Maximum number of code blocks of a TB
+#define SRSRAN_PSSCH_MAX_NOF_CB                                                                                        \
+  ((SRSRAN_SL_SCH_MAX_TB_LEN + SRSRAN_PSSCH_CRC_LEN) / (SRSRAN_TCOD_MAX_LEN_CB - SRSRAN_PSSCH_CRC_LEN) + 1)
+
 typedef struct SRSRAN_API {
   uint32_t prb_start_idx; // PRB start idx to map RE from RIV
   uint32_t nof_prb;       // PSSCH nof_prbs, Length of continuous PRB to map RE (in the pool) from RIV
@@ -46,6 +56,10 @@ typedef struct SRSRAN_API {
   uint32_t mcs_idx;
   uint32_t rv_idx;
   uint32_t sf_idx; // PSSCH sf_idx
+
+  // Optional, soft bits of the previous transmissions of the same TB are combined with the received ones. Set to
+  // NULL for decoding every transmission on its own. Ignored when encoding
+  srsran_softbuffer_rx_t* softbuffer;
 } srsran_pssch_cfg_t;
 
 typedef struct SRSRAN_API {
@@ -71,7 +85,7 @@ typedef struct SRSRAN_API {
 
   // crc
   uint8_t*     c_r;
-  uint8_t*     c_r_bytes;
+  uint8_t*     c_r_bytes; // decoded code blocks, one SRSRAN_TCOD_MAX_LEN_CB slot each
   uint8_t*     tb_crc_temp;
   srsran_crc_t tb_crc;
   uint8_t*     cb_crc_temp;
@@ -79,9 +93,15 @@ typedef struct SRSRAN_API {
 
   // channel coding
   uint8_t*      d_r;
-  int16_t*      d_r_16;
+  int16_t*      d_r_16; // soft bits without soft buffer, one SRSRAN_PSSCH_MAX_CODED_BITS slot per code block
   srsran_tcod_t tcod;
   srsran_tdec_t tdec;
+  uint32_t      max_nof_iterations; // maximum turbo decoder iterations per code block
+  float         avg_iterations;     // average turbo decoder iterations per code block in the last decoding
+
+  // concurrent decoding of the code blocks, disabled if cb_pool is NULL
+  srsran_tdec_pool_t*    cb_pool;
+  srsran_tdec_pool_job_t cb_jobs[SRSRAN_PSSCH_MAX_NOF_CB];
 
   // rate matching
   uint8_t* e_r;
@@ -110,19 +130,27 @@ typedef struct SRSRAN_API {
 
   // dft precoding
   srsran_dft_precoding_t dft_precoder;
-  cf_t*                  scfdma_symbols;
   srsran_dft_precoding_t idft_precoder;
 
+  // processing time of the last decoding, only measured if meas_time_en is set
+  bool     meas_time_en;
+  uint32_t meas_time_demod_us; // transform predecoding, demodulation, descrambling, deinterleaving and rate matching
+  uint32_t meas_time_tdec_us;  // turbo decoding of all code blocks
+
 } srsran_pssch_t;
 
-SRSRAN_API int  srsran_pssch_init(srsran_pssch_t*                       q,
-                                  const srsran_cell_sl_t*               cell,
-                                  const srsran_sl_comm_resource_pool_t* sl_comm_resource_pool);
-SRSRAN_API int  srsran_pssch_set_cfg(srsran_pssch_t* q, srsran_pssch_cfg_t pssch_cfg);
-SRSRAN_API int  srsran_pssch_encode(srsran_pssch_t* q, uint8_t* input, uint32_t input_len, cf_t* sf_buffer);
-SRSRAN_API int  srsran_pssch_decode(srsran_pssch_t* q, cf_t* equalized_sf_syms, uint8_t* output, uint32_t output_len);
-SRSRAN_API int  srsran_pssch_put(srsran_pssch_t* q, cf_t* sf_buffer, cf_t* symbols);
-SRSRAN_API int  srsran_pssch_get(srsran_pssch_t* q, cf_t* sf_buffer, cf_t* symbols);
-SRSRAN_API void srsran_pssch_free(srsran_pssch_t* q);
+SRSRAN_API int   srsran_pssch_init(srsran_pssch_t*                       q,
+                                   const srsran_cell_sl_t*               cell,
+                                   const srsran_sl_comm_resource_pool_t* sl_comm_resource_pool);
+SRSRAN_API int   srsran_pssch_set_cfg(srsran_pssch_t* q, srsran_pssch_cfg_t pssch_cfg);
+SRSRAN_API int   srsran_pssch_encode(srsran_pssch_t* q, uint8_t* input, uint32_t input_len, cf_t* sf_buffer);
+SRSRAN_API int   srsran_pssch_decode(srsran_pssch_t* q, cf_t* equalized_sf_syms, uint8_t* output, uint32_t output_len);
+SRSRAN_API int   srsran_pssch_decode_compact(srsran_pssch_t* q, cf_t* symbols, uint8_t* output, uint32_t output_len);
+SRSRAN_API void  srsran_pssch_set_max_noi(srsran_pssch_t* q, uint32_t max_iterations);
+SRSRAN_API float srsran_pssch_last_noi(srsran_pssch_t* q);
+SRSRAN_API int   srsran_pssch_set_cb_workers(srsran_pssch_t* q, uint32_t nof_workers);
+SRSRAN_API int   srsran_pssch_put(srsran_pssch_t* q, cf_t* sf_buffer, cf_t* symbols);
+SRSRAN_API int   srsran_pssch_get(srsran_pssch_t* q, cf_t* sf_buffer, cf_t* symbols);
+SRSRAN_API void  srsran_pssch_free(srsran_pssch_t* q);
 
 #endif // SRSRAN_PSSCH_H
\ No newline at end of file
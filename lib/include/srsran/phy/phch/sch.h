@@ -36,6 +36,7 @@
 #include "srsran/phy/fec/turbo/rm_turbo.h"
 #include "srsran/phy/fec/turbo/turbocoder.h"
 #include "srsran/phy/fec/turbo/turbodecoder.h"
+#include "srsran/phy/fec/turbo/turbodecoder_pool.h"
 #include "srsran/phy/phch/pdsch_cfg.h"
 #include "srsran/phy/phch/pusch_cfg.h"
 #include "srsran/phy/phch/uci.h"
@@ -69,6 +70,11 @@ typedef struct SRSRAN_API {
   srsran_crc_t  crc_tb;
   srsran_crc_t  crc_cb;
 
+  /* Concurrent decoding of the code blocks of a TB, disabled if cb_pool is NULL */
+  srsran_tdec_pool_t*    cb_pool;
+  uint8_t*               cb_out; ///< Decoded code blocks, one SRSRAN_TCOD_MAX_LEN_CB slot each
+  srsran_tdec_pool_job_t cb_jobs[SRSRAN_MAX_CODEBLOCKS];
+
   srsran_uci_cqi_pusch_t uci_cqi;
 
 } srsran_sch_t;
@@ -81,6 +87,16 @@ SRSRAN_API void srsran_sch_set_max_noi(srsran_sch_t* q, uint32_t max_iterations)
 
 SRSRAN_API float srsran_sch_last_noi(srsran_sch_t* q);
 
+/**
+ * @brief Sets the number of threads that decode the code blocks of a TB besides the calling thread. The decoded data
+ * and the CRC results do not depend on the number of threads.
+ * @param q SCH object
+ * @param nof_workers Number of worker threads, up to SRSRAN_TDEC_POOL_MAX_WORKERS. Set to 0 to decode in the calling
+ * thread only
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_sch_set_cb_workers(srsran_sch_t* q, uint32_t nof_workers);
+
 SRSRAN_API int srsran_dlsch_encode(srsran_sch_t* q, srsran_pdsch_cfg_t* cfg, uint8_t* data, uint8_t* e_bits);
 
 SRSRAN_API int srsran_dlsch_encode2(srsran_sch_t*       q,
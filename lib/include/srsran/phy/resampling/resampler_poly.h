@@ -0,0 +1,144 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         resampler_poly.h
+ *
+ *  Description:  Streaming polyphase resampler between two arbitrary sampling
+ *                rates. Rational ratios with a small interpolation factor use
+ *                one filter phase per output sample, other ratios interpolate
+ *                linearly between the two closest phases of a fixed bank.
+ *
+ *  Reference:    Multirate Signal Processing for Communication Systems
+ *                fredric j. harris
+ *****************************************************************************/
+
+#ifndef SRSRAN_RESAMPLER_POLY_H
+#define SRSRAN_RESAMPLER_POLY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "srsran/config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Largest interpolation factor of a rational ratio filtered with one phase per output sample
+ */
+#define SRSRAN_RESAMPLER_POLY_MAX_PHASES 512
+
+/**
+ * Number of phases of the filter bank for the ratios which are not rational with a small interpolation factor
+ */
+#define SRSRAN_RESAMPLER_POLY_NOF_PHASES 256
+
+/**
+ * Filter taps per phase at the lowest of both rates, the number of taps grows with the decimation
+ */
+#define SRSRAN_RESAMPLER_POLY_TAPS 32
+
+/**
+ * @brief Polyphase resampler state. The position of the next output sample is kept as the input sample ending its
+ * filter window, the filter phase and the fraction between this phase and the next one
+ */
+typedef struct {
+  double   input_srate;  ///< Input sampling rate in Hz
+  double   output_srate; ///< Output sampling rate in Hz
+  bool     interpolate;  ///< Interpolates between phases, the ratio is not rational with a small factor
+  uint32_t nof_phases;   ///< Number of filter phases
+  uint32_t nof_taps;     ///< Taps per phase, multiple of the widest SIMD register
+  float*   filter;       ///< Filter bank, nof_phases + 1 rows of nof_taps taps, each tap repeated for real and imaginary
+  cf_t*    head;         ///< Last nof_taps input samples followed by the first ones of the current input
+
+  // Position of the next output sample
+  int64_t  n;     ///< Index of the last input sample of the filter window, relative to the next input
+  uint32_t phase; ///< Filter phase
+  uint32_t frac;  ///< Fraction towards the next phase in 1/2^32 units
+
+  // Position increment for each output sample
+  uint32_t step_n;
+  uint32_t step_phase;
+  uint32_t step_frac;
+} srsran_resampler_poly_t;
+
+/**
+ * Initialise a polyphase resampler from one sampling rate to another
+ * @param q Object pointer
+ * @param input_srate Input sampling rate in Hz
+ * @param output_srate Output sampling rate in Hz
+ * @return SRSRAN_SUCCESS if no error, otherwise an SRSRAN error code
+ */
+SRSRAN_API int srsran_resampler_poly_init(srsran_resampler_poly_t* q, double input_srate, double output_srate);
+
+/**
+ * @brief Resets the internal state, as if all the previous input samples were zero
+ * @param q Object pointer
+ */
+SRSRAN_API void srsran_resampler_poly_reset_state(srsran_resampler_poly_t* q);
+
+/**
+ * Get the delay of the resampler filter
+ * @param q Object pointer
+ * @return the delay in number of input samples
+ */
+SRSRAN_API double srsran_resampler_poly_get_delay(const srsran_resampler_poly_t* q);
+
+/**
+ * Get the number of input samples to produce exactly a number of output samples from the current state
+ * @param q Object pointer
+ * @param nof_output Number of output samples
+ * @return the number of input samples
+ */
+SRSRAN_API uint32_t srsran_resampler_poly_nof_input(const srsran_resampler_poly_t* q, uint32_t nof_output);
+
+/**
+ * @brief Resamples a block of samples, keeping the state for the next block
+ *
+ * @note The output stops after max_output samples. The input shall not exceed srsran_resampler_poly_nof_input() of
+ * max_output samples, otherwise the samples after the last output are lost
+ *
+ * @param q Object pointer, make sure it has been initialised
+ * @param input Points at the input complex buffer
+ * @param nof_input Number of input samples
+ * @param output Points at the output complex buffer
+ * @param max_output Size of the output buffer
+ * @return the number of output samples
+ */
+SRSRAN_API uint32_t srsran_resampler_poly_run(srsran_resampler_poly_t* q,
+                                              const cf_t*              input,
+                                              uint32_t                 nof_input,
+                                              cf_t*                    output,
+                                              uint32_t                 max_output);
+
+/**
+ * Free polyphase resampler buffers
+ * @param q  Object pointer
+ */
+SRSRAN_API void srsran_resampler_poly_free(srsran_resampler_poly_t* q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSRAN_RESAMPLER_POLY_H
@@ -129,6 +129,14 @@ typedef struct {
                                     bool   blocking,
                                     bool   is_start_of_burst,
                                     bool   is_end_of_burst);
+  bool (*srsran_rf_has_rx_sc16)(void* h);
+  int (*srsran_rf_recv_with_time_multi_sc16)(void*    h,
+                                             void**   data,
+                                             uint32_t nsamples,
+                                             bool     blocking,
+                                             time_t*  secs,
+                                             double*  frac_secs,
+                                             float*   scale);
 } rf_dev_t;
 
 typedef struct {
@@ -207,6 +215,33 @@ SRSRAN_API int srsran_rf_recv_with_time_multi(srsran_rf_t* h,
                                               time_t*      secs,
                                               double*      frac_secs);
 
+/**
+ * @brief Checks whether the device can deliver the received samples as interleaved 16-bit integer IQ pairs, without
+ * converting them to float
+ * @param[in] h Device handle
+ * @return true if srsran_rf_recv_with_time_multi_sc16() is available, false otherwise
+ */
+SRSRAN_API bool srsran_rf_has_rx_sc16(srsran_rf_t* h);
+
+/**
+ * @brief Receives interleaved 16-bit integer IQ samples as delivered by the device, see srsran_rf_has_rx_sc16()
+ * @param[in] h Device handle
+ * @param[out] data Buffers of 2 * nsamples integers for each channel
+ * @param[in] nsamples Number of samples
+ * @param[in] blocking Blocking reception
+ * @param[out] secs Integer part of the reception timestamp; NULL to ignore
+ * @param[out] frac_secs Fractional part of the reception timestamp; NULL to ignore
+ * @param[out] scale Integer value of the unitary amplitude, it includes the RX gain
+ * @return The number of received samples on success, otherwise SRSRAN_ERROR
+ */
+SRSRAN_API int srsran_rf_recv_with_time_multi_sc16(srsran_rf_t* h,
+                                                   int16_t**    data,
+                                                   uint32_t     nsamples,
+                                                   bool         blocking,
+                                                   time_t*      secs,
+                                                   double*      frac_secs,
+                                                   float*       scale);
+
 SRSRAN_API double srsran_rf_set_tx_srate(srsran_rf_t* h, double freq);
 
 SRSRAN_API int srsran_rf_set_tx_gain(srsran_rf_t* h, double gain);
@@ -24,6 +24,12 @@
  *
  *  Description:  Primary sidelink synchronization signal (PSSS) generation and detection.
  *
+ *                Detection runs in two stages. A coarse correlator over the
+ *                whole subframe works at 1.92 Msps, where the PSSS still fits,
+ *                after a boxcar decimation of the input. The full-rate
+ *                correlation is then only evaluated around the coarse peak.
+ *                Once found, srsran_psss_track() only evaluates the latter
+ *                around the expected position.
  *
  *  Reference:    3GPP TS 36.211 version 15.6.0 Release 15 Sec. 9.7.1
  *****************************************************************************/
@@ -40,10 +46,16 @@
 
 #define SRSRAN_PSSS_LEN 62
 
+/// Symbol size of the coarse search, 1.92 Msps
+#define SRSRAN_PSSS_COARSE_SYMBOL_SZ 128
+
 typedef struct SRSRAN_API {
 
   cf_t psss_signal[2][SRSRAN_PSSS_LEN]; // One sequence for each N_id_2
 
+  uint32_t decim; // Decimation factor of the coarse search, symbol_sz / SRSRAN_PSSS_COARSE_SYMBOL_SZ
+
+  // Coarse search buffers, two decimated subframes long
   cf_t** psss_sf_freq;
 
   cf_t* input_pad_freq;
@@ -56,8 +68,15 @@ typedef struct SRSRAN_API {
 
   float* shifted_output_abs;
 
+  // Full-rate time-domain PSSS symbols (with cyclic prefix) for the fine search
+  cf_t*    psss_time[2];
+  uint32_t psss_time_offset; // Position of the first PSSS symbol in the subframe
+  uint32_t psss_time_len;
+
   int32_t corr_peak_pos;
   float   corr_peak_value;
+  float   corr_peak_norm; // Peak normalized by the input and replica energies, between 0 and 1
+  float   cfo;            // Frequency offset between the two PSSS symbols, normalized to the subcarrier spacing
 
   uint32_t N_id_2;
 
@@ -74,6 +93,8 @@ SRSRAN_API void srsran_psss_put_sf_buffer(cf_t* psss_signal, cf_t* sf_buffer, ui
 
 SRSRAN_API int srsran_psss_find(srsran_psss_t* q, cf_t* input, uint32_t nof_prb, srsran_cp_t cp);
 
+SRSRAN_API int srsran_psss_track(srsran_psss_t* q, cf_t* input, uint32_t nof_prb, uint32_t N_id_2, uint32_t window);
+
 SRSRAN_API void srsran_psss_free(srsran_psss_t* q);
 
 #endif // SRSRAN_PSSS_H
@@ -0,0 +1,125 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         ue_sl_harq.h
+ *
+ *  Description:  Soft buffer store for the blind retransmissions of the
+ *                sidelink shared channel (TM3/TM4).
+ *
+ *                The SCI Format 1 of a retransmission is the SCI of the
+ *                initial transmission with the retransmission index set, and
+ *                it is sent time_gap subframes later. A soft buffer is taken
+ *                when an initial transmission announcing a retransmission is
+ *                received, keyed by its N_x_id. The retransmission recomputes
+ *                the N_x_id of the initial SCI to find it, so that both
+ *                transmissions are combined. Buffers are released after the
+ *                retransmission, or when the subframe of the retransmission
+ *                has passed. A TB decoded in its initial transmission keeps
+ *                its buffer only to recognise the redundant retransmission,
+ *                and that buffer is the first reused when all are taken.
+ *
+ *                The store is shared by several decoding threads.
+ *
+ *  Reference:    3GPP TS 36.213 version 15.6.0 Release 15 Sec. 14.1.1.4C
+ *****************************************************************************/
+
+#ifndef SRSRAN_UE_SL_HARQ_H
+#define SRSRAN_UE_SL_HARQ_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "srsran/config.h"
+#include "srsran/phy/fec/crc.h"
+#include "srsran/phy/fec/softbuffer.h"
+#include "srsran/phy/phch/sci.h"
+
+#define SRSRAN_UE_SL_HARQ_DEFAULT_NOF_BUFFERS 16
+
+typedef struct SRSRAN_API {
+  srsran_softbuffer_rx_t softbuffer;
+  bool                   active;        ///< Holds the soft bits of a TB waiting for its retransmission
+  bool                   busy;          ///< Acquired by a decoder
+  bool                   retx_received; ///< The retransmission has been acquired
+  bool                   decoded;       ///< The TB was decoded in its initial transmission
+  uint32_t               N_x_id;        ///< N_x_id of the initial transmission
+  uint32_t               tti_retx;      ///< TTI of the expected retransmission
+} srsran_ue_sl_harq_buffer_t;
+
+typedef struct SRSRAN_API {
+  uint32_t                    nof_buffers;
+  srsran_ue_sl_harq_buffer_t* buffers;
+
+  srsran_crc_t crc; ///< SCI CRC, used to compute the N_x_id of an initial transmission
+  uint8_t      sci_bits[SRSRAN_SCI_MAX_LEN + SRSRAN_SCI_CRC_LEN];
+
+  pthread_mutex_t mutex;
+  pthread_cond_t  cvar;
+
+  // Metrics
+  uint64_t nof_combined;  ///< Retransmissions combined with their initial transmission
+  uint64_t nof_missed;    ///< Retransmissions whose initial transmission was not stored
+  uint64_t nof_redundant; ///< Retransmissions of a TB already decoded in its initial transmission
+  uint64_t nof_expired;   ///< Buffers released because their retransmission was not received
+  uint64_t nof_evicted;   ///< Buffers reused before their retransmission because all of them were active
+} srsran_ue_sl_harq_t;
+
+/**
+ * @brief Initialises a sidelink soft buffer store
+ * @param q Sidelink soft buffer store
+ * @param nof_prb Number of PRB of the sidelink carrier, sets the size of the soft buffers
+ * @param nof_buffers Number of soft buffers, set to 0 for default
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_ue_sl_harq_init(srsran_ue_sl_harq_t* q, uint32_t nof_prb, uint32_t nof_buffers);
+
+SRSRAN_API void srsran_ue_sl_harq_free(srsran_ue_sl_harq_t* q);
+
+/**
+ * @brief Acquires the soft buffer for the PSSCH scheduled by an SCI Format 1, and releases the buffers whose
+ * retransmission is overdue. An initial transmission gets a cleared buffer if it announces a retransmission. A
+ * retransmission gets the buffer of its initial transmission, waiting for it if it is still being decoded.
+ *
+ * @param q Sidelink soft buffer store
+ * @param sci Received SCI Format 1
+ * @param N_x_id N_x_id of the received SCI
+ * @param tti TTI of the received subframe
+ * @param tbs Transport block size in bits
+ * @return The soft buffer to pass to the PSSCH decoder, or NULL if the transmission is decoded on its own
+ */
+SRSRAN_API srsran_softbuffer_rx_t*
+srsran_ue_sl_harq_acquire(srsran_ue_sl_harq_t* q, const srsran_sci_t* sci, uint32_t N_x_id, uint32_t tti, uint32_t tbs);
+
+/**
+ * @brief Returns a soft buffer after decoding. The buffer is kept for the retransmission unless the TB was decoded
+ * or this was the retransmission.
+ */
+SRSRAN_API void srsran_ue_sl_harq_release(srsran_ue_sl_harq_t* q, srsran_softbuffer_rx_t* softbuffer, bool tb_crc);
+
+/**
+ * @brief Computes the N_x_id of the initial transmission of the TB scheduled by an SCI Format 1
+ * @return The N_x_id, which is the SCI CRC as a 16 bit integer
+ */
+SRSRAN_API uint32_t srsran_ue_sl_harq_initial_N_x_id(srsran_ue_sl_harq_t* q, const srsran_sci_t* sci);
+
+#endif // SRSRAN_UE_SL_HARQ_H
@@ -0,0 +1,165 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         ue_sl_rx.h
+ *
+ *  Description:  Multi-threaded sidelink (TM3/TM4) receiver.
+ *
+ *                Time-domain subframes are queued with srsran_ue_sl_rx_push().
+ *                A pool of workers runs the FFT of each queued subframe and
+ *                then spreads the PSCCH blind search and PSSCH decoding of
+ *                every subchannel across the pool. Each worker owns its own
+ *                PSCCH, PSSCH and channel estimation objects. Decoded
+ *                subframes are returned with srsran_ue_sl_rx_pop() in the
+ *                same order they were pushed.
+ *
+ *  Reference:    3GPP TS 36.213 version 15.6.0 Release 15 Sec. 14
+ *****************************************************************************/
+
+#ifndef SRSRAN_UE_SL_RX_H
+#define SRSRAN_UE_SL_RX_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "srsran/config.h"
+#include "srsran/phy/ch_estimation/chest_sl.h"
+#include "srsran/phy/common/phy_common_sl.h"
+#include "srsran/phy/dft/ofdm.h"
+#include "srsran/phy/phch/pscch.h"
+#include "srsran/phy/phch/pssch.h"
+#include "srsran/phy/phch/sci.h"
+#include "srsran/phy/ue/ue_sl_harq.h"
+
+#define SRSRAN_UE_SL_RX_MAX_WORKERS 32
+#define SRSRAN_UE_SL_RX_MAX_SF_BUFFERS 64
+#define SRSRAN_UE_SL_RX_MAX_TB_BYTES (SRSRAN_SL_SCH_MAX_TB_LEN / 8)
+
+typedef struct SRSRAN_API {
+  uint32_t nof_workers;        ///< Number of decoding threads
+  uint32_t nof_sf_buffers;     ///< Maximum number of subframes in flight, 0 selects twice the number of workers
+  bool     blocking;           ///< If true, push waits for a free buffer instead of dropping the subframe. Only
+                               ///< useful if srsran_ue_sl_rx_pop() is called from a different thread
+  uint32_t max_nof_iterations; ///< Maximum PSSCH turbo decoder iterations per code block, 0 selects the default
+  uint32_t nof_harq_buffers;   ///< Soft buffers kept for combining blind retransmissions, 0 selects the default
+  uint32_t nof_cb_workers;     ///< Threads per decoding thread that decode the code blocks of a TB concurrently, 0
+                               ///< decodes them in the decoding thread only
+} srsran_ue_sl_rx_args_t;
+
+/// Result of the PSCCH search and PSSCH decoding in a single subchannel
+typedef struct SRSRAN_API {
+  uint32_t     sub_channel_idx;
+  uint32_t     cyclic_shift;
+  uint32_t     N_x_id;
+  srsran_sci_t sci;
+  bool         tb_crc;                                ///< True if the PSSCH transport block passed the CRC
+  uint32_t     tb_len;                                ///< Transport block length in bits
+  float        avg_iterations;                        ///< PSSCH turbo decoder iterations per code block
+  bool         combined;                              ///< Retransmission combined with its initial transmission
+  uint8_t      tb_packed[SRSRAN_UE_SL_RX_MAX_TB_BYTES]; ///< Packed transport block, valid if tb_crc is true
+} srsran_ue_sl_rx_grant_t;
+
+/// One processed subframe as returned by srsran_ue_sl_rx_pop()
+typedef struct SRSRAN_API {
+  uint32_t                       tti;
+  uint32_t                       sf_idx;
+  uint32_t                       nof_grants;
+  const srsran_ue_sl_rx_grant_t* grants; ///< Valid until the next call to srsran_ue_sl_rx_pop()
+  uint64_t                       latency_us; ///< Time from push until the last subchannel was processed
+} srsran_ue_sl_rx_sf_t;
+
+typedef struct SRSRAN_API {
+  uint64_t nof_sf_pushed;
+  uint64_t nof_sf_processed;
+  uint64_t nof_sf_dropped;
+  uint64_t nof_sci_decoded;
+  uint64_t nof_tb_decoded;
+  uint64_t nof_tb_errors;
+  uint64_t nof_tb_combined; ///< Retransmissions combined with their initial transmission
+  double   sf_per_sec;      ///< Sustained processing rate since the first push
+  double   avg_latency_us;  ///< Average push-to-completion latency
+  uint64_t max_latency_us;
+} srsran_ue_sl_rx_metrics_t;
+
+typedef struct SRSRAN_API {
+  srsran_cell_sl_t               cell;
+  srsran_sl_comm_resource_pool_t sl_comm_resource_pool;
+  srsran_ue_sl_rx_args_t         args;
+
+  uint32_t sf_len;
+  uint32_t nof_sf_buffers;
+
+  srsran_ue_sl_harq_t harq; ///< Soft buffers of the TBs waiting for their retransmission
+
+  void* workers; ///< Opaque worker array
+  void* slots;   ///< Opaque subframe buffer array
+
+  // Ring of subframe buffers, head is the next to be written and tail the next to be returned
+  uint32_t head;
+  uint32_t tail;
+  uint32_t count;
+  bool     tail_held; ///< The tail buffer has been returned to the caller and is released on the next pop
+  bool     quit;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t  cvar_work;
+  pthread_cond_t  cvar_done;
+  pthread_cond_t  cvar_free;
+
+  srsran_ue_sl_rx_metrics_t metrics;
+  uint64_t                  latency_acc_us;
+  struct timespec           t_start;
+} srsran_ue_sl_rx_t;
+
+SRSRAN_API int srsran_ue_sl_rx_init(srsran_ue_sl_rx_t*                    q,
+                                    const srsran_cell_sl_t*               cell,
+                                    const srsran_sl_comm_resource_pool_t* sl_comm_resource_pool,
+                                    const srsran_ue_sl_rx_args_t*         args);
+
+SRSRAN_API void srsran_ue_sl_rx_free(srsran_ue_sl_rx_t* q);
+
+/**
+ * @brief Queues one time-domain subframe for decoding. The samples are copied, so the buffer can be reused as soon
+ * as the call returns.
+ *
+ * @param tti TTI of the subframe (10 * SFN + subframe index, modulo 10240). It must advance by one every subframe: the
+ * subframe index is derived from it, and the soft buffers of blind retransmissions are keyed and expired on it
+ * @return SRSRAN_SUCCESS if queued, SRSRAN_ERROR if the subframe was dropped because all buffers were busy
+ */
+SRSRAN_API int srsran_ue_sl_rx_push(srsran_ue_sl_rx_t* q, const cf_t* samples, uint32_t tti);
+
+/**
+ * @brief Returns the oldest processed subframe. The previous subframe returned by this function is released.
+ *
+ * @param wait If true, blocks until the oldest queued subframe has been processed
+ * @return 1 if a subframe was returned, 0 if none is ready (or no subframe is queued), SRSRAN_ERROR on error
+ */
+SRSRAN_API int srsran_ue_sl_rx_pop(srsran_ue_sl_rx_t* q, srsran_ue_sl_rx_sf_t* sf, bool wait);
+
+/// Number of subframes pushed but not yet returned by srsran_ue_sl_rx_pop()
+SRSRAN_API uint32_t srsran_ue_sl_rx_pending(srsran_ue_sl_rx_t* q);
+
+SRSRAN_API void srsran_ue_sl_rx_get_metrics(srsran_ue_sl_rx_t* q, srsran_ue_sl_rx_metrics_t* metrics);
+
+#endif // SRSRAN_UE_SL_RX_H
@@ -0,0 +1,151 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         ue_sl_sync.h
+ *
+ *  Description:  Sidelink synchronization, aligns the received baseband to the
+ *                subframes of a SyncRef UE.
+ *
+ *                In find state every received subframe goes through the full
+ *                PSSS and SSSS search. Once the SLSS is found, the track state
+ *                only correlates the PSSS of the expected SLSS subframes, once
+ *                per SLSS period, within a small window around its expected
+ *                position. Timing and CFO are corrected from those
+ *                measurements, and the object goes back to find after several
+ *                SLSS in a row are missed.
+ *
+ *  Reference:    3GPP TS 36.211 version 15.6.0 Release 15 Sec. 9.7
+ *****************************************************************************/
+
+#ifndef SRSRAN_UE_SL_SYNC_H
+#define SRSRAN_UE_SL_SYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "srsran/config.h"
+#include "srsran/phy/common/phy_common_sl.h"
+#include "srsran/phy/common/timestamp.h"
+#include "srsran/phy/sync/psss.h"
+#include "srsran/phy/sync/ssss.h"
+
+#define SRSRAN_UE_SL_SYNC_DEFAULT_SLSS_PERIOD_MS 40
+#define SRSRAN_UE_SL_SYNC_DEFAULT_MAX_LOST 3
+#define SRSRAN_UE_SL_SYNC_DEFAULT_TRACK_THR 0.3f
+#define SRSRAN_UE_SL_SYNC_DEFAULT_CFO_ALPHA 0.2f
+
+/**
+ * @brief Describes sidelink UE synchronization object internal states
+ */
+typedef enum SRSRAN_API {
+  SRSRAN_UE_SL_SYNC_STATE_FIND = 0, ///< Full PSSS/SSSS search on every subframe, baseband is not aligned
+  SRSRAN_UE_SL_SYNC_STATE_TRACK     ///< Baseband is aligned with subframes, only the SLSS subframes are correlated
+} srsran_ue_sl_sync_state_t;
+
+/**
+ * @brief Describes sidelink UE synchronization object arguments
+ */
+typedef struct SRSRAN_API {
+  uint32_t slss_period_ms; ///< SLSS period (40 or 160 ms), set to 0 for 40
+  uint32_t track_window;   ///< Timing error searched in track state, in samples on each side, set to 0 for one CP
+  uint32_t max_lost;       ///< Consecutive missed SLSS before going back to find, set to 0 for default
+  float    track_thr;      ///< Minimum normalized PSSS correlation in track state, set to 0 for default
+  float    cfo_alpha;      ///< CFO loop coefficient, set to 0 for default
+  bool     disable_cfo;    ///< Set to true for disabling the CFO compensation
+
+  // Receive callback, returns the number of received samples or an SRSRAN error code
+  void* recv_obj;
+  int (*recv_callback)(void*, cf_t*, uint32_t, srsran_timestamp_t*);
+} srsran_ue_sl_sync_args_t;
+
+/**
+ * @brief Describes a sidelink UE synchronization object
+ */
+typedef struct SRSRAN_API {
+  // State
+  srsran_ue_sl_sync_state_t state;
+  int32_t                   next_rf_sample_offset; ///< Samples to discard (>0) or zero-fill (<0) on the next read
+  uint32_t                  sf_cnt;                ///< Index of the next subframe within the SLSS period
+  uint32_t                  nof_lost;              ///< Consecutive SLSS missed in track state
+  uint32_t                  nof_find_sf;           ///< Consecutive subframes searched without finding an SLSS
+  uint32_t                  N_id_2;
+
+  // Components
+  srsran_psss_t psss;
+  srsran_ssss_t ssss;
+  cf_t*         find_buffer;     ///< Last two subframes received in find state
+  uint32_t      find_buffer_len; ///< Number of valid samples in find_buffer
+  cf_t*         slss_buffer;     ///< SLSS subframe found, after CFO correction
+
+  // Initialised arguments
+  srsran_cell_sl_t         cell;
+  srsran_ue_sl_sync_args_t args;
+  uint32_t                 sf_len;
+  double                   srate_hz;
+
+  // Metrics
+  float    cfo_hz;             ///< Current CFO in Hz
+  int32_t  last_sample_offset; ///< Last timing error measured in track state
+  uint32_t nof_psss_find;      ///< Calls to the full PSSS search
+  uint32_t nof_psss_track;     ///< Calls to the PSSS tracking correlator
+} srsran_ue_sl_sync_t;
+
+/**
+ * @brief Describes a sidelink UE synchronization zerocopy outcome
+ */
+typedef struct SRSRAN_API {
+  bool               in_sync;       ///< Indicates whether the received subframe is aligned
+  bool               slss;          ///< An SLSS was found or tracked in the received subframe
+  uint32_t           sf_cnt;        ///< Index of the received subframe within the SLSS period, 0 carries the SLSS
+  uint32_t           N_sl_id;       ///< Sidelink identity of the SyncRef UE
+  srsran_timestamp_t timestamp;     ///< Last received timestamp
+  float              cfo_hz;        ///< Current CFO in Hz
+  int32_t            sample_offset; ///< Last timing error measured in track state, in samples
+} srsran_ue_sl_sync_outcome_t;
+
+/**
+ * @brief Initialises a sidelink UE synchronization object, starting in find state
+ * @param q Sidelink UE synchronization object
+ * @param[in] cell Sidelink cell, N_sl_id is ignored
+ * @param[in] args Sidelink UE synchronization initialization arguments
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int
+srsran_ue_sl_sync_init(srsran_ue_sl_sync_t* q, const srsran_cell_sl_t* cell, const srsran_ue_sl_sync_args_t* args);
+
+SRSRAN_API void srsran_ue_sl_sync_free(srsran_ue_sl_sync_t* q);
+
+/**
+ * @brief Goes back to find state
+ */
+SRSRAN_API void srsran_ue_sl_sync_reset(srsran_ue_sl_sync_t* q);
+
+/**
+ * @brief Receives one subframe into buffer, runs the find or track state and corrects the CFO of the received samples
+ * @param q Sidelink UE synchronization object
+ * @param buffer Subframe buffer, SRSRAN_SF_LEN_PRB(cell.nof_prb) samples long
+ * @param outcome zerocopy outcome
+ * @return SRSRAN_SUCCESS if no error occurs, SRSRAN_ERROR code otherwise
+ */
+SRSRAN_API int srsran_ue_sl_sync_zerocopy(srsran_ue_sl_sync_t* q, cf_t* buffer, srsran_ue_sl_sync_outcome_t* outcome);
+
+#endif // SRSRAN_UE_SL_SYNC_H
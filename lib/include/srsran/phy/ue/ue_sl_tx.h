@@ -0,0 +1,122 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         ue_sl_tx.h
+ *
+ *  Description:  Batched sidelink (TM3/TM4) transmitter.
+ *
+ *                Encodes several SCI Format 1 + transport block pairs into
+ *                non-overlapping subchannels of the same subframe, e.g. to
+ *                emulate many vehicles from a single host. The PSCCH, PSSCH
+ *                and DMRS of every grant are generated concurrently by a pool
+ *                of workers, each owning its own PHY objects, and the whole
+ *                subframe goes through a single IFFT.
+ *
+ *  Reference:    3GPP TS 36.213 version 15.6.0 Release 15 Sec. 14
+ *****************************************************************************/
+
+#ifndef SRSRAN_UE_SL_TX_H
+#define SRSRAN_UE_SL_TX_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "srsran/config.h"
+#include "srsran/phy/ch_estimation/chest_sl.h"
+#include "srsran/phy/common/phy_common_sl.h"
+#include "srsran/phy/dft/ofdm.h"
+#include "srsran/phy/phch/pscch.h"
+#include "srsran/phy/phch/pssch.h"
+#include "srsran/phy/phch/sci.h"
+
+#define SRSRAN_UE_SL_TX_MAX_WORKERS 32
+
+typedef struct SRSRAN_API {
+  uint32_t nof_workers; ///< Number of encoding threads besides the caller, 0 encodes every grant in the caller thread
+} srsran_ue_sl_tx_args_t;
+
+/// One transmission, the SCI Format 1 fields and the transport block sent in its allocation
+typedef struct SRSRAN_API {
+  uint32_t       sub_channel_idx; ///< First subchannel of the allocation, the PSCCH is sent in its first PRBs
+  uint32_t       L_subCH;         ///< Number of subchannels
+  uint32_t       mcs_idx;
+  uint32_t       cyclic_shift; ///< PSCCH DMRS cyclic shift {0, 3, 6, 9}
+  uint32_t       priority;
+  uint32_t       resource_reserv;
+  uint32_t       time_gap;
+  bool           retransmission;
+  const uint8_t* tb;     ///< Unpacked transport block bits
+  uint32_t       tb_len; ///< Must match srsran_ue_sl_tx_get_tb_len() for the allocation and MCS
+} srsran_ue_sl_tx_grant_t;
+
+typedef struct SRSRAN_API {
+  srsran_cell_sl_t               cell;
+  srsran_sl_comm_resource_pool_t sl_comm_resource_pool;
+  srsran_ue_sl_tx_args_t         args;
+
+  cf_t*         sf_buffer; ///< Frequency-domain subframe shared by all grants
+  srsran_ofdm_t ifft;
+
+  void* workers; ///< Opaque worker array, the first one belongs to the calling thread
+
+  // Batch currently being encoded
+  const srsran_ue_sl_tx_grant_t* grants;
+  uint32_t                       nof_grants;
+  uint32_t                       next_grant;
+  uint32_t                       nof_pending;
+  uint32_t                       sf_idx;
+  int                            ret;
+  bool                           quit;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t  cvar_work;
+  pthread_cond_t  cvar_done;
+} srsran_ue_sl_tx_t;
+
+/**
+ * @brief Creates the transmitter. The time-domain subframe, SRSRAN_SF_LEN_PRB(cell->nof_prb) samples, is written to
+ * out_buffer by every call to srsran_ue_sl_tx_encode().
+ */
+SRSRAN_API int srsran_ue_sl_tx_init(srsran_ue_sl_tx_t*                    q,
+                                    const srsran_cell_sl_t*               cell,
+                                    const srsran_sl_comm_resource_pool_t* sl_comm_resource_pool,
+                                    const srsran_ue_sl_tx_args_t*         args,
+                                    cf_t*                                 out_buffer);
+
+SRSRAN_API void srsran_ue_sl_tx_free(srsran_ue_sl_tx_t* q);
+
+/// Transport block size in bits carried by an allocation of L_subCH subchannels with the given MCS
+SRSRAN_API uint32_t srsran_ue_sl_tx_get_tb_len(srsran_ue_sl_tx_t* q, uint32_t L_subCH, uint32_t mcs_idx);
+
+/**
+ * @brief Encodes all grants into one subframe and converts it to time domain. The allocations must not overlap.
+ *
+ * @return SRSRAN_SUCCESS, SRSRAN_ERROR_INVALID_INPUTS if a grant is invalid or overlaps another one, or SRSRAN_ERROR
+ * if the encoding of any grant failed
+ */
+SRSRAN_API int srsran_ue_sl_tx_encode(srsran_ue_sl_tx_t*             q,
+                                      const srsran_ue_sl_tx_grant_t* grants,
+                                      uint32_t                       nof_grants,
+                                      uint32_t                       sf_idx);
+
+#endif // SRSRAN_UE_SL_TX_H
@@ -128,6 +128,8 @@ SRSRAN_API void srsran_vec_convert_conj_cs_simd(const cf_t* x, int16_t* z, const
 
 SRSRAN_API void srsran_vec_convert_fb_simd(const float* x, int8_t* z, const float scale, const int len);
 
+SRSRAN_API void srsran_vec_convert_bf_simd(const int8_t* x, float* z, const float scale, const int len);
+
 SRSRAN_API void srsran_vec_interleave_simd(const cf_t* x, const cf_t* y, cf_t* z, const int len);
 
 SRSRAN_API void srsran_vec_interleave_add_simd(const cf_t* x, const cf_t* y, cf_t* z, const int len);
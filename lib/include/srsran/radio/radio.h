@@ -26,6 +26,7 @@
 #include "srsran/common/interfaces_common.h"
 #include "srsran/interfaces/radio_interfaces.h"
 #include "srsran/phy/resampling/resampler.h"
+#include "srsran/phy/resampling/resampler_poly.h"
 #include "srsran/phy/rf/rf.h"
 #include "srsran/radio/radio_base.h"
 #include "srsran/srslog/srslog.h"
@@ -66,6 +67,8 @@ public:
   void tx_end() override;
   bool tx(rf_buffer_interface& buffer, const rf_timestamp_interface& tx_time) override;
   bool rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time) override;
+  bool has_rx_sc16() override;
+  bool rx_now_sc16(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time, float* scale) override;
 
   // setter
   void set_tx_freq(const uint32_t& carrier_idx, const double& freq) override;
@@ -95,21 +98,23 @@ public:
   static void rf_msg_callback(void* arg, srsran_rf_error_t error);
 
 private:
-  std::vector<srsran_rf_t>                                rf_devices  = {};
-  std::vector<srsran_rf_info_t>                           rf_info     = {};
-  std::vector<int32_t>                                    rx_offset_n = {};
-  rf_metrics_t                                            rf_metrics  = {};
-  std::mutex                                              metrics_mutex;
-  srslog::basic_logger&                                   logger = srslog::fetch_basic_logger("RF", false);
-  phy_interface_radio*                                    phy    = nullptr;
-  std::vector<cf_t>                                       zeros;
-  std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS>      dummy_buffers;
-  std::mutex                                              tx_mutex;
-  std::mutex                                              rx_mutex;
-  std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS>      tx_buffer;
-  std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS>      rx_buffer;
-  std::array<srsran_resampler_fft_t, SRSRAN_MAX_CHANNELS> interpolators = {};
-  std::array<srsran_resampler_fft_t, SRSRAN_MAX_CHANNELS> decimators    = {};
+  std::vector<srsran_rf_t>                                 rf_devices  = {};
+  std::vector<srsran_rf_info_t>                            rf_info     = {};
+  std::vector<int32_t>                                     rx_offset_n = {};
+  rf_metrics_t                                             rf_metrics  = {};
+  std::mutex                                               metrics_mutex;
+  srslog::basic_logger&                                    logger = srslog::fetch_basic_logger("RF", false);
+  phy_interface_radio*                                     phy    = nullptr;
+  std::vector<cf_t>                                        zeros;
+  std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS>       dummy_buffers;
+  std::mutex                                               tx_mutex;
+  std::mutex                                               rx_mutex;
+  std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS>       tx_buffer;
+  std::array<std::vector<cf_t>, SRSRAN_MAX_CHANNELS>       rx_buffer;
+  std::array<srsran_resampler_fft_t, SRSRAN_MAX_CHANNELS>  interpolators = {};
+  std::array<srsran_resampler_fft_t, SRSRAN_MAX_CHANNELS>  decimators    = {};
+  std::array<srsran_resampler_poly_t, SRSRAN_MAX_CHANNELS> tx_resamplers = {}; ///< Non-integer Tx rate ratios
+  std::array<srsran_resampler_poly_t, SRSRAN_MAX_CHANNELS> rx_resamplers = {}; ///< Non-integer Rx rate ratios
   std::atomic<bool> decimator_busy = {false}; ///< Indicates the decimator is changing the rate
 
   rf_timestamp_t    end_of_burst_time = {};
@@ -205,9 +210,17 @@ private:
    * @param device_idx Device index
    * @param buffer Common receive buffers
    * @param rxd_time Points at the receive time (write only)
+   * @param scale Receives 16-bit integer samples and writes their unitary amplitude per logical channel if it is not
+   * NULL, otherwise receives float samples
    * @return it returns true if the reception was successful, otherwise it returns false
    */
-  bool rx_dev(const uint32_t& device_idx, const rf_buffer_interface& buffer, srsran_timestamp_t* rxd_time);
+  bool rx_dev(const uint32_t&            device_idx,
+              const rf_buffer_interface& buffer,
+              srsran_timestamp_t*        rxd_time,
+              float*                     scale = nullptr);
+
+  // private unprotected start of the RX stream, if it is not streaming yet
+  void start_rx_stream_nolock();
 
   /**
    * Helper method for mapping logical channels into physical radio buffers.
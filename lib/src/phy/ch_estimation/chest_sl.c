@@ -26,6 +26,7 @@
 #include <string.h>
 
 #include "srsran/phy/ch_estimation/chest_sl.h"
+#include "srsran/phy/common/sl_seq_cache.h"
 #include "srsran/phy/common/zc_sequence.h"
 #include "srsran/phy/mimo/precoding.h"
 #include "srsran/phy/utils/debug.h"
@@ -252,11 +253,9 @@ static void chest_sl_psbch_ls_estimate(srsran_chest_sl_t* q, cf_t* sf_buffer)
   uint32_t dmrs_index  = 0;
   uint32_t k           = q->cell.nof_prb * SRSRAN_NRE / 2 - 36;
   uint32_t sf_nsymbols = srsran_sl_get_num_symbols(q->cell.tm, q->cell.cp);
-  uint32_t sf_n_re     = SRSRAN_SF_LEN_RE(q->cell.nof_prb, q->cell.cp);
 
   // Get Pilot Estimates
   // Use the known DMRS signal to compute least-squares estimates
-  srsran_vec_cf_zero(q->ce, sf_n_re);
   for (uint32_t i = 0; i < sf_nsymbols; i++) {
     if (srsran_psbch_is_symbol(SRSRAN_SIDELINK_DMRS_SYMBOL, q->cell.tm, i, q->cell.cp)) {
       srsran_vec_prod_conj_ccc(&sf_buffer[i * q->cell.nof_prb * SRSRAN_NRE + k],
@@ -442,8 +441,6 @@ static void chest_sl_pscch_ls_estimate(srsran_chest_sl_t* q, cf_t* sf_buffer)
 {
   // Get Pilot Estimates
   // Use the known DMRS signal to compute least-squares estimates
-  srsran_vec_cf_zero(q->ce, q->sf_n_re);
-
   uint32_t dmrs_idx = 0;
   for (uint32_t i = 0; i < srsran_sl_get_num_symbols(q->cell.tm, q->cell.cp); i++) {
     if (srsran_pscch_is_symbol(SRSRAN_SIDELINK_DMRS_SYMBOL, q->cell.tm, i, q->cell.cp)) {
@@ -481,6 +478,20 @@ static int chest_sl_pssch_gen(srsran_chest_sl_t* q)
     q->alpha[i] = (2 * M_PI * q->n_CS[i]) / 12;
   }
 
+  // The sequences only depend on N_x_id, sf_idx and nof_prb, reuse them if any object has generated them before
+  cf_t* r_sequence[SRSRAN_SL_MAX_DMRS_SYMB] = {};
+  for (int j = 0; j < q->nof_dmrs_symbols; j++) {
+    r_sequence[j] = q->r_sequence[j][0];
+  }
+  if (srsran_sl_seq_cache_dmrs_get(q->cell.tm,
+                                   q->chest_sl_cfg.N_x_id,
+                                   q->chest_sl_cfg.sf_idx,
+                                   q->chest_sl_cfg.nof_prb,
+                                   q->nof_dmrs_symbols,
+                                   r_sequence)) {
+    return SRSRAN_SUCCESS;
+  }
+
   // Group Hopping
   uint32_t f_gh                       = 0; // Group Hopping Flag
   uint32_t f_ss                       = 0;
@@ -542,6 +553,13 @@ static int chest_sl_pssch_gen(srsran_chest_sl_t* q)
     srsran_vec_sc_prod_ccc(seq, q->w[j], seq, q->M_sc_rs);
   }
 
+  srsran_sl_seq_cache_dmrs_put(q->cell.tm,
+                               q->chest_sl_cfg.N_x_id,
+                               q->chest_sl_cfg.sf_idx,
+                               q->chest_sl_cfg.nof_prb,
+                               q->nof_dmrs_symbols,
+                               r_sequence);
+
   return SRSRAN_SUCCESS;
 }
 
@@ -812,7 +830,6 @@ static void chest_sl_pssch_ls_estimate(srsran_chest_sl_t* q, cf_t* sf_buffer)
   int      dmrs_idx = 0;
   uint32_t k        = q->chest_sl_cfg.prb_start_idx * SRSRAN_NRE;
 
-  srsran_vec_cf_zero(q->ce, q->sf_n_re);
   for (int i = 0; i < srsran_sl_get_num_symbols(q->cell.tm, q->cell.cp); i++) {
     if (srsran_pssch_is_symbol(SRSRAN_SIDELINK_DMRS_SYMBOL, q->cell.tm, i, q->cell.cp)) {
       if (q->cell.tm == SRSRAN_SIDELINK_TM1 || q->cell.tm == SRSRAN_SIDELINK_TM2) {
@@ -883,67 +900,88 @@ static void get_subband_noise(srsran_chest_sl_t* q, uint32_t k_start, uint32_t k
   }
 }
 
-float srsran_chest_sl_estimate_noise(srsran_chest_sl_t* q)
+// Returns the number of contiguous subcarrier bands occupied by the configured channel, at most 2
+static uint32_t chest_sl_get_bands(srsran_chest_sl_t* q, uint32_t* k_start, uint32_t* k_end)
 {
-  uint32_t sf_nsymbols = srsran_sl_get_num_symbols(q->cell.tm, q->cell.cp);
-  if (sf_nsymbols == 0) {
-    ERROR("Error estimating channel noise. Invalid number of OFDM symbols.");
-    return SRSRAN_ERROR;
-  }
-
-  srsran_vec_cf_zero(q->ce_average, q->sf_n_re);
-  q->noise_estimated = 0.0;
-
-  uint32_t k_start = 0;
-  uint32_t k_end   = 0;
-
   switch (q->channel) {
     case SRSRAN_SIDELINK_PSBCH:
-      k_start = q->cell.nof_prb * SRSRAN_NRE / 2 - 36;
-      k_end   = k_start + q->M_sc_rs;
-      get_subband_noise(q, k_start, k_end, sf_nsymbols);
-      break;
+      k_start[0] = q->cell.nof_prb * SRSRAN_NRE / 2 - 36;
+      k_end[0]   = k_start[0] + q->M_sc_rs;
+      return 1;
     case SRSRAN_SIDELINK_PSCCH:
-      k_start = q->chest_sl_cfg.prb_start_idx * SRSRAN_NRE;
-      k_end   = k_start + q->M_sc_rs;
-      get_subband_noise(q, k_start, k_end, sf_nsymbols);
-      break;
+      k_start[0] = q->chest_sl_cfg.prb_start_idx * SRSRAN_NRE;
+      k_end[0]   = k_start[0] + q->M_sc_rs;
+      return 1;
     case SRSRAN_SIDELINK_PSSCH:
-      if (q->cell.tm == SRSRAN_SIDELINK_TM1 || q->cell.tm == SRSRAN_SIDELINK_TM2) {
-        if (q->chest_sl_cfg.nof_prb <= q->sl_comm_resource_pool.prb_num) {
-          k_start = q->chest_sl_cfg.prb_start_idx * SRSRAN_NRE;
-          k_end   = (q->chest_sl_cfg.nof_prb + q->chest_sl_cfg.prb_start_idx) * SRSRAN_NRE;
-          get_subband_noise(q, k_start, k_end, sf_nsymbols);
+      if ((q->cell.tm == SRSRAN_SIDELINK_TM1 || q->cell.tm == SRSRAN_SIDELINK_TM2) &&
+          q->chest_sl_cfg.nof_prb > q->sl_comm_resource_pool.prb_num) {
+        // First band
+        k_start[0] = q->chest_sl_cfg.prb_start_idx * SRSRAN_NRE;
+        k_end[0]   = k_start[0] + q->sl_comm_resource_pool.prb_num * SRSRAN_NRE;
+
+        // Second band
+        if ((q->sl_comm_resource_pool.prb_num * 2) >
+            (q->sl_comm_resource_pool.prb_end - q->sl_comm_resource_pool.prb_start + 1)) {
+          k_start[1] = (q->sl_comm_resource_pool.prb_end + 1 - q->sl_comm_resource_pool.prb_num + 1) * SRSRAN_NRE;
         } else {
-          // First band
-          k_start = q->chest_sl_cfg.prb_start_idx * SRSRAN_NRE;
-          k_end   = k_start + q->sl_comm_resource_pool.prb_num * SRSRAN_NRE;
-          get_subband_noise(q, k_start, k_end, sf_nsymbols);
-
-          // Second band
-          if ((q->sl_comm_resource_pool.prb_num * 2) >
-              (q->sl_comm_resource_pool.prb_end - q->sl_comm_resource_pool.prb_start + 1)) {
-            k_start = (q->sl_comm_resource_pool.prb_end + 1 - q->sl_comm_resource_pool.prb_num + 1) * SRSRAN_NRE;
-          } else {
-            k_start = (q->sl_comm_resource_pool.prb_end + 1 - q->sl_comm_resource_pool.prb_num) * SRSRAN_NRE;
-          }
-          k_end = k_start + (q->chest_sl_cfg.nof_prb - q->sl_comm_resource_pool.prb_num) * SRSRAN_NRE;
-          get_subband_noise(q, k_start, k_end, sf_nsymbols);
+          k_start[1] = (q->sl_comm_resource_pool.prb_end + 1 - q->sl_comm_resource_pool.prb_num) * SRSRAN_NRE;
         }
-      } else if (q->cell.tm == SRSRAN_SIDELINK_TM3 || q->cell.tm == SRSRAN_SIDELINK_TM4) {
-        k_start = q->chest_sl_cfg.prb_start_idx * SRSRAN_NRE;
-        k_end   = (q->chest_sl_cfg.nof_prb + q->chest_sl_cfg.prb_start_idx) * SRSRAN_NRE;
-        get_subband_noise(q, k_start, k_end, sf_nsymbols);
+        k_end[1] = k_start[1] + (q->chest_sl_cfg.nof_prb - q->sl_comm_resource_pool.prb_num) * SRSRAN_NRE;
+        return 2;
       }
-      break;
+      k_start[0] = q->chest_sl_cfg.prb_start_idx * SRSRAN_NRE;
+      k_end[0]   = (q->chest_sl_cfg.nof_prb + q->chest_sl_cfg.prb_start_idx) * SRSRAN_NRE;
+      return 1;
     default:
-      ERROR("Invalid Sidelink channel");
-      return SRSRAN_ERROR;
+      return 0;
+  }
+}
+
+static bool chest_sl_is_data_symbol(srsran_chest_sl_t* q, uint32_t i)
+{
+  switch (q->channel) {
+    case SRSRAN_SIDELINK_PSBCH:
+      return srsran_psbch_is_symbol(SRSRAN_SIDELINK_DATA_SYMBOL, q->cell.tm, i, q->cell.cp);
+    case SRSRAN_SIDELINK_PSCCH:
+      return srsran_pscch_is_symbol(SRSRAN_SIDELINK_DATA_SYMBOL, q->cell.tm, i, q->cell.cp);
+    case SRSRAN_SIDELINK_PSSCH:
+      return srsran_pssch_is_symbol(SRSRAN_SIDELINK_DATA_SYMBOL, q->cell.tm, i, q->cell.cp);
+    default:
+      return false;
+  }
+}
+
+// Noise estimation over the allocated bands only, ce_average is only written inside them
+static float chest_sl_estimate_noise_bands(srsran_chest_sl_t* q)
+{
+  uint32_t sf_nsymbols = srsran_sl_get_num_symbols(q->cell.tm, q->cell.cp);
+  if (sf_nsymbols == 0) {
+    ERROR("Error estimating channel noise. Invalid number of OFDM symbols.");
+    return SRSRAN_ERROR;
+  }
+
+  uint32_t k_start[2] = {};
+  uint32_t k_end[2]   = {};
+  uint32_t nof_bands  = chest_sl_get_bands(q, k_start, k_end);
+  if (nof_bands == 0) {
+    ERROR("Invalid Sidelink channel");
+    return SRSRAN_ERROR;
+  }
+
+  q->noise_estimated = 0.0;
+  for (uint32_t b = 0; b < nof_bands; b++) {
+    get_subband_noise(q, k_start[b], k_end[b], sf_nsymbols);
   }
   q->noise_estimated = q->noise_estimated / (float)sf_nsymbols;
   return q->noise_estimated;
 }
 
+float srsran_chest_sl_estimate_noise(srsran_chest_sl_t* q)
+{
+  srsran_vec_cf_zero(q->ce_average, q->sf_n_re);
+  return chest_sl_estimate_noise_bands(q);
+}
+
 int srsran_chest_sl_init(srsran_chest_sl_t*                    q,
                          srsran_sl_channels_t                  channel,
                          srsran_cell_sl_t                      cell,
@@ -1111,7 +1149,7 @@ int srsran_chest_sl_get_dmrs(srsran_chest_sl_t* q, cf_t* sf_buffer, cf_t** dmrs_
   return ret;
 }
 
-void srsran_chest_sl_ls_estimate(srsran_chest_sl_t* q, cf_t* sf_buffer)
+static void chest_sl_ls_estimate(srsran_chest_sl_t* q, cf_t* sf_buffer)
 {
   switch (q->channel) {
     case SRSRAN_SIDELINK_PSBCH:
@@ -1125,6 +1163,12 @@ void srsran_chest_sl_ls_estimate(srsran_chest_sl_t* q, cf_t* sf_buffer)
   }
 }
 
+void srsran_chest_sl_ls_estimate(srsran_chest_sl_t* q, cf_t* sf_buffer)
+{
+  srsran_vec_cf_zero(q->ce, q->sf_n_re);
+  chest_sl_ls_estimate(q, sf_buffer);
+}
+
 void srsran_chest_sl_ls_equalize(srsran_chest_sl_t* q, cf_t* sf_buffer, cf_t* equalized_sf_buffer)
 {
   srsran_chest_sl_estimate_noise(q);
@@ -1139,6 +1183,105 @@ void srsran_chest_sl_ls_estimate_equalize(srsran_chest_sl_t* q, cf_t* sf_buffer,
   srsran_chest_sl_ls_equalize(q, sf_buffer, equalized_sf_buffer);
 }
 
+int srsran_chest_sl_pscch_detect_cyclic_shift(srsran_chest_sl_t* q,
+                                              cf_t*              sf_buffer,
+                                              uint32_t           prb_start_idx,
+                                              float              threshold)
+{
+  if (q == NULL || sf_buffer == NULL || q->channel != SRSRAN_SIDELINK_PSCCH) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t nof_cyclic_shifts = (q->cell.tm <= SRSRAN_SIDELINK_TM2) ? SRSRAN_SL_DEFAULT_NOF_DMRS_CYCLIC_SHIFTS
+                                                                     : SRSRAN_SL_MAX_PSCCH_NOF_DMRS_CYCLIC_SHIFTS;
+  float    metric[SRSRAN_SL_MAX_PSCCH_NOF_DMRS_CYCLIC_SHIFTS] = {};
+  float    energy                                            = 0.0f;
+  uint32_t k                                                 = prb_start_idx * SRSRAN_NRE;
+  uint32_t dmrs_idx                                          = 0;
+
+  // Cyclic shifts are spaced by 3, so the phase of a wrong hypothesis rotates by a multiple of pi/2 per subcarrier
+  // and adds up to zero over any SRSRAN_SL_PSCCH_CS_DETECT_WINDOW consecutive subcarriers, while the right one only
+  // leaves the channel, which is flat over such a short window
+  for (uint32_t i = 0; i < srsran_sl_get_num_symbols(q->cell.tm, q->cell.cp); i++) {
+    if (srsran_pscch_is_symbol(SRSRAN_SIDELINK_DMRS_SYMBOL, q->cell.tm, i, q->cell.cp)) {
+      cf_t* dmrs = &sf_buffer[k + i * q->cell.nof_prb * SRSRAN_NRE];
+      energy += crealf(srsran_vec_dot_prod_conj_ccc(dmrs, dmrs, q->M_sc_rs));
+
+      for (uint32_t cs = 0; cs < nof_cyclic_shifts; cs++) {
+        srsran_vec_prod_conj_ccc(dmrs, q->r_sequence[dmrs_idx][cs], q->r_sequence_rx[0], q->M_sc_rs);
+        for (uint32_t n = 0; n + SRSRAN_SL_PSCCH_CS_DETECT_WINDOW <= q->M_sc_rs;
+             n += SRSRAN_SL_PSCCH_CS_DETECT_WINDOW) {
+          cf_t acc = srsran_vec_acc_cc(&q->r_sequence_rx[0][n], SRSRAN_SL_PSCCH_CS_DETECT_WINDOW);
+          metric[cs] += __real__(acc * conjf(acc));
+        }
+      }
+      dmrs_idx++;
+    }
+  }
+
+  // Normalized so that a noiseless DMRS gives 1 and noise alone 1 / SRSRAN_SL_PSCCH_CS_DETECT_WINDOW
+  uint32_t best_cs = 0;
+  for (uint32_t cs = 0; cs < nof_cyclic_shifts; cs++) {
+    metric[cs] = (energy > 0.0f) ? metric[cs] / (energy * SRSRAN_SL_PSCCH_CS_DETECT_WINDOW) : 0.0f;
+    if (metric[cs] > metric[best_cs]) {
+      best_cs = cs;
+    }
+  }
+  q->cyclic_shift_metric = metric[best_cs];
+
+  if (q->cyclic_shift_metric < threshold) {
+    return SRSRAN_ERROR;
+  }
+  return (int)(best_cs * 3);
+}
+
+int srsran_chest_sl_ls_equalize_compact(srsran_chest_sl_t* q, cf_t* sf_buffer, cf_t* equalized_syms)
+{
+  if (q == NULL || sf_buffer == NULL || equalized_syms == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t k_start[2] = {};
+  uint32_t k_end[2]   = {};
+  uint32_t nof_bands  = chest_sl_get_bands(q, k_start, k_end);
+  if (nof_bands == 0) {
+    return SRSRAN_ERROR;
+  }
+
+  chest_sl_estimate_noise_bands(q);
+
+  // Equalize the data REs of the allocation only, in the order they are extracted by the channel
+  uint32_t n_re       = q->cell.nof_prb * SRSRAN_NRE;
+  uint32_t sample_pos = 0;
+  for (uint32_t i = 0; i < srsran_sl_get_num_symbols(q->cell.tm, q->cell.cp); i++) {
+    if (chest_sl_is_data_symbol(q, i)) {
+      for (uint32_t b = 0; b < nof_bands; b++) {
+        srsran_predecoding_single(&sf_buffer[k_start[b] + i * n_re],
+                                  &q->ce_average[k_start[b] + i * n_re],
+                                  &equalized_syms[sample_pos],
+                                  NULL,
+                                  k_end[b] - k_start[b],
+                                  1.0,
+                                  q->noise_estimated);
+        sample_pos += k_end[b] - k_start[b];
+      }
+    }
+  }
+
+  return (int)sample_pos;
+}
+
+int srsran_chest_sl_ls_estimate_equalize_compact(srsran_chest_sl_t* q, cf_t* sf_buffer, cf_t* equalized_syms)
+{
+  if (q == NULL || sf_buffer == NULL || equalized_syms == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // The interpolation fills every symbol of the allocated bands, so nothing outside them needs to be cleared
+  chest_sl_ls_estimate(q, sf_buffer);
+  return srsran_chest_sl_ls_equalize_compact(q, sf_buffer, equalized_syms);
+}
+
 void srsran_chest_sl_free(srsran_chest_sl_t* q)
 {
   if (q != NULL) {
@@ -77,80 +77,122 @@ static inline int parse_model(srsran_channel_fading_t* q, const char* str)
   return ret;
 }
 
-#ifdef LV_HAVE_SSE
+/*
+ * Sine of x + quadrant * pi / 2. The argument is reduced to [-pi/4, pi/4] around the nearest multiple of pi/2, where
+ * the sine and cosine are approximated by polynomials (Cephes single precision coefficients). The quadrant selects
+ * one of them and its sign, so the cosine is the sine of the next quadrant.
+ */
+#define FADING_2_PI 0.636619772367581f
+#define FADING_DP1 1.5703125f
+#define FADING_DP2 4.837512969970703125e-4f
+#define FADING_DP3 7.54978995489188216e-8f
+#define FADING_S0 -1.6666654611e-1f
+#define FADING_S1 8.3321608736e-3f
+#define FADING_S2 -1.9515295891e-4f
+#define FADING_C0 4.166664568298827e-2f
+#define FADING_C1 -1.388731625493765e-3f
+#define FADING_C2 2.443315711809948e-5f
+
+#ifdef LV_HAVE_AVX2
 #include <immintrin.h>
-static inline __m128 _sine(const float* table, __m128 arg)
+static inline __m256 _sine8(__m256 x, int quadrant)
 {
-  __m128 ret;
-  int    idx[4];
-  float  sine[4];
-
-  __m128 turns =
-      _mm_round_ps(_mm_mul_ps(arg, _mm_set1_ps(1.0f / (2.0f * (float)M_PI))), (_MM_FROUND_TO_ZERO + _MM_FROUND_NO_EXC));
-  __m128  argmod   = _mm_sub_ps(arg, _mm_mul_ps(turns, _mm_set1_ps(2.0f * (float)M_PI)));
-  __m128  indexps  = _mm_mul_ps(argmod, _mm_set1_ps(1024.0f / (2.0f * (float)M_PI)));
-  __m128i indexi32 = _mm_abs_epi32(_mm_cvtps_epi32(indexps));
-  _mm_store_si128((__m128i*)idx, indexi32);
-
-  for (int i = 0; i < 4; i++) {
-    sine[i] = table[idx[i]];
-  }
-
-  ret = _mm_load_ps(sine);
-  return ret;
+  __m256  turns = _mm256_mul_ps(x, _mm256_set1_ps(FADING_2_PI));
+  __m256  j     = _mm256_round_ps(turns, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256i q     = _mm256_add_epi32(_mm256_cvtps_epi32(j), _mm256_set1_epi32(quadrant));
+
+  __m256 y = _mm256_sub_ps(x, _mm256_mul_ps(j, _mm256_set1_ps(FADING_DP1)));
+  y        = _mm256_sub_ps(y, _mm256_mul_ps(j, _mm256_set1_ps(FADING_DP2)));
+  y        = _mm256_sub_ps(y, _mm256_mul_ps(j, _mm256_set1_ps(FADING_DP3)));
+  __m256 z = _mm256_mul_ps(y, y);
+
+  __m256 s = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(FADING_S2)), _mm256_set1_ps(FADING_S1));
+  s        = _mm256_add_ps(_mm256_mul_ps(z, s), _mm256_set1_ps(FADING_S0));
+  s        = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(z, y), s), y);
+
+  __m256 c = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(FADING_C2)), _mm256_set1_ps(FADING_C1));
+  c        = _mm256_add_ps(_mm256_mul_ps(z, c), _mm256_set1_ps(FADING_C0));
+  c        = _mm256_mul_ps(_mm256_mul_ps(z, z), c);
+  c        = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(z, _mm256_set1_ps(0.5f))), c);
+
+  // Odd quadrants take the cosine, the second bit of the quadrant is the sign
+  __m256i odd  = _mm256_cmpeq_epi32(_mm256_and_si256(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(1));
+  __m256i sign = _mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30);
+  return _mm256_xor_ps(_mm256_blendv_ps(s, c, _mm256_castsi256_ps(odd)), _mm256_castsi256_ps(sign));
 }
-
-static inline __m128 _cosine(float* table, __m128 arg)
+#elif defined(LV_HAVE_SSE)
+#include <immintrin.h>
+static inline __m128 _sine4(__m128 x, int quadrant)
 {
-  arg = _mm_add_ps(arg, _mm_set1_ps((float)M_PI_2));
-  return _sine(table, arg);
+  __m128  turns = _mm_mul_ps(x, _mm_set1_ps(FADING_2_PI));
+  __m128  j     = _mm_round_ps(turns, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m128i q     = _mm_add_epi32(_mm_cvtps_epi32(j), _mm_set1_epi32(quadrant));
+
+  __m128 y = _mm_sub_ps(x, _mm_mul_ps(j, _mm_set1_ps(FADING_DP1)));
+  y        = _mm_sub_ps(y, _mm_mul_ps(j, _mm_set1_ps(FADING_DP2)));
+  y        = _mm_sub_ps(y, _mm_mul_ps(j, _mm_set1_ps(FADING_DP3)));
+  __m128 z = _mm_mul_ps(y, y);
+
+  __m128 s = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(FADING_S2)), _mm_set1_ps(FADING_S1));
+  s        = _mm_add_ps(_mm_mul_ps(z, s), _mm_set1_ps(FADING_S0));
+  s        = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(z, y), s), y);
+
+  __m128 c = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(FADING_C2)), _mm_set1_ps(FADING_C1));
+  c        = _mm_add_ps(_mm_mul_ps(z, c), _mm_set1_ps(FADING_C0));
+  c        = _mm_mul_ps(_mm_mul_ps(z, z), c);
+  c        = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(z, _mm_set1_ps(0.5f))), c);
+
+  // Odd quadrants take the cosine, the second bit of the quadrant is the sign
+  __m128i odd  = _mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1));
+  __m128i sign = _mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30);
+  return _mm_xor_ps(_mm_blendv_ps(s, c, _mm_castsi128_ps(odd)), _mm_castsi128_ps(sign));
 }
-#endif /*LV_HAVE_SSE*/
+#endif /* LV_HAVE_AVX2 */
 
-static inline cf_t
-get_doppler_dispersion(srsran_channel_fading_t* q, float t, float F_d, float* alpha, float* a, float* b)
+static inline cf_t get_doppler_dispersion(float t, float F_d, const float* alpha, const float* a, const float* b)
 {
-#ifdef LV_HAVE_SSE
-  const float recN   = 1.0f / sqrtf(SRSRAN_CHANNEL_FADING_NTERMS);
-  cf_t        ret    = 0;
-  __m128      _reacc = _mm_setzero_ps();
-  __m128      _imacc = _mm_setzero_ps();
-  __m128      _arg   = _mm_set1_ps((float)M_PI * F_d);
-  __m128      _t     = _mm_set1_ps(t);
-  __m128      _arg_  = (_mm_mul_ps(_arg, _t));
+  const float recN = 1.0f / sqrtf(SRSRAN_CHANNEL_FADING_NTERMS);
+  cf_t        r    = 0;
+#ifdef LV_HAVE_AVX2
+  __m256 _reacc = _mm256_setzero_ps();
+  __m256 _imacc = _mm256_setzero_ps();
+  __m256 _arg   = _mm256_set1_ps((float)M_PI * F_d * t);
+
+  for (int i = 0; i < SRSRAN_CHANNEL_FADING_NTERMS; i += 8) {
+    __m256 _arg1 = _mm256_mul_ps(_arg, _sine8(_mm256_loadu_ps(&alpha[i]), 1));
+    _reacc       = _mm256_add_ps(_reacc, _sine8(_mm256_add_ps(_arg1, _mm256_loadu_ps(&a[i])), 1));
+    _imacc       = _mm256_add_ps(_imacc, _sine8(_mm256_add_ps(_arg1, _mm256_loadu_ps(&b[i])), 0));
+  }
+
+  __m128 _tmp = _mm_hadd_ps(_mm_add_ps(_mm256_castps256_ps128(_reacc), _mm256_extractf128_ps(_reacc, 1)),
+                            _mm_add_ps(_mm256_castps256_ps128(_imacc), _mm256_extractf128_ps(_imacc, 1)));
+  _tmp        = _mm_hadd_ps(_tmp, _tmp);
+  __real__ r  = _mm_cvtss_f32(_tmp);
+  __imag__ r  = _mm_cvtss_f32(_mm_shuffle_ps(_tmp, _tmp, 1));
+#elif defined(LV_HAVE_SSE)
+  __m128 _reacc = _mm_setzero_ps();
+  __m128 _imacc = _mm_setzero_ps();
+  __m128 _arg   = _mm_set1_ps((float)M_PI * F_d * t);
 
   for (int i = 0; i < SRSRAN_CHANNEL_FADING_NTERMS; i += 4) {
-    __m128 _alpha = _mm_loadu_ps(&alpha[i]);
-    __m128 _a     = _mm_loadu_ps(&a[i]);
-    __m128 _b     = _mm_loadu_ps(&b[i]);
-    __m128 _arg1  = _mm_mul_ps(_arg_, _cosine(q->sin_table, _alpha));
-    __m128 _re    = _cosine(q->sin_table, _mm_add_ps(_arg1, _a));
-    __m128 _im    = _sine(q->sin_table, _mm_add_ps(_arg1, _b));
-    _reacc        = _mm_add_ps(_reacc, _re);
-    _imacc        = _mm_add_ps(_imacc, _im);
+    __m128 _arg1 = _mm_mul_ps(_arg, _sine4(_mm_loadu_ps(&alpha[i]), 1));
+    _reacc       = _mm_add_ps(_reacc, _sine4(_mm_add_ps(_arg1, _mm_loadu_ps(&a[i])), 1));
+    _imacc       = _mm_add_ps(_imacc, _sine4(_mm_add_ps(_arg1, _mm_loadu_ps(&b[i])), 0));
   }
 
   __m128 _tmp = _mm_hadd_ps(_reacc, _imacc);
   _tmp        = _mm_hadd_ps(_tmp, _tmp);
-  float r[4];
-  _mm_store_ps(r, _tmp);
-  __real__ ret = r[0];
-  __imag__ ret = r[1];
-
-  return ret * recN;
-
+  __real__ r  = _mm_cvtss_f32(_tmp);
+  __imag__ r  = _mm_cvtss_f32(_mm_shuffle_ps(_tmp, _tmp, 1));
 #else
-  const float recN = 1.0f / sqrtf(SRSRAN_CHANNEL_FADING_NTERMS);
-  cf_t        r    = 0;
-
   for (uint32_t i = 0; i < SRSRAN_CHANNEL_FADING_NTERMS; i++) {
     float arg = (float)M_PI * F_d * cosf(alpha[i]) * t;
     __real__ r += cosf(arg + a[i]);
     __imag__ r += sinf(arg + b[i]);
   }
+#endif /* LV_HAVE_AVX2 */
 
   return recN * r;
-#endif /*LV_HAVE_SSE*/
 }
 
 static inline void generate_tap(float delay_ns, float power_db, float srate, cf_t* buf, uint32_t N, uint32_t path_delay)
@@ -167,7 +209,7 @@ static inline void generate_taps(srsran_channel_fading_t* q, float time)
   // Generate taps
   for (int i = 0; i < nof_taps[q->model]; i++) {
     // Compute phase for the doppler dispersion
-    cf_t a = get_doppler_dispersion(q, time, q->doppler, q->coeff_alpha[i], q->coeff_a[i], q->coeff_b[i]);
+    cf_t a = get_doppler_dispersion(time, q->doppler, q->coeff_alpha[i], q->coeff_a[i], q->coeff_b[i]);
 
     if (i) {
       // Copy tap frequency response
@@ -185,6 +227,12 @@ static inline void generate_taps(srsran_channel_fading_t* q, float time)
   // at this stage, q->h_freq should contain the frequency response
 }
 
+static inline uint32_t get_fft_size(srsran_channel_fading_model_t model, double srate)
+{
+  uint32_t fft_min_pow = (uint32_t)round(log2(excess_tap_delay_ns[model][nof_taps[model] - 1] * 1e-9 * srate)) + 3;
+  return SRSRAN_MAX(1U << fft_min_pow, (uint32_t)(srate / (15e3f * 4.0f)));
+}
+
 static inline void filter_segment(srsran_channel_fading_t* q, const cf_t* input, cf_t* output, uint32_t nsamples)
 {
   // Fill Input vector
@@ -226,9 +274,7 @@ int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const c
     q->srate = (float)srate;
 
     // Populate internal parameters
-    uint32_t fft_min_pow =
-        (uint32_t)round(log2(excess_tap_delay_ns[q->model][nof_taps[q->model] - 1] * 1e-9 * srate)) + 3;
-    q->N          = SRSRAN_MAX(1U << fft_min_pow, (uint32_t)(srate / (15e3f * 4.0f)));
+    q->N          = get_fft_size(q->model, srate);
     q->path_delay = q->N / 4;
     q->state_len  = 0;
 
@@ -252,11 +298,6 @@ int srsran_channel_fading_init(srsran_channel_fading_t* q, double srate, const c
           excess_tap_delay_ns[q->model][i], relative_power_db[q->model][i], q->srate, q->h_tap[i], q->N, q->path_delay);
     }
 
-    // Generate sine Table
-    for (uint32_t i = 0; i < 1024; i++) {
-      q->sin_table[i] = sinf((float)i * 2.0f * (float)M_PI / 1024);
-    }
-
     // Free random
     srsran_random_free(random);
 
@@ -335,6 +376,22 @@ void srsran_channel_fading_free(srsran_channel_fading_t* q)
   }
 }
 
+void srsran_channel_fading_set_doppler(srsran_channel_fading_t* q, float doppler_hz)
+{
+  if (q) {
+    q->doppler = isfinite(doppler_hz) ? fabsf(doppler_hz) : 0.0f;
+  }
+}
+
+uint32_t srsran_channel_fading_latency(double srate, const char* model)
+{
+  srsran_channel_fading_t q = {};
+  if (model == NULL || parse_model(&q, model) != SRSRAN_SUCCESS) {
+    return 0;
+  }
+  return get_fft_size(q.model, srate) / 4;
+}
+
 double srsran_channel_fading_execute(srsran_channel_fading_t* q,
                                      const cf_t*              in,
                                      cf_t*                    out,
@@ -0,0 +1,303 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/channel/multilink.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define MULTILINK_SPEED_OF_LIGHT 299792458.0
+#define MULTILINK_MAX_MODEL_LEN 16
+
+static const char* fading_models[] = {"none0", "epa0", "eva0", "etu0"};
+
+/// Delay line length of a link for a propagation delay, or a negative value if it exceeds the maximum
+static int multilink_delay_nsamples(const srsran_channel_multilink_t*      q,
+                                    const srsran_channel_multilink_link_t* l,
+                                    float                                  delay_us)
+{
+  uint32_t delay_nsamples = (uint32_t)round(SRSRAN_MAX(delay_us, 0.0f) * 1e-6 * q->srate) + q->latency;
+  if (delay_nsamples > q->max_delay_nsamples) {
+    return SRSRAN_ERROR;
+  }
+
+  // The fading filter delays the signal by its path delay, the delay line adds the rest of the common latency
+  if (l->fading_enabled) {
+    delay_nsamples -= l->fading.path_delay;
+  }
+  return (int)delay_nsamples;
+}
+
+int srsran_channel_multilink_init(srsran_channel_multilink_t* q,
+                                  double                      srate,
+                                  double                      carrier_freq_hz,
+                                  uint32_t                    max_links,
+                                  uint32_t                    max_nsamples,
+                                  float                       max_delay_us)
+{
+  if (q == NULL || srate <= 0 || max_links == 0 || max_nsamples == 0 || max_delay_us < 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  bzero(q, sizeof(srsran_channel_multilink_t));
+
+  q->srate           = srate;
+  q->carrier_freq_hz = carrier_freq_hz;
+  q->max_links       = max_links;
+  q->max_nsamples    = max_nsamples;
+
+  // The common latency is the largest fading filter latency, so that any model can be compensated
+  for (uint32_t i = 0; i < sizeof(fading_models) / sizeof(fading_models[0]); i++) {
+    q->latency = SRSRAN_MAX(q->latency, srsran_channel_fading_latency(srate, fading_models[i]));
+  }
+  q->max_delay_nsamples = (uint32_t)ceil(max_delay_us * 1e-6 * srate) + q->latency;
+
+  q->links = calloc(max_links, sizeof(srsran_channel_multilink_link_t));
+  if (q->links == NULL) {
+    ERROR("Error allocating memory");
+    goto clean_exit;
+  }
+  for (uint32_t i = 0; i < max_links; i++) {
+    q->links[i].delay_state = srsran_vec_cf_malloc(SRSRAN_MAX(q->max_delay_nsamples, 1));
+    if (q->links[i].delay_state == NULL) {
+      ERROR("Error allocating memory");
+      goto clean_exit;
+    }
+  }
+
+  q->zeros     = srsran_vec_cf_malloc(max_nsamples);
+  q->delay_buf = srsran_vec_cf_malloc(q->max_delay_nsamples + max_nsamples);
+  q->link_buf  = srsran_vec_cf_malloc(max_nsamples);
+  q->phase_buf = srsran_vec_cf_malloc(max_nsamples);
+  if (q->zeros == NULL || q->delay_buf == NULL || q->link_buf == NULL || q->phase_buf == NULL) {
+    ERROR("Error allocating memory");
+    goto clean_exit;
+  }
+  srsran_vec_cf_zero(q->zeros, max_nsamples);
+
+  if (srsran_channel_awgn_init(&q->awgn, 0)) {
+    ERROR("Error initiating AWGN channel");
+    goto clean_exit;
+  }
+
+  return SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_channel_multilink_free(q);
+  return SRSRAN_ERROR;
+}
+
+void srsran_channel_multilink_free(srsran_channel_multilink_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  if (q->links) {
+    for (uint32_t i = 0; i < q->max_links; i++) {
+      srsran_channel_multilink_disable_link(q, i);
+      if (q->links[i].delay_state) {
+        free(q->links[i].delay_state);
+      }
+    }
+    free(q->links);
+  }
+  if (q->zeros) {
+    free(q->zeros);
+  }
+  if (q->delay_buf) {
+    free(q->delay_buf);
+  }
+  if (q->link_buf) {
+    free(q->link_buf);
+  }
+  if (q->phase_buf) {
+    free(q->phase_buf);
+  }
+  srsran_channel_awgn_free(&q->awgn);
+
+  bzero(q, sizeof(srsran_channel_multilink_t));
+}
+
+int srsran_channel_multilink_set_link(srsran_channel_multilink_t*           q,
+                                      uint32_t                              link,
+                                      const srsran_channel_multilink_cfg_t* cfg)
+{
+  if (q == NULL || cfg == NULL || link >= q->max_links) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  srsran_channel_multilink_link_t* l = &q->links[link];
+  srsran_channel_multilink_disable_link(q, link);
+
+  if (cfg->model) {
+    // The Doppler frequency follows the speed of the link, the model is initiated without it
+    char model[MULTILINK_MAX_MODEL_LEN];
+    snprintf(model, sizeof(model), "%s0", cfg->model);
+    bzero(&l->fading, sizeof(srsran_channel_fading_t));
+    if (srsran_channel_fading_init(&l->fading, q->srate, model, cfg->seed)) {
+      ERROR("Error initiating fading model '%s' of link %d", cfg->model, link);
+      srsran_channel_fading_free(&l->fading);
+      return SRSRAN_ERROR;
+    }
+    l->fading_enabled = true;
+  }
+
+  if (multilink_delay_nsamples(q, l, cfg->delay_us) < 0) {
+    ERROR("Delay %.1f us of link %d exceeds the maximum", cfg->delay_us, link);
+    srsran_channel_multilink_disable_link(q, link);
+    return SRSRAN_ERROR;
+  }
+
+  // Empty delay line, the geometry sets its length
+  l->enabled        = true;
+  l->cfo_hz         = cfg->cfo_hz;
+  l->phase          = 1.0f;
+  l->delay_nsamples = 0;
+
+  return srsran_channel_multilink_set_geometry(q, link, cfg->path_loss_db, cfg->delay_us, cfg->speed_kmh);
+}
+
+int srsran_channel_multilink_set_geometry(srsran_channel_multilink_t* q,
+                                          uint32_t                    link,
+                                          float                       path_loss_db,
+                                          float                       delay_us,
+                                          float                       speed_kmh)
+{
+  if (q == NULL || link >= q->max_links || !q->links[link].enabled) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  srsran_channel_multilink_link_t* l              = &q->links[link];
+  int                              delay_nsamples = multilink_delay_nsamples(q, l, delay_us);
+  if (delay_nsamples < 0) {
+    ERROR("Delay %.1f us of link %d exceeds the maximum", delay_us, link);
+    return SRSRAN_ERROR;
+  }
+
+  // Doppler frequency of the relative speed, spread by the fading model or shifting a line-of-sight link
+  float doppler_hz = (float)(speed_kmh / 3.6 * q->carrier_freq_hz / MULTILINK_SPEED_OF_LIGHT);
+  float freq_hz    = l->cfo_hz;
+  if (l->fading_enabled) {
+    srsran_channel_fading_set_doppler(&l->fading, doppler_hz);
+  } else {
+    freq_hz += doppler_hz;
+  }
+  l->freq_norm = freq_hz / (float)q->srate;
+  l->gain      = srsran_convert_dB_to_amplitude(-path_loss_db);
+
+  // Keep the newest samples of the delay line, zeros fill a longer one
+  uint32_t d = (uint32_t)delay_nsamples;
+  if (d > l->delay_nsamples) {
+    memmove(&l->delay_state[d - l->delay_nsamples], l->delay_state, sizeof(cf_t) * l->delay_nsamples);
+    srsran_vec_cf_zero(l->delay_state, d - l->delay_nsamples);
+  } else if (d < l->delay_nsamples) {
+    memmove(l->delay_state, &l->delay_state[l->delay_nsamples - d], sizeof(cf_t) * d);
+  }
+  l->delay_nsamples = d;
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_channel_multilink_disable_link(srsran_channel_multilink_t* q, uint32_t link)
+{
+  if (q == NULL || q->links == NULL || link >= q->max_links) {
+    return;
+  }
+
+  srsran_channel_multilink_link_t* l = &q->links[link];
+  if (l->fading_enabled) {
+    srsran_channel_fading_free(&l->fading);
+  }
+  l->enabled        = false;
+  l->fading_enabled = false;
+}
+
+int srsran_channel_multilink_set_n0(srsran_channel_multilink_t* q, float n0_dBfs)
+{
+  if (q == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  q->awgn_enabled = isfinite(n0_dBfs);
+  if (q->awgn_enabled) {
+    return srsran_channel_awgn_set_n0(&q->awgn, n0_dBfs);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+uint32_t srsran_channel_multilink_latency(const srsran_channel_multilink_t* q)
+{
+  return q ? q->latency : 0;
+}
+
+int srsran_channel_multilink_execute(srsran_channel_multilink_t* q, const cf_t* in[], cf_t* out, uint32_t nsamples)
+{
+  if (q == NULL || in == NULL || out == NULL || nsamples > q->max_nsamples) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  srsran_vec_cf_zero(out, nsamples);
+
+  for (uint32_t i = 0; i < q->max_links; i++) {
+    srsran_channel_multilink_link_t* l = &q->links[i];
+    if (!l->enabled) {
+      continue;
+    }
+    const cf_t* x = in[i] ? in[i] : q->zeros;
+
+    // Delay line: the state followed by the input, the first samples go through the link and the last ones remain
+    if (l->delay_nsamples) {
+      srsran_vec_cf_copy(q->delay_buf, l->delay_state, l->delay_nsamples);
+      srsran_vec_cf_copy(&q->delay_buf[l->delay_nsamples], x, nsamples);
+      srsran_vec_cf_copy(l->delay_state, &q->delay_buf[nsamples], l->delay_nsamples);
+      x = q->delay_buf;
+    }
+
+    if (l->fading_enabled) {
+      srsran_channel_fading_execute(&l->fading, x, q->link_buf, nsamples, q->time);
+      x = q->link_buf;
+    }
+
+    // Path loss and frequency shift, continuous across executions
+    if (l->freq_norm != 0.0f) {
+      cf_t osc = srsran_vec_gen_sine(l->gain * l->phase, l->freq_norm, q->phase_buf, (int)nsamples);
+      l->phase *= osc;
+      l->phase /= cabsf(l->phase);
+      srsran_vec_prod_ccc(x, q->phase_buf, q->link_buf, nsamples);
+    } else {
+      srsran_vec_sc_prod_cfc(x, l->gain, q->link_buf, nsamples);
+    }
+    srsran_vec_sum_ccc(out, q->link_buf, out, nsamples);
+  }
+  q->time += nsamples / q->srate;
+
+  if (q->awgn_enabled) {
+    srsran_channel_awgn_run_c(&q->awgn, out, out, nsamples);
+  }
+
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,297 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsran/phy/channel/multilink.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static uint32_t nof_links   = 8;
+static double   srate       = 15.36e6;
+static double   carrier     = 5.9e9;
+static uint32_t duration_ms = 20;
+
+#define MAX_DELAY_US 20.0f
+#define TOLERANCE 1e-3f
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [lsft]\n", prog);
+  printf("\t-l Number of links mixed: [Default %d]\n", nof_links);
+  printf("\t-s Sampling rate in Hz: [Default %.2f MHz]\n", srate / 1e6);
+  printf("\t-f Carrier frequency in Hz: [Default %.2f GHz]\n", carrier / 1e9);
+  printf("\t-t Simulation time in ms: [Default %d]\n", duration_ms);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "lsft")) != -1) {
+    switch (opt) {
+      case 'l':
+        nof_links = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        srate = strtod(argv[optind], NULL);
+        break;
+      case 'f':
+        carrier = strtod(argv[optind], NULL);
+        break;
+      case 't':
+        duration_ms = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static float max_error(const cf_t* x, const cf_t* ref, uint32_t len)
+{
+  float err = 0.0f;
+  for (uint32_t i = 0; i < len; i++) {
+    err = SRSRAN_MAX(err, cabsf(x[i] - ref[i]));
+  }
+  return err;
+}
+
+/// Runs the emulator on blocks of block_len samples, or of varying length if it is 0 to check that the links are
+/// continuous across executions
+static int run_blocks(srsran_channel_multilink_t* q, cf_t** in, cf_t* out, uint32_t len, uint32_t block_len)
+{
+  const cf_t* block_in[q->max_links];
+  uint32_t    n        = 0;
+  uint32_t    nsamples = 1;
+  while (n < len) {
+    nsamples = block_len ? block_len : (nsamples * 7 + 3) % q->max_nsamples + 1;
+    nsamples = SRSRAN_MIN(nsamples, len - n);
+    for (uint32_t i = 0; i < q->max_links; i++) {
+      block_in[i] = in[i] ? &in[i][n] : NULL;
+    }
+    TESTASSERT(srsran_channel_multilink_execute(q, block_in, &out[n], nsamples) == SRSRAN_SUCCESS);
+    n += nsamples;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+/// The fading output of a flat model is the input scaled by the Doppler dispersion of each filter segment, which is
+/// computed here with the scalar functions of the C library
+static int test_fading_dispersion(srsran_random_t random_gen)
+{
+  srsran_channel_fading_t fading = {};
+  TESTASSERT(srsran_channel_fading_init(&fading, srate, "none0", 0x1234) == SRSRAN_SUCCESS);
+  srsran_channel_fading_set_doppler(&fading, 1000.0f);
+  TESTASSERT(srsran_channel_fading_latency(srate, "none0") == fading.path_delay);
+
+  uint32_t len = 16 * fading.N;
+  cf_t*    in  = srsran_vec_cf_malloc(len);
+  cf_t*    out = srsran_vec_cf_malloc(len);
+  TESTASSERT(in != NULL && out != NULL);
+  for (uint32_t i = 0; i < len; i++) {
+    in[i] = srsran_random_uniform_complex_dist(random_gen, -1.0f, 1.0f);
+  }
+  srsran_channel_fading_execute(&fading, in, out, len, 0.1);
+
+  float err = 0.0f;
+  for (uint32_t i = 0; i + fading.path_delay < len; i++) {
+    float t = (float)(0.1 + (i / (fading.N / 2)) * (fading.N / 2) / srate);
+    cf_t  h = 0;
+    for (uint32_t j = 0; j < SRSRAN_CHANNEL_FADING_NTERMS; j++) {
+      float arg = (float)M_PI * fading.doppler * cosf(fading.coeff_alpha[0][j]) * t;
+      h += cosf(arg + fading.coeff_a[0][j]) + _Complex_I * sinf(arg + fading.coeff_b[0][j]);
+    }
+    h /= sqrtf(SRSRAN_CHANNEL_FADING_NTERMS);
+    err = SRSRAN_MAX(err, cabsf(out[i + fading.path_delay] - h * in[i]));
+  }
+  TESTASSERT(err < TOLERANCE);
+
+  free(in);
+  free(out);
+  srsran_channel_fading_free(&fading);
+  return SRSRAN_SUCCESS;
+}
+
+/// Line-of-sight links follow the configured path loss, delay and Doppler shift, a flat fading link is delayed as much
+static int test_geometry(srsran_random_t random_gen)
+{
+  const uint32_t             len   = duration_ms * (uint32_t)(srate / 1000);
+  srsran_channel_multilink_t q     = {};
+  cf_t*                      in[4] = {};
+  cf_t*                      out   = srsran_vec_cf_malloc(len);
+  cf_t*                      ref   = srsran_vec_cf_malloc(len);
+  TESTASSERT(out != NULL && ref != NULL);
+  for (uint32_t i = 0; i < 4; i++) {
+    in[i] = srsran_vec_cf_malloc(len);
+    TESTASSERT(in[i] != NULL);
+    for (uint32_t j = 0; j < len; j++) {
+      in[i][j] = srsran_random_uniform_complex_dist(random_gen, -1.0f, 1.0f);
+    }
+  }
+  TESTASSERT(srsran_channel_multilink_init(&q, srate, carrier, 4, 1000, MAX_DELAY_US) == SRSRAN_SUCCESS);
+  uint32_t latency = srsran_channel_multilink_latency(&q);
+
+  // Path loss and delay
+  srsran_channel_multilink_cfg_t cfg = {};
+  cfg.path_loss_db                   = 6.0f;
+  cfg.delay_us                       = 10.0f;
+  TESTASSERT(srsran_channel_multilink_set_link(&q, 0, &cfg) == SRSRAN_SUCCESS);
+  TESTASSERT(run_blocks(&q, in, out, len, 0) == SRSRAN_SUCCESS);
+  uint32_t d    = (uint32_t)round(cfg.delay_us * 1e-6 * srate) + latency;
+  float    gain = srsran_convert_dB_to_amplitude(-cfg.path_loss_db);
+  srsran_vec_cf_zero(ref, d);
+  srsran_vec_sc_prod_cfc(in[0], gain, &ref[d], len - d);
+  TESTASSERT(max_error(out, ref, len) < TOLERANCE);
+
+  // Doppler shift of the relative speed, on top of the oscillator offset
+  srsran_channel_multilink_disable_link(&q, 0);
+  cfg.path_loss_db = 0.0f;
+  cfg.delay_us     = 0.0f;
+  cfg.speed_kmh    = 120.0f;
+  cfg.cfo_hz       = 100.0f;
+  TESTASSERT(srsran_channel_multilink_set_link(&q, 1, &cfg) == SRSRAN_SUCCESS);
+  TESTASSERT(run_blocks(&q, in, out, len, 0) == SRSRAN_SUCCESS);
+  double freq = cfg.speed_kmh / 3.6 * carrier / 299792458.0 + cfg.cfo_hz;
+  srsran_vec_cf_zero(ref, latency);
+  for (uint32_t i = latency; i < len; i++) {
+    ref[i] = in[1][i - latency] * cexp(_Complex_I * 2.0 * M_PI * freq * (double)i / srate);
+  }
+  TESTASSERT(max_error(out, ref, len) < TOLERANCE);
+
+  // A flat fading link without Doppler is a constant gain, with the same delay
+  srsran_channel_multilink_disable_link(&q, 1);
+  cfg.model     = "none";
+  cfg.speed_kmh = 0.0f;
+  cfg.cfo_hz    = 0.0f;
+  cfg.delay_us  = 10.0f;
+  TESTASSERT(srsran_channel_multilink_set_link(&q, 2, &cfg) == SRSRAN_SUCCESS);
+  TESTASSERT(run_blocks(&q, in, out, len, 0) == SRSRAN_SUCCESS);
+  d = (uint32_t)round(cfg.delay_us * 1e-6 * srate) + latency;
+  TESTASSERT(cabsf(in[2][0]) > 0.1f);
+  cf_t h = out[d] / in[2][0];
+  srsran_vec_cf_zero(ref, d);
+  srsran_vec_sc_prod_ccc(in[2], h, &ref[d], len - d);
+  TESTASSERT(max_error(out, ref, len) < TOLERANCE);
+
+  // Delays beyond the maximum are rejected, moving a link keeps the signal in the delay line
+  TESTASSERT(srsran_channel_multilink_set_geometry(&q, 2, 0.0f, 2.0f * MAX_DELAY_US, 0.0f) == SRSRAN_ERROR);
+  TESTASSERT(srsran_channel_multilink_set_geometry(&q, 3, 0.0f, 0.0f, 0.0f) == SRSRAN_ERROR_INVALID_INPUTS);
+  TESTASSERT(srsran_channel_multilink_set_geometry(&q, 2, 0.0f, 15.0f, 0.0f) == SRSRAN_SUCCESS);
+
+  for (uint32_t i = 0; i < 4; i++) {
+    free(in[i]);
+  }
+  free(out);
+  free(ref);
+  srsran_channel_multilink_free(&q);
+  return SRSRAN_SUCCESS;
+}
+
+/// The mix of all the links is the sum of each link alone, and the time to mix them is measured
+static int test_mix(srsran_random_t random_gen)
+{
+  const char*                    models[] = {NULL, "epa", "eva", "etu"};
+  const uint32_t                 sf_len   = (uint32_t)(srate / 1000);
+  const uint32_t                 len      = duration_ms * sf_len;
+  srsran_channel_multilink_t     mix      = {};
+  srsran_channel_multilink_t     single   = {};
+  cf_t**                         in       = calloc(nof_links, sizeof(cf_t*));
+  cf_t*                          out      = srsran_vec_cf_malloc(len);
+  cf_t*                          sum      = srsran_vec_cf_malloc(len);
+  cf_t*                          tmp      = srsran_vec_cf_malloc(len);
+  TESTASSERT(in != NULL && out != NULL && sum != NULL && tmp != NULL);
+
+  srsran_channel_multilink_cfg_t cfg[nof_links];
+
+  TESTASSERT(srsran_channel_multilink_init(&mix, srate, carrier, nof_links, sf_len, MAX_DELAY_US) == SRSRAN_SUCCESS);
+  for (uint32_t i = 0; i < nof_links; i++) {
+    in[i] = srsran_vec_cf_malloc(len);
+    TESTASSERT(in[i] != NULL);
+    for (uint32_t j = 0; j < len; j++) {
+      in[i][j] = srsran_random_uniform_complex_dist(random_gen, -1.0f, 1.0f);
+    }
+    cfg[i]              = (srsran_channel_multilink_cfg_t){};
+    cfg[i].path_loss_db = srsran_random_uniform_real_dist(random_gen, 0.0f, 20.0f);
+    cfg[i].delay_us     = srsran_random_uniform_real_dist(random_gen, 0.0f, MAX_DELAY_US);
+    cfg[i].speed_kmh    = srsran_random_uniform_real_dist(random_gen, -250.0f, 250.0f);
+    cfg[i].cfo_hz       = srsran_random_uniform_real_dist(random_gen, -500.0f, 500.0f);
+    cfg[i].model        = models[i % 4];
+    cfg[i].seed         = i;
+    TESTASSERT(srsran_channel_multilink_set_link(&mix, i, &cfg[i]) == SRSRAN_SUCCESS);
+  }
+
+  struct timeval t[3];
+  gettimeofday(&t[1], NULL);
+  TESTASSERT(run_blocks(&mix, in, out, len, sf_len) == SRSRAN_SUCCESS);
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+
+  srsran_vec_cf_zero(sum, len);
+  for (uint32_t i = 0; i < nof_links; i++) {
+    TESTASSERT(srsran_channel_multilink_init(&single, srate, carrier, nof_links, sf_len, MAX_DELAY_US) ==
+               SRSRAN_SUCCESS);
+    TESTASSERT(srsran_channel_multilink_set_link(&single, i, &cfg[i]) == SRSRAN_SUCCESS);
+    TESTASSERT(run_blocks(&single, in, tmp, len, sf_len) == SRSRAN_SUCCESS);
+    srsran_vec_sum_ccc(sum, tmp, sum, len);
+    srsran_channel_multilink_free(&single);
+  }
+  TESTASSERT(max_error(out, sum, len) < TOLERANCE);
+
+  double elapsed_us = t[0].tv_sec * 1e6 + t[0].tv_usec;
+  printf("%d links, %d ms: %.1f ms, %.1f MSps per link\n",
+         nof_links,
+         duration_ms,
+         elapsed_us / 1000.0,
+         (double)len * nof_links / elapsed_us);
+
+  for (uint32_t i = 0; i < nof_links; i++) {
+    free(in[i]);
+  }
+  free(in);
+  free(out);
+  free(sum);
+  free(tmp);
+  srsran_channel_multilink_free(&mix);
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  srsran_random_t random_gen = srsran_random_init(0x1234);
+
+  parse_args(argc, argv);
+
+  TESTASSERT(test_fading_dispersion(random_gen) == SRSRAN_SUCCESS);
+  TESTASSERT(test_geometry(random_gen) == SRSRAN_SUCCESS);
+  TESTASSERT(test_mix(random_gen) == SRSRAN_SUCCESS);
+
+  srsran_random_free(random_gen);
+
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
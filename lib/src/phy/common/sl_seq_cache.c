@@ -0,0 +1,315 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "srsran/phy/common/sl_seq_cache.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+
+typedef struct {
+  bool              valid;    // Sequence is generated and can be returned
+  bool              pending;  // Sequence is being generated by the user that missed it
+  uint32_t          seed;     // c_init, unique for each (N_x_id, sf_idx)
+  uint32_t          refcount; // Number of users, pinned entries are never evicted
+  uint64_t          last_use;
+  srsran_sequence_t seq;
+} sl_seq_cache_scrambling_entry_t;
+
+typedef struct {
+  bool           valid;
+  srsran_sl_tm_t tm;
+  uint32_t       N_x_id;
+  uint32_t       sf_idx;
+  uint32_t       nof_prb;
+  uint32_t       nof_dmrs_symbols;
+  uint64_t       last_use;
+  cf_t*          r_sequence; // nof_dmrs_symbols sequences of nof_prb * SRSRAN_NRE samples
+} sl_seq_cache_dmrs_entry_t;
+
+static pthread_mutex_t                 cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t                  cache_cvar  = PTHREAD_COND_INITIALIZER; // Signals the end of a generation
+static uint64_t                        cache_tick  = 0;
+static sl_seq_cache_scrambling_entry_t scrambling_entries[SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES];
+static sl_seq_cache_dmrs_entry_t       dmrs_entries[SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES];
+static srsran_sl_seq_cache_stats_t     scrambling_stats;
+static srsran_sl_seq_cache_stats_t     dmrs_stats;
+
+// 3GPP TS 36.211 version 15.6.0 Release 15 Sec. 9.3.1
+static uint32_t sl_seq_cache_scrambling_seed(uint32_t N_x_id, uint32_t sf_idx)
+{
+  return N_x_id * 16384 + (sf_idx % 10) * 512 + 510;
+}
+
+/// Picks an empty entry or, if there is none, the least recently used entry which is not pinned
+static int sl_seq_cache_scrambling_victim(void)
+{
+  int victim = -1;
+  for (int i = 0; i < SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES; i++) {
+    sl_seq_cache_scrambling_entry_t* e = &scrambling_entries[i];
+    if (e->refcount > 0) {
+      continue;
+    }
+    if (!e->valid) {
+      return i;
+    }
+    if (victim < 0 || e->last_use < scrambling_entries[victim].last_use) {
+      victim = i;
+    }
+  }
+  return victim;
+}
+
+srsran_sequence_t* srsran_sl_seq_cache_scrambling_acquire(uint32_t N_x_id, uint32_t sf_idx, uint32_t len)
+{
+  uint32_t seed = sl_seq_cache_scrambling_seed(N_x_id, sf_idx);
+
+  pthread_mutex_lock(&cache_mutex);
+
+  // If the sequence of this seed is being generated, wait for it and look it up again, so that a seed never has a
+  // second entry
+  for (int i = 0; i < SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES; i++) {
+    sl_seq_cache_scrambling_entry_t* e = &scrambling_entries[i];
+    if (e->pending && e->seed == seed) {
+      while (e->pending) {
+        pthread_cond_wait(&cache_cvar, &cache_mutex);
+      }
+      i = -1;
+    }
+  }
+
+  // Any cached sequence with the same seed is valid as long as it is long enough
+  for (int i = 0; i < SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES; i++) {
+    sl_seq_cache_scrambling_entry_t* e = &scrambling_entries[i];
+    if (e->valid && e->seed == seed && e->seq.cur_len >= len) {
+      e->refcount++;
+      e->last_use = ++cache_tick;
+      scrambling_stats.nof_hits++;
+      pthread_mutex_unlock(&cache_mutex);
+      return &e->seq;
+    }
+  }
+
+  scrambling_stats.nof_misses++;
+
+  // A shorter sequence with the same seed is replaced by the longer one, so that a seed has a single entry. If it is
+  // pinned, it is only invalidated, and its slot is reused once it is released
+  int victim = -1;
+  for (int i = 0; i < SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES; i++) {
+    sl_seq_cache_scrambling_entry_t* e = &scrambling_entries[i];
+    if (e->valid && e->seed == seed) {
+      if (e->refcount == 0 && victim < 0) {
+        victim = i;
+      } else {
+        e->valid = false;
+        scrambling_stats.nof_evictions++;
+      }
+    }
+  }
+  if (victim < 0) {
+    victim = sl_seq_cache_scrambling_victim();
+  }
+  if (victim < 0) {
+    pthread_mutex_unlock(&cache_mutex);
+    return NULL;
+  }
+
+  // Pin the entry and generate the sequence without holding the lock
+  sl_seq_cache_scrambling_entry_t* e = &scrambling_entries[victim];
+  if (e->valid) {
+    scrambling_stats.nof_evictions++;
+  }
+  e->valid    = false;
+  e->pending  = true;
+  e->seed     = seed;
+  e->refcount = 1;
+  e->last_use = ++cache_tick;
+  pthread_mutex_unlock(&cache_mutex);
+
+  int ret = srsran_sequence_LTE_pr(&e->seq, len, seed);
+
+  pthread_mutex_lock(&cache_mutex);
+  e->pending = false;
+  pthread_cond_broadcast(&cache_cvar);
+  if (ret != SRSRAN_SUCCESS) {
+    ERROR("Error generating PSSCH scrambling sequence");
+    e->refcount = 0;
+    pthread_mutex_unlock(&cache_mutex);
+    return NULL;
+  }
+  e->valid = true;
+  pthread_mutex_unlock(&cache_mutex);
+
+  return &e->seq;
+}
+
+void srsran_sl_seq_cache_scrambling_release(srsran_sequence_t* seq)
+{
+  if (seq == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&cache_mutex);
+  for (int i = 0; i < SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES; i++) {
+    if (&scrambling_entries[i].seq == seq && scrambling_entries[i].refcount > 0) {
+      scrambling_entries[i].refcount--;
+      break;
+    }
+  }
+  pthread_mutex_unlock(&cache_mutex);
+}
+
+static bool sl_seq_cache_dmrs_match(const sl_seq_cache_dmrs_entry_t* e,
+                                    srsran_sl_tm_t                   tm,
+                                    uint32_t                         N_x_id,
+                                    uint32_t                         sf_idx,
+                                    uint32_t                         nof_prb,
+                                    uint32_t                         nof_dmrs_symbols)
+{
+  return e->valid && e->tm == tm && e->N_x_id == N_x_id && e->sf_idx == sf_idx && e->nof_prb == nof_prb &&
+         e->nof_dmrs_symbols == nof_dmrs_symbols;
+}
+
+// TM1/2 DMRS do not hop with the subframe, so all subframes share the same entry
+static uint32_t sl_seq_cache_dmrs_sf_idx(srsran_sl_tm_t tm, uint32_t sf_idx)
+{
+  return (tm <= SRSRAN_SIDELINK_TM2) ? 0 : sf_idx % 10;
+}
+
+bool srsran_sl_seq_cache_dmrs_get(srsran_sl_tm_t tm,
+                                  uint32_t       N_x_id,
+                                  uint32_t       sf_idx,
+                                  uint32_t       nof_prb,
+                                  uint32_t       nof_dmrs_symbols,
+                                  cf_t**         r_sequence)
+{
+  uint32_t M_sc_rs = nof_prb * SRSRAN_NRE;
+  sf_idx           = sl_seq_cache_dmrs_sf_idx(tm, sf_idx);
+
+  pthread_mutex_lock(&cache_mutex);
+  for (int i = 0; i < SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES; i++) {
+    sl_seq_cache_dmrs_entry_t* e = &dmrs_entries[i];
+    if (sl_seq_cache_dmrs_match(e, tm, N_x_id, sf_idx, nof_prb, nof_dmrs_symbols)) {
+      for (uint32_t j = 0; j < nof_dmrs_symbols; j++) {
+        srsran_vec_cf_copy(r_sequence[j], &e->r_sequence[j * M_sc_rs], M_sc_rs);
+      }
+      e->last_use = ++cache_tick;
+      dmrs_stats.nof_hits++;
+      pthread_mutex_unlock(&cache_mutex);
+      return true;
+    }
+  }
+  dmrs_stats.nof_misses++;
+  pthread_mutex_unlock(&cache_mutex);
+
+  return false;
+}
+
+void srsran_sl_seq_cache_dmrs_put(srsran_sl_tm_t tm,
+                                  uint32_t       N_x_id,
+                                  uint32_t       sf_idx,
+                                  uint32_t       nof_prb,
+                                  uint32_t       nof_dmrs_symbols,
+                                  cf_t**         r_sequence)
+{
+  uint32_t M_sc_rs = nof_prb * SRSRAN_NRE;
+  sf_idx           = sl_seq_cache_dmrs_sf_idx(tm, sf_idx);
+
+  if (nof_dmrs_symbols > SRSRAN_SL_TM34_DEFAULT_NUM_DMRS_SYMBOLS || nof_prb > SRSRAN_MAX_PRB) {
+    return;
+  }
+
+  pthread_mutex_lock(&cache_mutex);
+
+  int victim = -1;
+  for (int i = 0; i < SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES; i++) {
+    sl_seq_cache_dmrs_entry_t* e = &dmrs_entries[i];
+    if (sl_seq_cache_dmrs_match(e, tm, N_x_id, sf_idx, nof_prb, nof_dmrs_symbols)) {
+      // Another user stored it in the meantime
+      pthread_mutex_unlock(&cache_mutex);
+      return;
+    }
+    if (victim < 0 || (dmrs_entries[victim].valid && (!e->valid || e->last_use < dmrs_entries[victim].last_use))) {
+      victim = i;
+    }
+  }
+
+  sl_seq_cache_dmrs_entry_t* e = &dmrs_entries[victim];
+  if (e->r_sequence == NULL) {
+    e->r_sequence = srsran_vec_cf_malloc(SRSRAN_SL_TM34_DEFAULT_NUM_DMRS_SYMBOLS * SRSRAN_MAX_PRB * SRSRAN_NRE);
+    if (e->r_sequence == NULL) {
+      ERROR("Error allocating memory");
+      pthread_mutex_unlock(&cache_mutex);
+      return;
+    }
+  }
+  if (e->valid) {
+    dmrs_stats.nof_evictions++;
+  }
+
+  for (uint32_t j = 0; j < nof_dmrs_symbols; j++) {
+    srsran_vec_cf_copy(&e->r_sequence[j * M_sc_rs], r_sequence[j], M_sc_rs);
+  }
+  e->valid            = true;
+  e->tm               = tm;
+  e->N_x_id           = N_x_id;
+  e->sf_idx           = sf_idx;
+  e->nof_prb          = nof_prb;
+  e->nof_dmrs_symbols = nof_dmrs_symbols;
+  e->last_use         = ++cache_tick;
+
+  pthread_mutex_unlock(&cache_mutex);
+}
+
+void srsran_sl_seq_cache_get_stats(srsran_sl_seq_cache_stats_t* scrambling, srsran_sl_seq_cache_stats_t* dmrs)
+{
+  pthread_mutex_lock(&cache_mutex);
+  if (scrambling != NULL) {
+    *scrambling = scrambling_stats;
+  }
+  if (dmrs != NULL) {
+    *dmrs = dmrs_stats;
+  }
+  pthread_mutex_unlock(&cache_mutex);
+}
+
+void srsran_sl_seq_cache_clear(void)
+{
+  pthread_mutex_lock(&cache_mutex);
+  for (int i = 0; i < SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES; i++) {
+    sl_seq_cache_scrambling_entry_t* s = &scrambling_entries[i];
+    if (s->refcount == 0) {
+      srsran_sequence_free(&s->seq);
+      s->valid = false;
+    }
+
+    sl_seq_cache_dmrs_entry_t* d = &dmrs_entries[i];
+    if (d->r_sequence) {
+      free(d->r_sequence);
+    }
+    memset(d, 0, sizeof(sl_seq_cache_dmrs_entry_t));
+  }
+  memset(&scrambling_stats, 0, sizeof(srsran_sl_seq_cache_stats_t));
+  memset(&dmrs_stats, 0, sizeof(srsran_sl_seq_cache_stats_t));
+  pthread_mutex_unlock(&cache_mutex);
+}
@@ -0,0 +1,207 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <complex.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "srsran/phy/common/sl_seq_cache.h"
+#include "srsran/phy/utils/vector.h"
+#include "srsran/support/srsran_test.h"
+
+#define TEST_LEN 4320
+
+static int test_scrambling(void)
+{
+  srsran_sl_seq_cache_clear();
+
+  srsran_sequence_t           ref   = {};
+  srsran_sl_seq_cache_stats_t stats = {};
+
+  // A miss generates the same sequence as srsran_sequence_LTE_pr()
+  srsran_sequence_t* seq = srsran_sl_seq_cache_scrambling_acquire(1234, 3, TEST_LEN);
+  TESTASSERT(seq != NULL);
+  TESTASSERT(srsran_sequence_LTE_pr(&ref, TEST_LEN, 1234 * 16384 + 3 * 512 + 510) == SRSRAN_SUCCESS);
+  TESTASSERT(memcmp(ref.c, seq->c, TEST_LEN) == 0);
+  TESTASSERT(memcmp(ref.c_short, seq->c_short, TEST_LEN * sizeof(int16_t)) == 0);
+  srsran_sl_seq_cache_scrambling_release(seq);
+
+  // Same subframe modulo 10 and a shorter length are hits on the same entry
+  srsran_sequence_t* seq2 = srsran_sl_seq_cache_scrambling_acquire(1234, 13, TEST_LEN / 2);
+  TESTASSERT(seq2 == seq);
+  srsran_sl_seq_cache_scrambling_release(seq2);
+
+  // A longer sequence is a miss, which replaces the shorter one in its entry
+  seq2 = srsran_sl_seq_cache_scrambling_acquire(1234, 3, 2 * TEST_LEN);
+  TESTASSERT(seq2 == seq && seq2->cur_len >= 2 * TEST_LEN);
+  srsran_sl_seq_cache_scrambling_release(seq2);
+
+  // A shorter sequence in use is invalidated instead, so that the longer one is the only entry of the seed
+  seq  = srsran_sl_seq_cache_scrambling_acquire(4321, 3, TEST_LEN);
+  seq2 = srsran_sl_seq_cache_scrambling_acquire(4321, 3, 2 * TEST_LEN);
+  TESTASSERT(seq != NULL && seq2 != NULL && seq2 != seq);
+  srsran_sl_seq_cache_scrambling_release(seq);
+  srsran_sequence_t* seq3 = srsran_sl_seq_cache_scrambling_acquire(4321, 3, TEST_LEN);
+  TESTASSERT(seq3 == seq2);
+  srsran_sl_seq_cache_scrambling_release(seq3);
+  srsran_sl_seq_cache_scrambling_release(seq2);
+
+  srsran_sl_seq_cache_get_stats(&stats, NULL);
+  TESTASSERT(stats.nof_hits == 2);
+  TESTASSERT(stats.nof_misses == 4);
+  TESTASSERT(stats.nof_evictions == 2);
+
+  // Pinned entries are never evicted, once all of them are pinned the caller is on its own
+  srsran_sl_seq_cache_clear();
+  srsran_sequence_t* pinned[SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES] = {};
+  for (uint32_t i = 0; i < SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES; i++) {
+    pinned[i] = srsran_sl_seq_cache_scrambling_acquire(i, 0, TEST_LEN);
+    TESTASSERT(pinned[i] != NULL);
+  }
+  TESTASSERT(srsran_sl_seq_cache_scrambling_acquire(SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES, 0, TEST_LEN) == NULL);
+  TESTASSERT(srsran_sequence_LTE_pr(&ref, TEST_LEN, 0 * 16384 + 510) == SRSRAN_SUCCESS);
+  TESTASSERT(memcmp(ref.c, pinned[0]->c, TEST_LEN) == 0);
+  for (uint32_t i = 0; i < SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES; i++) {
+    srsran_sl_seq_cache_scrambling_release(pinned[i]);
+  }
+
+  // The least recently used entry is evicted first
+  srsran_sequence_t* touched = srsran_sl_seq_cache_scrambling_acquire(0, 0, TEST_LEN);
+  TESTASSERT(touched == pinned[0]);
+  srsran_sl_seq_cache_scrambling_release(touched);
+  srsran_sequence_t* evicting = srsran_sl_seq_cache_scrambling_acquire(SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES, 0, TEST_LEN);
+  TESTASSERT(evicting == pinned[1]);
+  srsran_sl_seq_cache_scrambling_release(evicting);
+
+  srsran_sl_seq_cache_get_stats(&stats, NULL);
+  TESTASSERT(stats.nof_evictions == 1);
+
+  srsran_sequence_free(&ref);
+  return SRSRAN_SUCCESS;
+}
+
+#define TEST_NOF_THREADS 8
+
+static pthread_barrier_t scrambling_barrier;
+
+static void* scrambling_acquire_thread(void* arg)
+{
+  pthread_barrier_wait(&scrambling_barrier);
+  return srsran_sl_seq_cache_scrambling_acquire(77, 5, *(uint32_t*)arg);
+}
+
+static int test_scrambling_concurrent(void)
+{
+  srsran_sl_seq_cache_clear();
+
+  // Concurrent misses on the same seed wait for the first generation instead of generating a second entry
+  uint32_t           len = 64 * TEST_LEN;
+  pthread_t          threads[TEST_NOF_THREADS];
+  srsran_sequence_t* seq[TEST_NOF_THREADS] = {};
+  TESTASSERT(pthread_barrier_init(&scrambling_barrier, NULL, TEST_NOF_THREADS) == 0);
+  for (uint32_t i = 0; i < TEST_NOF_THREADS; i++) {
+    TESTASSERT(pthread_create(&threads[i], NULL, scrambling_acquire_thread, &len) == 0);
+  }
+  for (uint32_t i = 0; i < TEST_NOF_THREADS; i++) {
+    TESTASSERT(pthread_join(threads[i], (void**)&seq[i]) == 0);
+    TESTASSERT(seq[i] != NULL && seq[i] == seq[0]);
+  }
+  pthread_barrier_destroy(&scrambling_barrier);
+  for (uint32_t i = 0; i < TEST_NOF_THREADS; i++) {
+    srsran_sl_seq_cache_scrambling_release(seq[i]);
+  }
+
+  srsran_sl_seq_cache_stats_t stats = {};
+  srsran_sl_seq_cache_get_stats(&stats, NULL);
+  TESTASSERT(stats.nof_misses == 1);
+  TESTASSERT(stats.nof_hits == TEST_NOF_THREADS - 1);
+  TESTASSERT(stats.nof_evictions == 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+static int test_dmrs(void)
+{
+  srsran_sl_seq_cache_clear();
+
+  uint32_t nof_prb          = 10;
+  uint32_t nof_dmrs_symbols = 4;
+  uint32_t M_sc_rs          = nof_prb * SRSRAN_NRE;
+
+  cf_t* tx[SRSRAN_SL_TM34_DEFAULT_NUM_DMRS_SYMBOLS] = {};
+  cf_t* rx[SRSRAN_SL_TM34_DEFAULT_NUM_DMRS_SYMBOLS] = {};
+  for (uint32_t j = 0; j < nof_dmrs_symbols; j++) {
+    tx[j] = srsran_vec_cf_malloc(M_sc_rs);
+    rx[j] = srsran_vec_cf_malloc(M_sc_rs);
+    TESTASSERT(tx[j] != NULL && rx[j] != NULL);
+    for (uint32_t i = 0; i < M_sc_rs; i++) {
+      tx[j][i] = (float)j + I * (float)i;
+    }
+  }
+
+  TESTASSERT(!srsran_sl_seq_cache_dmrs_get(SRSRAN_SIDELINK_TM4, 100, 2, nof_prb, nof_dmrs_symbols, rx));
+  srsran_sl_seq_cache_dmrs_put(SRSRAN_SIDELINK_TM4, 100, 2, nof_prb, nof_dmrs_symbols, tx);
+  TESTASSERT(srsran_sl_seq_cache_dmrs_get(SRSRAN_SIDELINK_TM4, 100, 12, nof_prb, nof_dmrs_symbols, rx));
+  for (uint32_t j = 0; j < nof_dmrs_symbols; j++) {
+    TESTASSERT(memcmp(tx[j], rx[j], M_sc_rs * sizeof(cf_t)) == 0);
+  }
+
+  // Any key change is a miss
+  TESTASSERT(!srsran_sl_seq_cache_dmrs_get(SRSRAN_SIDELINK_TM4, 100, 3, nof_prb, nof_dmrs_symbols, rx));
+  TESTASSERT(!srsran_sl_seq_cache_dmrs_get(SRSRAN_SIDELINK_TM4, 101, 2, nof_prb, nof_dmrs_symbols, rx));
+  TESTASSERT(!srsran_sl_seq_cache_dmrs_get(SRSRAN_SIDELINK_TM4, 100, 2, nof_prb - 1, nof_dmrs_symbols, rx));
+  TESTASSERT(!srsran_sl_seq_cache_dmrs_get(SRSRAN_SIDELINK_TM3, 100, 2, nof_prb, nof_dmrs_symbols, rx));
+
+  // TM1/2 sequences do not depend on the subframe
+  srsran_sl_seq_cache_dmrs_put(SRSRAN_SIDELINK_TM2, 100, 2, nof_prb, 2, tx);
+  TESTASSERT(srsran_sl_seq_cache_dmrs_get(SRSRAN_SIDELINK_TM2, 100, 7, nof_prb, 2, rx));
+
+  // Overflow the cache by one, the least recently used entry is the one evicted
+  for (uint32_t i = 0; i < SRSRAN_SL_SEQ_CACHE_NOF_ENTRIES - 1; i++) {
+    srsran_sl_seq_cache_dmrs_put(SRSRAN_SIDELINK_TM4, 1000 + i, 0, nof_prb, nof_dmrs_symbols, tx);
+  }
+  TESTASSERT(!srsran_sl_seq_cache_dmrs_get(SRSRAN_SIDELINK_TM4, 100, 2, nof_prb, nof_dmrs_symbols, rx));
+  TESTASSERT(srsran_sl_seq_cache_dmrs_get(SRSRAN_SIDELINK_TM2, 100, 0, nof_prb, 2, rx));
+  TESTASSERT(srsran_sl_seq_cache_dmrs_get(SRSRAN_SIDELINK_TM4, 1000, 0, nof_prb, nof_dmrs_symbols, rx));
+
+  srsran_sl_seq_cache_stats_t stats = {};
+  srsran_sl_seq_cache_get_stats(NULL, &stats);
+  TESTASSERT(stats.nof_evictions == 1);
+
+  for (uint32_t j = 0; j < nof_dmrs_symbols; j++) {
+    free(tx[j]);
+    free(rx[j]);
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  TESTASSERT(test_scrambling() == SRSRAN_SUCCESS);
+  TESTASSERT(test_scrambling_concurrent() == SRSRAN_SUCCESS);
+  TESTASSERT(test_dmrs() == SRSRAN_SUCCESS);
+
+  srsran_sl_seq_cache_clear();
+
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
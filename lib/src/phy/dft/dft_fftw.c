@@ -53,6 +53,120 @@ static int get_fftw_wisdom_file(char* full_path, uint32_t n)
 
 static pthread_mutex_t fft_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+// Whether the wisdom is exported to the default file at exit
+static bool save_wisdom_at_exit = true;
+
+/* Process-wide plan registry. The DFT objects with the same transform and buffer layout share one FFTW plan, which
+ * they only execute with the new-array interface on their own buffers, as FFTW allows from several threads at once.
+ * Plans no longer used are kept for the next objects, so restarting a cell does not plan again. All the plans are made
+ * with FFTW_TYPE, the flags are not part of the key. The registry is protected by fft_mutex. */
+typedef struct dft_registry_entry_s {
+  bool                         real;    // Real-to-real transform, complex otherwise
+  int                          sign;    // FFTW sign for complex transforms, kind for real ones
+  fftwf_iodim                  dim;     // Transform size and strides
+  fftwf_iodim                  howmany; // Number of transforms and distances, zero distances for a single one
+  bool                         in_place;
+  int                          in_align;
+  int                          out_align;
+  fftwf_plan                   p;
+  uint32_t                     nof_users;
+  struct dft_registry_entry_s* next;
+} dft_registry_entry_t;
+
+static dft_registry_entry_t* dft_registry = NULL;
+
+static fftwf_plan
+dft_registry_acquire(bool real, int sign, fftwf_iodim dim, fftwf_iodim howmany, void* in_buffer, void* out_buffer)
+{
+  if (howmany.n == 1) {
+    howmany.is = 0;
+    howmany.os = 0;
+  }
+  bool in_place  = (in_buffer == out_buffer);
+  int  in_align  = fftwf_alignment_of((float*)in_buffer);
+  int  out_align = fftwf_alignment_of((float*)out_buffer);
+
+  for (dft_registry_entry_t* e = dft_registry; e != NULL; e = e->next) {
+    if (e->real == real && e->sign == sign && e->dim.n == dim.n && e->dim.is == dim.is && e->dim.os == dim.os &&
+        e->howmany.n == howmany.n && e->howmany.is == howmany.is && e->howmany.os == howmany.os &&
+        e->in_place == in_place && e->in_align == in_align && e->out_align == out_align) {
+      e->nof_users++;
+      return e->p;
+    }
+  }
+
+  dft_registry_entry_t* e = calloc(1, sizeof(dft_registry_entry_t));
+  if (e == NULL) {
+    return NULL;
+  }
+  if (real) {
+    e->p = fftwf_plan_r2r_1d(dim.n, in_buffer, out_buffer, sign, FFTW_TYPE);
+  } else {
+    e->p = fftwf_plan_guru_dft(1, &dim, 1, &howmany, in_buffer, out_buffer, sign, FFTW_TYPE);
+  }
+  if (e->p == NULL) {
+    free(e);
+    return NULL;
+  }
+  e->real      = real;
+  e->sign      = sign;
+  e->dim       = dim;
+  e->howmany   = howmany;
+  e->in_place  = in_place;
+  e->in_align  = in_align;
+  e->out_align = out_align;
+  e->nof_users = 1;
+  e->next      = dft_registry;
+  dft_registry = e;
+
+  return e->p;
+}
+
+static void dft_registry_release(fftwf_plan p)
+{
+  for (dft_registry_entry_t* e = dft_registry; e != NULL; e = e->next) {
+    if (e->p == p) {
+      if (e->nof_users > 0) {
+        e->nof_users--;
+      }
+      return;
+    }
+  }
+}
+
+static void dft_registry_clear_unused()
+{
+  dft_registry_entry_t** e = &dft_registry;
+  while (*e != NULL) {
+    if ((*e)->nof_users == 0) {
+      dft_registry_entry_t* unused = *e;
+      *e                           = unused->next;
+      fftwf_destroy_plan(unused->p);
+      free(unused);
+    } else {
+      e = &(*e)->next;
+    }
+  }
+}
+
+uint32_t srsran_dft_registry_nof_plans()
+{
+  uint32_t count = 0;
+  pthread_mutex_lock(&fft_mutex);
+  for (dft_registry_entry_t* e = dft_registry; e != NULL; e = e->next) {
+    count++;
+  }
+  pthread_mutex_unlock(&fft_mutex);
+  return count;
+}
+
+void srsran_dft_registry_clear()
+{
+  pthread_mutex_lock(&fft_mutex);
+  dft_registry_clear_unused();
+  pthread_mutex_unlock(&fft_mutex);
+}
+
 // This function is called in the beggining of any executable where it is linked
 __attribute__((constructor)) static void srsran_dft_load()
 {
@@ -81,29 +195,49 @@ __attribute__((constructor)) static void srsran_dft_load()
 #endif
 }
 
-// This function is called in the ending of any executable where it is linked
-__attribute__((destructor)) void srsran_dft_exit()
+int srsran_dft_save_wisdom(const char* path)
 {
-#ifdef FFTW_WISDOM_FILE
   char full_path[256];
-  get_fftw_wisdom_file(full_path, sizeof(full_path));
-  FILE* fd = fopen(full_path, "w");
+  if (path == NULL) {
+    get_fftw_wisdom_file(full_path, sizeof(full_path));
+    path = full_path;
+  }
+  FILE* fd = fopen(path, "w");
   if (fd == NULL) {
-    return;
+    return SRSRAN_ERROR;
   }
   if (lockf(fileno(fd), F_LOCK, 0) == -1) {
     perror("lockf()");
     fclose(fd);
-    return;
+    return SRSRAN_ERROR;
   }
+  pthread_mutex_lock(&fft_mutex);
   fftwf_export_wisdom_to_file(fd);
+  pthread_mutex_unlock(&fft_mutex);
   if (lockf(fileno(fd), F_ULOCK, 0) == -1) {
     perror("u-lockf()");
     fclose(fd);
-    return;
+    return SRSRAN_ERROR;
   }
   fclose(fd);
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_dft_save_wisdom_at_exit(bool enable)
+{
+  save_wisdom_at_exit = enable;
+}
+
+// This function is called in the ending of any executable where it is linked
+__attribute__((destructor)) void srsran_dft_exit()
+{
+#ifdef FFTW_WISDOM_FILE
+  if (save_wisdom_at_exit) {
+    srsran_dft_save_wisdom(NULL);
+  }
 #endif
+  // Plans still in use are left to their objects
+  srsran_dft_registry_clear();
   fftwf_cleanup();
 }
 
@@ -158,16 +292,18 @@ int srsran_dft_replan_guru_c(srsran_dft_plan_t* plan,
 
   pthread_mutex_lock(&fft_mutex);
 
-  /* Destroy current plan */
-  fftwf_destroy_plan(plan->p);
+  /* Release current plan */
+  dft_registry_release(plan->p);
 
-  plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
+  plan->p = dft_registry_acquire(false, sign, iodim, howmany_dims, in_buffer, out_buffer);
 
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
     return -1;
   }
+  plan->in        = in_buffer;
+  plan->out       = out_buffer;
   plan->size      = new_dft_points;
   plan->init_size = plan->size;
 
@@ -183,12 +319,15 @@ int srsran_dft_replan_c(srsran_dft_plan_t* plan, const int new_dft_points)
     return 0;
   }
 
+  const fftwf_iodim iodim        = {new_dft_points, 1, 1};
+  const fftwf_iodim howmany_dims = {1, 0, 0};
+
   pthread_mutex_lock(&fft_mutex);
   if (plan->p) {
-    fftwf_destroy_plan(plan->p);
+    dft_registry_release(plan->p);
     plan->p = NULL;
   }
-  plan->p = fftwf_plan_dft_1d(new_dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  plan->p = dft_registry_acquire(false, sign, iodim, howmany_dims, plan->in, plan->out);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -216,13 +355,15 @@ int srsran_dft_plan_guru_c(srsran_dft_plan_t* plan,
 
   pthread_mutex_lock(&fft_mutex);
 
-  plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
+  plan->p = dft_registry_acquire(false, sign, iodim, howmany_dims, in_buffer, out_buffer);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
     return -1;
   }
 
+  plan->in        = in_buffer; // Not owned by the plan, only kept to check the buffers of new-array executions
+  plan->out       = out_buffer;
   plan->size      = dft_points;
   plan->init_size = plan->size;
   plan->mode      = SRSRAN_DFT_COMPLEX;
@@ -241,10 +382,13 @@ int srsran_dft_plan_c(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_
 {
   allocate(plan, sizeof(fftwf_complex), sizeof(fftwf_complex), dft_points);
 
+  int               sign         = (dir == SRSRAN_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
+  const fftwf_iodim iodim        = {dft_points, 1, 1};
+  const fftwf_iodim howmany_dims = {1, 0, 0};
+
   pthread_mutex_lock(&fft_mutex);
 
-  int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
-  plan->p  = fftwf_plan_dft_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  plan->p = dft_registry_acquire(false, sign, iodim, howmany_dims, plan->in, plan->out);
 
   pthread_mutex_unlock(&fft_mutex);
 
@@ -269,12 +413,15 @@ int srsran_dft_replan_r(srsran_dft_plan_t* plan, const int new_dft_points)
 {
   int sign = (plan->dir == SRSRAN_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
 
+  const fftwf_iodim iodim        = {new_dft_points, 1, 1};
+  const fftwf_iodim howmany_dims = {1, 0, 0};
+
   pthread_mutex_lock(&fft_mutex);
   if (plan->p) {
-    fftwf_destroy_plan(plan->p);
+    dft_registry_release(plan->p);
     plan->p = NULL;
   }
-  plan->p = fftwf_plan_r2r_1d(new_dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  plan->p = dft_registry_acquire(true, sign, iodim, howmany_dims, plan->in, plan->out);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -287,10 +434,12 @@ int srsran_dft_replan_r(srsran_dft_plan_t* plan, const int new_dft_points)
 int srsran_dft_plan_r(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_dir_t dir)
 {
   allocate(plan, sizeof(float), sizeof(float), dft_points);
-  int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
+  int               sign         = (dir == SRSRAN_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
+  const fftwf_iodim iodim        = {dft_points, 1, 1};
+  const fftwf_iodim howmany_dims = {1, 0, 0};
 
   pthread_mutex_lock(&fft_mutex);
-  plan->p = fftwf_plan_r2r_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  plan->p = dft_registry_acquire(true, sign, iodim, howmany_dims, plan->in, plan->out);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -372,7 +521,7 @@ void srsran_dft_run_c(srsran_dft_plan_t* plan, const cf_t* in, cf_t* out)
   fftwf_complex* f_out = plan->out;
 
   copy_pre((uint8_t*)plan->in, (uint8_t*)in, sizeof(cf_t), plan->size, plan->forward, plan->mirror, plan->dc);
-  fftwf_execute(plan->p);
+  fftwf_execute_dft(plan->p, plan->in, plan->out);
   if (plan->norm) {
     norm = 1.0 / sqrtf(plan->size);
     srsran_vec_sc_prod_cfc(f_out, norm, f_out, plan->size);
@@ -388,12 +537,30 @@ void srsran_dft_run_c(srsran_dft_plan_t* plan, const cf_t* in, cf_t* out)
 void srsran_dft_run_guru_c(srsran_dft_plan_t* plan)
 {
   if (plan->is_guru == true) {
-    fftwf_execute(plan->p);
+    fftwf_execute_dft(plan->p, plan->in, plan->out);
   } else {
     ERROR("srsran_dft_run_guru_c: the selected plan is not guru!");
   }
 }
 
+int srsran_dft_run_guru_buffers_c(srsran_dft_plan_t* plan, const cf_t* in, cf_t* out)
+{
+  if (plan->is_guru == false) {
+    ERROR("srsran_dft_run_guru_buffers_c: the selected plan is not guru!");
+    return SRSRAN_ERROR;
+  }
+
+  // FFTW new-array execution requirements, the layout is given by the plan
+  if ((in == out) != (plan->in == plan->out) ||
+      fftwf_alignment_of((float*)in) != fftwf_alignment_of((float*)plan->in) ||
+      fftwf_alignment_of((float*)out) != fftwf_alignment_of((float*)plan->out)) {
+    return SRSRAN_ERROR;
+  }
+
+  fftwf_execute_dft(plan->p, (cf_t*)in, out);
+  return SRSRAN_SUCCESS;
+}
+
 void srsran_dft_run_r(srsran_dft_plan_t* plan, const float* in, float* out)
 {
   float  norm;
@@ -402,7 +569,7 @@ void srsran_dft_run_r(srsran_dft_plan_t* plan, const float* in, float* out)
   float* f_out = plan->out;
 
   memcpy(plan->in, in, sizeof(float) * plan->size);
-  fftwf_execute(plan->p);
+  fftwf_execute_r2r(plan->p, plan->in, plan->out);
   if (plan->norm) {
     norm = 1.0 / plan->size;
     srsran_vec_sc_prod_fff(f_out, norm, f_out, plan->size);
@@ -430,7 +597,7 @@ void srsran_dft_plan_free(srsran_dft_plan_t* plan)
       fftwf_free(plan->out);
   }
   if (plan->p)
-    fftwf_destroy_plan(plan->p);
+    dft_registry_release(plan->p);
   pthread_mutex_unlock(&fft_mutex);
   bzero(plan, sizeof(srsran_dft_plan_t));
 }
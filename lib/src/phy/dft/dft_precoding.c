@@ -74,9 +74,68 @@ int srsran_dft_precoding_init_tx(srsran_dft_precoding_t* q, uint32_t max_prb)
   return srsran_dft_precoding_init(q, max_prb, true);
 }
 
+static void dft_precoding_free_batch(srsran_dft_precoding_t* q)
+{
+  for (uint32_t i = 1; i <= q->max_prb; i++) {
+    srsran_dft_plan_free(&q->batch_plan[i]);
+  }
+  if (q->batch_in) {
+    free(q->batch_in);
+  }
+  if (q->batch_out) {
+    free(q->batch_out);
+  }
+  q->batch_in          = NULL;
+  q->batch_out         = NULL;
+  q->batch_nof_symbols = 0;
+}
+
+int srsran_dft_precoding_set_batch(srsran_dft_precoding_t* q, uint32_t nof_symbols)
+{
+  if (q == NULL || q->max_prb == 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  if (nof_symbols == q->batch_nof_symbols) {
+    return SRSRAN_SUCCESS;
+  }
+
+  dft_precoding_free_batch(q);
+  if (nof_symbols == 0) {
+    return SRSRAN_SUCCESS;
+  }
+
+  uint32_t max_len = q->max_prb * SRSRAN_NRE * nof_symbols;
+  q->batch_in      = srsran_vec_cf_malloc(max_len);
+  q->batch_out     = srsran_vec_cf_malloc(max_len);
+  if (!q->batch_in || !q->batch_out) {
+    ERROR("Error allocating memory");
+    dft_precoding_free_batch(q);
+    return SRSRAN_ERROR;
+  }
+
+  // The plans are created out of place, in-place calls transform into batch_out. One PRB is always valid
+  srsran_dft_dir_t dir = q->dft_plan[1].dir;
+  for (uint32_t i = 1; i <= q->max_prb; i++) {
+    if (srsran_dft_precoding_valid_prb(i)) {
+      int len = (int)(i * SRSRAN_NRE);
+      if (srsran_dft_plan_guru_c(
+              &q->batch_plan[i], len, dir, q->batch_in, q->batch_out, 1, 1, (int)nof_symbols, len, len)) {
+        ERROR("Error: Creating batch DFT plan %d", i);
+        dft_precoding_free_batch(q);
+        return SRSRAN_ERROR;
+      }
+    }
+  }
+  q->batch_nof_symbols = nof_symbols;
+
+  return SRSRAN_SUCCESS;
+}
+
 /* Free DFT plans for transform precoding */
 void srsran_dft_precoding_free(srsran_dft_precoding_t* q)
 {
+  dft_precoding_free_batch(q);
   for (uint32_t i = 1; i <= q->max_prb; i++) {
     if (srsran_dft_precoding_valid_prb(i)) {
       srsran_dft_plan_free(&q->dft_plan[i]);
@@ -118,6 +177,15 @@ int srsran_dft_precoding(srsran_dft_precoding_t* q, cf_t* input, cf_t* output, u
     return SRSRAN_ERROR;
   }
 
+  if (nof_symbols == q->batch_nof_symbols && nof_prb <= q->max_prb) {
+    cf_t* out = (input == output) ? q->batch_out : output;
+    if (srsran_dft_run_guru_buffers_c(&q->batch_plan[nof_prb], input, out) == SRSRAN_SUCCESS) {
+      float norm = 1.0 / sqrtf(SRSRAN_NRE * nof_prb);
+      srsran_vec_sc_prod_cfc(out, norm, output, SRSRAN_NRE * nof_prb * nof_symbols);
+      return SRSRAN_SUCCESS;
+    }
+  }
+
   for (uint32_t i = 0; i < nof_symbols; i++) {
     srsran_dft_run_c(&q->dft_plan[nof_prb], &input[i * SRSRAN_NRE * nof_prb], &output[i * SRSRAN_NRE * nof_prb]);
   }
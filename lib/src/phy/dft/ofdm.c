@@ -135,6 +135,17 @@ static int ofdm_init_mbsfn_(srsran_ofdm_t* q, srsran_ofdm_cfg_t* cfg, srsran_dft
       return SRSRAN_ERROR;
     }
 
+    if (dir == SRSRAN_DFT_FORWARD && q->cfg.rx_sc16) {
+      if (q->sc16_buffer) {
+        free(q->sc16_buffer);
+      }
+      q->sc16_buffer = srsran_vec_cf_malloc(q->slot_sz);
+      if (!q->sc16_buffer) {
+        perror("malloc");
+        return SRSRAN_ERROR;
+      }
+    }
+
     q->max_prb = cfg->nof_prb;
   }
 
@@ -204,6 +215,27 @@ static int ofdm_init_mbsfn_(srsran_ofdm_t* q, srsran_ofdm_cfg_t* cfg, srsran_dft
       }
     }
   }
+
+  // The sc16 input is converted without cyclic prefix one slot at a time, the symbols are contiguous
+  if (dir == SRSRAN_DFT_FORWARD && q->cfg.rx_sc16) {
+    if (q->fft_plan_sc16.size) {
+      srsran_dft_plan_free(&q->fft_plan_sc16);
+    }
+
+    if (srsran_dft_plan_guru_c(&q->fft_plan_sc16,
+                               symbol_sz,
+                               dir,
+                               q->sc16_buffer,
+                               q->tmp,
+                               1,
+                               1,
+                               SRSRAN_CP_NSYMB(cp),
+                               symbol_sz,
+                               symbol_sz)) {
+      ERROR("Creating Guru DFT plan (sc16)");
+      return SRSRAN_ERROR;
+    }
+  }
 #endif
 
   srsran_dft_plan_set_mirror(&q->fft_plan, true);
@@ -253,6 +285,9 @@ void srsran_ofdm_free_(srsran_ofdm_t* q)
       srsran_dft_plan_free(&q->fft_plan_sf[slot]);
     }
   }
+  if (q->fft_plan_sc16.size) {
+    srsran_dft_plan_free(&q->fft_plan_sc16);
+  }
 #endif
 
   if (q->tmp) {
@@ -264,6 +299,9 @@ void srsran_ofdm_free_(srsran_ofdm_t* q)
   if (q->window_offset_buffer) {
     free(q->window_offset_buffer);
   }
+  if (q->sc16_buffer) {
+    free(q->sc16_buffer);
+  }
   srsran_cfr_free(&q->tx_cfr);
   SRSRAN_MEM_ZERO(q, srsran_ofdm_t, 1);
 }
@@ -468,15 +506,10 @@ void srsran_ofdm_rx_slot_ng(srsran_ofdm_t* q, cf_t* input, cf_t* output)
   }
 }
 
-/* Transforms input samples into output OFDM symbols.
- * Performs FFT on a each symbol and removes CP.
+/* Extracts the subcarriers of the DFT of each symbol of a slot, in the temporal buffer, into the output buffer.
  */
-static void ofdm_rx_slot(srsran_ofdm_t* q, int slot_in_sf)
+static void ofdm_rx_slot_output(srsran_ofdm_t* q, int slot_in_sf)
 {
-#ifdef AVOID_GURU
-  srsran_ofdm_rx_slot_ng(
-      q, q->cfg.in_buffer + slot_in_sf * q->slot_sz, q->cfg.out_buffer + slot_in_sf * q->nof_re * q->nof_symbols);
-#else
   uint32_t nof_symbols = q->nof_symbols;
   uint32_t nof_re = q->nof_re;
   cf_t* output = q->cfg.out_buffer + slot_in_sf * nof_re * nof_symbols;
@@ -485,8 +518,6 @@ static void ofdm_rx_slot(srsran_ofdm_t* q, int slot_in_sf)
   cf_t* tmp = q->tmp;
   uint32_t dc = (q->fft_plan.dc) ? 1 : 0;
 
-  srsran_dft_run_guru_c(&q->fft_plan_sf[slot_in_sf]);
-
   for (int i = 0; i < q->nof_symbols; i++) {
     // Apply frequency domain window offset
     if (q->window_offset_n) {
@@ -516,6 +547,19 @@ static void ofdm_rx_slot(srsran_ofdm_t* q, int slot_in_sf)
     tmp += symbol_sz;
     output += nof_re;
   }
+}
+
+/* Transforms input samples into output OFDM symbols.
+ * Performs FFT on a each symbol and removes CP.
+ */
+static void ofdm_rx_slot(srsran_ofdm_t* q, int slot_in_sf)
+{
+#ifdef AVOID_GURU
+  srsran_ofdm_rx_slot_ng(
+      q, q->cfg.in_buffer + slot_in_sf * q->slot_sz, q->cfg.out_buffer + slot_in_sf * q->nof_re * q->nof_symbols);
+#else
+  srsran_dft_run_guru_c(&q->fft_plan_sf[slot_in_sf]);
+  ofdm_rx_slot_output(q, slot_in_sf);
 #endif
 }
 
@@ -579,6 +623,40 @@ void srsran_ofdm_rx_sf_ng(srsran_ofdm_t* q, cf_t* input, cf_t* output)
   }
 }
 
+void srsran_ofdm_rx_sf_sc16(srsran_ofdm_t* q, const int16_t* input, float scale)
+{
+#ifndef AVOID_GURU
+  if (q->cfg.rx_sc16 && !q->mbsfn_subframe) {
+    uint32_t    symbol_sz = q->cfg.symbol_sz;
+    srsran_cp_t cp        = q->cfg.cp;
+    uint32_t    offset    = 0; // Input sample index
+
+    for (uint32_t slot = 0; slot < SRSRAN_NOF_SLOTS_PER_SF; slot++) {
+      // Convert only the DFT window of each symbol, with the frequency shift if any
+      for (uint32_t i = 0; i < q->nof_symbols; i++) {
+        uint32_t cp_len = SRSRAN_CP_ISNORM(cp) ? SRSRAN_CP_LEN_NORM(i, symbol_sz) : SRSRAN_CP_LEN_EXT(symbol_sz);
+        uint32_t start  = offset + cp_len - q->window_offset_n;
+        cf_t*    symbol = &q->sc16_buffer[i * symbol_sz];
+
+        srsran_vec_convert_if(&input[2 * start], scale, (float*)symbol, 2 * symbol_sz);
+        if (isnormal(q->cfg.freq_shift_f)) {
+          srsran_vec_prod_ccc(symbol, &q->shift_buffer[start], symbol, symbol_sz);
+        }
+        offset += cp_len + symbol_sz;
+      }
+
+      srsran_dft_run_guru_c(&q->fft_plan_sc16);
+      ofdm_rx_slot_output(q, slot);
+    }
+    return;
+  }
+#endif
+
+  // Convert the whole subframe otherwise
+  srsran_vec_convert_if(input, scale, (float*)q->cfg.in_buffer, 2 * q->sf_sz);
+  srsran_ofdm_rx_sf(q);
+}
+
 /* Transforms input OFDM symbols into output samples.
  * Performs the FFT on each symbol and adds CP.
  */
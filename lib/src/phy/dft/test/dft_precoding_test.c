@@ -0,0 +1,158 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srsran/srsran.h"
+
+static uint32_t max_prb     = 100;
+static uint32_t nof_symbols = 12;
+static uint32_t nof_reps    = 100;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [pnr]\n", prog);
+  printf("\t-p max_prb [Default %d]\n", max_prb);
+  printf("\t-n nof_symbols [Default %d]\n", nof_symbols);
+  printf("\t-r nof_reps, transforms timed per number of PRB [Default %d]\n", nof_reps);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "pnr")) != -1) {
+    switch (opt) {
+      case 'p':
+        max_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        nof_symbols = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'r':
+        nof_reps = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static double time_us(srsran_dft_precoding_t* q, cf_t* in, cf_t* out, uint32_t nof_prb)
+{
+  struct timeval t[3];
+  gettimeofday(&t[1], NULL);
+  for (uint32_t r = 0; r < nof_reps; r++) {
+    srsran_dft_precoding(q, in, out, nof_prb, nof_symbols);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  return (t[0].tv_sec * 1e6 + t[0].tv_usec) / nof_reps;
+}
+
+int main(int argc, char** argv)
+{
+  int                    ret = SRSRAN_ERROR;
+  srsran_dft_precoding_t ref_tx, tx, rx;
+  srsran_random_t        random_gen = srsran_random_init(0x1234);
+
+  parse_args(argc, argv);
+
+  if (srsran_dft_precoding_init_tx(&ref_tx, max_prb) || srsran_dft_precoding_init_tx(&tx, max_prb) ||
+      srsran_dft_precoding_init_rx(&rx, max_prb)) {
+    ERROR("Error initiating DFT precoding");
+    exit(-1);
+  }
+  if (srsran_dft_precoding_set_batch(&tx, nof_symbols) || srsran_dft_precoding_set_batch(&rx, nof_symbols)) {
+    ERROR("Error initiating batched DFT precoding");
+    exit(-1);
+  }
+
+  uint32_t max_len = max_prb * SRSRAN_NRE * nof_symbols;
+  cf_t*    input   = srsran_vec_cf_malloc(max_len);
+  cf_t*    ref     = srsran_vec_cf_malloc(max_len);
+  cf_t*    output  = srsran_vec_cf_malloc(max_len);
+  cf_t*    inplace = srsran_vec_cf_malloc(max_len);
+  if (!input || !ref || !output || !inplace) {
+    perror("malloc");
+    exit(-1);
+  }
+  for (uint32_t i = 0; i < max_len; i++) {
+    input[i] = srsran_random_uniform_complex_dist(random_gen, -1.0f, 1.0f);
+  }
+
+  for (uint32_t nof_prb = 1; nof_prb <= max_prb; nof_prb++) {
+    if (!srsran_dft_precoding_valid_prb(nof_prb)) {
+      continue;
+    }
+    uint32_t len = nof_prb * SRSRAN_NRE * nof_symbols;
+
+    // Batched transform, out of place and in place, against one transform per symbol
+    srsran_dft_precoding(&ref_tx, input, ref, nof_prb, nof_symbols);
+    srsran_dft_precoding(&tx, input, output, nof_prb, nof_symbols);
+    srsran_vec_cf_copy(inplace, input, len);
+    srsran_dft_precoding(&tx, inplace, inplace, nof_prb, nof_symbols);
+
+    float err_out     = 0.0f;
+    float err_inplace = 0.0f;
+    for (uint32_t i = 0; i < len; i++) {
+      err_out     = SRSRAN_MAX(err_out, cabsf(output[i] - ref[i]));
+      err_inplace = SRSRAN_MAX(err_inplace, cabsf(inplace[i] - ref[i]));
+    }
+
+    // The receiver transform recovers the input, in place
+    srsran_dft_precoding(&rx, inplace, inplace, nof_prb, nof_symbols);
+    float err_rx = 0.0f;
+    for (uint32_t i = 0; i < len; i++) {
+      err_rx = SRSRAN_MAX(err_rx, cabsf(inplace[i] - input[i]));
+    }
+
+    if (err_out > 1e-4f || err_inplace > 1e-4f || err_rx > 1e-4f) {
+      ERROR("%d PRB: error %e out of place, %e in place, %e after receiving", nof_prb, err_out, err_inplace, err_rx);
+      goto clean_exit;
+    }
+
+    if (nof_reps > 0) {
+      printf("%3d PRB: per symbol %8.2f us; batched %8.2f us; batched in place %8.2f us\n",
+             nof_prb,
+             time_us(&ref_tx, input, output, nof_prb),
+             time_us(&tx, input, output, nof_prb),
+             time_us(&tx, inplace, inplace, nof_prb));
+    }
+  }
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  free(input);
+  free(ref);
+  free(output);
+  free(inplace);
+  srsran_dft_precoding_free(&ref_tx);
+  srsran_dft_precoding_free(&tx);
+  srsran_dft_precoding_free(&rx);
+  srsran_random_free(random_gen);
+
+  printf("%s\n", ret ? "Failed" : "Ok");
+  exit(ret);
+}
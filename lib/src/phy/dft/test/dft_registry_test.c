@@ -0,0 +1,186 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "srsran/common/test_common.h"
+#include "srsran/srsran.h"
+
+#define MAX_THREADS 8
+
+static uint32_t dft_size    = 1536;
+static uint32_t nof_threads = 4;
+static uint32_t nof_reps    = 20;
+
+static cf_t* input     = NULL;
+static cf_t* reference = NULL;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [Ntr]\n", prog);
+  printf("\t-N dft_size [Default %d]\n", dft_size);
+  printf("\t-t nof_threads, running plans of the same size [Default %d, max %d]\n", nof_threads, MAX_THREADS);
+  printf("\t-r nof_reps, transforms per thread [Default %d]\n", nof_reps);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "Ntr")) != -1) {
+    switch (opt) {
+      case 'N':
+        dft_size = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 't':
+        nof_threads = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'r':
+        nof_reps = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+  if (nof_threads > MAX_THREADS) {
+    usage(argv[0]);
+    exit(-1);
+  }
+}
+
+typedef struct {
+  srsran_dft_plan_t plan;
+  cf_t*             output;
+  int               ret;
+} worker_t;
+
+static void* worker_thread(void* arg)
+{
+  worker_t* w = (worker_t*)arg;
+
+  w->ret = SRSRAN_ERROR;
+  for (uint32_t r = 0; r < nof_reps; r++) {
+    srsran_dft_run_c(&w->plan, input, w->output);
+    if (memcmp(w->output, reference, sizeof(cf_t) * dft_size) != 0) {
+      return NULL;
+    }
+  }
+  w->ret = SRSRAN_SUCCESS;
+  return NULL;
+}
+
+int main(int argc, char** argv)
+{
+  srsran_dft_plan_t fwd, fwd2, bwd;
+  srsran_dft_plan_t real[2];
+  worker_t          workers[MAX_THREADS] = {};
+  pthread_t         threads[MAX_THREADS];
+  srsran_random_t   random_gen = srsran_random_init(0x1234);
+
+  parse_args(argc, argv);
+
+  srsran_dft_registry_clear();
+  uint32_t nof_plans = srsran_dft_registry_nof_plans();
+
+  input         = srsran_vec_cf_malloc(dft_size);
+  reference     = srsran_vec_cf_malloc(dft_size);
+  cf_t* output  = srsran_vec_cf_malloc(dft_size);
+  float* real_o = srsran_vec_f_malloc(2 * dft_size);
+  TESTASSERT(input != NULL && reference != NULL && output != NULL && real_o != NULL);
+  for (uint32_t i = 0; i < dft_size; i++) {
+    input[i] = srsran_random_uniform_complex_dist(random_gen, -1.0f, 1.0f);
+  }
+
+  // Plans of the same size and direction share the FFTW plan
+  TESTASSERT(srsran_dft_plan_c(&fwd, dft_size, SRSRAN_DFT_FORWARD) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_dft_plan_c(&fwd2, dft_size, SRSRAN_DFT_FORWARD) == SRSRAN_SUCCESS);
+  TESTASSERT(fwd.p == fwd2.p);
+  TESTASSERT(srsran_dft_registry_nof_plans() == nof_plans + 1);
+  TESTASSERT(srsran_dft_plan_c(&bwd, dft_size, SRSRAN_DFT_BACKWARD) == SRSRAN_SUCCESS);
+  TESTASSERT(bwd.p != fwd.p);
+  TESTASSERT(srsran_dft_registry_nof_plans() == nof_plans + 2);
+
+  // Each plan transforms its own buffers
+  srsran_dft_run_c(&fwd, input, reference);
+  srsran_dft_run_c(&fwd2, input, output);
+  TESTASSERT(memcmp(output, reference, sizeof(cf_t) * dft_size) == 0);
+  srsran_dft_run_c(&bwd, reference, output);
+  for (uint32_t i = 0; i < dft_size; i++) {
+    TESTASSERT(cabsf(output[i] / (float)dft_size - input[i]) < 1e-3f);
+  }
+
+  // Real plans are not shared with complex ones
+  for (uint32_t i = 0; i < 2; i++) {
+    TESTASSERT(srsran_dft_plan_r(&real[i], dft_size, SRSRAN_DFT_FORWARD) == SRSRAN_SUCCESS);
+  }
+  TESTASSERT(real[0].p == real[1].p);
+  TESTASSERT(srsran_dft_registry_nof_plans() == nof_plans + 3);
+  srsran_dft_run_r(&real[0], (float*)input, real_o);
+  srsran_dft_run_r(&real[1], (float*)input, real_o + dft_size);
+  TESTASSERT(memcmp(real_o, real_o + dft_size, sizeof(float) * dft_size) == 0);
+
+  // Plans of the same size run concurrently, each one on its own buffers
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    workers[i].output = srsran_vec_cf_malloc(dft_size);
+    TESTASSERT(workers[i].output != NULL);
+    TESTASSERT(srsran_dft_plan_c(&workers[i].plan, dft_size, SRSRAN_DFT_FORWARD) == SRSRAN_SUCCESS);
+    TESTASSERT(workers[i].plan.p == fwd.p);
+  }
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    TESTASSERT(pthread_create(&threads[i], NULL, worker_thread, &workers[i]) == 0);
+  }
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    pthread_join(threads[i], NULL);
+    TESTASSERT(workers[i].ret == SRSRAN_SUCCESS);
+    srsran_dft_plan_free(&workers[i].plan);
+    free(workers[i].output);
+  }
+
+  // Released plans are kept for the next objects until the registry is cleared
+  srsran_dft_plan_free(&fwd);
+  srsran_dft_plan_free(&fwd2);
+  srsran_dft_plan_free(&real[0]);
+  srsran_dft_plan_free(&real[1]);
+  TESTASSERT(srsran_dft_registry_nof_plans() == nof_plans + 3);
+  TESTASSERT(srsran_dft_plan_c(&fwd, dft_size, SRSRAN_DFT_FORWARD) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_dft_registry_nof_plans() == nof_plans + 3);
+  srsran_dft_run_c(&fwd, input, output);
+  TESTASSERT(memcmp(output, reference, sizeof(cf_t) * dft_size) == 0);
+
+  srsran_dft_registry_clear();
+  TESTASSERT(srsran_dft_registry_nof_plans() == nof_plans + 2);
+  srsran_dft_plan_free(&fwd);
+  srsran_dft_plan_free(&bwd);
+  srsran_dft_registry_clear();
+  TESTASSERT(srsran_dft_registry_nof_plans() == nof_plans);
+
+  free(input);
+  free(reference);
+  free(output);
+  free(real_o);
+  srsran_random_free(random_gen);
+
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
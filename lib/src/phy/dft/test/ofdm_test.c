@@ -29,6 +29,9 @@
 #include "srsran/phy/utils/random.h"
 #include "srsran/srsran.h"
 
+// Integer value of the unitary amplitude for the 16-bit Rx input, leaves 12 dB of headroom
+#define SC16_SCALE 8192.0f
+
 static int         nof_prb               = -1;
 static srsran_cp_t cp                    = SRSRAN_CP_NORM;
 static int         nof_repetitions       = 1;
@@ -36,6 +39,7 @@ static float       rx_window_offset      = 0.5f;
 static float       freq_shift_f          = 0.0f;
 static double      phase_compensation_hz = 0.0;
 static uint32_t    force_symbol_sz       = 0;
+static bool        rx_sc16               = false;
 static double      elapsed_us(struct timeval* ts_start, struct timeval* ts_end)
 {
   if (ts_end->tv_usec > ts_start->tv_usec) {
@@ -57,12 +61,13 @@ static void usage(char* prog)
   printf("\t-o rx window offset (portion of CP length) [Default %.1f]\n", rx_window_offset);
   printf("\t-s frequency shift (normalised with sampling rate) [Default %.1f]\n", freq_shift_f);
   printf("\t-p Phase compensation carrier frequency in Hz [Default %.1f]\n", phase_compensation_hz);
+  printf("\t-i Rx from 16-bit integer samples [Default %s]\n", rx_sc16 ? "yes" : "no");
 }
 
 static void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "Nnerosp")) != -1) {
+  while ((opt = getopt(argc, argv, "Nnerospi")) != -1) {
     switch (opt) {
       case 'n':
         nof_prb = (int)strtol(argv[optind], NULL, 10);
@@ -85,6 +90,9 @@ static void parse_args(int argc, char** argv)
       case 'p':
         phase_compensation_hz = strtod(argv[optind], NULL);
         break;
+      case 'i':
+        rx_sc16 = true;
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -98,6 +106,7 @@ int main(int argc, char** argv)
   struct timeval  start, end;
   srsran_ofdm_t   fft = {}, ifft = {};
   cf_t *          input, *outfft, *outifft;
+  int16_t*        outifft_sc16;
   float           mse;
   uint32_t        n_prb, max_prb;
 
@@ -120,8 +129,9 @@ int main(int argc, char** argv)
 
     input   = srsran_vec_cf_malloc(n_re);
     outfft  = srsran_vec_cf_malloc(n_re);
-    outifft = srsran_vec_cf_malloc(sf_len);
-    if (!input || !outfft || !outifft) {
+    outifft      = srsran_vec_cf_malloc(sf_len);
+    outifft_sc16 = srsran_vec_i16_malloc(2 * sf_len);
+    if (!input || !outfft || !outifft || !outifft_sc16) {
       perror("malloc");
       exit(-1);
     }
@@ -145,6 +155,7 @@ int main(int argc, char** argv)
     ofdm_cfg.out_buffer       = outfft;
     ofdm_cfg.rx_window_offset = rx_window_offset;
     ofdm_cfg.freq_shift_f     = -freq_shift_f;
+    ofdm_cfg.rx_sc16          = rx_sc16;
     if (srsran_ofdm_rx_init_cfg(&fft, &ofdm_cfg)) {
       ERROR("Error initializing FFT");
       exit(-1);
@@ -165,10 +176,19 @@ int main(int argc, char** argv)
     gettimeofday(&end, NULL);
     printf(" Tx@%.1fMsps", (float)(sf_len * nof_repetitions) / elapsed_us(&start, &end));
 
+    // Quantize the Tx signal as received from the radio
+    if (rx_sc16) {
+      srsran_vec_convert_fi((float*)outifft, SC16_SCALE, outifft_sc16, 2 * sf_len);
+    }
+
     // Execute Rx
     gettimeofday(&start, NULL);
     for (uint32_t i = 0; i < nof_repetitions; i++) {
-      srsran_ofdm_rx_sf(&fft);
+      if (rx_sc16) {
+        srsran_ofdm_rx_sf_sc16(&fft, outifft_sc16, SC16_SCALE);
+      } else {
+        srsran_ofdm_rx_sf(&fft);
+      }
     }
     gettimeofday(&end, NULL);
     printf(" Rx@%.1fMsps", (double)(sf_len * nof_repetitions) / elapsed_us(&start, &end));
@@ -179,7 +199,8 @@ int main(int argc, char** argv)
 
     printf(" MSE=%.6f\n", mse);
 
-    if (mse >= 0.0001) {
+    // The 16-bit input adds the quantization noise, truncated by the conversion
+    if (mse >= (rx_sc16 ? 0.001 : 0.0001)) {
       printf("MSE too large\n");
       exit(-1);
     }
@@ -190,6 +211,7 @@ int main(int argc, char** argv)
     free(input);
     free(outfft);
     free(outifft);
+    free(outifft_sc16);
 
     n_prb++;
   }
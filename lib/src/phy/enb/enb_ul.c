@@ -113,6 +113,7 @@ int srsran_enb_ul_set_cell(srsran_enb_ul_t*                   q,
       ofdm_cfg.freq_shift_f      = -0.5f;
       ofdm_cfg.normalize         = false;
       ofdm_cfg.rx_window_offset  = 0.5f;
+      ofdm_cfg.rx_sc16           = q->rx_sc16;
       if (srsran_ofdm_rx_init_cfg(&q->fft, &ofdm_cfg)) {
         ERROR("Error initiating FFT");
         return SRSRAN_ERROR;
@@ -153,6 +154,11 @@ void srsran_enb_ul_fft(srsran_enb_ul_t* q)
   srsran_ofdm_rx_sf(&q->fft);
 }
 
+void srsran_enb_ul_fft_sc16(srsran_enb_ul_t* q, const int16_t* input, float scale)
+{
+  srsran_ofdm_rx_sf_sc16(&q->fft, input, scale);
+}
+
 static int get_pucch(srsran_enb_ul_t* q, srsran_ul_sf_cfg_t* ul_sf, srsran_pucch_cfg_t* cfg, srsran_pucch_res_t* res)
 {
   int      ret                               = SRSRAN_SUCCESS;
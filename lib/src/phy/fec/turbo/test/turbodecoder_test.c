@@ -62,7 +62,8 @@ void usage(char* prog)
   printf("\t-N nof_repetitions [Default %d]\n", nof_repetitions);
   printf("\t-l frame_length [Default %d]\n", frame_length);
   printf("\t-e ebno in dB [Default scan]\n");
-  printf("\t-d Decoder implementation type: 0: Generic, 1: SSE, 2: SSE-window\n");
+  printf("\t-d Decoder implementation type: 0: Auto, 1: Generic, 2: SSE, 3: SSE-window, 4: NEON-window, 5: AVX-window, "
+         "6: SSE8-window, 7: AVX8-window, 8: AVX512-window, 9: AVX512-8-window\n");
   printf("\t-t test: check errors on exit [Default disabled]\n");
   printf("\t-s seed [Default 0=time]\n");
 }
@@ -118,7 +119,7 @@ int main(int argc, char** argv)
   uint32_t        frame_cnt;
   float*          llr;
   short*          llr_s;
-  uint8_t*        llr_c;
+  int8_t*         llr_c;
   uint8_t *       data_tx, *data_rx, *data_rx_bytes, *symbols;
   float           var[SNR_POINTS];
   uint32_t        snr_points;
@@ -185,7 +186,7 @@ int main(int argc, char** argv)
     perror("malloc");
     exit(-1);
   }
-  llr_c = srsran_vec_u8_malloc(coded_length);
+  llr_c = srsran_vec_i8_malloc(coded_length);
   if (!llr_c) {
     perror("malloc");
     exit(-1);
@@ -254,6 +255,11 @@ int main(int argc, char** argv)
         llr_s[j] = (int16_t)(100 * llr[j]);
       }
 
+      // 8-bit decoders take saturated LLR with a smaller scale
+      for (uint32_t j = 0; j < coded_length; j++) {
+        llr_c[j] = (int8_t)SRSRAN_MAX(-127.0f, SRSRAN_MIN(127.0f, 10 * llr[j]));
+      }
+
       /* decoder */
       srsran_tdec_new_cb(&tdec, frame_length);
 
@@ -266,7 +272,12 @@ int main(int argc, char** argv)
 
       gettimeofday(&tdata[1], NULL);
       for (int k = 0; k < nof_repetitions; k++) {
-        srsran_tdec_run_all(&tdec, llr_s, data_rx_bytes, t, frame_length);
+        if (tdec_type == SRSRAN_TDEC_SSE8_WINDOW || tdec_type == SRSRAN_TDEC_AVX8_WINDOW ||
+            tdec_type == SRSRAN_TDEC_AVX512_8_WINDOW) {
+          srsran_tdec_run_all_8bit(&tdec, llr_c, data_rx_bytes, t, frame_length);
+        } else {
+          srsran_tdec_run_all(&tdec, llr_s, data_rx_bytes, t, frame_length);
+        }
       }
       gettimeofday(&tdata[2], NULL);
       get_time_interval(tdata);
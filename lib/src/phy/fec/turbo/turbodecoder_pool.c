@@ -0,0 +1,260 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdlib.h>
+#include <strings.h>
+
+#include "srsran/phy/common/phy_common.h"
+#include "srsran/phy/fec/turbo/turbodecoder_pool.h"
+#include "srsran/phy/utils/debug.h"
+
+typedef struct {
+  srsran_tdec_pool_t* pool;
+  pthread_t           thread;
+  bool                started;
+  uint32_t            batch;
+  srsran_tdec_t       tdec;
+  srsran_crc_t        crc_tb; // Own CRCs, computing a CRC modifies the object
+  srsran_crc_t        crc_cb;
+  srsran_crc_t*       crc[2];
+} tdec_pool_worker_t;
+
+static void tdec_pool_decode(srsran_tdec_t*                tdec,
+                             srsran_crc_t**                crc_list,
+                             uint32_t                      nof_crc,
+                             srsran_tdec_pool_job_t*       job,
+                             const srsran_tdec_pool_cfg_t* cfg)
+{
+  srsran_crc_t* crc = NULL;
+  for (uint32_t i = 0; i < nof_crc && crc == NULL; i++) {
+    if (crc_list[i]->polynom == (int)job->crc_poly && crc_list[i]->order == job->crc_order) {
+      crc = crc_list[i];
+    }
+  }
+  if (crc == NULL) {
+    ERROR("No CRC with polynomial 0x%x and order %d for the code block", job->crc_poly, job->crc_order);
+    return;
+  }
+
+  srsran_tdec_new_cb(tdec, job->long_cb);
+
+  // Run iterations and use the CRC for early stopping
+  bool     early_stop = false;
+  uint32_t noi        = 0;
+  do {
+    if (cfg->llr_is_8bit) {
+      srsran_tdec_iteration_8bit(tdec, (int8_t*)job->input, job->output);
+    } else {
+      srsran_tdec_iteration(tdec, (int16_t*)job->input, job->output);
+    }
+    noi++;
+
+    // CRC is OK and ran the minimum number of iterations
+    early_stop = (noi >= cfg->min_iterations) && !srsran_crc_checksum_byte(crc, job->output, job->crc_len);
+  } while (noi < cfg->max_iterations && !early_stop);
+
+  job->nof_iterations = noi;
+  job->crc_ok         = early_stop;
+}
+
+/// Takes the next pending job of the current batch, or returns NULL. Must be called with the mutex locked
+static srsran_tdec_pool_job_t* tdec_pool_next_job(srsran_tdec_pool_t* q)
+{
+  if (q->next_job >= q->nof_jobs || (q->cfg.stop_on_error && q->error)) {
+    return NULL;
+  }
+  return &q->jobs[q->next_job++];
+}
+
+static void* tdec_pool_worker_thread(void* arg)
+{
+  tdec_pool_worker_t* w = (tdec_pool_worker_t*)arg;
+  srsran_tdec_pool_t* q = w->pool;
+
+  pthread_mutex_lock(&q->mutex);
+  while (true) {
+    while (!q->quit && w->batch == q->batch) {
+      pthread_cond_wait(&q->cvar_start, &q->mutex);
+    }
+    if (q->quit) {
+      break;
+    }
+    w->batch = q->batch;
+    q->nof_busy++;
+
+    srsran_tdec_pool_cfg_t  cfg = q->cfg;
+    srsran_tdec_pool_job_t* job = tdec_pool_next_job(q);
+    w->tdec.force_not_sb        = q->force_not_sb;
+    while (job) {
+      pthread_mutex_unlock(&q->mutex);
+
+      tdec_pool_decode(&w->tdec, w->crc, 2, job, &cfg);
+
+      pthread_mutex_lock(&q->mutex);
+      q->error |= !job->crc_ok;
+      job = tdec_pool_next_job(q);
+    }
+
+    q->nof_busy--;
+    if (q->nof_busy == 0) {
+      pthread_cond_signal(&q->cvar_done);
+    }
+  }
+  pthread_mutex_unlock(&q->mutex);
+
+  return NULL;
+}
+
+int srsran_tdec_pool_init(srsran_tdec_pool_t* q, uint32_t nof_workers, uint32_t max_long_cb)
+{
+  if (q == NULL || nof_workers > SRSRAN_TDEC_POOL_MAX_WORKERS) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  bzero(q, sizeof(srsran_tdec_pool_t));
+
+  pthread_mutex_init(&q->mutex, NULL);
+  pthread_cond_init(&q->cvar_start, NULL);
+  pthread_cond_init(&q->cvar_done, NULL);
+
+  tdec_pool_worker_t* workers = calloc(nof_workers ? nof_workers : 1, sizeof(tdec_pool_worker_t));
+  if (workers == NULL) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+  q->workers     = workers;
+  q->nof_workers = nof_workers;
+
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    tdec_pool_worker_t* w = &workers[i];
+    w->pool               = q;
+    if (srsran_tdec_init(&w->tdec, max_long_cb)) {
+      ERROR("Error initiating Turbo Decoder");
+      srsran_tdec_pool_free(q);
+      return SRSRAN_ERROR;
+    }
+    if (srsran_crc_init(&w->crc_tb, SRSRAN_LTE_CRC24A, 24) || srsran_crc_init(&w->crc_cb, SRSRAN_LTE_CRC24B, 24)) {
+      ERROR("Error initiating CRC");
+      srsran_tdec_pool_free(q);
+      return SRSRAN_ERROR;
+    }
+    w->crc[0] = &w->crc_tb;
+    w->crc[1] = &w->crc_cb;
+    if (pthread_create(&w->thread, NULL, tdec_pool_worker_thread, w)) {
+      ERROR("Error creating turbo decoder worker thread");
+      srsran_tdec_pool_free(q);
+      return SRSRAN_ERROR;
+    }
+    w->started = true;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_tdec_pool_free(srsran_tdec_pool_t* q)
+{
+  if (q == NULL || q->workers == NULL) {
+    return;
+  }
+
+  tdec_pool_worker_t* workers = (tdec_pool_worker_t*)q->workers;
+
+  // Stop threads
+  pthread_mutex_lock(&q->mutex);
+  q->quit = true;
+  pthread_cond_broadcast(&q->cvar_start);
+  pthread_mutex_unlock(&q->mutex);
+
+  for (uint32_t i = 0; i < q->nof_workers; i++) {
+    if (workers[i].started) {
+      pthread_join(workers[i].thread, NULL);
+    }
+    srsran_tdec_free(&workers[i].tdec);
+  }
+  free(workers);
+
+  pthread_mutex_destroy(&q->mutex);
+  pthread_cond_destroy(&q->cvar_start);
+  pthread_cond_destroy(&q->cvar_done);
+
+  bzero(q, sizeof(srsran_tdec_pool_t));
+}
+
+int srsran_tdec_pool_run(srsran_tdec_pool_t*           q,
+                         srsran_tdec_t*                tdec,
+                         srsran_crc_t**                crc,
+                         uint32_t                      nof_crc,
+                         srsran_tdec_pool_job_t*       jobs,
+                         uint32_t                      nof_jobs,
+                         const srsran_tdec_pool_cfg_t* cfg)
+{
+  if (tdec == NULL || crc == NULL || cfg == NULL || (jobs == NULL && nof_jobs > 0)) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  for (uint32_t i = 0; i < nof_jobs; i++) {
+    jobs[i].nof_iterations = 0;
+    jobs[i].crc_ok         = false;
+  }
+
+  // Without workers, or a single job, the calling thread decodes all the jobs in order
+  if (q == NULL || q->nof_workers == 0 || nof_jobs < 2) {
+    for (uint32_t i = 0; i < nof_jobs; i++) {
+      tdec_pool_decode(tdec, crc, nof_crc, &jobs[i], cfg);
+      if (cfg->stop_on_error && !jobs[i].crc_ok) {
+        break;
+      }
+    }
+    return SRSRAN_SUCCESS;
+  }
+
+  pthread_mutex_lock(&q->mutex);
+  q->cfg          = *cfg;
+  q->force_not_sb = tdec->force_not_sb;
+  q->jobs         = jobs;
+  q->nof_jobs     = nof_jobs;
+  q->next_job     = 0;
+  q->error        = false;
+  q->batch++;
+  pthread_cond_broadcast(&q->cvar_start);
+
+  // The calling thread takes jobs like the workers, with its own CRC objects
+  srsran_tdec_pool_job_t* job = tdec_pool_next_job(q);
+  while (job) {
+    pthread_mutex_unlock(&q->mutex);
+
+    tdec_pool_decode(tdec, crc, nof_crc, job, cfg);
+
+    pthread_mutex_lock(&q->mutex);
+    q->error |= !job->crc_ok;
+    job = tdec_pool_next_job(q);
+  }
+
+  // All jobs are taken, wait for the workers still decoding
+  while (q->nof_busy > 0) {
+    pthread_cond_wait(&q->cvar_done, &q->mutex);
+  }
+  q->jobs     = NULL;
+  q->nof_jobs = 0;
+  pthread_mutex_unlock(&q->mutex);
+
+  return SRSRAN_SUCCESS;
+}
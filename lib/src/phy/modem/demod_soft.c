@@ -76,6 +76,10 @@
 void demod_16qam_lte_s_sse(const cf_t* symbols, short* llr, int nsymbols);
 #endif
 
+#if defined(LV_HAVE_AVX2) || defined(LV_HAVE_AVX512)
+#include <immintrin.h>
+#endif
+
 #define SCALE_SHORT_CONV_QPSK 100
 #define SCALE_SHORT_CONV_QAM16 400
 #define SCALE_SHORT_CONV_QAM64 700
@@ -360,14 +364,8 @@ void demod_16qam_lte_b_sse(const cf_t* symbols, int8_t* llr, int nsymbols)
 
 #endif
 
-void demod_16qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
+static void demod_16qam_lte_s_generic(const cf_t* symbols, short* llr, int nsymbols)
 {
-#ifdef LV_HAVE_SSE
-  demod_16qam_lte_s_sse(symbols, llr, nsymbols);
-#else
-#ifdef HAVE_NEONv8
-  demod_16qam_lte_s_neon(symbols, llr, nsymbols);
-#else
   for (int i = 0; i < nsymbols; i++) {
     short yre = (short)(SCALE_SHORT_CONV_QAM16 * crealf(symbols[i]));
     short yim = (short)(SCALE_SHORT_CONV_QAM16 * cimagf(symbols[i]));
@@ -377,18 +375,10 @@ void demod_16qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
     llr[4 * i + 2] = abs(yre) - 2 * SCALE_SHORT_CONV_QAM16 / sqrtf(10);
     llr[4 * i + 3] = abs(yim) - 2 * SCALE_SHORT_CONV_QAM16 / sqrtf(10);
   }
-#endif
-#endif
 }
 
-void demod_16qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
+static void demod_16qam_lte_b_generic(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
-#ifdef LV_HAVE_SSE
-  demod_16qam_lte_b_sse(symbols, llr, nsymbols);
-#else
-#ifdef HAVE_NEONv8
-  demod_16qam_lte_b_neon(symbols, llr, nsymbols);
-#else
   for (int i = 0; i < nsymbols; i++) {
     int8_t yre = (int8_t)(SCALE_BYTE_CONV_QAM16 * crealf(symbols[i]));
     int8_t yim = (int8_t)(SCALE_BYTE_CONV_QAM16 * cimagf(symbols[i]));
@@ -398,8 +388,6 @@ void demod_16qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
     llr[4 * i + 2] = abs(yre) - 2 * SCALE_BYTE_CONV_QAM16 / sqrtf(10);
     llr[4 * i + 3] = abs(yim) - 2 * SCALE_BYTE_CONV_QAM16 / sqrtf(10);
   }
-#endif
-#endif
 }
 
 void demod_64qam_lte(const cf_t* symbols, float* llr, int nsymbols)
@@ -731,14 +719,8 @@ void demod_64qam_lte_b_sse(const cf_t* symbols, int8_t* llr, int nsymbols)
 
 #endif
 
-void demod_64qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
+static void demod_64qam_lte_s_generic(const cf_t* symbols, short* llr, int nsymbols)
 {
-#ifdef LV_HAVE_SSE
-  demod_64qam_lte_s_sse(symbols, llr, nsymbols);
-#else
-#ifdef HAVE_NEONv8
-  demod_64qam_lte_s_neon(symbols, llr, nsymbols);
-#else
   for (int i = 0; i < nsymbols; i++) {
     float yre = (short)(SCALE_SHORT_CONV_QAM64 * crealf(symbols[i]));
     float yim = (short)(SCALE_SHORT_CONV_QAM64 * cimagf(symbols[i]));
@@ -750,18 +732,10 @@ void demod_64qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
     llr[6 * i + 4] = abs(llr[6 * i + 2]) - 2 * SCALE_SHORT_CONV_QAM64 / sqrtf(42);
     llr[6 * i + 5] = abs(llr[6 * i + 3]) - 2 * SCALE_SHORT_CONV_QAM64 / sqrtf(42);
   }
-#endif
-#endif
 }
 
-void demod_64qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
+static void demod_64qam_lte_b_generic(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
-#ifdef LV_HAVE_SSE
-  demod_64qam_lte_b_sse(symbols, llr, nsymbols);
-#else
-#ifdef HAVE_NEONv8
-  demod_64qam_lte_b_neon(symbols, llr, nsymbols);
-#else
   for (int i = 0; i < nsymbols; i++) {
     float yre = (int8_t)(SCALE_BYTE_CONV_QAM64 * crealf(symbols[i]));
     float yim = (int8_t)(SCALE_BYTE_CONV_QAM64 * cimagf(symbols[i]));
@@ -773,8 +747,6 @@ void demod_64qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
     llr[6 * i + 4] = abs(llr[6 * i + 2]) - 2 * SCALE_BYTE_CONV_QAM64 / sqrtf(42);
     llr[6 * i + 5] = abs(llr[6 * i + 3]) - 2 * SCALE_BYTE_CONV_QAM64 / sqrtf(42);
   }
-#endif
-#endif
 }
 
 void demod_256qam_lte(const cf_t* symbols, float* llr, int nsymbols)
@@ -799,7 +771,7 @@ void demod_256qam_lte(const cf_t* symbols, float* llr, int nsymbols)
   }
 }
 
-void demod_256qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
+static void demod_256qam_lte_b_generic(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
   for (int i = 0; i < nsymbols; i++) {
     float real = -__real__ symbols[i];
@@ -821,7 +793,7 @@ void demod_256qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
   }
 }
 
-void demod_256qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
+static void demod_256qam_lte_s_generic(const cf_t* symbols, short* llr, int nsymbols)
 {
   for (int i = 0; i < nsymbols; i++) {
     float real = -__real__ symbols[i];
@@ -843,6 +815,589 @@ void demod_256qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
   }
 }
 
+#ifdef LV_HAVE_AVX2
+
+static void demod_16qam_lte_s_avx2(const cf_t* symbols, short* llr, int nsymbols)
+{
+  const float* symbolsPtr = (const float*)symbols;
+  __m256i      offset     = _mm256_set1_epi16(2 * SCALE_SHORT_CONV_QAM16 / sqrtf(10));
+  __m256       scale_v    = _mm256_set1_ps(-SCALE_SHORT_CONV_QAM16);
+
+  int i = 0;
+  for (; i < nsymbols - 7; i += 8) {
+    __m256i symbol_i1 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(&symbolsPtr[2 * i]), scale_v));
+    __m256i symbol_i2 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(&symbolsPtr[2 * i + 8]), scale_v));
+
+    // Symbols {0, 1, 4, 5} in the lower lane and {2, 3, 6, 7} in the upper lane
+    __m256i symbol_i   = _mm256_packs_epi32(symbol_i1, symbol_i2);
+    __m256i symbol_abs = _mm256_sub_epi16(_mm256_abs_epi16(symbol_i), offset);
+
+    _mm256_storeu_si256((__m256i*)&llr[4 * i], _mm256_unpacklo_epi32(symbol_i, symbol_abs));
+    _mm256_storeu_si256((__m256i*)&llr[4 * i + 16], _mm256_unpackhi_epi32(symbol_i, symbol_abs));
+  }
+  demod_16qam_lte_s_sse(&symbols[i], &llr[4 * i], nsymbols - i);
+}
+
+static void demod_16qam_lte_b_avx2(const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+  const float* symbolsPtr = (const float*)symbols;
+  __m256i      offset     = _mm256_set1_epi8(2 * SCALE_BYTE_CONV_QAM16 / sqrtf(10));
+  __m256       scale_v    = _mm256_set1_ps(-SCALE_BYTE_CONV_QAM16);
+  __m256i      reorder    = _mm256_setr_epi32(0, 4, 2, 6, 1, 5, 3, 7);
+
+  int i = 0;
+  for (; i < nsymbols - 15; i += 16) {
+    __m256i symbol_i1 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(&symbolsPtr[2 * i]), scale_v));
+    __m256i symbol_i2 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(&symbolsPtr[2 * i + 8]), scale_v));
+    __m256i symbol_i3 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(&symbolsPtr[2 * i + 16]), scale_v));
+    __m256i symbol_i4 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(&symbolsPtr[2 * i + 24]), scale_v));
+    __m256i symbol_i  = _mm256_packs_epi16(_mm256_packs_epi32(symbol_i1, symbol_i2),
+                                          _mm256_packs_epi32(symbol_i3, symbol_i4));
+
+    // Symbols {0..3, 8..11} in the lower lane and {4..7, 12..15} in the upper lane
+    symbol_i           = _mm256_permutevar8x32_epi32(symbol_i, reorder);
+    __m256i symbol_abs = _mm256_sub_epi8(_mm256_abs_epi8(symbol_i), offset);
+
+    _mm256_storeu_si256((__m256i*)&llr[4 * i], _mm256_unpacklo_epi16(symbol_i, symbol_abs));
+    _mm256_storeu_si256((__m256i*)&llr[4 * i + 32], _mm256_unpackhi_epi16(symbol_i, symbol_abs));
+  }
+  demod_16qam_lte_b_sse(&symbols[i], &llr[4 * i], nsymbols - i);
+}
+
+static void demod_64qam_lte_s_avx2(const cf_t* symbols, short* llr, int nsymbols)
+{
+  const float* symbolsPtr = (const float*)symbols;
+  __m256i      offset1    = _mm256_set1_epi16(4 * SCALE_SHORT_CONV_QAM64 / sqrtf(42));
+  __m256i      offset2    = _mm256_set1_epi16(2 * SCALE_SHORT_CONV_QAM64 / sqrtf(42));
+  __m256       scale_v    = _mm256_set1_ps(-SCALE_SHORT_CONV_QAM64);
+
+  // Symbol of each 32 bit output, holding the real and imaginary LLR
+  __m256i idx1 = _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2);
+  __m256i idx2 = _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5);
+  __m256i idx3 = _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7);
+
+  int i = 0;
+  for (; i < nsymbols - 7; i += 8) {
+    __m256i symbol_i1 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(&symbolsPtr[2 * i]), scale_v));
+    __m256i symbol_i2 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(&symbolsPtr[2 * i + 8]), scale_v));
+    __m256i symbol_i  = _mm256_permute4x64_epi64(_mm256_packs_epi32(symbol_i1, symbol_i2), 0xD8);
+
+    __m256i symbol_abs  = _mm256_sub_epi16(_mm256_abs_epi16(symbol_i), offset1);
+    __m256i symbol_abs2 = _mm256_sub_epi16(_mm256_abs_epi16(symbol_abs), offset2);
+
+    __m256i result1 = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(symbol_i, idx1),
+                                         _mm256_permutevar8x32_epi32(symbol_abs, idx1),
+                                         0x92);
+    result1         = _mm256_blend_epi32(result1, _mm256_permutevar8x32_epi32(symbol_abs2, idx1), 0x24);
+
+    __m256i result2 = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(symbol_i, idx2),
+                                         _mm256_permutevar8x32_epi32(symbol_abs, idx2),
+                                         0x24);
+    result2         = _mm256_blend_epi32(result2, _mm256_permutevar8x32_epi32(symbol_abs2, idx2), 0x49);
+
+    __m256i result3 = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(symbol_i, idx3),
+                                         _mm256_permutevar8x32_epi32(symbol_abs, idx3),
+                                         0x49);
+    result3         = _mm256_blend_epi32(result3, _mm256_permutevar8x32_epi32(symbol_abs2, idx3), 0x92);
+
+    _mm256_storeu_si256((__m256i*)&llr[6 * i], result1);
+    _mm256_storeu_si256((__m256i*)&llr[6 * i + 16], result2);
+    _mm256_storeu_si256((__m256i*)&llr[6 * i + 32], result3);
+  }
+  demod_64qam_lte_s_sse(&symbols[i], &llr[6 * i], nsymbols - i);
+}
+
+static void demod_64qam_lte_b_avx2(const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+  const float* symbolsPtr = (const float*)symbols;
+  __m256i      offset1    = _mm256_set1_epi8(4 * SCALE_BYTE_CONV_QAM64 / sqrtf(42));
+  __m256i      offset2    = _mm256_set1_epi8(2 * SCALE_BYTE_CONV_QAM64 / sqrtf(42));
+  __m256       scale_v    = _mm256_set1_ps(-SCALE_BYTE_CONV_QAM64);
+  __m256i      reorder    = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+  // Same shuffles as the SSE implementation, applied to the 8 symbols of each lane
+  __m256i shuffle_negated_1 = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(0xff, 0xff, 5, 4, 0xff, 0xff, 0xff, 0xff, 3, 2, 0xff, 0xff, 0xff, 0xff, 1, 0));
+  __m256i shuffle_negated_2 = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(11, 10, 0xff, 0xff, 0xff, 0xff, 9, 8, 0xff, 0xff, 0xff, 0xff, 7, 6, 0xff, 0xff));
+  __m256i shuffle_negated_3 = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(0xff, 0xff, 0xff, 0xff, 15, 14, 0xff, 0xff, 0xff, 0xff, 13, 12, 0xff, 0xff, 0xff, 0xff));
+
+  __m256i shuffle_abs_1 = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(5, 4, 0xff, 0xff, 0xff, 0xff, 3, 2, 0xff, 0xff, 0xff, 0xff, 1, 0, 0xff, 0xff));
+  __m256i shuffle_abs_2 = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(0xff, 0xff, 0xff, 0xff, 9, 8, 0xff, 0xff, 0xff, 0xff, 7, 6, 0xff, 0xff, 0xff, 0xff));
+  __m256i shuffle_abs_3 = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(0xff, 0xff, 15, 14, 0xff, 0xff, 0xff, 0xff, 13, 12, 0xff, 0xff, 0xff, 0xff, 11, 10));
+
+  __m256i shuffle_abs2_1 = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(0xff, 0xff, 0xff, 0xff, 3, 2, 0xff, 0xff, 0xff, 0xff, 1, 0, 0xff, 0xff, 0xff, 0xff));
+  __m256i shuffle_abs2_2 = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(0xff, 0xff, 9, 8, 0xff, 0xff, 0xff, 0xff, 7, 6, 0xff, 0xff, 0xff, 0xff, 5, 4));
+  __m256i shuffle_abs2_3 = _mm256_broadcastsi128_si256(
+      _mm_set_epi8(15, 14, 0xff, 0xff, 0xff, 0xff, 13, 12, 0xff, 0xff, 0xff, 0xff, 11, 10, 0xff, 0xff));
+
+  int i = 0;
+  for (; i < nsymbols - 15; i += 16) {
+    __m256i symbol_i1 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(&symbolsPtr[2 * i]), scale_v));
+    __m256i symbol_i2 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(&symbolsPtr[2 * i + 8]), scale_v));
+    __m256i symbol_i3 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(&symbolsPtr[2 * i + 16]), scale_v));
+    __m256i symbol_i4 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(&symbolsPtr[2 * i + 24]), scale_v));
+    __m256i symbol_i  = _mm256_packs_epi16(_mm256_packs_epi32(symbol_i1, symbol_i2),
+                                          _mm256_packs_epi32(symbol_i3, symbol_i4));
+
+    // Symbols 0 to 7 in the lower lane and 8 to 15 in the upper lane
+    symbol_i            = _mm256_permutevar8x32_epi32(symbol_i, reorder);
+    __m256i symbol_abs  = _mm256_sub_epi8(_mm256_abs_epi8(symbol_i), offset1);
+    __m256i symbol_abs2 = _mm256_sub_epi8(_mm256_abs_epi8(symbol_abs), offset2);
+
+    __m256i result1 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(symbol_i, shuffle_negated_1),
+                                                      _mm256_shuffle_epi8(symbol_abs, shuffle_abs_1)),
+                                      _mm256_shuffle_epi8(symbol_abs2, shuffle_abs2_1));
+    __m256i result2 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(symbol_i, shuffle_negated_2),
+                                                      _mm256_shuffle_epi8(symbol_abs, shuffle_abs_2)),
+                                      _mm256_shuffle_epi8(symbol_abs2, shuffle_abs2_2));
+    __m256i result3 = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(symbol_i, shuffle_negated_3),
+                                                      _mm256_shuffle_epi8(symbol_abs, shuffle_abs_3)),
+                                      _mm256_shuffle_epi8(symbol_abs2, shuffle_abs2_3));
+
+    _mm256_storeu_si256((__m256i*)&llr[6 * i], _mm256_permute2x128_si256(result1, result2, 0x20));
+    _mm256_storeu_si256((__m256i*)&llr[6 * i + 32], _mm256_permute2x128_si256(result3, result1, 0x30));
+    _mm256_storeu_si256((__m256i*)&llr[6 * i + 64], _mm256_permute2x128_si256(result2, result3, 0x31));
+  }
+  demod_64qam_lte_b_sse(&symbols[i], &llr[6 * i], nsymbols - i);
+}
+
+/// Computes the four LLR pairs of 8 256QAM symbols as in the generic implementation. Each 32 bit word of levels[k]
+/// holds the pair k of a symbol, in the order {0, 1, 4, 5} in the lower lane and {2, 3, 6, 7} in the upper lane
+static inline void demod_256qam_levels_avx2(const float* symbolsPtr, __m256 scale_v, __m256i levels[4])
+{
+  const __m256 sign_mask     = _mm256_set1_ps(-0.0f);
+  const __m256 thresholds[3] = {_mm256_set1_ps(8.0f / sqrtf(170.0f)),
+                                _mm256_set1_ps(4.0f / sqrtf(170.0f)),
+                                _mm256_set1_ps(2.0f / sqrtf(170.0f))};
+
+  __m256 symbol1 = _mm256_xor_ps(_mm256_loadu_ps(symbolsPtr), sign_mask);
+  __m256 symbol2 = _mm256_xor_ps(_mm256_loadu_ps(symbolsPtr + 8), sign_mask);
+  for (int k = 0; k < 4; k++) {
+    if (k > 0) {
+      symbol1 = _mm256_sub_ps(_mm256_andnot_ps(sign_mask, symbol1), thresholds[k - 1]);
+      symbol2 = _mm256_sub_ps(_mm256_andnot_ps(sign_mask, symbol2), thresholds[k - 1]);
+    }
+    levels[k] = _mm256_packs_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(symbol1, scale_v)),
+                                   _mm256_cvttps_epi32(_mm256_mul_ps(symbol2, scale_v)));
+  }
+
+  // Gather the four pairs of each symbol, the symbols {0, 2}, {1, 3}, {4, 6} and {5, 7} are left in each output
+  __m256i lo01 = _mm256_unpacklo_epi32(levels[0], levels[1]);
+  __m256i lo23 = _mm256_unpacklo_epi32(levels[2], levels[3]);
+  __m256i hi01 = _mm256_unpackhi_epi32(levels[0], levels[1]);
+  __m256i hi23 = _mm256_unpackhi_epi32(levels[2], levels[3]);
+  levels[0]    = _mm256_unpacklo_epi64(lo01, lo23);
+  levels[1]    = _mm256_unpackhi_epi64(lo01, lo23);
+  levels[2]    = _mm256_unpacklo_epi64(hi01, hi23);
+  levels[3]    = _mm256_unpackhi_epi64(hi01, hi23);
+}
+
+static void demod_256qam_lte_s_avx2(const cf_t* symbols, short* llr, int nsymbols)
+{
+  const float* symbolsPtr = (const float*)symbols;
+  __m256       scale_v    = _mm256_set1_ps(SCALE_SHORT_CONV_QAM256);
+  __m256i      levels[4];
+
+  int i = 0;
+  for (; i < nsymbols - 7; i += 8) {
+    demod_256qam_levels_avx2(&symbolsPtr[2 * i], scale_v, levels);
+
+    _mm256_storeu_si256((__m256i*)&llr[8 * i], _mm256_permute2x128_si256(levels[0], levels[1], 0x20));
+    _mm256_storeu_si256((__m256i*)&llr[8 * i + 16], _mm256_permute2x128_si256(levels[0], levels[1], 0x31));
+    _mm256_storeu_si256((__m256i*)&llr[8 * i + 32], _mm256_permute2x128_si256(levels[2], levels[3], 0x20));
+    _mm256_storeu_si256((__m256i*)&llr[8 * i + 48], _mm256_permute2x128_si256(levels[2], levels[3], 0x31));
+  }
+  demod_256qam_lte_s_generic(&symbols[i], &llr[8 * i], nsymbols - i);
+}
+
+static void demod_256qam_lte_b_avx2(const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+  const float* symbolsPtr = (const float*)symbols;
+  __m256       scale_v    = _mm256_set1_ps(SCALE_BYTE_CONV_QAM256);
+  __m256i      levels[4];
+
+  int i = 0;
+  for (; i < nsymbols - 7; i += 8) {
+    demod_256qam_levels_avx2(&symbolsPtr[2 * i], scale_v, levels);
+
+    // Packing within each lane leaves the symbols in order
+    _mm256_storeu_si256((__m256i*)&llr[8 * i], _mm256_packs_epi16(levels[0], levels[1]));
+    _mm256_storeu_si256((__m256i*)&llr[8 * i + 32], _mm256_packs_epi16(levels[2], levels[3]));
+  }
+  demod_256qam_lte_b_generic(&symbols[i], &llr[8 * i], nsymbols - i);
+}
+
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_AVX512
+
+// Output word j of the vector k holds the LLR (16 * k + j) % 3 of symbol (16 * k + j) / 3. The words taken from the
+// first absolute value are offset by 16, the ones set by the mask are taken from the second absolute value
+static const int32_t demod_64qam_avx512_idx_s[3][16] = {
+    {0, 16, 0, 1, 17, 1, 2, 18, 2, 3, 19, 3, 4, 20, 4, 5},
+    {21, 5, 6, 22, 6, 7, 23, 7, 8, 24, 8, 9, 25, 9, 10, 26},
+    {10, 11, 27, 11, 12, 28, 12, 13, 29, 13, 14, 30, 14, 15, 31, 15}};
+static const __mmask16 demod_64qam_avx512_mask_s[3] = {0x4924, 0x2492, 0x9249};
+
+// Same for 16 bit words, with 32 symbols
+static const int16_t demod_64qam_avx512_idx_b[3][32] = {
+    {0, 32, 0, 1, 33, 1, 2, 34, 2, 3, 35, 3, 4, 36, 4, 5, 37, 5, 6, 38, 6, 7, 39, 7, 8, 40, 8, 9, 41, 9, 10, 42},
+    {10, 11, 43, 11, 12, 44, 12, 13, 45, 13, 14, 46, 14, 15, 47, 15,
+     16, 48, 16, 17, 49, 17, 18, 50, 18, 19, 51, 19, 20, 52, 20, 21},
+    {53, 21, 22, 54, 22, 23, 55, 23, 24, 56, 24, 25, 57, 25, 26, 58,
+     26, 27, 59, 27, 28, 60, 28, 29, 61, 29, 30, 62, 30, 31, 63, 31}};
+static const __mmask32 demod_64qam_avx512_mask_b[3] = {0x24924924, 0x49249249, 0x92492492};
+
+/// Converts 16 symbols to saturated 16 bit words, in order
+static inline __m512i demod_cvt_epi16_avx512(const float* symbolsPtr, __m512 scale_v)
+{
+  __m256i symbol_i1 = _mm512_cvtsepi32_epi16(_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_loadu_ps(symbolsPtr), scale_v)));
+  __m256i symbol_i2 =
+      _mm512_cvtsepi32_epi16(_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_loadu_ps(symbolsPtr + 16), scale_v)));
+  return _mm512_inserti64x4(_mm512_castsi256_si512(symbol_i1), symbol_i2, 1);
+}
+
+static void demod_16qam_lte_s_avx512(const cf_t* symbols, short* llr, int nsymbols)
+{
+  const float* symbolsPtr = (const float*)symbols;
+  __m512i      offset     = _mm512_set1_epi16(2 * SCALE_SHORT_CONV_QAM16 / sqrtf(10));
+  __m512       scale_v    = _mm512_set1_ps(-SCALE_SHORT_CONV_QAM16);
+  __m512i      idx1       = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+  __m512i      idx2       = _mm512_add_epi32(idx1, _mm512_set1_epi32(8));
+
+  int i = 0;
+  for (; i < nsymbols - 15; i += 16) {
+    __m512i symbol_i   = demod_cvt_epi16_avx512(&symbolsPtr[2 * i], scale_v);
+    __m512i symbol_abs = _mm512_sub_epi16(_mm512_abs_epi16(symbol_i), offset);
+
+    _mm512_storeu_si512(&llr[4 * i], _mm512_permutex2var_epi32(symbol_i, idx1, symbol_abs));
+    _mm512_storeu_si512(&llr[4 * i + 32], _mm512_permutex2var_epi32(symbol_i, idx2, symbol_abs));
+  }
+  demod_16qam_lte_s_avx2(&symbols[i], &llr[4 * i], nsymbols - i);
+}
+
+static void demod_16qam_lte_b_avx512(const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+  const float* symbolsPtr = (const float*)symbols;
+  __m512i      offset     = _mm512_set1_epi8(2 * SCALE_BYTE_CONV_QAM16 / sqrtf(10));
+  __m512       scale_v    = _mm512_set1_ps(-SCALE_BYTE_CONV_QAM16);
+
+  int16_t idx[32];
+  for (int j = 0; j < 32; j++) {
+    idx[j] = (int16_t)(j / 2 + (j % 2) * 32);
+  }
+  __m512i idx1 = _mm512_loadu_si512(idx);
+  __m512i idx2 = _mm512_add_epi16(idx1, _mm512_set1_epi16(16));
+
+  int i = 0;
+  for (; i < nsymbols - 31; i += 32) {
+    __m256i symbol_i1  = _mm512_cvtsepi16_epi8(demod_cvt_epi16_avx512(&symbolsPtr[2 * i], scale_v));
+    __m256i symbol_i2  = _mm512_cvtsepi16_epi8(demod_cvt_epi16_avx512(&symbolsPtr[2 * i + 32], scale_v));
+    __m512i symbol_i   = _mm512_inserti64x4(_mm512_castsi256_si512(symbol_i1), symbol_i2, 1);
+    __m512i symbol_abs = _mm512_sub_epi8(_mm512_abs_epi8(symbol_i), offset);
+
+    _mm512_storeu_si512(&llr[4 * i], _mm512_permutex2var_epi16(symbol_i, idx1, symbol_abs));
+    _mm512_storeu_si512(&llr[4 * i + 64], _mm512_permutex2var_epi16(symbol_i, idx2, symbol_abs));
+  }
+  demod_16qam_lte_b_avx2(&symbols[i], &llr[4 * i], nsymbols - i);
+}
+
+static void demod_64qam_lte_s_avx512(const cf_t* symbols, short* llr, int nsymbols)
+{
+  const float* symbolsPtr = (const float*)symbols;
+  __m512i      offset1    = _mm512_set1_epi16(4 * SCALE_SHORT_CONV_QAM64 / sqrtf(42));
+  __m512i      offset2    = _mm512_set1_epi16(2 * SCALE_SHORT_CONV_QAM64 / sqrtf(42));
+  __m512       scale_v    = _mm512_set1_ps(-SCALE_SHORT_CONV_QAM64);
+  __m512i      idx[3];
+  for (int k = 0; k < 3; k++) {
+    idx[k] = _mm512_loadu_si512(demod_64qam_avx512_idx_s[k]);
+  }
+
+  int i = 0;
+  for (; i < nsymbols - 15; i += 16) {
+    __m512i symbol_i    = demod_cvt_epi16_avx512(&symbolsPtr[2 * i], scale_v);
+    __m512i symbol_abs  = _mm512_sub_epi16(_mm512_abs_epi16(symbol_i), offset1);
+    __m512i symbol_abs2 = _mm512_sub_epi16(_mm512_abs_epi16(symbol_abs), offset2);
+
+    for (int k = 0; k < 3; k++) {
+      __m512i result = _mm512_permutex2var_epi32(symbol_i, idx[k], symbol_abs);
+      result = _mm512_mask_permutexvar_epi32(result, demod_64qam_avx512_mask_s[k], idx[k], symbol_abs2);
+      _mm512_storeu_si512(&llr[6 * i + 32 * k], result);
+    }
+  }
+  demod_64qam_lte_s_avx2(&symbols[i], &llr[6 * i], nsymbols - i);
+}
+
+static void demod_64qam_lte_b_avx512(const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+  const float* symbolsPtr = (const float*)symbols;
+  __m512i      offset1    = _mm512_set1_epi8(4 * SCALE_BYTE_CONV_QAM64 / sqrtf(42));
+  __m512i      offset2    = _mm512_set1_epi8(2 * SCALE_BYTE_CONV_QAM64 / sqrtf(42));
+  __m512       scale_v    = _mm512_set1_ps(-SCALE_BYTE_CONV_QAM64);
+  __m512i      idx[3];
+  for (int k = 0; k < 3; k++) {
+    idx[k] = _mm512_loadu_si512(demod_64qam_avx512_idx_b[k]);
+  }
+
+  int i = 0;
+  for (; i < nsymbols - 31; i += 32) {
+    __m256i symbol_i1   = _mm512_cvtsepi16_epi8(demod_cvt_epi16_avx512(&symbolsPtr[2 * i], scale_v));
+    __m256i symbol_i2   = _mm512_cvtsepi16_epi8(demod_cvt_epi16_avx512(&symbolsPtr[2 * i + 32], scale_v));
+    __m512i symbol_i    = _mm512_inserti64x4(_mm512_castsi256_si512(symbol_i1), symbol_i2, 1);
+    __m512i symbol_abs  = _mm512_sub_epi8(_mm512_abs_epi8(symbol_i), offset1);
+    __m512i symbol_abs2 = _mm512_sub_epi8(_mm512_abs_epi8(symbol_abs), offset2);
+
+    for (int k = 0; k < 3; k++) {
+      __m512i result = _mm512_permutex2var_epi16(symbol_i, idx[k], symbol_abs);
+      result = _mm512_mask_permutexvar_epi16(result, demod_64qam_avx512_mask_b[k], idx[k], symbol_abs2);
+      _mm512_storeu_si512(&llr[6 * i + 64 * k], result);
+    }
+  }
+  demod_64qam_lte_b_avx2(&symbols[i], &llr[6 * i], nsymbols - i);
+}
+
+/// Computes the four LLR pairs of 16 256QAM symbols as in the generic implementation and interleaves them. Each
+/// output holds 4 symbols as 16 bit words
+static inline void demod_256qam_levels_avx512(const float* symbolsPtr, __m512 scale_v, __m512i out[4])
+{
+  const __m512 sign_mask     = _mm512_set1_ps(-0.0f);
+  const __m512 thresholds[3] = {_mm512_set1_ps(8.0f / sqrtf(170.0f)),
+                                _mm512_set1_ps(4.0f / sqrtf(170.0f)),
+                                _mm512_set1_ps(2.0f / sqrtf(170.0f))};
+  __m512i      idx           = _mm512_setr_epi32(0, 16, 0, 16, 1, 17, 1, 17, 2, 18, 2, 18, 3, 19, 3, 19);
+  __m512i      levels[4];
+
+  __m512 symbol1 = _mm512_xor_ps(_mm512_loadu_ps(symbolsPtr), sign_mask);
+  __m512 symbol2 = _mm512_xor_ps(_mm512_loadu_ps(symbolsPtr + 16), sign_mask);
+  for (int k = 0; k < 4; k++) {
+    if (k > 0) {
+      symbol1 = _mm512_sub_ps(_mm512_andnot_ps(sign_mask, symbol1), thresholds[k - 1]);
+      symbol2 = _mm512_sub_ps(_mm512_andnot_ps(sign_mask, symbol2), thresholds[k - 1]);
+    }
+    __m256i level1 = _mm512_cvtsepi32_epi16(_mm512_cvttps_epi32(_mm512_mul_ps(symbol1, scale_v)));
+    __m256i level2 = _mm512_cvtsepi32_epi16(_mm512_cvttps_epi32(_mm512_mul_ps(symbol2, scale_v)));
+    levels[k]      = _mm512_inserti64x4(_mm512_castsi256_si512(level1), level2, 1);
+  }
+
+  // Each 32 bit word is the pair of a symbol, take the pairs 2 and 3 from the second permutation
+  for (int k = 0; k < 4; k++) {
+    out[k] = _mm512_mask_blend_epi32(0xCCCC,
+                                     _mm512_permutex2var_epi32(levels[0], idx, levels[1]),
+                                     _mm512_permutex2var_epi32(levels[2], idx, levels[3]));
+    idx    = _mm512_add_epi32(idx, _mm512_set1_epi32(4));
+  }
+}
+
+static void demod_256qam_lte_s_avx512(const cf_t* symbols, short* llr, int nsymbols)
+{
+  const float* symbolsPtr = (const float*)symbols;
+  __m512       scale_v    = _mm512_set1_ps(SCALE_SHORT_CONV_QAM256);
+  __m512i      out[4];
+
+  int i = 0;
+  for (; i < nsymbols - 15; i += 16) {
+    demod_256qam_levels_avx512(&symbolsPtr[2 * i], scale_v, out);
+    for (int k = 0; k < 4; k++) {
+      _mm512_storeu_si512(&llr[8 * i + 32 * k], out[k]);
+    }
+  }
+  demod_256qam_lte_s_avx2(&symbols[i], &llr[8 * i], nsymbols - i);
+}
+
+static void demod_256qam_lte_b_avx512(const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+  const float* symbolsPtr = (const float*)symbols;
+  __m512       scale_v    = _mm512_set1_ps(SCALE_BYTE_CONV_QAM256);
+  __m512i      out[4];
+
+  int i = 0;
+  for (; i < nsymbols - 15; i += 16) {
+    demod_256qam_levels_avx512(&symbolsPtr[2 * i], scale_v, out);
+    for (int k = 0; k < 4; k++) {
+      _mm256_storeu_si256((__m256i*)&llr[8 * i + 32 * k], _mm512_cvtsepi16_epi8(out[k]));
+    }
+  }
+  demod_256qam_lte_b_avx2(&symbols[i], &llr[8 * i], nsymbols - i);
+}
+
+#endif /* LV_HAVE_AVX512 */
+
+static void demod_16qam_lte_s(srsran_demod_soft_impl_t impl, const cf_t* symbols, short* llr, int nsymbols)
+{
+#ifdef LV_HAVE_AVX512
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_AVX512) {
+    demod_16qam_lte_s_avx512(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_AVX2) {
+    demod_16qam_lte_s_avx2(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_SSE) {
+    demod_16qam_lte_s_sse(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_SSE */
+#ifdef HAVE_NEONv8
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_SSE) {
+    demod_16qam_lte_s_neon(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* HAVE_NEONv8 */
+  demod_16qam_lte_s_generic(symbols, llr, nsymbols);
+}
+
+static void demod_16qam_lte_b(srsran_demod_soft_impl_t impl, const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+#ifdef LV_HAVE_AVX512
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_AVX512) {
+    demod_16qam_lte_b_avx512(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_AVX2) {
+    demod_16qam_lte_b_avx2(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_SSE) {
+    demod_16qam_lte_b_sse(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_SSE */
+#ifdef HAVE_NEONv8
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_SSE) {
+    demod_16qam_lte_b_neon(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* HAVE_NEONv8 */
+  demod_16qam_lte_b_generic(symbols, llr, nsymbols);
+}
+
+static void demod_64qam_lte_s(srsran_demod_soft_impl_t impl, const cf_t* symbols, short* llr, int nsymbols)
+{
+#ifdef LV_HAVE_AVX512
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_AVX512) {
+    demod_64qam_lte_s_avx512(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_AVX2) {
+    demod_64qam_lte_s_avx2(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_SSE) {
+    demod_64qam_lte_s_sse(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_SSE */
+#ifdef HAVE_NEONv8
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_SSE) {
+    demod_64qam_lte_s_neon(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* HAVE_NEONv8 */
+  demod_64qam_lte_s_generic(symbols, llr, nsymbols);
+}
+
+static void demod_64qam_lte_b(srsran_demod_soft_impl_t impl, const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+#ifdef LV_HAVE_AVX512
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_AVX512) {
+    demod_64qam_lte_b_avx512(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_AVX2) {
+    demod_64qam_lte_b_avx2(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_AVX2 */
+#ifdef LV_HAVE_SSE
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_SSE) {
+    demod_64qam_lte_b_sse(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_SSE */
+#ifdef HAVE_NEONv8
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_SSE) {
+    demod_64qam_lte_b_neon(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* HAVE_NEONv8 */
+  demod_64qam_lte_b_generic(symbols, llr, nsymbols);
+}
+
+static void demod_256qam_lte_s(srsran_demod_soft_impl_t impl, const cf_t* symbols, short* llr, int nsymbols)
+{
+#ifdef LV_HAVE_AVX512
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_AVX512) {
+    demod_256qam_lte_s_avx512(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_AVX2) {
+    demod_256qam_lte_s_avx2(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_AVX2 */
+  demod_256qam_lte_s_generic(symbols, llr, nsymbols);
+}
+
+static void demod_256qam_lte_b(srsran_demod_soft_impl_t impl, const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+#ifdef LV_HAVE_AVX512
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_AVX512) {
+    demod_256qam_lte_b_avx512(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_AVX512 */
+#ifdef LV_HAVE_AVX2
+  if (impl >= SRSRAN_DEMOD_SOFT_IMPL_AVX2) {
+    demod_256qam_lte_b_avx2(symbols, llr, nsymbols);
+    return;
+  }
+#endif /* LV_HAVE_AVX2 */
+  demod_256qam_lte_b_generic(symbols, llr, nsymbols);
+}
+
+/// Returns the fastest implementation compiled in. The library is built for the instruction set of the target CPU
+static srsran_demod_soft_impl_t demod_soft_impl_best()
+{
+#if defined(LV_HAVE_AVX512)
+  return SRSRAN_DEMOD_SOFT_IMPL_AVX512;
+#elif defined(LV_HAVE_AVX2)
+  return SRSRAN_DEMOD_SOFT_IMPL_AVX2;
+#elif defined(LV_HAVE_SSE) || defined(HAVE_NEONv8)
+  return SRSRAN_DEMOD_SOFT_IMPL_SSE;
+#else
+  return SRSRAN_DEMOD_SOFT_IMPL_GENERIC;
+#endif
+}
+
+bool srsran_demod_soft_impl_available(srsran_demod_soft_impl_t impl)
+{
+  return impl == SRSRAN_DEMOD_SOFT_IMPL_AUTO || (impl < SRSRAN_DEMOD_SOFT_IMPL_NOF && impl <= demod_soft_impl_best());
+}
+
 int srsran_demod_soft_demodulate(srsran_mod_t modulation, const cf_t* symbols, float* llr, int nsymbols)
 {
   switch (modulation) {
@@ -868,8 +1423,20 @@ int srsran_demod_soft_demodulate(srsran_mod_t modulation, const cf_t* symbols, f
   return 0;
 }
 
-int srsran_demod_soft_demodulate_s(srsran_mod_t modulation, const cf_t* symbols, short* llr, int nsymbols)
+int srsran_demod_soft_demodulate_s_impl(srsran_demod_soft_impl_t impl,
+                                        srsran_mod_t             modulation,
+                                        const cf_t*              symbols,
+                                        short*                   llr,
+                                        int                      nsymbols)
 {
+  if (!srsran_demod_soft_impl_available(impl)) {
+    ERROR("Soft demodulator implementation %d is not available", impl);
+    return SRSRAN_ERROR;
+  }
+  if (impl == SRSRAN_DEMOD_SOFT_IMPL_AUTO) {
+    impl = demod_soft_impl_best();
+  }
+
   switch (modulation) {
     case SRSRAN_MOD_BPSK:
       demod_bpsk_lte_s(symbols, llr, nsymbols);
@@ -878,13 +1445,13 @@ int srsran_demod_soft_demodulate_s(srsran_mod_t modulation, const cf_t* symbols,
       demod_qpsk_lte_s(symbols, llr, nsymbols);
       break;
     case SRSRAN_MOD_16QAM:
-      demod_16qam_lte_s(symbols, llr, nsymbols);
+      demod_16qam_lte_s(impl, symbols, llr, nsymbols);
       break;
     case SRSRAN_MOD_64QAM:
-      demod_64qam_lte_s(symbols, llr, nsymbols);
+      demod_64qam_lte_s(impl, symbols, llr, nsymbols);
       break;
     case SRSRAN_MOD_256QAM:
-      demod_256qam_lte_s(symbols, llr, nsymbols);
+      demod_256qam_lte_s(impl, symbols, llr, nsymbols);
       break;
     default:
       ERROR("Invalid modulation %d", modulation);
@@ -893,8 +1460,20 @@ int srsran_demod_soft_demodulate_s(srsran_mod_t modulation, const cf_t* symbols,
   return 0;
 }
 
-int srsran_demod_soft_demodulate_b(srsran_mod_t modulation, const cf_t* symbols, int8_t* llr, int nsymbols)
+int srsran_demod_soft_demodulate_b_impl(srsran_demod_soft_impl_t impl,
+                                        srsran_mod_t             modulation,
+                                        const cf_t*              symbols,
+                                        int8_t*                  llr,
+                                        int                      nsymbols)
 {
+  if (!srsran_demod_soft_impl_available(impl)) {
+    ERROR("Soft demodulator implementation %d is not available", impl);
+    return SRSRAN_ERROR;
+  }
+  if (impl == SRSRAN_DEMOD_SOFT_IMPL_AUTO) {
+    impl = demod_soft_impl_best();
+  }
+
   switch (modulation) {
     case SRSRAN_MOD_BPSK:
       demod_bpsk_lte_b(symbols, llr, nsymbols);
@@ -903,13 +1482,13 @@ int srsran_demod_soft_demodulate_b(srsran_mod_t modulation, const cf_t* symbols,
       demod_qpsk_lte_b(symbols, llr, nsymbols);
       break;
     case SRSRAN_MOD_16QAM:
-      demod_16qam_lte_b(symbols, llr, nsymbols);
+      demod_16qam_lte_b(impl, symbols, llr, nsymbols);
       break;
     case SRSRAN_MOD_64QAM:
-      demod_64qam_lte_b(symbols, llr, nsymbols);
+      demod_64qam_lte_b(impl, symbols, llr, nsymbols);
       break;
     case SRSRAN_MOD_256QAM:
-      demod_256qam_lte_b(symbols, llr, nsymbols);
+      demod_256qam_lte_b(impl, symbols, llr, nsymbols);
       break;
     default:
       ERROR("Invalid modulation %d", modulation);
@@ -917,3 +1496,13 @@ int srsran_demod_soft_demodulate_b(srsran_mod_t modulation, const cf_t* symbols,
   }
   return 0;
 }
+
+int srsran_demod_soft_demodulate_s(srsran_mod_t modulation, const cf_t* symbols, short* llr, int nsymbols)
+{
+  return srsran_demod_soft_demodulate_s_impl(SRSRAN_DEMOD_SOFT_IMPL_AUTO, modulation, symbols, llr, nsymbols);
+}
+
+int srsran_demod_soft_demodulate_b(srsran_mod_t modulation, const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+  return srsran_demod_soft_demodulate_b_impl(SRSRAN_DEMOD_SOFT_IMPL_AUTO, modulation, symbols, llr, nsymbols);
+}
@@ -0,0 +1,222 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srsran/srsran.h"
+
+// Number of symbol counts below this value tested to cover the remainder of every SIMD loop
+#define MAX_TAIL_LEN 80
+
+static uint32_t     nof_symbols = 14400;
+static uint32_t     nof_reps    = 1000;
+static srsran_mod_t modulation  = SRSRAN_MOD_NITEMS;
+
+static const char* impl_names[SRSRAN_DEMOD_SOFT_IMPL_NOF] = {"auto", "generic", "sse/neon", "avx2", "avx512"};
+
+void usage(char* prog)
+{
+  printf("Usage: %s -m modulation (4: QAM16, 6: QAM64, 8: QAM256) [nr]\n", prog);
+  printf("\t-n nof_symbols [Default %d]\n", nof_symbols);
+  printf("\t-r nof_reps, demodulations timed per implementation [Default %d]\n", nof_reps);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "mnr")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_symbols = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'r':
+        nof_reps = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        switch (strtol(argv[optind], NULL, 10)) {
+          case 4:
+            modulation = SRSRAN_MOD_16QAM;
+            break;
+          case 6:
+            modulation = SRSRAN_MOD_64QAM;
+            break;
+          case 8:
+            modulation = SRSRAN_MOD_256QAM;
+            break;
+          default:
+            ERROR("Invalid modulation %d. Possible values: (4: QAM16, 6: QAM64, 8: QAM256)",
+                  (int)strtol(argv[optind], NULL, 10));
+            break;
+        }
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+  if (modulation == SRSRAN_MOD_NITEMS || nof_symbols < MAX_TAIL_LEN) {
+    usage(argv[0]);
+    exit(-1);
+  }
+}
+
+static int demod(srsran_demod_soft_impl_t impl, const cf_t* symbols, int16_t* llr_s, int8_t* llr_b, uint32_t len)
+{
+  if (srsran_demod_soft_demodulate_s_impl(impl, modulation, symbols, llr_s, len)) {
+    return SRSRAN_ERROR;
+  }
+  return srsran_demod_soft_demodulate_b_impl(impl, modulation, symbols, llr_b, len);
+}
+
+/// The SIMD implementations of 16QAM and 64QAM round the symbols and truncate the thresholds before subtracting them,
+/// where the generic one truncates the result. The LLR may differ by one for each step
+static int compare(const int16_t* ref_s,
+                   const int8_t*  ref_b,
+                   const int16_t* llr_s,
+                   const int8_t*  llr_b,
+                   uint32_t       nof_llr,
+                   int            tolerance)
+{
+  for (uint32_t i = 0; i < nof_llr; i++) {
+    if (abs(ref_s[i] - llr_s[i]) > tolerance || abs(ref_b[i] - llr_b[i]) > tolerance) {
+      ERROR("LLR %d mismatch: %d/%d expected %d/%d", i, llr_s[i], llr_b[i], ref_s[i], ref_b[i]);
+      return SRSRAN_ERROR;
+    }
+  }
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  int                  ret = SRSRAN_ERROR;
+  srsran_modem_table_t mod;
+  srsran_random_t      random_gen = srsran_random_init(0x1234);
+
+  parse_args(argc, argv);
+
+  if (srsran_modem_table_lte(&mod, modulation)) {
+    ERROR("Error initializing modem table");
+    exit(-1);
+  }
+
+  uint32_t nof_bits = nof_symbols * mod.nbits_x_symbol;
+  uint8_t* bits     = srsran_vec_u8_malloc(nof_bits);
+  cf_t*    symbols  = srsran_vec_cf_malloc(nof_symbols);
+  int16_t* ref_s    = srsran_vec_i16_malloc(nof_bits);
+  int8_t*  ref_b    = srsran_vec_i8_malloc(nof_bits);
+  int16_t* sse_s    = srsran_vec_i16_malloc(nof_bits);
+  int8_t*  sse_b    = srsran_vec_i8_malloc(nof_bits);
+  int16_t* llr_s    = srsran_vec_i16_malloc(nof_bits);
+  int8_t*  llr_b    = srsran_vec_i8_malloc(nof_bits);
+  if (!bits || !symbols || !ref_s || !ref_b || !sse_s || !sse_b || !llr_s || !llr_b) {
+    perror("malloc");
+    exit(-1);
+  }
+
+  // Noisy symbols, which keep the LLR in the range of the 8 bit implementations
+  for (uint32_t i = 0; i < nof_bits; i++) {
+    bits[i] = (uint8_t)srsran_random_uniform_int_dist(random_gen, 0, 1);
+  }
+  srsran_mod_modulate(&mod, bits, symbols, nof_bits);
+  for (uint32_t i = 0; i < nof_symbols; i++) {
+    float n_re = srsran_random_uniform_real_dist(random_gen, -0.05f, 0.05f);
+    float n_im = srsran_random_uniform_real_dist(random_gen, -0.05f, 0.05f);
+    symbols[i] += n_re + _Complex_I * n_im;
+  }
+
+  int                      tolerance = (modulation == SRSRAN_MOD_256QAM) ? 0 : 3;
+  srsran_demod_soft_impl_t simd_ref  = srsran_demod_soft_impl_available(SRSRAN_DEMOD_SOFT_IMPL_SSE)
+                                           ? SRSRAN_DEMOD_SOFT_IMPL_SSE
+                                           : SRSRAN_DEMOD_SOFT_IMPL_GENERIC;
+
+  // The SIMD implementations must match the generic one, and each other exactly
+  for (uint32_t n = 0; n <= MAX_TAIL_LEN; n++) {
+    uint32_t len     = (n < MAX_TAIL_LEN) ? n + 1 : nof_symbols;
+    uint32_t nof_llr = len * mod.nbits_x_symbol;
+    if (demod(SRSRAN_DEMOD_SOFT_IMPL_GENERIC, symbols, ref_s, ref_b, len) ||
+        demod(simd_ref, symbols, sse_s, sse_b, len)) {
+      goto clean_exit;
+    }
+    for (srsran_demod_soft_impl_t impl = SRSRAN_DEMOD_SOFT_IMPL_AUTO; impl < SRSRAN_DEMOD_SOFT_IMPL_NOF; impl++) {
+      if (!srsran_demod_soft_impl_available(impl)) {
+        continue;
+      }
+      if (demod(impl, symbols, llr_s, llr_b, len)) {
+        goto clean_exit;
+      }
+      if (compare(ref_s, ref_b, llr_s, llr_b, nof_llr, tolerance) ||
+          (impl != SRSRAN_DEMOD_SOFT_IMPL_GENERIC && compare(sse_s, sse_b, llr_s, llr_b, nof_llr, 0))) {
+        ERROR("Implementation %s failed for %d symbols", impl_names[impl], len);
+        goto clean_exit;
+      }
+    }
+  }
+
+  for (srsran_demod_soft_impl_t impl = SRSRAN_DEMOD_SOFT_IMPL_GENERIC; impl < SRSRAN_DEMOD_SOFT_IMPL_NOF; impl++) {
+    if (!srsran_demod_soft_impl_available(impl)) {
+      printf("%-8s not available\n", impl_names[impl]);
+      continue;
+    }
+
+    struct timeval t[3];
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < nof_reps; r++) {
+      srsran_demod_soft_demodulate_s_impl(impl, modulation, symbols, llr_s, nof_symbols);
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    double us_s = (t[0].tv_sec * 1e6 + t[0].tv_usec) / nof_reps;
+
+    gettimeofday(&t[1], NULL);
+    for (uint32_t r = 0; r < nof_reps; r++) {
+      srsran_demod_soft_demodulate_b_impl(impl, modulation, symbols, llr_b, nof_symbols);
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    double us_b = (t[0].tv_sec * 1e6 + t[0].tv_usec) / nof_reps;
+
+    printf("%-8s int16: %8.2f us %8.1f Msymbol/s; int8: %8.2f us %8.1f Msymbol/s\n",
+           impl_names[impl],
+           us_s,
+           nof_symbols / us_s,
+           us_b,
+           nof_symbols / us_b);
+  }
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  free(bits);
+  free(symbols);
+  free(ref_s);
+  free(ref_b);
+  free(sse_s);
+  free(sse_b);
+  free(llr_s);
+  free(llr_b);
+  srsran_random_free(random_gen);
+  srsran_modem_table_free(&mod);
+
+  printf("%s\n", ret ? "Failed" : "Ok");
+  exit(ret);
+}
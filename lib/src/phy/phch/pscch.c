@@ -200,8 +200,9 @@ int srsran_pscch_encode(srsran_pscch_t* q, uint8_t* sci, cf_t* sf_buffer, uint32
 {
   memcpy(q->c, sci, sizeof(uint8_t) * q->sci_len);
 
-  // CRC Attachment
+  // CRC Attachment, kept since it seeds the PSSCH scrambling and DMRS (N_X_ID)
   srsran_crc_attach(&q->crc, q->c, q->sci_len);
+  memcpy(q->sci_crc, &q->c[q->sci_len], sizeof(uint8_t) * SRSRAN_SCI_CRC_LEN);
 
   // Channel Coding
   srsran_convcoder_encode(&q->encoder, q->c, q->d, q->sci_len + SRSRAN_SCI_CRC_LEN);
@@ -246,13 +247,8 @@ int srsran_pscch_encode(srsran_pscch_t* q, uint8_t* sci, cf_t* sf_buffer, uint32
   return SRSRAN_SUCCESS;
 }
 
-int srsran_pscch_decode(srsran_pscch_t* q, cf_t* equalized_sf_syms, uint8_t* sci, uint32_t prb_start_idx)
+static int pscch_decode_scfdma(srsran_pscch_t* q, uint8_t* sci)
 {
-  if (srsran_pscch_get(q, equalized_sf_syms, prb_start_idx) != q->nof_tx_re) {
-    printf("Error during PSCCH RE extraction\n");
-    return SRSRAN_ERROR;
-  }
-
   // Precoding
   // Void: Single antenna port
   // 3GPP TS 36.211 version 15.6.0 Release 15 Sec. 9.4.5
@@ -297,6 +293,26 @@ int srsran_pscch_decode(srsran_pscch_t* q, cf_t* equalized_sf_syms, uint8_t* sci
   return SRSRAN_SUCCESS;
 }
 
+int srsran_pscch_decode(srsran_pscch_t* q, cf_t* equalized_sf_syms, uint8_t* sci, uint32_t prb_start_idx)
+{
+  if (srsran_pscch_get(q, equalized_sf_syms, prb_start_idx) != q->nof_tx_re) {
+    printf("Error during PSCCH RE extraction\n");
+    return SRSRAN_ERROR;
+  }
+
+  return pscch_decode_scfdma(q, sci);
+}
+
+int srsran_pscch_decode_compact(srsran_pscch_t* q, cf_t* equalized_syms, uint8_t* sci)
+{
+  memcpy(q->scfdma_symbols, equalized_syms, sizeof(cf_t) * q->nof_tx_re);
+
+  // Force zeros in last symbol
+  srsran_vec_cf_zero(&q->scfdma_symbols[q->nof_tx_re], SRSRAN_NRE * q->pscch_nof_prb);
+
+  return pscch_decode_scfdma(q, sci);
+}
+
 int srsran_pscch_put(srsran_pscch_t* q, cf_t* sf_buffer, uint32_t prb_start_idx)
 {
   int sample_pos = 0;
@@ -21,6 +21,7 @@
 
 #include <string.h>
 
+#include "srsran/phy/common/sl_seq_cache.h"
 #include "srsran/phy/fec/turbo/rm_turbo.h"
 #include "srsran/phy/modem/demod_soft.h"
 #include "srsran/phy/phch/pssch.h"
@@ -40,6 +41,8 @@ int srsran_pssch_init(srsran_pssch_t*                       q,
 
   q->cell                  = *cell;
   q->sl_comm_resource_pool = *sl_comm_resource_pool;
+  q->meas_time_en          = false;
+  q->max_nof_iterations    = SRSRAN_PSSCH_DEFAULT_MAX_TDEC_ITERS;
 
   if (cell->tm == SRSRAN_SIDELINK_TM1 || cell->tm == SRSRAN_SIDELINK_TM2) {
     if (cell->cp == SRSRAN_CP_NORM) {
@@ -88,7 +91,7 @@ int srsran_pssch_init(srsran_pssch_t*                       q,
     ERROR("Error allocating memory");
     return SRSRAN_ERROR;
   }
-  q->c_r_bytes = srsran_vec_u8_malloc(SRSRAN_TCOD_MAX_LEN_CB / 8);
+  q->c_r_bytes = srsran_vec_u8_malloc(SRSRAN_PSSCH_MAX_NOF_CB * SRSRAN_TCOD_MAX_LEN_CB / 8);
   if (!q->c_r_bytes) {
     ERROR("Error allocating memory");
     return SRSRAN_ERROR;
@@ -114,7 +117,7 @@ int srsran_pssch_init(srsran_pssch_t*                       q,
   }
   srsran_tdec_init(&q->tdec, SRSRAN_TCOD_MAX_LEN_CB);
   srsran_tdec_force_not_sb(&q->tdec);
-  q->d_r_16 = srsran_vec_i16_malloc(SRSRAN_PSSCH_MAX_CODED_BITS);
+  q->d_r_16 = srsran_vec_i16_malloc(SRSRAN_PSSCH_MAX_NOF_CB * SRSRAN_PSSCH_MAX_CODED_BITS);
   if (!q->d_r_16) {
     ERROR("Error allocating memory");
     return SRSRAN_ERROR;
@@ -204,14 +207,7 @@ int srsran_pssch_init(srsran_pssch_t*                       q,
     return SRSRAN_ERROR;
   }
 
-  // Transform Precoding
-  q->scfdma_symbols = srsran_vec_cf_malloc(q->nof_data_symbols * SRSRAN_NRE * SRSRAN_MAX_PRB);
-  if (!q->scfdma_symbols) {
-    ERROR("Error allocating memory");
-    return SRSRAN_ERROR;
-  }
-  srsran_vec_cf_zero(q->scfdma_symbols, q->nof_data_symbols * SRSRAN_NRE * SRSRAN_MAX_PRB);
-
+  // Transform Precoding, in place on the modulation symbols
   if (srsran_dft_precoding_init(&q->dft_precoder, SRSRAN_MAX_PRB, true)) {
     ERROR("Error DFT precoder init");
     return SRSRAN_ERROR;
@@ -220,6 +216,11 @@ int srsran_pssch_init(srsran_pssch_t*                       q,
     ERROR("Error in DFT precoder init");
     return SRSRAN_ERROR;
   }
+  if (srsran_dft_precoding_set_batch(&q->dft_precoder, q->nof_data_symbols) ||
+      srsran_dft_precoding_set_batch(&q->idft_precoder, q->nof_data_symbols)) {
+    ERROR("Error in DFT precoder batch init");
+    return SRSRAN_ERROR;
+  }
 
   return SRSRAN_SUCCESS;
 }
@@ -260,6 +261,30 @@ int srsran_pssch_set_cfg(srsran_pssch_t* q, srsran_pssch_cfg_t pssch_cfg)
   return SRSRAN_SUCCESS;
 }
 
+/// Looks the scrambling sequence up in the shared cache, and only generates it in the object if every entry is in use
+static srsran_sequence_t* pssch_scrambling_seq_acquire(srsran_pssch_t* q)
+{
+  srsran_sequence_t* seq = srsran_sl_seq_cache_scrambling_acquire(q->pssch_cfg.N_x_id, q->pssch_cfg.sf_idx, q->G);
+  if (seq != NULL) {
+    return seq;
+  }
+
+  if (srsran_sequence_LTE_pr(
+          &q->scrambling_seq, q->G, q->pssch_cfg.N_x_id * 16384 + (q->pssch_cfg.sf_idx % 10) * 512 + 510) !=
+      SRSRAN_SUCCESS) {
+    ERROR("Error generating scrambling sequence");
+    return NULL;
+  }
+  return &q->scrambling_seq;
+}
+
+static void pssch_scrambling_seq_release(srsran_pssch_t* q, srsran_sequence_t* seq)
+{
+  if (seq != &q->scrambling_seq) {
+    srsran_sl_seq_cache_scrambling_release(seq);
+  }
+}
+
 int srsran_pssch_encode(srsran_pssch_t* q, uint8_t* input, uint32_t input_len, cf_t* sf_buffer)
 {
   if (!input || input_len > q->sl_sch_tb_len) {
@@ -348,9 +373,12 @@ int srsran_pssch_encode(srsran_pssch_t* q, uint8_t* input, uint32_t input_len, c
   srsran_bit_unpack_vector(q->codeword_bytes, q->codeword, q->G);
 
   // Scrambling follows 3GPP TS 36.211 version 15.6.0 Release 15 Sec. 9.3.1
-  srsran_sequence_LTE_pr(
-      &q->scrambling_seq, q->G, q->pssch_cfg.N_x_id * 16384 + (q->pssch_cfg.sf_idx % 10) * 512 + 510);
-  srsran_scrambling_b(&q->scrambling_seq, q->codeword);
+  srsran_sequence_t* scrambling_seq = pssch_scrambling_seq_acquire(q);
+  if (scrambling_seq == NULL) {
+    return SRSRAN_ERROR;
+  }
+  srsran_scrambling_b_offset(scrambling_seq, q->codeword, 0, q->G);
+  pssch_scrambling_seq_release(q, scrambling_seq);
 
   // Modulation
   srsran_mod_modulate(&q->mod[q->mod_idx], q->codeword, q->symbols, q->G);
@@ -360,14 +388,14 @@ int srsran_pssch_encode(srsran_pssch_t* q, uint8_t* input, uint32_t input_len, c
   // 3GPP TS 36.211 version 15.6.0 Release 15 Sec. 9.3.3
 
   // Transform Precoding
-  srsran_dft_precoding(&q->dft_precoder, q->symbols, q->scfdma_symbols, q->pssch_cfg.nof_prb, q->nof_data_symbols);
+  srsran_dft_precoding(&q->dft_precoder, q->symbols, q->symbols, q->pssch_cfg.nof_prb, q->nof_data_symbols);
 
   // Precoding
   // Voided: Single antenna port
   // 3GPP TS 36.211 version 15.6.0 Release 15 Sec. 9.3.5
 
   // RE mapping
-  if (q->nof_tx_re != srsran_pssch_put(q, sf_buffer, q->scfdma_symbols)) {
+  if (q->nof_tx_re != srsran_pssch_put(q, sf_buffer, q->symbols)) {
     ERROR("There was an error mapping the PSSCH symbols");
     return SRSRAN_ERROR;
   }
@@ -375,26 +403,14 @@ int srsran_pssch_encode(srsran_pssch_t* q, uint8_t* input, uint32_t input_len, c
   return SRSRAN_SUCCESS;
 }
 
-int srsran_pssch_decode(srsran_pssch_t* q, cf_t* equalized_sf_syms, uint8_t* output, uint32_t output_len)
+static int pssch_decode_sl_sch(srsran_pssch_t* q, uint8_t* output)
 {
-  if (output_len < q->sl_sch_tb_len) {
-    ERROR("Can't decode PSSCH, provided buffer too small (%d < %d)", output_len, q->sl_sch_tb_len);
-    return SRSRAN_ERROR;
-  }
-
-  // RE extraction
-  if (q->nof_tx_re != srsran_pssch_get(q, equalized_sf_syms, q->scfdma_symbols)) {
-    ERROR("There was an error getting the PSSCH symbols");
-    return SRSRAN_ERROR;
-  }
-
   // Precoding
   // Voided: Single antenna port
   // 3GPP TS 36.211 version 15.6.0 Release 15 Sec. 9.3.5
 
   // Transform Predecoding
-  if (srsran_dft_precoding(
-          &q->idft_precoder, q->scfdma_symbols, q->symbols, q->pssch_cfg.nof_prb, q->nof_data_symbols) !=
+  if (srsran_dft_precoding(&q->idft_precoder, q->symbols, q->symbols, q->pssch_cfg.nof_prb, q->nof_data_symbols) !=
       SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
   }
@@ -406,10 +422,16 @@ int srsran_pssch_decode(srsran_pssch_t* q, cf_t* equalized_sf_syms, uint8_t* out
   // Demodulation
   srsran_demod_soft_demodulate_s(q->Qm / 2, q->symbols, q->llr, q->G / q->Qm);
 
+  // The last symbol is not transmitted, its bits are erasures rather than the demodulation of zeros
+  srsran_vec_i16_zero(&q->llr[q->nof_tx_re * q->Qm], (q->nof_data_re - q->nof_tx_re) * q->Qm);
+
   // Descramble follows 3GPP TS 36.211 version 15.6.0 Release 15 Sec. 9.3.1
-  srsran_sequence_LTE_pr(
-      &q->scrambling_seq, q->G, q->pssch_cfg.N_x_id * 16384 + (q->pssch_cfg.sf_idx % 10) * 512 + 510);
-  srsran_scrambling_s(&q->scrambling_seq, q->llr);
+  srsran_sequence_t* scrambling_seq = pssch_scrambling_seq_acquire(q);
+  if (scrambling_seq == NULL) {
+    return SRSRAN_ERROR;
+  }
+  srsran_scrambling_s_offset(scrambling_seq, q->llr, 0, q->G);
+  pssch_scrambling_seq_release(q, scrambling_seq);
 
   srsran_cbsegm(&q->cb_segm, q->sl_sch_tb_len);
   uint32_t L = SRSRAN_PSSCH_CRC_LEN;
@@ -424,9 +446,21 @@ int srsran_pssch_decode(srsran_pssch_t* q, cf_t* equalized_sf_syms, uint8_t* out
   uint32_t Gp    = q->E / q->Qm;
   uint32_t gamma = Gp % q->cb_segm.C;
 
+  srsran_softbuffer_rx_t* softbuffer = q->pssch_cfg.softbuffer;
+  if (softbuffer && q->cb_segm.C > softbuffer->max_cb) {
+    ERROR("Soft buffer too small for %d code blocks (max %d)", q->cb_segm.C, softbuffer->max_cb);
+    return SRSRAN_ERROR;
+  }
+
+  uint32_t nof_iter_sum = 0;
+  q->avg_iterations     = 0;
+
   // Deinterleaving
   srsran_sl_ulsch_deinterleave(q->llr, q->Qm, q->G / q->Qm, q->nof_data_symbols, q->f_16, q->interleaver_lut);
 
+  // Rate matching of all CBs. With a soft buffer the soft bits are added to those of the previous transmissions of
+  // the TB
+  uint32_t nof_jobs = 0;
   for (int r = 0; r < q->cb_segm.C; r++) {
     // Code block segmentation
     if (r < q->cb_segm.C2) {
@@ -444,15 +478,76 @@ int srsran_pssch_decode(srsran_pssch_t* q, cf_t* equalized_sf_syms, uint8_t* out
     memcpy(q->e_r_16, &q->f_16[s], sizeof(int16_t) * E_r);
     s += E_r;
 
-    // Rate matching
     uint32_t cb_len_idx = r < q->cb_segm.C1 ? q->cb_segm.K1_idx : q->cb_segm.K2_idx;
-    srsran_vec_i16_zero(q->d_r_16, SRSRAN_PSSCH_MAX_CODED_BITS);
-    srsran_rm_turbo_rx_lut_(q->e_r_16, q->d_r_16, E_r, cb_len_idx, srsran_pssch_rv[q->pssch_cfg.rv_idx], false);
+    int16_t* d_r_16     = softbuffer ? softbuffer->buffer_f[r] : &q->d_r_16[r * SRSRAN_PSSCH_MAX_CODED_BITS];
+    if (softbuffer == NULL) {
+      srsran_vec_i16_zero(d_r_16, SRSRAN_PSSCH_MAX_CODED_BITS);
+    }
+    srsran_rm_turbo_rx_lut_(q->e_r_16, d_r_16, E_r, cb_len_idx, srsran_pssch_rv[q->pssch_cfg.rv_idx], false);
+
+    // Already decoded in a previous transmission
+    if (softbuffer && softbuffer->cb_crc[r]) {
+      continue;
+    }
+
+    // Use the CB CRC, or the TB CRC if there is a single CB, for early stopping. Filler bits are zeros and do not
+    // change the CRC
+    srsran_tdec_pool_job_t* job = &q->cb_jobs[nof_jobs++];
+    job->input                  = d_r_16;
+    job->output                 = &q->c_r_bytes[r * SRSRAN_TCOD_MAX_LEN_CB / 8];
+    job->long_cb                = K_r;
+    job->crc_poly               = (q->cb_segm.C > 1) ? SRSRAN_LTE_CRC24B : SRSRAN_LTE_CRC24A;
+    job->crc_order              = SRSRAN_PSSCH_CRC_LEN;
+    job->crc_len                = K_r;
+  }
+
+  // Channel decoding. Once a CB failed the TB can not be decoded, the pending CBs are skipped
+  struct timeval t[3];
+  if (q->meas_time_en) {
+    gettimeofday(&t[1], NULL);
+  }
+  srsran_tdec_pool_cfg_t tdec_cfg = {.llr_is_8bit    = false,
+                                     .min_iterations = SRSRAN_MIN(SRSRAN_PSSCH_MIN_TDEC_ITERS, q->max_nof_iterations),
+                                     .max_iterations = q->max_nof_iterations,
+                                     .stop_on_error  = true};
+  srsran_crc_t* crc[2] = {&q->tb_crc, &q->cb_crc};
+  if (srsran_tdec_pool_run(q->cb_pool, &q->tdec, crc, 2, q->cb_jobs, nof_jobs, &tdec_cfg)) {
+    ERROR("Error decoding PSSCH code blocks");
+    return SRSRAN_ERROR;
+  }
+  if (q->meas_time_en) {
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    q->meas_time_tdec_us += (uint32_t)(t[0].tv_sec * 1000000 + t[0].tv_usec);
+  }
+
+  // CB CRC check and concatenation, in order up to the first CB that failed
+  uint32_t job_idx = 0;
+  for (int r = 0; r < q->cb_segm.C; r++) {
+    K_r              = (r < q->cb_segm.C2) ? q->cb_segm.K2 : q->cb_segm.K1;
+    uint8_t* c_bytes = &q->c_r_bytes[r * SRSRAN_TCOD_MAX_LEN_CB / 8];
 
-    // Channel decoding
-    srsran_tdec_new_cb(&q->tdec, K_r);
-    srsran_tdec_run_all(&q->tdec, q->d_r_16, q->c_r_bytes, 3, K_r);
-    srsran_bit_unpack_vector(q->c_r_bytes, q->c_r, K_r);
+    if (softbuffer && softbuffer->cb_crc[r]) {
+      memcpy(c_bytes, softbuffer->data[r], K_r / 8);
+    } else {
+      srsran_tdec_pool_job_t* job = &q->cb_jobs[job_idx++];
+      nof_iter_sum += job->nof_iterations;
+      q->avg_iterations = (float)nof_iter_sum / (float)job_idx;
+
+      INFO("PSSCH CB %d: K_r=%d, CRC=%s, iterations=%d/%d",
+           r,
+           K_r,
+           job->crc_ok ? "OK" : "KO",
+           job->nof_iterations,
+           q->max_nof_iterations);
+
+      // Keep the decoded CB, a retransmission does not need to decode it again
+      if (softbuffer && job->crc_ok) {
+        softbuffer->cb_crc[r] = true;
+        memcpy(softbuffer->data[r], c_bytes, K_r / 8);
+      }
+    }
+    srsran_bit_unpack_vector(c_bytes, q->c_r, K_r);
 
     if (q->cb_segm.C > 1) {
       // Copy received crc to temp
@@ -488,12 +583,115 @@ int srsran_pssch_decode(srsran_pssch_t* q, cf_t* equalized_sf_syms, uint8_t* out
     return SRSRAN_ERROR;
   }
 
+  if (softbuffer) {
+    softbuffer->tb_crc = true;
+  }
+
   // Remove CRC and copy to output buffer
   memcpy(output, q->b, sizeof(uint8_t) * q->sl_sch_tb_len);
 
   return SRSRAN_SUCCESS;
 }
 
+static int pssch_decode_scfdma(srsran_pssch_t* q, uint8_t* output)
+{
+  struct timeval t[3];
+  if (q->meas_time_en) {
+    q->meas_time_tdec_us = 0;
+    gettimeofday(&t[1], NULL);
+  }
+
+  int ret = pssch_decode_sl_sch(q, output);
+
+  if (q->meas_time_en) {
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    uint32_t total_us     = (uint32_t)(t[0].tv_sec * 1000000 + t[0].tv_usec);
+    q->meas_time_demod_us = total_us - SRSRAN_MIN(total_us, q->meas_time_tdec_us);
+  }
+
+  return ret;
+}
+
+int srsran_pssch_decode(srsran_pssch_t* q, cf_t* equalized_sf_syms, uint8_t* output, uint32_t output_len)
+{
+  if (output_len < q->sl_sch_tb_len) {
+    ERROR("Can't decode PSSCH, provided buffer too small (%d < %d)", output_len, q->sl_sch_tb_len);
+    return SRSRAN_ERROR;
+  }
+
+  // RE extraction
+  if (q->nof_tx_re != srsran_pssch_get(q, equalized_sf_syms, q->symbols)) {
+    ERROR("There was an error getting the PSSCH symbols");
+    return SRSRAN_ERROR;
+  }
+  srsran_vec_cf_zero(&q->symbols[q->nof_tx_re], q->nof_data_re - q->nof_tx_re);
+
+  return pssch_decode_scfdma(q, output);
+}
+
+int srsran_pssch_decode_compact(srsran_pssch_t* q, cf_t* symbols, uint8_t* output, uint32_t output_len)
+{
+  if (output_len < q->sl_sch_tb_len) {
+    ERROR("Can't decode PSSCH, provided buffer too small (%d < %d)", output_len, q->sl_sch_tb_len);
+    return SRSRAN_ERROR;
+  }
+
+  // REs are already extracted by srsran_chest_sl_ls_equalize_compact()
+  memcpy(q->symbols, symbols, sizeof(cf_t) * q->nof_tx_re);
+  srsran_vec_cf_zero(&q->symbols[q->nof_tx_re], q->nof_data_re - q->nof_tx_re);
+
+  return pssch_decode_scfdma(q, output);
+}
+
+void srsran_pssch_set_max_noi(srsran_pssch_t* q, uint32_t max_iterations)
+{
+  if (max_iterations == 0) {
+    max_iterations = SRSRAN_PSSCH_DEFAULT_MAX_TDEC_ITERS;
+  }
+
+  q->max_nof_iterations = max_iterations;
+}
+
+float srsran_pssch_last_noi(srsran_pssch_t* q)
+{
+  return q->avg_iterations;
+}
+
+int srsran_pssch_set_cb_workers(srsran_pssch_t* q, uint32_t nof_workers)
+{
+  if (q == NULL || nof_workers > SRSRAN_TDEC_POOL_MAX_WORKERS) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  if (q->cb_pool) {
+    if (q->cb_pool->nof_workers == nof_workers) {
+      return SRSRAN_SUCCESS;
+    }
+    srsran_tdec_pool_free(q->cb_pool);
+    free(q->cb_pool);
+    q->cb_pool = NULL;
+  }
+
+  if (nof_workers == 0) {
+    return SRSRAN_SUCCESS;
+  }
+
+  q->cb_pool = calloc(1, sizeof(srsran_tdec_pool_t));
+  if (q->cb_pool == NULL) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_tdec_pool_init(q->cb_pool, nof_workers, SRSRAN_TCOD_MAX_LEN_CB)) {
+    ERROR("Error initiating turbo decoder pool");
+    free(q->cb_pool);
+    q->cb_pool = NULL;
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 int srsran_pssch_put(srsran_pssch_t* q, cf_t* sf_buffer, cf_t* symbols)
 {
   uint32_t sample_pos = 0;
@@ -590,6 +788,7 @@ void srsran_pssch_free(srsran_pssch_t* q)
     srsran_dft_precoding_free(&q->dft_precoder);
     srsran_dft_precoding_free(&q->idft_precoder);
     srsran_tcod_free(&q->tcod);
+    srsran_pssch_set_cb_workers(q, 0);
     srsran_tdec_free(&q->tdec);
     srsran_sequence_free(&q->scrambling_seq);
     srsran_rm_turbo_free_tables();
@@ -652,9 +851,6 @@ void srsran_pssch_free(srsran_pssch_t* q)
     if (q->symbols) {
       free(q->symbols);
     }
-    if (q->scfdma_symbols) {
-      free(q->scfdma_symbols);
-    }
     if (q->bits_after_demod) {
       free(q->bits_after_demod);
     }
@@ -227,6 +227,12 @@ int srsran_pusch_set_cell(srsran_pusch_t* q, srsran_cell_t cell)
       srsran_evm_buffer_resize(q->evm_buffer, srsran_ra_tbs_from_idx(SRSRAN_RA_NOF_TBS_IDX - 1, cell.nof_prb));
     }
 
+    // Transform all the symbols of a subframe at once, shortened subframes run a transform per symbol
+    if (srsran_dft_precoding_set_batch(&q->dft_precoding, 2 * (SRSRAN_CP_NSYMB(cell.cp) - 1))) {
+      ERROR("Error initiating batched DFT transform precoding");
+      return SRSRAN_ERROR;
+    }
+
     q->cell   = cell;
     q->max_re = cell.nof_prb * MAX_PUSCH_RE(cell.cp);
     ret       = SRSRAN_SUCCESS;
@@ -214,12 +214,52 @@ void srsran_sch_free(srsran_sch_t* q)
   if (q->ul_interleaver) {
     free(q->ul_interleaver);
   }
+  srsran_sch_set_cb_workers(q, 0);
   srsran_tdec_free(&q->decoder);
   srsran_tcod_free(&q->encoder);
   srsran_uci_cqi_free(&q->uci_cqi);
   bzero(q, sizeof(srsran_sch_t));
 }
 
+int srsran_sch_set_cb_workers(srsran_sch_t* q, uint32_t nof_workers)
+{
+  if (q == NULL || nof_workers > SRSRAN_TDEC_POOL_MAX_WORKERS) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  if (q->cb_pool) {
+    if (q->cb_pool->nof_workers == nof_workers) {
+      return SRSRAN_SUCCESS;
+    }
+    srsran_tdec_pool_free(q->cb_pool);
+    free(q->cb_pool);
+    q->cb_pool = NULL;
+  }
+  if (q->cb_out) {
+    free(q->cb_out);
+    q->cb_out = NULL;
+  }
+
+  if (nof_workers == 0) {
+    return SRSRAN_SUCCESS;
+  }
+
+  q->cb_out  = srsran_vec_u8_malloc(SRSRAN_MAX_CODEBLOCKS * SRSRAN_TCOD_MAX_LEN_CB / 8);
+  q->cb_pool = calloc(1, sizeof(srsran_tdec_pool_t));
+  if (q->cb_out == NULL || q->cb_pool == NULL) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_tdec_pool_init(q->cb_pool, nof_workers, SRSRAN_TCOD_MAX_LEN_CB)) {
+    ERROR("Error initiating turbo decoder pool");
+    free(q->cb_pool);
+    q->cb_pool = NULL;
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 void srsran_sch_set_max_noi(srsran_sch_t* q, uint32_t max_iterations)
 {
   if (max_iterations == 0) {
@@ -387,6 +427,9 @@ bool decode_tb_cb(srsran_sch_t*           q,
 
   q->avg_iterations = 0;
 
+  // Without a pool the code blocks are decoded in order straight into data. Otherwise each code block gets its own
+  // output slot, as the decoder writes the 24 CRC bits past the end of the code block data
+  uint32_t nof_jobs = 0;
   for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
     /* Do not process blocks with CRC Ok */
     if (softbuffer->cb_crc[cb_idx] == false) {
@@ -418,57 +461,54 @@ bool decode_tb_cb(srsran_sch_t*           q,
         }
       }
 
-      srsran_tdec_new_cb(&q->decoder, cb_len);
-
-      // Run iterations and use CRC for early stopping
-      bool     early_stop = false;
-      uint32_t cb_noi     = 0;
-      do {
-        if (q->llr_is_8bit) {
-          srsran_tdec_iteration_8bit(&q->decoder, (int8_t*)softbuffer->buffer_f[cb_idx], &data[cb_idx * rlen / 8]);
-        } else {
-          srsran_tdec_iteration(&q->decoder, softbuffer->buffer_f[cb_idx], &data[cb_idx * rlen / 8]);
-        }
-        q->avg_iterations++;
-        cb_noi++;
-
-        uint32_t      len_crc;
-        srsran_crc_t* crc_ptr;
-
-        if (cb_segm->C > 1) {
-          len_crc = cb_len;
-          crc_ptr = &q->crc_cb;
-        } else {
-          len_crc = cb_segm->tbs + 24;
-          crc_ptr = &q->crc_tb;
-        }
+      srsran_tdec_pool_job_t* job = &q->cb_jobs[nof_jobs++];
+      job->input                  = softbuffer->buffer_f[cb_idx];
+      job->output  = q->cb_pool ? &q->cb_out[cb_idx * SRSRAN_TCOD_MAX_LEN_CB / 8] : &data[cb_idx * rlen / 8];
+      job->long_cb = cb_len;
+      if (cb_segm->C > 1) {
+        job->crc_len   = cb_len;
+        job->crc_poly  = SRSRAN_LTE_CRC24B;
+        job->crc_order = 24;
+      } else {
+        job->crc_len   = cb_segm->tbs + 24;
+        job->crc_poly  = SRSRAN_LTE_CRC24A;
+        job->crc_order = 24;
+      }
+    }
+  }
 
-        // CRC is OK and ran the minimum number of iterations
-        if (!srsran_crc_checksum_byte(crc_ptr, &data[cb_idx * rlen / 8], len_crc) &&
-            (cb_noi >= SRSRAN_PDSCH_MIN_TDEC_ITERS)) {
-          softbuffer->cb_crc[cb_idx] = true;
-          early_stop                 = true;
+  srsran_tdec_pool_cfg_t tdec_cfg = {.llr_is_8bit    = q->llr_is_8bit,
+                                     .min_iterations = SRSRAN_PDSCH_MIN_TDEC_ITERS,
+                                     .max_iterations = q->max_iterations,
+                                     .stop_on_error  = false};
+  srsran_crc_t* crc[2] = {&q->crc_tb, &q->crc_cb};
+  if (srsran_tdec_pool_run(q->cb_pool, &q->decoder, crc, 2, q->cb_jobs, nof_jobs, &tdec_cfg)) {
+    ERROR("Error decoding code blocks");
+    return false;
+  }
 
-          // CRC is error and exceeded maximum iterations for this CB.
-          // Early stop the whole transport block.
-        }
+  uint32_t job_idx = 0;
+  for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
+    uint32_t cb_len = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
+    uint32_t rlen   = cb_segm->C == 1 ? cb_len : (cb_len - 24);
 
-      } while (cb_noi < q->max_iterations && !early_stop);
+    if (softbuffer->cb_crc[cb_idx] == false) {
+      srsran_tdec_pool_job_t* job = &q->cb_jobs[job_idx++];
+      if (q->cb_pool) {
+        memcpy(&data[cb_idx * rlen / 8], job->output, rlen / 8 * sizeof(uint8_t));
+      }
+      softbuffer->cb_crc[cb_idx] = job->crc_ok;
+      q->avg_iterations += job->nof_iterations;
 
-      INFO("CB %d: rp=%d, n_e=%d, cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d",
+      INFO("CB %d: cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d",
            cb_idx,
-           rp,
-           n_e2,
            cb_len,
-           early_stop ? "OK" : "KO",
+           job->crc_ok ? "OK" : "KO",
            rlen,
-           cb_noi,
+           job->nof_iterations,
            q->max_iterations);
-
     } else {
       // Copy decoded data from previous transmissions
-      uint32_t cb_len = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
-      uint32_t rlen   = cb_segm->C == 1 ? cb_len : (cb_len - 24);
       memcpy(&data[cb_idx * rlen / 8], softbuffer->data[cb_idx], rlen / 8 * sizeof(uint8_t));
     }
   }
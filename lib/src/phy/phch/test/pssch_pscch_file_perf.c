@@ -0,0 +1,536 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Replays a TM3/TM4 sidelink capture through PSSS/SSSS search, FFT, PSCCH search and PSSCH decoding as fast as
+ * possible. The capture is loaded into memory first, so file I/O is not measured. Reports the sustained subframe rate,
+ * the time spent in every stage and the per-subframe processing latency percentiles.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "srsran/phy/ch_estimation/chest_sl.h"
+#include "srsran/phy/common/phy_common_sl.h"
+#include "srsran/phy/dft/ofdm.h"
+#include "srsran/phy/io/filesource.h"
+#include "srsran/phy/phch/pscch.h"
+#include "srsran/phy/phch/pssch.h"
+#include "srsran/phy/phch/ra_sl.h"
+#include "srsran/phy/phch/sci.h"
+#include "srsran/phy/sync/psss.h"
+#include "srsran/phy/sync/ssss.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+
+static char*            input_file_name        = NULL;
+static srsran_cell_sl_t cell = {.nof_prb = 50, .N_sl_id = 0, .tm = SRSRAN_SIDELINK_TM4, .cp = SRSRAN_CP_NORM};
+static bool             use_standard_lte_rates = false;
+static uint32_t         file_offset            = 0;
+static uint32_t         size_sub_channel       = 10;
+static uint32_t         num_sub_channel        = 5;
+static uint32_t         first_sf_idx           = 0;
+static uint32_t         nof_repetitions        = 100;
+static uint32_t         max_nof_sf             = 1000;
+static bool             skip_sync              = false;
+static bool             try_all_cyclic_shifts  = false;
+static uint32_t         max_nof_iterations     = SRSRAN_PSSCH_DEFAULT_MAX_TDEC_ITERS;
+
+typedef enum {
+  STAGE_SYNC = 0,
+  STAGE_FFT,
+  STAGE_PSCCH_CHEST,
+  STAGE_PSCCH_DECODE,
+  STAGE_PSSCH_CHEST,
+  STAGE_PSSCH_DEMOD,
+  STAGE_PSSCH_TDEC,
+  STAGE_NOF_STAGES
+} stage_t;
+
+static const char* stage_names[STAGE_NOF_STAGES] =
+    {"PSSS/SSSS sync", "FFT", "PSCCH chest", "PSCCH decode", "PSSCH chest", "PSSCH demod", "PSSCH turbo decode"};
+
+static uint64_t stage_ns[STAGE_NOF_STAGES] = {};
+
+static uint32_t                       sf_n_samples          = 0;
+static uint32_t                       sf_n_re               = 0;
+static cf_t*                          capture               = NULL;
+static uint32_t                       capture_nof_sf        = 0;
+static cf_t*                          input_buffer          = NULL;
+static cf_t*                          sf_buffer             = NULL;
+static cf_t*                          equalized_syms        = NULL;
+static srsran_psss_t                  psss                  = {};
+static srsran_ssss_t                  ssss                  = {};
+static srsran_ofdm_t                  fft                   = {};
+static srsran_sci_t                   sci                   = {};
+static srsran_pscch_t                 pscch                 = {};
+static srsran_chest_sl_t              pscch_chest           = {};
+static srsran_pssch_t                 pssch                 = {};
+static srsran_chest_sl_t              pssch_chest           = {};
+static srsran_sl_comm_resource_pool_t sl_comm_resource_pool = {};
+
+void usage(char* prog)
+{
+  printf("Usage: %s [adiIlmnoprsStv]\n", prog);
+  printf("\t-i input_file_name\n");
+  printf("\t-o File offset samples [Default %d]\n", file_offset);
+  printf("\t-p nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-s size_sub_channel [Default for 50 prbs %d]\n", size_sub_channel);
+  printf("\t-n num_sub_channel [Default for 50 prbs %d]\n", num_sub_channel);
+  printf("\t-m Subframe index of the first subframe [Default %d]\n", first_sf_idx);
+  printf("\t-t Sidelink transmission mode {3,4} [Default %d]\n", (cell.tm + 1));
+  printf("\t-d use_standard_lte_rates [Default %i]\n", use_standard_lte_rates);
+  printf("\t-r Number of times the capture is replayed [Default %d]\n", nof_repetitions);
+  printf("\t-l Maximum number of subframes loaded from the capture [Default %d]\n", max_nof_sf);
+  printf("\t-S Skip the PSSS/SSSS search [Default %i]\n", skip_sync);
+  printf("\t-a Try all PSCCH cyclic shifts instead of detecting it from the DMRS [Default %i]\n",
+         try_all_cyclic_shifts);
+  printf("\t-I Maximum PSSCH turbo decoder iterations [Default %d]\n", max_nof_iterations);
+  printf("\t-v [set srsran_verbose to debug, default none]\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "adiIlmnoprsStv")) != -1) {
+    switch (opt) {
+      case 'a':
+        try_all_cyclic_shifts = true;
+        break;
+      case 'd':
+        use_standard_lte_rates = true;
+        break;
+      case 'i':
+        input_file_name = argv[optind];
+        break;
+      case 'I':
+        max_nof_iterations = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'l':
+        max_nof_sf = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        first_sf_idx = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        num_sub_channel = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'o':
+        file_offset = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'p':
+        cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'r':
+        nof_repetitions = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        size_sub_channel = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'S':
+        skip_sync = true;
+        break;
+      case 't':
+        if (srsran_sl_tm_to_cell_sl_tm_t(&cell, strtol(argv[optind], NULL, 10)) != SRSRAN_SUCCESS) {
+          usage(argv[0]);
+          exit(-1);
+        }
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+  if (cell.tm != SRSRAN_SIDELINK_TM3 && cell.tm != SRSRAN_SIDELINK_TM4) {
+    ERROR("Only TM3 and TM4 are supported");
+    usage(argv[0]);
+    exit(-1);
+  }
+  if (input_file_name == NULL || nof_repetitions == 0) {
+    usage(argv[0]);
+    exit(-1);
+  }
+}
+
+static inline uint64_t time_ns()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+/// Adds the time since *t to the stage and restarts *t
+static inline void stage_add(stage_t stage, uint64_t* t)
+{
+  uint64_t now = time_ns();
+  stage_ns[stage] += now - *t;
+  *t = now;
+}
+
+static int load_capture()
+{
+  srsran_filesource_t fsrc = {};
+  if (srsran_filesource_init(&fsrc, input_file_name, SRSRAN_COMPLEX_FLOAT_BIN)) {
+    ERROR("Error opening file %s", input_file_name);
+    return SRSRAN_ERROR;
+  }
+  if (file_offset > 0) {
+    srsran_filesource_seek(&fsrc, file_offset * sizeof(cf_t));
+  }
+
+  capture = srsran_vec_cf_malloc(max_nof_sf * sf_n_samples);
+  if (!capture) {
+    ERROR("Error allocating memory");
+    srsran_filesource_free(&fsrc);
+    return SRSRAN_ERROR;
+  }
+
+  // Only whole subframes are kept
+  while (capture_nof_sf < max_nof_sf &&
+         srsran_filesource_read(&fsrc, &capture[capture_nof_sf * sf_n_samples], sf_n_samples) == sf_n_samples) {
+    capture_nof_sf++;
+  }
+  srsran_filesource_free(&fsrc);
+
+  if (capture_nof_sf == 0) {
+    ERROR("Capture %s is shorter than a subframe", input_file_name);
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int base_init()
+{
+  sf_n_samples = srsran_symbol_sz(cell.nof_prb) * 15;
+  sf_n_re      = SRSRAN_SF_LEN_RE(cell.nof_prb, cell.cp);
+
+  if (srsran_sl_comm_resource_pool_get_default_config(&sl_comm_resource_pool, cell) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing sl_comm_resource_pool");
+    return SRSRAN_ERROR;
+  }
+  sl_comm_resource_pool.num_sub_channel  = num_sub_channel;
+  sl_comm_resource_pool.size_sub_channel = size_sub_channel;
+
+  if (load_capture() != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  input_buffer   = srsran_vec_cf_malloc(sf_n_samples);
+  sf_buffer      = srsran_vec_cf_malloc(sf_n_re);
+  equalized_syms = srsran_vec_cf_malloc(sf_n_re);
+  if (!input_buffer || !sf_buffer || !equalized_syms) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_psss_init(&psss, cell.nof_prb, cell.cp) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing PSSS");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_ssss_init(&ssss, cell.nof_prb, cell.cp, cell.tm) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing SSSS");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_sci_init(&sci, &cell, &sl_comm_resource_pool) < SRSRAN_SUCCESS) {
+    ERROR("Error in SCI init");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_pscch_init(&pscch, SRSRAN_MAX_PRB) != SRSRAN_SUCCESS) {
+    ERROR("Error in PSCCH init");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_pscch_set_cell(&pscch, cell) != SRSRAN_SUCCESS) {
+    ERROR("Error in PSCCH set cell");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_chest_sl_init(&pscch_chest, SRSRAN_SIDELINK_PSCCH, cell, &sl_comm_resource_pool) != SRSRAN_SUCCESS) {
+    ERROR("Error in PSCCH DMRS init");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_pssch_init(&pssch, &cell, &sl_comm_resource_pool) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing PSSCH");
+    return SRSRAN_ERROR;
+  }
+  pssch.meas_time_en = true;
+  srsran_pssch_set_max_noi(&pssch, max_nof_iterations);
+
+  if (srsran_chest_sl_init(&pssch_chest, SRSRAN_SIDELINK_PSSCH, cell, &sl_comm_resource_pool) != SRSRAN_SUCCESS) {
+    ERROR("Error in chest PSSCH init");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_ofdm_rx_init(&fft, cell.cp, input_buffer, sf_buffer, cell.nof_prb)) {
+    ERROR("Error creating FFT object");
+    return SRSRAN_ERROR;
+  }
+  srsran_ofdm_set_normalize(&fft, true);
+  srsran_ofdm_set_freq_shift(&fft, -0.5);
+
+  return SRSRAN_SUCCESS;
+}
+
+void base_free()
+{
+  srsran_ofdm_rx_free(&fft);
+  srsran_psss_free(&psss);
+  srsran_ssss_free(&ssss);
+
+  srsran_sci_free(&sci);
+  srsran_pscch_free(&pscch);
+  srsran_chest_sl_free(&pscch_chest);
+
+  srsran_pssch_free(&pssch);
+  srsran_chest_sl_free(&pssch_chest);
+
+  if (capture) {
+    free(capture);
+  }
+  if (input_buffer) {
+    free(input_buffer);
+  }
+  if (sf_buffer) {
+    free(sf_buffer);
+  }
+  if (equalized_syms) {
+    free(equalized_syms);
+  }
+}
+
+typedef struct {
+  uint32_t nof_slss;
+  uint32_t nof_sci;
+  uint32_t nof_tb;
+  uint64_t nof_tb_bits;
+  uint32_t nof_pssch;
+  double   sum_iterations;
+} counters_t;
+
+/// Decodes the PSSCH scheduled by the SCI just decoded in sub_channel_idx
+static void decode_pssch(uint32_t sub_channel_idx, uint32_t sf_idx, counters_t* cnt, uint64_t* t)
+{
+  static uint8_t tb[SRSRAN_SL_SCH_MAX_TB_LEN];
+
+  // 3GPP TS 36.213 Section 14.1.1.4C
+  uint32_t sub_channel_start_idx = 0;
+  uint32_t L_subCH               = 0;
+  srsran_ra_sl_type0_from_riv(sci.riv, sl_comm_resource_pool.num_sub_channel, &L_subCH, &sub_channel_start_idx);
+
+  uint32_t pssch_prb_start_idx = (sub_channel_idx * sl_comm_resource_pool.size_sub_channel) + pscch.pscch_nof_prb +
+                                 sl_comm_resource_pool.start_prb_sub_channel;
+  uint32_t nof_prb_pssch = ((L_subCH + sub_channel_idx) * sl_comm_resource_pool.size_sub_channel) -
+                           pssch_prb_start_idx + sl_comm_resource_pool.start_prb_sub_channel;
+  nof_prb_pssch = srsran_dft_precoding_get_valid_prb(nof_prb_pssch);
+
+  uint32_t N_x_id = 0;
+  for (int j = 0; j < SRSRAN_SCI_CRC_LEN; j++) {
+    N_x_id += pscch.sci_crc[j] * (1 << (SRSRAN_SCI_CRC_LEN - 1 - j));
+  }
+  uint32_t rv_idx = sci.retransmission ? 1 : 0;
+
+  srsran_chest_sl_cfg_t pssch_chest_sl_cfg = {};
+  pssch_chest_sl_cfg.N_x_id                = N_x_id;
+  pssch_chest_sl_cfg.sf_idx                = sf_idx;
+  pssch_chest_sl_cfg.prb_start_idx         = pssch_prb_start_idx;
+  pssch_chest_sl_cfg.nof_prb               = nof_prb_pssch;
+  srsran_chest_sl_set_cfg(&pssch_chest, pssch_chest_sl_cfg);
+  srsran_chest_sl_ls_estimate_equalize_compact(&pssch_chest, sf_buffer, equalized_syms);
+  stage_add(STAGE_PSSCH_CHEST, t);
+
+  srsran_pssch_cfg_t pssch_cfg = {pssch_prb_start_idx, nof_prb_pssch, N_x_id, sci.mcs_idx, rv_idx, sf_idx, NULL};
+  if (srsran_pssch_set_cfg(&pssch, pssch_cfg) != SRSRAN_SUCCESS) {
+    stage_add(STAGE_PSSCH_DEMOD, t);
+    return;
+  }
+  int ret = srsran_pssch_decode_compact(&pssch, equalized_syms, tb, SRSRAN_SL_SCH_MAX_TB_LEN);
+
+  // Split the decoding time between demodulation and turbo decoding as measured by the PSSCH itself
+  uint64_t now     = time_ns();
+  uint64_t tdec_ns = SRSRAN_MIN((uint64_t)pssch.meas_time_tdec_us * 1000, now - *t);
+  stage_ns[STAGE_PSSCH_TDEC] += tdec_ns;
+  stage_ns[STAGE_PSSCH_DEMOD] += now - *t - tdec_ns;
+  *t = now;
+
+  cnt->nof_pssch++;
+  cnt->sum_iterations += srsran_pssch_last_noi(&pssch);
+
+  if (ret == SRSRAN_SUCCESS) {
+    cnt->nof_tb++;
+    cnt->nof_tb_bits += pssch.sl_sch_tb_len;
+  }
+}
+
+static void process_sf(const cf_t* samples, uint32_t sf_idx, counters_t* cnt)
+{
+  uint8_t  sci_rx[SRSRAN_SCI_MAX_LEN] = {};
+  uint64_t t                          = time_ns();
+
+  srsran_vec_cf_copy(input_buffer, samples, sf_n_samples);
+
+  if (!skip_sync) {
+    if (srsran_psss_find(&psss, input_buffer, cell.nof_prb, cell.cp) == SRSRAN_SUCCESS) {
+      if (srsran_ssss_find(&ssss, input_buffer, cell.nof_prb, psss.N_id_2, cell.cp) == SRSRAN_SUCCESS) {
+        cnt->nof_slss++;
+      }
+    }
+    stage_add(STAGE_SYNC, &t);
+  }
+
+  srsran_ofdm_rx_sf(&fft);
+  stage_add(STAGE_FFT, &t);
+
+  for (uint32_t sub_channel_idx = 0; sub_channel_idx < sl_comm_resource_pool.num_sub_channel; sub_channel_idx++) {
+    uint32_t pscch_prb_start_idx = sl_comm_resource_pool.size_sub_channel * sub_channel_idx;
+
+    uint32_t cyclic_shift_first = 0;
+    uint32_t cyclic_shift_last  = 9;
+    if (!try_all_cyclic_shifts) {
+      int cs = srsran_chest_sl_pscch_detect_cyclic_shift(
+          &pscch_chest, sf_buffer, pscch_prb_start_idx, SRSRAN_SL_PSCCH_CS_DETECT_DEFAULT_THRESHOLD);
+      if (cs < 0) {
+        stage_add(STAGE_PSCCH_CHEST, &t);
+        continue;
+      }
+      cyclic_shift_first = (uint32_t)cs;
+      cyclic_shift_last  = (uint32_t)cs;
+    }
+
+    for (uint32_t cyclic_shift = cyclic_shift_first; cyclic_shift <= cyclic_shift_last; cyclic_shift += 3) {
+      srsran_chest_sl_cfg_t pscch_chest_sl_cfg = {};
+      pscch_chest_sl_cfg.cyclic_shift          = cyclic_shift;
+      pscch_chest_sl_cfg.prb_start_idx         = pscch_prb_start_idx;
+      srsran_chest_sl_set_cfg(&pscch_chest, pscch_chest_sl_cfg);
+      srsran_chest_sl_ls_estimate_equalize_compact(&pscch_chest, sf_buffer, equalized_syms);
+      stage_add(STAGE_PSCCH_CHEST, &t);
+
+      bool decoded = srsran_pscch_decode_compact(&pscch, equalized_syms, sci_rx) == SRSRAN_SUCCESS &&
+                     srsran_sci_format1_unpack(&sci, sci_rx) == SRSRAN_SUCCESS;
+      stage_add(STAGE_PSCCH_DECODE, &t);
+
+      if (decoded) {
+        cnt->nof_sci++;
+        decode_pssch(sub_channel_idx, sf_idx, cnt, &t);
+        break;
+      }
+    }
+  }
+}
+
+static int cmp_u64(const void* a, const void* b)
+{
+  uint64_t x = *(const uint64_t*)a;
+  uint64_t y = *(const uint64_t*)b;
+  return (x > y) - (x < y);
+}
+
+int main(int argc, char** argv)
+{
+  int       ret         = SRSRAN_ERROR;
+  uint64_t* latency_ns  = NULL;
+  uint32_t  nof_sf      = 0;
+  uint64_t  total_ns    = 0;
+  uint64_t  t_start     = 0;
+  uint64_t  stage_total = 0;
+
+  parse_args(argc, argv);
+  srsran_use_standard_symbol_size(use_standard_lte_rates);
+
+  if (base_init()) {
+    ERROR("Error initializing");
+    goto clean_exit;
+  }
+
+  nof_sf     = capture_nof_sf * nof_repetitions;
+  latency_ns = calloc(nof_sf, sizeof(uint64_t));
+  if (!latency_ns) {
+    ERROR("Error allocating memory");
+    goto clean_exit;
+  }
+
+  // The first replay checks what is decoded, it also warms up caches and sequence tables
+  counters_t first = {};
+  for (uint32_t i = 0; i < capture_nof_sf; i++) {
+    process_sf(&capture[i * sf_n_samples], (first_sf_idx + i) % SRSRAN_NOF_SF_X_FRAME, &first);
+  }
+  bzero(stage_ns, sizeof(stage_ns));
+
+  counters_t total = {};
+  t_start          = time_ns();
+  for (uint32_t n = 0; n < nof_sf; n++) {
+    uint32_t i   = n % capture_nof_sf;
+    uint64_t t_0 = time_ns();
+    process_sf(&capture[i * sf_n_samples], (first_sf_idx + i) % SRSRAN_NOF_SF_X_FRAME, &total);
+    latency_ns[n] = time_ns() - t_0;
+  }
+  total_ns = time_ns() - t_start;
+
+  qsort(latency_ns, nof_sf, sizeof(uint64_t), cmp_u64);
+
+  printf("Replayed %d subframes (%d x %d) of %s\n", nof_sf, nof_repetitions, capture_nof_sf, input_file_name);
+  printf("Throughput: %.1f subframes/s, %.2f Mbps decoded\n",
+         (double)nof_sf * 1e9 / (double)total_ns,
+         (double)total.nof_tb_bits * 1e3 / (double)total_ns);
+  printf("Latency per subframe: p50=%.1f p99=%.1f max=%.1f us\n",
+         latency_ns[nof_sf / 2] / 1e3,
+         latency_ns[SRSRAN_MIN(nof_sf - 1, (uint32_t)(nof_sf * 0.99))] / 1e3,
+         latency_ns[nof_sf - 1] / 1e3);
+
+  for (uint32_t s = 0; s < STAGE_NOF_STAGES; s++) {
+    stage_total += stage_ns[s];
+  }
+  printf("PSSCH turbo decoder: %.2f iterations/CB (max %d)\n",
+         total.nof_pssch ? total.sum_iterations / total.nof_pssch : 0.0,
+         pssch.max_nof_iterations);
+  printf("%-20s %12s %10s %7s\n", "Stage", "Total ms", "us/sf", "%");
+  for (uint32_t s = 0; s < STAGE_NOF_STAGES; s++) {
+    printf("%-20s %12.2f %10.2f %6.1f%%\n",
+           stage_names[s],
+           stage_ns[s] / 1e6,
+           stage_ns[s] / 1e3 / nof_sf,
+           stage_total ? 100.0 * stage_ns[s] / stage_total : 0.0);
+  }
+
+  printf("num_slss=%d num_decoded_sci=%d num_decoded_tb=%d\n", first.nof_slss, first.nof_sci, first.nof_tb);
+
+  ret = (first.nof_sci > 0) ? SRSRAN_SUCCESS : SRSRAN_ERROR;
+
+clean_exit:
+  base_free();
+  if (latency_ns) {
+    free(latency_ns);
+  }
+
+  return ret;
+}
@@ -40,6 +40,8 @@ static char*            input_file_name = NULL;
 static srsran_cell_sl_t cell            = {.nof_prb = 6, .N_sl_id = 0, .tm = SRSRAN_SIDELINK_TM2, .cp = SRSRAN_CP_NORM};
 static bool             use_standard_lte_rates = false;
 static uint32_t         file_offset            = 0;
+static bool             use_compact_equalizer  = false;
+static bool             use_cs_detection       = false;
 
 static uint32_t                       sf_n_samples          = 0;
 static uint32_t                       sf_n_re               = 0;
@@ -64,7 +66,7 @@ static srsran_filesource_t fsrc = {};
 
 void usage(char* prog)
 {
-  printf("Usage: %s [deinopstv]\n", prog);
+  printf("Usage: %s [cdeinopstv]\n", prog);
   printf("\t-i input_file_name\n");
   printf("\t-o File offset samples [Default %d]\n", file_offset);
   printf("\t-p nof_prb [Default %d]\n", cell.nof_prb);
@@ -74,14 +76,22 @@ void usage(char* prog)
   printf("\t-e Extended CP [Default normal]\n");
   printf("\t-t Sidelink transmission mode {1,2,3,4} [Default %d]\n", (cell.tm + 1));
   printf("\t-d use_standard_lte_rates [Default %i]\n", use_standard_lte_rates);
+  printf("\t-c equalize only the allocated PRBs into a compact buffer [Default %i]\n", use_compact_equalizer);
+  printf("\t-f detect the PSCCH cyclic shift from the DMRS instead of trying all [Default %i]\n", use_cs_detection);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "deinmopstv")) != -1) {
+  while ((opt = getopt(argc, argv, "cdefinmopstv")) != -1) {
     switch (opt) {
+      case 'c':
+        use_compact_equalizer = true;
+        break;
+      case 'f':
+        use_cs_detection = true;
+        break;
       case 'd':
         use_standard_lte_rates = true;
         break;
@@ -233,6 +243,26 @@ void base_free()
   }
 }
 
+static int pscch_equalize_decode(uint8_t* sci_rx, uint32_t pscch_prb_start_idx)
+{
+  if (use_compact_equalizer) {
+    srsran_chest_sl_ls_estimate_equalize_compact(&pscch_chest, sf_buffer, equalized_sf_buffer);
+    return srsran_pscch_decode_compact(&pscch, equalized_sf_buffer, sci_rx);
+  }
+  srsran_chest_sl_ls_estimate_equalize(&pscch_chest, sf_buffer, equalized_sf_buffer);
+  return srsran_pscch_decode(&pscch, equalized_sf_buffer, sci_rx, pscch_prb_start_idx);
+}
+
+static int pssch_equalize_decode(uint8_t* tb)
+{
+  if (use_compact_equalizer) {
+    srsran_chest_sl_ls_estimate_equalize_compact(&pssch_chest, sf_buffer, equalized_sf_buffer);
+    return srsran_pssch_decode_compact(&pssch, equalized_sf_buffer, tb, SRSRAN_SL_SCH_MAX_TB_LEN);
+  }
+  srsran_chest_sl_ls_estimate_equalize(&pssch_chest, sf_buffer, equalized_sf_buffer);
+  return srsran_pssch_decode(&pssch, equalized_sf_buffer, tb, SRSRAN_SL_SCH_MAX_TB_LEN);
+}
+
 int main(int argc, char** argv)
 {
   uint8_t sci_rx[SRSRAN_SCI_MAX_LEN] = {};
@@ -291,9 +321,8 @@ int main(int argc, char** argv)
           // PSCCH Channel estimation
           pscch_chest_sl_cfg.prb_start_idx = pscch_prb_start_idx;
           srsran_chest_sl_set_cfg(&pscch_chest, pscch_chest_sl_cfg);
-          srsran_chest_sl_ls_estimate_equalize(&pscch_chest, sf_buffer, equalized_sf_buffer);
 
-          if (srsran_pscch_decode(&pscch, equalized_sf_buffer, sci_rx, pscch_prb_start_idx) == SRSRAN_SUCCESS) {
+          if (pscch_equalize_decode(sci_rx, pscch_prb_start_idx) == SRSRAN_SUCCESS) {
             if (srsran_sci_format0_unpack(&sci, sci_rx) == SRSRAN_SUCCESS) {
               srsran_sci_info(&sci, sci_msg, sizeof(sci_msg));
               fprintf(stdout, "%s\n", sci_msg);
@@ -328,12 +357,11 @@ int main(int argc, char** argv)
           pssch_chest_sl_cfg.prb_start_idx = pssch_prb_start_idx;
           pssch_chest_sl_cfg.nof_prb       = nof_prb_pssch;
           srsran_chest_sl_set_cfg(&pssch_chest, pssch_chest_sl_cfg);
-          srsran_chest_sl_ls_estimate_equalize(&pssch_chest, sf_buffer, equalized_sf_buffer);
 
           srsran_pssch_cfg_t pssch_cfg = {
-              pssch_prb_start_idx, nof_prb_pssch, sci.N_sa_id, sci.mcs_idx, rv_idx, current_sf_idx};
+              pssch_prb_start_idx, nof_prb_pssch, sci.N_sa_id, sci.mcs_idx, rv_idx, current_sf_idx, NULL};
           if (srsran_pssch_set_cfg(&pssch, pssch_cfg) == SRSRAN_SUCCESS) {
-            if (srsran_pssch_decode(&pssch, equalized_sf_buffer, tb, SRSRAN_SL_SCH_MAX_TB_LEN) == SRSRAN_SUCCESS) {
+            if (pssch_equalize_decode(tb) == SRSRAN_SUCCESS) {
               srsran_vec_fprint_byte(stdout, tb, pssch.sl_sch_tb_len);
               num_decoded_tb++;
               printf("> Transport Block SUCCESS! TB count: %i\n", num_decoded_tb);
@@ -347,14 +375,25 @@ int main(int argc, char** argv)
       for (int sub_channel_idx = 0; sub_channel_idx < sl_comm_resource_pool.num_sub_channel; sub_channel_idx++) {
         uint32_t pscch_prb_start_idx = sl_comm_resource_pool.size_sub_channel * sub_channel_idx;
 
-        for (uint32_t cyclic_shift = 0; cyclic_shift <= 9; cyclic_shift += 3) {
+        uint32_t cyclic_shift_first = 0;
+        uint32_t cyclic_shift_last  = 9;
+        if (use_cs_detection) {
+          int cs = srsran_chest_sl_pscch_detect_cyclic_shift(
+              &pscch_chest, sf_buffer, pscch_prb_start_idx, SRSRAN_SL_PSCCH_CS_DETECT_DEFAULT_THRESHOLD);
+          if (cs < 0) {
+            continue;
+          }
+          cyclic_shift_first = (uint32_t)cs;
+          cyclic_shift_last  = (uint32_t)cs;
+        }
+
+        for (uint32_t cyclic_shift = cyclic_shift_first; cyclic_shift <= cyclic_shift_last; cyclic_shift += 3) {
           // PSCCH Channel estimation
           pscch_chest_sl_cfg.cyclic_shift  = cyclic_shift;
           pscch_chest_sl_cfg.prb_start_idx = pscch_prb_start_idx;
           srsran_chest_sl_set_cfg(&pscch_chest, pscch_chest_sl_cfg);
-          srsran_chest_sl_ls_estimate_equalize(&pscch_chest, sf_buffer, equalized_sf_buffer);
 
-          if (srsran_pscch_decode(&pscch, equalized_sf_buffer, sci_rx, pscch_prb_start_idx) == SRSRAN_SUCCESS) {
+          if (pscch_equalize_decode(sci_rx, pscch_prb_start_idx) == SRSRAN_SUCCESS) {
             if (srsran_sci_format1_unpack(&sci, sci_rx) == SRSRAN_SUCCESS) {
               srsran_sci_info(&sci, sci_msg, sizeof(sci_msg));
               fprintf(stdout, "%s\n", sci_msg);
@@ -392,12 +431,11 @@ int main(int argc, char** argv)
               pssch_chest_sl_cfg.prb_start_idx = pssch_prb_start_idx;
               pssch_chest_sl_cfg.nof_prb       = nof_prb_pssch;
               srsran_chest_sl_set_cfg(&pssch_chest, pssch_chest_sl_cfg);
-              srsran_chest_sl_ls_estimate_equalize(&pssch_chest, sf_buffer, equalized_sf_buffer);
 
               srsran_pssch_cfg_t pssch_cfg = {
-                  pssch_prb_start_idx, nof_prb_pssch, N_x_id, sci.mcs_idx, rv_idx, current_sf_idx};
+                  pssch_prb_start_idx, nof_prb_pssch, N_x_id, sci.mcs_idx, rv_idx, current_sf_idx, NULL};
               if (srsran_pssch_set_cfg(&pssch, pssch_cfg) == SRSRAN_SUCCESS) {
-                if (srsran_pssch_decode(&pssch, equalized_sf_buffer, tb, SRSRAN_SL_SCH_MAX_TB_LEN) == SRSRAN_SUCCESS) {
+                if (pssch_equalize_decode(tb) == SRSRAN_SUCCESS) {
                   srsran_vec_fprint_byte(stdout, tb, pssch.sl_sch_tb_len);
                   num_decoded_tb++;
                 }
@@ -30,28 +30,35 @@
 
 srsran_cell_sl_t cell = {.nof_prb = 6, .N_sl_id = 0, .tm = SRSRAN_SIDELINK_TM2, .cp = SRSRAN_CP_NORM};
 
-static uint32_t        mcs_idx       = 4;
-static uint32_t        prb_start_idx = 0;
-static srsran_random_t random_gen    = NULL;
+static uint32_t        mcs_idx        = 4;
+static uint32_t        prb_start_idx  = 0;
+static uint32_t        max_nof_iter   = SRSRAN_PSSCH_DEFAULT_MAX_TDEC_ITERS;
+static uint32_t        nof_cb_workers = 0;
+static srsran_random_t random_gen     = NULL;
 
 void usage(char* prog)
 {
-  printf("Usage: %s [emptv]\n", prog);
+  printf("Usage: %s [eimptvw]\n", prog);
   printf("\t-p nof_prb [Default %d]\n", cell.nof_prb);
   printf("\t-m mcs_idx [Default %d]\n", mcs_idx);
   printf("\t-e extended CP [Default normal]\n");
+  printf("\t-i maximum turbo decoder iterations [Default %d]\n", max_nof_iter);
   printf("\t-t Sidelink transmission mode {1,2,3,4} [Default %d]\n", (cell.tm + 1));
   printf("\t-v [set srsran_verbose to debug, default none]\n");
+  printf("\t-w threads decoding the code blocks concurrently [Default %d]\n", nof_cb_workers);
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "emptv")) != -1) {
+  while ((opt = getopt(argc, argv, "eimptvw")) != -1) {
     switch (opt) {
       case 'e':
         cell.cp = SRSRAN_CP_EXT;
         break;
+      case 'i':
+        max_nof_iter = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'm':
         mcs_idx = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
@@ -67,6 +74,9 @@ void parse_args(int argc, char** argv)
       case 'v':
         increase_srsran_verbose_level();
         break;
+      case 'w':
+        nof_cb_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -96,6 +106,12 @@ int main(int argc, char** argv)
     ERROR("Error initializing PSSCH");
     return SRSRAN_ERROR;
   }
+  srsran_pssch_set_max_noi(&pssch, max_nof_iter);
+  if (srsran_pssch_set_cb_workers(&pssch, nof_cb_workers) != SRSRAN_SUCCESS) {
+    ERROR("Error setting PSSCH code block workers");
+    srsran_pssch_free(&pssch);
+    return SRSRAN_ERROR;
+  }
 
   uint32_t nof_prb_pssch = srsran_dft_precoding_get_valid_prb(cell.nof_prb);
   uint32_t N_x_id        = 255;
@@ -113,7 +129,7 @@ int main(int argc, char** argv)
   // Rx transport block buffer
   uint8_t tb_rx[SRSRAN_SL_SCH_MAX_TB_LEN] = {};
 
-  srsran_pssch_cfg_t pssch_cfg = {prb_start_idx, nof_prb_pssch, N_x_id, mcs_idx, 0, 0};
+  srsran_pssch_cfg_t pssch_cfg = {prb_start_idx, nof_prb_pssch, N_x_id, mcs_idx, 0, 0, NULL};
   if (srsran_pssch_set_cfg(&pssch, pssch_cfg) != SRSRAN_SUCCESS) {
     ERROR("Error configuring PSSCH");
     goto clean_exit;
@@ -139,7 +155,13 @@ int main(int argc, char** argv)
     goto clean_exit;
   }
 
-  if (memcmp(tb_rx, tb, pssch.sl_sch_tb_len) == 0) {
+  // Without noise the CRC passes after the minimum number of iterations
+  float avg_iterations = srsran_pssch_last_noi(&pssch);
+  printf("avg_iterations=%.1f\n", avg_iterations);
+  if (avg_iterations > SRSRAN_MIN(SRSRAN_PSSCH_MIN_TDEC_ITERS, pssch.max_nof_iterations)) {
+    ERROR("Early stopping failed, %.1f iterations per CB", avg_iterations);
+    ret = SRSRAN_ERROR;
+  } else if (memcmp(tb_rx, tb, pssch.sl_sch_tb_len) == 0) {
     ret = SRSRAN_SUCCESS;
   } else {
     ret = SRSRAN_ERROR;
@@ -56,6 +56,7 @@ int          freq_hop      = -1;
 int          riv           = -1;
 uint32_t     mcs_idx       = 0;
 bool         enable_64_qam = false;
+uint32_t     cb_workers    = 0;
 
 void usage(char* prog)
 {
@@ -83,6 +84,7 @@ void usage(char* prog)
 
   printf("\n\tOther parameters:\n");
   printf("\t\t-p enable_64qam [Default %s]\n", enable_64_qam ? "enabled" : "disabled");
+  printf("\t\t-p cb_workers threads decoding the code blocks concurrently [Default %d]\n", cb_workers);
   printf("\t\t-s number of subframes [Default %d]\n", subframe);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
@@ -126,6 +128,11 @@ void parse_extensive_param(char* param, char* arg)
     uci_data_tx.cfg.ack[0].nof_acks = SRSRAN_MIN((uint32_t)strtol(arg, NULL, 10), SRSRAN_UCI_MAX_ACK_BITS);
   } else if (!strcmp(param, "enable_64qam")) {
     enable_64_qam ^= true;
+  } else if (!strcmp(param, "cb_workers")) {
+    cb_workers = (uint32_t)strtol(arg, NULL, 10);
+    if (cb_workers > SRSRAN_TDEC_POOL_MAX_WORKERS) {
+      ext_code = SRSRAN_ERROR;
+    }
   } else {
     ext_code = SRSRAN_ERROR;
   }
@@ -243,6 +250,10 @@ int main(int argc, char** argv)
     ERROR("Error creating PUSCH object");
     goto quit;
   }
+  if (srsran_sch_set_cb_workers(&pusch_rx.ul_sch, cb_workers)) {
+    ERROR("Error setting UL-SCH code block workers");
+    goto quit;
+  }
 
   uint16_t rnti = 62;
   dci.rnti      = rnti;
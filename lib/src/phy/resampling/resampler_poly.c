@@ -0,0 +1,292 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <complex.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "srsran/phy/resampling/resampler_poly.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/simd.h"
+#include "srsran/phy/utils/vector.h"
+
+/**
+ * Kaiser window shape parameter, about 70 dB of stop band attenuation
+ */
+#define RESAMPLER_POLY_KAISER_BETA 7.0
+
+/**
+ * The number of taps per phase is a multiple of this value, so that the real and imaginary parts of the taps fill the
+ * widest SIMD registers
+ */
+#define RESAMPLER_POLY_TAPS_ALIGN 16
+
+static inline uint64_t resampler_poly_gcd(uint64_t a, uint64_t b)
+{
+  while (b != 0) {
+    uint64_t t = a % b;
+    a          = b;
+    b          = t;
+  }
+  return a;
+}
+
+/// Zeroth order modified Bessel function of the first kind, for the Kaiser window
+static double resampler_poly_bessel_i0(double x)
+{
+  double sum  = 1.0;
+  double term = 1.0;
+  for (uint32_t k = 1; k < 50 && term > sum * 1e-12; k++) {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+/// Designs the prototype low pass filter at nof_phases times the input rate, a Kaiser windowed sinc cut at half the
+/// lowest rate, and stores it as a bank of phases. The taps of each phase are ordered to multiply the filter window
+/// from the oldest sample, and repeated for the real and imaginary parts
+static void resampler_poly_design(srsran_resampler_poly_t* q, double cutoff)
+{
+  uint32_t len    = q->nof_phases * q->nof_taps;
+  double   center = len / 2.0;
+  double   sum    = 0.0;
+  double*  h      = calloc(len + 1, sizeof(double));
+  if (h == NULL) {
+    return;
+  }
+
+  for (uint32_t i = 0; i <= len; i++) {
+    double t  = (i - center) / q->nof_phases; // Time in input samples
+    double x  = 2.0 * cutoff * t;
+    double r  = (i - center) / center;
+    double w  = resampler_poly_bessel_i0(RESAMPLER_POLY_KAISER_BETA * sqrt(SRSRAN_MAX(0.0, 1.0 - r * r)));
+    h[i]      = 2.0 * cutoff * (x == 0.0 ? 1.0 : sin(M_PI * x) / (M_PI * x)) * w;
+    sum      += (i < len) ? h[i] : 0.0;
+  }
+
+  // Unitary gain at DC for every phase on average
+  double norm = q->nof_phases / sum;
+  for (uint32_t p = 0; p <= q->nof_phases; p++) {
+    float* row = &q->filter[2 * p * q->nof_taps];
+    for (uint32_t k = 0; k < q->nof_taps; k++) {
+      uint32_t i     = p + (q->nof_taps - 1 - k) * q->nof_phases;
+      float    tap   = (i <= len) ? (float)(h[i] * norm) : 0.0f;
+      row[2 * k]     = tap;
+      row[2 * k + 1] = tap;
+    }
+  }
+
+  free(h);
+}
+
+static inline cf_t resampler_poly_dot(const cf_t* x, const float* h, uint32_t nof_taps)
+{
+  const float* x_ptr = (const float*)x;
+  uint32_t     i     = 0;
+  float        re    = 0.0f;
+  float        im    = 0.0f;
+
+#if SRSRAN_SIMD_F_SIZE
+  simd_f_t acc = srsran_simd_f_zero();
+  for (; i + SRSRAN_SIMD_F_SIZE <= 2 * nof_taps; i += SRSRAN_SIMD_F_SIZE) {
+    acc = srsran_simd_f_add(acc, srsran_simd_f_mul(srsran_simd_f_loadu(&x_ptr[i]), srsran_simd_f_load(&h[i])));
+  }
+
+  __attribute__((aligned(64))) float sum[SRSRAN_SIMD_F_SIZE];
+  srsran_simd_f_store(sum, acc);
+  for (uint32_t j = 0; j < SRSRAN_SIMD_F_SIZE; j += 2) {
+    re += sum[j];
+    im += sum[j + 1];
+  }
+#endif /* SRSRAN_SIMD_F_SIZE */
+
+  for (; i < 2 * nof_taps; i += 2) {
+    re += x_ptr[i] * h[i];
+    im += x_ptr[i + 1] * h[i + 1];
+  }
+
+  return re + _Complex_I * im;
+}
+
+int srsran_resampler_poly_init(srsran_resampler_poly_t* q, double input_srate, double output_srate)
+{
+  if (q == NULL || !isnormal(input_srate) || !isnormal(output_srate) || input_srate < 0 || output_srate < 0) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  if (q->input_srate == input_srate && q->output_srate == output_srate && q->filter != NULL) {
+    srsran_resampler_poly_reset_state(q);
+    return SRSRAN_SUCCESS;
+  }
+
+  srsran_resampler_poly_free(q);
+
+  q->input_srate  = input_srate;
+  q->output_srate = output_srate;
+
+  // Rational ratio L/M from the rates in Hz. Large interpolation factors use a fixed bank and interpolate the phases
+  uint64_t in_hz  = (uint64_t)round(input_srate);
+  uint64_t out_hz = (uint64_t)round(output_srate);
+  uint64_t gcd    = resampler_poly_gcd(in_hz, out_hz);
+  uint64_t L      = out_hz / gcd;
+  uint64_t M      = in_hz / gcd;
+  if (L <= SRSRAN_RESAMPLER_POLY_MAX_PHASES && in_hz == input_srate && out_hz == output_srate) {
+    q->interpolate = false;
+    q->nof_phases  = (uint32_t)L;
+    q->step_n      = (uint32_t)(M / L);
+    q->step_phase  = (uint32_t)(M % L);
+    q->step_frac   = 0;
+  } else {
+    double step    = input_srate / output_srate;
+    double phases  = (step - floor(step)) * SRSRAN_RESAMPLER_POLY_NOF_PHASES;
+    q->interpolate = true;
+    q->nof_phases  = SRSRAN_RESAMPLER_POLY_NOF_PHASES;
+    q->step_n      = (uint32_t)floor(step);
+    q->step_phase  = (uint32_t)floor(phases);
+    q->step_frac   = (uint32_t)round((phases - floor(phases)) * 4294967296.0);
+  }
+
+  // Wider filters when decimating keep the transition band at the output rate
+  double ratio = SRSRAN_MIN(1.0, output_srate / input_srate);
+  q->nof_taps  = (uint32_t)ceil(SRSRAN_RESAMPLER_POLY_TAPS / ratio);
+  q->nof_taps  = SRSRAN_CEIL(q->nof_taps, RESAMPLER_POLY_TAPS_ALIGN) * RESAMPLER_POLY_TAPS_ALIGN;
+
+  q->filter = srsran_vec_f_malloc(2 * (q->nof_phases + 1) * q->nof_taps);
+  q->head   = srsran_vec_cf_malloc(2 * q->nof_taps);
+  if (q->filter == NULL || q->head == NULL) {
+    ERROR("Error allocating memory");
+    srsran_resampler_poly_free(q);
+    return SRSRAN_ERROR;
+  }
+  resampler_poly_design(q, 0.5 * ratio);
+
+  srsran_resampler_poly_reset_state(q);
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_resampler_poly_reset_state(srsran_resampler_poly_t* q)
+{
+  if (q == NULL || q->head == NULL) {
+    return;
+  }
+
+  srsran_vec_cf_zero(q->head, 2 * q->nof_taps);
+  q->n     = 0;
+  q->phase = 0;
+  q->frac  = 0;
+}
+
+double srsran_resampler_poly_get_delay(const srsran_resampler_poly_t* q)
+{
+  if (q == NULL) {
+    return 0.0;
+  }
+  return q->nof_taps / 2.0;
+}
+
+uint32_t srsran_resampler_poly_nof_input(const srsran_resampler_poly_t* q, uint32_t nof_output)
+{
+  if (q == NULL || q->nof_phases == 0 || nof_output == 0) {
+    return 0;
+  }
+
+  // Position of the last output sample
+  uint64_t k     = nof_output - 1;
+  uint64_t frac  = q->frac + k * q->step_frac;
+  uint64_t phase = q->phase + k * q->step_phase + (frac >> 32U);
+  int64_t  n     = q->n + (int64_t)(k * q->step_n + phase / q->nof_phases);
+
+  return (uint32_t)SRSRAN_MAX(n + 1, 0);
+}
+
+uint32_t srsran_resampler_poly_run(srsran_resampler_poly_t* q,
+                                   const cf_t*              input,
+                                   uint32_t                 nof_input,
+                                   cf_t*                    output,
+                                   uint32_t                 max_output)
+{
+  if (q == NULL || q->filter == NULL || (input == NULL && nof_input > 0) || (output == NULL && max_output > 0)) {
+    return 0;
+  }
+
+  uint32_t T     = q->nof_taps;
+  uint32_t count = 0;
+
+  // The head joins the last samples of the previous input with the first ones of this input, for the windows across
+  // both. A window ending at input index n starts at head index n + 1
+  uint32_t nof_head = SRSRAN_MIN(nof_input, T - 1);
+  srsran_vec_cf_copy(&q->head[T], input, nof_head);
+
+  while (count < max_output && q->n < (int64_t)nof_input) {
+    const cf_t*  x   = (q->n + 1 < (int64_t)T) ? &q->head[q->n + 1] : &input[q->n + 1 - T];
+    const float* row = &q->filter[2 * q->phase * T];
+
+    if (q->interpolate) {
+      cf_t  y0   = resampler_poly_dot(x, row, T);
+      cf_t  y1   = resampler_poly_dot(x, row + 2 * T, T);
+      float frac = q->frac * (1.0f / 4294967296.0f);
+      output[count] = y0 + (y1 - y0) * frac;
+    } else {
+      output[count] = resampler_poly_dot(x, row, T);
+    }
+    count++;
+
+    // Advance the position of the next output sample
+    uint64_t frac = (uint64_t)q->frac + q->step_frac;
+    q->frac       = (uint32_t)frac;
+    q->phase += q->step_phase + (uint32_t)(frac >> 32U);
+    q->n += q->step_n;
+    if (q->phase >= q->nof_phases) {
+      q->phase -= q->nof_phases;
+      q->n++;
+    }
+  }
+
+  // Keep the last input samples for the next windows
+  if (nof_input >= T) {
+    srsran_vec_cf_copy(q->head, &input[nof_input - T], T);
+  } else {
+    memmove(q->head, &q->head[nof_input], sizeof(cf_t) * T);
+  }
+  // The window of the next output ends at most one sample before the next input, unless the output buffer was short
+  q->n = SRSRAN_MAX(q->n - (int64_t)nof_input, -1);
+
+  return count;
+}
+
+void srsran_resampler_poly_free(srsran_resampler_poly_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  if (q->filter) {
+    free(q->filter);
+  }
+  if (q->head) {
+    free(q->head);
+  }
+
+  memset(q, 0, sizeof(srsran_resampler_poly_t));
+}
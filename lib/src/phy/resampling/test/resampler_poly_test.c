@@ -0,0 +1,210 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/phy/resampling/resampler_poly.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+#include "srsran/support/srsran_test.h"
+#include <complex.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+static double   input_srate  = 23.04e6;
+static double   output_srate = 30.72e6;
+static uint32_t nof_samples  = 23040;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [ion]\n", prog);
+  printf("\t-i Input sampling rate in Hz [Default %.2f MHz]\n", input_srate / 1e6);
+  printf("\t-o Output sampling rate in Hz [Default %.2f MHz]\n", output_srate / 1e6);
+  printf("\t-n Number of input samples [Default %d]\n", nof_samples);
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "ionv")) != -1) {
+    switch (opt) {
+      case 'i':
+        input_srate = strtod(argv[optind], NULL);
+        break;
+      case 'o':
+        output_srate = strtod(argv[optind], NULL);
+        break;
+      case 'n':
+        nof_samples = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+// A tone below both Nyquist frequencies, resampled in one block, matches the tone at the output rate
+static int test_tone(srsran_resampler_poly_t* q, cf_t* in, cf_t* out, uint32_t max_output)
+{
+  double freq_hz = 0.3 * SRSRAN_MIN(input_srate, output_srate);
+  srsran_vec_gen_sine(1.0f, (float)(freq_hz / input_srate), in, (int)nof_samples);
+
+  srsran_resampler_poly_reset_state(q);
+  struct timeval t[3] = {};
+  gettimeofday(&t[1], NULL);
+  uint32_t count = srsran_resampler_poly_run(q, in, nof_samples, out, max_output);
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+
+  // Skip the filter transient
+  double   delay = srsran_resampler_poly_get_delay(q);
+  uint32_t skip  = (uint32_t)ceil(2 * delay * output_srate / input_srate);
+  float    error = 0.0f;
+  for (uint32_t i = skip; i < count; i++) {
+    double time = i / output_srate - delay / input_srate;
+    cf_t   ref  = cexpf(_Complex_I * (float)(2 * M_PI * fmod(freq_hz * time, 1.0)));
+    error       = SRSRAN_MAX(error, cabsf(out[i] - ref));
+  }
+
+  printf("Tone %.2f MHz: %d samples in %ld us, max error %.5f\n",
+         freq_hz / 1e6,
+         count,
+         (long)(t[0].tv_sec * 1000000L + t[0].tv_usec),
+         error);
+
+  TESTASSERT(count > skip);
+  TESTASSERT(abs((int)count - (int)round(nof_samples * output_srate / input_srate)) <= 1);
+  TESTASSERT(error < 0.01f);
+
+  return SRSRAN_SUCCESS;
+}
+
+// Blocks of random sizes give the same output than a single block
+static int test_streaming(srsran_resampler_poly_t* q, srsran_random_t rnd, cf_t* in, cf_t* out, cf_t* ref)
+{
+  uint32_t max_output = (uint32_t)ceil(nof_samples * output_srate / input_srate) + 1;
+
+  srsran_resampler_poly_reset_state(q);
+  uint32_t nof_ref = srsran_resampler_poly_run(q, in, nof_samples, ref, max_output);
+
+  srsran_resampler_poly_reset_state(q);
+  uint32_t nof_in  = 0;
+  uint32_t nof_out = 0;
+  while (nof_in < nof_samples) {
+    uint32_t n = (uint32_t)srsran_random_uniform_int_dist(rnd, 0, 200);
+    n          = SRSRAN_MIN(n, nof_samples - nof_in);
+    nof_out += srsran_resampler_poly_run(q, &in[nof_in], n, &out[nof_out], max_output - nof_out);
+    nof_in += n;
+  }
+
+  TESTASSERT(nof_out == nof_ref);
+  for (uint32_t i = 0; i < nof_out; i++) {
+    TESTASSERT(cabsf(out[i] - ref[i]) < 1e-5f);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+// The number of input samples given by the resampler produces exactly the requested number of output samples, as
+// the radio does when the physical layer asks for a number of samples
+static int test_nof_input(srsran_resampler_poly_t* q, srsran_random_t rnd, cf_t* in, cf_t* out)
+{
+  srsran_resampler_poly_reset_state(q);
+  uint64_t nof_in  = 0;
+  uint64_t nof_out = 0;
+  for (uint32_t i = 0; i < 1000; i++) {
+    uint32_t n = (uint32_t)srsran_random_uniform_int_dist(rnd, 0, 100);
+    uint32_t m = srsran_resampler_poly_nof_input(q, n);
+    TESTASSERT(m <= nof_samples);
+    TESTASSERT(srsran_resampler_poly_run(q, in, m, out, n) == n);
+    nof_in += m;
+    nof_out += n;
+  }
+
+  // The input follows the rate ratio
+  TESTASSERT(fabs(nof_in - nof_out * input_srate / output_srate) < 2.0);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  int                     ret = SRSRAN_ERROR;
+  srsran_resampler_poly_t q   = {};
+  srsran_random_t         rnd = srsran_random_init(0x1234);
+
+  parse_args(argc, argv);
+
+  uint32_t max_output = (uint32_t)ceil(nof_samples * output_srate / input_srate) + 1;
+  cf_t*    in         = srsran_vec_cf_malloc(nof_samples);
+  cf_t*    out        = srsran_vec_cf_malloc(max_output);
+  cf_t*    ref        = srsran_vec_cf_malloc(max_output);
+  if (in == NULL || out == NULL || ref == NULL) {
+    ERROR("Error allocating memory");
+    goto clean_exit;
+  }
+
+  if (srsran_resampler_poly_init(&q, input_srate, output_srate)) {
+    ERROR("Error initiating resampler");
+    goto clean_exit;
+  }
+  printf("Resampling %.3f to %.3f MHz: %d phases%s, %d taps\n",
+         input_srate / 1e6,
+         output_srate / 1e6,
+         q.nof_phases,
+         q.interpolate ? " interpolated" : "",
+         q.nof_taps);
+
+  if (test_tone(&q, in, out, max_output) < SRSRAN_SUCCESS) {
+    goto clean_exit;
+  }
+
+  srsran_random_uniform_complex_dist_vector(rnd, in, nof_samples, -1.0f, 1.0f);
+  if (test_streaming(&q, rnd, in, out, ref) < SRSRAN_SUCCESS) {
+    goto clean_exit;
+  }
+
+  if (test_nof_input(&q, rnd, in, out) < SRSRAN_SUCCESS) {
+    goto clean_exit;
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_resampler_poly_free(&q);
+  srsran_random_free(rnd);
+  if (in) {
+    free(in);
+  }
+  if (out) {
+    free(out);
+  }
+  if (ref) {
+    free(ref);
+  }
+  printf("%s\n", ret == SRSRAN_SUCCESS ? "Ok" : "Failed");
+  return ret;
+}
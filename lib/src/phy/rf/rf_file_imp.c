@@ -71,6 +71,41 @@ typedef struct {
 
 static void update_rates(rf_file_handler_t* handler, double srate);
 
+static int rf_file_open_file_opts(void**         h,
+                                  FILE**         rx_files,
+                                  FILE**         tx_files,
+                                  uint32_t       nof_channels,
+                                  uint32_t       base_srate,
+                                  rf_file_opts_t rx_opts,
+                                  rf_file_opts_t tx_opts);
+
+uint32_t rf_file_sample_size(rf_file_format_t format)
+{
+  switch (format) {
+    case FILERF_TYPE_SC16:
+      return 2 * sizeof(int16_t);
+    case FILERF_TYPE_SC8:
+      return 2 * sizeof(int8_t);
+    case FILERF_TYPE_FC32:
+    default:
+      return sizeof(cf_t);
+  }
+}
+
+int rf_file_parse_format(const char* str, rf_file_format_t* format)
+{
+  if (!strcmp(str, "fc32")) {
+    *format = FILERF_TYPE_FC32;
+  } else if (!strcmp(str, "sc16")) {
+    *format = FILERF_TYPE_SC16;
+  } else if (!strcmp(str, "sc8")) {
+    *format = FILERF_TYPE_SC8;
+  } else {
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
 void rf_file_info(char* id, const char* format, ...)
 {
 #if VERBOSE
@@ -179,12 +214,42 @@ int rf_file_open_multi(char* args, void** h, uint32_t nof_channels)
   FILE* tx_files[SRSRAN_MAX_CHANNELS] = {NULL};
 
   if (h && nof_channels <= SRSRAN_MAX_CHANNELS) {
-    uint32_t base_srate = FILE_BASERATE_DEFAULT_HZ;
+    uint32_t       base_srate = FILE_BASERATE_DEFAULT_HZ;
+    double         rx_offset  = 0.0;
+    rf_file_opts_t rx_opts    = {};
+    rf_file_opts_t tx_opts    = {};
+    rx_opts.sample_format     = FILERF_TYPE_FC32;
+    rx_opts.use_mmap          = true;
+    tx_opts.sample_format     = FILERF_TYPE_FC32;
 
     // parse args
     if (args && strlen(args)) {
       // base_srate
       parse_uint32(args, "base_srate", -1, &base_srate);
+
+      // rx_format, tx_format
+      char tmp[RF_PARAM_LEN] = {};
+      if (parse_string(args, "rx_format", -1, tmp) == SRSRAN_SUCCESS &&
+          rf_file_parse_format(tmp, &rx_opts.sample_format) < SRSRAN_SUCCESS) {
+        fprintf(stderr, "[file] Error: unsupported rx_format %s\n", tmp);
+        goto clean_exit;
+      }
+      if (parse_string(args, "tx_format", -1, tmp) == SRSRAN_SUCCESS &&
+          rf_file_parse_format(tmp, &tx_opts.sample_format) < SRSRAN_SUCCESS) {
+        fprintf(stderr, "[file] Error: unsupported tx_format %s\n", tmp);
+        goto clean_exit;
+      }
+
+      // rx_mmap, rx_loop
+      uint32_t flag = rx_opts.use_mmap;
+      parse_uint32(args, "rx_mmap", -1, &flag);
+      rx_opts.use_mmap = (flag != 0);
+      flag             = rx_opts.loop;
+      parse_uint32(args, "rx_loop", -1, &flag);
+      rx_opts.loop = (flag != 0);
+
+      // rx_offset, in seconds from the beginning of the rx files
+      parse_double(args, "rx_offset", -1, &rx_offset);
     } else {
       fprintf(stderr, "[file] Error: RF device args are required for file-based no-RF module\n");
       goto clean_exit;
@@ -219,7 +284,7 @@ int rf_file_open_multi(char* args, void** h, uint32_t nof_channels)
     }
 
     // defer further initialization to open_file method
-    ret = rf_file_open_file(h, rx_files, tx_files, nof_channels, base_srate);
+    ret = rf_file_open_file_opts(h, rx_files, tx_files, nof_channels, base_srate, rx_opts, tx_opts);
     if (ret != SRSRAN_SUCCESS) {
       goto clean_exit;
     }
@@ -227,6 +292,12 @@ int rf_file_open_multi(char* args, void** h, uint32_t nof_channels)
     // add flag to close all files when closing device
     rf_file_handler_t* handler = (rf_file_handler_t*)(*h);
     handler->close_files       = true;
+
+    if (rx_offset > 0.0) {
+      srsran_timestamp_t ts = {};
+      srsran_timestamp_init(&ts, 0, rx_offset);
+      ret = rf_file_rx_seek_time(handler, ts.full_secs, ts.frac_secs);
+    }
     return ret;
   }
 
@@ -243,6 +314,23 @@ clean_exit:
 }
 
 int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_channels, uint32_t base_srate)
+{
+  rf_file_opts_t rx_opts = {};
+  rf_file_opts_t tx_opts = {};
+  rx_opts.sample_format  = FILERF_TYPE_FC32;
+  rx_opts.use_mmap       = true;
+  tx_opts.sample_format  = FILERF_TYPE_FC32;
+
+  return rf_file_open_file_opts(h, rx_files, tx_files, nof_channels, base_srate, rx_opts, tx_opts);
+}
+
+static int rf_file_open_file_opts(void**         h,
+                                  FILE**         rx_files,
+                                  FILE**         tx_files,
+                                  uint32_t       nof_channels,
+                                  uint32_t       base_srate,
+                                  rf_file_opts_t rx_opts,
+                                  rf_file_opts_t tx_opts)
 {
   int ret = SRSRAN_ERROR;
 
@@ -264,10 +352,8 @@ int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_c
     handler->nof_channels     = nof_channels;
     strcpy(handler->id, "file\0");
 
-    rf_file_opts_t rx_opts = {};
-    rf_file_opts_t tx_opts = {};
-    tx_opts.id             = handler->id;
-    rx_opts.id             = handler->id;
+    tx_opts.id = handler->id;
+    rx_opts.id = handler->id;
 
     if (pthread_mutex_init(&handler->tx_config_mutex, NULL)) {
       fprintf(stderr, "Mutex init: %s\n", strerror(errno));
@@ -289,11 +375,6 @@ int rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_c
     // id
     // TODO: set some meaningful ID in handler->id
 
-    // rx_format, tx_format
-    // TODO: add other formats
-    rx_opts.sample_format = FILERF_TYPE_FC32;
-    tx_opts.sample_format = FILERF_TYPE_FC32;
-
     update_rates(handler, 1.92e6);
 
     // Create channels
@@ -397,6 +478,28 @@ int rf_file_close(void* h)
   return SRSRAN_SUCCESS;
 }
 
+int rf_file_rx_seek_time(void* h, time_t secs, double frac_secs)
+{
+  int ret = SRSRAN_ERROR;
+
+  if (h) {
+    rf_file_handler_t* handler = (rf_file_handler_t*)h;
+
+    srsran_timestamp_t ts = {};
+    srsran_timestamp_init(&ts, secs, frac_secs);
+    uint64_t sample = srsran_timestamp_uint64(&ts, handler->base_srate);
+
+    ret = SRSRAN_SUCCESS;
+    for (uint32_t i = 0; i < handler->nof_channels; i++) {
+      if (handler->receiver[i].running && rf_file_rx_seek(&handler->receiver[i], sample) < SRSRAN_SUCCESS) {
+        ret = SRSRAN_ERROR;
+      }
+    }
+  }
+
+  return ret;
+}
+
 void update_rates(rf_file_handler_t* handler, double srate)
 {
   pthread_mutex_lock(&handler->decim_mutex);
@@ -540,14 +643,28 @@ int rf_file_recv_with_time(void* h, void* data, uint32_t nsamples, bool blocking
   return rf_file_recv_with_time_multi(h, &data, nsamples, blocking, secs, frac_secs);
 }
 
-int rf_file_recv_with_time_multi(void*    h,
-                                 void**   data,
-                                 uint32_t nsamples,
-                                 bool     blocking,
-                                 time_t*  secs,
-                                 double*  frac_secs)
+bool rf_file_has_rx_sc16(void* h)
 {
-  int ret = SRSRAN_ERROR;
+  bool ret = false;
+
+  if (h) {
+    rf_file_handler_t* handler = (rf_file_handler_t*)h;
+
+    ret = true;
+    for (uint32_t i = 0; i < handler->nof_channels; i++) {
+      ret &= (handler->receiver[i].sample_format == FILERF_TYPE_SC16);
+    }
+  }
+
+  return ret;
+}
+
+// Receives float samples when sc16_scale is NULL, otherwise the raw 16-bit integer samples and their unitary amplitude
+static int
+rf_file_recv_multi(void* h, void** data, uint32_t nsamples, time_t* secs, double* frac_secs, float* sc16_scale)
+{
+  int  ret  = SRSRAN_ERROR;
+  bool sc16 = (sc16_scale != NULL);
 
   if (h) {
     rf_file_handler_t* handler = (rf_file_handler_t*)h;
@@ -555,7 +672,7 @@ int rf_file_recv_with_time_multi(void*    h,
     // Map ports to data buffers according to the selected frequencies
     pthread_mutex_lock(&handler->rx_config_mutex);
     bool  mapped[SRSRAN_MAX_CHANNELS]  = {}; // Mapped mask, set to true when the physical channel is used
-    cf_t* buffers[SRSRAN_MAX_CHANNELS] = {}; // Buffer pointers, NULL if unmatched
+    void* buffers[SRSRAN_MAX_CHANNELS] = {}; // Buffer pointers, NULL if unmatched
 
     // For each logical channel...
     for (uint32_t logical = 0; logical < handler->nof_channels; logical++) {
@@ -566,7 +683,7 @@ int rf_file_recv_with_time_multi(void*    h,
         // Consider a match if the physical channel is NOT mapped and the frequency match
         if (!mapped[physical] && rf_file_rx_match_freq(&handler->receiver[physical], handler->rx_freq_mhz[logical])) {
           // Not mapped and matched frequency with receiver
-          buffers[physical] = (cf_t*)data[logical];
+          buffers[physical] = data[logical];
           mapped[physical]  = true;
           unmatched         = false;
           break;
@@ -575,7 +692,11 @@ int rf_file_recv_with_time_multi(void*    h,
 
       // If no matching frequency found; set data to zeros
       if (unmatched) {
-        srsran_vec_zero(data[logical], nsamples);
+        if (sc16) {
+          srsran_vec_i16_zero((int16_t*)data[logical], 2 * nsamples);
+        } else {
+          srsran_vec_zero(data[logical], nsamples);
+        }
       }
     }
     pthread_mutex_unlock(&handler->rx_config_mutex);
@@ -636,12 +757,14 @@ int rf_file_recv_with_time_multi(void*    h,
 
       // Iterate channels
       for (uint32_t i = 0; i < handler->nof_channels; i++) {
-        cf_t* ptr = (decim_factor != 1 || buffers[i] == NULL) ? handler->buffer_decimation[i] : buffers[i];
+        void* ptr = (decim_factor != 1 || buffers[i] == NULL) ? handler->buffer_decimation[i] : buffers[i];
 
         // Completed condition
         if (count[i] < nsamples_baserate && handler->receiver[i].running) {
           // Keep receiving
-          int32_t n = rf_file_rx_baseband(&handler->receiver[i], &ptr[count[i]], nsamples_baserate - count[i]);
+          uint32_t n_left = nsamples_baserate - count[i];
+          int32_t  n      = sc16 ? rf_file_rx_baseband_sc16(&handler->receiver[i], (int16_t*)ptr + 2 * count[i], n_left)
+                                 : rf_file_rx_baseband(&handler->receiver[i], (cf_t*)ptr + count[i], n_left);
           if (n > 0) {
             // No error
             count[i] += n;
@@ -668,8 +791,23 @@ int rf_file_recv_with_time_multi(void*    h,
     if (decim_factor != 1) {
       for (uint32_t c = 0; c < handler->nof_channels; c++) {
         // skip if buffer is not available
-        if (buffers[c]) {
-          cf_t* dst = buffers[c];
+        if (buffers[c] && sc16) {
+          int16_t* dst = (int16_t*)buffers[c];
+          int16_t* ptr = (int16_t*)handler->buffer_decimation[c];
+
+          for (uint32_t i = 0, n = 0; i < nsamples; i++) {
+            // Averaging decimation, the integer samples can not hold the sum so divide here
+            int32_t avg_re = 0;
+            int32_t avg_im = 0;
+            for (int j = 0; j < decim_factor; j++, n++) {
+              avg_re += ptr[2 * n];
+              avg_im += ptr[2 * n + 1];
+            }
+            dst[2 * i]     = (int16_t)(avg_re / (int32_t)decim_factor);
+            dst[2 * i + 1] = (int16_t)(avg_im / (int32_t)decim_factor);
+          }
+        } else if (buffers[c]) {
+          cf_t* dst = (cf_t*)buffers[c];
           cf_t* ptr = handler->buffer_decimation[c];
 
           for (uint32_t i = 0, n = 0; i < nsamples; i++) {
@@ -694,11 +832,16 @@ int rf_file_recv_with_time_multi(void*    h,
     pthread_mutex_lock(&handler->rx_gain_mutex);
     float scale = srsran_convert_dB_to_amplitude(handler->rx_gain);
     pthread_mutex_unlock(&handler->rx_gain_mutex);
-    // scale shall also incorporate decim_factor
-    scale = scale / decim_factor;
-    for (uint32_t c = 0; c < handler->nof_channels; c++) {
-      if (buffers[c]) {
-        srsran_vec_sc_prod_cfc(buffers[c], scale, buffers[c], nsamples);
+    if (sc16) {
+      // Leave the integer samples untouched and report the value of the unitary amplitude instead
+      *sc16_scale = (float)INT16_MAX / scale;
+    } else {
+      // scale shall also incorporate decim_factor
+      scale = scale / decim_factor;
+      for (uint32_t c = 0; c < handler->nof_channels; c++) {
+        if (buffers[c]) {
+          srsran_vec_sc_prod_cfc((cf_t*)buffers[c], scale, (cf_t*)buffers[c], nsamples);
+        }
       }
     }
 
@@ -713,6 +856,31 @@ clean_exit:
   return ret;
 }
 
+int rf_file_recv_with_time_multi(void*    h,
+                                 void**   data,
+                                 uint32_t nsamples,
+                                 bool     blocking,
+                                 time_t*  secs,
+                                 double*  frac_secs)
+{
+  return rf_file_recv_multi(h, data, nsamples, secs, frac_secs, NULL);
+}
+
+int rf_file_recv_with_time_multi_sc16(void*    h,
+                                      void**   data,
+                                      uint32_t nsamples,
+                                      bool     blocking,
+                                      time_t*  secs,
+                                      double*  frac_secs,
+                                      float*   scale)
+{
+  if (scale == NULL || !rf_file_has_rx_sc16(h)) {
+    return SRSRAN_ERROR;
+  }
+  *scale = (float)INT16_MAX;
+  return rf_file_recv_multi(h, data, nsamples, secs, frac_secs, scale);
+}
+
 int rf_file_send_timed(void*  h,
                        void*  data,
                        int    nsamples,
@@ -890,4 +1058,6 @@ rf_dev_t srsran_rf_dev_file = {"file",
                                rf_file_recv_with_time,
                                rf_file_recv_with_time_multi,
                                rf_file_send_timed,
-                               .srsran_rf_send_timed_multi = rf_file_send_timed_multi};
+                               .srsran_rf_send_timed_multi          = rf_file_send_timed_multi,
+                               .srsran_rf_has_rx_sc16               = rf_file_has_rx_sc16,
+                               .srsran_rf_recv_with_time_multi_sc16 = rf_file_recv_with_time_multi_sc16};
@@ -109,6 +109,16 @@ rf_file_recv_with_time(void* h, void* data, uint32_t nsamples, bool blocking, ti
 SRSRAN_API int
 rf_file_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool blocking, time_t* secs, double* frac_secs);
 
+SRSRAN_API bool rf_file_has_rx_sc16(void* h);
+
+SRSRAN_API int rf_file_recv_with_time_multi_sc16(void*    h,
+                                                 void**   data,
+                                                 uint32_t nsamples,
+                                                 bool     blocking,
+                                                 time_t*  secs,
+                                                 double*  frac_secs,
+                                                 float*   scale);
+
 SRSRAN_API int rf_file_send_timed(void*  h,
                                   void*  data,
                                   int    nsamples,
@@ -141,4 +151,14 @@ SRSRAN_API int rf_file_send_timed_multi(void*  h,
 SRSRAN_API int
 rf_file_open_file(void** h, FILE** rx_files, FILE** tx_files, uint32_t nof_channels, uint32_t base_srate);
 
+/**
+ * @brief Moves the read position of all the RX files to the given time from their beginning, at the base sample rate.
+ * The timestamps of the received samples are not affected
+ * @param[in] h Object handle
+ * @param[in] secs Full seconds from the beginning of the files
+ * @param[in] frac_secs Fractional seconds
+ * @return SRSRAN_SUCCESS on success, otherwise error code
+ */
+SRSRAN_API int rf_file_rx_seek_time(void* h, time_t secs, double frac_secs);
+
 #endif // SRSRAN_RF_FILE_IMP_H
@@ -20,9 +20,144 @@
  */
 
 #include "rf_file_imp_trx.h"
+#include <errno.h>
+#include <inttypes.h>
 #include <srsran/phy/utils/vector.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Maps the whole file again, it is called at open and every time the end of the mapping is reached, as the file may
+// still be growing
+static int rf_file_rx_map(rf_file_rx_t* q)
+{
+  struct stat st = {};
+  if (fstat(fileno(q->file), &st) < 0 || !S_ISREG(st.st_mode)) {
+    return SRSRAN_ERROR;
+  }
+
+  size_t len = (size_t)st.st_size;
+  if (len == q->map_len) {
+    return SRSRAN_SUCCESS;
+  }
+
+  if (q->map) {
+    munmap(q->map, q->map_len);
+    q->map     = NULL;
+    q->map_len = 0;
+  }
+
+  if (len > 0) {
+    void* map = mmap(NULL, len, PROT_READ, MAP_SHARED, fileno(q->file), 0);
+    if (map == MAP_FAILED) {
+      rf_file_error(q->id, "[file] Error: mapping rx file. %s.\n", strerror(errno));
+      return SRSRAN_ERROR;
+    }
+    madvise(map, len, MADV_SEQUENTIAL);
+    q->map     = map;
+    q->map_len = len;
+  }
+  q->file_nsamples    = q->map_len / rf_file_sample_size(q->sample_format);
+  q->readahead_offset = 0;
+
+  return SRSRAN_SUCCESS;
+}
+
+// Requests the next window of the file, and releases the pages already read
+static void rf_file_rx_readahead(rf_file_rx_t* q, size_t offset)
+{
+  if (offset + FILE_READAHEAD_BYTES / 2 < q->readahead_offset && offset + FILE_READAHEAD_BYTES >= q->readahead_offset) {
+    return;
+  }
+
+  size_t page_sz = (size_t)sysconf(_SC_PAGESIZE);
+  size_t start   = offset - offset % page_sz;
+  size_t len     = SRSRAN_MIN(FILE_READAHEAD_BYTES, q->map_len - start);
+  madvise(q->map + start, len, MADV_WILLNEED);
+  if (start >= 2 * FILE_READAHEAD_BYTES) {
+    madvise(q->map + start - 2 * FILE_READAHEAD_BYTES, FILE_READAHEAD_BYTES, MADV_DONTNEED);
+  }
+  q->readahead_offset = start + len;
+}
+
+// Converts the file samples to float, or copies them as they are when sc16 is set (the file format must be SC16)
+static void rf_file_rx_convert(rf_file_rx_t* q, const void* src, void* buffer, uint32_t nsamples, bool sc16)
+{
+  if (sc16) {
+    if (src != buffer) {
+      memcpy(buffer, src, (size_t)nsamples * rf_file_sample_size(FILERF_TYPE_SC16));
+    }
+    return;
+  }
+
+  switch (q->sample_format) {
+    case FILERF_TYPE_SC16:
+      srsran_vec_convert_if((const int16_t*)src, INT16_MAX, (float*)buffer, 2 * nsamples);
+      break;
+    case FILERF_TYPE_SC8:
+      srsran_vec_convert_bf((const int8_t*)src, INT8_MAX, (float*)buffer, 2 * nsamples);
+      break;
+    case FILERF_TYPE_FC32:
+    default:
+      if (src != buffer) {
+        memcpy(buffer, src, NSAMPLES2NBYTES(nsamples));
+      }
+      break;
+  }
+}
+
+static int rf_file_rx_baseband_mmap(rf_file_rx_t* q, void* buffer, uint32_t nsamples, bool sc16)
+{
+  if (q->nsamples >= q->file_nsamples) {
+    // Reached the end of the mapping, the file may have grown
+    if (rf_file_rx_map(q) < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+    if (q->nsamples >= q->file_nsamples) {
+      if (!q->loop || q->file_nsamples == 0) {
+        return SRSRAN_ERROR_RX_EOF;
+      }
+      rf_file_info(q->id, " - Rx file looped after %" PRIu64 " samples.\n", q->file_nsamples);
+      q->nsamples = 0;
+    }
+  }
+
+  uint32_t sample_sz = rf_file_sample_size(q->sample_format);
+  uint32_t n         = (uint32_t)SRSRAN_MIN((uint64_t)nsamples, q->file_nsamples - q->nsamples);
+  size_t   offset    = (size_t)q->nsamples * sample_sz;
+
+  rf_file_rx_readahead(q, offset);
+  rf_file_rx_convert(q, q->map + offset, buffer, n, sc16);
+  q->nsamples += n;
+
+  return (int)n;
+}
+
+static int rf_file_rx_baseband_read(rf_file_rx_t* q, void* buffer, uint32_t nsamples, bool sc16)
+{
+  uint32_t sample_sz = rf_file_sample_size(q->sample_format);
+  void*    dst       = (q->sample_format == FILERF_TYPE_FC32 || sc16) ? buffer : q->temp_buffer_convert;
+
+  // The conversion buffer holds as many samples as the caller buffers
+  nsamples = SRSRAN_MIN(nsamples, FILE_MAX_BUFFER_SIZE / sample_sz);
+
+  size_t ret = fread(dst, sample_sz, nsamples, q->file);
+  if (ret == 0 && q->loop && fseek(q->file, 0, SEEK_SET) == 0) {
+    rf_file_info(q->id, " - Rx file looped after %" PRIu64 " samples.\n", q->nsamples);
+    q->nsamples = 0;
+    ret         = fread(dst, sample_sz, nsamples, q->file);
+  }
+  if (ret == 0) {
+    return SRSRAN_ERROR_RX_EOF;
+  }
+
+  rf_file_rx_convert(q, dst, buffer, (uint32_t)ret, sc16);
+  q->nsamples += ret;
+
+  return (int)ret;
+}
 
 int rf_file_rx_open(rf_file_rx_t* q, rf_file_opts_t opts)
 {
@@ -42,6 +177,7 @@ int rf_file_rx_open(rf_file_rx_t* q, rf_file_opts_t opts)
     // Configure formats
     q->sample_format = opts.sample_format;
     q->frequency_mhz = opts.frequency_mhz;
+    q->loop          = opts.loop;
 
     q->temp_buffer = srsran_vec_malloc(FILE_MAX_BUFFER_SIZE);
     if (!q->temp_buffer) {
@@ -60,6 +196,15 @@ int rf_file_rx_open(rf_file_rx_t* q, rf_file_opts_t opts)
       goto clean_exit;
     }
 
+    // Map the file if possible, reading continues from the current position of the file
+    if (opts.use_mmap && rf_file_rx_map(q) == SRSRAN_SUCCESS) {
+      off_t pos = ftello(q->file);
+      if (pos > 0) {
+        q->nsamples = (uint64_t)pos / rf_file_sample_size(q->sample_format);
+      }
+      q->use_mmap = true;
+    }
+
     q->running = true;
 
     ret = SRSRAN_SUCCESS;
@@ -69,16 +214,56 @@ clean_exit:
   return ret;
 }
 
+static int rf_file_rx_baseband_generic(rf_file_rx_t* q, void* buffer, uint32_t nsamples, bool sc16)
+{
+  int ret;
+
+  pthread_mutex_lock(&q->mutex);
+  if (q->use_mmap) {
+    ret = rf_file_rx_baseband_mmap(q, buffer, nsamples, sc16);
+  } else {
+    ret = rf_file_rx_baseband_read(q, buffer, nsamples, sc16);
+  }
+  pthread_mutex_unlock(&q->mutex);
+
+  return ret;
+}
+
 int rf_file_rx_baseband(rf_file_rx_t* q, cf_t* buffer, uint32_t nsamples)
 {
-  uint32_t sample_sz = sizeof(cf_t);
+  return rf_file_rx_baseband_generic(q, buffer, nsamples, false);
+}
+
+int rf_file_rx_baseband_sc16(rf_file_rx_t* q, int16_t* buffer, uint32_t nsamples)
+{
+  if (q->sample_format != FILERF_TYPE_SC16) {
+    return SRSRAN_ERROR;
+  }
+
+  return rf_file_rx_baseband_generic(q, buffer, nsamples, true);
+}
 
-  int ret = fread(buffer, sample_sz, nsamples, q->file);
-  if (ret > 0) {
-    return ret;
+int rf_file_rx_seek(rf_file_rx_t* q, uint64_t sample)
+{
+  int ret = SRSRAN_SUCCESS;
+
+  pthread_mutex_lock(&q->mutex);
+  if (q->use_mmap) {
+    rf_file_rx_map(q);
+    if (q->loop && q->file_nsamples > 0) {
+      sample %= q->file_nsamples;
+    }
+    q->nsamples         = sample;
+    q->readahead_offset = 0;
+  } else if (fseeko(q->file, (off_t)(sample * rf_file_sample_size(q->sample_format)), SEEK_SET) == 0) {
+    q->nsamples = sample;
   } else {
-    return SRSRAN_ERROR_RX_EOF;
+    rf_file_error(q->id, "[file] Error: seeking rx file to sample %" PRIu64 ". %s.\n", sample, strerror(errno));
+    ret = SRSRAN_ERROR;
   }
+  pthread_mutex_unlock(&q->mutex);
+
+  return ret;
 }
 
 bool rf_file_rx_match_freq(rf_file_rx_t* q, uint32_t freq_hz)
@@ -103,5 +288,9 @@ void rf_file_rx_close(rf_file_rx_t* q)
     free(q->temp_buffer_convert);
   }
 
+  if (q->map) {
+    munmap(q->map, q->map_len);
+  }
+
   // not touching q->file as we don't know if we need to close it ourselves
 }
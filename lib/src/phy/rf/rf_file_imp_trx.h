@@ -39,8 +39,9 @@
 #define FILE_ID_STRLEN 16
 #define FILE_MAX_GAIN_DB (30.0f)
 #define FILE_MIN_GAIN_DB (0.0f)
+#define FILE_READAHEAD_BYTES (FILE_MAX_BUFFER_SIZE) // Mapped file window requested ahead of the read position
 
-typedef enum { FILERF_TYPE_FC32 = 0, FILERF_TYPE_SC16 } rf_file_format_t;
+typedef enum { FILERF_TYPE_FC32 = 0, FILERF_TYPE_SC16, FILERF_TYPE_SC8 } rf_file_format_t;
 
 typedef struct {
   char             id[FILE_ID_STRLEN];
@@ -66,6 +67,14 @@ typedef struct {
   cf_t*            temp_buffer;
   void*            temp_buffer_convert;
   uint32_t         frequency_mhz;
+  bool             loop;
+
+  // Memory mapped file, the read position is nsamples
+  bool     use_mmap;
+  uint8_t* map;
+  size_t   map_len;
+  uint64_t file_nsamples;
+  size_t   readahead_offset; // End of the window requested ahead
 } rf_file_rx_t;
 
 typedef struct {
@@ -73,11 +82,17 @@ typedef struct {
   rf_file_format_t sample_format;
   FILE*            file;
   uint32_t         frequency_mhz;
+  bool             use_mmap; // Rx only, falls back to reading the file if it can not be mapped
+  bool             loop;     // Rx only, restarts from the beginning of the file at the end
 } rf_file_opts_t;
 
 /*
  * Common functions
  */
+SRSRAN_API uint32_t rf_file_sample_size(rf_file_format_t format);
+
+SRSRAN_API int rf_file_parse_format(const char* str, rf_file_format_t* format);
+
 SRSRAN_API void rf_file_info(char* id, const char* format, ...);
 
 SRSRAN_API void rf_file_error(char* id, const char* format, ...);
@@ -108,6 +123,10 @@ SRSRAN_API int rf_file_rx_open(rf_file_rx_t* q, rf_file_opts_t opts);
 
 SRSRAN_API int rf_file_rx_baseband(rf_file_rx_t* q, cf_t* buffer, uint32_t nsamples);
 
+SRSRAN_API int rf_file_rx_baseband_sc16(rf_file_rx_t* q, int16_t* buffer, uint32_t nsamples);
+
+SRSRAN_API int rf_file_rx_seek(rf_file_rx_t* q, uint64_t sample);
+
 SRSRAN_API bool rf_file_rx_match_freq(rf_file_rx_t* q, uint32_t freq_hz);
 
 SRSRAN_API void rf_file_rx_close(rf_file_rx_t* q);
@@ -79,12 +79,14 @@ static int _rf_file_tx_baseband(rf_file_tx_t* q, cf_t* buffer, uint32_t nsamples
 
   // convert samples if necessary
   void*    buf       = (buffer) ? buffer : q->zeros;
-  uint32_t sample_sz = sizeof(cf_t);
+  uint32_t sample_sz = rf_file_sample_size(q->sample_format);
 
   if (q->sample_format == FILERF_TYPE_SC16) {
-    buf       = q->temp_buffer_convert;
-    sample_sz = 2 * sizeof(short);
+    buf = q->temp_buffer_convert;
     srsran_vec_convert_fi((float*)buffer, INT16_MAX, (short*)q->temp_buffer_convert, 2 * nsamples);
+  } else if (q->sample_format == FILERF_TYPE_SC8) {
+    buf = q->temp_buffer_convert;
+    srsran_vec_convert_fb((float*)buffer, INT8_MAX, (int8_t*)q->temp_buffer_convert, 2 * nsamples);
   }
 
   size_t ret = fwrite(buf, (size_t)sample_sz, (size_t)nsamples, q->file);
@@ -231,6 +231,126 @@ int param_test(const char* args_param, const int num_channels)
   return SRSRAN_SUCCESS;
 }
 
+// Writes random samples in the given format and reads them back, optionally from an offset and looping over the file
+int format_test(const char* format, float epsilon, bool use_mmap, uint32_t offset_sf, bool loop)
+{
+  const uint32_t nof_sf = 10;
+  char           rf_args[RF_PARAM_LEN] = {};
+
+  snprintf(rf_args, RF_PARAM_LEN, "tx_file=format_file,base_srate=1.92e6,tx_format=%s", format);
+  if (srsran_rf_open_devname(&enb_radio, "file", rf_args, 1)) {
+    fprintf(stderr, "Error opening rf\n");
+    return SRSRAN_ERROR;
+  }
+  for (uint32_t i = 0; i < nof_sf * SF_LEN; i++) {
+    enb_tx_buffer[0][i] = (2.0f * (float)rand() / (float)RAND_MAX - 1.0f) +
+                          _Complex_I * (2.0f * (float)rand() / (float)RAND_MAX - 1.0f);
+  }
+  for (uint32_t i = 0; i < nof_sf; i++) {
+    void* data_ptr[SRSRAN_MAX_PORTS] = {&enb_tx_buffer[0][i * SF_LEN]};
+    if (srsran_rf_send_multi(&enb_radio, data_ptr, SF_LEN, true, true, false) != SRSRAN_SUCCESS) {
+      fprintf(stderr, "Error sending data\n");
+      return SRSRAN_ERROR;
+    }
+  }
+  srsran_rf_close(&enb_radio);
+
+  snprintf(rf_args,
+           RF_PARAM_LEN,
+           "rx_file=format_file,base_srate=1.92e6,rx_format=%s,rx_mmap=%d,rx_loop=%d,rx_offset=%g",
+           format,
+           use_mmap,
+           loop,
+           offset_sf * 1e-3);
+  if (srsran_rf_open_devname(&ue_radio, "file", rf_args, 1)) {
+    fprintf(stderr, "Error opening rf\n");
+    return SRSRAN_ERROR;
+  }
+
+  // Without looping, the subframes after the end of the file can not be received
+  uint32_t nof_rx_sf = loop ? 2 * nof_sf : nof_sf - offset_sf;
+  for (uint32_t i = 0; i < nof_rx_sf; i++) {
+    void* data_ptr[SRSRAN_MAX_PORTS] = {&ue_rx_buffer[0][i * SF_LEN]};
+    if (srsran_rf_recv_with_time_multi(&ue_radio, data_ptr, SF_LEN, true, NULL, NULL) != SF_LEN) {
+      fprintf(stderr, "Error receiving subframe %d\n", i);
+      return SRSRAN_ERROR;
+    }
+  }
+  void* data_ptr[SRSRAN_MAX_PORTS] = {ue_rx_buffer[0]};
+  int   ret                        = srsran_rf_recv_with_time_multi(&ue_radio, data_ptr, SF_LEN, true, NULL, NULL);
+  srsran_rf_close(&ue_radio);
+  if (!loop && ret != SRSRAN_ERROR_RX_EOF) {
+    fprintf(stderr, "Expected the end of the file\n");
+    return SRSRAN_ERROR;
+  }
+
+  for (uint32_t i = 0; i < nof_rx_sf * SF_LEN; i++) {
+    cf_t expected = enb_tx_buffer[0][(offset_sf * SF_LEN + i) % (nof_sf * SF_LEN)];
+    if (cabsf(ue_rx_buffer[0][i] - expected) > epsilon) {
+      fprintf(stderr, "%s data mismatch in sample %d\n", format, i);
+      return SRSRAN_ERROR;
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+// Writes random sc16 samples and reads them back without the float conversion
+int sc16_test(bool use_mmap)
+{
+  const uint32_t nof_sf                = 4;
+  char           rf_args[RF_PARAM_LEN] = {};
+  static int16_t rx_sc16[2 * SF_LEN];
+
+  if (format_test("sc16", 1e-4f, use_mmap, 0, false) != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  // A float file can not be received as integers
+  snprintf(rf_args, RF_PARAM_LEN, "rx_file=format_file,base_srate=1.92e6,rx_format=fc32");
+  if (srsran_rf_open_devname(&ue_radio, "file", rf_args, 1)) {
+    fprintf(stderr, "Error opening rf\n");
+    return SRSRAN_ERROR;
+  }
+  bool has_rx_sc16 = srsran_rf_has_rx_sc16(&ue_radio);
+  srsran_rf_close(&ue_radio);
+  if (has_rx_sc16) {
+    fprintf(stderr, "Unexpected sc16 reception from a fc32 file\n");
+    return SRSRAN_ERROR;
+  }
+
+  snprintf(rf_args, RF_PARAM_LEN, "rx_file=format_file,base_srate=1.92e6,rx_format=sc16,rx_mmap=%d", use_mmap);
+  if (srsran_rf_open_devname(&ue_radio, "file", rf_args, 1)) {
+    fprintf(stderr, "Error opening rf\n");
+    return SRSRAN_ERROR;
+  }
+  if (!srsran_rf_has_rx_sc16(&ue_radio)) {
+    fprintf(stderr, "Expected sc16 reception\n");
+    return SRSRAN_ERROR;
+  }
+
+  // format_test left the samples it wrote in the TX buffer
+  for (uint32_t sf = 0; sf < nof_sf; sf++) {
+    int16_t* data_ptr[SRSRAN_MAX_PORTS] = {rx_sc16};
+    float    scale                      = 0.0f;
+    if (srsran_rf_recv_with_time_multi_sc16(&ue_radio, data_ptr, SF_LEN, true, NULL, NULL, &scale) != SF_LEN) {
+      fprintf(stderr, "Error receiving subframe %d\n", sf);
+      return SRSRAN_ERROR;
+    }
+    for (uint32_t i = 0; i < SF_LEN; i++) {
+      cf_t rx       = ((float)rx_sc16[2 * i] + _Complex_I * (float)rx_sc16[2 * i + 1]) / scale;
+      cf_t expected = enb_tx_buffer[0][sf * SF_LEN + i];
+      if (cabsf(rx - expected) > 1e-4f) {
+        fprintf(stderr, "sc16 data mismatch in sample %d\n", sf * SF_LEN + i);
+        return SRSRAN_ERROR;
+      }
+    }
+  }
+  srsran_rf_close(&ue_radio);
+
+  return SRSRAN_SUCCESS;
+}
+
 void create_file(const char* filename)
 {
   FILE* f = fopen(filename, "w");
@@ -320,7 +440,22 @@ int main()
     return -1;
   }
 
+  // on-disk formats, read from the mapped file or with stdio, with offset and looped playback
+  if (format_test("fc32", COMPARE_EPSILON, true, 0, false) || format_test("fc32", COMPARE_EPSILON, false, 3, false) ||
+      format_test("sc16", 1e-4f, true, 2, true) || format_test("sc16", 1e-4f, false, 0, true) ||
+      format_test("sc8", 2e-2f, true, 0, false) || format_test("sc8", 2e-2f, false, 5, true)) {
+    fprintf(stderr, "Sample format test failed!\n");
+    return -1;
+  }
+
+  // sc16 samples received as they are stored in the file
+  if (sc16_test(true) || sc16_test(false)) {
+    fprintf(stderr, "sc16 reception test failed!\n");
+    return -1;
+  }
+
   // clean workspace
+  remove_file("format_file");
   remove_file("rx_file0");
   remove_file("rx_file1");
   remove_file("rx_file2");
@@ -295,6 +295,28 @@ int srsran_rf_recv_with_time_multi(srsran_rf_t* rf,
   return ((rf_dev_t*)rf->dev)->srsran_rf_recv_with_time_multi(rf->handler, data, nsamples, blocking, secs, frac_secs);
 }
 
+bool srsran_rf_has_rx_sc16(srsran_rf_t* rf)
+{
+  rf_dev_t* dev = (rf_dev_t*)rf->dev;
+  return dev->srsran_rf_has_rx_sc16 != NULL && dev->srsran_rf_has_rx_sc16(rf->handler);
+}
+
+int srsran_rf_recv_with_time_multi_sc16(srsran_rf_t* rf,
+                                        int16_t**    data,
+                                        uint32_t     nsamples,
+                                        bool         blocking,
+                                        time_t*      secs,
+                                        double*      frac_secs,
+                                        float*       scale)
+{
+  rf_dev_t* dev = (rf_dev_t*)rf->dev;
+  if (dev->srsran_rf_recv_with_time_multi_sc16 == NULL) {
+    return SRSRAN_ERROR;
+  }
+  return dev->srsran_rf_recv_with_time_multi_sc16(
+      rf->handler, (void**)data, nsamples, blocking, secs, frac_secs, scale);
+}
+
 int srsran_rf_set_tx_gain(srsran_rf_t* rf, double gain)
 {
   return ((rf_dev_t*)rf->dev)->srsran_rf_set_tx_gain(rf->handler, gain);
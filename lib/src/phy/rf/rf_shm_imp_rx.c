@@ -0,0 +1,201 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_shm_imp_trx.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// Marks the segment of a previous receiver as closed, so a transmitter still attached to it detaches
+static void rf_shm_rx_close_stale(const char* name)
+{
+  int fd = shm_open(name, O_RDWR, 0);
+  if (fd < 0) {
+    return;
+  }
+
+  struct stat st = {};
+  if (fstat(fd, &st) == 0 && st.st_size >= SHM_HEADER_SIZE) {
+    void* map = mmap(NULL, SHM_HEADER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map != MAP_FAILED) {
+      __atomic_store_n(&((rf_shm_header_t*)map)->closed, 1, __ATOMIC_RELEASE);
+      munmap(map, SHM_HEADER_SIZE);
+    }
+  }
+
+  close(fd);
+}
+
+int rf_shm_rx_open(rf_shm_rx_t* q, rf_shm_opts_t opts, char* port)
+{
+  int ret = SRSRAN_ERROR;
+  int fd  = -1;
+
+  if (q) {
+    // Zero object
+    bzero(q, sizeof(rf_shm_rx_t));
+
+    // Copy id
+    strncpy(q->id, opts.id, SHM_ID_STRLEN - 1);
+    q->id[SHM_ID_STRLEN - 1] = '\0';
+
+    rf_shm_segment_name(port, q->name);
+    q->sample_format      = opts.sample_format;
+    q->sample_sz          = rf_shm_sample_size(opts.sample_format);
+    q->frequency_mhz      = opts.frequency_mhz;
+    q->fail_on_disconnect = opts.fail_on_disconnect;
+    q->trx_timeout_ms     = opts.trx_timeout_ms;
+    q->log_trx_timeout    = opts.log_trx_timeout;
+    q->map_len            = SHM_HEADER_SIZE + (size_t)SHM_RING_NSAMPLES * q->sample_sz;
+
+    rf_shm_info(q->id, "Creating receiver segment: %s\n", q->name);
+
+    // Replace the segment of a previous run, a transmitter still attached to it sees it closed
+    rf_shm_rx_close_stale(q->name);
+    shm_unlink(q->name);
+    fd = shm_open(q->name, O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+      fprintf(stderr, "Error: creating receiver segment %s: %s\n", q->name, strerror(errno));
+      goto clean_exit;
+    }
+
+    if (ftruncate(fd, (off_t)q->map_len) < 0) {
+      fprintf(stderr, "Error: sizing receiver segment %s: %s\n", q->name, strerror(errno));
+      goto clean_exit;
+    }
+
+    void* map = mmap(NULL, q->map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+      fprintf(stderr, "Error: mapping receiver segment %s: %s\n", q->name, strerror(errno));
+      goto clean_exit;
+    }
+    q->hdr  = (rf_shm_header_t*)map;
+    q->ring = (uint8_t*)map + SHM_HEADER_SIZE;
+
+    if (pthread_mutex_init(&q->mutex, NULL)) {
+      fprintf(stderr, "Error: creating mutex\n");
+      goto clean_exit;
+    }
+
+    // Publish the first request and then the magic number, transmitters do not attach to an incomplete segment
+    q->hdr->format      = (uint32_t)q->sample_format;
+    q->hdr->sample_sz   = q->sample_sz;
+    q->hdr->nof_samples = SHM_RING_NSAMPLES;
+    q->hdr->write_ts    = 0;
+    q->hdr->request_ts  = SHM_RING_NSAMPLES;
+    __atomic_store_n(&q->hdr->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+
+    q->running = true;
+
+    ret = SRSRAN_SUCCESS;
+  }
+
+clean_exit:
+  // The mapping keeps the segment open
+  if (fd >= 0) {
+    close(fd);
+    if (ret && q->hdr == NULL) {
+      shm_unlink(q->name);
+    }
+  }
+  return ret;
+}
+
+int rf_shm_rx_baseband(rf_shm_rx_t* q, cf_t* buffer, uint32_t nsamples)
+{
+  uint64_t        write_ts = 0;
+  uint32_t        backoff  = 0;
+  struct timespec start    = {};
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  // Wait for samples
+  while ((write_ts = __atomic_load_n(&q->hdr->write_ts, __ATOMIC_ACQUIRE)) == q->nsamples) {
+    if (rf_shm_elapsed_ms(&start) > q->trx_timeout_ms) {
+      return SRSRAN_ERROR_TIMEOUT;
+    }
+    rf_shm_backoff(&backoff);
+  }
+
+  // Read up to the available samples or the end of the ring, straight from the segment into the caller buffer
+  uint32_t offset = (uint32_t)(q->nsamples & (SHM_RING_NSAMPLES - 1));
+  uint32_t n      = SRSRAN_MIN(nsamples, SHM_RING_NSAMPLES - offset);
+  n               = (uint32_t)SRSRAN_MIN(n, write_ts - q->nsamples);
+  void* src       = q->ring + (size_t)offset * q->sample_sz;
+  if (q->sample_format == SHM_TYPE_SC16) {
+    srsran_vec_convert_if((int16_t*)src, INT16_MAX, (float*)buffer, 2 * n);
+  } else {
+    srsran_vec_cf_copy(buffer, (cf_t*)src, n);
+  }
+
+  // Release the slots and request as many samples as fit in the ring
+  q->nsamples += n;
+  __atomic_store_n(&q->hdr->request_ts, q->nsamples + SHM_RING_NSAMPLES, __ATOMIC_RELEASE);
+
+  return (int)n;
+}
+
+bool rf_shm_rx_match_freq(rf_shm_rx_t* q, uint32_t freq_hz)
+{
+  bool ret = false;
+  if (q) {
+    ret = (q->frequency_mhz == 0 || q->frequency_mhz == freq_hz);
+  }
+  return ret;
+}
+
+void rf_shm_rx_close(rf_shm_rx_t* q)
+{
+  rf_shm_info(q->id, "Closing ...\n");
+
+  pthread_mutex_lock(&q->mutex);
+  q->running = false;
+  pthread_mutex_unlock(&q->mutex);
+
+  pthread_mutex_destroy(&q->mutex);
+
+  // The transmitter stops writing and waits for the segment of the next receiver
+  if (q->hdr) {
+    __atomic_store_n(&q->hdr->closed, 1, __ATOMIC_RELEASE);
+    munmap(q->hdr, q->map_len);
+    shm_unlink(q->name);
+    q->hdr  = NULL;
+    q->ring = NULL;
+  }
+}
+
+bool rf_shm_rx_is_running(rf_shm_rx_t* q)
+{
+  if (!q) {
+    return false;
+  }
+
+  bool ret = false;
+  pthread_mutex_lock(&q->mutex);
+  ret = q->running;
+  pthread_mutex_unlock(&q->mutex);
+
+  return ret;
+}
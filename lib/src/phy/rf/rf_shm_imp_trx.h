@@ -0,0 +1,161 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_RF_SHM_IMP_TRX_H
+#define SRSRAN_RF_SHM_IMP_TRX_H
+
+#include <pthread.h>
+#include <srsran/config.h>
+#include <srsran/phy/common/phy_common.h>
+#include <stdbool.h>
+#include <time.h>
+
+/* Definitions */
+#define VERBOSE (0)
+#define SHM_MAGIC (0x5352534dU)      // "SRSM"
+#define SHM_RING_NSAMPLES (1U << 19) // Power of two, more than 10 subframes at 30.72 MHz
+#define SHM_HEADER_SIZE (4096)
+#define SHM_CACHE_LINE (64)
+#define SHM_TIMEOUT_MS (2000)
+#define SHM_SPIN_COUNT (1000)
+#define SHM_POLL_US (10)
+#define SHM_MAX_BUFFER_NSAMPLES (3072000) // 100 subframes at 30.72 MHz, for decimation and interpolation
+#define SHM_BASERATE_DEFAULT_HZ (23040000)
+#define SHM_ID_STRLEN 16
+#define SHM_NAME_STRLEN 64
+#define SHM_MAX_GAIN_DB (30.0f)
+#define SHM_MIN_GAIN_DB (0.0f)
+
+typedef enum { SHM_TYPE_FC32 = 0, SHM_TYPE_SC16 } rf_shm_format_t;
+
+/*
+ * Header at the start of each shared-memory segment. A segment carries one channel from a single transmitter
+ * (producer) to a single receiver (consumer). The ring positions are sample timestamps counted from the creation of
+ * the segment, a sample with timestamp ts lives at slot (ts & (nof_samples - 1)).
+ *
+ * Flow control follows the ZMQ REQ/REP pattern without sockets: the receiver requests samples by publishing
+ * request_ts, and the transmitter does not write past it. The receiver creates the segment with its first request
+ * already published, so the transmitter attaches and writes without waiting on the other process. Each index is
+ * written by one side only, on its own cache line.
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t format;
+  uint32_t sample_sz;
+  uint32_t nof_samples;
+  uint32_t closed; ///< Set by the receiver when it closes, the transmitter waits for the next receiver
+  uint8_t  reserved0[SHM_CACHE_LINE - 5 * sizeof(uint32_t)];
+  uint64_t write_ts; ///< Transmitter: timestamp of the next sample to write, samples before it are readable
+  uint8_t  reserved1[SHM_CACHE_LINE - sizeof(uint64_t)];
+  uint64_t request_ts; ///< Receiver: the transmitter may write samples up to, not including, this timestamp
+  uint8_t  reserved2[SHM_HEADER_SIZE - 2 * SHM_CACHE_LINE - sizeof(uint64_t)];
+} rf_shm_header_t;
+
+typedef struct {
+  char             id[SHM_ID_STRLEN];
+  char             name[SHM_NAME_STRLEN];
+  rf_shm_format_t  sample_format;
+  rf_shm_header_t* hdr;
+  uint8_t*         ring;
+  size_t           map_len;
+  uint32_t         sample_sz;
+  uint64_t         nsamples; ///< Transmit timestamp, kept across receivers
+  bool             dropping; ///< No receiver attached within the timeout, samples are dropped until one attaches
+  bool             running;
+  pthread_mutex_t  mutex;
+  uint32_t         frequency_mhz;
+  uint32_t         trx_timeout_ms;
+} rf_shm_tx_t;
+
+typedef struct {
+  char             id[SHM_ID_STRLEN];
+  char             name[SHM_NAME_STRLEN];
+  rf_shm_format_t  sample_format;
+  rf_shm_header_t* hdr;
+  uint8_t*         ring;
+  size_t           map_len;
+  uint32_t         sample_sz;
+  uint64_t         nsamples; ///< Timestamp of the next sample to read
+  bool             running;
+  pthread_mutex_t  mutex;
+  uint32_t         frequency_mhz;
+  bool             fail_on_disconnect;
+  uint32_t         trx_timeout_ms;
+  bool             log_trx_timeout;
+} rf_shm_rx_t;
+
+typedef struct {
+  const char*     id;
+  rf_shm_format_t sample_format;
+  uint32_t        frequency_mhz;
+  bool            fail_on_disconnect;
+  uint32_t        trx_timeout_ms;
+  bool            log_trx_timeout;
+} rf_shm_opts_t;
+
+/*
+ * Common functions
+ */
+SRSRAN_API void rf_shm_info(char* id, const char* format, ...);
+
+SRSRAN_API void rf_shm_error(char* id, const char* format, ...);
+
+SRSRAN_API void rf_shm_segment_name(const char* port, char name[SHM_NAME_STRLEN]);
+
+SRSRAN_API uint32_t rf_shm_sample_size(rf_shm_format_t format);
+
+SRSRAN_API void rf_shm_backoff(uint32_t* count);
+
+SRSRAN_API uint64_t rf_shm_elapsed_ms(const struct timespec* start);
+
+/*
+ * Transmitter functions
+ */
+SRSRAN_API int rf_shm_tx_open(rf_shm_tx_t* q, rf_shm_opts_t opts, char* port);
+
+SRSRAN_API int rf_shm_tx_align(rf_shm_tx_t* q, uint64_t ts);
+
+SRSRAN_API int rf_shm_tx_baseband(rf_shm_tx_t* q, cf_t* buffer, uint32_t nsamples);
+
+SRSRAN_API uint64_t rf_shm_tx_get_nsamples(rf_shm_tx_t* q);
+
+SRSRAN_API int rf_shm_tx_zeros(rf_shm_tx_t* q, uint32_t nsamples);
+
+SRSRAN_API bool rf_shm_tx_match_freq(rf_shm_tx_t* q, uint32_t freq_hz);
+
+SRSRAN_API void rf_shm_tx_close(rf_shm_tx_t* q);
+
+SRSRAN_API bool rf_shm_tx_is_running(rf_shm_tx_t* q);
+
+/*
+ * Receiver functions
+ */
+SRSRAN_API int rf_shm_rx_open(rf_shm_rx_t* q, rf_shm_opts_t opts, char* port);
+
+SRSRAN_API int rf_shm_rx_baseband(rf_shm_rx_t* q, cf_t* buffer, uint32_t nsamples);
+
+SRSRAN_API bool rf_shm_rx_match_freq(rf_shm_rx_t* q, uint32_t freq_hz);
+
+SRSRAN_API void rf_shm_rx_close(rf_shm_rx_t* q);
+
+SRSRAN_API bool rf_shm_rx_is_running(rf_shm_rx_t* q);
+
+#endif // SRSRAN_RF_SHM_IMP_TRX_H
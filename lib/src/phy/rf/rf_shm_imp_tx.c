@@ -0,0 +1,273 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_shm_imp_trx.h"
+#include <fcntl.h>
+#include <inttypes.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static void rf_shm_tx_detach(rf_shm_tx_t* q)
+{
+  if (q->hdr) {
+    munmap(q->hdr, q->map_len);
+    q->hdr  = NULL;
+    q->ring = NULL;
+  }
+}
+
+/// Maps the segment of the receiver, if it exists, is complete and still open
+static int rf_shm_tx_attach(rf_shm_tx_t* q)
+{
+  int fd = shm_open(q->name, O_RDWR, 0);
+  if (fd < 0) {
+    return SRSRAN_ERROR;
+  }
+
+  int         ret = SRSRAN_ERROR;
+  struct stat st  = {};
+  if (fstat(fd, &st) < 0 || st.st_size < SHM_HEADER_SIZE) {
+    goto clean_exit;
+  }
+
+  void* map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) {
+    goto clean_exit;
+  }
+  q->hdr     = (rf_shm_header_t*)map;
+  q->map_len = (size_t)st.st_size;
+
+  if (__atomic_load_n(&q->hdr->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC ||
+      __atomic_load_n(&q->hdr->closed, __ATOMIC_ACQUIRE)) {
+    rf_shm_tx_detach(q);
+    goto clean_exit;
+  }
+
+  if (q->hdr->format != (uint32_t)q->sample_format || q->hdr->sample_sz != q->sample_sz ||
+      q->hdr->nof_samples != SHM_RING_NSAMPLES ||
+      q->map_len < SHM_HEADER_SIZE + (size_t)SHM_RING_NSAMPLES * q->sample_sz) {
+    rf_shm_error(q->id, "Error: segment %s does not match the transmitter sample format\n", q->name);
+    rf_shm_tx_detach(q);
+    ret = SRSRAN_ERROR_INVALID_INPUTS;
+    goto clean_exit;
+  }
+  q->ring = (uint8_t*)map + SHM_HEADER_SIZE;
+
+  rf_shm_info(q->id, "Attached transmitter to %s at sample %" PRIu64 "\n", q->name, q->nsamples);
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  close(fd);
+  return ret;
+}
+
+int rf_shm_tx_open(rf_shm_tx_t* q, rf_shm_opts_t opts, char* port)
+{
+  int ret = SRSRAN_ERROR;
+
+  if (q) {
+    // Zero object
+    bzero(q, sizeof(rf_shm_tx_t));
+
+    // Copy id
+    strncpy(q->id, opts.id, SHM_ID_STRLEN - 1);
+    q->id[SHM_ID_STRLEN - 1] = '\0';
+
+    rf_shm_segment_name(port, q->name);
+    q->sample_format  = opts.sample_format;
+    q->sample_sz      = rf_shm_sample_size(opts.sample_format);
+    q->frequency_mhz  = opts.frequency_mhz;
+    q->trx_timeout_ms = opts.trx_timeout_ms;
+
+    if (pthread_mutex_init(&q->mutex, NULL)) {
+      fprintf(stderr, "Error: creating mutex\n");
+      goto clean_exit;
+    }
+
+    // The receiver may start later, the transmitter attaches when its segment appears
+    rf_shm_info(q->id, "Connecting transmitter: %s\n", q->name);
+    if (rf_shm_tx_attach(q) == SRSRAN_ERROR_INVALID_INPUTS) {
+      goto clean_exit;
+    }
+
+    q->running = true;
+
+    ret = SRSRAN_SUCCESS;
+  }
+
+clean_exit:
+  return ret;
+}
+
+static int _rf_shm_tx_baseband(rf_shm_tx_t* q, cf_t* buffer, uint32_t nsamples)
+{
+  uint32_t        count   = 0;
+  uint32_t        backoff = 0;
+  struct timespec start   = {};
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  while (count < nsamples && q->running) {
+    // Wait for the receiver segment, like a REP socket waiting for the first request
+    if (q->hdr && __atomic_load_n(&q->hdr->closed, __ATOMIC_ACQUIRE)) {
+      rf_shm_info(q->id, "Receiver of %s closed\n", q->name);
+      rf_shm_tx_detach(q);
+    }
+    if (q->hdr == NULL) {
+      int ret = rf_shm_tx_attach(q);
+      if (ret == SRSRAN_ERROR_INVALID_INPUTS) {
+        return SRSRAN_ERROR;
+      }
+      if (ret == SRSRAN_SUCCESS) {
+        q->dropping = false;
+      } else if (q->dropping || rf_shm_elapsed_ms(&start) > q->trx_timeout_ms) {
+        // Without a receiver the samples are lost, as over the air, and the transmit time keeps running
+        rf_shm_info(q->id, " - no receiver, dropping %d samples\n", nsamples - count);
+        q->dropping = true;
+        count       = nsamples;
+        break;
+      } else {
+        rf_shm_backoff(&backoff);
+        continue;
+      }
+    }
+
+    // Wait for the receiver to request samples
+    uint64_t write_ts   = q->hdr->write_ts;
+    uint64_t request_ts = __atomic_load_n(&q->hdr->request_ts, __ATOMIC_ACQUIRE);
+    if (request_ts <= write_ts) {
+      if (rf_shm_elapsed_ms(&start) > q->trx_timeout_ms) {
+        rf_shm_info(q->id, " - waiting for a tx request\n");
+        clock_gettime(CLOCK_MONOTONIC, &start);
+      }
+      rf_shm_backoff(&backoff);
+      continue;
+    }
+    backoff = 0;
+
+    // Write up to the request or the end of the ring, converting straight into the segment
+    uint32_t offset = (uint32_t)(write_ts & (SHM_RING_NSAMPLES - 1));
+    uint32_t n      = SRSRAN_MIN(nsamples - count, SHM_RING_NSAMPLES - offset);
+    n               = (uint32_t)SRSRAN_MIN(n, request_ts - write_ts);
+    void* dst       = q->ring + (size_t)offset * q->sample_sz;
+    if (buffer == NULL) {
+      memset(dst, 0, (size_t)n * q->sample_sz);
+    } else if (q->sample_format == SHM_TYPE_SC16) {
+      srsran_vec_convert_fi((float*)&buffer[count], INT16_MAX, (int16_t*)dst, 2 * n);
+    } else {
+      srsran_vec_cf_copy((cf_t*)dst, &buffer[count], n);
+    }
+
+    // Publish the samples
+    __atomic_store_n(&q->hdr->write_ts, write_ts + n, __ATOMIC_RELEASE);
+    count += n;
+  }
+
+  // Increment sample counter
+  q->nsamples += count;
+  rf_shm_info(q->id, " - sent %d samples\n", count);
+
+  return (count == nsamples) ? (int)nsamples : SRSRAN_ERROR;
+}
+
+int rf_shm_tx_align(rf_shm_tx_t* q, uint64_t ts)
+{
+  pthread_mutex_lock(&q->mutex);
+
+  int64_t nsamples = (int64_t)ts - (int64_t)q->nsamples;
+
+  if (nsamples > 0) {
+    rf_shm_info(q->id, " - Detected Tx gap of %d samples.\n", nsamples);
+    _rf_shm_tx_baseband(q, NULL, (uint32_t)nsamples);
+  }
+
+  pthread_mutex_unlock(&q->mutex);
+
+  return (int)nsamples;
+}
+
+int rf_shm_tx_baseband(rf_shm_tx_t* q, cf_t* buffer, uint32_t nsamples)
+{
+  pthread_mutex_lock(&q->mutex);
+  int n = _rf_shm_tx_baseband(q, buffer, nsamples);
+  pthread_mutex_unlock(&q->mutex);
+
+  return n;
+}
+
+uint64_t rf_shm_tx_get_nsamples(rf_shm_tx_t* q)
+{
+  pthread_mutex_lock(&q->mutex);
+  uint64_t ret = q->nsamples;
+  pthread_mutex_unlock(&q->mutex);
+  return ret;
+}
+
+int rf_shm_tx_zeros(rf_shm_tx_t* q, uint32_t nsamples)
+{
+  pthread_mutex_lock(&q->mutex);
+
+  rf_shm_info(q->id, " - Tx %d Zeros.\n", nsamples);
+  _rf_shm_tx_baseband(q, NULL, nsamples);
+
+  pthread_mutex_unlock(&q->mutex);
+
+  return (int)nsamples;
+}
+
+bool rf_shm_tx_match_freq(rf_shm_tx_t* q, uint32_t freq_hz)
+{
+  bool ret = false;
+  if (q) {
+    ret = (q->frequency_mhz == 0 || q->frequency_mhz == freq_hz);
+  }
+  return ret;
+}
+
+void rf_shm_tx_close(rf_shm_tx_t* q)
+{
+  pthread_mutex_lock(&q->mutex);
+  q->running = false;
+  pthread_mutex_unlock(&q->mutex);
+
+  pthread_mutex_destroy(&q->mutex);
+
+  // The segment belongs to the receiver, which still reads the pending samples
+  rf_shm_tx_detach(q);
+}
+
+bool rf_shm_tx_is_running(rf_shm_tx_t* q)
+{
+  if (!q) {
+    return false;
+  }
+
+  bool ret = false;
+  pthread_mutex_lock(&q->mutex);
+  ret = q->running;
+  pthread_mutex_unlock(&q->mutex);
+
+  return ret;
+}
@@ -0,0 +1,253 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "rf_shm_imp.h"
+#include "rf_shm_imp_trx.h"
+#include "srsran/common/tsan_options.h"
+#include "srsran/phy/common/timestamp.h"
+#include "srsran/phy/utils/debug.h"
+#include <complex.h>
+#include <pthread.h>
+#include <srsran/phy/common/phy_common.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdlib.h>
+
+#define NOF_CHANNELS 2
+#define NUM_SF (100)
+#define SF_LEN (1920)
+#define RF_BUFFER_SIZE (SF_LEN * NUM_SF)
+#define TX_OFFSET_MS (4)
+
+static cf_t ue_rx_buffer[NOF_CHANNELS][RF_BUFFER_SIZE];
+static cf_t enb_tx_buffer[NOF_CHANNELS][RF_BUFFER_SIZE];
+static cf_t enb_rx_buffer[NOF_CHANNELS][SF_LEN];
+
+static srsran_rf_t ue_radio, enb_radio;
+
+static void* ue_rx_thread_function(void* args)
+{
+  // receive 5 subframes at once (i.e. mimic initial rx that receives one slot)
+  uint32_t num_slots          = NUM_SF / 5;
+  uint32_t num_samps_per_slot = SF_LEN * 5;
+  uint32_t num_rxed_samps     = 0;
+  for (uint32_t i = 0; i < num_slots; ++i) {
+    void* data_ptr[SRSRAN_MAX_PORTS] = {NULL};
+    for (uint32_t c = 0; c < NOF_CHANNELS; c++) {
+      data_ptr[c] = &ue_rx_buffer[c][i * num_samps_per_slot];
+    }
+    num_rxed_samps += srsran_rf_recv_with_time_multi(&ue_radio, data_ptr, num_samps_per_slot, true, NULL, NULL);
+  }
+
+  printf("received %d samples.\n", num_rxed_samps);
+
+  return NULL;
+}
+
+static int enb_tx_function(bool timed_tx)
+{
+  void* data_ptr[SRSRAN_MAX_PORTS] = {NULL};
+
+  // initial transmission without ts
+  for (int c = 0; c < NOF_CHANNELS; c++) {
+    data_ptr[c] = &enb_tx_buffer[c][0];
+  }
+  if (srsran_rf_send_multi(&enb_radio, (void**)data_ptr, SF_LEN, true, true, false) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Error sending data\n");
+    return SRSRAN_ERROR;
+  }
+  uint32_t num_txed_samples = SF_LEN;
+
+  // from here on, all transmissions are timed relative to the last rx time
+  srsran_timestamp_t rx_time, tx_time;
+
+  for (uint32_t i = 0; i < NUM_SF - ((timed_tx) ? TX_OFFSET_MS : 1); ++i) {
+    // first recv samples, the UE transmitter only sends the zeros of the gap
+    for (int c = 0; c < NOF_CHANNELS; c++) {
+      data_ptr[c] = enb_rx_buffer[c];
+    }
+    srsran_rf_recv_with_time_multi(&enb_radio, data_ptr, SF_LEN, true, &rx_time.full_secs, &rx_time.frac_secs);
+    for (int c = 0; c < NOF_CHANNELS; c++) {
+      if (enb_rx_buffer[c][srsran_vec_max_abs_ci(enb_rx_buffer[c], SF_LEN)] != 0.0f) {
+        fprintf(stderr, "Unexpected samples received by the eNB\n");
+        return SRSRAN_ERROR;
+      }
+    }
+
+    for (int c = 0; c < NOF_CHANNELS; c++) {
+      data_ptr[c] = &enb_tx_buffer[c][num_txed_samples];
+    }
+
+    int ret;
+    if (timed_tx) {
+      // timed tx relative to receive time (this inserts 3 zero subframes in the UE rx)
+      srsran_timestamp_copy(&tx_time, &rx_time);
+      srsran_timestamp_add(&tx_time, 0, TX_OFFSET_MS * 1e-3);
+      ret = srsran_rf_send_timed_multi(
+          &enb_radio, (void**)data_ptr, SF_LEN, tx_time.full_secs, tx_time.frac_secs, true, true, false);
+    } else {
+      ret = srsran_rf_send_multi(&enb_radio, (void**)data_ptr, SF_LEN, true, true, false);
+    }
+    if (ret != SRSRAN_SUCCESS) {
+      fprintf(stderr, "Error sending data\n");
+      return SRSRAN_ERROR;
+    }
+
+    num_txed_samples += SF_LEN;
+  }
+
+  printf("transmitted %d samples\n", num_txed_samples);
+
+  return SRSRAN_SUCCESS;
+}
+
+static int run_test(const char* ue_args, const char* enb_args, bool timed_tx, float epsilon)
+{
+  char      rf_args[RF_PARAM_LEN];
+  pthread_t rx_thread;
+
+  // generate random tx data
+  for (int c = 0; c < NOF_CHANNELS; c++) {
+    for (int i = 0; i < RF_BUFFER_SIZE; i++) {
+      enb_tx_buffer[c][i] = ((float)rand() / (float)RAND_MAX) + _Complex_I * ((float)rand() / (float)RAND_MAX);
+    }
+  }
+
+  // Each receiver creates its segment, so both ends open before any transmission
+  strncpy(rf_args, ue_args, RF_PARAM_LEN - 1);
+  rf_args[RF_PARAM_LEN - 1] = 0;
+  printf("opening ue device with args=%s\n", rf_args);
+  if (srsran_rf_open_devname(&ue_radio, "shm", rf_args, NOF_CHANNELS)) {
+    fprintf(stderr, "Error opening rf\n");
+    return SRSRAN_ERROR;
+  }
+
+  strncpy(rf_args, enb_args, RF_PARAM_LEN - 1);
+  rf_args[RF_PARAM_LEN - 1] = 0;
+  printf("opening enb device with args=%s\n", rf_args);
+  if (srsran_rf_open_devname(&enb_radio, "shm", rf_args, NOF_CHANNELS)) {
+    fprintf(stderr, "Error opening rf\n");
+    return SRSRAN_ERROR;
+  }
+
+  if (pthread_create(&rx_thread, NULL, ue_rx_thread_function, NULL)) {
+    perror("pthread_create");
+    return SRSRAN_ERROR;
+  }
+
+  int ret = enb_tx_function(timed_tx);
+  srsran_rf_close(&enb_radio);
+
+  pthread_join(rx_thread, NULL);
+  srsran_rf_close(&ue_radio);
+
+  if (ret) {
+    return ret;
+  }
+
+  // channel-wise comparison, the timed transmission leaves a gap of 3 zero subframes after the first
+  for (int c = 0; c < NOF_CHANNELS; c++) {
+    for (uint32_t i = 0; i < NUM_SF - (timed_tx ? TX_OFFSET_MS - 1 : 0); ++i) {
+      uint32_t rx_offset = (timed_tx && i >= 1) ? (TX_OFFSET_MS - 1) * SF_LEN : 0;
+      cf_t*    rx        = &ue_rx_buffer[c][rx_offset + i * SF_LEN];
+      srsran_vec_sub_ccc(rx, &enb_tx_buffer[c][i * SF_LEN], rx, SF_LEN);
+      uint32_t max_ix = srsran_vec_max_abs_ci(rx, SF_LEN);
+      if (cabsf(rx[max_ix]) > epsilon) {
+        fprintf(stderr, "data mismatch in channel %d subframe %d: %e\n", c, i, cabsf(rx[max_ix]));
+        return SRSRAN_ERROR;
+      }
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static int run_restart_test()
+{
+  char          port[] = "srsran_shm_test_restart";
+  rf_shm_opts_t opts   = {.id = "restart", .sample_format = SHM_TYPE_FC32, .trx_timeout_ms = 100};
+  rf_shm_rx_t   old_rx, new_rx;
+  rf_shm_tx_t   tx;
+
+  // A transmitter fills the ring of a receiver that stops reading without closing, as if it crashed
+  if (rf_shm_rx_open(&old_rx, opts, port) || rf_shm_tx_open(&tx, opts, port)) {
+    fprintf(stderr, "Error opening segment\n");
+    return SRSRAN_ERROR;
+  }
+  rf_shm_tx_zeros(&tx, SHM_RING_NSAMPLES);
+
+  // The restarted receiver closes the old segment, so the transmitter attaches to the new one instead of waiting
+  if (rf_shm_rx_open(&new_rx, opts, port)) {
+    fprintf(stderr, "Error reopening segment\n");
+    return SRSRAN_ERROR;
+  }
+  int ret = SRSRAN_SUCCESS;
+  if (rf_shm_tx_baseband(&tx, enb_tx_buffer[0], SF_LEN) != SF_LEN ||
+      rf_shm_rx_baseband(&new_rx, ue_rx_buffer[0], SF_LEN) != SF_LEN) {
+    fprintf(stderr, "Error transmitting to the restarted receiver\n");
+    ret = SRSRAN_ERROR;
+  } else {
+    srsran_vec_sub_ccc(ue_rx_buffer[0], enb_tx_buffer[0], ue_rx_buffer[0], SF_LEN);
+    if (cabsf(ue_rx_buffer[0][srsran_vec_max_abs_ci(ue_rx_buffer[0], SF_LEN)]) > 1e-6f) {
+      fprintf(stderr, "data mismatch after the receiver restart\n");
+      ret = SRSRAN_ERROR;
+    }
+  }
+
+  rf_shm_tx_close(&tx);
+  rf_shm_rx_close(&new_rx);
+  rf_shm_rx_close(&old_rx);
+
+  return ret;
+}
+
+int main()
+{
+  // continuous tx, no decimation
+  if (run_test("tx_port=/srsran_shm_test_ul0,tx_port=/srsran_shm_test_ul1,rx_port=/srsran_shm_test_dl0,rx_port=/"
+               "srsran_shm_test_dl1,id=ue,base_srate=1.92e6,trx_timeout_ms=100",
+               "rx_port=/srsran_shm_test_ul0,rx_port=/srsran_shm_test_ul1,tx_port=/srsran_shm_test_dl0,tx_port=/"
+               "srsran_shm_test_dl1,id=enb,base_srate=1.92e6,trx_timeout_ms=100",
+               false,
+               1e-6f) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Continuous tx test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+  // timed tx, with sc16 samples and x2 decimation
+  if (run_test("tx_port=srsran_shm_test_ul0,tx_port=srsran_shm_test_ul1,rx_port=srsran_shm_test_dl0,rx_port="
+               "srsran_shm_test_dl1,id=ue,base_srate=3.84e6,rx_format=sc16,tx_format=sc16,trx_timeout_ms=100",
+               "rx_port=srsran_shm_test_ul0,rx_port=srsran_shm_test_ul1,tx_port=srsran_shm_test_dl0,tx_port="
+               "srsran_shm_test_dl1,id=enb,base_srate=3.84e6,rx_format=sc16,tx_format=sc16,trx_timeout_ms=100",
+               true,
+               1e-4f) != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Timed tx test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+  // receiver restart while the transmitter waits for a request
+  if (run_restart_test() != SRSRAN_SUCCESS) {
+    fprintf(stderr, "Restart test failed!\n");
+    return SRSRAN_ERROR;
+  }
+
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
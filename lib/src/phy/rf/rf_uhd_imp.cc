@@ -1574,7 +1574,9 @@ rf_dev_t srsran_rf_dev_uhd = {"UHD",
                               rf_uhd_recv_with_time,
                               rf_uhd_recv_with_time_multi,
                               rf_uhd_send_timed,
-                              rf_uhd_send_timed_multi};
+                              rf_uhd_send_timed_multi,
+                              nullptr,
+                              nullptr};
 
 #ifdef ENABLE_RF_PLUGINS
 int register_plugin(rf_dev_t** rf_api)
@@ -634,9 +634,28 @@ int rf_zmq_recv_with_time(void* h, void* data, uint32_t nsamples, bool blocking,
   return rf_zmq_recv_with_time_multi(h, &data, nsamples, blocking, secs, frac_secs);
 }
 
-int rf_zmq_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool blocking, time_t* secs, double* frac_secs)
+bool rf_zmq_has_rx_sc16(void* h)
 {
-  int ret = SRSRAN_ERROR;
+  bool ret = false;
+
+  if (h) {
+    rf_zmq_handler_t* handler = (rf_zmq_handler_t*)h;
+
+    ret = true;
+    for (uint32_t i = 0; i < handler->nof_channels; i++) {
+      ret &= (handler->receiver[i].sample_format == ZMQ_TYPE_SC16);
+    }
+  }
+
+  return ret;
+}
+
+// Receives float samples when sc16_scale is NULL, otherwise the raw 16-bit integer samples and their unitary amplitude
+static int
+rf_zmq_recv_multi(void* h, void** data, uint32_t nsamples, time_t* secs, double* frac_secs, float* sc16_scale)
+{
+  int  ret  = SRSRAN_ERROR;
+  bool sc16 = (sc16_scale != NULL);
 
   if (h) {
     rf_zmq_handler_t* handler = (rf_zmq_handler_t*)h;
@@ -644,7 +663,7 @@ int rf_zmq_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool bl
     // Map ports to data buffers according to the selected frequencies
     pthread_mutex_lock(&handler->rx_config_mutex);
     bool  mapped[SRSRAN_MAX_CHANNELS]  = {}; // Mapped mask, set to true when the physical channel is used
-    cf_t* buffers[SRSRAN_MAX_CHANNELS] = {}; // Buffer pointers, NULL if unmatched
+    void* buffers[SRSRAN_MAX_CHANNELS] = {}; // Buffer pointers, NULL if unmatched
 
     // For each logical channel...
     for (uint32_t logical = 0; logical < handler->nof_channels; logical++) {
@@ -655,7 +674,7 @@ int rf_zmq_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool bl
         // Consider a match if the physical channel is NOT mapped and the frequency match
         if (!mapped[physical] && rf_zmq_rx_match_freq(&handler->receiver[physical], handler->rx_freq_mhz[logical])) {
           // Not mapped and matched frequency with receiver
-          buffers[physical] = (cf_t*)data[logical];
+          buffers[physical] = data[logical];
           mapped[physical]  = true;
           unmatched         = false;
           break;
@@ -664,7 +683,11 @@ int rf_zmq_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool bl
 
       // If no matching frequency found; set data to zeros
       if (unmatched) {
-        srsran_vec_zero(data[logical], nsamples);
+        if (sc16) {
+          srsran_vec_i16_zero((int16_t*)data[logical], 2 * nsamples);
+        } else {
+          srsran_vec_zero(data[logical], nsamples);
+        }
       }
     }
     pthread_mutex_unlock(&handler->rx_config_mutex);
@@ -728,12 +751,14 @@ int rf_zmq_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool bl
 
       // Iterate channels
       for (uint32_t i = 0; i < handler->nof_channels; i++) {
-        cf_t* ptr = (decim_factor != 1 || buffers[i] == NULL) ? handler->buffer_decimation[i] : buffers[i];
+        void* ptr = (decim_factor != 1 || buffers[i] == NULL) ? handler->buffer_decimation[i] : buffers[i];
 
         // Completed condition
         if (count[i] < nsamples_baserate && rf_zmq_rx_is_running(&handler->receiver[i])) {
           // Keep receiving
-          int32_t n = rf_zmq_rx_baseband(&handler->receiver[i], &ptr[count[i]], nsamples_baserate);
+          rf_zmq_rx_t* rx = &handler->receiver[i];
+          int32_t      n  = sc16 ? rf_zmq_rx_baseband_sc16(rx, (int16_t*)ptr + 2 * count[i], nsamples_baserate)
+                                 : rf_zmq_rx_baseband(rx, (cf_t*)ptr + count[i], nsamples_baserate);
 #if ZMQ_MONITOR
           // handle socket events
           int event = rf_zmq_rx_get_monitor_event(handler->receiver[i].socket_monitor, NULL, NULL);
@@ -785,8 +810,23 @@ int rf_zmq_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool bl
     if (decim_factor != 1) {
       for (uint32_t c = 0; c < handler->nof_channels; c++) {
         // skip if buffer is not available
-        if (buffers[c]) {
-          cf_t* dst = buffers[c];
+        if (buffers[c] && sc16) {
+          int16_t* dst = (int16_t*)buffers[c];
+          int16_t* ptr = (int16_t*)handler->buffer_decimation[c];
+
+          for (uint32_t i = 0, n = 0; i < nsamples; i++) {
+            // Averaging decimation, the integer samples can not hold the sum so divide here
+            int32_t avg_re = 0;
+            int32_t avg_im = 0;
+            for (int j = 0; j < decim_factor; j++, n++) {
+              avg_re += ptr[2 * n];
+              avg_im += ptr[2 * n + 1];
+            }
+            dst[2 * i]     = (int16_t)(avg_re / (int32_t)decim_factor);
+            dst[2 * i + 1] = (int16_t)(avg_im / (int32_t)decim_factor);
+          }
+        } else if (buffers[c]) {
+          cf_t* dst = (cf_t*)buffers[c];
           cf_t* ptr = handler->buffer_decimation[c];
 
           for (uint32_t i = 0, n = 0; i < nsamples; i++) {
@@ -811,13 +851,18 @@ int rf_zmq_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool bl
     pthread_mutex_lock(&handler->rx_gain_mutex);
     float scale = srsran_convert_dB_to_amplitude(handler->rx_gain);
     pthread_mutex_unlock(&handler->rx_gain_mutex);
-    // scale shall also incorporate decim_factor
-    if (decim_factor > 0) {
-      scale = scale / decim_factor;
-    }
-    for (uint32_t c = 0; c < handler->nof_channels; c++) {
-      if (buffers[c]) {
-        srsran_vec_sc_prod_cfc(buffers[c], scale, buffers[c], nsamples);
+    if (sc16) {
+      // Leave the integer samples untouched and report the value of the unitary amplitude instead
+      *sc16_scale = (float)INT16_MAX / scale;
+    } else {
+      // scale shall also incorporate decim_factor
+      if (decim_factor > 0) {
+        scale = scale / decim_factor;
+      }
+      for (uint32_t c = 0; c < handler->nof_channels; c++) {
+        if (buffers[c]) {
+          srsran_vec_sc_prod_cfc((cf_t*)buffers[c], scale, (cf_t*)buffers[c], nsamples);
+        }
       }
     }
 
@@ -832,6 +877,26 @@ clean_exit:
   return ret;
 }
 
+int rf_zmq_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool blocking, time_t* secs, double* frac_secs)
+{
+  return rf_zmq_recv_multi(h, data, nsamples, secs, frac_secs, NULL);
+}
+
+int rf_zmq_recv_with_time_multi_sc16(void*    h,
+                                     void**   data,
+                                     uint32_t nsamples,
+                                     bool     blocking,
+                                     time_t*  secs,
+                                     double*  frac_secs,
+                                     float*   scale)
+{
+  if (scale == NULL || !rf_zmq_has_rx_sc16(h)) {
+    return SRSRAN_ERROR;
+  }
+  *scale = (float)INT16_MAX;
+  return rf_zmq_recv_multi(h, data, nsamples, secs, frac_secs, scale);
+}
+
 int rf_zmq_send_timed(void*  h,
                       void*  data,
                       int    nsamples,
@@ -1022,7 +1087,9 @@ rf_dev_t srsran_rf_dev_zmq = {"zmq",
                               rf_zmq_recv_with_time,
                               rf_zmq_recv_with_time_multi,
                               rf_zmq_send_timed,
-                              .srsran_rf_send_timed_multi = rf_zmq_send_timed_multi};
+                              .srsran_rf_send_timed_multi          = rf_zmq_send_timed_multi,
+                              .srsran_rf_has_rx_sc16               = rf_zmq_has_rx_sc16,
+                              .srsran_rf_recv_with_time_multi_sc16 = rf_zmq_recv_with_time_multi_sc16};
 
 #ifdef ENABLE_RF_PLUGINS
 int register_plugin(rf_dev_t** rf_api)
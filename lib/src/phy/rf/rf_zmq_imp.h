@@ -76,6 +76,16 @@ rf_zmq_recv_with_time(void* h, void* data, uint32_t nsamples, bool blocking, tim
 SRSRAN_API int
 rf_zmq_recv_with_time_multi(void* h, void** data, uint32_t nsamples, bool blocking, time_t* secs, double* frac_secs);
 
+SRSRAN_API bool rf_zmq_has_rx_sc16(void* h);
+
+SRSRAN_API int rf_zmq_recv_with_time_multi_sc16(void*    h,
+                                                void**   data,
+                                                uint32_t nsamples,
+                                                bool     blocking,
+                                                time_t*  secs,
+                                                double*  frac_secs,
+                                                float*   scale);
+
 SRSRAN_API double rf_zmq_set_tx_srate(void* h, double freq);
 
 SRSRAN_API int rf_zmq_set_tx_gain(void* h, double gain);
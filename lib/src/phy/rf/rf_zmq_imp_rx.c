@@ -207,15 +207,9 @@ clean_exit:
   return ret;
 }
 
-int rf_zmq_rx_baseband(rf_zmq_rx_t* q, cf_t* buffer, uint32_t nsamples)
+// Applies the pending sample offset and reads nsamples of sample_sz bytes from the ring buffer into dst_buffer
+static int rf_zmq_rx_read(rf_zmq_rx_t* q, void* dst_buffer, uint32_t sample_sz, uint32_t nsamples)
 {
-  void*    dst_buffer = buffer;
-  uint32_t sample_sz  = sizeof(cf_t);
-  if (q->sample_format != ZMQ_TYPE_FC32) {
-    dst_buffer = q->temp_buffer_convert;
-    sample_sz  = 2 * sizeof(short);
-  }
-
   // If the read needs to be delayed
   while (q->sample_offset > 0) {
     uint32_t n_offset = SRSRAN_MIN(q->sample_offset, NBYTES2NSAMPLES(ZMQ_MAX_BUFFER_SIZE));
@@ -238,7 +232,19 @@ int rf_zmq_rx_baseband(rf_zmq_rx_t* q, cf_t* buffer, uint32_t nsamples)
     q->sample_offset += n_offset;
   }
 
-  int n = srsran_ringbuffer_read_timed(&q->ringbuffer, dst_buffer, sample_sz * nsamples, q->trx_timeout_ms);
+  return srsran_ringbuffer_read_timed(&q->ringbuffer, dst_buffer, sample_sz * nsamples, q->trx_timeout_ms);
+}
+
+int rf_zmq_rx_baseband(rf_zmq_rx_t* q, cf_t* buffer, uint32_t nsamples)
+{
+  void*    dst_buffer = buffer;
+  uint32_t sample_sz  = sizeof(cf_t);
+  if (q->sample_format != ZMQ_TYPE_FC32) {
+    dst_buffer = q->temp_buffer_convert;
+    sample_sz  = 2 * sizeof(short);
+  }
+
+  int n = rf_zmq_rx_read(q, dst_buffer, sample_sz, nsamples);
   if (n < 0) {
     return n;
   }
@@ -250,6 +256,15 @@ int rf_zmq_rx_baseband(rf_zmq_rx_t* q, cf_t* buffer, uint32_t nsamples)
   return n;
 }
 
+int rf_zmq_rx_baseband_sc16(rf_zmq_rx_t* q, int16_t* buffer, uint32_t nsamples)
+{
+  if (q->sample_format != ZMQ_TYPE_SC16) {
+    return SRSRAN_ERROR;
+  }
+
+  return rf_zmq_rx_read(q, buffer, 2 * sizeof(int16_t), nsamples);
+}
+
 bool rf_zmq_rx_match_freq(rf_zmq_rx_t* q, uint32_t freq_hz)
 {
   bool ret = false;
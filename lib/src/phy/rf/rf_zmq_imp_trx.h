@@ -123,6 +123,8 @@ SRSRAN_API int rf_zmq_rx_open(rf_zmq_rx_t* q, rf_zmq_opts_t opts, void* zmq_ctx,
 
 SRSRAN_API int rf_zmq_rx_baseband(rf_zmq_rx_t* q, cf_t* buffer, uint32_t nsamples);
 
+SRSRAN_API int rf_zmq_rx_baseband_sc16(rf_zmq_rx_t* q, int16_t* buffer, uint32_t nsamples);
+
 SRSRAN_API bool rf_zmq_rx_match_freq(rf_zmq_rx_t* q, uint32_t freq_hz);
 
 SRSRAN_API void rf_zmq_rx_close(rf_zmq_rx_t* q);
@@ -19,6 +19,7 @@
  *
  */
 
+#include <complex.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -31,6 +32,146 @@
 #include "srsran/phy/utils/vector_simd.h"
 #include <srsran/phy/utils/vector.h>
 
+// Boxcar decimation, each output sample is the sum of decim consecutive input samples. It is enough to keep the 62
+// PSSS subcarriers for the coarse search, the correlation peak only needs to land in the right decimated sample
+static void psss_decimate(const cf_t* input, cf_t* output, uint32_t decim, uint32_t nof_output)
+{
+  if (decim == 1) {
+    srsran_vec_cf_copy(output, input, nof_output);
+    return;
+  }
+  for (uint32_t i = 0; i < nof_output; i++) {
+    output[i] = srsran_vec_acc_cc(&input[i * decim], decim);
+  }
+}
+
+// Maximum of x in [start, end), clipped to [0, len)
+static float psss_max_range(const float* x, uint32_t len, int32_t start, int32_t end)
+{
+  start = SRSRAN_MAX(start, 0);
+  end   = SRSRAN_MIN(end, (int32_t)len);
+  if (end <= start) {
+    return 0.0f;
+  }
+  return x[start + srsran_vec_max_fi(&x[start], (uint32_t)(end - start))];
+}
+
+/*
+ * Checks the side peaks around the main correlation peak at pos:
+ *
+ *       |
+ *       |                              |
+ *       |                              |
+ *       |                 |            |            |
+ *       |...______________|____________|____________|______________... t (samples)
+ *                     side peak    main peak    side peak
+ *
+ * The two side peaks come from each PSSS symbol correlating with the other one. They must be within tol samples of
+ * pos -/+ dist, have about half the main peak value and be stronger than anything outside the three peaks, which
+ * extend symbol_sz / 2 samples on each side. Every maximum is searched on its own window, nothing is written.
+ */
+static bool psss_check_side_peaks(const float* corr, uint32_t len, uint32_t pos, uint32_t symbol_sz, uint32_t dist)
+{
+  const int32_t tol  = 1;
+  int32_t       p    = (int32_t)pos;
+  int32_t       d    = (int32_t)dist;
+  int32_t       half = (int32_t)symbol_sz / 2;
+
+  float side_1 = psss_max_range(corr, len, p - d - tol, p - d + tol + 1);
+  float side_2 = psss_max_range(corr, len, p + d - tol, p + d + tol + 1);
+
+  float others = psss_max_range(corr, len, 0, p - d - half);
+  others       = SRSRAN_MAX(others, psss_max_range(corr, len, p - d + half, p - half));
+  others       = SRSRAN_MAX(others, psss_max_range(corr, len, p + half, p + d - half));
+  others       = SRSRAN_MAX(others, psss_max_range(corr, len, p + d + half, (int32_t)len));
+  if (side_1 < others || side_2 < others) {
+    return false;
+  }
+
+  float threshold_above = corr[pos] / 2.0f * 1.4f;
+  float threshold_below = corr[pos] / 2.0f * 0.6f;
+  return side_1 <= threshold_above && side_2 <= threshold_above && side_1 >= threshold_below &&
+         side_2 >= threshold_below;
+}
+
+/*
+ * Full-rate correlation of the input against each of the two PSSS symbols, for a subframe starting at lag. Samples
+ * past the end of the subframe are zero padding.
+ */
+static void psss_corr_symbols(srsran_psss_t* q,
+                              uint32_t       N_id_2,
+                              const cf_t*    input,
+                              uint32_t       sf_n_samples,
+                              int32_t        lag,
+                              cf_t           corr[2])
+{
+  uint32_t symbol_len = q->psss_time_len / 2;
+  uint32_t start      = (uint32_t)((int32_t)q->psss_time_offset + lag);
+
+  for (uint32_t s = 0; s < 2; s++, start += symbol_len) {
+    uint32_t len = (start < sf_n_samples) ? SRSRAN_MIN(symbol_len, sf_n_samples - start) : 0;
+    corr[s]      = srsran_vec_dot_prod_conj_ccc(&input[start], &q->psss_time[N_id_2][s * symbol_len], len);
+  }
+}
+
+/*
+ * Full-rate correlation for every lag in [lag_min, lag_max], scaled as the output of a normalized FFT correlator two
+ * subframes long. Returns the best value, its lag and the correlation of each symbol there.
+ */
+static float psss_fine_search(srsran_psss_t* q,
+                              uint32_t       N_id_2,
+                              const cf_t*    input,
+                              uint32_t       sf_n_samples,
+                              int32_t        lag_min,
+                              int32_t        lag_max,
+                              int32_t*       lag,
+                              cf_t           corr[2])
+{
+  float norm = 1.0f / sqrtf(2.0f * (float)sf_n_samples);
+  float best = 0.0f;
+
+  // The first PSSS symbol must start within the input
+  lag_min = SRSRAN_MAX(lag_min, -(int32_t)q->psss_time_offset);
+  lag_max = SRSRAN_MIN(lag_max, (int32_t)sf_n_samples - (int32_t)q->psss_time_offset - 1);
+
+  for (int32_t n = lag_min; n <= lag_max; n++) {
+    cf_t c[2];
+    psss_corr_symbols(q, N_id_2, input, sf_n_samples, n, c);
+    float value = cabsf(c[0] + c[1]) * norm;
+    if (value > best) {
+      best    = value;
+      *lag    = n;
+      corr[0] = c[0];
+      corr[1] = c[1];
+    }
+  }
+
+  return best;
+}
+
+// Sets the CFO and the normalized correlation of the peak found by psss_fine_search()
+static void psss_set_peak_metrics(srsran_psss_t* q,
+                                  uint32_t       N_id_2,
+                                  const cf_t*    input,
+                                  uint32_t       sf_n_samples,
+                                  int32_t        lag,
+                                  const cf_t     corr[2])
+{
+  uint32_t symbol_sz  = sf_n_samples / 15;
+  uint32_t symbol_len = q->psss_time_len / 2;
+  uint32_t start      = (uint32_t)((int32_t)q->psss_time_offset + lag);
+  uint32_t len        = SRSRAN_MIN(q->psss_time_len, sf_n_samples - start);
+
+  // Both symbols carry the same sequence, the phase between them only depends on the frequency offset
+  q->cfo = cargf(corr[1] * conjf(corr[0])) / (2.0f * (float)M_PI) * (float)symbol_sz / (float)symbol_len;
+
+  float energy_input   = crealf(srsran_vec_dot_prod_conj_ccc(&input[start], &input[start], len));
+  float energy_replica = crealf(srsran_vec_dot_prod_conj_ccc(q->psss_time[N_id_2], q->psss_time[N_id_2], len));
+  float energy         = sqrtf(energy_input * energy_replica);
+
+  q->corr_peak_norm = isnormal(energy) ? cabsf(corr[0] + corr[1]) / energy : 0.0f;
+}
+
 // Generates the sidelink sequences that are used to detect PSSS
 int srsran_psss_init(srsran_psss_t* q, uint32_t nof_prb, srsran_cp_t cp)
 {
@@ -48,8 +189,16 @@ int srsran_psss_init(srsran_psss_t* q, uint32_t nof_prb, srsran_cp_t cp)
     /*
      * Initialization of buffers for find PSSS operations
      */
-    uint32_t sf_n_samples = srsran_symbol_sz(nof_prb) * 15;
-    uint32_t fft_size     = sf_n_samples * 2;
+    uint32_t symbol_sz    = (uint32_t)srsran_symbol_sz(nof_prb);
+    uint32_t sf_n_samples = symbol_sz * 15;
+    if (symbol_sz < SRSRAN_PSSS_COARSE_SYMBOL_SZ || symbol_sz % SRSRAN_PSSS_COARSE_SYMBOL_SZ != 0) {
+      ERROR("Unsupported symbol size %d", symbol_sz);
+      return SRSRAN_ERROR;
+    }
+    q->decim = symbol_sz / SRSRAN_PSSS_COARSE_SYMBOL_SZ;
+
+    uint32_t coarse_sf_n_samples = sf_n_samples / q->decim;
+    uint32_t fft_size            = coarse_sf_n_samples * 2;
 
     q->psss_sf_freq = srsran_vec_malloc(sizeof(cf_t*) * 2);
     if (!q->psss_sf_freq) {
@@ -71,9 +220,31 @@ int srsran_psss_init(srsran_psss_t* q, uint32_t nof_prb, srsran_cp_t cp)
       return SRSRAN_ERROR;
     }
 
+    // The PSSS is sent in symbols 1 and 2 (normal CP) or 0 and 1 (extended CP), both with the same CP length
+    q->psss_time_offset = SRSRAN_CP_ISNORM(cp) ? symbol_sz + SRSRAN_CP_LEN_NORM(0, symbol_sz) : 0;
+    q->psss_time_len    = 2 * (symbol_sz + SRSRAN_CP_SZ(symbol_sz, cp));
+    for (uint32_t i = 0; i < 2; ++i) {
+      q->psss_time[i] = srsran_vec_cf_malloc(q->psss_time_len);
+      if (!q->psss_time[i]) {
+        return SRSRAN_ERROR;
+      }
+    }
+
+    // Full-rate subframe, only needed to generate the replicas
+    uint32_t sf_n_re   = SRSRAN_CP_NSYMB(cp) * 2 * nof_prb * SRSRAN_NRE;
+    cf_t*    sf_freq   = srsran_vec_cf_malloc(sf_n_re);
+    cf_t*    sf_time   = srsran_vec_cf_malloc(sf_n_samples);
+    if (!sf_freq || !sf_time) {
+      free(sf_freq);
+      free(sf_time);
+      return SRSRAN_ERROR;
+    }
+
     srsran_ofdm_t psss_tx;
-    if (srsran_ofdm_tx_init(&psss_tx, cp, q->input_pad_freq, q->input_pad_time, nof_prb)) {
+    if (srsran_ofdm_tx_init(&psss_tx, cp, sf_freq, sf_time, nof_prb)) {
       printf("Error creating iFFT object\n");
+      free(sf_freq);
+      free(sf_time);
       return SRSRAN_ERROR;
     }
     srsran_ofdm_set_normalize(&psss_tx, true);
@@ -81,6 +252,9 @@ int srsran_psss_init(srsran_psss_t* q, uint32_t nof_prb, srsran_cp_t cp)
 
     srsran_dft_plan_t plan;
     if (srsran_dft_plan(&plan, fft_size, SRSRAN_DFT_FORWARD, SRSRAN_DFT_COMPLEX)) {
+      srsran_ofdm_tx_free(&psss_tx);
+      free(sf_freq);
+      free(sf_time);
       return SRSRAN_ERROR;
     }
     srsran_dft_plan_set_norm(&plan, true);
@@ -88,18 +262,26 @@ int srsran_psss_init(srsran_psss_t* q, uint32_t nof_prb, srsran_cp_t cp)
 
     // Create empty subframes with only PSSS
     for (uint32_t N_id_2 = 0; N_id_2 < 2; ++N_id_2) {
-      srsran_vec_cf_zero(q->input_pad_freq, fft_size);
-      srsran_vec_cf_zero(q->input_pad_time, fft_size);
+      srsran_vec_cf_zero(sf_freq, sf_n_re);
+      srsran_vec_cf_zero(sf_time, sf_n_samples);
 
-      srsran_psss_put_sf_buffer(q->psss_signal[N_id_2], q->input_pad_freq, nof_prb, cp);
+      srsran_psss_put_sf_buffer(q->psss_signal[N_id_2], sf_freq, nof_prb, cp);
       srsran_ofdm_tx_sf(&psss_tx);
 
+      srsran_vec_cf_copy(q->psss_time[N_id_2], &sf_time[q->psss_time_offset], q->psss_time_len);
+
+      // The coarse replica goes through the same decimation as the input
+      srsran_vec_cf_zero(q->input_pad_time, fft_size);
+      psss_decimate(sf_time, q->input_pad_time, q->decim, coarse_sf_n_samples);
+
       srsran_dft_run_c(&plan, q->input_pad_time, q->psss_sf_freq[N_id_2]);
       srsran_vec_conj_cc(q->psss_sf_freq[N_id_2], q->psss_sf_freq[N_id_2], fft_size);
     }
 
     srsran_dft_plan_free(&plan);
     srsran_ofdm_tx_free(&psss_tx);
+    free(sf_freq);
+    free(sf_time);
 
     q->dot_prod_output = srsran_vec_cf_malloc(fft_size);
     if (!q->dot_prod_output) {
@@ -188,6 +370,9 @@ void srsran_psss_put_sf_buffer(cf_t* psss_signal, cf_t* sf_buffer, uint32_t nof_
  * The value of the correlation is stored in corr_peak_value.
  * The subframe starts at corr_peak_pos - sf_n_samples.
  *
+ * The main and side peaks are first looked for in the decimated correlation of the whole subframe, the full-rate
+ * correlation is then only computed within one decimated sample of the coarse peak.
+ *
  * * Input buffer must be subframe_size long.
  */
 int srsran_psss_find(srsran_psss_t* q, cf_t* input, uint32_t nof_prb, srsran_cp_t cp)
@@ -199,14 +384,19 @@ int srsran_psss_find(srsran_psss_t* q, cf_t* input, uint32_t nof_prb, srsran_cp_
   // One array for each N_id_2
   float    corr_peak_value[2] = {};
   uint32_t corr_peak_pos[2]   = {};
+  cf_t     corr[2][2]         = {};
 
   uint32_t sf_n_samples = (uint32_t)SRSRAN_SF_LEN_PRB(nof_prb);
-  uint32_t fft_size     = sf_n_samples * 2;
+  uint32_t symbol_sz    = (uint32_t)srsran_symbol_sz(nof_prb);
+  uint32_t side_dist    = symbol_sz + SRSRAN_CP_SZ(symbol_sz, cp);
+  uint32_t max_lag      = sf_n_samples - symbol_sz;
 
-  srsran_vec_cf_zero(q->input_pad_freq, fft_size);
-  srsran_vec_cf_zero(q->input_pad_time, fft_size);
+  uint32_t decim               = q->decim;
+  uint32_t coarse_sf_n_samples = sf_n_samples / decim;
+  uint32_t fft_size            = coarse_sf_n_samples * 2;
 
-  memcpy(q->input_pad_time, input, sizeof(cf_t) * sf_n_samples);
+  psss_decimate(input, q->input_pad_time, decim, coarse_sf_n_samples);
+  srsran_vec_cf_zero(&q->input_pad_time[coarse_sf_n_samples], coarse_sf_n_samples);
 
   srsran_dft_run_c(&q->plan_input, q->input_pad_time, q->input_pad_freq);
 
@@ -217,90 +407,71 @@ int srsran_psss_find(srsran_psss_t* q, cf_t* input, uint32_t nof_prb, srsran_cp_
     // IFFT
     srsran_dft_run_c(&q->plan_out, q->dot_prod_output, q->dot_prod_output_time);
 
-    srsran_vec_cf_zero(q->shifted_output, fft_size);
     srsran_vec_cf_copy(q->shifted_output, &q->dot_prod_output_time[fft_size / 2], fft_size / 2);
     srsran_vec_cf_copy(&q->shifted_output[fft_size / 2], q->dot_prod_output_time, fft_size / 2);
 
-    // Peak detection
-    q->corr_peak_pos = -1;
-    srsran_vec_f_zero(q->shifted_output_abs, fft_size);
     srsran_vec_abs_cf_simd(q->shifted_output, q->shifted_output_abs, fft_size);
 
-    // Experimental Validation
-    uint32_t symbol_sz = (uint32_t)srsran_symbol_sz(nof_prb);
-    int      cp_len    = SRSRAN_CP_SZ(symbol_sz, cp);
-
-    // Correlation output peaks:
-    //
-    //       |
-    //       |                              |
-    //       |                              |
-    //       |                 |            |            |
-    //       |...______________|____________|____________|______________... t (samples)
-    //                     side peak    main peak    side peak
-
-    // Find the main peak
-    q->corr_peak_pos   = srsran_vec_max_fi(q->shifted_output_abs, fft_size);
-    q->corr_peak_value = q->shifted_output_abs[q->corr_peak_pos];
-    if ((q->corr_peak_pos < sf_n_samples) || (q->corr_peak_pos > fft_size - symbol_sz)) {
-      q->corr_peak_pos = -1;
-      continue;
-    }
-    srsran_vec_f_zero(&q->shifted_output_abs[q->corr_peak_pos - (symbol_sz / 2)], symbol_sz);
-
-    // Find the first side peak
-    uint32_t peak_1_pos   = srsran_vec_max_fi(q->shifted_output_abs, fft_size);
-    float    peak_1_value = q->shifted_output_abs[peak_1_pos];
-    if ((peak_1_pos >= (q->corr_peak_pos - (symbol_sz + cp_len) - 2)) &&
-        (peak_1_pos <= (q->corr_peak_pos - (symbol_sz + cp_len) + 2))) {
-      ; // Do nothing
-    } else if ((peak_1_pos >= (q->corr_peak_pos + (symbol_sz + cp_len) - 2)) &&
-               (peak_1_pos <= (q->corr_peak_pos + (symbol_sz + cp_len) + 2))) {
-      ; // Do nothing
-    } else {
-      q->corr_peak_pos = -1;
+    // Coarse main peak, the subframe must start within the input buffer
+    uint32_t coarse_pos = srsran_vec_max_fi(q->shifted_output_abs, fft_size);
+    if ((coarse_pos < coarse_sf_n_samples) || (coarse_pos > fft_size - SRSRAN_PSSS_COARSE_SYMBOL_SZ)) {
       continue;
     }
-    srsran_vec_f_zero(&q->shifted_output_abs[peak_1_pos - (symbol_sz / 2)], symbol_sz);
-
-    // Find the second side peak
-    uint32_t peak_2_pos   = srsran_vec_max_fi(q->shifted_output_abs, fft_size);
-    float    peak_2_value = q->shifted_output_abs[peak_2_pos];
-    if ((peak_2_pos >= (q->corr_peak_pos - (symbol_sz + cp_len) - 2)) &&
-        (peak_2_pos <= (q->corr_peak_pos - (symbol_sz + cp_len) + 2))) {
-      ; // Do nothing
-    } else if ((peak_2_pos >= (q->corr_peak_pos + (symbol_sz + cp_len) - 2)) &&
-               (peak_2_pos <= (q->corr_peak_pos + (symbol_sz + cp_len) + 2))) {
-      ; // Do nothing
-    } else {
-      q->corr_peak_pos = -1;
+    if (!psss_check_side_peaks(
+            q->shifted_output_abs, fft_size, coarse_pos, SRSRAN_PSSS_COARSE_SYMBOL_SZ, side_dist / decim)) {
       continue;
     }
-    srsran_vec_f_zero(&q->shifted_output_abs[peak_2_pos - (symbol_sz / 2)], symbol_sz);
 
-    float threshold_above = q->corr_peak_value / 2.0f * 1.4f;
-    if ((peak_1_value > threshold_above) || (peak_2_value > threshold_above)) {
-      q->corr_peak_pos = -1;
-      continue;
-    }
-
-    float threshold_below = q->corr_peak_value / 2.0f * 0.6f;
-    if ((peak_1_value < threshold_below) || (peak_2_value < threshold_below)) {
-      q->corr_peak_pos = -1;
-      continue;
-    }
+    // Fine peak
+    uint32_t coarse_lag = (coarse_pos - coarse_sf_n_samples) * decim;
+    int32_t  lag_min    = (int32_t)SRSRAN_MAX(coarse_lag, decim) - (int32_t)decim;
+    int32_t  lag_max    = (int32_t)SRSRAN_MIN(coarse_lag + decim, max_lag);
+    int32_t  lag        = 0;
 
-    corr_peak_value[i] = q->corr_peak_value;
-    corr_peak_pos[i]   = (uint32_t)q->corr_peak_pos;
+    corr_peak_value[i] = psss_fine_search(q, i, input, sf_n_samples, lag_min, lag_max, &lag, corr[i]);
+    corr_peak_pos[i]   = sf_n_samples + lag;
   }
 
   q->N_id_2 = srsran_vec_max_fi(corr_peak_value, 2);
   if (corr_peak_value[q->N_id_2] == 0.0f) {
+    q->corr_peak_pos = -1;
     return SRSRAN_ERROR;
   }
 
-  q->corr_peak_pos   = corr_peak_pos[q->N_id_2];
+  q->corr_peak_pos   = (int32_t)corr_peak_pos[q->N_id_2];
   q->corr_peak_value = corr_peak_value[q->N_id_2];
+  psss_set_peak_metrics(
+      q, q->N_id_2, input, sf_n_samples, q->corr_peak_pos - (int32_t)sf_n_samples, corr[q->N_id_2]);
+
+  return SRSRAN_SUCCESS;
+}
+
+/** Tracks an already found PSSS.
+ * Only the full-rate correlation for the given N_id_2 is computed, for subframe starts within window samples of the
+ * beginning of the input. The outputs follow srsran_psss_find(), corr_peak_pos - sf_n_samples may be negative. With
+ * extended CP the PSSS starts the subframe, so early subframes can not be seen.
+ *
+ * * Input buffer must be subframe_size long.
+ */
+int srsran_psss_track(srsran_psss_t* q, cf_t* input, uint32_t nof_prb, uint32_t N_id_2, uint32_t window)
+{
+  if (q == NULL || input == NULL || N_id_2 > 1) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  uint32_t sf_n_samples = (uint32_t)SRSRAN_SF_LEN_PRB(nof_prb);
+  int32_t  lag          = 0;
+  cf_t     corr[2]      = {};
+
+  float value = psss_fine_search(q, N_id_2, input, sf_n_samples, -(int32_t)window, (int32_t)window, &lag, corr);
+  if (value == 0.0f) {
+    return SRSRAN_ERROR;
+  }
+
+  q->N_id_2          = N_id_2;
+  q->corr_peak_pos   = (int32_t)sf_n_samples + lag;
+  q->corr_peak_value = value;
+  psss_set_peak_metrics(q, N_id_2, input, sf_n_samples, lag, corr);
 
   return SRSRAN_SUCCESS;
 }
@@ -329,6 +500,11 @@ void srsran_psss_free(srsran_psss_t* q)
     if (q->input_pad_time) {
       free(q->input_pad_time);
     }
+    for (int N_id_2 = 0; N_id_2 < 2; ++N_id_2) {
+      if (q->psss_time[N_id_2]) {
+        free(q->psss_time[N_id_2]);
+      }
+    }
     if (q->psss_sf_freq) {
       for (int N_id_2 = 0; N_id_2 < 2; ++N_id_2) {
         if (q->psss_sf_freq[N_id_2]) {
@@ -200,6 +200,16 @@ void srsran_ssss_put_sf_buffer(float* ssss_signal, cf_t* sf_buffer, uint32_t nof
   }
 }
 
+// Zeroes width samples centered at pos, side peaks can be close to the edges of the correlation
+static void ssss_zero_peak(float* x, uint32_t len, uint32_t pos, uint32_t width)
+{
+  uint32_t start = (pos > width / 2) ? pos - width / 2 : 0;
+  uint32_t end   = SRSRAN_MIN(pos + (width - width / 2), len);
+  if (end > start) {
+    srsran_vec_f_zero(&x[start], end - start);
+  }
+}
+
 /**
  * Performs SSSS correlation.
  * Returns the index of the SSSS correlation peak in a subframe.
@@ -274,7 +284,7 @@ int srsran_ssss_find(srsran_ssss_t* q, cf_t* input, uint32_t nof_prb, uint32_t N
       q->corr_peak_pos = -1;
       continue;
     }
-    srsran_vec_f_zero(&q->shifted_output_abs[peak_1_pos - ((cp_len - 2) / 2)], cp_len - 2);
+    ssss_zero_peak(q->shifted_output_abs, ssss_n_samples, peak_1_pos, cp_len - 2);
 
     // Find the second side peak
     uint32_t peak_2_pos   = srsran_vec_max_fi(q->shifted_output_abs, ssss_n_samples);
@@ -289,7 +299,7 @@ int srsran_ssss_find(srsran_ssss_t* q, cf_t* input, uint32_t nof_prb, uint32_t N
       q->corr_peak_pos = -1;
       continue;
     }
-    srsran_vec_f_zero(&q->shifted_output_abs[peak_2_pos - ((cp_len - 2) / 2)], cp_len - 2);
+    ssss_zero_peak(q->shifted_output_abs, ssss_n_samples, peak_2_pos, cp_len - 2);
 
     float threshold_above = q->corr_peak_value / 2.0 * 1.6;
     if ((peak_1_value > threshold_above) || (peak_2_value > threshold_above)) {
@@ -0,0 +1,269 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "srsran/phy/channel/ch_awgn.h"
+#include "srsran/phy/phch/pssch.h"
+#include "srsran/phy/ue/ue_sl_harq.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+#include "srsran/support/srsran_test.h"
+
+#define TIME_GAP 4
+
+static srsran_cell_sl_t cell    = {.nof_prb = 25, .N_sl_id = 0, .tm = SRSRAN_SIDELINK_TM4, .cp = SRSRAN_CP_NORM};
+static uint32_t         mcs_idx = 12;
+static float            snr_db  = 4.0f;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [pmsv]\n", prog);
+  printf("\t-p nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-m mcs_idx [Default %d]\n", mcs_idx);
+  printf("\t-s SNR in dB, a single transmission must fail and both combined must pass [Default %.1f]\n", snr_db);
+  printf("\t-v [set srsran_verbose to debug, default none]\n");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "pmsv")) != -1) {
+    switch (opt) {
+      case 'p':
+        cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        mcs_idx = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+/// Returns the N_x_id of an SCI, as computed by the PSCCH encoder
+static uint32_t sci_N_x_id(srsran_sci_t* sci)
+{
+  srsran_crc_t crc = {};
+  uint8_t      bits[SRSRAN_SCI_MAX_LEN + SRSRAN_SCI_CRC_LEN];
+  srsran_crc_init(&crc, 0x11021, SRSRAN_SCI_CRC_LEN);
+  srsran_sci_format1_pack(sci, bits);
+  return srsran_crc_checksum(&crc, bits, (int)sci->sci_len);
+}
+
+static void add_noise(const cf_t* in, cf_t* out, uint32_t len)
+{
+  srsran_ch_awgn_c(in, out, srsran_convert_dB_to_power(-snr_db), len);
+}
+
+static int test_combining(srsran_ue_sl_harq_t* harq, srsran_sci_t* sci)
+{
+  srsran_sl_comm_resource_pool_t pool = {};
+  TESTASSERT(srsran_sl_comm_resource_pool_get_default_config(&pool, cell) == SRSRAN_SUCCESS);
+
+  srsran_pssch_t pssch_tx = {};
+  srsran_pssch_t pssch_rx = {};
+  TESTASSERT(srsran_pssch_init(&pssch_tx, &cell, &pool) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_pssch_init(&pssch_rx, &cell, &pool) == SRSRAN_SUCCESS);
+
+  uint32_t sf_n_re  = SRSRAN_SF_LEN_RE(cell.nof_prb, cell.cp);
+  cf_t*    sf_tx[2] = {srsran_vec_cf_malloc(sf_n_re), srsran_vec_cf_malloc(sf_n_re)};
+  cf_t*    sf_rx    = srsran_vec_cf_malloc(sf_n_re);
+  uint8_t* tb       = srsran_vec_u8_malloc(SRSRAN_SL_SCH_MAX_TB_LEN);
+  uint8_t* tb_rx    = srsran_vec_u8_malloc(SRSRAN_SL_SCH_MAX_TB_LEN);
+  TESTASSERT(sf_tx[0] != NULL && sf_tx[1] != NULL && sf_rx != NULL && tb != NULL && tb_rx != NULL);
+
+  srsran_random_t random_gen = srsran_random_init(0x5eed);
+  uint32_t        tti        = 10235; // The retransmission wraps around the TTI counter
+
+  // Initial transmission and retransmission of the same TB
+  sci->mcs_idx        = mcs_idx;
+  sci->time_gap       = TIME_GAP;
+  sci->retransmission = false;
+  uint32_t N_x_id[2]  = {sci_N_x_id(sci), 0};
+  sci->retransmission = true;
+  N_x_id[1]           = sci_N_x_id(sci);
+  TESTASSERT(N_x_id[0] != N_x_id[1]);
+  TESTASSERT(srsran_ue_sl_harq_initial_N_x_id(harq, sci) == N_x_id[0]);
+
+  uint32_t           nof_prb   = srsran_dft_precoding_get_valid_prb(cell.nof_prb);
+  uint32_t           tti_tx[2] = {tti, (tti + TIME_GAP) % 10240};
+  srsran_pssch_cfg_t cfg[2]    = {{0, nof_prb, N_x_id[0], mcs_idx, 0, tti_tx[0] % 10, NULL},
+                                  {0, nof_prb, N_x_id[1], mcs_idx, 1, tti_tx[1] % 10, NULL}};
+
+  TESTASSERT(srsran_pssch_set_cfg(&pssch_tx, cfg[0]) == SRSRAN_SUCCESS);
+  uint32_t tbs = pssch_tx.sl_sch_tb_len;
+  for (uint32_t i = 0; i < tbs; i++) {
+    tb[i] = (uint8_t)srsran_random_uniform_int_dist(random_gen, 0, 1);
+  }
+  for (uint32_t i = 0; i < 2; i++) {
+    srsran_vec_cf_zero(sf_tx[i], sf_n_re);
+    TESTASSERT(srsran_pssch_set_cfg(&pssch_tx, cfg[i]) == SRSRAN_SUCCESS);
+    TESTASSERT(srsran_pssch_encode(&pssch_tx, tb, tbs, sf_tx[i]) == SRSRAN_SUCCESS);
+  }
+
+  // Neither transmission can be decoded on its own
+  for (uint32_t i = 0; i < 2; i++) {
+    add_noise(sf_tx[i], sf_rx, sf_n_re);
+    TESTASSERT(srsran_pssch_set_cfg(&pssch_rx, cfg[i]) == SRSRAN_SUCCESS);
+    TESTASSERT(srsran_pssch_decode(&pssch_rx, sf_rx, tb_rx, SRSRAN_SL_SCH_MAX_TB_LEN) != SRSRAN_SUCCESS);
+  }
+
+  // The initial transmission fails and leaves its soft bits in the store
+  sci->retransmission = false;
+  add_noise(sf_tx[0], sf_rx, sf_n_re);
+  cfg[0].softbuffer = srsran_ue_sl_harq_acquire(harq, sci, N_x_id[0], tti_tx[0], tbs);
+  TESTASSERT(cfg[0].softbuffer != NULL);
+  TESTASSERT(srsran_pssch_set_cfg(&pssch_rx, cfg[0]) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_pssch_decode(&pssch_rx, sf_rx, tb_rx, SRSRAN_SL_SCH_MAX_TB_LEN) != SRSRAN_SUCCESS);
+  srsran_ue_sl_harq_release(harq, cfg[0].softbuffer, false);
+
+  // The retransmission is combined with it
+  sci->retransmission = true;
+  add_noise(sf_tx[1], sf_rx, sf_n_re);
+  cfg[1].softbuffer = srsran_ue_sl_harq_acquire(harq, sci, N_x_id[1], tti_tx[1], tbs);
+  TESTASSERT(cfg[1].softbuffer == cfg[0].softbuffer);
+  TESTASSERT(srsran_pssch_set_cfg(&pssch_rx, cfg[1]) == SRSRAN_SUCCESS);
+  TESTASSERT(srsran_pssch_decode(&pssch_rx, sf_rx, tb_rx, SRSRAN_SL_SCH_MAX_TB_LEN) == SRSRAN_SUCCESS);
+  TESTASSERT(memcmp(tb, tb_rx, tbs) == 0);
+  srsran_ue_sl_harq_release(harq, cfg[1].softbuffer, true);
+  TESTASSERT(harq->nof_combined == 1);
+
+  printf("TB of %d bits decoded after combining at %.1f dB SNR\n", tbs, snr_db);
+
+  srsran_random_free(random_gen);
+  free(sf_tx[0]);
+  free(sf_tx[1]);
+  free(sf_rx);
+  free(tb);
+  free(tb_rx);
+  srsran_pssch_free(&pssch_tx);
+  srsran_pssch_free(&pssch_rx);
+
+  return SRSRAN_SUCCESS;
+}
+
+static int test_store(srsran_ue_sl_harq_t* harq, srsran_sci_t* sci)
+{
+  uint32_t                tbs = 1000;
+  srsran_softbuffer_rx_t* sb  = NULL;
+
+  // No retransmission announced
+  sci->retransmission = false;
+  sci->time_gap       = 0;
+  TESTASSERT(srsran_ue_sl_harq_acquire(harq, sci, sci_N_x_id(sci), 0, tbs) == NULL);
+
+  // Retransmission in a different subframe than announced
+  sci->time_gap = 2;
+  sci->mcs_idx  = 1;
+  sb            = srsran_ue_sl_harq_acquire(harq, sci, sci_N_x_id(sci), 100, tbs);
+  TESTASSERT(sb != NULL);
+  srsran_ue_sl_harq_release(harq, sb, false);
+  sci->retransmission = true;
+  TESTASSERT(srsran_ue_sl_harq_acquire(harq, sci, sci_N_x_id(sci), 101, tbs) == NULL);
+
+  // The retransmission is not received, the buffer expires after its subframe
+  sci->retransmission = false;
+  sci->mcs_idx        = 2;
+  sb                  = srsran_ue_sl_harq_acquire(harq, sci, sci_N_x_id(sci), 103, tbs);
+  TESTASSERT(sb != NULL);
+  TESTASSERT(harq->nof_expired == 1);
+  srsran_ue_sl_harq_release(harq, sb, false);
+
+  // The retransmission of a TB decoded in its initial transmission is redundant, not missed
+  uint64_t nof_missed = harq->nof_missed;
+  sci->mcs_idx        = 3;
+  sb                  = srsran_ue_sl_harq_acquire(harq, sci, sci_N_x_id(sci), 110, tbs);
+  TESTASSERT(sb != NULL);
+  srsran_ue_sl_harq_release(harq, sb, true);
+  sci->retransmission = true;
+  TESTASSERT(srsran_ue_sl_harq_acquire(harq, sci, sci_N_x_id(sci), 112, tbs) == NULL);
+  TESTASSERT(harq->nof_redundant == 1);
+  TESTASSERT(harq->nof_missed == nof_missed);
+
+  // The buffer of a decoded TB is reused first once all buffers are active, without an eviction
+  uint64_t nof_evicted = harq->nof_evicted;
+  sci->retransmission  = false;
+  for (uint32_t i = 0; i < harq->nof_buffers; i++) {
+    sci->mcs_idx = 10 + i;
+    sb           = srsran_ue_sl_harq_acquire(harq, sci, sci_N_x_id(sci), 114, tbs);
+    TESTASSERT(sb != NULL);
+    srsran_ue_sl_harq_release(harq, sb, i == harq->nof_buffers - 1);
+  }
+  srsran_softbuffer_rx_t* sb_decoded = sb;
+  sci->mcs_idx                       = 10 + harq->nof_buffers;
+  sb                                 = srsran_ue_sl_harq_acquire(harq, sci, sci_N_x_id(sci), 114, tbs);
+  TESTASSERT(sb == sb_decoded);
+  TESTASSERT(harq->nof_evicted == nof_evicted);
+  srsran_ue_sl_harq_release(harq, sb, false);
+
+  // Once all buffers are active the one expecting its retransmission first is reused
+  nof_evicted         = harq->nof_evicted;
+  sci->retransmission = false;
+  for (uint32_t i = 0; i < harq->nof_buffers + 1; i++) {
+    sci->mcs_idx = 4 + i;
+    sb           = srsran_ue_sl_harq_acquire(harq, sci, sci_N_x_id(sci), 120, tbs);
+    TESTASSERT(sb != NULL);
+    srsran_ue_sl_harq_release(harq, sb, false);
+  }
+  TESTASSERT(harq->nof_evicted == nof_evicted + 1);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srsran_sl_comm_resource_pool_t pool = {};
+  TESTASSERT(srsran_sl_comm_resource_pool_get_default_config(&pool, cell) == SRSRAN_SUCCESS);
+
+  srsran_sci_t sci = {};
+  TESTASSERT(srsran_sci_init(&sci, &cell, &pool) == SRSRAN_SUCCESS);
+  sci.priority        = 1;
+  sci.resource_reserv = 2;
+  sci.riv             = 0;
+
+  srsran_ue_sl_harq_t harq = {};
+  TESTASSERT(srsran_ue_sl_harq_init(&harq, cell.nof_prb, 4) == SRSRAN_SUCCESS);
+
+  TESTASSERT(test_combining(&harq, &sci) == SRSRAN_SUCCESS);
+  TESTASSERT(test_store(&harq, &sci) == SRSRAN_SUCCESS);
+
+  srsran_ue_sl_harq_free(&harq);
+  srsran_sci_free(&sci);
+
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
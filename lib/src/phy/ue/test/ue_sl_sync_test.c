@@ -0,0 +1,267 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <complex.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "srsran/phy/channel/ch_awgn.h"
+#include "srsran/phy/dft/ofdm.h"
+#include "srsran/phy/ue/ue_sl_sync.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+#include "srsran/support/srsran_test.h"
+
+static srsran_cell_sl_t cell         = {.nof_prb = 25, .N_sl_id = 170, .tm = SRSRAN_SIDELINK_TM4, .cp = SRSRAN_CP_NORM};
+static uint32_t         slss_period  = 40;
+static float            cfo_hz       = 500.0f;
+static float            snr_db       = 10.0f;
+static uint32_t         start_offset = 1234;
+static uint32_t         drift_period = 30; // One transmitter sample is skipped every drift_period subframes
+
+// Emulated SyncRef UE: an SLSS subframe every slss_period subframes and random QPSK in all the others
+typedef struct {
+  cf_t*           slss_sf;
+  cf_t*           data_sf;
+  uint32_t        sf_len;
+  uint64_t        tx_pos;      // Transmitter sample index of the next received sample
+  uint64_t        rx_pos;      // Number of received samples
+  uint64_t        last_tx_pos; // Transmitter sample index of the first sample of the last read
+  uint32_t        last_len;
+  bool            signal_on;
+  float           noise_var;
+  srsran_random_t random;
+} test_channel_t;
+
+static test_channel_t channel = {};
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [pctfsodv]\n", prog);
+  printf("\t-p nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-c N_sl_id [Default %d]\n", cell.N_sl_id);
+  printf("\t-t Sidelink transmission mode {1,2,3,4} [Default %d]\n", (cell.tm + 1));
+  printf("\t-f CFO in Hz [Default %.1f]\n", cfo_hz);
+  printf("\t-s SNR in dB [Default %.1f]\n", snr_db);
+  printf("\t-o Initial sample offset [Default %d]\n", start_offset);
+  printf("\t-d Subframes between transmitter sample slips, 0 disables [Default %d]\n", drift_period);
+  printf("\t-v [set srsran_verbose to debug, default none]\n");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "pctfsodv")) != -1) {
+    switch (opt) {
+      case 'p':
+        cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'c':
+        cell.N_sl_id = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 't':
+        cell.tm = (srsran_sl_tm_t)(strtol(argv[optind], NULL, 10) - 1);
+        break;
+      case 'f':
+        cfo_hz = strtof(argv[optind], NULL);
+        break;
+      case 's':
+        snr_db = strtof(argv[optind], NULL);
+        break;
+      case 'o':
+        start_offset = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'd':
+        drift_period = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static int channel_init(test_channel_t* ch)
+{
+  ch->sf_len = SRSRAN_SF_LEN_PRB(cell.nof_prb);
+  ch->random = srsran_random_init(0x5151);
+
+  uint32_t sf_n_re  = SRSRAN_CP_NSYMB(cell.cp) * SRSRAN_NRE * 2 * cell.nof_prb;
+  cf_t*    sf_freq  = srsran_vec_cf_malloc(sf_n_re);
+  cf_t*    sf_time  = srsran_vec_cf_malloc(ch->sf_len);
+  ch->slss_sf       = srsran_vec_cf_malloc(ch->sf_len);
+  ch->data_sf       = srsran_vec_cf_malloc(ch->sf_len);
+  srsran_psss_t psss = {};
+  srsran_ssss_t ssss = {};
+  srsran_ofdm_t ifft = {};
+  if (!sf_freq || !sf_time || !ch->slss_sf || !ch->data_sf || srsran_psss_init(&psss, cell.nof_prb, cell.cp) ||
+      srsran_ssss_init(&ssss, cell.nof_prb, cell.cp, cell.tm) ||
+      srsran_ofdm_tx_init(&ifft, cell.cp, sf_freq, sf_time, cell.nof_prb)) {
+    return SRSRAN_ERROR;
+  }
+  srsran_ofdm_set_normalize(&ifft, true);
+  srsran_ofdm_set_freq_shift(&ifft, 0.5);
+
+  srsran_vec_cf_zero(sf_freq, sf_n_re);
+  srsran_psss_put_sf_buffer(psss.psss_signal[cell.N_sl_id < 168 ? 0 : 1], sf_freq, cell.nof_prb, cell.cp);
+  srsran_ssss_put_sf_buffer(ssss.ssss_signal[cell.N_sl_id], sf_freq, cell.nof_prb, cell.cp);
+  srsran_ofdm_tx_sf(&ifft);
+  srsran_vec_cf_copy(ch->slss_sf, sf_time, ch->sf_len);
+
+  for (uint32_t i = 0; i < sf_n_re; i++) {
+    sf_freq[i] = (srsran_random_bool(ch->random, 0.5f) ? 1.0f : -1.0f) +
+                 _Complex_I * (srsran_random_bool(ch->random, 0.5f) ? 1.0f : -1.0f);
+  }
+  srsran_vec_sc_prod_cfc(sf_freq, (float)M_SQRT1_2, sf_freq, sf_n_re);
+  srsran_ofdm_tx_sf(&ifft);
+  srsran_vec_cf_copy(ch->data_sf, sf_time, ch->sf_len);
+
+  ch->noise_var = srsran_vec_avg_power_cf(ch->data_sf, ch->sf_len) * srsran_convert_dB_to_power(-snr_db);
+  ch->tx_pos    = start_offset;
+  ch->signal_on = true;
+
+  srsran_ofdm_tx_free(&ifft);
+  srsran_psss_free(&psss);
+  srsran_ssss_free(&ssss);
+  free(sf_freq);
+  free(sf_time);
+  return SRSRAN_SUCCESS;
+}
+
+static void channel_free(test_channel_t* ch)
+{
+  free(ch->slss_sf);
+  free(ch->data_sf);
+  srsran_random_free(ch->random);
+}
+
+static int channel_recv(void* obj, cf_t* data, uint32_t nsamples, srsran_timestamp_t* timestamp)
+{
+  test_channel_t* ch     = (test_channel_t*)obj;
+  uint64_t        sf_len = ch->sf_len;
+
+  ch->last_tx_pos = ch->tx_pos;
+  ch->last_len    = nsamples;
+  for (uint32_t i = 0; i < nsamples; i++) {
+    uint64_t sf_idx = ch->tx_pos / sf_len;
+    cf_t     x      = (sf_idx % slss_period == 0) ? ch->slss_sf[ch->tx_pos % sf_len] : ch->data_sf[ch->tx_pos % sf_len];
+    double   phase  = fmod((double)cfo_hz * (double)ch->rx_pos / (1000.0 * (double)sf_len), 1.0);
+    data[i]         = ch->signal_on ? x * cexpf(_Complex_I * 2.0f * (float)M_PI * (float)phase) : 0.0f;
+    ch->tx_pos++;
+    ch->rx_pos++;
+    if (drift_period && ch->rx_pos % (drift_period * sf_len) == 0) {
+      ch->tx_pos++;
+    }
+  }
+  srsran_ch_awgn_c(data, data, ch->noise_var, nsamples);
+
+  srsran_timestamp_init_uint64(timestamp, ch->rx_pos, 1000.0 * sf_len);
+  return (int)nsamples;
+}
+
+// Timing error of a received subframe, relative to the closest transmitter subframe boundary
+static int32_t channel_sf_error(test_channel_t* ch)
+{
+  int64_t sf_len = ch->sf_len;
+  int64_t start  = (int64_t)ch->last_tx_pos - (sf_len - (int64_t)ch->last_len);
+  int64_t error  = start % sf_len;
+  return (int32_t)(error > sf_len / 2 ? error - sf_len : error);
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  TESTASSERT(channel_init(&channel) == SRSRAN_SUCCESS);
+
+  srsran_ue_sl_sync_t      ue_sync = {};
+  srsran_ue_sl_sync_args_t args    = {};
+  args.slss_period_ms              = slss_period;
+  args.recv_obj                    = &channel;
+  args.recv_callback               = channel_recv;
+  TESTASSERT(srsran_ue_sl_sync_init(&ue_sync, &cell, &args) == SRSRAN_SUCCESS);
+
+  cf_t* buffer = srsran_vec_cf_malloc(channel.sf_len);
+  TESTASSERT(buffer != NULL);
+
+  srsran_ue_sl_sync_outcome_t outcome = {};
+
+  // Initial acquisition, within two SLSS periods and a half subframe shift of the search
+  uint32_t nof_sf = 0;
+  while (ue_sync.state != SRSRAN_UE_SL_SYNC_STATE_TRACK) {
+    TESTASSERT(srsran_ue_sl_sync_zerocopy(&ue_sync, buffer, &outcome) == SRSRAN_SUCCESS);
+    TESTASSERT(++nof_sf <= 3 * slss_period);
+  }
+  TESTASSERT(outcome.slss);
+  TESTASSERT(outcome.N_sl_id == cell.N_sl_id);
+  printf("SLSS found after %d subframes, N_sl_id=%d, CFO=%.1f Hz\n", nof_sf, outcome.N_sl_id, outcome.cfo_hz);
+
+  // Tracking, the full search is not used anymore and every subframe stays aligned. The transmitter clock drift
+  // accumulates between two SLSS
+  int32_t  max_error     = 1 + (drift_period ? (int32_t)SRSRAN_CEIL(slss_period, drift_period) : 0);
+  uint32_t nof_psss_find = ue_sync.nof_psss_find;
+  for (uint32_t i = 0; i < 10 * slss_period; i++) {
+    TESTASSERT(srsran_ue_sl_sync_zerocopy(&ue_sync, buffer, &outcome) == SRSRAN_SUCCESS);
+    TESTASSERT(outcome.in_sync);
+    TESTASSERT(abs(channel_sf_error(&channel)) <= max_error);
+    if (outcome.sf_cnt == 0) {
+      TESTASSERT(outcome.slss);
+    }
+  }
+  TESTASSERT(ue_sync.nof_psss_find == nof_psss_find);
+  TESTASSERT(ue_sync.nof_psss_track == 10);
+  TESTASSERT(fabsf(outcome.cfo_hz - cfo_hz) < 50.0f);
+  printf("Tracked %d SLSS, CFO=%.1f Hz, last sample offset=%d\n",
+         ue_sync.nof_psss_track,
+         outcome.cfo_hz,
+         outcome.sample_offset);
+
+  // Signal loss, falls back to the full search after max_lost periods
+  channel.signal_on = false;
+  for (uint32_t i = 0; i < (SRSRAN_UE_SL_SYNC_DEFAULT_MAX_LOST + 1) * slss_period; i++) {
+    TESTASSERT(srsran_ue_sl_sync_zerocopy(&ue_sync, buffer, &outcome) == SRSRAN_SUCCESS);
+  }
+  TESTASSERT(ue_sync.state == SRSRAN_UE_SL_SYNC_STATE_FIND);
+
+  // Reacquisition
+  channel.signal_on = true;
+  nof_sf            = 0;
+  while (ue_sync.state != SRSRAN_UE_SL_SYNC_STATE_TRACK) {
+    TESTASSERT(srsran_ue_sl_sync_zerocopy(&ue_sync, buffer, &outcome) == SRSRAN_SUCCESS);
+    TESTASSERT(++nof_sf <= 3 * slss_period);
+  }
+  TESTASSERT(outcome.N_sl_id == cell.N_sl_id);
+  printf("SLSS found again after %d subframes\n", nof_sf);
+
+  srsran_ue_sl_sync_free(&ue_sync);
+  channel_free(&channel);
+  free(buffer);
+
+  printf("Ok\n");
+  return SRSRAN_SUCCESS;
+}
@@ -0,0 +1,166 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "srsran/phy/ue/ue_sl_rx.h"
+#include "srsran/phy/ue/ue_sl_tx.h"
+#include "srsran/phy/utils/bit.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+#include "srsran/support/srsran_test.h"
+
+#define NOF_GRANTS 3
+
+static srsran_cell_sl_t cell        = {.nof_prb = 50, .N_sl_id = 168, .tm = SRSRAN_SIDELINK_TM4, .cp = SRSRAN_CP_NORM};
+static uint32_t         nof_workers = 0;
+static uint32_t         nof_sf      = 10;
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [pwnv]\n", prog);
+  printf("\t-p nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-w number of encoding workers [Default %d]\n", nof_workers);
+  printf("\t-n number of subframes [Default %d]\n", nof_sf);
+  printf("\t-v [set srsran_verbose to debug, default none]\n");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "pwnv")) != -1) {
+    switch (opt) {
+      case 'p':
+        cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'w':
+        nof_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'n':
+        nof_sf = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  int ret = SRSRAN_ERROR;
+
+  parse_args(argc, argv);
+
+  srsran_sl_comm_resource_pool_t pool = {};
+  TESTASSERT(srsran_sl_comm_resource_pool_get_default_config(&pool, cell) == SRSRAN_SUCCESS);
+  TESTASSERT(pool.num_sub_channel >= NOF_GRANTS + 1);
+
+  uint32_t sf_len     = SRSRAN_SF_LEN_PRB(cell.nof_prb);
+  cf_t*    sf_samples = srsran_vec_cf_malloc(sf_len);
+  TESTASSERT(sf_samples != NULL);
+
+  srsran_ue_sl_tx_t      ue_tx   = {};
+  srsran_ue_sl_tx_args_t tx_args = {.nof_workers = nof_workers};
+  TESTASSERT(srsran_ue_sl_tx_init(&ue_tx, &cell, &pool, &tx_args, sf_samples) == SRSRAN_SUCCESS);
+
+  srsran_ue_sl_rx_t      ue_rx   = {};
+  srsran_ue_sl_rx_args_t rx_args = {.nof_workers = 2, .nof_sf_buffers = 2, .blocking = false};
+  TESTASSERT(srsran_ue_sl_rx_init(&ue_rx, &cell, &pool, &rx_args) == SRSRAN_SUCCESS);
+
+  // One grant per emulated UE, with different sizes, MCS and cyclic shifts. The second one is a retransmission and the
+  // last one uses 16QAM
+  const uint32_t mcs_idx[NOF_GRANTS] = {4, 6, 14};
+  srsran_ue_sl_tx_grant_t grants[NOF_GRANTS] = {};
+  uint8_t*                tb[NOF_GRANTS]     = {};
+  uint8_t                 tb_packed[SRSRAN_UE_SL_RX_MAX_TB_BYTES];
+  srsran_random_t         random_gen = srsran_random_init(0x1234);
+  uint32_t                sub        = 0;
+  for (uint32_t i = 0; i < NOF_GRANTS; i++) {
+    grants[i].sub_channel_idx = sub;
+    grants[i].L_subCH         = (i == 0) ? 2 : 1;
+    grants[i].mcs_idx         = mcs_idx[i];
+    grants[i].cyclic_shift    = 3 * i;
+    grants[i].priority        = i;
+    grants[i].resource_reserv = 1;
+    grants[i].retransmission  = (i == 1);
+    grants[i].tb_len          = srsran_ue_sl_tx_get_tb_len(&ue_tx, grants[i].L_subCH, grants[i].mcs_idx);
+    TESTASSERT(grants[i].tb_len > 0 && grants[i].tb_len <= 8 * SRSRAN_UE_SL_RX_MAX_TB_BYTES);
+    tb[i] = srsran_vec_u8_malloc(grants[i].tb_len);
+    TESTASSERT(tb[i] != NULL);
+    grants[i].tb = tb[i];
+    sub += grants[i].L_subCH;
+  }
+
+  // Overlapping allocations are rejected before anything is encoded
+  srsran_ue_sl_tx_grant_t overlap[2] = {grants[0], grants[1]};
+  overlap[1].sub_channel_idx         = grants[0].sub_channel_idx + 1;
+  TESTASSERT(srsran_ue_sl_tx_encode(&ue_tx, overlap, 2, 0) == SRSRAN_ERROR_INVALID_INPUTS);
+
+  for (uint32_t tti = 0; tti < nof_sf; tti++) {
+    for (uint32_t i = 0; i < NOF_GRANTS; i++) {
+      for (uint32_t j = 0; j < grants[i].tb_len; j++) {
+        tb[i][j] = (uint8_t)srsran_random_uniform_int_dist(random_gen, 0, 1);
+      }
+    }
+
+    TESTASSERT(srsran_ue_sl_tx_encode(&ue_tx, grants, NOF_GRANTS, tti) == SRSRAN_SUCCESS);
+    TESTASSERT(srsran_ue_sl_rx_push(&ue_rx, sf_samples, tti) == SRSRAN_SUCCESS);
+
+    srsran_ue_sl_rx_sf_t sf = {};
+    TESTASSERT(srsran_ue_sl_rx_pop(&ue_rx, &sf, true) == 1);
+    TESTASSERT(sf.tti == tti);
+    TESTASSERT(sf.nof_grants == NOF_GRANTS);
+
+    // Grants are reported in subchannel order
+    for (uint32_t i = 0; i < NOF_GRANTS; i++) {
+      const srsran_ue_sl_rx_grant_t* g = &sf.grants[i];
+      TESTASSERT(g->sub_channel_idx == grants[i].sub_channel_idx);
+      TESTASSERT(g->cyclic_shift == grants[i].cyclic_shift);
+      TESTASSERT(g->sci.mcs_idx == grants[i].mcs_idx);
+      TESTASSERT(g->sci.retransmission == grants[i].retransmission);
+      TESTASSERT(g->tb_crc);
+      TESTASSERT(g->tb_len == grants[i].tb_len);
+      srsran_bit_pack_vector(tb[i], tb_packed, grants[i].tb_len);
+      TESTASSERT(memcmp(tb_packed, g->tb_packed, grants[i].tb_len / 8) == 0);
+    }
+  }
+
+  printf("Decoded %d subframes of %d grants with %d workers\n", nof_sf, NOF_GRANTS, nof_workers);
+  ret = SRSRAN_SUCCESS;
+
+  srsran_random_free(random_gen);
+  for (uint32_t i = 0; i < NOF_GRANTS; i++) {
+    free(tb[i]);
+  }
+  srsran_ue_sl_rx_free(&ue_rx);
+  srsran_ue_sl_tx_free(&ue_tx);
+  free(sf_samples);
+
+  return ret;
+}
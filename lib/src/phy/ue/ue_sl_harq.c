@@ -0,0 +1,239 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdlib.h>
+#include <strings.h>
+
+#include "srsran/phy/common/phy_common.h"
+#include "srsran/phy/ue/ue_sl_harq.h"
+#include "srsran/phy/utils/debug.h"
+
+#define UE_SL_HARQ_NOF_TTI 10240
+
+int srsran_ue_sl_harq_init(srsran_ue_sl_harq_t* q, uint32_t nof_prb, uint32_t nof_buffers)
+{
+  if (q == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  bzero(q, sizeof(srsran_ue_sl_harq_t));
+
+  q->nof_buffers = nof_buffers ? nof_buffers : SRSRAN_UE_SL_HARQ_DEFAULT_NOF_BUFFERS;
+
+  if (srsran_crc_init(&q->crc, 0x11021, SRSRAN_SCI_CRC_LEN) != SRSRAN_SUCCESS) {
+    ERROR("Error initialising SCI CRC");
+    return SRSRAN_ERROR;
+  }
+
+  pthread_mutex_init(&q->mutex, NULL);
+  pthread_cond_init(&q->cvar, NULL);
+
+  q->buffers = calloc(q->nof_buffers, sizeof(srsran_ue_sl_harq_buffer_t));
+  if (q->buffers == NULL) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+
+  for (uint32_t i = 0; i < q->nof_buffers; i++) {
+    if (srsran_softbuffer_rx_init(&q->buffers[i].softbuffer, nof_prb) != SRSRAN_SUCCESS) {
+      ERROR("Error initialising soft buffer");
+      return SRSRAN_ERROR;
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_ue_sl_harq_free(srsran_ue_sl_harq_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  if (q->buffers) {
+    for (uint32_t i = 0; i < q->nof_buffers; i++) {
+      srsran_softbuffer_rx_free(&q->buffers[i].softbuffer);
+    }
+    free(q->buffers);
+    pthread_mutex_destroy(&q->mutex);
+    pthread_cond_destroy(&q->cvar);
+  }
+
+  bzero(q, sizeof(srsran_ue_sl_harq_t));
+}
+
+/// Computes the N_x_id of the initial transmission with the SCI bits and CRC of the store, q->mutex must be held
+static uint32_t ue_sl_harq_initial_N_x_id(srsran_ue_sl_harq_t* q, const srsran_sci_t* sci)
+{
+  // Only the retransmission index differs between the SCI of both transmissions
+  srsran_sci_t sci_initial   = *sci;
+  sci_initial.retransmission = false;
+  srsran_sci_format1_pack(&sci_initial, q->sci_bits);
+
+  return srsran_crc_checksum(&q->crc, q->sci_bits, (int)sci->sci_len);
+}
+
+uint32_t srsran_ue_sl_harq_initial_N_x_id(srsran_ue_sl_harq_t* q, const srsran_sci_t* sci)
+{
+  pthread_mutex_lock(&q->mutex);
+  uint32_t N_x_id = ue_sl_harq_initial_N_x_id(q, sci);
+  pthread_mutex_unlock(&q->mutex);
+
+  return N_x_id;
+}
+
+/// Releases the buffers whose retransmission should have been received before tti
+static void ue_sl_harq_expire(srsran_ue_sl_harq_t* q, uint32_t tti)
+{
+  for (uint32_t i = 0; i < q->nof_buffers; i++) {
+    srsran_ue_sl_harq_buffer_t* b        = &q->buffers[i];
+    uint32_t                    interval = srsran_tti_interval(tti, b->tti_retx);
+    if (b->active && !b->busy && interval > 0 && interval < UE_SL_HARQ_NOF_TTI / 2) {
+      b->active = false;
+      if (!b->decoded) {
+        INFO("SL HARQ: N_x_id=%d expired, retransmission expected at tti=%d", b->N_x_id, b->tti_retx);
+        q->nof_expired++;
+      }
+    }
+  }
+}
+
+static srsran_ue_sl_harq_buffer_t* ue_sl_harq_find(srsran_ue_sl_harq_t* q, uint32_t N_x_id, uint32_t tti)
+{
+  for (uint32_t i = 0; i < q->nof_buffers; i++) {
+    srsran_ue_sl_harq_buffer_t* b = &q->buffers[i];
+    if (b->active && b->N_x_id == N_x_id && b->tti_retx == tti) {
+      return b;
+    }
+  }
+  return NULL;
+}
+
+/// Returns a free buffer, the buffer of a decoded TB, or the idle active buffer whose retransmission is expected first
+static srsran_ue_sl_harq_buffer_t* ue_sl_harq_alloc(srsran_ue_sl_harq_t* q, uint32_t tti)
+{
+  srsran_ue_sl_harq_buffer_t* decoded  = NULL;
+  srsran_ue_sl_harq_buffer_t* oldest   = NULL;
+  uint32_t                    min_wait = UE_SL_HARQ_NOF_TTI;
+  for (uint32_t i = 0; i < q->nof_buffers; i++) {
+    srsran_ue_sl_harq_buffer_t* b = &q->buffers[i];
+    if (!b->active) {
+      return b;
+    }
+    if (b->decoded && !b->busy && decoded == NULL) {
+      decoded = b;
+    }
+    uint32_t wait = srsran_tti_interval(b->tti_retx, tti);
+    if (!b->busy && wait < min_wait) {
+      oldest   = b;
+      min_wait = wait;
+    }
+  }
+  if (decoded) {
+    return decoded;
+  }
+  if (oldest) {
+    q->nof_evicted++;
+  }
+  return oldest;
+}
+
+srsran_softbuffer_rx_t*
+srsran_ue_sl_harq_acquire(srsran_ue_sl_harq_t* q, const srsran_sci_t* sci, uint32_t N_x_id, uint32_t tti, uint32_t tbs)
+{
+  if (q == NULL || sci == NULL || sci->format != SRSRAN_SCI_FORMAT1) {
+    return NULL;
+  }
+
+  srsran_softbuffer_rx_t* softbuffer = NULL;
+  tti                                = tti % UE_SL_HARQ_NOF_TTI;
+
+  pthread_mutex_lock(&q->mutex);
+  ue_sl_harq_expire(q, tti);
+
+  if (!sci->retransmission) {
+    // Without a time gap no retransmission follows, nothing to keep
+    if (sci->time_gap > 0) {
+      srsran_ue_sl_harq_buffer_t* b = ue_sl_harq_alloc(q, tti);
+      if (b) {
+        b->active        = true;
+        b->busy          = true;
+        b->retx_received = false;
+        b->decoded       = false;
+        b->N_x_id        = N_x_id;
+        b->tti_retx      = (tti + sci->time_gap) % UE_SL_HARQ_NOF_TTI;
+        srsran_softbuffer_rx_reset_tbs(&b->softbuffer, tbs);
+        softbuffer = &b->softbuffer;
+      }
+    }
+  } else {
+    uint32_t                    N_x_id_initial = ue_sl_harq_initial_N_x_id(q, sci);
+    srsran_ue_sl_harq_buffer_t* b              = ue_sl_harq_find(q, N_x_id_initial, tti);
+
+    // The initial transmission may still be decoded by another thread
+    while (b && b->busy) {
+      pthread_cond_wait(&q->cvar, &q->mutex);
+      b = ue_sl_harq_find(q, N_x_id_initial, tti);
+    }
+
+    if (b && b->decoded) {
+      // Nothing to combine, the TB was decoded in its initial transmission
+      b->active = false;
+      q->nof_redundant++;
+    } else if (b) {
+      INFO("SL HARQ: combining retransmission N_x_id=%d with N_x_id=%d", N_x_id, N_x_id_initial);
+      b->busy          = true;
+      b->retx_received = true;
+      softbuffer       = &b->softbuffer;
+      q->nof_combined++;
+    } else {
+      q->nof_missed++;
+    }
+  }
+
+  pthread_mutex_unlock(&q->mutex);
+
+  return softbuffer;
+}
+
+void srsran_ue_sl_harq_release(srsran_ue_sl_harq_t* q, srsran_softbuffer_rx_t* softbuffer, bool tb_crc)
+{
+  if (q == NULL || softbuffer == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&q->mutex);
+  for (uint32_t i = 0; i < q->nof_buffers; i++) {
+    srsran_ue_sl_harq_buffer_t* b = &q->buffers[i];
+    if (&b->softbuffer == softbuffer) {
+      b->busy = false;
+      if (b->retx_received) {
+        b->active = false;
+      } else if (tb_crc) {
+        // Kept until the retransmission, which is then not counted as missed
+        b->decoded = true;
+      }
+      break;
+    }
+  }
+  pthread_cond_broadcast(&q->cvar);
+  pthread_mutex_unlock(&q->mutex);
+}
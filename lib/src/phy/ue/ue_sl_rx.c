@@ -0,0 +1,627 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "srsran/phy/common/phy_common_sl.h"
+#include "srsran/phy/phch/ra_sl.h"
+#include "srsran/phy/ue/ue_sl_rx.h"
+#include "srsran/phy/utils/bit.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+
+typedef enum {
+  UE_SL_RX_SLOT_FREE = 0,
+  UE_SL_RX_SLOT_QUEUED, ///< Waiting for a worker to run the FFT
+  UE_SL_RX_SLOT_FFT,    ///< FFT in progress
+  UE_SL_RX_SLOT_DECODE, ///< Subchannels are being dispatched to the workers
+  UE_SL_RX_SLOT_DONE    ///< All subchannels processed, ready to be returned
+} ue_sl_rx_slot_state_t;
+
+typedef struct {
+  ue_sl_rx_slot_state_t state;
+
+  cf_t*         in_buffer;
+  cf_t*         sf_buffer;
+  srsran_ofdm_t fft;
+
+  uint32_t tti;
+  uint32_t next_sub_channel; ///< Next subchannel to dispatch
+  uint32_t nof_pending;      ///< Subchannels not finished yet
+
+  srsran_ue_sl_rx_grant_t* grants;
+  bool*                    grant_valid;
+  uint32_t                 nof_grants;
+
+  struct timespec t_push;
+  uint64_t        latency_us;
+} ue_sl_rx_slot_t;
+
+typedef struct {
+  pthread_t          thread;
+  bool               started;
+  srsran_ue_sl_rx_t* q;
+
+  srsran_pscch_t    pscch;
+  srsran_pssch_t    pssch;
+  srsran_chest_sl_t pscch_chest;
+  srsran_chest_sl_t pssch_chest;
+  srsran_sci_t      sci;
+
+  cf_t*    equalized_syms;
+  uint8_t* tb;
+} ue_sl_rx_worker_t;
+
+static uint64_t ue_sl_rx_elapsed_us(const struct timespec* t0, const struct timespec* t1)
+{
+  int64_t us = (int64_t)(t1->tv_sec - t0->tv_sec) * 1000000 + (t1->tv_nsec - t0->tv_nsec) / 1000;
+  return us > 0 ? (uint64_t)us : 0;
+}
+
+static int ue_sl_rx_worker_init(srsran_ue_sl_rx_t* q, ue_sl_rx_worker_t* w)
+{
+  w->q = q;
+
+  if (srsran_pscch_init(&w->pscch, SRSRAN_MAX_PRB) != SRSRAN_SUCCESS) {
+    ERROR("Error in PSCCH init");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_pscch_set_cell(&w->pscch, q->cell) != SRSRAN_SUCCESS) {
+    ERROR("Error in PSCCH set cell");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_chest_sl_init(&w->pscch_chest, SRSRAN_SIDELINK_PSCCH, q->cell, &q->sl_comm_resource_pool) !=
+      SRSRAN_SUCCESS) {
+    ERROR("Error in chest PSCCH init");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_pssch_init(&w->pssch, &q->cell, &q->sl_comm_resource_pool) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing PSSCH");
+    return SRSRAN_ERROR;
+  }
+  srsran_pssch_set_max_noi(&w->pssch, q->args.max_nof_iterations);
+  if (srsran_pssch_set_cb_workers(&w->pssch, q->args.nof_cb_workers) != SRSRAN_SUCCESS) {
+    ERROR("Error setting PSSCH code block workers");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_chest_sl_init(&w->pssch_chest, SRSRAN_SIDELINK_PSSCH, q->cell, &q->sl_comm_resource_pool) !=
+      SRSRAN_SUCCESS) {
+    ERROR("Error in chest PSSCH init");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_sci_init(&w->sci, &q->cell, &q->sl_comm_resource_pool) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing SCI");
+    return SRSRAN_ERROR;
+  }
+
+  w->equalized_syms = srsran_vec_cf_malloc(SRSRAN_SF_LEN_RE(q->cell.nof_prb, q->cell.cp));
+  if (!w->equalized_syms) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+  w->tb = srsran_vec_u8_malloc(SRSRAN_SL_SCH_MAX_TB_LEN);
+  if (!w->tb) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static void ue_sl_rx_worker_free(ue_sl_rx_worker_t* w)
+{
+  srsran_sci_free(&w->sci);
+  srsran_pscch_free(&w->pscch);
+  srsran_pssch_free(&w->pssch);
+  srsran_chest_sl_free(&w->pscch_chest);
+  srsran_chest_sl_free(&w->pssch_chest);
+
+  if (w->equalized_syms) {
+    free(w->equalized_syms);
+  }
+  if (w->tb) {
+    free(w->tb);
+  }
+}
+
+static int ue_sl_rx_slot_init(srsran_ue_sl_rx_t* q, ue_sl_rx_slot_t* s)
+{
+  s->in_buffer = srsran_vec_cf_malloc(q->sf_len);
+  if (!s->in_buffer) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+  s->sf_buffer = srsran_vec_cf_malloc(SRSRAN_SF_LEN_RE(q->cell.nof_prb, q->cell.cp));
+  if (!s->sf_buffer) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+
+  srsran_ofdm_cfg_t ofdm_cfg = {};
+  ofdm_cfg.nof_prb           = q->cell.nof_prb;
+  ofdm_cfg.cp                = q->cell.cp;
+  ofdm_cfg.rx_window_offset  = 0.0f;
+  ofdm_cfg.normalize         = true;
+  ofdm_cfg.sf_type           = SRSRAN_SF_NORM;
+  ofdm_cfg.freq_shift_f      = -0.5;
+  ofdm_cfg.in_buffer         = s->in_buffer;
+  ofdm_cfg.out_buffer        = s->sf_buffer;
+  if (srsran_ofdm_rx_init_cfg(&s->fft, &ofdm_cfg)) {
+    ERROR("Error initiating FFT");
+    return SRSRAN_ERROR;
+  }
+
+  s->grants = calloc(q->sl_comm_resource_pool.num_sub_channel, sizeof(srsran_ue_sl_rx_grant_t));
+  if (!s->grants) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+  s->grant_valid = calloc(q->sl_comm_resource_pool.num_sub_channel, sizeof(bool));
+  if (!s->grant_valid) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static void ue_sl_rx_slot_free(ue_sl_rx_slot_t* s)
+{
+  srsran_ofdm_rx_free(&s->fft);
+  if (s->in_buffer) {
+    free(s->in_buffer);
+  }
+  if (s->sf_buffer) {
+    free(s->sf_buffer);
+  }
+  if (s->grants) {
+    free(s->grants);
+  }
+  if (s->grant_valid) {
+    free(s->grant_valid);
+  }
+}
+
+/// PSCCH cyclic shift detection and decoding followed by PSSCH decoding for one subchannel, same procedure as pssch_ue
+static void ue_sl_rx_decode_sub_channel(ue_sl_rx_worker_t* w, ue_sl_rx_slot_t* s, uint32_t sub_channel_idx)
+{
+  srsran_ue_sl_rx_t*                    q      = w->q;
+  const srsran_sl_comm_resource_pool_t* pool   = &q->sl_comm_resource_pool;
+  srsran_ue_sl_rx_grant_t*              g      = &s->grants[sub_channel_idx];
+  uint32_t                              sf_idx = s->tti % SRSRAN_NOF_SF_X_FRAME;
+
+  uint8_t sci_rx[SRSRAN_SCI_MAX_LEN] = {};
+
+  s->grant_valid[sub_channel_idx] = false;
+
+  uint32_t              pscch_prb_start_idx = sub_channel_idx * pool->size_sub_channel;
+  srsran_chest_sl_cfg_t pscch_chest_sl_cfg  = {};
+
+  // Pick the cyclic shift from the DMRS alone, empty subchannels are skipped without running the PSCCH decoder
+  int cyclic_shift = srsran_chest_sl_pscch_detect_cyclic_shift(
+      &w->pscch_chest, s->sf_buffer, pscch_prb_start_idx, SRSRAN_SL_PSCCH_CS_DETECT_DEFAULT_THRESHOLD);
+  if (cyclic_shift < 0) {
+    return;
+  }
+
+  pscch_chest_sl_cfg.cyclic_shift  = (uint32_t)cyclic_shift;
+  pscch_chest_sl_cfg.prb_start_idx = pscch_prb_start_idx;
+  srsran_chest_sl_set_cfg(&w->pscch_chest, pscch_chest_sl_cfg);
+  srsran_chest_sl_ls_estimate_equalize_compact(&w->pscch_chest, s->sf_buffer, w->equalized_syms);
+
+  if (srsran_pscch_decode_compact(&w->pscch, w->equalized_syms, sci_rx) != SRSRAN_SUCCESS) {
+    return;
+  }
+  if (srsran_sci_format1_unpack(&w->sci, sci_rx) != SRSRAN_SUCCESS) {
+    return;
+  }
+
+  s->grant_valid[sub_channel_idx] = true;
+  g->sub_channel_idx              = sub_channel_idx;
+  g->cyclic_shift                 = (uint32_t)cyclic_shift;
+  g->sci                          = w->sci;
+  g->tb_crc                       = false;
+  g->tb_len                       = 0;
+  g->avg_iterations               = 0;
+  g->combined                     = false;
+
+  // 3GPP TS 36.213 Section 14.1.1.4C
+  uint32_t sub_channel_start_idx = 0;
+  uint32_t L_subCH               = 0;
+  srsran_ra_sl_type0_from_riv(w->sci.riv, pool->num_sub_channel, &L_subCH, &sub_channel_start_idx);
+
+  uint32_t pssch_prb_start_idx =
+      (sub_channel_idx * pool->size_sub_channel) + w->pscch.pscch_nof_prb + pool->start_prb_sub_channel;
+  uint32_t nof_prb_pssch = ((L_subCH + sub_channel_idx) * pool->size_sub_channel) - pssch_prb_start_idx +
+                           pool->start_prb_sub_channel;
+
+  // make sure PRBs are valid for DFT precoding
+  nof_prb_pssch = srsran_dft_precoding_get_valid_prb(nof_prb_pssch);
+
+  uint32_t N_x_id = 0;
+  for (int j = 0; j < SRSRAN_SCI_CRC_LEN; j++) {
+    N_x_id += w->pscch.sci_crc[j] * (1U << (SRSRAN_SCI_CRC_LEN - 1 - j));
+  }
+  g->N_x_id = N_x_id;
+
+  uint32_t rv_idx = w->sci.retransmission ? 1 : 0;
+
+  srsran_chest_sl_cfg_t pssch_chest_sl_cfg = {};
+  pssch_chest_sl_cfg.N_x_id                = N_x_id;
+  pssch_chest_sl_cfg.sf_idx                = sf_idx;
+  pssch_chest_sl_cfg.prb_start_idx         = pssch_prb_start_idx;
+  pssch_chest_sl_cfg.nof_prb               = nof_prb_pssch;
+  srsran_chest_sl_set_cfg(&w->pssch_chest, pssch_chest_sl_cfg);
+  srsran_chest_sl_ls_estimate_equalize_compact(&w->pssch_chest, s->sf_buffer, w->equalized_syms);
+
+  srsran_pssch_cfg_t pssch_cfg = {pssch_prb_start_idx, nof_prb_pssch, N_x_id, w->sci.mcs_idx, rv_idx, sf_idx, NULL};
+  if (srsran_pssch_set_cfg(&w->pssch, pssch_cfg) == SRSRAN_SUCCESS) {
+    // Soft bits are kept for the blind retransmission, which combines them with its own. The TB size is known once
+    // the PSSCH is configured
+    pssch_cfg.softbuffer = srsran_ue_sl_harq_acquire(&q->harq, &w->sci, N_x_id, s->tti, w->pssch.sl_sch_tb_len);
+    if (pssch_cfg.softbuffer) {
+      srsran_pssch_set_cfg(&w->pssch, pssch_cfg);
+    }
+
+    int ret           = srsran_pssch_decode_compact(&w->pssch, w->equalized_syms, w->tb, SRSRAN_SL_SCH_MAX_TB_LEN);
+    g->avg_iterations = srsran_pssch_last_noi(&w->pssch);
+    g->combined       = w->sci.retransmission && pssch_cfg.softbuffer != NULL;
+    srsran_ue_sl_harq_release(&q->harq, pssch_cfg.softbuffer, ret == SRSRAN_SUCCESS);
+    if (ret == SRSRAN_SUCCESS) {
+      g->tb_crc = true;
+      g->tb_len = w->pssch.sl_sch_tb_len;
+      srsran_bit_pack_vector(w->tb, g->tb_packed, w->pssch.sl_sch_tb_len);
+    }
+  }
+}
+
+/// Finds the oldest pending job, must be called with the mutex locked
+static ue_sl_rx_slot_t* ue_sl_rx_find_work(srsran_ue_sl_rx_t* q)
+{
+  ue_sl_rx_slot_t* slots = (ue_sl_rx_slot_t*)q->slots;
+  for (uint32_t i = 0; i < q->count; i++) {
+    ue_sl_rx_slot_t* s = &slots[(q->tail + i) % q->nof_sf_buffers];
+    if (s->state == UE_SL_RX_SLOT_QUEUED) {
+      return s;
+    }
+    if (s->state == UE_SL_RX_SLOT_DECODE && s->next_sub_channel < q->sl_comm_resource_pool.num_sub_channel) {
+      return s;
+    }
+  }
+  return NULL;
+}
+
+static void ue_sl_rx_slot_done(srsran_ue_sl_rx_t* q, ue_sl_rx_slot_t* s)
+{
+  struct timespec t_done;
+  clock_gettime(CLOCK_MONOTONIC, &t_done);
+  s->latency_us = ue_sl_rx_elapsed_us(&s->t_push, &t_done);
+
+  // Compact the valid grants in subchannel order
+  s->nof_grants = 0;
+  for (uint32_t i = 0; i < q->sl_comm_resource_pool.num_sub_channel; i++) {
+    if (s->grant_valid[i]) {
+      if (s->nof_grants != i) {
+        s->grants[s->nof_grants] = s->grants[i];
+      }
+      q->metrics.nof_sci_decoded++;
+      if (s->grants[s->nof_grants].tb_crc) {
+        q->metrics.nof_tb_decoded++;
+      } else {
+        q->metrics.nof_tb_errors++;
+      }
+      if (s->grants[s->nof_grants].combined) {
+        q->metrics.nof_tb_combined++;
+      }
+      s->nof_grants++;
+    }
+  }
+
+  q->metrics.nof_sf_processed++;
+  q->latency_acc_us += s->latency_us;
+  q->metrics.max_latency_us = SRSRAN_MAX(q->metrics.max_latency_us, s->latency_us);
+
+  double elapsed_us = (double)ue_sl_rx_elapsed_us(&q->t_start, &t_done);
+  if (elapsed_us > 0) {
+    q->metrics.sf_per_sec = (double)q->metrics.nof_sf_processed * 1e6 / elapsed_us;
+  }
+
+  s->state = UE_SL_RX_SLOT_DONE;
+  pthread_cond_broadcast(&q->cvar_done);
+}
+
+static void* ue_sl_rx_worker_thread(void* arg)
+{
+  ue_sl_rx_worker_t* w = (ue_sl_rx_worker_t*)arg;
+  srsran_ue_sl_rx_t* q = w->q;
+
+  pthread_mutex_lock(&q->mutex);
+  while (!q->quit) {
+    ue_sl_rx_slot_t* s = ue_sl_rx_find_work(q);
+    if (s == NULL) {
+      pthread_cond_wait(&q->cvar_work, &q->mutex);
+      continue;
+    }
+
+    if (s->state == UE_SL_RX_SLOT_QUEUED) {
+      s->state = UE_SL_RX_SLOT_FFT;
+      pthread_mutex_unlock(&q->mutex);
+
+      srsran_ofdm_rx_sf(&s->fft);
+
+      pthread_mutex_lock(&q->mutex);
+      s->next_sub_channel = 0;
+      s->nof_pending      = q->sl_comm_resource_pool.num_sub_channel;
+      s->state            = UE_SL_RX_SLOT_DECODE;
+      if (s->nof_pending == 0) {
+        ue_sl_rx_slot_done(q, s);
+      }
+      // More subchannels than this worker can take are now available
+      pthread_cond_broadcast(&q->cvar_work);
+    } else {
+      uint32_t sub_channel_idx = s->next_sub_channel++;
+      pthread_mutex_unlock(&q->mutex);
+
+      ue_sl_rx_decode_sub_channel(w, s, sub_channel_idx);
+
+      pthread_mutex_lock(&q->mutex);
+      s->nof_pending--;
+      if (s->nof_pending == 0) {
+        ue_sl_rx_slot_done(q, s);
+      }
+    }
+  }
+  pthread_mutex_unlock(&q->mutex);
+
+  return NULL;
+}
+
+int srsran_ue_sl_rx_init(srsran_ue_sl_rx_t*                    q,
+                         const srsran_cell_sl_t*               cell,
+                         const srsran_sl_comm_resource_pool_t* sl_comm_resource_pool,
+                         const srsran_ue_sl_rx_args_t*         args)
+{
+  if (q == NULL || cell == NULL || sl_comm_resource_pool == NULL || args == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  bzero(q, sizeof(srsran_ue_sl_rx_t));
+
+  if (cell->tm != SRSRAN_SIDELINK_TM3 && cell->tm != SRSRAN_SIDELINK_TM4) {
+    ERROR("Sidelink receiver only supports TM3 and TM4");
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+  if (args->nof_workers == 0 || args->nof_workers > SRSRAN_UE_SL_RX_MAX_WORKERS) {
+    ERROR("Invalid number of workers %d", args->nof_workers);
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  q->cell                  = *cell;
+  q->sl_comm_resource_pool = *sl_comm_resource_pool;
+  q->args                  = *args;
+  q->sf_len                = SRSRAN_SF_LEN_PRB(cell->nof_prb);
+  q->nof_sf_buffers        = args->nof_sf_buffers ? args->nof_sf_buffers : 2 * args->nof_workers;
+  q->nof_sf_buffers        = SRSRAN_MIN(q->nof_sf_buffers, SRSRAN_UE_SL_RX_MAX_SF_BUFFERS);
+
+  pthread_mutex_init(&q->mutex, NULL);
+  pthread_cond_init(&q->cvar_work, NULL);
+  pthread_cond_init(&q->cvar_done, NULL);
+  pthread_cond_init(&q->cvar_free, NULL);
+
+  if (srsran_ue_sl_harq_init(&q->harq, cell->nof_prb, args->nof_harq_buffers) != SRSRAN_SUCCESS) {
+    ERROR("Error initialising sidelink soft buffers");
+    goto clean_exit;
+  }
+
+  q->slots = calloc(q->nof_sf_buffers, sizeof(ue_sl_rx_slot_t));
+  if (!q->slots) {
+    ERROR("Error allocating memory");
+    goto clean_exit;
+  }
+  ue_sl_rx_slot_t* slots = (ue_sl_rx_slot_t*)q->slots;
+  for (uint32_t i = 0; i < q->nof_sf_buffers; i++) {
+    if (ue_sl_rx_slot_init(q, &slots[i]) != SRSRAN_SUCCESS) {
+      goto clean_exit;
+    }
+  }
+
+  // All PHY objects are created from this thread since FFTW planning and table generation are not thread-safe
+  q->workers = calloc(args->nof_workers, sizeof(ue_sl_rx_worker_t));
+  if (!q->workers) {
+    ERROR("Error allocating memory");
+    goto clean_exit;
+  }
+  ue_sl_rx_worker_t* workers = (ue_sl_rx_worker_t*)q->workers;
+  for (uint32_t i = 0; i < args->nof_workers; i++) {
+    if (ue_sl_rx_worker_init(q, &workers[i]) != SRSRAN_SUCCESS) {
+      goto clean_exit;
+    }
+  }
+
+  for (uint32_t i = 0; i < args->nof_workers; i++) {
+    if (pthread_create(&workers[i].thread, NULL, ue_sl_rx_worker_thread, &workers[i])) {
+      perror("pthread_create");
+      goto clean_exit;
+    }
+    workers[i].started = true;
+  }
+
+  return SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_ue_sl_rx_free(q);
+  return SRSRAN_ERROR;
+}
+
+void srsran_ue_sl_rx_free(srsran_ue_sl_rx_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  ue_sl_rx_worker_t* workers = (ue_sl_rx_worker_t*)q->workers;
+  ue_sl_rx_slot_t*   slots   = (ue_sl_rx_slot_t*)q->slots;
+
+  if (workers) {
+    pthread_mutex_lock(&q->mutex);
+    q->quit = true;
+    pthread_cond_broadcast(&q->cvar_work);
+    pthread_cond_broadcast(&q->cvar_free);
+    pthread_mutex_unlock(&q->mutex);
+
+    for (uint32_t i = 0; i < q->args.nof_workers; i++) {
+      if (workers[i].started) {
+        pthread_join(workers[i].thread, NULL);
+      }
+    }
+    for (uint32_t i = 0; i < q->args.nof_workers; i++) {
+      ue_sl_rx_worker_free(&workers[i]);
+    }
+    free(workers);
+  }
+
+  if (slots) {
+    for (uint32_t i = 0; i < q->nof_sf_buffers; i++) {
+      ue_sl_rx_slot_free(&slots[i]);
+    }
+    free(slots);
+  }
+
+  srsran_ue_sl_harq_free(&q->harq);
+
+  pthread_cond_destroy(&q->cvar_work);
+  pthread_cond_destroy(&q->cvar_done);
+  pthread_cond_destroy(&q->cvar_free);
+  pthread_mutex_destroy(&q->mutex);
+
+  bzero(q, sizeof(srsran_ue_sl_rx_t));
+}
+
+int srsran_ue_sl_rx_push(srsran_ue_sl_rx_t* q, const cf_t* samples, uint32_t tti)
+{
+  if (q == NULL || samples == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  pthread_mutex_lock(&q->mutex);
+  if (q->metrics.nof_sf_pushed == 0) {
+    clock_gettime(CLOCK_MONOTONIC, &q->t_start);
+  }
+  q->metrics.nof_sf_pushed++;
+
+  if (q->args.blocking) {
+    while (q->count == q->nof_sf_buffers && !q->quit) {
+      pthread_cond_wait(&q->cvar_free, &q->mutex);
+    }
+  }
+  if (q->count == q->nof_sf_buffers || q->quit) {
+    q->metrics.nof_sf_dropped++;
+    pthread_mutex_unlock(&q->mutex);
+    return SRSRAN_ERROR;
+  }
+
+  ue_sl_rx_slot_t* s = &((ue_sl_rx_slot_t*)q->slots)[q->head];
+  q->head            = (q->head + 1) % q->nof_sf_buffers;
+  q->count++;
+  pthread_mutex_unlock(&q->mutex);
+
+  // The slot is not visible to the workers until it is queued
+  srsran_vec_cf_copy(s->in_buffer, samples, q->sf_len);
+  s->tti        = tti;
+  s->nof_grants = 0;
+  clock_gettime(CLOCK_MONOTONIC, &s->t_push);
+
+  pthread_mutex_lock(&q->mutex);
+  s->state = UE_SL_RX_SLOT_QUEUED;
+  pthread_cond_signal(&q->cvar_work);
+  pthread_mutex_unlock(&q->mutex);
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_ue_sl_rx_pop(srsran_ue_sl_rx_t* q, srsran_ue_sl_rx_sf_t* sf, bool wait)
+{
+  if (q == NULL || sf == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  ue_sl_rx_slot_t* slots = (ue_sl_rx_slot_t*)q->slots;
+
+  pthread_mutex_lock(&q->mutex);
+
+  // Release the subframe returned in the previous call
+  if (q->tail_held) {
+    slots[q->tail].state = UE_SL_RX_SLOT_FREE;
+    q->tail              = (q->tail + 1) % q->nof_sf_buffers;
+    q->count--;
+    q->tail_held = false;
+    pthread_cond_signal(&q->cvar_free);
+  }
+
+  // A slot between head and tail may still be filled by push, it is not ready until its state is set
+  while (wait && !q->quit && q->count > 0 && slots[q->tail].state != UE_SL_RX_SLOT_DONE) {
+    pthread_cond_wait(&q->cvar_done, &q->mutex);
+  }
+
+  if (q->count == 0 || slots[q->tail].state != UE_SL_RX_SLOT_DONE) {
+    pthread_mutex_unlock(&q->mutex);
+    return 0;
+  }
+
+  ue_sl_rx_slot_t* s = &slots[q->tail];
+  sf->tti            = s->tti;
+  sf->sf_idx         = s->tti % SRSRAN_NOF_SF_X_FRAME;
+  sf->nof_grants     = s->nof_grants;
+  sf->grants         = s->grants;
+  sf->latency_us     = s->latency_us;
+  q->tail_held       = true;
+
+  pthread_mutex_unlock(&q->mutex);
+
+  return 1;
+}
+
+uint32_t srsran_ue_sl_rx_pending(srsran_ue_sl_rx_t* q)
+{
+  if (q == NULL) {
+    return 0;
+  }
+  pthread_mutex_lock(&q->mutex);
+  uint32_t pending = q->count - (q->tail_held ? 1 : 0);
+  pthread_mutex_unlock(&q->mutex);
+  return pending;
+}
+
+void srsran_ue_sl_rx_get_metrics(srsran_ue_sl_rx_t* q, srsran_ue_sl_rx_metrics_t* metrics)
+{
+  if (q == NULL || metrics == NULL) {
+    return;
+  }
+  pthread_mutex_lock(&q->mutex);
+  *metrics = q->metrics;
+  if (q->metrics.nof_sf_processed > 0) {
+    metrics->avg_latency_us = (double)q->latency_acc_us / (double)q->metrics.nof_sf_processed;
+  }
+  pthread_mutex_unlock(&q->mutex);
+}
@@ -0,0 +1,272 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <strings.h>
+
+#include "srsran/phy/ue/ue_sl_sync.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+
+#define UE_SL_SYNC_SCS_HZ 15000.0f
+
+int srsran_ue_sl_sync_init(srsran_ue_sl_sync_t* q, const srsran_cell_sl_t* cell, const srsran_ue_sl_sync_args_t* args)
+{
+  if (q == NULL || cell == NULL || args == NULL || args->recv_callback == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  bzero(q, sizeof(srsran_ue_sl_sync_t));
+
+  q->cell     = *cell;
+  q->args     = *args;
+  q->sf_len   = SRSRAN_SF_LEN_PRB(cell->nof_prb);
+  q->srate_hz = 1000.0 * q->sf_len;
+
+  // Set defaults
+  if (q->args.slss_period_ms == 0) {
+    q->args.slss_period_ms = SRSRAN_UE_SL_SYNC_DEFAULT_SLSS_PERIOD_MS;
+  }
+  if (q->args.track_window == 0) {
+    q->args.track_window = SRSRAN_CP_SZ(srsran_symbol_sz(cell->nof_prb), cell->cp);
+  }
+  if (q->args.max_lost == 0) {
+    q->args.max_lost = SRSRAN_UE_SL_SYNC_DEFAULT_MAX_LOST;
+  }
+  if (!isnormal(q->args.track_thr)) {
+    q->args.track_thr = SRSRAN_UE_SL_SYNC_DEFAULT_TRACK_THR;
+  }
+  if (!isnormal(q->args.cfo_alpha)) {
+    q->args.cfo_alpha = SRSRAN_UE_SL_SYNC_DEFAULT_CFO_ALPHA;
+  }
+
+  if (srsran_psss_init(&q->psss, cell->nof_prb, cell->cp) != SRSRAN_SUCCESS) {
+    ERROR("Error initialising PSSS");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_ssss_init(&q->ssss, cell->nof_prb, cell->cp, cell->tm) != SRSRAN_SUCCESS) {
+    ERROR("Error initialising SSSS");
+    return SRSRAN_ERROR;
+  }
+
+  q->find_buffer = srsran_vec_cf_malloc(2 * q->sf_len);
+  if (q->find_buffer == NULL) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+  q->slss_buffer = srsran_vec_cf_malloc(q->sf_len);
+  if (q->slss_buffer == NULL) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+
+  srsran_ue_sl_sync_reset(q);
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_ue_sl_sync_free(srsran_ue_sl_sync_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  srsran_psss_free(&q->psss);
+  srsran_ssss_free(&q->ssss);
+  if (q->find_buffer) {
+    free(q->find_buffer);
+  }
+  if (q->slss_buffer) {
+    free(q->slss_buffer);
+  }
+
+  bzero(q, sizeof(srsran_ue_sl_sync_t));
+}
+
+void srsran_ue_sl_sync_reset(srsran_ue_sl_sync_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  q->state                 = SRSRAN_UE_SL_SYNC_STATE_FIND;
+  q->next_rf_sample_offset = 0;
+  q->find_buffer_len       = 0;
+  q->nof_find_sf           = 0;
+  q->nof_lost              = 0;
+}
+
+static int ue_sl_sync_run_find(srsran_ue_sl_sync_t* q, const cf_t* buffer, srsran_ue_sl_sync_outcome_t* outcome)
+{
+  // Keep the last two subframes, so that an SLSS subframe starting in the first one is entirely available
+  if (q->find_buffer_len == 2 * q->sf_len) {
+    memmove(q->find_buffer, &q->find_buffer[q->sf_len], sizeof(cf_t) * q->sf_len);
+    q->find_buffer_len = q->sf_len;
+  }
+  srsran_vec_cf_copy(&q->find_buffer[q->find_buffer_len], buffer, q->sf_len);
+  q->find_buffer_len += q->sf_len;
+  if (q->find_buffer_len < 2 * q->sf_len) {
+    return SRSRAN_SUCCESS;
+  }
+
+  q->nof_psss_find++;
+  if (srsran_psss_find(&q->psss, q->find_buffer, q->cell.nof_prb, q->cell.cp) == SRSRAN_SUCCESS) {
+    uint32_t lag    = (uint32_t)q->psss.corr_peak_pos - q->sf_len;
+    float    cfo_hz = q->args.disable_cfo ? 0.0f : q->psss.cfo * UE_SL_SYNC_SCS_HZ;
+
+    // Correct the CFO measured on the PSSS before correlating the SSSS
+    srsran_vec_apply_cfo(&q->find_buffer[lag], (float)(-cfo_hz / q->srate_hz), q->slss_buffer, (int)q->sf_len);
+
+    if (srsran_ssss_find(&q->ssss, q->slss_buffer, q->cell.nof_prb, q->psss.N_id_2, q->cell.cp) == SRSRAN_SUCCESS) {
+      INFO("SLSS found N_sl_id=%d, lag=%d, cfo=%.1f Hz", q->ssss.N_sl_id, lag, cfo_hz);
+
+      q->cell.N_sl_id = q->ssss.N_sl_id;
+      q->N_id_2       = q->psss.N_id_2;
+      q->cfo_hz       = cfo_hz;
+      q->nof_lost     = 0;
+      q->state        = SRSRAN_UE_SL_SYNC_STATE_TRACK;
+
+      // The SLSS subframe started lag samples into the previous subframe. Skipping them aligns the next read, which
+      // is the second subframe after the SLSS one
+      q->next_rf_sample_offset = (int32_t)lag;
+      q->sf_cnt                = 2 % q->args.slss_period_ms;
+
+      outcome->slss = true;
+      return SRSRAN_SUCCESS;
+    }
+  }
+
+  // The last symbols of every window can not hold a PSSS that is found, shift the windows by half a subframe after
+  // searching a whole SLSS period
+  if (++q->nof_find_sf >= q->args.slss_period_ms) {
+    q->nof_find_sf           = 0;
+    q->find_buffer_len       = 0;
+    q->next_rf_sample_offset = (int32_t)q->sf_len / 2;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static int ue_sl_sync_run_track(srsran_ue_sl_sync_t* q, cf_t* buffer, srsran_ue_sl_sync_outcome_t* outcome)
+{
+  outcome->sf_cnt = q->sf_cnt;
+  q->sf_cnt       = (q->sf_cnt + 1) % q->args.slss_period_ms;
+
+  // Nothing to do outside the SLSS subframes
+  if (outcome->sf_cnt != 0) {
+    return SRSRAN_SUCCESS;
+  }
+
+  q->nof_psss_track++;
+  if (srsran_psss_track(&q->psss, buffer, q->cell.nof_prb, q->N_id_2, q->args.track_window) == SRSRAN_SUCCESS &&
+      q->psss.corr_peak_norm >= q->args.track_thr) {
+    int32_t lag = q->psss.corr_peak_pos - (int32_t)q->sf_len;
+
+    // The samples have already been corrected, the PSSS measures the residual CFO
+    if (!q->args.disable_cfo) {
+      q->cfo_hz += q->psss.cfo * UE_SL_SYNC_SCS_HZ * q->args.cfo_alpha;
+    }
+    q->last_sample_offset    = lag;
+    q->next_rf_sample_offset = lag;
+    q->nof_lost              = 0;
+
+    outcome->slss = true;
+    return SRSRAN_SUCCESS;
+  }
+
+  q->nof_lost++;
+  INFO("SLSS missed in track state (%d/%d), corr=%.2f", q->nof_lost, q->args.max_lost, q->psss.corr_peak_norm);
+  if (q->nof_lost >= q->args.max_lost) {
+    srsran_ue_sl_sync_reset(q);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static int ue_sl_sync_recv(srsran_ue_sl_sync_t* q, cf_t* buffer, srsran_timestamp_t* timestamp)
+{
+  uint32_t buffer_offset = 0;
+  uint32_t nof_samples   = q->sf_len;
+
+  if (q->next_rf_sample_offset > 0) {
+    // Discard a number of samples from RF
+    if (q->args.recv_callback(q->args.recv_obj, buffer, (uint32_t)q->next_rf_sample_offset, timestamp) <
+        SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
+    }
+  } else if (q->next_rf_sample_offset < 0) {
+    // Initialise first offset samples to zero
+    buffer_offset = (uint32_t)(-q->next_rf_sample_offset);
+    nof_samples   = q->sf_len - buffer_offset;
+    srsran_vec_cf_zero(buffer, buffer_offset);
+  }
+  q->next_rf_sample_offset = 0;
+
+  if (q->args.recv_callback(q->args.recv_obj, &buffer[buffer_offset], nof_samples, timestamp) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_ue_sl_sync_zerocopy(srsran_ue_sl_sync_t* q, cf_t* buffer, srsran_ue_sl_sync_outcome_t* outcome)
+{
+  if (q == NULL || buffer == NULL || outcome == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  bzero(outcome, sizeof(srsran_ue_sl_sync_outcome_t));
+
+  if (ue_sl_sync_recv(q, buffer, &outcome->timestamp) < SRSRAN_SUCCESS) {
+    ERROR("Error receiving baseband");
+    return SRSRAN_ERROR;
+  }
+
+  bool aligned = (q->state == SRSRAN_UE_SL_SYNC_STATE_TRACK);
+
+  // Run FSM
+  switch (q->state) {
+    case SRSRAN_UE_SL_SYNC_STATE_FIND:
+      if (ue_sl_sync_run_find(q, buffer, outcome) < SRSRAN_SUCCESS) {
+        ERROR("Error running find");
+        return SRSRAN_ERROR;
+      }
+      break;
+    case SRSRAN_UE_SL_SYNC_STATE_TRACK:
+      if (!q->args.disable_cfo) {
+        srsran_vec_apply_cfo(buffer, (float)(-q->cfo_hz / q->srate_hz), buffer, (int)q->sf_len);
+      }
+      if (ue_sl_sync_run_track(q, buffer, outcome) < SRSRAN_SUCCESS) {
+        ERROR("Error running track");
+        return SRSRAN_ERROR;
+      }
+      break;
+  }
+
+  // Fill outcome
+  outcome->in_sync       = aligned && (q->state == SRSRAN_UE_SL_SYNC_STATE_TRACK);
+  outcome->N_sl_id       = q->cell.N_sl_id;
+  outcome->cfo_hz        = q->cfo_hz;
+  outcome->sample_offset = q->last_sample_offset;
+
+  return SRSRAN_SUCCESS;
+}
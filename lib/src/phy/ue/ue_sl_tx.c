@@ -0,0 +1,399 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "srsran/phy/common/phy_common_sl.h"
+#include "srsran/phy/dft/dft_precoding.h"
+#include "srsran/phy/phch/ra.h"
+#include "srsran/phy/phch/ra_sl.h"
+#include "srsran/phy/ue/ue_sl_tx.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+
+typedef struct {
+  pthread_t          thread;
+  bool               started;
+  srsran_ue_sl_tx_t* q;
+
+  srsran_pscch_t    pscch;
+  srsran_pssch_t    pssch;
+  srsran_chest_sl_t pscch_chest;
+  srsran_chest_sl_t pssch_chest;
+  srsran_sci_t      sci;
+} ue_sl_tx_worker_t;
+
+static int ue_sl_tx_worker_init(srsran_ue_sl_tx_t* q, ue_sl_tx_worker_t* w)
+{
+  w->q = q;
+
+  if (srsran_pscch_init(&w->pscch, SRSRAN_MAX_PRB) != SRSRAN_SUCCESS) {
+    ERROR("Error in PSCCH init");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_pscch_set_cell(&w->pscch, q->cell) != SRSRAN_SUCCESS) {
+    ERROR("Error in PSCCH set cell");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_chest_sl_init(&w->pscch_chest, SRSRAN_SIDELINK_PSCCH, q->cell, &q->sl_comm_resource_pool) !=
+      SRSRAN_SUCCESS) {
+    ERROR("Error in chest PSCCH init");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_pssch_init(&w->pssch, &q->cell, &q->sl_comm_resource_pool) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing PSSCH");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_chest_sl_init(&w->pssch_chest, SRSRAN_SIDELINK_PSSCH, q->cell, &q->sl_comm_resource_pool) !=
+      SRSRAN_SUCCESS) {
+    ERROR("Error in chest PSSCH init");
+    return SRSRAN_ERROR;
+  }
+  if (srsran_sci_init(&w->sci, &q->cell, &q->sl_comm_resource_pool) != SRSRAN_SUCCESS) {
+    ERROR("Error initializing SCI");
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+static void ue_sl_tx_worker_free(ue_sl_tx_worker_t* w)
+{
+  srsran_sci_free(&w->sci);
+  srsran_pscch_free(&w->pscch);
+  srsran_pssch_free(&w->pssch);
+  srsran_chest_sl_free(&w->pscch_chest);
+  srsran_chest_sl_free(&w->pssch_chest);
+}
+
+/// PSSCH PRB allocation of a grant, as derived by the receivers from the SCI (3GPP TS 36.213 Section 14.1.1.4C)
+static void ue_sl_tx_pssch_alloc(srsran_ue_sl_tx_t* q,
+                                 uint32_t           pscch_nof_prb,
+                                 uint32_t           sub_channel_idx,
+                                 uint32_t           L_subCH,
+                                 uint32_t*          prb_start_idx,
+                                 uint32_t*          nof_prb)
+{
+  const srsran_sl_comm_resource_pool_t* pool = &q->sl_comm_resource_pool;
+
+  *prb_start_idx = (sub_channel_idx * pool->size_sub_channel) + pscch_nof_prb + pool->start_prb_sub_channel;
+  *nof_prb = ((L_subCH + sub_channel_idx) * pool->size_sub_channel) - *prb_start_idx + pool->start_prb_sub_channel;
+
+  // make sure PRBs are valid for DFT precoding
+  *nof_prb = srsran_dft_precoding_get_valid_prb(*nof_prb);
+}
+
+static int ue_sl_tx_encode_grant(ue_sl_tx_worker_t* w, const srsran_ue_sl_tx_grant_t* g, uint32_t sf_idx)
+{
+  srsran_ue_sl_tx_t* q = w->q;
+
+  uint8_t sci_tx[SRSRAN_SCI_MAX_LEN] = {};
+
+  // SCI Format 1
+  w->sci.riv = srsran_ra_sl_type0_to_riv(q->sl_comm_resource_pool.num_sub_channel, g->sub_channel_idx, g->L_subCH);
+  w->sci.mcs_idx         = g->mcs_idx;
+  w->sci.priority        = g->priority;
+  w->sci.resource_reserv = g->resource_reserv;
+  w->sci.time_gap        = g->time_gap;
+  w->sci.retransmission  = g->retransmission;
+  if (srsran_sci_format1_pack(&w->sci, sci_tx) != SRSRAN_SUCCESS) {
+    ERROR("Error packing SCI Format 1");
+    return SRSRAN_ERROR;
+  }
+
+  // PSCCH and its DMRS
+  uint32_t pscch_prb_start_idx = g->sub_channel_idx * q->sl_comm_resource_pool.size_sub_channel;
+  if (srsran_pscch_encode(&w->pscch, sci_tx, q->sf_buffer, pscch_prb_start_idx) != SRSRAN_SUCCESS) {
+    ERROR("Error encoding PSCCH");
+    return SRSRAN_ERROR;
+  }
+
+  srsran_chest_sl_cfg_t pscch_chest_sl_cfg = {};
+  pscch_chest_sl_cfg.cyclic_shift          = g->cyclic_shift;
+  pscch_chest_sl_cfg.prb_start_idx         = pscch_prb_start_idx;
+  srsran_chest_sl_set_cfg(&w->pscch_chest, pscch_chest_sl_cfg);
+  if (srsran_chest_sl_put_dmrs(&w->pscch_chest, q->sf_buffer) != SRSRAN_SUCCESS) {
+    ERROR("Error mapping PSCCH DMRS");
+    return SRSRAN_ERROR;
+  }
+
+  // The PSSCH is scrambled with the SCI CRC
+  uint32_t N_x_id = 0;
+  for (int j = 0; j < SRSRAN_SCI_CRC_LEN; j++) {
+    N_x_id += w->pscch.sci_crc[j] * (1U << (SRSRAN_SCI_CRC_LEN - 1 - j));
+  }
+
+  uint32_t pssch_prb_start_idx = 0;
+  uint32_t nof_prb_pssch       = 0;
+  ue_sl_tx_pssch_alloc(q, w->pscch.pscch_nof_prb, g->sub_channel_idx, g->L_subCH, &pssch_prb_start_idx, &nof_prb_pssch);
+
+  uint32_t           rv_idx    = g->retransmission ? 1 : 0;
+  srsran_pssch_cfg_t pssch_cfg = {pssch_prb_start_idx, nof_prb_pssch, N_x_id, g->mcs_idx, rv_idx, sf_idx, NULL};
+  if (srsran_pssch_set_cfg(&w->pssch, pssch_cfg) != SRSRAN_SUCCESS) {
+    ERROR("Error configuring PSSCH");
+    return SRSRAN_ERROR;
+  }
+  if (w->pssch.sl_sch_tb_len != g->tb_len) {
+    ERROR("Transport block of %d bits does not match the allocation of %d bits", g->tb_len, w->pssch.sl_sch_tb_len);
+    return SRSRAN_ERROR;
+  }
+  if (srsran_pssch_encode(&w->pssch, (uint8_t*)g->tb, g->tb_len, q->sf_buffer) != SRSRAN_SUCCESS) {
+    ERROR("Error encoding PSSCH");
+    return SRSRAN_ERROR;
+  }
+
+  srsran_chest_sl_cfg_t pssch_chest_sl_cfg = {};
+  pssch_chest_sl_cfg.N_x_id                = N_x_id;
+  pssch_chest_sl_cfg.sf_idx                = sf_idx;
+  pssch_chest_sl_cfg.prb_start_idx         = pssch_prb_start_idx;
+  pssch_chest_sl_cfg.nof_prb               = nof_prb_pssch;
+  srsran_chest_sl_set_cfg(&w->pssch_chest, pssch_chest_sl_cfg);
+  if (srsran_chest_sl_put_dmrs(&w->pssch_chest, q->sf_buffer) != SRSRAN_SUCCESS) {
+    ERROR("Error mapping PSSCH DMRS");
+    return SRSRAN_ERROR;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+/// Takes grants from the current batch until there are none left, used by the workers and the calling thread
+static void ue_sl_tx_run_grants(srsran_ue_sl_tx_t* q, ue_sl_tx_worker_t* w)
+{
+  while (q->next_grant < q->nof_grants) {
+    uint32_t idx = q->next_grant++;
+    pthread_mutex_unlock(&q->mutex);
+
+    int ret = ue_sl_tx_encode_grant(w, &q->grants[idx], q->sf_idx);
+
+    pthread_mutex_lock(&q->mutex);
+    if (ret != SRSRAN_SUCCESS) {
+      q->ret = SRSRAN_ERROR;
+    }
+    q->nof_pending--;
+    if (q->nof_pending == 0) {
+      pthread_cond_signal(&q->cvar_done);
+    }
+  }
+}
+
+static void* ue_sl_tx_worker_thread(void* arg)
+{
+  ue_sl_tx_worker_t* w = (ue_sl_tx_worker_t*)arg;
+  srsran_ue_sl_tx_t* q = w->q;
+
+  pthread_mutex_lock(&q->mutex);
+  while (!q->quit) {
+    if (q->next_grant >= q->nof_grants) {
+      pthread_cond_wait(&q->cvar_work, &q->mutex);
+      continue;
+    }
+    ue_sl_tx_run_grants(q, w);
+  }
+  pthread_mutex_unlock(&q->mutex);
+
+  return NULL;
+}
+
+int srsran_ue_sl_tx_init(srsran_ue_sl_tx_t*                    q,
+                         const srsran_cell_sl_t*               cell,
+                         const srsran_sl_comm_resource_pool_t* sl_comm_resource_pool,
+                         const srsran_ue_sl_tx_args_t*         args,
+                         cf_t*                                 out_buffer)
+{
+  if (q == NULL || cell == NULL || sl_comm_resource_pool == NULL || args == NULL || out_buffer == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  bzero(q, sizeof(srsran_ue_sl_tx_t));
+
+  if (cell->tm != SRSRAN_SIDELINK_TM3 && cell->tm != SRSRAN_SIDELINK_TM4) {
+    ERROR("Sidelink transmitter only supports TM3 and TM4");
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+  if (args->nof_workers > SRSRAN_UE_SL_TX_MAX_WORKERS) {
+    ERROR("Invalid number of workers %d", args->nof_workers);
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  q->cell                  = *cell;
+  q->sl_comm_resource_pool = *sl_comm_resource_pool;
+  q->args                  = *args;
+
+  pthread_mutex_init(&q->mutex, NULL);
+  pthread_cond_init(&q->cvar_work, NULL);
+  pthread_cond_init(&q->cvar_done, NULL);
+
+  q->sf_buffer = srsran_vec_cf_malloc(SRSRAN_SF_LEN_RE(cell->nof_prb, cell->cp));
+  if (!q->sf_buffer) {
+    ERROR("Error allocating memory");
+    goto clean_exit;
+  }
+
+  srsran_ofdm_cfg_t ofdm_cfg = {};
+  ofdm_cfg.nof_prb           = cell->nof_prb;
+  ofdm_cfg.cp                = cell->cp;
+  ofdm_cfg.normalize         = true;
+  ofdm_cfg.sf_type           = SRSRAN_SF_NORM;
+  ofdm_cfg.freq_shift_f      = 0.5;
+  ofdm_cfg.in_buffer         = q->sf_buffer;
+  ofdm_cfg.out_buffer        = out_buffer;
+  if (srsran_ofdm_tx_init_cfg(&q->ifft, &ofdm_cfg)) {
+    ERROR("Error initiating IFFT");
+    goto clean_exit;
+  }
+
+  // All PHY objects are created from this thread since FFTW planning and table generation are not thread-safe
+  q->workers = calloc(args->nof_workers + 1, sizeof(ue_sl_tx_worker_t));
+  if (!q->workers) {
+    ERROR("Error allocating memory");
+    goto clean_exit;
+  }
+  ue_sl_tx_worker_t* workers = (ue_sl_tx_worker_t*)q->workers;
+  for (uint32_t i = 0; i < args->nof_workers + 1; i++) {
+    if (ue_sl_tx_worker_init(q, &workers[i]) != SRSRAN_SUCCESS) {
+      goto clean_exit;
+    }
+  }
+
+  // Worker 0 is run by the thread calling srsran_ue_sl_tx_encode()
+  for (uint32_t i = 1; i < args->nof_workers + 1; i++) {
+    if (pthread_create(&workers[i].thread, NULL, ue_sl_tx_worker_thread, &workers[i])) {
+      perror("pthread_create");
+      goto clean_exit;
+    }
+    workers[i].started = true;
+  }
+
+  return SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_ue_sl_tx_free(q);
+  return SRSRAN_ERROR;
+}
+
+void srsran_ue_sl_tx_free(srsran_ue_sl_tx_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+
+  ue_sl_tx_worker_t* workers = (ue_sl_tx_worker_t*)q->workers;
+  if (workers) {
+    pthread_mutex_lock(&q->mutex);
+    q->quit = true;
+    pthread_cond_broadcast(&q->cvar_work);
+    pthread_mutex_unlock(&q->mutex);
+
+    for (uint32_t i = 0; i < q->args.nof_workers + 1; i++) {
+      if (workers[i].started) {
+        pthread_join(workers[i].thread, NULL);
+      }
+    }
+    for (uint32_t i = 0; i < q->args.nof_workers + 1; i++) {
+      ue_sl_tx_worker_free(&workers[i]);
+    }
+    free(workers);
+  }
+
+  srsran_ofdm_tx_free(&q->ifft);
+  if (q->sf_buffer) {
+    free(q->sf_buffer);
+  }
+
+  pthread_cond_destroy(&q->cvar_work);
+  pthread_cond_destroy(&q->cvar_done);
+  pthread_mutex_destroy(&q->mutex);
+
+  bzero(q, sizeof(srsran_ue_sl_tx_t));
+}
+
+uint32_t srsran_ue_sl_tx_get_tb_len(srsran_ue_sl_tx_t* q, uint32_t L_subCH, uint32_t mcs_idx)
+{
+  if (q == NULL || q->workers == NULL) {
+    return 0;
+  }
+
+  ue_sl_tx_worker_t* w             = (ue_sl_tx_worker_t*)q->workers;
+  uint32_t           prb_start_idx = 0;
+  uint32_t           nof_prb       = 0;
+  ue_sl_tx_pssch_alloc(q, w->pscch.pscch_nof_prb, 0, L_subCH, &prb_start_idx, &nof_prb);
+
+  return srsran_ra_tbs_from_idx(srsran_ra_tbs_idx_from_mcs(mcs_idx, false, true), nof_prb);
+}
+
+int srsran_ue_sl_tx_encode(srsran_ue_sl_tx_t*             q,
+                           const srsran_ue_sl_tx_grant_t* grants,
+                           uint32_t                       nof_grants,
+                           uint32_t                       sf_idx)
+{
+  if (q == NULL || (grants == NULL && nof_grants > 0)) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // Every grant owns its subchannels, so the workers write disjoint parts of the subframe
+  bool used[SRSRAN_MAX_PRB] = {};
+  for (uint32_t i = 0; i < nof_grants; i++) {
+    const srsran_ue_sl_tx_grant_t* g = &grants[i];
+    if (g->L_subCH == 0 || g->sub_channel_idx + g->L_subCH > q->sl_comm_resource_pool.num_sub_channel ||
+        g->tb == NULL || g->cyclic_shift > 9 || g->cyclic_shift % 3 != 0) {
+      ERROR("Invalid sidelink grant %d", i);
+      return SRSRAN_ERROR_INVALID_INPUTS;
+    }
+    for (uint32_t n = g->sub_channel_idx; n < g->sub_channel_idx + g->L_subCH; n++) {
+      if (used[n]) {
+        ERROR("Sidelink grant %d overlaps subchannel %d", i, n);
+        return SRSRAN_ERROR_INVALID_INPUTS;
+      }
+      used[n] = true;
+    }
+  }
+
+  srsran_vec_cf_zero(q->sf_buffer, SRSRAN_SF_LEN_RE(q->cell.nof_prb, q->cell.cp));
+
+  pthread_mutex_lock(&q->mutex);
+  q->grants      = grants;
+  q->nof_grants  = nof_grants;
+  q->next_grant  = 0;
+  q->nof_pending = nof_grants;
+  q->sf_idx      = sf_idx % SRSRAN_NOF_SF_X_FRAME;
+  q->ret         = SRSRAN_SUCCESS;
+  if (nof_grants > 1) {
+    pthread_cond_broadcast(&q->cvar_work);
+  }
+
+  // The calling thread takes grants too and then waits for the ones still in the workers
+  ue_sl_tx_run_grants(q, (ue_sl_tx_worker_t*)q->workers);
+  while (q->nof_pending > 0) {
+    pthread_cond_wait(&q->cvar_done, &q->mutex);
+  }
+  int ret       = q->ret;
+  q->grants     = NULL;
+  q->nof_grants = 0;
+  q->next_grant = 0;
+  pthread_mutex_unlock(&q->mutex);
+
+  // A single IFFT for all grants
+  srsran_ofdm_tx_sf(&q->ifft);
+
+  return ret;
+}
@@ -502,6 +502,26 @@ TEST(
     free(x);
     free(z);)
 
+TEST(
+    srsran_vec_convert_bf, MALLOC(int8_t, x); MALLOC(float, z); float scale = 127.0f;
+
+    float gold;
+    float k = 1.0f / scale;
+    for (int i = 0; i < block_size; i++) { x[i] = RANDOM_B(); }
+
+    TEST_CALL(srsran_vec_convert_bf(x, scale, z, block_size))
+
+        for (int i = 0; i < block_size; i++) {
+          gold       = ((float)x[i]) * k;
+          double err = fabsf((float)gold - (float)z[i]);
+          if (err > mse) {
+            mse = err;
+          }
+        }
+
+    free(x);
+    free(z);)
+
 TEST(
     srsran_vec_prod_fff, MALLOC(float, x); MALLOC(float, y); MALLOC(float, z);
 
@@ -963,6 +983,10 @@ int main(int argc, char** argv)
         test_srsran_vec_convert_if(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
 
+    passed[func_count][size_count] =
+        test_srsran_vec_convert_bf(func_names[func_count], &timmings[func_count][size_count], block_size);
+    func_count++;
+
     passed[func_count][size_count] =
         test_srsran_vec_prod_fff(func_names[func_count], &timmings[func_count][size_count], block_size);
     func_count++;
@@ -134,6 +134,11 @@ void srsran_vec_convert_fb(const float* x, const float scale, int8_t* z, const u
   srsran_vec_convert_fb_simd(x, z, scale, len);
 }
 
+void srsran_vec_convert_bf(const int8_t* x, const float scale, float* z, const uint32_t len)
+{
+  srsran_vec_convert_bf_simd(x, z, scale, len);
+}
+
 void srsran_vec_lut_sss(const short* x, const unsigned short* lut, short* y, const uint32_t len)
 {
   srsran_vec_lut_sss_simd(x, lut, y, len);
@@ -407,6 +407,14 @@ void srsran_vec_convert_if_simd(const int16_t* x, float* z, const float scale, c
   int         i    = 0;
   const float gain = 1.0f / scale;
 
+#ifdef LV_HAVE_AVX2
+  __m256 s8 = _mm256_set1_ps(gain);
+  for (; i < len - 7; i += 8) {
+    __m256i i32 = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i*)&x[i]));
+    _mm256_storeu_ps(&z[i], _mm256_mul_ps(_mm256_cvtepi32_ps(i32), s8));
+  }
+#endif /* LV_HAVE_AVX2 */
+
 #ifdef LV_HAVE_SSE
   __m128 s = _mm_set1_ps(gain);
   if (SRSRAN_IS_ALIGNED(z)) {
@@ -588,6 +596,34 @@ void srsran_vec_convert_fb_simd(const float* x, int8_t* z, const float scale, co
   }
 }
 
+void srsran_vec_convert_bf_simd(const int8_t* x, float* z, const float scale, const int len)
+{
+  int         i    = 0;
+  const float gain = 1.0f / scale;
+
+#ifdef LV_HAVE_AVX2
+  __m256 s = _mm256_set1_ps(gain);
+  for (; i < len - 7; i += 8) {
+    __m256i i32 = _mm256_cvtepi8_epi32(_mm_loadl_epi64((__m128i*)&x[i]));
+    _mm256_storeu_ps(&z[i], _mm256_mul_ps(_mm256_cvtepi32_ps(i32), s));
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  __m128 s4 = _mm_set1_ps(gain);
+  for (; i < len - 3; i += 4) {
+    int32_t packed;
+    memcpy(&packed, &x[i], sizeof(int32_t));
+    __m128i i32 = _mm_cvtepi8_epi32(_mm_cvtsi32_si128(packed));
+    _mm_storeu_ps(&z[i], _mm_mul_ps(_mm_cvtepi32_ps(i32), s4));
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < len; i++) {
+    z[i] = ((float)x[i]) * gain;
+  }
+}
+
 float srsran_vec_acc_ff_simd(const float* x, const int len)
 {
   int   i       = 0;
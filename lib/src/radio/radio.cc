@@ -47,6 +47,14 @@ radio::~radio()
   for (srsran_resampler_fft_t& q : decimators) {
     srsran_resampler_fft_free(&q);
   }
+
+  for (srsran_resampler_poly_t& q : tx_resamplers) {
+    srsran_resampler_poly_free(&q);
+  }
+
+  for (srsran_resampler_poly_t& q : rx_resamplers) {
+    srsran_resampler_poly_free(&q);
+  }
 }
 
 int radio::init(const rf_args_t& args, phy_interface_radio* phy_)
@@ -295,25 +303,32 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
 
   // Extract decimation ratio. As the decimation may take some time to set a new ratio, deactivate the decimation and
   // keep receiving samples to avoid stalling the RX stream
-  uint32_t ratio = 1; // No decimation by default
+  uint32_t ratio     = 1; // No decimation by default
+  bool     resampler = false;
   if (decimator_busy) {
     lock.unlock();
   } else if (decimators[0].ratio > 1) {
     ratio = decimators[0].ratio;
+  } else if (rx_resamplers[0].filter != nullptr) {
+    resampler = true;
   }
 
-  // Calculate number of samples, considering the decimation ratio
+  // Calculate number of samples, considering the decimation ratio or the input the resampler needs for the requested
+  // number of samples
   uint32_t nof_samples = buffer.get_nof_samples() * ratio;
+  if (resampler) {
+    nof_samples = srsran_resampler_poly_nof_input(&rx_resamplers[0], buffer.get_nof_samples());
+  }
 
   // Check decimation buffer protection
-  if (ratio > 1 && nof_samples > rx_buffer[0].size()) {
+  if ((ratio > 1 || resampler) && nof_samples > rx_buffer[0].size()) {
     // This is a corner case that could happen during sample rate change transitions, as it does not have a negative
     // impact, log it as info.
     fmt::memory_buffer buff;
     fmt::format_to(buff,
                    "Rx number of samples ({}/{}) exceeds buffer size ({})",
                    buffer.get_nof_samples(),
-                   buffer.get_nof_samples() * ratio,
+                   nof_samples,
                    rx_buffer[0].size());
     logger.info("%s", to_c_str(buff));
 
@@ -327,22 +342,10 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
   // If the interpolator have been set, interpolate
   for (uint32_t ch = 0; ch < nof_channels; ch++) {
     // Use rx buffer if decimator is required
-    buffer_rx.set(ch, ratio > 1 ? rx_buffer[ch].data() : buffer.get(ch));
+    buffer_rx.set(ch, (ratio > 1 || resampler) ? rx_buffer[ch].data() : buffer.get(ch));
   }
 
-  if (not radio_is_streaming) {
-    for (srsran_rf_t& rf_device : rf_devices) {
-      srsran_rf_start_rx_stream(&rf_device, false);
-    }
-    radio_is_streaming = true;
-
-    // Flush buffers to compensate settling time
-    if (rf_devices.size() > 1) {
-      for (srsran_rf_t& rf_device : rf_devices) {
-        srsran_rf_flush_buffer(&rf_device);
-      }
-    }
-  }
+  start_rx_stream_nolock();
 
   for (uint32_t device_idx = 0; device_idx < (uint32_t)rf_devices.size(); device_idx++) {
     ret &= rx_dev(device_idx, buffer_rx, rxd_time.get_ptr(device_idx));
@@ -357,10 +360,90 @@ bool radio::rx_now(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time
     }
   }
 
+  // Perform resampling, the output is short only if the input was limited by the buffer size
+  if (resampler) {
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      if (buffer.get(ch) and buffer_rx.get(ch)) {
+        uint32_t count = srsran_resampler_poly_run(&rx_resamplers[ch],
+                                                   buffer_rx.get(ch),
+                                                   buffer_rx.get_nof_samples(),
+                                                   buffer.get(ch),
+                                                   buffer.get_nof_samples());
+        srsran_vec_cf_zero(&buffer.get(ch)[count], buffer.get_nof_samples() - count);
+      }
+    }
+
+    // The first output sample is delayed by the filter group delay, move the timestamp back accordingly
+    rxd_time.sub(srsran_resampler_poly_get_delay(&rx_resamplers[0]) / rx_resamplers[0].input_srate);
+  }
+
   return ret;
 }
 
-bool radio::rx_dev(const uint32_t& device_idx, const rf_buffer_interface& buffer, srsran_timestamp_t* rxd_time)
+bool radio::has_rx_sc16()
+{
+  std::unique_lock<std::mutex> lock(rx_mutex);
+
+  if (not is_initialized or rf_devices.empty()) {
+    return false;
+  }
+
+  // The integer samples can not go through the decimator nor the resampler
+  if (decimator_busy or decimators[0].ratio > 1 or rx_resamplers[0].filter != nullptr) {
+    return false;
+  }
+
+  for (srsran_rf_t& rf_device : rf_devices) {
+    if (not srsran_rf_has_rx_sc16(&rf_device)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool radio::rx_now_sc16(rf_buffer_interface& buffer, rf_timestamp_interface& rxd_time, float* scale)
+{
+  std::unique_lock<std::mutex> lock(rx_mutex);
+  bool                         ret = true;
+
+  // The sample rate may have changed since has_rx_sc16() was checked
+  if (decimator_busy or decimators[0].ratio > 1 or rx_resamplers[0].filter != nullptr) {
+    return false;
+  }
+
+  start_rx_stream_nolock();
+
+  for (uint32_t device_idx = 0; device_idx < (uint32_t)rf_devices.size(); device_idx++) {
+    ret &= rx_dev(device_idx, buffer, rxd_time.get_ptr(device_idx), scale);
+  }
+
+  return ret;
+}
+
+void radio::start_rx_stream_nolock()
+{
+  if (radio_is_streaming) {
+    return;
+  }
+
+  for (srsran_rf_t& rf_device : rf_devices) {
+    srsran_rf_start_rx_stream(&rf_device, false);
+  }
+  radio_is_streaming = true;
+
+  // Flush buffers to compensate settling time
+  if (rf_devices.size() > 1) {
+    for (srsran_rf_t& rf_device : rf_devices) {
+      srsran_rf_flush_buffer(&rf_device);
+    }
+  }
+}
+
+bool radio::rx_dev(const uint32_t&            device_idx,
+                   const rf_buffer_interface& buffer,
+                   srsran_timestamp_t*        rxd_time,
+                   float*                     scale)
 {
   if (!is_initialized) {
     return false;
@@ -397,8 +480,24 @@ bool radio::rx_dev(const uint32_t& device_idx, const rf_buffer_interface& buffer
   // Subtract number of offset samples
   rx_offset_n.at(device_idx) = nof_samples_offset - ((int)nof_samples - (int)buffer.get_nof_samples());
 
-  int ret =
-      srsran_rf_recv_with_time_multi(&rf_devices[device_idx], radio_buffers, nof_samples, true, full_secs, frac_secs);
+  int ret = 0;
+  if (scale != nullptr) {
+    float dev_scale = 1.0f;
+    ret             = srsran_rf_recv_with_time_multi_sc16(
+        &rf_devices[device_idx], (int16_t**)radio_buffers, nof_samples, true, full_secs, frac_secs, &dev_scale);
+
+    // All the logical channels of the device share its scale
+    for (uint32_t i = 0; i < nof_carriers; i++) {
+      for (uint32_t j = 0; j < nof_antennas and rx_channel_mapping.is_allocated(i); j++) {
+        if (rx_channel_mapping.get_device_mapping(i, j).device_idx == device_idx) {
+          scale[i * nof_antennas + j] = dev_scale;
+        }
+      }
+    }
+  } else {
+    ret =
+        srsran_rf_recv_with_time_multi(&rf_devices[device_idx], radio_buffers, nof_samples, true, full_secs, frac_secs);
+  }
 
   // If the number of received samples filled the buffer, there is nothing else to do
   if (buffer.get_nof_samples() <= nof_samples) {
@@ -408,7 +507,10 @@ bool radio::rx_dev(const uint32_t& device_idx, const rf_buffer_interface& buffer
   // Otherwise, set rest of buffer to zero
   uint32_t nof_zeros = buffer.get_nof_samples() - nof_samples;
   for (auto& b : radio_buffers) {
-    if (b != nullptr) {
+    if (b != nullptr and scale != nullptr) {
+      int16_t* ptr = (int16_t*)b;
+      srsran_vec_i16_zero(&ptr[2 * nof_samples], 2 * nof_zeros);
+    } else if (b != nullptr) {
       cf_t* ptr = (cf_t*)b;
       srsran_vec_cf_zero(&ptr[nof_samples], nof_zeros);
     }
@@ -454,6 +556,19 @@ bool radio::tx(rf_buffer_interface& buffer, const rf_timestamp_interface& tx_tim
 
     // Set buffer size after applying the interpolation
     buffer.set_nof_samples(nof_samples * ratio);
+  } else if (tx_resamplers[0].filter != nullptr) {
+    // Resample to the fixed rate, the number of samples at the output follows the rate ratio from one call to another
+    uint32_t count = 0;
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      count = srsran_resampler_poly_run(
+          &tx_resamplers[ch], buffer.get(ch), nof_samples, tx_buffer[ch].data(), (uint32_t)tx_buffer[ch].size());
+
+      // Set the buffer pointer
+      buffer.set(ch, tx_buffer[ch].data());
+    }
+
+    // Set buffer size after applying the resampling
+    buffer.set_nof_samples(count);
   }
 
   for (uint32_t device_idx = 0; device_idx < (uint32_t)rf_devices.size(); device_idx++) {
@@ -746,17 +861,23 @@ void radio::set_rx_srate(const double& srate)
       }
     }
 
-    // Assert ratio is integer
-    srsran_assert(((uint32_t)cur_rx_srate % (uint32_t)srate) == 0,
-                  "The sampling rate ratio is not integer (%.2f MHz / %.2f MHz = %.3f)",
-                  cur_rx_srate / 1e6,
-                  srate / 1e6,
-                  cur_rx_srate / srate);
-
-    // Update decimators
-    uint32_t ratio = (uint32_t)ceil(cur_rx_srate / srate);
-    for (uint32_t ch = 0; ch < nof_channels; ch++) {
-      srsran_resampler_fft_init(&decimators[ch], SRSRAN_RESAMPLER_MODE_DECIMATE, ratio);
+    if (((uint32_t)cur_rx_srate % (uint32_t)srate) == 0) {
+      // Update decimators
+      uint32_t ratio = (uint32_t)ceil(cur_rx_srate / srate);
+      for (uint32_t ch = 0; ch < nof_channels; ch++) {
+        srsran_resampler_fft_init(&decimators[ch], SRSRAN_RESAMPLER_MODE_DECIMATE, ratio);
+        srsran_resampler_poly_free(&rx_resamplers[ch]);
+      }
+    } else {
+      // The sampling rate ratio is not integer, use the polyphase resampler
+      logger.info("Resampling Rx from %.2f MHz to %.2f MHz", cur_rx_srate / 1e6, srate / 1e6);
+      for (uint32_t ch = 0; ch < nof_channels; ch++) {
+        srsran_resampler_fft_free(&decimators[ch]);
+        srsran_assert(srsran_resampler_poly_init(&rx_resamplers[ch], cur_rx_srate, srate) == SRSRAN_SUCCESS,
+                      "Error initiating Rx resampler (%.2f MHz / %.2f MHz)",
+                      cur_rx_srate / 1e6,
+                      srate / 1e6);
+      }
     }
 
     decimator_busy = false;
@@ -1002,17 +1123,23 @@ void radio::set_tx_srate(const double& srate)
       }
     }
 
-    // Assert ratio is integer
-    srsran_assert(((uint32_t)cur_tx_srate % (uint32_t)srate) == 0,
-                  "The sampling rate ratio is not integer (%.2f MHz / %.2f MHz = %.3f)",
-                  cur_rx_srate / 1e6,
-                  srate / 1e6,
-                  cur_rx_srate / srate);
-
-    // Update interpolators
-    uint32_t ratio = (uint32_t)ceil(cur_tx_srate / srate);
-    for (uint32_t ch = 0; ch < nof_channels; ch++) {
-      srsran_resampler_fft_init(&interpolators[ch], SRSRAN_RESAMPLER_MODE_INTERPOLATE, ratio);
+    if (((uint32_t)cur_tx_srate % (uint32_t)srate) == 0) {
+      // Update interpolators
+      uint32_t ratio = (uint32_t)ceil(cur_tx_srate / srate);
+      for (uint32_t ch = 0; ch < nof_channels; ch++) {
+        srsran_resampler_fft_init(&interpolators[ch], SRSRAN_RESAMPLER_MODE_INTERPOLATE, ratio);
+        srsran_resampler_poly_free(&tx_resamplers[ch]);
+      }
+    } else {
+      // The sampling rate ratio is not integer, use the polyphase resampler
+      logger.info("Resampling Tx from %.2f MHz to %.2f MHz", srate / 1e6, cur_tx_srate / 1e6);
+      for (uint32_t ch = 0; ch < nof_channels; ch++) {
+        srsran_resampler_fft_free(&interpolators[ch]);
+        srsran_assert(srsran_resampler_poly_init(&tx_resamplers[ch], srate, cur_tx_srate) == SRSRAN_SUCCESS,
+                      "Error initiating Tx resampler (%.2f MHz / %.2f MHz)",
+                      srate / 1e6,
+                      cur_tx_srate / 1e6);
+      }
     }
   } else {
     for (srsran_rf_t& rf_device : rf_devices) {
@@ -140,6 +140,88 @@ void test_correct_destruction()
   TESTASSERT(C::count == 0);
 }
 
+void test_runtime_capacity_map()
+{
+  circular_map<uint32_t, std::string> mymap(3);
+  TESTASSERT(mymap.capacity() == 3 and mymap.empty() and not mymap.full());
+  TESTASSERT(mymap.begin() == mymap.end());
+
+  // TEST: the capacity is the configured one, even if the number of slots is larger
+  TESTASSERT(mymap.insert(0, "0"));
+  TESTASSERT(mymap.insert(1, "1"));
+  TESTASSERT(mymap.insert(2, "2"));
+  TESTASSERT(mymap.full() and not mymap.has_space(3));
+  TESTASSERT(not mymap.insert(3, "3"));
+
+  // TEST: keys that map to the same slot exclude each other
+  TESTASSERT(mymap.erase(0));
+  TESTASSERT(not mymap.insert(5, "5"));
+  TESTASSERT(mymap.insert(4, "4"));
+  TESTASSERT(mymap.contains(4) and not mymap.contains(0) and mymap[4] == "4");
+  mymap.clear();
+
+  // TEST: sparse iteration over a large map, in key order
+  mymap.set_capacity(1024);
+  std::vector<uint32_t> keys = {1, 63, 64, 200, 1023};
+  for (uint32_t k : keys) {
+    TESTASSERT(mymap.insert(k, std::to_string(k)));
+  }
+  size_t i = 0;
+  for (auto& e : mymap) {
+    TESTASSERT(e.first == keys[i] and e.second == std::to_string(keys[i]));
+    i++;
+  }
+  TESTASSERT(i == keys.size());
+
+  // TEST: erase while iterating
+  for (auto it = mymap.begin(); it != mymap.end();) {
+    it = (it->first % 2 == 1) ? mymap.erase(it) : ++it;
+  }
+  TESTASSERT(mymap.size() == 2 and mymap.contains(64) and mymap.contains(200));
+
+  // TEST: copy and move
+  circular_map<uint32_t, std::string> mymap2(mymap);
+  TESTASSERT(mymap2.size() == 2 and mymap2.capacity() == 1024 and mymap2[200] == "200");
+  const circular_map<uint32_t, std::string> mymap3(std::move(mymap2));
+  TESTASSERT(mymap2.empty() and mymap3.size() == 2);
+  i = 0;
+  for (auto e : mymap3) {
+    TESTASSERT(e->first == keys[2 + i]);
+    i++;
+  }
+  TESTASSERT(mymap3.find(200) != mymap3.end() and mymap3.find(201) == mymap3.end());
+}
+
+void test_runtime_capacity_destruction()
+{
+  TESTASSERT(C::count == 0);
+  {
+    circular_map<uint32_t, C> circ_buffer(4);
+    TESTASSERT(circ_buffer.insert(0, C{}));
+    TESTASSERT(circ_buffer.insert(1, C{}));
+    TESTASSERT(circ_buffer.insert(2, C{}));
+    TESTASSERT(C::count == 3);
+    TESTASSERT(circ_buffer.erase(1));
+    TESTASSERT(C::count == 2);
+
+    circular_map<uint32_t, C> circ_buffer2(4);
+    TESTASSERT(circ_buffer2.insert(3, C{}));
+    circ_buffer2 = std::move(circ_buffer);
+    TESTASSERT(C::count == 2);
+  }
+  TESTASSERT(C::count == 0);
+
+  id_obj_pool<uint32_t, C> pool(1);
+  pool.set_capacity(2);
+  srsran::expected<uint32_t> id = pool.insert(C{});
+  TESTASSERT(id.has_value() and id.value() == 1);
+  TESTASSERT(pool.insert(C{}).has_value());
+  TESTASSERT(pool.full() and not pool.insert(C{}).has_value());
+  TESTASSERT(pool.erase(id.value()));
+  TESTASSERT(pool.insert(C{}).has_value());
+  TESTASSERT(C::count == 2);
+}
+
 } // namespace srsran
 
 int main(int argc, char** argv)
@@ -152,6 +234,8 @@ int main(int argc, char** argv)
   srsran::test_id_map();
   srsran::test_id_map_wraparound();
   srsran::test_correct_destruction();
+  srsran::test_runtime_capacity_map();
+  srsran::test_runtime_capacity_destruction();
 
   printf("Success\n");
   return SRSRAN_SUCCESS;
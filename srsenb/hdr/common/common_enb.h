@@ -35,7 +35,11 @@ namespace srsenb {
 #define SRSENB_RRC_MAX_N_PLMN_IDENTITIES 6
 
 #define SRSENB_N_SRB 3
-#define SRSENB_MAX_UES 64
+#define SRSENB_MAX_UES 64            // Default number of connected UEs
+#define SRSENB_MAX_UES_LIMIT 2048    // Largest number of connected UEs that can be configured
+#define SRSENB_MAX_UPPER_WORKERS 16  // Largest number of worker threads for the PDCP/RLC of the UEs
+#define SRSENB_SPS_FIRST_RNTI 0xF000 // SPS C-RNTIs are allocated above the C-RNTIs of the MAC
+#define SRSENB_SPS_NOF_RNTIS 0xFF0   // Number of SPS C-RNTIs, below the reserved RNTI values
 const uint32_t MAX_ERAB_ID   = 15;
 const uint32_t MAX_NOF_ERABS = 16;
 
@@ -62,9 +66,14 @@ constexpr lte_drb lte_lcid_to_drb(uint32_t lcid)
 #define SRSENB_MAX_BUFFER_SIZE_BYTES 12756
 #define SRSENB_BUFFER_HEADER_OFFSET 1024
 
-/// Typedef of circular map container which key corresponding to rnti value and that can be used across layers
+/// Circular map container which key corresponds to the rnti value and that can be used across layers. Its capacity is
+/// SRSENB_MAX_UES, unless set to the configured number of UEs during initialization
 template <typename UEObject>
-using rnti_map_t = srsran::static_circular_map<uint16_t, UEObject, SRSENB_MAX_UES>;
+class rnti_map_t : public srsran::circular_map<uint16_t, UEObject>
+{
+public:
+  explicit rnti_map_t(size_t max_nof_ues = SRSENB_MAX_UES) : srsran::circular_map<uint16_t, UEObject>(max_nof_ues) {}
+};
 
 } // namespace srsenb
 
@@ -40,9 +40,16 @@ public:
   void init(phy_common* phy, uint32_t cc_idx);
   void reset();
 
-  cf_t* get_buffer_rx(uint32_t antenna_idx);
-  cf_t* get_buffer_tx(uint32_t antenna_idx);
-  void  set_tti(uint32_t tti);
+  cf_t*    get_buffer_rx(uint32_t antenna_idx);
+  int16_t* get_buffer_rx_sc16(uint32_t antenna_idx);
+  cf_t*    get_buffer_tx(uint32_t antenna_idx);
+  void     set_tti(uint32_t tti);
+
+  /**
+   * Selects the RX buffer of the next UL subframe: the 16-bit integer buffer with the given unitary amplitude if scale
+   * is positive, otherwise the float buffer
+   */
+  void set_rx_sc16_scale(float scale);
 
   int      add_rnti(uint16_t rnti);
   void     rem_rnti(uint16_t rnti);
@@ -83,8 +90,10 @@ private:
   phy_common*           phy       = nullptr;
   bool                  initiated = false;
 
-  cf_t*    signal_buffer_rx[SRSRAN_MAX_PORTS] = {};
-  cf_t*    signal_buffer_tx[SRSRAN_MAX_PORTS] = {};
+  cf_t*    signal_buffer_rx[SRSRAN_MAX_PORTS]      = {};
+  int16_t* signal_buffer_rx_sc16[SRSRAN_MAX_PORTS] = {}; ///< Only with rx_sc16, must not alias signal_buffer_rx
+  float    rx_sc16_scale                           = 0.0f;
+  cf_t*    signal_buffer_tx[SRSRAN_MAX_PORTS]      = {};
   uint32_t tti_rx = 0, tti_tx_dl = 0, tti_tx_ul = 0;
 
   srsran_enb_dl_t enb_dl = {};
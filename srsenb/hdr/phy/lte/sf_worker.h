@@ -40,8 +40,10 @@ public:
   ~sf_worker();
   void init(phy_common* phy);
 
-  cf_t* get_buffer_rx(uint32_t cc_idx, uint32_t antenna_idx);
-  void  set_context(const srsran::phy_common_interface::worker_context_t& w_ctx);
+  cf_t*    get_buffer_rx(uint32_t cc_idx, uint32_t antenna_idx);
+  int16_t* get_buffer_rx_sc16(uint32_t cc_idx, uint32_t antenna_idx);
+  void     set_rx_sc16_scale(uint32_t cc_idx, float scale);
+  void     set_context(const srsran::phy_common_interface::worker_context_t& w_ctx);
 
   int      add_rnti(uint16_t rnti, uint32_t cc_idx);
   void     rem_rnti(uint16_t rnti);
@@ -64,6 +64,7 @@ struct phy_args_t {
   uint32_t                pusch_max_its       = 10;
   uint32_t                nr_pusch_max_its    = 10;
   bool                    pusch_8bit_decoder  = false;
+  bool                    rx_sc16             = false;
   float                   tx_amplitude        = 1.0f;
   uint32_t                nof_phy_threads     = 1;
   std::string             equalizer_mode      = "mmse";
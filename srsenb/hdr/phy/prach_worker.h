@@ -55,6 +55,7 @@ public:
             int                       priority,
             uint32_t                  nof_workers);
   int  new_tti(uint32_t tti, cf_t* buffer);
+  int  new_tti_sc16(uint32_t tti, const int16_t* buffer, float scale);
   void set_max_prach_offset_us(float delay_us);
   void stop();
 
@@ -106,6 +107,7 @@ private:
 
   void run_thread() final;
   int  run_tti(sf_buffer* b);
+  int  new_tti_generic(uint32_t tti_rx, const cf_t* buffer_rx, const int16_t* buffer_rx_sc16, float scale);
 };
 
 class prach_worker_pool
@@ -155,6 +157,15 @@ public:
     }
     return ret;
   }
+
+  int new_tti_sc16(uint32_t cc_idx, uint32_t tti, const int16_t* buffer, float scale)
+  {
+    int ret = SRSRAN_ERROR;
+    if (cc_idx < prach_vec.size()) {
+      ret = prach_vec[cc_idx]->new_tti_sc16(tti, buffer, scale);
+    }
+    return ret;
+  }
 };
 } // namespace srsenb
 #endif // SRSENB_PRACH_WORKER_H
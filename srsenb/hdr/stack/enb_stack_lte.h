@@ -33,6 +33,7 @@
 #include "srsran/common/task_scheduler.h"
 #include "upper/gtpu.h"
 #include "upper/pdcp.h"
+#include "upper/pdcp_rlc_shards.h"
 #include "upper/rlc.h"
 
 #include "enb_stack_base.h"
@@ -186,6 +187,9 @@ private:
   srsenb::gtpu gtpu;
   srsenb::s1ap s1ap;
 
+  // PDCP/RLC of the UEs in worker threads, instead of the pdcp and rlc above, if configured
+  pdcp_rlc_shards upper_shards;
+
   // RAT-specific interfaces
   phy_interface_stack_lte* phy = nullptr;
 
@@ -27,6 +27,7 @@
 #include "sched_ue.h"
 #include "srsenb/hdr/common/common_enb.h"
 #include <atomic>
+#include <bitset>
 #include <map>
 #include <mutex>
 
@@ -76,6 +77,7 @@ public:
   int ul_bsr(uint16_t rnti, uint32_t lcg_id, uint32_t bsr) final;
   int ul_phr(uint16_t rnti, int phr, uint32_t ul_nof_prb) final;
   int ul_snr_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, float snr, uint32_t ul_ch_code) final;
+  int ul_pdu_info(uint32_t tti, uint16_t rnti, uint32_t nof_sdus) final;
 
   int dl_sched(uint32_t tti, uint32_t enb_cc_idx, dl_sched_res_t& sched_result) final;
   int ul_sched(uint32_t tti, uint32_t enb_cc_idx, ul_sched_res_t& sched_result) final;
@@ -98,6 +100,12 @@ protected:
   // Helper methods
   template <typename Func>
   int ue_db_access_locked(uint16_t rnti, Func&& f, const char* func_name = nullptr, bool log_fail = true);
+  template <typename Func>
+  int ue_db_enqueue(uint16_t rnti, const char* event_name, Func&& f);
+  template <typename Func>
+  void ue_access(sched_ue& ue, Func&& f);
+  void catch_up_ue(sched_ue& ue);
+  void add_active_ue(sched_ue& ue);
 
   // args
   rrc_interface_mac*               rrc       = nullptr;
@@ -106,13 +114,26 @@ protected:
 
   rnti_map_t<std::unique_ptr<sched_ue> > ue_db;
 
+  // UEs scheduled in each TTI. The other UEs are idle, and catch up with the TTIs they skipped when accessed
+  sched_ue_active_list   active_ues;
+  std::bitset<1U << 16U> active_rnti_mask;
+
   // independent schedulers for each carrier
   std::vector<std::unique_ptr<carrier_sched> > carrier_schedulers;
 
+  // UE updates applied at the start of the next TTI
+  class ue_event_manager;
+  std::unique_ptr<ue_event_manager> pending_events;
+
+  // workers that schedule the carriers of a TTI in parallel
+  class carrier_worker_pool;
+  std::unique_ptr<carrier_worker_pool> cc_workers;
+
   // Storage of past scheduling results
   sched_result_ringbuffer sched_results;
 
   srsran::tti_point last_tti;
+  uint64_t          tti_count = 0; ///< Non-wrapping counter of last_tti
   std::mutex        sched_mutex;
   bool              configured;
 };
@@ -36,17 +36,19 @@ class ra_sched;
 class sched::carrier_sched
 {
 public:
-  explicit carrier_sched(rrc_interface_mac*       rrc_,
-                         sched_ue_list*           ue_db_,
-                         uint32_t                 enb_cc_idx_,
-                         sched_result_ringbuffer* sched_results_);
+  explicit carrier_sched(sched_ue_list*              ue_db_,
+                         const sched_ue_active_list* active_ues_,
+                         uint32_t                    enb_cc_idx_,
+                         sched_result_ringbuffer*    sched_results_);
   ~carrier_sched();
-  void                   reset();
-  void                   carrier_cfg(const sched_cell_params_t& sched_params_);
-  void                   set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs);
-  const cc_sched_result& generate_tti_result(srsran::tti_point tti_rx);
+  void reset();
+  void carrier_cfg(const sched_cell_params_t& sched_params_);
+  void set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs);
+  //! Compute the scheduling result for a TTI. The UE subframe state and the result storage are prepared by the caller
+  const cc_sched_result& generate_tti_result(srsran::tti_point tti_rx, uint32_t paging_payload);
   int                    dl_rach_info(dl_sched_rar_info_t rar_info);
   int                    pdcch_order_info(dl_sched_po_info_t pdcch_order_info);
+  void                   rem_ue(uint16_t rnti);
 
   // getters
   const ra_sched* get_ra_sched() const { return ra_sched_ptr.get(); }
@@ -66,9 +68,9 @@ private:
   // args
   const sched_cell_params_t* cc_cfg = nullptr;
   srslog::basic_logger&      logger;
-  rrc_interface_mac*         rrc   = nullptr;
-  sched_ue_list*             ue_db = nullptr;
-  const uint32_t             enb_cc_idx;
+  sched_ue_list*              ue_db      = nullptr;
+  const sched_ue_active_list* active_ues = nullptr; ///< Only these UEs are scheduled in the TTI
+  const uint32_t              enb_cc_idx;
 
   // Subframe scheduling logic
   srsran::circular_array<sf_sched, TTIMOD_SZ> sf_scheds;
@@ -92,8 +94,8 @@ private:
 class bc_sched
 {
 public:
-  explicit bc_sched(const sched_cell_params_t& cfg_, rrc_interface_mac* rrc_);
-  void dl_sched(sf_sched* tti_sched);
+  explicit bc_sched(const sched_cell_params_t& cfg_);
+  void dl_sched(sf_sched* tti_sched, uint32_t paging_payload);
   void reset();
 
 private:
@@ -105,11 +107,10 @@ private:
 
   void update_si_windows(sf_sched* tti_sched);
   void alloc_sibs(sf_sched* tti_sched);
-  void alloc_paging(sf_sched* tti_sched);
+  void alloc_paging(sf_sched* tti_sched, uint32_t paging_payload);
 
   // args
   const sched_cell_params_t* cc_cfg = nullptr;
-  rrc_interface_mac*         rrc    = nullptr;
   srslog::basic_logger&      logger;
 
   std::array<sched_sib_t, sched_interface::MAX_SIBS> pending_sibs;
@@ -133,6 +134,17 @@ public:
   int  dl_rach_info(dl_sched_rar_info_t rar_info);
   void reset();
 
+  //! Calls f with the temporary C-RNTI of each Msg3 grant whose RAR is still pending
+  template <typename Func>
+  void for_each_pending_msg3_rnti(const Func& f) const
+  {
+    for (const pending_rar_t& rar : pending_rars) {
+      for (const dl_sched_rar_info_t& msg3_grant : rar.msg3_grant) {
+        f(msg3_grant.temp_crnti);
+      }
+    }
+  }
+
 private:
   alloc_result allocate_pending_rar(sf_sched* tti_sched, const pending_rar_t& rar, uint32_t& nof_grants_alloc);
 
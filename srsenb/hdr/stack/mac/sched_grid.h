@@ -54,6 +54,7 @@ struct sf_sched_result {
     return &enb_cc_list[enb_cc_idx];
   }
   bool is_ul_alloc(uint16_t rnti) const;
+  bool is_ul_alloc(uint16_t rnti, uint32_t enb_cc_idx) const;
   bool is_dl_alloc(uint16_t rnti) const;
 };
 
@@ -160,7 +161,7 @@ public:
     uint32_t  pid;
   };
   struct ul_alloc_t {
-    enum type_t { NEWTX, NOADAPT_RETX, ADAPT_RETX };
+    enum type_t { NEWTX, NOADAPT_RETX, ADAPT_RETX, SPS_ACTIVATION, SPS_OCCASION, SPS_RELEASE };
     bool         is_msg3 = false;
     size_t       dci_idx;
     type_t       type;
@@ -168,7 +169,11 @@ public:
     prb_interval alloc;
     int          msg3_mcs = -1;
     bool         is_retx() const { return type == NOADAPT_RETX or type == ADAPT_RETX; }
-    bool         needs_pdcch() const { return (type == NEWTX and not is_msg3) or type == ADAPT_RETX; }
+    bool         is_sps() const { return type == SPS_ACTIVATION or type == SPS_OCCASION; }
+    bool         needs_pdcch() const
+    {
+      return (type == NEWTX and not is_msg3) or type == ADAPT_RETX or type == SPS_ACTIVATION or type == SPS_RELEASE;
+    }
   };
   struct pending_msg3_t {
     uint16_t rnti  = 0;
@@ -199,9 +204,10 @@ public:
     return tti_alloc.reserve_ul_prbs(ulmask, strict);
   }
   alloc_result alloc_phich(sched_ue* user);
+  alloc_result alloc_ul_sps(sched_ue* user);
 
   // compute DCIs and generate dl_sched_result/ul_sched_result for a given TTI
-  void generate_sched_results(sched_ue_list& ue_db);
+  void generate_sched_results(sched_ue_list& ue_db, const sched_ue_active_list& active_ues);
 
   alloc_result                    alloc_dl_user(sched_ue* user, const rbgmask_t& user_mask, uint32_t pid);
   tti_point                       get_tti_tx_dl() const { return to_tx_dl(tti_rx); }
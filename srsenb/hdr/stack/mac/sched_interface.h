@@ -20,6 +20,7 @@
  */
 
 #include "common/sched_config.h"
+#include "srsenb/hdr/common/common_enb.h"
 #include "srsran/adt/bounded_vector.h"
 #include "srsran/common/common.h"
 #include "srsran/srsran.h"
@@ -39,16 +40,17 @@ public:
   const static uint32_t max_prb = 100;
   const static uint32_t max_rbg = 25;
 
-  const static int MAX_SIB_PAYLOAD_LEN = 2048;
-  const static int MAX_SIBS            = 16;
-  const static int MAX_LC              = 11;
-  const static int MAX_LC_GROUP        = 4;
-  const static int MAX_DATA_LIST       = 32;
-  const static int MAX_RAR_LIST        = 8;
-  const static int MAX_BC_LIST         = 8;
-  const static int MAX_PO_LIST         = 8;
-  const static int MAX_RLC_PDU_LIST    = 8;
-  const static int MAX_PHICH_LIST      = 8;
+  const static int MAX_SIB_PAYLOAD_LEN  = 2048;
+  const static int MAX_SIBS             = 16;
+  const static int MAX_LC               = 11;
+  const static int MAX_LC_GROUP         = 4;
+  const static int MAX_DATA_LIST        = 32;
+  const static int MAX_RAR_LIST         = 8;
+  const static int MAX_BC_LIST          = 8;
+  const static int MAX_PO_LIST          = 8;
+  const static int MAX_RLC_PDU_LIST     = 8;
+  const static int MAX_PHICH_LIST       = 8;
+  const static int MAX_SPS_RELEASE_LIST = 8;
 
   typedef struct {
     uint32_t len;
@@ -80,6 +82,8 @@ public:
     int         init_dl_cqi               = 5;
     float       max_sib_coderate          = 0.8;
     int         pdcch_cqi_offset          = 0;
+    uint32_t    max_nof_ues               = SRSENB_MAX_UES;
+    bool        parallel_carriers         = true;
   };
 
   struct cell_cfg_t {
@@ -154,6 +158,13 @@ public:
       srsran_dl_cfg_t dl_cfg               = {};
       uint32_t        aperiodic_cqi_period = 0; // if 0 is periodic CQI
     };
+    /// UL semi-persistent scheduling in the PCell. See TS 36.321, 5.10.2
+    struct ul_sps_cfg_t {
+      uint16_t sps_crnti              = SRSRAN_INVALID_RNTI;
+      uint32_t interval_ms            = 0; ///< SPS UL interval. If 0, UL SPS is not configured
+      uint32_t implicit_release_after = 2; ///< Number of empty MAC PDUs after which the UE releases the SPS grant
+      uint32_t lcg                    = 1; ///< Logical channel group whose data is scheduled semi-persistently
+    };
     /* ue capabilities, etc */
     uint32_t                            maxharq_tx       = 5;
     bool                                continuous_pusch = false;
@@ -166,7 +177,8 @@ public:
     uint32_t                            measgap_period    = 0;
     uint32_t                            measgap_offset    = 0;
     enum class ul64qam_cap { undefined, disabled, enabled };
-    ul64qam_cap support_ul64qam = ul64qam_cap::undefined;
+    ul64qam_cap  support_ul64qam = ul64qam_cap::undefined;
+    ul_sps_cfg_t ul_sps_cfg;
   };
 
   typedef struct {
@@ -203,8 +215,15 @@ public:
     uint32_t        current_tx_nb;
     uint32_t        tbs;
     srsran_dci_ul_t dci;
+    uint16_t        sps_crnti; ///< If not zero, the PUSCH and its PDCCH use the UE SPS C-RNTI instead of dci.rnti
   } ul_sched_data_t;
 
+  /// UL SPS release DCI. It carries no PUSCH
+  typedef struct {
+    srsran_dci_ul_t dci;
+    uint16_t        sps_crnti;
+  } ul_sched_sps_release_t;
+
   struct dl_sched_rar_info_t {
     uint32_t preamble_idx;
     uint32_t ta_cmd;
@@ -259,8 +278,9 @@ public:
   } ul_sched_phich_t;
 
   struct ul_sched_res_t {
-    srsran::bounded_vector<ul_sched_data_t, MAX_DATA_LIST>   pusch;
-    srsran::bounded_vector<ul_sched_phich_t, MAX_PHICH_LIST> phich;
+    srsran::bounded_vector<ul_sched_data_t, MAX_DATA_LIST>               pusch;
+    srsran::bounded_vector<ul_sched_phich_t, MAX_PHICH_LIST>             phich;
+    srsran::bounded_vector<ul_sched_sps_release_t, MAX_SPS_RELEASE_LIST> sps_release;
   };
 
   /******************* Scheduler Control ****************************/
@@ -319,6 +339,17 @@ public:
   virtual int ul_phr(uint16_t rnti, int phr, uint32_t ul_nof_prb)                                           = 0;
   virtual int ul_snr_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, float snr, uint32_t ul_ch_code) = 0;
 
+  /**
+   * Report the number of MAC SDUs of an UL MAC PDU received with correct CRC. Consecutive empty PDUs in the UL SPS
+   * occasions implicitly release the SPS grant, see TS 36.321, 5.10.2
+   *
+   * @param tti tti of the PUSCH reception
+   * @param rnti user rnti
+   * @param nof_sdus number of MAC SDUs in the PDU
+   * @return error code
+   */
+  virtual int ul_pdu_info(uint32_t tti, uint16_t rnti, uint32_t nof_sdus) = 0;
+
   /* Run Scheduler for this tti */
   virtual int dl_sched(uint32_t tti, uint32_t enb_cc_idx, dl_sched_res_t& sched_result) = 0;
   virtual int ul_sched(uint32_t tti, uint32_t enb_cc_idx, ul_sched_res_t& sched_result) = 0;
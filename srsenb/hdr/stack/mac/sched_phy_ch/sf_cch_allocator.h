@@ -29,11 +29,19 @@ namespace srsenb {
 
 class sched_ue;
 
-/// Class responsible for managing a PDCCH CCE grid, namely CCE allocs, and avoid collisions.
+/**
+ * Class responsible for managing a PDCCH CCE grid, namely CCE allocs, and avoid collisions.
+ * - A new DCI is placed in the first of its CCE positions left free by the previous allocations
+ * - On conflict, a single DCI blocking one of the new DCI positions is moved to another of its positions
+ * - Otherwise, the positions of the previous DCIs are searched depth-first, for at most max_dfs_nodes backtracking
+ *   steps per CFI, before the CFI is increased
+ */
 class sf_cch_allocator
 {
 public:
   const static uint32_t MAX_CFI = 3;
+  /// Default limit of backtracking steps of the DFS of DCI positions per CFI
+  const static uint32_t default_max_dfs_nodes = 64;
   struct tree_node {
     int8_t                pucch_n_prb = -1; ///< this PUCCH resource identifier
     uint16_t              rnti        = SRSRAN_INVALID_RNTI;
@@ -48,7 +56,11 @@ public:
 
   sf_cch_allocator() : logger(srslog::fetch_basic_logger("MAC")) {}
 
-  void init(const sched_cell_params_t& cell_params_);
+  /**
+   * Initializes the allocator for a cell
+   * @param max_dfs_nodes_ limit of backtracking steps per CFI. If 0, the DCI positions are searched exhaustively
+   */
+  void init(const sched_cell_params_t& cell_params_, uint32_t max_dfs_nodes_ = default_max_dfs_nodes);
   void new_tti(tti_point tti_rx_);
   /**
    * Allocates DCI space in PDCCH and PUCCH, avoiding in the process collisions with other users
@@ -76,17 +88,29 @@ private:
     uint32_t     aggr_idx;
     alloc_type_t alloc_type;
     sched_ue*    user;
+    /// Union of the CCEs of all the record DCI positions, for each CFI
+    std::array<pdcch_mask_t, MAX_CFI> cce_candidates;
   };
   const cce_cfi_position_table* get_cce_loc_table(alloc_type_t alloc_type, sched_ue* user, uint32_t cfix) const;
+  const cce_position_list*      get_cce_pos_list(const alloc_record& record, uint32_t cfix) const;
+  void                          set_cce_candidates(alloc_record& record) const;
 
   // PDCCH allocation algorithm
+  bool check_dci_pos(const alloc_record& record,
+                     uint32_t            ncce,
+                     const pdcch_mask_t& pdcch_mask,
+                     const prbmask_t&    pucch_mask,
+                     int8_t*             pucch_n_prb);
   bool alloc_dfs_node(const alloc_record& record, uint32_t start_child_idx);
-  bool get_next_dfs();
+  bool relocate_dci();
+  bool search_dfs();
+  void update_total_masks(uint32_t start_node_idx);
 
   // consts
   const sched_cell_params_t* cc_cfg = nullptr;
   srslog::basic_logger&      logger;
   srsran_pucch_cfg_t         pucch_cfg_common = {};
+  uint32_t                   max_dfs_nodes    = default_max_dfs_nodes;
 
   // tti vars
   tti_point                 tti_rx;
@@ -46,7 +46,9 @@ class sched_ue
 
 public:
   sched_ue(uint16_t rnti, const std::vector<sched_cell_params_t>& cell_list_params_, const ue_cfg_t& cfg);
-  void new_subframe(tti_point tti_rx, uint32_t enb_cc_idx);
+  void new_subframe(tti_point tti_rx, uint64_t tti_count_);
+  /// Checks whether the UE has no pending data, SR, HARQ or PHICH work left, so it can skip TTIs until it is accessed
+  bool is_idle() const;
 
   /*************************************************************
    *
@@ -72,6 +74,7 @@ public:
   void set_dl_sb_cqi(tti_point tti_rx, uint32_t enb_cc_idx, uint32_t sb_idx, uint32_t cqi);
   int  set_ack_info(tti_point tti_rx, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack);
   void set_ul_crc(tti_point tti_rx, uint32_t enb_cc_idx, bool crc_res);
+  void set_ul_pdu(tti_point tti_rx, uint32_t nof_sdus);
 
   /*******************************************************
    * Custom functions
@@ -103,6 +106,7 @@ public:
   uint32_t get_pending_ul_new_data(tti_point tti_tx_ul, int this_enb_cc_idx);
   uint32_t get_pending_ul_old_data();
   uint32_t get_pending_ul_old_data(uint32_t enb_cc_idx);
+  uint32_t get_pending_ul_lcg_data(uint32_t lcg) const;
   uint32_t get_expected_ul_bitrate(uint32_t enb_cc_idx, int nof_prbs = -1) const;
 
   dl_harq_proc* get_pending_dl_harq(tti_point tti_tx_dl, uint32_t enb_cc_idx);
@@ -135,7 +139,11 @@ public:
                        bool                              needs_pdcch,
                        srsran_dci_location_t             cce_range,
                        int                               explicit_mcs = -1,
-                       uci_pusch_t                       uci_type     = UCI_PUSCH_NONE);
+                       uci_pusch_t                       uci_type     = UCI_PUSCH_NONE,
+                       sps_grant_t                       sps_grant    = sps_grant_t::none);
+  void generate_sps_release(sched_interface::ul_sched_sps_release_t* data,
+                            uint32_t                                 enb_cc_idx,
+                            srsran_dci_location_t                    cce_range);
 
   srsran_dci_format_t           get_dci_format();
   const cce_cfi_position_table* get_locations(uint32_t enb_cc_idx, uint32_t current_cfi, uint32_t sf_idx) const;
@@ -218,10 +226,13 @@ private:
   bool phy_config_dedicated_enabled = false;
 
   tti_point                  current_tti;
+  uint64_t                   tti_count = 0; ///< Non-wrapping counter of current_tti
   std::vector<sched_ue_cell> cells; ///< List of eNB cells that may be configured/activated/deactivated for the UE
 };
 
 using sched_ue_list = rnti_map_t<std::unique_ptr<sched_ue> >;
+/// UEs of the sched_ue_list that are processed in the current TTI, sorted by RNTI. The remaining UEs are idle
+using sched_ue_active_list = std::vector<sched_ue*>;
 
 } // namespace srsenb
 
@@ -102,7 +102,13 @@ class ul_harq_proc : public harq_proc
 public:
   void new_tti();
 
-  void new_tx(srsran::tti_point tti, int mcs, int tbs, prb_interval alloc, uint32_t max_retx_, bool is_msg3);
+  void new_tx(srsran::tti_point tti,
+              int               mcs,
+              int               tbs,
+              prb_interval      alloc,
+              uint32_t          max_retx_,
+              bool              is_msg3,
+              bool              is_sps = false);
   void new_retx(srsran::tti_point tti_, int* mcs, int* tbs, prb_interval alloc);
   bool set_ack(uint32_t tb_idx, bool ack);
   bool retx_requires_pdcch(srsran::tti_point tti_, prb_interval alloc) const;
@@ -110,6 +116,7 @@ public:
   prb_interval get_alloc() const;
   bool         has_pending_retx() const;
   bool         is_msg3() const { return is_msg3_; }
+  bool         is_sps() const { return is_sps_; }
 
   void     reset_pending_data();
   uint32_t get_pending_data() const;
@@ -123,6 +130,7 @@ private:
   int          pending_data;
   bool         pending_phich   = false;
   bool         is_msg3_        = false;
+  bool         is_sps_         = false;
   bool         pdcch_requested = false;
 };
 
@@ -134,7 +142,7 @@ public:
   harq_entity(size_t nof_dl_harqs, size_t nof_ul_harqs);
 
   void reset();
-  void new_tti(tti_point tti_rx);
+  void new_tti(tti_point tti_rx, uint32_t nof_ttis = 1);
 
   size_t                           nof_dl_harqs() const { return dl_harqs.size(); }
   size_t                           nof_ul_harqs() const { return ul_harqs.size(); }
@@ -172,6 +180,9 @@ public:
    */
   int set_ul_crc(srsran::tti_point tti_tx_ul, uint32_t tb_idx, bool ack_);
 
+  //! Checks whether all HARQs are empty and have no pending PHICH
+  bool is_empty() const;
+
   //! Resets pending harq ACKs and cleans UL Harqs with maxretx == 0
   void finish_tti(srsran::tti_point tti_rx);
 
@@ -37,7 +37,7 @@ class lch_ue_manager : private base_ue_buffer_manager<false>
 public:
   explicit lch_ue_manager(uint16_t rnti) : base_ue_buffer_manager(rnti, srslog::fetch_basic_logger("MAC")) {}
   void set_cfg(const sched_interface::ue_cfg_t& cfg_);
-  void new_tti();
+  void new_tti(uint32_t nof_ttis = 1);
 
   // Inherited methods from ue_buffer_manager base class
   using base_type::config_lcid;
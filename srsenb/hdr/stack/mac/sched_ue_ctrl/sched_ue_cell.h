@@ -25,6 +25,7 @@
 #include "../sched_lte_common.h"
 #include "sched_dl_cqi.h"
 #include "sched_harq.h"
+#include "sched_ul_sps.h"
 #include "srsenb/hdr/stack/mac/sched_phy_ch/sched_dci.h"
 #include "tpc.h"
 
@@ -38,9 +39,11 @@ struct sched_ue_cell {
 
   sched_ue_cell(uint16_t rnti_, const sched_cell_params_t& cell_cfg_, tti_point current_tti);
   void set_ue_cfg(const sched_interface::ue_cfg_t& ue_cfg_);
-  void new_tti(tti_point tti_rx);
+  void new_tti(tti_point tti_rx, uint32_t nof_ttis = 1);
   void clear_feedback();
   void finish_tti(tti_point tti_rx);
+  /// Checks whether the cell has no HARQ, PHICH, SPS or (de)activation work left, so its TTIs can be skipped
+  bool is_idle() const;
 
   int set_dl_wb_cqi(tti_point tti_rx, uint32_t dl_cqi_);
   int set_dl_sb_cqi(tti_point tti_rx, uint32_t sb_idx, uint32_t dl_cqi_);
@@ -79,6 +82,9 @@ struct sched_ue_cell {
   /// Cell Transmit Power Control state machine
   tpc tpc_fsm;
 
+  /// UL semi-persistent scheduling state. Only configured in the PCell
+  sched_ul_sps ul_sps;
+
   /// UCI Feedback
   const sched_dl_cqi& dl_cqi() const { return dl_cqi_ctxt; }
   uint32_t            dl_ri = 0;
@@ -0,0 +1,97 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_SCHED_UL_SPS_H
+#define SRSRAN_SCHED_UL_SPS_H
+
+#include "srsenb/hdr/stack/mac/sched_interface.h"
+#include "srsenb/hdr/stack/mac/sched_phy_ch/sched_phy_resource.h"
+#include "srsran/common/tti_point.h"
+#include "srsran/srslog/srslog.h"
+
+namespace srsenb {
+
+/// Role of an UL grant in the semi-persistent scheduling of the UE
+enum class sps_grant_t { none, activation, occasion };
+
+/**
+ * Class that handles the UL semi-persistent scheduling (SPS) state of a UE in its PCell. See TS 36.321, 5.10.2
+ * - The SPS grant is activated with a DCI format 0 scrambled with the SPS C-RNTI. The PUSCH of the activation is the
+ *   first SPS occasion, and the same PRBs and MCS are reused every SPS interval without PDCCH
+ * - The UE releases the grant implicitly after "implicitReleaseAfter" consecutive MAC PDUs without MAC SDUs in the
+ *   SPS occasions
+ * - The eNB releases the grant with a release DCI when the SPS occasions fail the CRC repeatedly, as the eNB may have
+ *   missed the empty MAC PDUs of an implicit release. The SPS occasions are kept until the release DCI is sent
+ */
+class sched_ul_sps
+{
+public:
+  using sps_cfg_t = sched_interface::ue_cfg_t::ul_sps_cfg_t;
+
+  /// Largest MCS of an SPS activation, whose MCS MSB is zero. See TS 36.213, Table 9.2-1
+  static const uint32_t max_mcs = 15;
+  /// Consecutive CRC failures in the SPS occasions after which the grant is released with a release DCI
+  static const uint32_t max_crc_failures = 4;
+
+  explicit sched_ul_sps(uint16_t rnti_);
+
+  /// The UE clears its SPS grant when SPS is reconfigured by RRC, so any change of configuration deactivates it
+  void set_cfg(const sps_cfg_t& cfg_);
+  void reset();
+
+  bool         is_configured() const { return cfg.interval_ms > 0 and cfg.sps_crnti != SRSRAN_INVALID_RNTI; }
+  bool         is_active() const { return active; }
+  bool         is_release_pending() const { return release_crnti != SRSRAN_INVALID_RNTI; }
+  uint16_t     get_sps_crnti() const { return is_release_pending() ? release_crnti : cfg.sps_crnti; }
+  uint32_t     get_lcg() const { return cfg.lcg; }
+  prb_interval get_alloc() const { return alloc; }
+  int          get_mcs() const { return mcs; }
+
+  /// Checks whether tti_tx_ul is one of the UE SPS occasions
+  bool is_occasion(tti_point tti_tx_ul) const;
+
+  void activate(tti_point tti_tx_ul, prb_interval alloc_, int mcs_);
+  void release_sent();
+
+  void set_ul_crc(tti_point tti_rx, bool crc_res);
+  void set_ul_pdu(tti_point tti_rx, uint32_t nof_sdus);
+
+private:
+  void deactivate(const char* cause);
+
+  // args
+  uint16_t              rnti;
+  srslog::basic_logger& logger;
+  sps_cfg_t             cfg;
+
+  // state
+  bool         active = false;
+  tti_point    start_tti;
+  prb_interval alloc;
+  int          mcs              = 0;
+  uint32_t     nof_empty_pdus   = 0;
+  uint32_t     nof_crc_failures = 0;
+  uint16_t     release_crnti    = SRSRAN_INVALID_RNTI;
+};
+
+} // namespace srsenb
+
+#endif // SRSRAN_SCHED_UL_SPS_H
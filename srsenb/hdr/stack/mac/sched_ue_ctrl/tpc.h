@@ -107,7 +107,45 @@ public:
     }
   }
 
-  void new_tti()
+  /// Advances nof_ttis TTIs. An idle UE skips TTIs, so it catches up with all of them when it is next scheduled
+  void new_tti(uint32_t nof_ttis = 1)
+  {
+    // Once the TPC window has been flushed, the remaining TTIs only add to the counters
+    uint32_t nof_flush_ttis = std::min(nof_ttis, (uint32_t)snr_estim_list[0].win_tpc_values.size() + 1);
+    for (uint32_t i = 0; i < nof_flush_ttis; ++i) {
+      new_single_tti();
+    }
+    uint32_t nof_rem_ttis = nof_ttis - nof_flush_ttis;
+    if (nof_rem_ttis > 0) {
+      tti_count += nof_rem_ttis;
+      for (auto& ch_snr : snr_estim_list) {
+        ch_snr.last_snr_sample_count += nof_rem_ttis;
+        ch_snr.acc_tpc_values += ch_snr.win_tpc_values.oldest() * (int)nof_rem_ttis;
+        ch_snr.acc_tpc_phr_values += ch_snr.win_tpc_values.oldest() * (int)nof_rem_ttis;
+      }
+    }
+  }
+
+  /**
+   * Called during DCI format0 encoding to set PUSCH TPC command
+   * @remark See TS 36.213 Section 5.1.1
+   * @return accumulated TPC value {-1, 0, 1, 3}
+   */
+  uint8_t encode_pusch_tpc() { return encode_tpc(PUSCH_CODE); }
+
+  /**
+   * Called during DCI format1/2A/A encoding to set PUCCH TPC command
+   * @remark See TS 36.213 Section 5.1.2
+   * @return accumulated TPC value {-1, 0, 1, 3}
+   */
+  uint8_t encode_pucch_tpc() { return encode_tpc(PUCCH_CODE); }
+
+  uint32_t max_ul_prbs() const { return max_prbs_cached; }
+
+  float get_ul_snr_estim(uint32_t ul_ch_code = PUSCH_CODE) const { return snr_estim_list[ul_ch_code].snr_avg.value(); }
+
+private:
+  void new_single_tti()
   {
     tti_count++;
     for (size_t chidx = 0; chidx < nof_ul_ch_code; ++chidx) {
@@ -135,25 +173,6 @@ public:
     }
   }
 
-  /**
-   * Called during DCI format0 encoding to set PUSCH TPC command
-   * @remark See TS 36.213 Section 5.1.1
-   * @return accumulated TPC value {-1, 0, 1, 3}
-   */
-  uint8_t encode_pusch_tpc() { return encode_tpc(PUSCH_CODE); }
-
-  /**
-   * Called during DCI format1/2A/A encoding to set PUCCH TPC command
-   * @remark See TS 36.213 Section 5.1.2
-   * @return accumulated TPC value {-1, 0, 1, 3}
-   */
-  uint8_t encode_pucch_tpc() { return encode_tpc(PUCCH_CODE); }
-
-  uint32_t max_ul_prbs() const { return max_prbs_cached; }
-
-  float get_ul_snr_estim(uint32_t ul_ch_code = PUSCH_CODE) const { return snr_estim_list[ul_ch_code].snr_avg.value(); }
-
-private:
   uint8_t encode_tpc_delta(int8_t delta)
   {
     switch (delta) {
@@ -35,8 +35,10 @@ class sched_base
 public:
   virtual ~sched_base() = default;
 
-  virtual void sched_dl_users(sched_ue_list& ue_db, sf_sched* tti_sched) = 0;
-  virtual void sched_ul_users(sched_ue_list& ue_db, sf_sched* tti_sched) = 0;
+  virtual void sched_dl_users(const sched_ue_active_list& ue_list, sf_sched* tti_sched) = 0;
+  virtual void sched_ul_users(const sched_ue_active_list& ue_list, sf_sched* tti_sched) = 0;
+  /// Called when a UE is removed, so that any UE history kept by the algorithm can be released
+  virtual void rem_ue(uint16_t rnti) {}
 
 protected:
   srslog::basic_logger& logger = srslog::fetch_basic_logger("MAC");
@@ -35,16 +35,18 @@ class sched_time_pf final : public sched_base
 
 public:
   sched_time_pf(const sched_cell_params_t& cell_params_, const sched_interface::sched_args_t& sched_args);
-  void sched_dl_users(sched_ue_list& ue_db, sf_sched* tti_sched) override;
-  void sched_ul_users(sched_ue_list& ue_db, sf_sched* tti_sched) override;
+  void sched_dl_users(const sched_ue_active_list& ue_list, sf_sched* tti_sched) override;
+  void sched_ul_users(const sched_ue_active_list& ue_list, sf_sched* tti_sched) override;
+  void rem_ue(uint16_t rnti) override;
 
 private:
-  void new_tti(sched_ue_list& ue_db, sf_sched* tti_sched);
+  void new_tti(const sched_ue_active_list& ue_list, sf_sched* tti_sched);
 
   const sched_cell_params_t* cc_cfg         = nullptr;
   float                      fairness_coeff = 1;
 
   srsran::tti_point current_tti_rx;
+  uint64_t          tti_count = 0; ///< Number of TTIs scheduled, used to age the history of idle UEs
 
   struct ue_ctxt {
     ue_ctxt(uint16_t rnti_, float fairness_coeff_) : rnti(rnti_), fairness_coeff(fairness_coeff_) {}
@@ -55,18 +57,25 @@ private:
     void     new_tti(const sched_cell_params_t& cell, sched_ue& ue, sf_sched* tti_sched);
     void     save_dl_alloc(uint32_t alloc_bytes, float alpha);
     void     save_ul_alloc(uint32_t alloc_bytes, float alpha);
+    void     skip_ttis(const sched_cell_params_t& cell, const sched_ue& ue, uint32_t nof_ttis, float alpha);
 
     const uint16_t rnti;
     const float    fairness_coeff;
 
-    int                 ue_cc_idx  = 0;
-    float               dl_prio    = 0;
-    float               ul_prio    = 0;
-    const dl_harq_proc* dl_retx_h  = nullptr;
-    const dl_harq_proc* dl_newtx_h = nullptr;
-    const ul_harq_proc* ul_h       = nullptr;
+    sched_ue*           user           = nullptr;
+    uint64_t            last_tti_count = 0; ///< Last TTI in which the UE was active
+    int                 ue_cc_idx      = 0;
+    float               dl_prio        = 0;
+    float               ul_prio        = 0;
+    const dl_harq_proc* dl_retx_h      = nullptr;
+    const dl_harq_proc* dl_newtx_h     = nullptr;
+    const ul_harq_proc* ul_h           = nullptr;
+    bool                dl_idle        = false; ///< HARQ available for a newtx, but no DL data to transmit
+    bool                ul_idle        = false; ///< HARQ available for a newtx, but no UL data to receive
 
   private:
+    static void skip_allocs(float& avg_rate, uint32_t& nof_samples, uint32_t nof_allocs, float alpha);
+
     float    dl_avg_rate_   = 0;
     float    ul_avg_rate_   = 0;
     uint32_t dl_nof_samples = 0;
@@ -85,8 +94,9 @@ private:
   using ue_dl_queue_t = std::priority_queue<ue_ctxt*, std::vector<ue_ctxt*>, ue_dl_prio_compare>;
   using ue_ul_queue_t = std::priority_queue<ue_ctxt*, std::vector<ue_ctxt*>, ue_ul_prio_compare>;
 
-  ue_dl_queue_t dl_queue;
-  ue_ul_queue_t ul_queue;
+  ue_dl_queue_t         dl_queue;
+  ue_ul_queue_t         ul_queue;
+  std::vector<ue_ctxt*> ul_idle_list; ///< UEs left out of the UL queue, as their allocation would fail
 
   uint32_t try_dl_alloc(ue_ctxt& ue_ctxt, sched_ue& ue, sf_sched* tti_sched);
   uint32_t try_ul_alloc(ue_ctxt& ue_ctxt, sched_ue& ue, sf_sched* tti_sched);
@@ -32,14 +32,14 @@ class sched_time_rr final : public sched_base
 
 public:
   sched_time_rr(const sched_cell_params_t& cell_params_, const sched_interface::sched_args_t& sched_args);
-  void sched_dl_users(sched_ue_list& ue_db, sf_sched* tti_sched) override;
-  void sched_ul_users(sched_ue_list& ue_db, sf_sched* tti_sched) override;
+  void sched_dl_users(const sched_ue_active_list& ue_list, sf_sched* tti_sched) override;
+  void sched_ul_users(const sched_ue_active_list& ue_list, sf_sched* tti_sched) override;
 
 private:
-  void sched_dl_retxs(sched_ue_list& ue_db, sf_sched* tti_sched, size_t prio_idx);
-  void sched_dl_newtxs(sched_ue_list& ue_db, sf_sched* tti_sched, size_t prio_idx);
-  void sched_ul_retxs(sched_ue_list& ue_db, sf_sched* tti_sched, size_t prio_idx);
-  void sched_ul_newtxs(sched_ue_list& ue_db, sf_sched* tti_sched, size_t prio_idx);
+  void sched_dl_retxs(const sched_ue_active_list& ue_list, sf_sched* tti_sched, size_t prio_idx);
+  void sched_dl_newtxs(const sched_ue_active_list& ue_list, sf_sched* tti_sched, size_t prio_idx);
+  void sched_ul_retxs(const sched_ue_active_list& ue_list, sf_sched* tti_sched, size_t prio_idx);
+  void sched_ul_newtxs(const sched_ue_active_list& ue_list, sf_sched* tti_sched, size_t prio_idx);
 
   const sched_cell_params_t* cc_cfg = nullptr;
 };
@@ -192,6 +192,7 @@ private:
 
   void     process_release_complete(uint16_t rnti);
   void     rem_user(uint16_t rnti);
+  uint16_t allocate_sps_crnti(uint16_t rnti);
   uint32_t generate_sibs();
   void     configure_mbsfn_sibs();
   int      pack_mcch();
@@ -47,6 +47,16 @@ struct rrc_cfg_qci_t {
   asn1::rrc::rlc_cfg_c                          rlc_cfg;
 };
 
+/// UL semi-persistent scheduling of the UEs with an established DRB of the configured QCI
+struct rrc_cfg_sps_t {
+  using sps_ul_setup_t = asn1::rrc::sps_cfg_ul_c::setup_s_;
+
+  bool                                            enabled = false;
+  uint32_t                                        qci     = 1;
+  sps_ul_setup_t::semi_persist_sched_interv_ul_e_ ul_interval;
+  sps_ul_setup_t::implicit_release_after_e_       implicit_release_after;
+};
+
 struct srb_cfg_t {
   int                                     enb_dl_max_retx_thres = -1;
   asn1::rrc::srb_to_add_mod_s::rlc_cfg_c_ rlc_cfg;
@@ -76,6 +86,7 @@ struct rrc_cfg_t {
   asn1::rrc::pdsch_cfg_ded_s::p_a_e_                                                      pdsch_cfg;
   rrc_cfg_sr_t                                                                            sr_cfg;
   rrc_cfg_cqi_t                                                                           cqi_cfg;
+  rrc_cfg_sps_t                                                                           sps_cfg;
   std::map<uint32_t, rrc_cfg_qci_t>                                                       qci_cfg;
   bool                                                                                    enable_mbsfn;
   uint16_t                                                                                mbms_mcs;
@@ -100,6 +111,7 @@ struct ue_var_cfg_t {
   asn1::rrc::rr_cfg_ded_s                rr_cfg;
   asn1::rrc::meas_cfg_s                  meas_cfg;
   asn1::rrc::scell_to_add_mod_list_r10_l scells;
+  uint16_t                               sps_crnti = SRSRAN_INVALID_RNTI;
 };
 
 } // namespace srsenb
@@ -126,7 +126,7 @@ public:
   bool remove_rnti(uint16_t rnti);
 
 private:
-  using tunnel_list_t  = srsran::static_id_obj_pool<uint32_t, tunnel, SRSENB_MAX_UES * MAX_TUNNELS_PER_UE>;
+  using tunnel_list_t  = srsran::id_obj_pool<uint32_t, tunnel>;
   using tunnel_ctxt_it = typename tunnel_list_t::iterator;
 
   // Used to differentiate whether GTPU is used in NR or LTE context.
@@ -0,0 +1,228 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSENB_PDCP_RLC_SHARDS_H
+#define SRSENB_PDCP_RLC_SHARDS_H
+
+#include "srsenb/hdr/stack/upper/pdcp.h"
+#include "srsenb/hdr/stack/upper/rlc.h"
+#include "srsran/common/task_scheduler.h"
+#include "srsran/common/threads.h"
+#include "srsran/interfaces/enb_gtpu_interfaces.h"
+#include "srsran/interfaces/enb_rrc_interface_pdcp.h"
+#include "srsran/interfaces/enb_rrc_interface_rlc.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <set>
+
+namespace srsenb {
+
+/**
+ * Shards the PDCP and RLC entities of the UEs across worker threads by RNTI, so that the user-plane processing of
+ * PDCP (ciphering) and RLC (segmentation and reassembly) does not run in the stack thread, where RRC and S1AP stay
+ * - Each shard owns a PDCP and an RLC instance, and a task scheduler whose timers run the PDCP/RLC timers of its UEs
+ * - The calls of RRC, GTPU and MAC to the PDCP/RLC of a UE are queued to its shard in the order they are made, which
+ *   keeps the order of the SDUs, PDUs and reconfigurations of every bearer. The calls that return a result wait for
+ *   the shard to process them
+ * - The calls of PDCP/RLC to RRC and GTPU are queued back to the stack thread in an unbounded queue, which the stack
+ *   thread runs when woken up and every TTI, so they are never lost. The shards never wait for the stack thread, so
+ *   the stack thread can safely wait for them
+ * - The MAC reads the RLC PDUs directly from the PHY workers, as the RLC of every shard is thread-safe
+ */
+class pdcp_rlc_shards
+{
+public:
+  pdcp_rlc_shards(srsran::task_sched_handle stack_task_sched_,
+                  srslog::basic_logger&     logger_,
+                  srslog::basic_logger&     pdcp_logger_,
+                  srslog::basic_logger&     rlc_logger_);
+  ~pdcp_rlc_shards();
+
+  void init(uint32_t             nof_shards,
+            rrc_interface_pdcp*  rrc_pdcp_,
+            rrc_interface_rlc*   rrc_rlc_,
+            gtpu_interface_pdcp* gtpu_,
+            mac_interface_rlc*   mac_);
+  void start(int prio);
+  /// Joins the shard threads and runs their pending calls to RRC and GTPU. Called from the stack thread
+  void stop();
+
+  /// Steps the PDCP/RLC timers of all shards. Called from the stack thread every TTI
+  void tti_clock();
+  void get_metrics(rlc_metrics_t& rlc_metrics, pdcp_metrics_t& pdcp_metrics, uint32_t nof_tti);
+
+  uint32_t nof_shards() const { return shards.size(); }
+
+  // Interfaces to the sharded PDCP and RLC, to be used from the stack thread, except for rlc_interface_mac::read_pdu
+  pdcp_interface_rrc*  pdcp_rrc() { return &pdcp_itf; }
+  pdcp_interface_gtpu* pdcp_gtpu() { return &pdcp_itf; }
+  rlc_interface_rrc*   rlc_rrc() { return &rlc_itf; }
+  rlc_interface_mac*   rlc_mac() { return &rlc_itf; }
+
+private:
+  class shard final : public srsran::thread
+  {
+  public:
+    shard(uint32_t idx, srslog::basic_logger& pdcp_logger, srslog::basic_logger& rlc_logger);
+    void start_shard(int prio);
+    void stop();
+    bool is_running() const { return running.load(std::memory_order_relaxed); }
+
+    srsran::task_scheduler    task_sched;
+    srsran::task_queue_handle queue;
+    srsenb::pdcp              pdcp;
+    srsenb::rlc               rlc;
+
+    // UEs with a PDCP/RLC user in the shard, as requested by the stack thread
+    std::set<uint16_t> pdcp_rntis, rlc_rntis;
+
+  private:
+    void run_thread() override;
+
+    std::atomic<bool> running{false};
+  };
+
+  // PDCP/RLC interfaces given to the stack layers. Each call is queued to the shard of the UE
+  class pdcp_adapter final : public pdcp_interface_rrc, public pdcp_interface_gtpu
+  {
+  public:
+    explicit pdcp_adapter(pdcp_rlc_shards* parent_) : parent(parent_) {}
+
+    // pdcp_interface_rrc
+    void set_enabled(uint16_t rnti, uint32_t lcid, bool enabled) override;
+    void reset(uint16_t rnti) override;
+    void add_user(uint16_t rnti) override;
+    void rem_user(uint16_t rnti) override;
+    void write_sdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu, int pdcp_sn = -1) override;
+    void add_bearer(uint16_t rnti, uint32_t lcid, const srsran::pdcp_config_t& cnfg) override;
+    void del_bearer(uint16_t rnti, uint32_t lcid) override;
+    void config_security(uint16_t rnti, uint32_t lcid, const srsran::as_security_config_t& sec_cfg) override;
+    void enable_integrity(uint16_t rnti, uint32_t lcid) override;
+    void enable_encryption(uint16_t rnti, uint32_t lcid) override;
+    void send_status_report(uint16_t rnti) override;
+    void send_status_report(uint16_t rnti, uint32_t lcid) override;
+    bool get_bearer_state(uint16_t rnti, uint32_t lcid, srsran::pdcp_lte_state_t* state) override;
+    bool set_bearer_state(uint16_t rnti, uint32_t lcid, const srsran::pdcp_lte_state_t& state) override;
+    void reestablish(uint16_t rnti) override;
+
+    // pdcp_interface_gtpu
+    std::map<uint32_t, srsran::unique_byte_buffer_t> get_buffered_pdus(uint16_t rnti, uint32_t lcid) override;
+
+  private:
+    pdcp_rlc_shards* parent;
+  };
+
+  class rlc_adapter final : public rlc_interface_rrc, public rlc_interface_mac
+  {
+  public:
+    explicit rlc_adapter(pdcp_rlc_shards* parent_) : parent(parent_) {}
+
+    // rlc_interface_rrc
+    void clear_buffer(uint16_t rnti) override;
+    void add_user(uint16_t rnti) override;
+    void rem_user(uint16_t rnti) override;
+    void add_bearer(uint16_t rnti, uint32_t lcid, const srsran::rlc_config_t& cnfg) override;
+    void add_bearer_mrb(uint16_t rnti, uint32_t lcid) override;
+    void del_bearer(uint16_t rnti, uint32_t lcid) override;
+    void write_sdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu) override;
+    bool has_bearer(uint16_t rnti, uint32_t lcid) override;
+    bool suspend_bearer(uint16_t rnti, uint32_t lcid) override;
+    bool is_suspended(uint16_t rnti, uint32_t lcid) override;
+    bool resume_bearer(uint16_t rnti, uint32_t lcid) override;
+    void reestablish(uint16_t rnti) override;
+
+    // rlc_interface_mac
+    int  read_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) override;
+    void write_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes) override;
+
+  private:
+    pdcp_rlc_shards* parent;
+  };
+
+  // RRC and GTPU interfaces given to the PDCP/RLC of the shards. Each call is queued to the stack thread
+  class rrc_pdcp_adapter final : public rrc_interface_pdcp
+  {
+  public:
+    explicit rrc_pdcp_adapter(pdcp_rlc_shards* parent_) : parent(parent_) {}
+    void write_pdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t pdu) override;
+    void notify_pdcp_integrity_error(uint16_t rnti, uint32_t lcid) override;
+
+  private:
+    pdcp_rlc_shards* parent;
+  };
+
+  class rrc_rlc_adapter final : public rrc_interface_rlc
+  {
+  public:
+    explicit rrc_rlc_adapter(pdcp_rlc_shards* parent_) : parent(parent_) {}
+    void max_retx_attempted(uint16_t rnti) override;
+    void protocol_failure(uint16_t rnti) override;
+    void write_pdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu) override;
+
+  private:
+    pdcp_rlc_shards* parent;
+  };
+
+  class gtpu_adapter final : public gtpu_interface_pdcp
+  {
+  public:
+    explicit gtpu_adapter(pdcp_rlc_shards* parent_) : parent(parent_) {}
+    void write_pdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t pdu) override;
+
+  private:
+    pdcp_rlc_shards* parent;
+  };
+
+  shard* get_shard(uint16_t rnti) { return shards[rnti % shards.size()].get(); }
+  /// Runs the task in the shard and waits for its completion
+  void run_sync(shard* s, srsran::move_task_t task);
+  /// Queues a task to the stack thread, without waiting for it
+  void push_stack_task(srsran::move_task_t task);
+  /// Runs the tasks queued to the stack thread. Called from the stack thread
+  void run_stack_tasks();
+
+  srsran::task_sched_handle stack_task_sched;
+  srslog::basic_logger&     logger;
+  srslog::basic_logger&     pdcp_logger;
+  srslog::basic_logger&     rlc_logger;
+
+  rrc_interface_pdcp*  rrc_pdcp = nullptr;
+  rrc_interface_rlc*   rrc_rlc  = nullptr;
+  gtpu_interface_pdcp* gtpu     = nullptr;
+
+  pdcp_adapter     pdcp_itf;
+  rlc_adapter      rlc_itf;
+  rrc_pdcp_adapter rrc_pdcp_itf;
+  rrc_rlc_adapter  rrc_rlc_itf;
+  gtpu_adapter     gtpu_itf;
+
+  srsran::task_queue_handle            stack_queue;
+  std::vector<std::unique_ptr<shard> > shards;
+
+  std::mutex                      stack_tasks_mutex;
+  std::deque<srsran::move_task_t> stack_tasks;
+  std::atomic<bool>               stack_wakeup_pending{false};
+};
+
+} // namespace srsenb
+
+#endif // SRSENB_PDCP_RLC_SHARDS_H
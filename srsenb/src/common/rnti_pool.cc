@@ -34,10 +34,10 @@ namespace srsenb {
 const static size_t UE_MEM_BLOCK_SIZE = 1024 + sizeof(ue) + sizeof(rrc::ue) + sizeof(rrc::ue::rrc_mobility) +
                                         sizeof(rrc::ue::rrc_endc) + sizeof(srsran::rlc) + sizeof(srsran::pdcp);
 
-srsran::circular_stack_pool<SRSENB_MAX_UES>* get_rnti_pool()
+srsran::circular_stack_pool<SRSENB_MAX_UES_LIMIT>* get_rnti_pool()
 {
-  static std::unique_ptr<srsran::circular_stack_pool<SRSENB_MAX_UES> > pool(
-      new srsran::circular_stack_pool<SRSENB_MAX_UES>(8, UE_MEM_BLOCK_SIZE, 4));
+  static std::unique_ptr<srsran::circular_stack_pool<SRSENB_MAX_UES_LIMIT> > pool(
+      new srsran::circular_stack_pool<SRSENB_MAX_UES_LIMIT>(8, UE_MEM_BLOCK_SIZE, 4));
   return pool.get();
 }
 
@@ -1266,6 +1266,13 @@ int parse_rr(all_args_t* args_, rrc_cfg_t* rrc_cfg_, rrc_nr_cfg_t* rrc_nr_cfg_)
 
   mac_cnfg.add_field(make_asn1_enum_number_parser("time_alignment_timer", &rrc_cfg_->mac_cnfg.time_align_timer_ded));
 
+  parser::section sps_cnfg("sps_cnfg");
+  mac_cnfg.add_subsection(&sps_cnfg);
+  sps_cnfg.set_optional(&rrc_cfg_->sps_cfg.enabled);
+  sps_cnfg.add_field(new parser::field<uint32>("qci", &rrc_cfg_->sps_cfg.qci));
+  sps_cnfg.add_field(make_asn1_enum_number_parser("ul_interval", &rrc_cfg_->sps_cfg.ul_interval));
+  sps_cnfg.add_field(make_asn1_enum_number_parser("implicit_release_after", &rrc_cfg_->sps_cfg.implicit_release_after));
+
   /* PHY config section */
   parser::section phy_cfg_("phy_cnfg");
 
@@ -1314,7 +1321,17 @@ int parse_rr(all_args_t* args_, rrc_cfg_t* rrc_cfg_, rrc_nr_cfg_t* rrc_nr_cfg_)
   p.add_section(&cell_cnfg);
   p.add_section(&nr_cell_cnfg);
 
-  return p.parse();
+  if (p.parse() != SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  // The scheduler supports the UL SPS intervals that divide the SFN wrap-around
+  if (rrc_cfg_->sps_cfg.enabled and rrc_cfg_->sps_cfg.ul_interval.to_number() < 10) {
+    ERROR("Invalid SPS UL interval (%d). Only 10, 20, 32, 40, 64, 80, 128, 160, 320 or 640 are allowed.",
+          rrc_cfg_->sps_cfg.ul_interval.to_number());
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
 }
 
 static int parse_meas_cell_list(rrc_meas_cfg_t* meas_cfg, Setting& root)
@@ -1867,10 +1884,19 @@ int parse_cfg_files(all_args_t* args_, rrc_cfg_t* rrc_cfg_, rrc_nr_cfg_t* rrc_nr
 int set_derived_args(all_args_t* args_, rrc_cfg_t* rrc_cfg_, phy_cfg_t* phy_cfg_, const srsran_cell_t& cell_cfg_)
 {
   // Sanity checks
-  ASSERT_VALID_CFG(args_->stack.mac.nof_prealloc_ues <= SRSENB_MAX_UES,
+  ASSERT_VALID_CFG(args_->stack.mac.sched.max_nof_ues > 0 and
+                       args_->stack.mac.sched.max_nof_ues <= SRSENB_MAX_UES_LIMIT,
+                   "expert.max_nof_ues=%d must be within [1, %d]",
+                   args_->stack.mac.sched.max_nof_ues,
+                   SRSENB_MAX_UES_LIMIT);
+  ASSERT_VALID_CFG(args_->stack.mac.nof_prealloc_ues <= args_->stack.mac.sched.max_nof_ues,
                    "mac.nof_prealloc_ues=%d must be within [0, %d]",
                    args_->stack.mac.nof_prealloc_ues,
-                   SRSENB_MAX_UES);
+                   args_->stack.mac.sched.max_nof_ues);
+  ASSERT_VALID_CFG(args_->stack.nof_upper_workers <= SRSENB_MAX_UPPER_WORKERS,
+                   "expert.nof_upper_workers=%d must be within [0, %d]",
+                   args_->stack.nof_upper_workers,
+                   SRSENB_MAX_UPPER_WORKERS);
 
   // Check for a forced  DL EARFCN or frequency (only valid for a single cell config
   if (rrc_cfg_->cell_list.size() > 0) {
@@ -71,6 +71,9 @@ cc_worker::~cc_worker()
     if (signal_buffer_rx[p]) {
       free(signal_buffer_rx[p]);
     }
+    if (signal_buffer_rx_sc16[p]) {
+      free(signal_buffer_rx_sc16[p]);
+    }
     if (signal_buffer_tx[p]) {
       free(signal_buffer_tx[p]);
     }
@@ -103,6 +106,15 @@ void cc_worker::init(phy_common* phy_, uint32_t cc_idx_)
       return;
     }
     srsran_vec_cf_zero(signal_buffer_rx[p], 2 * sf_len);
+    if (phy->params.rx_sc16) {
+      // Interleaved IQ components, the OFDM demodulator falls back to converting into signal_buffer_rx
+      signal_buffer_rx_sc16[p] = srsran_vec_i16_malloc(2 * 2 * sf_len);
+      if (!signal_buffer_rx_sc16[p]) {
+        ERROR("Error allocating memory");
+        return;
+      }
+      srsran_vec_i16_zero(signal_buffer_rx_sc16[p], 2 * 2 * sf_len);
+    }
     signal_buffer_tx[p] = srsran_vec_cf_malloc(2 * sf_len);
     if (!signal_buffer_tx[p]) {
       ERROR("Error allocating memory");
@@ -126,6 +138,7 @@ void cc_worker::init(phy_common* phy_, uint32_t cc_idx_)
     ERROR("Error initiating ENB UL");
     return;
   }
+  enb_ul.rx_sc16 = phy->params.rx_sc16;
 
   if (srsran_enb_ul_set_cell(&enb_ul, cell, &phy->dmrs_pusch_cfg, nullptr)) {
     ERROR("Error initiating ENB UL");
@@ -174,6 +187,16 @@ cf_t* cc_worker::get_buffer_rx(uint32_t antenna_idx)
   return signal_buffer_rx[antenna_idx];
 }
 
+int16_t* cc_worker::get_buffer_rx_sc16(uint32_t antenna_idx)
+{
+  return signal_buffer_rx_sc16[antenna_idx];
+}
+
+void cc_worker::set_rx_sc16_scale(float scale)
+{
+  rx_sc16_scale = scale;
+}
+
 cf_t* cc_worker::get_buffer_tx(uint32_t antenna_idx)
 {
   return signal_buffer_tx[antenna_idx];
@@ -219,7 +242,11 @@ void cc_worker::work_ul(const srsran_ul_sf_cfg_t& ul_sf_cfg, stack_interface_phy
   logger.set_context(ul_sf.tti);
 
   // Process UL signal
-  srsran_enb_ul_fft(&enb_ul);
+  if (rx_sc16_scale > 0.0f and signal_buffer_rx_sc16[0] != nullptr) {
+    srsran_enb_ul_fft_sc16(&enb_ul, signal_buffer_rx_sc16[0], rx_sc16_scale);
+  } else {
+    srsran_enb_ul_fft(&enb_ul);
+  }
 
   // Decode pending UL grants for the tti they were scheduled
   decode_pusch(ul_grants.pusch, ul_grants.nof_grants);
@@ -306,6 +333,11 @@ bool cc_worker::decode_pusch_rnti(stack_interface_phy_lte::ul_sched_grant_t& ul_
     return false;
   }
 
+  // The PUSCH of the SPS grants is scrambled with the SPS C-RNTI, see TS 36.211, 5.3.1
+  if (ul_grant.sps_crnti != SRSRAN_INVALID_RNTI) {
+    ul_cfg.pusch.rnti = ul_grant.sps_crnti;
+  }
+
   // Fill UCI configuration
   bool uci_required =
       phy->ue_db.fill_uci_cfg(tti_rx, cc_idx, rnti, ul_grant.dci.cqi_request, true, ul_cfg.pusch.uci_cfg);
@@ -388,6 +420,11 @@ void cc_worker::decode_pusch(stack_interface_phy_lte::ul_sched_grant_t* grants,
     stack_interface_phy_lte::ul_sched_grant_t& ul_grant = grants[i];
     uint16_t                                   rnti     = ul_grant.dci.rnti;
 
+    // Skip PDCCH-only grants, they have no PUSCH
+    if (ul_grant.data == nullptr and ul_grant.softbuffer_rx == nullptr) {
+      continue;
+    }
+
     srsran_pusch_res_t pusch_res = {};
     srsran_ul_cfg_t    ul_cfg    = {};
 
@@ -510,7 +547,13 @@ int cc_worker::encode_pdcch_ul(stack_interface_phy_lte::ul_sched_grant_t* grants
         }
       }
 
-      if (srsran_enb_dl_put_pdcch_ul(&enb_dl, &dci_cfg, &grants[i].dci)) {
+      // UL SPS DCIs are scrambled with the SPS C-RNTI, the UE configuration is looked up with the C-RNTI
+      srsran_dci_ul_t dci = grants[i].dci;
+      if (grants[i].sps_crnti != SRSRAN_INVALID_RNTI) {
+        dci.rnti = grants[i].sps_crnti;
+      }
+
+      if (srsran_enb_dl_put_pdcch_ul(&enb_dl, &dci_cfg, &dci)) {
         Error("Error putting PUSCH %d", i);
         return SRSRAN_ERROR;
       }
@@ -110,6 +110,16 @@ cf_t* sf_worker::get_buffer_rx(uint32_t cc_idx, uint32_t antenna_idx)
   return cc_workers[cc_idx]->get_buffer_rx(antenna_idx);
 }
 
+int16_t* sf_worker::get_buffer_rx_sc16(uint32_t cc_idx, uint32_t antenna_idx)
+{
+  return cc_workers[cc_idx]->get_buffer_rx_sc16(antenna_idx);
+}
+
+void sf_worker::set_rx_sc16_scale(uint32_t cc_idx, float scale)
+{
+  cc_workers[cc_idx]->set_rx_sc16_scale(scale);
+}
+
 void sf_worker::set_context(const srsran::phy_common_interface::worker_context_t& w_ctx)
 {
   tti_rx    = w_ctx.sf_idx;
@@ -792,6 +792,10 @@ int phy_ue_db::set_ul_grant_available(uint32_t tti, const stack_interface_phy_lt
     for (uint32_t i = 0; i < ul_sched.nof_grants; i++) {
       const stack_interface_phy_lte::ul_sched_grant_t& ul_sched_grant = ul_sched.pusch[i];
       uint16_t                                         rnti           = ul_sched_grant.dci.rnti;
+      // Skip PDCCH-only grants, they have no PUSCH
+      if (ul_sched_grant.data == nullptr and ul_sched_grant.softbuffer_rx == nullptr) {
+        continue;
+      }
       // Check that eNb Cell/Carrier is active for the given RNTI
       if (_assert_active_enb_cc(rnti, enb_cc_idx) != SRSRAN_SUCCESS) {
         ret = SRSRAN_ERROR;
@@ -97,6 +97,19 @@ void prach_worker::set_max_prach_offset_us(float delay_us)
 }
 
 int prach_worker::new_tti(uint32_t tti_rx, cf_t* buffer_rx)
+{
+  return new_tti_generic(tti_rx, buffer_rx, nullptr, 0.0f);
+}
+
+int prach_worker::new_tti_sc16(uint32_t tti_rx, const int16_t* buffer_rx, float scale)
+{
+  return new_tti_generic(tti_rx, nullptr, buffer_rx, scale);
+}
+
+int prach_worker::new_tti_generic(uint32_t       tti_rx,
+                                  const cf_t*    buffer_rx,
+                                  const int16_t* buffer_rx_sc16,
+                                  float          scale)
 {
   // Save buffer only if it's a PRACH TTI
   if (srsran_prach_tti_opportunity(&prach, tti_rx, -1) || sf_cnt) {
@@ -112,9 +125,12 @@ int prach_worker::new_tti(uint32_t tti_rx, cf_t* buffer_rx)
       return -1;
     }
     if (current_buffer->nof_samples + SRSRAN_SF_LEN_PRB(cell.nof_prb) < sf_buffer_sz) {
-      memcpy(&current_buffer->samples[sf_cnt * SRSRAN_SF_LEN_PRB(cell.nof_prb)],
-             buffer_rx,
-             sizeof(cf_t) * SRSRAN_SF_LEN_PRB(cell.nof_prb));
+      cf_t* samples = &current_buffer->samples[sf_cnt * SRSRAN_SF_LEN_PRB(cell.nof_prb)];
+      if (buffer_rx_sc16 != nullptr) {
+        srsran_vec_convert_if(buffer_rx_sc16, scale, (float*)samples, 2 * SRSRAN_SF_LEN_PRB(cell.nof_prb));
+      } else {
+        memcpy(samples, buffer_rx, sizeof(cf_t) * SRSRAN_SF_LEN_PRB(cell.nof_prb));
+      }
       current_buffer->nof_samples += SRSRAN_SF_LEN_PRB(cell.nof_prb);
       if (sf_cnt == 0) {
         current_buffer->tti = tti_rx;
@@ -131,6 +131,13 @@ void txrx::run_thread()
     ul_channel->set_srate(static_cast<uint32_t>(samp_rate));
   }
 
+  // The 16-bit integer samples can only go straight from the radio to the LTE workers
+  bool rx_sc16 = worker_com->params.rx_sc16;
+  if (rx_sc16 and (not radio_h->has_rx_sc16() or ul_channel or worker_com->get_nof_carriers_nr() > 0)) {
+    logger.warning("The radio can not pass 16-bit integer samples to the LTE workers, receiving float samples");
+    rx_sc16 = false;
+  }
+
   logger.info("Starting RX/TX thread nof_prb=%d, sf_len=%d", worker_com->get_nof_prb(0), sf_len);
 
   // Set TTI so that first TX is at tti=0
@@ -168,7 +175,8 @@ void txrx::run_thread()
 
         for (uint32_t p = 0; p < worker_com->get_nof_ports(cc); p++) {
           // WARNING: The number of ports for all cells must be the same
-          buffer.set(rf_port, p, worker_com->get_nof_ports(0), lte_worker->get_buffer_rx(cc_lte, p));
+          cf_t* ptr = rx_sc16 ? (cf_t*)lte_worker->get_buffer_rx_sc16(cc_lte, p) : lte_worker->get_buffer_rx(cc_lte, p);
+          buffer.set(rf_port, p, worker_com->get_nof_ports(0), ptr);
         }
       }
       for (uint32_t cc_nr = 0; cc_nr < worker_com->get_nof_carriers_nr(); cc_nr++, cc++) {
@@ -186,7 +194,22 @@ void txrx::run_thread()
     }
 
     buffer.set_nof_samples(sf_len);
-    radio_h->rx_now(buffer, timestamp);
+    float rx_scale[SRSRAN_MAX_CHANNELS] = {};
+    bool  rx_sc16_ok                    = rx_sc16 and radio_h->rx_now_sc16(buffer, timestamp, rx_scale);
+    if (not rx_sc16_ok) {
+      if (rx_sc16) {
+        // The radio could not provide 16-bit integer samples (e.g. while changing the sample rate), so this subframe is
+        // received as float samples into the float buffers of the LTE workers
+        logger.info("Could not receive 16-bit integer samples, receiving float samples");
+        for (uint32_t cc_lte = 0; cc_lte < worker_com->get_nof_carriers_lte(); cc_lte++) {
+          uint32_t rf_port = worker_com->get_rf_port(cc_lte);
+          for (uint32_t p = 0; p < worker_com->get_nof_ports(cc_lte); p++) {
+            buffer.set(rf_port, p, worker_com->get_nof_ports(0), lte_worker->get_buffer_rx(cc_lte, p));
+          }
+        }
+      }
+      radio_h->rx_now(buffer, timestamp);
+    }
 
     if (ul_channel) {
       ul_channel->run(buffer.to_cf_t(), buffer.to_cf_t(), sf_len, timestamp.get(0));
@@ -203,7 +226,17 @@ void txrx::run_thread()
 
     // Trigger prach worker execution
     for (uint32_t cc = 0; cc < worker_com->get_nof_carriers_lte(); cc++) {
-      prach->new_tti(cc, tti, buffer.get(worker_com->get_rf_port(cc), 0, worker_com->get_nof_ports(0)));
+      uint32_t ch = worker_com->get_rf_port(cc) * worker_com->get_nof_ports(0);
+      if (rx_sc16_ok) {
+        prach->new_tti_sc16(cc, tti, (int16_t*)buffer.get(ch), rx_scale[ch]);
+        lte_worker->set_rx_sc16_scale(cc, rx_scale[ch]);
+      } else {
+        prach->new_tti(cc, tti, buffer.get(ch));
+        if (rx_sc16) {
+          // No scale makes the worker demodulate its float buffer
+          lte_worker->set_rx_sc16_scale(cc, 0.0f);
+        }
+      }
     }
 
     // Set NR worker context and start
@@ -48,6 +48,7 @@ enb_stack_lte::enb_stack_lte(srslog::sink& log_sink) :
   gtpu(&task_sched, gtpu_logger, srsran::srsran_rat_t::lte, &get_rx_io_manager()),
   s1ap(&task_sched, s1ap_logger, &get_rx_io_manager()),
   rrc(&task_sched, bearers),
+  upper_shards(&task_sched, stack_logger, pdcp_logger, rlc_logger),
   mac_pcap(),
   pending_stack_metrics(64)
 {
@@ -125,17 +126,32 @@ int enb_stack_lte::init(const stack_args_t&      args_,
     x2_task_queue = task_sched.make_task_queue();
   }
 
+  // PDCP/RLC run in the stack thread, unless they are sharded across worker threads
+  rlc_interface_mac*   mac_rlc   = &rlc;
+  rlc_interface_rrc*   rrc_rlc   = &rlc;
+  pdcp_interface_rrc*  rrc_pdcp  = &pdcp;
+  pdcp_interface_gtpu* gtpu_pdcp = &pdcp;
+  if (args.nof_upper_workers > 0) {
+    mac_rlc   = upper_shards.rlc_mac();
+    rrc_rlc   = upper_shards.rlc_rrc();
+    rrc_pdcp  = upper_shards.pdcp_rrc();
+    gtpu_pdcp = upper_shards.pdcp_gtpu();
+  }
+
   // setup bearer managers
-  gtpu_adapter.reset(new gtpu_pdcp_adapter(stack_logger, &pdcp, x2_, &gtpu, bearers));
+  gtpu_adapter.reset(new gtpu_pdcp_adapter(stack_logger, gtpu_pdcp, x2_, &gtpu, bearers));
 
   // Init all LTE layers
-  if (!mac.init(args.mac, rrc_cfg.cell_list, phy, &rlc, &rrc)) {
+  if (!mac.init(args.mac, rrc_cfg.cell_list, phy, mac_rlc, &rrc)) {
     stack_logger.error("Couldn't initialize MAC");
     return SRSRAN_ERROR;
   }
   rlc.init(&pdcp, &rrc, &mac, task_sched.get_timer_handler());
   pdcp.init(&rlc, &rrc, gtpu_adapter.get());
-  if (rrc.init(rrc_cfg, phy, &mac, &rlc, &pdcp, &s1ap, &gtpu, x2_) != SRSRAN_SUCCESS) {
+  if (args.nof_upper_workers > 0) {
+    upper_shards.init(args.nof_upper_workers, &rrc, &rrc, gtpu_adapter.get(), &mac);
+  }
+  if (rrc.init(rrc_cfg, phy, &mac, rrc_rlc, rrc_pdcp, &s1ap, &gtpu, x2_) != SRSRAN_SUCCESS) {
     stack_logger.error("Couldn't initialize RRC");
     return SRSRAN_ERROR;
   }
@@ -151,12 +167,14 @@ int enb_stack_lte::init(const stack_args_t&      args_,
   gtpu_args.mme_addr                     = args.s1ap.mme_addr;
   gtpu_args.gtp_bind_addr                = args.s1ap.gtp_bind_addr;
   gtpu_args.indirect_tunnel_timeout_msec = args.gtpu_indirect_tunnel_timeout_msec;
+  gtpu_args.max_nof_ues                  = args.mac.sched.max_nof_ues;
   if (gtpu.init(gtpu_args, gtpu_adapter.get()) != SRSRAN_SUCCESS) {
     stack_logger.error("Couldn't initialize GTPU");
     return SRSRAN_ERROR;
   }
 
   started = true;
+  upper_shards.start(STACK_MAIN_THREAD_PRIO);
   start(STACK_MAIN_THREAD_PRIO);
 
   return SRSRAN_SUCCESS;
@@ -172,6 +190,7 @@ void enb_stack_lte::tti_clock()
 void enb_stack_lte::tti_clock_impl()
 {
   task_sched.tic();
+  upper_shards.tti_clock();
   rrc.tti_clock();
 }
 
@@ -187,6 +206,9 @@ void enb_stack_lte::stop_impl()
 {
   get_rx_io_manager().stop();
 
+  // The PDCP/RLC shards call into RRC, GTPU and MAC, so they are joined before the other layers stop
+  upper_shards.stop();
+
   s1ap.stop();
   gtpu.stop();
   mac.stop();
@@ -219,8 +241,12 @@ bool enb_stack_lte::get_metrics(stack_metrics_t* metrics)
     stack_metrics_t metrics{};
     mac.get_metrics(metrics.mac);
     if (not metrics.mac.ues.empty()) {
-      rlc.get_metrics(metrics.rlc, metrics.mac.ues[0].nof_tti);
-      pdcp.get_metrics(metrics.pdcp, metrics.mac.ues[0].nof_tti);
+      if (upper_shards.nof_shards() > 0) {
+        upper_shards.get_metrics(metrics.rlc, metrics.pdcp, metrics.mac.ues[0].nof_tti);
+      } else {
+        rlc.get_metrics(metrics.rlc, metrics.mac.ues[0].nof_tti);
+        pdcp.get_metrics(metrics.pdcp, metrics.mac.ues[0].nof_tti);
+      }
     }
     rrc.get_metrics(metrics.rrc);
     s1ap.get_metrics(metrics.s1ap);
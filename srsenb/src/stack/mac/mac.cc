@@ -64,6 +64,7 @@ bool mac::init(const mac_args_t&        args_,
   args  = args_;
   cells = cells_;
 
+  ue_db.set_capacity(args.sched.max_nof_ues);
   scheduler.init(rrc, args.sched);
 
   // Init softbuffer for SI messages
@@ -351,10 +352,10 @@ int mac::push_pdu(uint32_t tti_rx,
                   tti_rx,
                   nof_bytes,
                   (int)pdu->size());
-    auto process_pdu_task = [this, rnti, enb_cc_idx, ul_nof_prbs](srsran::unique_byte_buffer_t& pdu) {
+    auto process_pdu_task = [this, tti_rx, rnti, enb_cc_idx, ul_nof_prbs](srsran::unique_byte_buffer_t& pdu) {
       srsran::rwlock_read_guard lock(rwlock);
       if (check_ue_active(rnti)) {
-        ue_db[rnti]->process_pdu(std::move(pdu), enb_cc_idx, ul_nof_prbs);
+        ue_db[rnti]->process_pdu(std::move(pdu), tti_rx, enb_cc_idx, ul_nof_prbs);
       } else {
         logger.debug("Discarding PDU rnti=0x%x", rnti);
       }
@@ -491,7 +492,7 @@ uint16_t mac::allocate_ue(uint32_t enb_cc_idx)
     {
       srsran::rwlock_read_guard read_lock(rwlock);
       if (ue_db.full()) {
-        logger.warning("Maximum number of connected UEs %zd connected to the eNB. Ignoring PRACH", SRSENB_MAX_UES);
+        logger.warning("Maximum number of connected UEs %zd connected to the eNB. Ignoring PRACH", ue_db.capacity());
         return SRSRAN_INVALID_RNTI;
       }
       if (not is_valid_rnti_unprotected(rnti)) {
@@ -1003,6 +1004,7 @@ int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
           phy_ul_sched_res->pusch[n].pid           = TTI_RX(tti_tx_ul) % SRSRAN_FDD_NOF_HARQ;
           phy_ul_sched_res->pusch[n].needs_pdcch   = sched_result.pusch[i].needs_pdcch;
           phy_ul_sched_res->pusch[n].dci           = sched_result.pusch[i].dci;
+          phy_ul_sched_res->pusch[n].sps_crnti     = sched_result.pusch[i].sps_crnti;
           phy_ul_sched_res->pusch[n].softbuffer_rx = ue_db[rnti]->get_rx_softbuffer(enb_cc_idx, tti_tx_ul);
 
           // If the Rx soft-buffer is not given, abort reception
@@ -1030,6 +1032,19 @@ int mac::get_ul_sched(uint32_t tti_tx_ul, ul_sched_list_t& ul_sched_res_list)
       }
     }
 
+    // Copy UL SPS releases, which only carry a PDCCH
+    for (uint32_t i = 0; i < sched_result.sps_release.size(); i++) {
+      if (phy_ul_sched_res->nof_grants >= stack_interface_phy_lte::MAX_GRANTS) {
+        logger.warning("No space left for UL SPS release of rnti=0x%x", sched_result.sps_release[i].dci.rnti);
+        break;
+      }
+      stack_interface_phy_lte::ul_sched_grant_t& grant = phy_ul_sched_res->pusch[phy_ul_sched_res->nof_grants++];
+      grant                                            = {};
+      grant.needs_pdcch                                = true;
+      grant.dci                                        = sched_result.sps_release[i].dci;
+      grant.sps_crnti                                  = sched_result.sps_release[i].sps_crnti;
+    }
+
     // Copy PHICH actions
     for (uint32_t i = 0; i < sched_result.phich.size(); i++) {
       phy_ul_sched_res->phich[i].ack  = sched_result.phich[i].phich == sched_interface::ul_sched_phich_t::ACK;
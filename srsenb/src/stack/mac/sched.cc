@@ -25,7 +25,11 @@
 #include "srsenb/hdr/stack/mac/sched.h"
 #include "srsenb/hdr/stack/mac/sched_carrier.h"
 #include "srsenb/hdr/stack/mac/sched_helpers.h"
+#include "srsran/common/thread_pool.h"
+#include "srsran/interfaces/enb_rrc_interface_mac.h"
 #include "srsran/srslog/srslog.h"
+#include <bitset>
+#include <condition_variable>
 
 #define Console(fmt, ...) srsran::console(fmt, ##__VA_ARGS__)
 #define Error(fmt, ...) srslog::fetch_basic_logger("MAC").error(fmt, ##__VA_ARGS__)
@@ -34,13 +38,171 @@ using srsran::tti_point;
 
 namespace srsenb {
 
+/// Stores the UE updates (reconfigurations, buffer states, feedback) received from the PHY, RLC and RRC until the start
+/// of the next TTI. The callers only hold the event mutex to append the update, so they are not blocked by the
+/// scheduling of a TTI. The updates come from several threads (PHY workers, stack, RRC) for the same UE, so instead of
+/// lock-free per-UE queues, all UEs share one queue whose critical section is a single append, which preserves the
+/// arrival order. Calls that must return a value right away first apply the pending updates of their UE
+class sched::ue_event_manager
+{
+public:
+  using callback_t = srsran::move_callback<void(sched_ue&)>;
+
+  void add_ue(uint16_t rnti)
+  {
+    std::lock_guard<std::mutex> lock(event_mutex);
+    active_rntis.set(rnti);
+  }
+
+  /// Stop accepting events for a removed UE and drop its pending events
+  void rem_ue(uint16_t rnti)
+  {
+    std::lock_guard<std::mutex> lock(event_mutex);
+    active_rntis.reset(rnti);
+    pending_rntis.reset(rnti);
+    for (ue_event_t& ev : next_tti_events) {
+      if (ev.rnti == rnti) {
+        ev.rnti = SRSRAN_INVALID_RNTI;
+      }
+    }
+  }
+
+  /// Returns false, without storing the event, if the UE does not exist
+  bool enqueue(uint16_t rnti, const char* event_name, callback_t callback)
+  {
+    std::lock_guard<std::mutex> lock(event_mutex);
+    if (not active_rntis.test(rnti)) {
+      return false;
+    }
+    next_tti_events.emplace_back(rnti, event_name, std::move(callback));
+    pending_rntis.set(rnti);
+    return true;
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(event_mutex);
+    active_rntis.reset();
+    pending_rntis.reset();
+    next_tti_events.clear();
+  }
+
+  /// Apply the pending events, in their order of arrival. access(ue, f) brings the UE up to date before calling f(ue)
+  template <typename Func>
+  void process(sched_ue_list& ue_db, const Func& access)
+  {
+    current_tti_events.clear();
+    {
+      std::lock_guard<std::mutex> lock(event_mutex);
+      next_tti_events.swap(current_tti_events);
+      pending_rntis.reset();
+    }
+
+    for (ue_event_t& ev : current_tti_events) {
+      if (ev.rnti == SRSRAN_INVALID_RNTI) {
+        continue;
+      }
+      auto it = ue_db.find(ev.rnti);
+      if (it == ue_db.end()) {
+        Error("SCHED: User rnti=0x%x not found. Failed to call %s.", ev.rnti, ev.event_name);
+        continue;
+      }
+      access(*it->second, ev.callback);
+    }
+  }
+
+  /// Apply the pending events of a single UE ahead of the others, before a call that cannot be deferred
+  template <typename Func>
+  void process_ue(sched_ue& ue, const Func& access)
+  {
+    uint16_t rnti = ue.get_rnti();
+    ue_events.clear();
+    {
+      std::lock_guard<std::mutex> lock(event_mutex);
+      if (not pending_rntis.test(rnti)) {
+        return;
+      }
+      pending_rntis.reset(rnti);
+      for (ue_event_t& ev : next_tti_events) {
+        if (ev.rnti == rnti) {
+          ue_events.push_back(std::move(ev));
+          ev.rnti = SRSRAN_INVALID_RNTI;
+        }
+      }
+    }
+
+    for (ue_event_t& ev : ue_events) {
+      access(ue, ev.callback);
+    }
+  }
+
+private:
+  struct ue_event_t {
+    uint16_t    rnti;
+    const char* event_name;
+    callback_t  callback;
+    ue_event_t(uint16_t rnti_, const char* event_name_, callback_t c) :
+      rnti(rnti_), event_name(event_name_), callback(std::move(c))
+    {
+    }
+  };
+
+  std::mutex              event_mutex;
+  std::bitset<1U << 16U>  active_rntis;
+  std::bitset<1U << 16U>  pending_rntis; ///< RNTIs with events in next_tti_events
+  std::vector<ue_event_t> next_tti_events, current_tti_events, ue_events;
+};
+
+/// Runs groups of carrier schedulers in parallel. One group runs in the calling thread, the others in the workers
+class sched::carrier_worker_pool
+{
+public:
+  explicit carrier_worker_pool(uint32_t nof_workers) : workers(nof_workers) {}
+
+  void set_nof_workers(uint32_t nof_workers)
+  {
+    if (nof_workers > workers.nof_workers()) {
+      workers.set_nof_workers(nof_workers);
+    }
+  }
+
+  /// Calls run_group(group_idx) for each group and waits until all of them have finished
+  template <typename Func>
+  void run(uint32_t nof_groups, const Func& run_group)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      nof_pending = nof_groups - 1;
+    }
+    for (uint32_t group_idx = 1; group_idx < nof_groups; ++group_idx) {
+      workers.push_task([this, group_idx, &run_group]() {
+        run_group(group_idx);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--nof_pending == 0) {
+          cvar.notify_one();
+        }
+      });
+    }
+    run_group(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cvar.wait(lock, [this]() { return nof_pending == 0; });
+  }
+
+private:
+  srsran::task_thread_pool workers;
+  std::mutex               mutex;
+  std::condition_variable  cvar;
+  uint32_t                 nof_pending = 0;
+};
+
 /*******************************************************
  *
  * Initialization and sched configuration functions
  *
  *******************************************************/
 
-sched::sched() {}
+sched::sched() : pending_events(new ue_event_manager{}) {}
 
 sched::~sched() {}
 
@@ -50,9 +212,10 @@ void sched::init(rrc_interface_mac* rrc_, const sched_args_t& sched_cfg_)
   sched_cfg = sched_cfg_;
 
   // Initialize first carrier scheduler
-  carrier_schedulers.emplace_back(new carrier_sched{rrc, &ue_db, 0, &sched_results});
+  carrier_schedulers.emplace_back(new carrier_sched{&ue_db, &active_ues, 0, &sched_results});
 
   reset();
+  ue_db.set_capacity(sched_cfg.max_nof_ues);
 }
 
 int sched::reset()
@@ -60,8 +223,14 @@ int sched::reset()
   std::lock_guard<std::mutex> lock(sched_mutex);
   for (std::unique_ptr<carrier_sched>& c : carrier_schedulers) {
     c->reset();
+    for (auto& ue_pair : ue_db) {
+      c->rem_ue(ue_pair.first);
+    }
   }
   ue_db.clear();
+  active_ues.clear();
+  active_rnti_mask.reset();
+  pending_events->clear();
   return 0;
 }
 
@@ -83,7 +252,16 @@ int sched::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg)
   uint32_t prev_size = carrier_schedulers.size();
   carrier_schedulers.resize(sched_cell_params.size());
   for (uint32_t i = prev_size; i < sched_cell_params.size(); ++i) {
-    carrier_schedulers[i].reset(new carrier_sched{rrc, &ue_db, i, &sched_results});
+    carrier_schedulers[i].reset(new carrier_sched{&ue_db, &active_ues, i, &sched_results});
+  }
+
+  // One carrier is scheduled by the caller of dl_sched/ul_sched, the others may need a worker each
+  if (sched_cfg.parallel_carriers and carrier_schedulers.size() > 1) {
+    if (cc_workers == nullptr) {
+      cc_workers.reset(new carrier_worker_pool{(uint32_t)carrier_schedulers.size() - 1});
+    } else {
+      cc_workers->set_nof_workers(carrier_schedulers.size() - 1);
+    }
   }
 
   // setup all carriers cfg params
@@ -103,20 +281,19 @@ int sched::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg)
 
 int sched::ue_cfg(uint16_t rnti, const sched_interface::ue_cfg_t& ue_cfg)
 {
-  {
-    // config existing user
-    std::lock_guard<std::mutex> lock(sched_mutex);
-    auto                        it = ue_db.find(rnti);
-    if (it != ue_db.end()) {
-      it->second->set_cfg(ue_cfg);
-      return SRSRAN_SUCCESS;
-    }
+  // config existing user, in order with the other updates of the UE
+  if (pending_events->enqueue(rnti, "ue_cfg", [ue_cfg](sched_ue& ue) { ue.set_cfg(ue_cfg); })) {
+    return SRSRAN_SUCCESS;
   }
 
   // Add new user case
   std::unique_ptr<sched_ue>   ue{new sched_ue(rnti, sched_cell_params, ue_cfg)};
   std::lock_guard<std::mutex> lock(sched_mutex);
-  ue_db.insert(rnti, std::move(ue));
+  auto                        ret = ue_db.insert(rnti, std::move(ue));
+  if (ret.has_value()) {
+    pending_events->add_ue(rnti);
+    add_active_ue(*ret.value()->second);
+  }
   return SRSRAN_SUCCESS;
 }
 
@@ -124,7 +301,16 @@ int sched::ue_rem(uint16_t rnti)
 {
   std::lock_guard<std::mutex> lock(sched_mutex);
   if (ue_db.contains(rnti)) {
+    if (active_rnti_mask.test(rnti)) {
+      active_rnti_mask.reset(rnti);
+      active_ues.erase(std::find_if(
+          active_ues.begin(), active_ues.end(), [rnti](const sched_ue* ue) { return ue->get_rnti() == rnti; }));
+    }
     ue_db.erase(rnti);
+    pending_events->rem_ue(rnti);
+    for (std::unique_ptr<carrier_sched>& c : carrier_schedulers) {
+      c->rem_ue(rnti);
+    }
   } else {
     Error("User rnti=0x%x not found", rnti);
     return SRSRAN_ERROR;
@@ -141,18 +327,18 @@ bool sched::ue_exists(uint16_t rnti)
 void sched::phy_config_enabled(uint16_t rnti, bool enabled)
 {
   // TODO: Check if correct use of last_tti
-  ue_db_access_locked(
-      rnti, [this, enabled](sched_ue& ue) { ue.phy_config_enabled(last_tti, enabled); }, __PRETTY_FUNCTION__);
+  ue_db_enqueue(
+      rnti, "phy_config_enabled", [this, enabled](sched_ue& ue) { ue.phy_config_enabled(last_tti, enabled); });
 }
 
 int sched::bearer_ue_cfg(uint16_t rnti, uint32_t lc_id, const mac_lc_ch_cfg_t& cfg_)
 {
-  return ue_db_access_locked(rnti, [lc_id, cfg_](sched_ue& ue) { ue.set_bearer_cfg(lc_id, cfg_); });
+  return ue_db_enqueue(rnti, "bearer_ue_cfg", [lc_id, cfg_](sched_ue& ue) { ue.set_bearer_cfg(lc_id, cfg_); });
 }
 
 int sched::bearer_ue_rem(uint16_t rnti, uint32_t lc_id)
 {
-  return ue_db_access_locked(rnti, [lc_id](sched_ue& ue) { ue.rem_bearer(lc_id); });
+  return ue_db_enqueue(rnti, "bearer_ue_rem", [lc_id](sched_ue& ue) { ue.rem_bearer(lc_id); });
 }
 
 uint32_t sched::get_dl_buffer(uint16_t rnti)
@@ -176,16 +362,20 @@ uint32_t sched::get_ul_buffer(uint16_t rnti)
 
 int sched::dl_rlc_buffer_state(uint16_t rnti, uint32_t lc_id, uint32_t tx_queue, uint32_t prio_tx_queue)
 {
-  return ue_db_access_locked(rnti, [&](sched_ue& ue) { ue.dl_buffer_state(lc_id, tx_queue, prio_tx_queue); });
+  return ue_db_enqueue(rnti, "dl_rlc_buffer_state", [lc_id, tx_queue, prio_tx_queue](sched_ue& ue) {
+    ue.dl_buffer_state(lc_id, tx_queue, prio_tx_queue);
+  });
 }
 
 int sched::dl_mac_buffer_state(uint16_t rnti, uint32_t ce_code, uint32_t nof_cmds)
 {
-  return ue_db_access_locked(rnti, [ce_code, nof_cmds](sched_ue& ue) { ue.mac_buffer_state(ce_code, nof_cmds); });
+  return ue_db_enqueue(
+      rnti, "dl_mac_buffer_state", [ce_code, nof_cmds](sched_ue& ue) { ue.mac_buffer_state(ce_code, nof_cmds); });
 }
 
 int sched::dl_ack_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, uint32_t tb_idx, bool ack)
 {
+  // HARQ feedback is not deferred. The caller needs the TBS of the ACKed HARQ
   int ret = -1;
   ue_db_access_locked(
       rnti,
@@ -202,25 +392,28 @@ int sched::ul_crc_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, bool
 
 int sched::dl_ri_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t ri_value)
 {
-  return ue_db_access_locked(
-      rnti, [tti, enb_cc_idx, ri_value](sched_ue& ue) { ue.set_dl_ri(tti_point{tti}, enb_cc_idx, ri_value); });
+  return ue_db_enqueue(rnti, "dl_ri_info", [tti, enb_cc_idx, ri_value](sched_ue& ue) {
+    ue.set_dl_ri(tti_point{tti}, enb_cc_idx, ri_value);
+  });
 }
 
 int sched::dl_pmi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t pmi_value)
 {
-  return ue_db_access_locked(
-      rnti, [tti, enb_cc_idx, pmi_value](sched_ue& ue) { ue.set_dl_pmi(tti_point{tti}, enb_cc_idx, pmi_value); });
+  return ue_db_enqueue(rnti, "dl_pmi_info", [tti, enb_cc_idx, pmi_value](sched_ue& ue) {
+    ue.set_dl_pmi(tti_point{tti}, enb_cc_idx, pmi_value);
+  });
 }
 
 int sched::dl_cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t cqi_value)
 {
-  return ue_db_access_locked(
-      rnti, [tti, enb_cc_idx, cqi_value](sched_ue& ue) { ue.set_dl_cqi(tti_point{tti}, enb_cc_idx, cqi_value); });
+  return ue_db_enqueue(rnti, "dl_cqi_info", [tti, enb_cc_idx, cqi_value](sched_ue& ue) {
+    ue.set_dl_cqi(tti_point{tti}, enb_cc_idx, cqi_value);
+  });
 }
 
 int sched::dl_sb_cqi_info(uint32_t tti, uint16_t rnti, uint32_t enb_cc_idx, uint32_t sb_idx, uint32_t cqi_value)
 {
-  return ue_db_access_locked(rnti, [tti, enb_cc_idx, cqi_value, sb_idx](sched_ue& ue) {
+  return ue_db_enqueue(rnti, "dl_sb_cqi_info", [tti, enb_cc_idx, cqi_value, sb_idx](sched_ue& ue) {
     ue.set_dl_sb_cqi(tti_point{tti}, enb_cc_idx, sb_idx, cqi_value);
   });
 }
@@ -233,30 +426,35 @@ int sched::dl_rach_info(uint32_t enb_cc_idx, dl_sched_rar_info_t rar_info)
 
 int sched::ul_snr_info(uint32_t tti_rx, uint16_t rnti, uint32_t enb_cc_idx, float snr, uint32_t ul_ch_code)
 {
-  return ue_db_access_locked(rnti,
-                             [&](sched_ue& ue) { ue.set_ul_snr(tti_point{tti_rx}, enb_cc_idx, snr, ul_ch_code); });
+  return ue_db_enqueue(rnti, "ul_snr_info", [tti_rx, enb_cc_idx, snr, ul_ch_code](sched_ue& ue) {
+    ue.set_ul_snr(tti_point{tti_rx}, enb_cc_idx, snr, ul_ch_code);
+  });
+}
+
+int sched::ul_pdu_info(uint32_t tti_rx, uint16_t rnti, uint32_t nof_sdus)
+{
+  return ue_db_enqueue(
+      rnti, "ul_pdu_info", [tti_rx, nof_sdus](sched_ue& ue) { ue.set_ul_pdu(tti_point{tti_rx}, nof_sdus); });
 }
 
 int sched::ul_bsr(uint16_t rnti, uint32_t lcg_id, uint32_t bsr)
 {
-  return ue_db_access_locked(rnti, [lcg_id, bsr](sched_ue& ue) { ue.ul_buffer_state(lcg_id, bsr); });
+  return ue_db_enqueue(rnti, "ul_bsr", [lcg_id, bsr](sched_ue& ue) { ue.ul_buffer_state(lcg_id, bsr); });
 }
 
 int sched::ul_buffer_add(uint16_t rnti, uint32_t lcid, uint32_t bytes)
 {
-  return ue_db_access_locked(rnti, [lcid, bytes](sched_ue& ue) { ue.ul_buffer_add(lcid, bytes); });
+  return ue_db_enqueue(rnti, "ul_buffer_add", [lcid, bytes](sched_ue& ue) { ue.ul_buffer_add(lcid, bytes); });
 }
 
 int sched::ul_phr(uint16_t rnti, int phr, uint32_t ul_nof_prb)
 {
-  return ue_db_access_locked(
-      rnti, [phr, ul_nof_prb](sched_ue& ue) { ue.ul_phr(phr, ul_nof_prb); }, __PRETTY_FUNCTION__);
+  return ue_db_enqueue(rnti, "ul_phr", [phr, ul_nof_prb](sched_ue& ue) { ue.ul_phr(phr, ul_nof_prb); });
 }
 
 int sched::ul_sr_info(uint32_t tti, uint16_t rnti)
 {
-  return ue_db_access_locked(
-      rnti, [](sched_ue& ue) { ue.set_sr(); }, __PRETTY_FUNCTION__);
+  return ue_db_enqueue(rnti, "ul_sr_info", [](sched_ue& ue) { ue.set_sr(); });
 }
 
 void sched::set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs)
@@ -359,15 +557,96 @@ int sched::ul_sched(uint32_t tti, uint32_t enb_cc_idx, srsenb::sched_interface::
 ///       configurations (e.g. different set of activated SCells) in different CC decisions
 void sched::new_tti(tti_point tti_rx)
 {
-  last_tti = std::max(last_tti, tti_rx);
+  std::array<uint32_t, SRSRAN_MAX_CARRIERS> cc_group{};
+  uint32_t                                  nof_pending_ccs = 0;
+  for (uint32_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+    cc_group[cc_idx] = cc_idx;
+    nof_pending_ccs += is_generated(tti_rx, cc_idx) ? 0 : 1;
+  }
+  if (nof_pending_ccs == 0) {
+    return;
+  }
+
+  // Apply the UE updates received since the last TTI. Idle UEs are first brought up to date with the last TTI
+  pending_events->process(ue_db, [this](sched_ue& ue, ue_event_manager::callback_t& ev) { ue_access(ue, ev); });
+
+  // UEs waiting for a RAR are kept active, as their Msg3 is allocated in the same TTI as the RAR
+  for (std::unique_ptr<carrier_sched>& c : carrier_schedulers) {
+    c->get_ra_sched()->for_each_pending_msg3_rnti([this](uint16_t rnti) {
+      auto it = ue_db.find(rnti);
+      if (it != ue_db.end() and not active_rnti_mask.test(rnti)) {
+        catch_up_ue(*it->second);
+        add_active_ue(*it->second);
+      }
+    });
+  }
+
+  // Advance the TTI counter, which unlike tti_rx does not wrap around
+  if (not last_tti.is_valid() or tti_rx > last_tti) {
+    tti_count += last_tti.is_valid() ? (uint64_t)(tti_rx - last_tti) : 1;
+    last_tti = tti_rx;
+  }
+
+  // Refresh UE internal buffers and subframe vars. CCs with a UE in common are grouped, as they share its buffers,
+  // HARQs and UCI and need to be scheduled one after the other. Idle UEs are not scheduled, so they do not group CCs
+  for (sched_ue* user : active_ues) {
+    user->new_subframe(tti_rx, tti_count);
+
+    const auto& cc_list = user->get_ue_cfg().supported_cc_list;
+    for (uint32_t i = 1; i < cc_list.size(); ++i) {
+      uint32_t old_group = cc_group[cc_list[i].enb_cc_idx];
+      uint32_t new_group = cc_group[cc_list[0].enb_cc_idx];
+      for (uint32_t& group : cc_group) {
+        group = (group == old_group) ? new_group : group;
+      }
+    }
+  }
+
+  // Paging is common to all CCs. The RRC skips paging if its lock is taken, so it is only queried once per TTI
+  uint32_t paging_payload = 0;
+  if (not rrc->is_paging_opportunity(to_tx_dl(tti_rx).to_uint(), &paging_payload)) {
+    paging_payload = 0;
+  }
+
+  // The result storage is shared by all CCs, so it is set before they are scheduled
+  for (tti_point tti : {tti_rx, tti_rx + MSG3_DELAY_MS}) {
+    if (not sched_results.has_sf(tti)) {
+      sched_results.new_tti(tti);
+    }
+  }
 
   // Generate sched results for all CCs, if not yet generated
-  for (size_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
-    if (not is_generated(tti_rx, cc_idx)) {
-      // Generate carrier scheduling result
-      carrier_schedulers[cc_idx]->generate_tti_result(tti_rx);
+  srsran::bounded_vector<uint32_t, SRSRAN_MAX_CARRIERS> groups;
+  for (uint32_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+    if (not is_generated(tti_rx, cc_idx) and std::count(groups.begin(), groups.end(), cc_group[cc_idx]) == 0) {
+      groups.push_back(cc_group[cc_idx]);
     }
   }
+  auto run_group = [this, tti_rx, paging_payload, &groups, &cc_group](uint32_t group_idx) {
+    for (uint32_t cc_idx = 0; cc_idx < carrier_schedulers.size(); ++cc_idx) {
+      if (cc_group[cc_idx] == groups[group_idx] and not is_generated(tti_rx, cc_idx)) {
+        // Generate carrier scheduling result
+        carrier_schedulers[cc_idx]->generate_tti_result(tti_rx, paging_payload);
+      }
+    }
+  };
+  if (cc_workers != nullptr and groups.size() > 1) {
+    cc_workers->run(groups.size(), run_group);
+  } else {
+    for (uint32_t group_idx = 0; group_idx < groups.size(); ++group_idx) {
+      run_group(group_idx);
+    }
+  }
+
+  // UEs left without pending work go idle, until an event or a call for them is received
+  auto idle_begin = std::remove_if(active_ues.begin(), active_ues.end(), [this](sched_ue* ue) {
+    if (not ue->is_idle()) {
+      return false;
+    }
+    active_rnti_mask.reset(ue->get_rnti());
+    return true;
+  });
+  active_ues.erase(idle_begin, active_ues.end());
 }
 
 /// Check if TTI result is generated
@@ -382,14 +661,17 @@ int sched::metrics_read(uint16_t rnti, mac_ue_metrics_t& metrics)
       rnti, [&metrics](sched_ue& ue) { ue.metrics_read(metrics); }, "metrics_read");
 }
 
-// Common way to access ue_db elements in a read locking way
+// Common way to access ue_db elements in a read locking way. The updates queued for the UE are applied first, so that
+// the call sees them in their order of arrival
 template <typename Func>
 int sched::ue_db_access_locked(uint16_t rnti, Func&& f, const char* func_name, bool log_fail)
 {
   std::lock_guard<std::mutex> lock(sched_mutex);
   auto                        it = ue_db.find(rnti);
   if (it != ue_db.end()) {
-    f(*it->second);
+    pending_events->process_ue(
+        *it->second, [this](sched_ue& ue, ue_event_manager::callback_t& ev) { ue_access(ue, ev); });
+    ue_access(*it->second, f);
   } else {
     if (log_fail) {
       if (func_name != nullptr) {
@@ -403,4 +685,51 @@ int sched::ue_db_access_locked(uint16_t rnti, Func&& f, const char* func_name, b
   return SRSRAN_SUCCESS;
 }
 
+// Defer a UE update to the start of the next TTI, without waiting for the scheduler
+template <typename Func>
+int sched::ue_db_enqueue(uint16_t rnti, const char* event_name, Func&& f)
+{
+  if (not pending_events->enqueue(rnti, event_name, std::forward<Func>(f))) {
+    Error("SCHED: User rnti=0x%x not found. Failed to call %s.", rnti, event_name);
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+// Call f on an idle UE only once it is up to date, and schedule it again if f left it with pending work
+template <typename Func>
+void sched::ue_access(sched_ue& ue, Func&& f)
+{
+  bool idle = not active_rnti_mask.test(ue.get_rnti());
+  if (idle) {
+    catch_up_ue(ue);
+  }
+  f(ue);
+  if (idle and not ue.is_idle()) {
+    add_active_ue(ue);
+  }
+}
+
+/// Idle UEs skip the TTIs in which they have nothing to schedule. Their HARQ, TPC and logical channel state is brought
+/// up to date with the last TTI when they are accessed again
+void sched::catch_up_ue(sched_ue& ue)
+{
+  if (last_tti.is_valid()) {
+    ue.new_subframe(last_tti, tti_count);
+  }
+}
+
+void sched::add_active_ue(sched_ue& ue)
+{
+  if (active_rnti_mask.test(ue.get_rnti())) {
+    return;
+  }
+  active_rnti_mask.set(ue.get_rnti());
+  // Keep the UEs sorted by RNTI, so that the scheduling order does not depend on when they became active
+  auto it = std::lower_bound(active_ues.begin(), active_ues.end(), ue.get_rnti(), [](const sched_ue* u, uint16_t rnti) {
+    return u->get_rnti() < rnti;
+  });
+  active_ues.insert(it, &ue);
+}
+
 } // namespace srsenb
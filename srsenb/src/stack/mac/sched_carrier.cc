@@ -25,7 +25,6 @@
 #include "srsenb/hdr/stack/mac/schedulers/sched_time_rr.h"
 #include "srsran/common/standard_streams.h"
 #include "srsran/common/string_helpers.h"
-#include "srsran/interfaces/enb_rrc_interface_mac.h"
 
 namespace srsenb {
 
@@ -35,12 +34,11 @@ using srsran::tti_point;
  *        Broadcast (SIB+Paging) scheduling
  *******************************************************/
 
-bc_sched::bc_sched(const sched_cell_params_t& cfg_, srsenb::rrc_interface_mac* rrc_) :
-  cc_cfg(&cfg_), rrc(rrc_), logger(srslog::fetch_basic_logger("MAC"))
+bc_sched::bc_sched(const sched_cell_params_t& cfg_) : cc_cfg(&cfg_), logger(srslog::fetch_basic_logger("MAC"))
 {
 }
 
-void bc_sched::dl_sched(sf_sched* tti_sched)
+void bc_sched::dl_sched(sf_sched* tti_sched, uint32_t paging_payload)
 {
   current_tti   = tti_sched->get_tti_tx_dl();
   bc_aggr_level = 2;
@@ -52,8 +50,7 @@ void bc_sched::dl_sched(sf_sched* tti_sched)
   alloc_sibs(tti_sched);
 
   /* Allocate Paging */
-  // NOTE: It blocks
-  alloc_paging(tti_sched);
+  alloc_paging(tti_sched, paging_payload);
 }
 
 void bc_sched::update_si_windows(sf_sched* tti_sched)
@@ -142,12 +139,10 @@ void bc_sched::alloc_sibs(sf_sched* tti_sched)
   }
 }
 
-void bc_sched::alloc_paging(sf_sched* tti_sched)
+void bc_sched::alloc_paging(sf_sched* tti_sched, uint32_t paging_payload)
 {
-  uint32_t paging_payload = 0;
-
   // Check if pending Paging message
-  if (not rrc->is_paging_opportunity(tti_sched->get_tti_tx_dl().to_uint(), &paging_payload) or paging_payload == 0) {
+  if (paging_payload == 0) {
     return;
   }
 
@@ -342,12 +337,12 @@ void ra_sched::reset()
  *                 Carrier scheduling
  *******************************************************/
 
-sched::carrier_sched::carrier_sched(rrc_interface_mac*       rrc_,
-                                    sched_ue_list*           ue_db_,
-                                    uint32_t                 enb_cc_idx_,
-                                    sched_result_ringbuffer* sched_results_) :
-  rrc(rrc_),
+sched::carrier_sched::carrier_sched(sched_ue_list*              ue_db_,
+                                    const sched_ue_active_list* active_ues_,
+                                    uint32_t                    enb_cc_idx_,
+                                    sched_result_ringbuffer*    sched_results_) :
   ue_db(ue_db_),
+  active_ues(active_ues_),
   logger(srslog::fetch_basic_logger("MAC")),
   enb_cc_idx(enb_cc_idx_),
   prev_sched_results(sched_results_)
@@ -370,7 +365,7 @@ void sched::carrier_sched::carrier_cfg(const sched_cell_params_t& cell_params_)
   cc_cfg = &cell_params_;
 
   // init Broadcast/RA schedulers
-  bc_sched_ptr.reset(new bc_sched{*cc_cfg, rrc});
+  bc_sched_ptr.reset(new bc_sched{*cc_cfg});
   ra_sched_ptr.reset(new ra_sched{*cc_cfg, *ue_db});
 
   // Setup data scheduling algorithms
@@ -393,7 +388,7 @@ void sched::carrier_sched::set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs)
   sf_dl_mask.assign(tti_mask, tti_mask + nof_sfs);
 }
 
-const cc_sched_result& sched::carrier_sched::generate_tti_result(tti_point tti_rx)
+const cc_sched_result& sched::carrier_sched::generate_tti_result(tti_point tti_rx, uint32_t paging_payload)
 {
   sf_sched*        tti_sched = get_sf_sched(tti_rx);
   sf_sched_result* sf_result = prev_sched_results->get_sf(tti_rx);
@@ -401,22 +396,22 @@ const cc_sched_result& sched::carrier_sched::generate_tti_result(tti_point tti_r
 
   bool dl_active = sf_dl_mask[tti_sched->get_tti_tx_dl().to_uint() % sf_dl_mask.size()] == 0;
 
-  /* Refresh UE internal buffers and subframe vars */
-  for (auto& user : *ue_db) {
-    user.second->new_subframe(tti_rx, enb_cc_idx);
-  }
-
-  /* Schedule PHICH */
-  for (auto& ue_pair : *ue_db) {
-    if (tti_sched->alloc_phich(ue_pair.second.get()) == alloc_result::no_grant_space) {
+  /* Schedule PHICH. Idle UEs have no pending PHICH */
+  for (sched_ue* ue : *active_ues) {
+    if (tti_sched->alloc_phich(ue) == alloc_result::no_grant_space) {
       break;
     }
   }
 
+  /* Schedule UL SPS occasions, activations and releases before any dynamic UL grant */
+  for (sched_ue* ue : *active_ues) {
+    tti_sched->alloc_ul_sps(ue);
+  }
+
   /* Schedule DL control data */
   if (dl_active) {
     /* Schedule Broadcast data (SIB and paging) */
-    bc_sched_ptr->dl_sched(tti_sched);
+    bc_sched_ptr->dl_sched(tti_sched, paging_payload);
 
     /* Schedule RAR */
     ra_sched_ptr->dl_sched(tti_sched);
@@ -442,11 +437,11 @@ const cc_sched_result& sched::carrier_sched::generate_tti_result(tti_point tti_r
   }
 
   /* Select the winner DCI allocation combination, store all the scheduling results */
-  tti_sched->generate_sched_results(*ue_db);
+  tti_sched->generate_sched_results(*ue_db, *active_ues);
 
   /* Reset ue harq pending ack state, clean-up blocked pids */
-  for (auto& user : *ue_db) {
-    user.second->finish_tti(tti_rx, enb_cc_idx);
+  for (sched_ue* ue : *active_ues) {
+    ue->finish_tti(tti_rx, enb_cc_idx);
   }
 
   log_dl_cc_results(logger, enb_cc_idx, cc_result->dl_sched_result);
@@ -470,13 +465,13 @@ void sched::carrier_sched::alloc_dl_users(sf_sched* tti_result)
   }
 
   // call DL scheduler metric to fill RB grid
-  sched_algo->sched_dl_users(*ue_db, tti_result);
+  sched_algo->sched_dl_users(*active_ues, tti_result);
 }
 
 int sched::carrier_sched::alloc_ul_users(sf_sched* tti_sched)
 {
   /* Call scheduler for UL data */
-  sched_algo->sched_ul_users(*ue_db, tti_sched);
+  sched_algo->sched_ul_users(*active_ues, tti_sched);
 
   return SRSRAN_SUCCESS;
 }
@@ -506,6 +501,13 @@ int sched::carrier_sched::dl_rach_info(dl_sched_rar_info_t rar_info)
   return ra_sched_ptr->dl_rach_info(rar_info);
 }
 
+void sched::carrier_sched::rem_ue(uint16_t rnti)
+{
+  if (sched_algo != nullptr) {
+    sched_algo->rem_ue(rnti);
+  }
+}
+
 int sched::carrier_sched::pdcch_order_info(dl_sched_po_info_t pdcch_order_info)
 {
   logger.info("SCHED: New PDCCH order preamble=%d, prach_mask_idx=%d crnti=0x%x",
@@ -36,15 +36,20 @@ void sf_sched_result::new_tti(tti_point tti_rx_)
 
 bool sf_sched_result::is_ul_alloc(uint16_t rnti) const
 {
-  for (const auto& cc : enb_cc_list) {
-    for (const auto& pusch : cc.ul_sched_result.pusch) {
-      if (pusch.dci.rnti == rnti) {
-        return true;
-      }
+  for (uint32_t enb_cc_idx = 0; enb_cc_idx < enb_cc_list.size(); ++enb_cc_idx) {
+    if (is_ul_alloc(rnti, enb_cc_idx)) {
+      return true;
     }
   }
   return false;
 }
+bool sf_sched_result::is_ul_alloc(uint16_t rnti, uint32_t enb_cc_idx) const
+{
+  const auto& pusch_list = enb_cc_list[enb_cc_idx].ul_sched_result.pusch;
+  return std::any_of(pusch_list.begin(), pusch_list.end(), [rnti](const sched_interface::ul_sched_data_t& pusch) {
+    return pusch.dci.rnti == rnti;
+  });
+}
 bool sf_sched_result::is_dl_alloc(uint16_t rnti) const
 {
   for (const auto& cc : enb_cc_list) {
@@ -538,7 +543,11 @@ alloc_result sf_sched::alloc_dl_user(sched_ue* user, const rbgmask_t& user_mask,
     }
   }
 
-  bool has_pusch_grant = is_ul_alloc(user->get_rnti()) or cc_results->is_ul_alloc(user->get_rnti());
+  // Only the carriers of the UE are checked, the other carriers may be scheduled in parallel
+  bool has_pusch_grant = is_ul_alloc(user->get_rnti());
+  for (const auto& cc : user->get_ue_cfg().supported_cc_list) {
+    has_pusch_grant |= cc_results->is_ul_alloc(user->get_rnti(), cc.enb_cc_idx);
+  }
 
   // Check if there is space in the PUCCH for HARQ ACKs
   const sched_interface::ue_cfg_t& ue_cfg    = user->get_ue_cfg();
@@ -600,8 +609,15 @@ sf_sched::alloc_ul(sched_ue* user, prb_interval alloc, ul_alloc_t::type_t alloc_
     return alloc_result::no_rnti_opportunity;
   }
 
+  ul_alloc_t ul_alloc;
+  ul_alloc.type     = alloc_type;
+  ul_alloc.is_msg3  = is_msg3;
+  ul_alloc.rnti     = user->get_rnti();
+  ul_alloc.alloc    = alloc;
+  ul_alloc.msg3_mcs = msg3_mcs;
+
   // Check if there is no collision with measGap
-  bool needs_pdcch = alloc_type == ul_alloc_t::ADAPT_RETX or (alloc_type == ul_alloc_t::NEWTX and not is_msg3);
+  bool needs_pdcch = ul_alloc.needs_pdcch();
   if (not user->pusch_enabled(get_tti_rx(), cc_cfg->enb_cc_idx, needs_pdcch)) {
     logger.debug("SCHED: PDCCH/PUSCH would collide with rnti=0x%x Measurement Gap", user->get_rnti());
     return alloc_result::no_rnti_opportunity;
@@ -614,14 +630,8 @@ sf_sched::alloc_ul(sched_ue* user, prb_interval alloc, ul_alloc_t::type_t alloc_
     return ret;
   }
 
-  ul_data_allocs.emplace_back();
-  ul_alloc_t& ul_alloc = ul_data_allocs.back();
-  ul_alloc.type        = alloc_type;
-  ul_alloc.is_msg3     = is_msg3;
-  ul_alloc.dci_idx     = tti_alloc.get_pdcch_grid().nof_allocs() - 1;
-  ul_alloc.rnti        = user->get_rnti();
-  ul_alloc.alloc       = alloc;
-  ul_alloc.msg3_mcs    = msg3_mcs;
+  ul_alloc.dci_idx = tti_alloc.get_pdcch_grid().nof_allocs() - 1;
+  ul_data_allocs.push_back(ul_alloc);
 
   return alloc_result::success;
 }
@@ -643,6 +653,78 @@ alloc_result sf_sched::alloc_ul_user(sched_ue* user, prb_interval alloc)
   return alloc_ul(user, alloc, alloc_type, h->is_msg3());
 }
 
+alloc_result sf_sched::alloc_ul_sps(sched_ue* user)
+{
+  auto p = user->get_active_cell_index(cc_cfg->enb_cc_idx);
+  if (not p.first or p.second != 0) {
+    // UL SPS is only configured in the PCell
+    return alloc_result::no_rnti_opportunity;
+  }
+  const sched_ul_sps& sps = user->find_ue_carrier(cc_cfg->enb_cc_idx)->ul_sps;
+
+  // The release DCI carries no PUSCH, so it waits for a TTI without a pending retx of the UE
+  ul_harq_proc* h = user->get_ul_harq(get_tti_tx_ul(), cc_cfg->enb_cc_idx);
+  if (sps.is_release_pending() and not h->has_pending_retx()) {
+    auto is_release = [](const ul_alloc_t& a) { return a.type == ul_alloc_t::SPS_RELEASE; };
+    if (std::count_if(ul_data_allocs.begin(), ul_data_allocs.end(), is_release) <
+            sched_interface::MAX_SPS_RELEASE_LIST and
+        alloc_ul(user, prb_interval{}, ul_alloc_t::SPS_RELEASE) == alloc_result::success) {
+      // The UE clears the SPS grant when it receives the release DCI, which carries no PUSCH
+      return alloc_result::success;
+    }
+  }
+
+  if (sps.is_active()) {
+    if (not sps.is_occasion(get_tti_tx_ul())) {
+      return alloc_result::no_rnti_opportunity;
+    }
+    // The UE transmits in the SPS occasion without PDCCH, in the PRBs of the activation
+    alloc_result ret = alloc_ul(user, sps.get_alloc(), ul_alloc_t::SPS_OCCASION);
+    if (ret != alloc_result::success) {
+      fmt::memory_buffer str_buffer;
+      fmt::format_to(str_buffer, "{}", sps.get_alloc());
+      logger.warning("SCHED: Failed to allocate UL SPS occasion rnti=0x%x, prb=%s. Cause: %s",
+                     user->get_rnti(),
+                     srsran::to_c_str(str_buffer),
+                     to_string(ret));
+    }
+    return ret;
+  }
+
+  // Activate the SPS grant once there is data in the SPS logical channel group and the HARQ is free
+  if (not sps.is_configured() or sps.is_release_pending() or not h->is_empty()) {
+    return alloc_result::no_rnti_opportunity;
+  }
+  uint32_t pending_bytes = user->get_pending_ul_lcg_data(sps.get_lcg());
+  if (pending_bytes == 0) {
+    return alloc_result::no_rnti_opportunity;
+  }
+  uint32_t nof_prbs = user->get_required_prb_ul(cc_cfg->enb_cc_idx, pending_bytes);
+
+  // The same PRBs are used in every SPS occasion. Search them from the upper edge of the band, away from the Msg3
+  // grants, and outside of the PRACH. If there is no room for all the pending data, the largest free interval is used
+  prbmask_t mask = get_ul_mask();
+  mask.fill(cc_cfg->cfg.prach_freq_offset, std::min(cc_cfg->cfg.prach_freq_offset + 6, cc_cfg->nof_prb()));
+  prb_interval alloc;
+  for (uint32_t stop = cc_cfg->nof_prb(), prb = stop; prb > 0 and alloc.length() < nof_prbs; --prb) {
+    if (mask.test(prb - 1)) {
+      stop = prb - 1;
+      continue;
+    }
+    uint32_t len = std::min(stop - prb + 1, nof_prbs);
+    if (len > alloc.length()) {
+      alloc.set(stop - len, stop);
+    }
+  }
+  while (not srsran_dft_precoding_valid_prb(alloc.length()) and not alloc.empty()) {
+    alloc.set(alloc.start() + 1, alloc.stop());
+  }
+  if (alloc.empty()) {
+    return alloc_result::no_sch_space;
+  }
+  return alloc_ul(user, alloc, ul_alloc_t::SPS_ACTIVATION);
+}
+
 alloc_result sf_sched::alloc_phich(sched_ue* user)
 {
   using phich_t = sched_interface::ul_sched_phich_t;
@@ -822,12 +904,16 @@ uci_pusch_t is_uci_included(const sf_sched*        sf_sched,
   }
 
   for (uint32_t enbccidx = 0; enbccidx < other_cc_results.enb_cc_list.size(); ++enbccidx) {
+    // Only the active carriers of the UE are checked, the other carriers may be scheduled in parallel
+    auto p = user->get_active_cell_index(enbccidx);
+    if (not p.first) {
+      continue;
+    }
     for (uint32_t j = 0; j < other_cc_results.enb_cc_list[enbccidx].ul_sched_result.pusch.size(); ++j) {
       // Checks all the UL grants already allocated for the given rnti
       if (other_cc_results.enb_cc_list[enbccidx].ul_sched_result.pusch[j].dci.rnti == user->get_rnti()) {
-        auto p = user->get_active_cell_index(enbccidx);
         // If the UE CC Idx is the lowest so far
-        if (p.first and p.second < ue_cc_idx) {
+        if (p.second < ue_cc_idx) {
           ue_cc_idx      = p.second;
           sel_enb_cc_idx = enbccidx;
         }
@@ -858,6 +944,22 @@ void sf_sched::set_ul_sched_result(const sf_cch_allocator::alloc_result_t& dci_r
       cce_range = dci_result[ul_alloc.dci_idx]->dci_pos;
     }
 
+    if (ul_alloc.type == ul_alloc_t::SPS_RELEASE) {
+      ul_result->sps_release.emplace_back();
+      user->generate_sps_release(&ul_result->sps_release.back(), cc_cfg->enb_cc_idx, cce_range);
+      logger.info("SCHED: UL SPS release rnti=0x%x, cc=%d, sps-crnti=0x%x, dci=(%d,%d), tti_tx_ul=%d",
+                  user->get_rnti(),
+                  cc_cfg->enb_cc_idx,
+                  ul_result->sps_release.back().sps_crnti,
+                  cce_range.L,
+                  cce_range.ncce,
+                  get_tti_tx_ul().to_uint());
+      continue;
+    }
+    sps_grant_t sps_grant = ul_alloc.type == ul_alloc_t::SPS_ACTIVATION ? sps_grant_t::activation
+                            : ul_alloc.type == ul_alloc_t::SPS_OCCASION ? sps_grant_t::occasion
+                                                                        : sps_grant_t::none;
+
     // If UCI is encoded in the current carrier
     uci_pusch_t uci_type = is_uci_included(this, *cc_results, user, cc_cfg->enb_cc_idx);
 
@@ -872,7 +974,8 @@ void sf_sched::set_ul_sched_result(const sf_cch_allocator::alloc_result_t& dci_r
                                                                      ul_alloc.needs_pdcch(),
                                                                      cce_range,
                                                                      ul_alloc.msg3_mcs,
-                                                                     uci_type);
+                                                                     uci_type,
+                                                                     sps_grant);
 
     ul_harq_proc* h                 = user->get_ul_harq(get_tti_tx_ul(), cc_cfg->enb_cc_idx);
     uint32_t      new_pending_bytes = user->get_pending_ul_new_data(get_tti_tx_ul(), cc_cfg->enb_cc_idx);
@@ -881,7 +984,7 @@ void sf_sched::set_ul_sched_result(const sf_cch_allocator::alloc_result_t& dci_r
       fmt::memory_buffer str_buffer;
       fmt::format_to(str_buffer,
                      "SCHED: Error {} {} rnti=0x{:x}, pid={}, dci=({},{}), prb={}, bsr={}",
-                     ul_alloc.is_msg3 ? "Msg3" : "UL",
+                     ul_alloc.is_msg3 ? "Msg3" : (ul_alloc.is_sps() ? "UL SPS" : "UL"),
                      ul_alloc.is_retx() ? "retx" : "tx",
                      user->get_rnti(),
                      h->get_id(),
@@ -901,7 +1004,7 @@ void sf_sched::set_ul_sched_result(const sf_cch_allocator::alloc_result_t& dci_r
       fmt::format_to(str_buffer,
                      "SCHED: {} {} rnti=0x{:x}, cc={}, pid={}, dci=({},{}), prb={}, n_rtx={}, cfi={}, tbs={}, bsr={} "
                      "({}-{}), tti_tx_ul={}",
-                     ul_alloc.is_msg3 ? "Msg3" : "UL",
+                     ul_alloc.is_msg3 ? "Msg3" : (ul_alloc.is_sps() ? "UL SPS" : "UL"),
                      ul_alloc.is_retx() ? "retx" : "tx",
                      user->get_rnti(),
                      cc_cfg->enb_cc_idx,
@@ -937,15 +1040,15 @@ alloc_result sf_sched::alloc_msg3(sched_ue* user, const sched_interface::dl_sche
   return ret;
 }
 
-void sf_sched::generate_sched_results(sched_ue_list& ue_db)
+void sf_sched::generate_sched_results(sched_ue_list& ue_db, const sched_ue_active_list& active_ues)
 {
   cc_sched_result* cc_result = cc_results->get_cc(cc_cfg->enb_cc_idx);
 
   /* Resume UL HARQs with pending retxs that did not get allocated */
   using phich_t    = sched_interface::ul_sched_phich_t;
   auto& phich_list = cc_result->ul_sched_result.phich;
-  for (auto& ue_pair : ue_db) {
-    auto&         ue   = *ue_pair.second;
+  for (sched_ue* ue_ptr : active_ues) {
+    auto&         ue   = *ue_ptr;
     uint16_t      rnti = ue.get_rnti();
     ul_harq_proc* h    = ue.get_ul_harq(get_tti_tx_ul(), cc_cfg->enb_cc_idx);
     if (h != nullptr and not h->is_empty() and not is_ul_alloc(rnti)) {
@@ -33,10 +33,11 @@ bool is_pucch_sr_collision(const srsran_pucch_cfg_t& ue_pucch_cfg, tti_point tti
   return false;
 }
 
-void sf_cch_allocator::init(const sched_cell_params_t& cell_params_)
+void sf_cch_allocator::init(const sched_cell_params_t& cell_params_, uint32_t max_dfs_nodes_)
 {
   cc_cfg           = &cell_params_;
   pucch_cfg_common = cc_cfg->pucch_cfg_common;
+  max_dfs_nodes    = max_dfs_nodes_;
   dci_record_list.reserve(16);
   last_dci_dfs.reserve(16);
   temp_dci_dfs.reserve(16);
@@ -72,9 +73,30 @@ sf_cch_allocator::get_cce_loc_table(alloc_type_t alloc_type, sched_ue* user, uin
   return nullptr;
 }
 
+const cce_position_list* sf_cch_allocator::get_cce_pos_list(const alloc_record& record, uint32_t cfix) const
+{
+  const cce_cfi_position_table* dci_locs = get_cce_loc_table(record.alloc_type, record.user, cfix);
+  return dci_locs == nullptr ? nullptr : &(*dci_locs)[record.aggr_idx];
+}
+
+void sf_cch_allocator::set_cce_candidates(alloc_record& record) const
+{
+  for (uint32_t cfix = current_cfix; cfix <= current_max_cfix; ++cfix) {
+    pdcch_mask_t& mask = record.cce_candidates[cfix];
+    mask.resize(cc_cfg->nof_cce_table[cfix]);
+    mask.reset();
+    const cce_position_list* dci_pos_list = get_cce_pos_list(record, cfix);
+    if (dci_pos_list == nullptr) {
+      continue;
+    }
+    for (uint32_t ncce : *dci_pos_list) {
+      mask.fill(ncce, ncce + (1U << record.aggr_idx));
+    }
+  }
+}
+
 bool sf_cch_allocator::alloc_dci(alloc_type_t alloc_type, uint32_t aggr_idx, sched_ue* user, bool has_pusch_grant)
 {
-  temp_dci_dfs.clear();
   uint32_t start_cfix = current_cfix;
 
   alloc_record record;
@@ -82,6 +104,7 @@ bool sf_cch_allocator::alloc_dci(alloc_type_t alloc_type, uint32_t aggr_idx, sch
   record.aggr_idx   = aggr_idx;
   record.alloc_type = alloc_type;
   record.pusch_uci  = has_pusch_grant;
+  set_cce_candidates(record);
 
   if (is_dl_ctrl_alloc(alloc_type) and nof_allocs() == 0 and cc_cfg->nof_prb() <= 25 and
       current_max_cfix > current_cfix) {
@@ -99,65 +122,195 @@ bool sf_cch_allocator::alloc_dci(alloc_type_t alloc_type, uint32_t aggr_idx, sch
     }
   }
 
-  // Try to allocate grant. If it fails, attempt the same grant, but using a different permutation of past grant DCI
-  // positions
-  do {
-    bool success = alloc_dfs_node(record, 0);
-    if (success) {
-      // DCI record allocation successful
-      dci_record_list.push_back(record);
-
-      if (is_dl_ctrl_alloc(alloc_type)) {
-        // Dynamic CFI not yet supported for DL control allocations, as coderate can be exceeded
-        current_max_cfix = current_cfix;
-      }
-      return true;
+  // Place the DCI in the CCEs left free by the previous allocations. On conflict, move the previous DCIs, and increase
+  // the CFI as a last resort
+  bool success = alloc_dfs_node(record, 0);
+  if (success) {
+    dci_record_list.push_back(record);
+  } else {
+    temp_dci_dfs = last_dci_dfs;
+    dci_record_list.push_back(record);
+    success = relocate_dci() or search_dfs();
+    while (not success and current_cfix < current_max_cfix) {
+      current_cfix++;
+      last_dci_dfs.clear();
+      success = search_dfs();
     }
-    if (temp_dci_dfs.empty()) {
-      temp_dci_dfs = last_dci_dfs;
+  }
+
+  if (success) {
+    if (is_dl_ctrl_alloc(alloc_type)) {
+      // Dynamic CFI not yet supported for DL control allocations, as coderate can be exceeded
+      current_max_cfix = current_cfix;
     }
-  } while (get_next_dfs());
+    return true;
+  }
 
   // Revert steps to initial state, before dci record allocation was attempted
+  dci_record_list.pop_back();
   last_dci_dfs.swap(temp_dci_dfs);
   current_cfix = start_cfix;
   return false;
 }
 
-bool sf_cch_allocator::get_next_dfs()
+/// Depth-first search of the DCI positions of all records, starting from the current DFS path
+bool sf_cch_allocator::search_dfs()
 {
-  do {
-    uint32_t start_child_idx = 0;
-    if (last_dci_dfs.empty()) {
-      // If we reach root, increase CFI
-      current_cfix++;
-      if (current_cfix > current_max_cfix) {
-        return false;
+  uint32_t nof_backtracks  = 0;
+  uint32_t start_child_idx = 0;
+  while (last_dci_dfs.size() < dci_record_list.size()) {
+    if (alloc_dfs_node(dci_record_list[last_dci_dfs.size()], start_child_idx)) {
+      start_child_idx = 0;
+      continue;
+    }
+    if (last_dci_dfs.empty() or (max_dfs_nodes > 0 and ++nof_backtracks > max_dfs_nodes)) {
+      // All the DCI positions were searched, or the search exceeded its limit
+      return false;
+    }
+    // Attempt to re-add last tree node, but with a higher node child index
+    start_child_idx = last_dci_dfs.back().dci_pos_idx + 1;
+    last_dci_dfs.pop_back();
+  }
+  return true;
+}
+
+/// Attempts to fit the last DCI record by moving the single DCI that blocks one of its positions. This repairs in
+/// O(nof_allocs) bitset operations the common conflicts that the bounded DFS may not reach. As in the DFS, the most
+/// recent DCIs are moved first, so that the earlier DCIs keep their positions whenever possible
+bool sf_cch_allocator::relocate_dci()
+{
+  if (max_dfs_nodes == 0 or last_dci_dfs.empty()) {
+    // The exhaustive DFS finds any solution
+    return false;
+  }
+  const alloc_record&      record       = dci_record_list.back();
+  const cce_position_list* dci_pos_list = get_cce_pos_list(record, current_cfix);
+  if (dci_pos_list == nullptr) {
+    return false;
+  }
+
+  pdcch_mask_t dci_mask(nof_cces()), rest_mask(nof_cces()), others_mask(nof_cces());
+  prbmask_t    others_pucch_mask(cc_cfg->nof_prb());
+  for (uint32_t blocker_idx = last_dci_dfs.size(); blocker_idx-- > 0;) {
+    tree_node           blocker        = last_dci_dfs[blocker_idx];
+    const alloc_record& blocker_record = dci_record_list[blocker_idx];
+
+    // PDCCH and PUCCH resources of the other DCIs
+    rest_mask.reset();
+    others_pucch_mask.reset();
+    for (uint32_t i = 0; i < last_dci_dfs.size(); ++i) {
+      if (i != blocker_idx) {
+        rest_mask |= last_dci_dfs[i].current_mask;
+        if (last_dci_dfs[i].pucch_n_prb >= 0) {
+          others_pucch_mask.set(last_dci_dfs[i].pucch_n_prb);
+        }
       }
+    }
+
+    for (uint32_t dci_pos_idx = 0; dci_pos_idx < dci_pos_list->size(); ++dci_pos_idx) {
+      uint32_t ncce = (*dci_pos_list)[dci_pos_idx];
+      if (rest_mask.any(ncce, ncce + (1U << record.aggr_idx)) or
+          not blocker.current_mask.any(ncce, ncce + (1U << record.aggr_idx))) {
+        // This position is not blocked by this DCI alone
+        continue;
+      }
+      dci_mask.reset();
+      dci_mask.fill(ncce, ncce + (1U << record.aggr_idx));
+      others_mask = rest_mask | dci_mask;
+      if ((blocker_record.cce_candidates[current_cfix] & ~others_mask).none()) {
+        // None of the CCEs of the blocking DCI positions is free
+        continue;
+      }
+
+      const cce_position_list& blocker_pos_list = *get_cce_pos_list(blocker_record, current_cfix);
+      for (uint32_t pos_idx = 0; pos_idx < blocker_pos_list.size(); ++pos_idx) {
+        int8_t   pucch_n_prb  = -1;
+        uint32_t blocker_ncce = blocker_pos_list[pos_idx];
+        if (pos_idx == blocker.dci_pos_idx or
+            not check_dci_pos(blocker_record, blocker_ncce, others_mask, others_pucch_mask, &pucch_n_prb)) {
+          continue;
+        }
+        tree_node& node   = last_dci_dfs[blocker_idx];
+        node.pucch_n_prb  = pucch_n_prb;
+        node.dci_pos_idx  = pos_idx;
+        node.dci_pos.ncce = blocker_ncce;
+        node.current_mask.reset();
+        node.current_mask.fill(node.dci_pos.ncce, node.dci_pos.ncce + (1U << blocker_record.aggr_idx));
+        update_total_masks(blocker_idx);
+        if (alloc_dfs_node(record, dci_pos_idx)) {
+          return true;
+        }
+      }
+
+      // Revert the blocking DCI to its previous position
+      last_dci_dfs[blocker_idx] = blocker;
+      update_total_masks(blocker_idx);
+    }
+  }
+  return false;
+}
+
+/// Recomputes the accumulated PDCCH and PUCCH masks of the DFS path from a node onwards
+void sf_cch_allocator::update_total_masks(uint32_t start_node_idx)
+{
+  for (uint32_t i = start_node_idx; i < last_dci_dfs.size(); ++i) {
+    tree_node& node = last_dci_dfs[i];
+    if (i > 0) {
+      node.total_mask       = last_dci_dfs[i - 1].total_mask | node.current_mask;
+      node.total_pucch_mask = last_dci_dfs[i - 1].total_pucch_mask;
     } else {
-      // Attempt to re-add last tree node, but with a higher node child index
-      start_child_idx = last_dci_dfs.back().dci_pos_idx + 1;
-      last_dci_dfs.pop_back();
+      node.total_mask = node.current_mask;
+      node.total_pucch_mask.reset();
     }
-    while (last_dci_dfs.size() < dci_record_list.size() and
-           alloc_dfs_node(dci_record_list[last_dci_dfs.size()], start_child_idx)) {
-      start_child_idx = 0;
+    if (node.pucch_n_prb >= 0) {
+      node.total_pucch_mask.set(node.pucch_n_prb);
+    }
+  }
+}
+
+/// Checks whether a DCI position avoids the given PDCCH and PUCCH allocations, and derives its PUCCH resource
+bool sf_cch_allocator::check_dci_pos(const alloc_record& record,
+                                     uint32_t            ncce,
+                                     const pdcch_mask_t& pdcch_mask,
+                                     const prbmask_t&    pucch_mask,
+                                     int8_t*             pucch_n_prb)
+{
+  if (pdcch_mask.any(ncce, ncce + (1U << record.aggr_idx))) {
+    // there is a PDCCH collision. Try another CCE position
+    return false;
+  }
+
+  *pucch_n_prb = -1;
+  if (record.alloc_type == alloc_type_t::DL_DATA and not record.pusch_uci) {
+    // The UE needs to allocate space in PUCCH for HARQ-ACK
+    pucch_cfg_common.n_pucch = ncce + pucch_cfg_common.N_pucch_1;
+
+    if (is_pucch_sr_collision(record.user->get_ue_cfg().pucch_cfg, to_tx_dl_ack(tti_rx), pucch_cfg_common.n_pucch)) {
+      // avoid collision of HARQ-ACK with own SR n(1)_pucch
+      return false;
     }
-  } while (last_dci_dfs.size() < dci_record_list.size());
 
-  // Finished computation of next DFS node
+    *pucch_n_prb = srsran_pucch_n_prb(&cc_cfg->cfg.cell, &pucch_cfg_common, 0);
+    if (not cc_cfg->sched_cfg->pucch_mux_enabled and pucch_mask.test(*pucch_n_prb)) {
+      // PUCCH allocation would collide with other PUCCH/PUSCH grants. Try another CCE position
+      return false;
+    }
+    int low_rb = *pucch_n_prb < (int)cc_cfg->cfg.cell.nof_prb / 2 ? *pucch_n_prb
+                                                                   : cc_cfg->cfg.cell.nof_prb - *pucch_n_prb - 1;
+    if (cc_cfg->sched_cfg->pucch_harq_max_rb > 0 && low_rb >= cc_cfg->sched_cfg->pucch_harq_max_rb) {
+      // PUCCH allocation would fall outside the maximum allowed PUCCH HARQ region. Try another CCE position
+      logger.info("Skipping PDCCH allocation for CCE=%d due to PUCCH HARQ falling outside region\n", ncce);
+      return false;
+    }
+  }
   return true;
 }
 
 bool sf_cch_allocator::alloc_dfs_node(const alloc_record& record, uint32_t start_dci_idx)
 {
   // Get DCI Location Table
-  const cce_cfi_position_table* dci_locs = get_cce_loc_table(record.alloc_type, record.user, current_cfix);
-  if (dci_locs == nullptr or (*dci_locs)[record.aggr_idx].empty()) {
-    return false;
-  }
-  const cce_position_list& dci_pos_list = (*dci_locs)[record.aggr_idx];
-  if (start_dci_idx >= dci_pos_list.size()) {
+  const cce_position_list* dci_pos_list = get_cce_pos_list(record, current_cfix);
+  if (dci_pos_list == nullptr or start_dci_idx >= dci_pos_list->size()) {
     return false;
   }
 
@@ -175,42 +328,14 @@ bool sf_cch_allocator::alloc_dfs_node(const alloc_record& record, uint32_t start
     node.total_pucch_mask.resize(cc_cfg->nof_prb());
   }
 
-  for (; node.dci_pos_idx < dci_pos_list.size(); ++node.dci_pos_idx) {
-    node.dci_pos.ncce = dci_pos_list[node.dci_pos_idx];
-
-    if (record.alloc_type == alloc_type_t::DL_DATA and not record.pusch_uci) {
-      // The UE needs to allocate space in PUCCH for HARQ-ACK
-      pucch_cfg_common.n_pucch = node.dci_pos.ncce + pucch_cfg_common.N_pucch_1;
-
-      if (is_pucch_sr_collision(record.user->get_ue_cfg().pucch_cfg, to_tx_dl_ack(tti_rx), pucch_cfg_common.n_pucch)) {
-        // avoid collision of HARQ-ACK with own SR n(1)_pucch
-        continue;
-      }
-
-      node.pucch_n_prb = srsran_pucch_n_prb(&cc_cfg->cfg.cell, &pucch_cfg_common, 0);
-      if (not cc_cfg->sched_cfg->pucch_mux_enabled and node.total_pucch_mask.test(node.pucch_n_prb)) {
-        // PUCCH allocation would collide with other PUCCH/PUSCH grants. Try another CCE position
-        continue;
-      }
-      int low_rb = node.pucch_n_prb < (int)cc_cfg->cfg.cell.nof_prb / 2
-                       ? node.pucch_n_prb
-                       : cc_cfg->cfg.cell.nof_prb - node.pucch_n_prb - 1;
-      if (cc_cfg->sched_cfg->pucch_harq_max_rb > 0 && low_rb >= cc_cfg->sched_cfg->pucch_harq_max_rb) {
-        // PUCCH allocation would fall outside the maximum allowed PUCCH HARQ region. Try another CCE position
-        logger.info("Skipping PDCCH allocation for CCE=%d due to PUCCH HARQ falling outside region\n",
-                    node.dci_pos.ncce);
-        continue;
-      }
-    }
-
-    node.current_mask.reset();
-    node.current_mask.fill(node.dci_pos.ncce, node.dci_pos.ncce + (1U << record.aggr_idx));
-    if ((node.total_mask & node.current_mask).any()) {
-      // there is a PDCCH collision. Try another CCE position
+  for (; node.dci_pos_idx < dci_pos_list->size(); ++node.dci_pos_idx) {
+    node.dci_pos.ncce = (*dci_pos_list)[node.dci_pos_idx];
+    if (not check_dci_pos(record, node.dci_pos.ncce, node.total_mask, node.total_pucch_mask, &node.pucch_n_prb)) {
       continue;
     }
 
     // Allocation successful
+    node.current_mask.fill(node.dci_pos.ncce, node.dci_pos.ncce + (1U << record.aggr_idx));
     node.total_mask |= node.current_mask;
     if (node.pucch_n_prb >= 0) {
       node.total_pucch_mask.set(node.pucch_n_prb);
@@ -96,17 +96,29 @@ void sched_ue::set_cfg(const ue_cfg_t& cfg_)
   check_ue_cfg_correctness(cfg);
 }
 
-void sched_ue::new_subframe(tti_point tti_rx, uint32_t enb_cc_idx)
+void sched_ue::new_subframe(tti_point tti_rx, uint64_t tti_count_)
 {
   if (current_tti != tti_rx) {
-    current_tti = tti_rx;
-    lch_handler.new_tti();
+    // An idle UE is not processed every TTI, so it catches up with all the TTIs it skipped
+    uint64_t nof_ttis = (tti_count > 0 and tti_count_ > tti_count) ? tti_count_ - tti_count : 1;
+    nof_ttis          = std::min(nof_ttis, (uint64_t)std::numeric_limits<uint32_t>::max());
+    current_tti       = tti_rx;
+    tti_count         = tti_count_;
+    lch_handler.new_tti(nof_ttis);
     for (auto& cc : cells) {
-      cc.new_tti(tti_rx);
+      cc.new_tti(tti_rx, nof_ttis);
     }
   }
 }
 
+bool sched_ue::is_idle() const
+{
+  if (sr or lch_handler.has_pending_dl_txs() or lch_handler.get_bsr() > 0) {
+    return false;
+  }
+  return std::all_of(cells.begin(), cells.end(), [](const sched_ue_cell& cc) { return cc.is_idle(); });
+}
+
 /*******************************************************
  *
  * FAPI-like main scheduler interface.
@@ -269,6 +281,13 @@ void sched_ue::set_ul_crc(tti_point tti_rx, uint32_t enb_cc_idx, bool crc_res)
   cells[enb_cc_idx].set_ul_crc(tti_rx, crc_res);
 }
 
+void sched_ue::set_ul_pdu(tti_point tti_rx, uint32_t nof_sdus)
+{
+  if (not cfg.supported_cc_list.empty()) {
+    cells[cfg.supported_cc_list[0].enb_cc_idx].ul_sps.set_ul_pdu(tti_rx, nof_sdus);
+  }
+}
+
 void sched_ue::set_dl_ri(tti_point tti_rx, uint32_t enb_cc_idx, uint32_t ri)
 {
   if (cells[enb_cc_idx].cc_state() != cc_st::idle) {
@@ -595,22 +614,31 @@ int sched_ue::generate_format0(sched_interface::ul_sched_data_t* data,
                                bool                              needs_pdcch,
                                srsran_dci_location_t             dci_pos,
                                int                               explicit_mcs,
-                               uci_pusch_t                       uci_type)
+                               uci_pusch_t                       uci_type,
+                               sps_grant_t                       sps_grant)
 {
   ul_harq_proc*    h   = get_ul_harq(tti_tx_ul, enb_cc_idx);
   srsran_dci_ul_t* dci = &data->dci;
+  sched_ul_sps&    sps = cells[enb_cc_idx].ul_sps;
 
-  bool cqi_request = needs_cqi(tti_tx_ul.to_uint(), enb_cc_idx, true);
+  // There is no DCI, and thus no CQI request, in the SPS occasions
+  bool cqi_request = sps_grant != sps_grant_t::occasion and needs_cqi(tti_tx_ul.to_uint(), enb_cc_idx, true);
 
   // Set DCI position
   data->needs_pdcch = needs_pdcch;
+  data->sps_crnti   = SRSRAN_INVALID_RNTI;
   dci->location     = dci_pos;
 
   tbs_info tbinfo;
   tbinfo.mcs       = (explicit_mcs >= 0) ? explicit_mcs : cells[enb_cc_idx].fixed_mcs_ul;
   tbinfo.tbs_bytes = 0;
+  if (sps_grant == sps_grant_t::occasion) {
+    // The SPS occasions reuse the MCS of the activation
+    tbinfo.mcs = sps.get_mcs();
+  }
 
-  bool is_newtx = h->is_empty(0);
+  // The UE considers the NDI toggled in the SPS occasions, even if the HARQ had a pending retx
+  bool is_newtx = h->is_empty(0) or sps_grant != sps_grant_t::none;
   if (is_newtx) {
     if (tbinfo.mcs >= 0) {
       tbinfo.tbs_bytes = get_tbs_bytes(tbinfo.mcs, alloc.length(), false, true);
@@ -644,12 +672,20 @@ int sched_ue::generate_format0(sched_interface::ul_sched_data_t* data,
         // NOTE: if (nof_re < nof_uci_re) we should set TBS=0
       }
     }
+    if (sps_grant == sps_grant_t::activation and tbinfo.mcs > (int)sched_ul_sps::max_mcs) {
+      tbinfo.mcs       = sched_ul_sps::max_mcs;
+      tbinfo.tbs_bytes = get_tbs_bytes(tbinfo.mcs, alloc.length(), false, true);
+    }
     // If Msg3 set different nof retx
-    uint32_t nof_retx = (data->needs_pdcch) ? get_max_retx() : max_msg3retx;
-    h->new_tx(tti_tx_ul, tbinfo.mcs, tbinfo.tbs_bytes, alloc, nof_retx, not data->needs_pdcch);
+    bool     is_msg3  = not data->needs_pdcch and sps_grant == sps_grant_t::none;
+    uint32_t nof_retx = is_msg3 ? max_msg3retx : get_max_retx();
+    h->new_tx(tti_tx_ul, tbinfo.mcs, tbinfo.tbs_bytes, alloc, nof_retx, is_msg3, sps_grant != sps_grant_t::none);
     // Un-trigger the SR if data is allocated
     if (tbinfo.tbs_bytes > 0) {
       unset_sr();
+      if (sps_grant == sps_grant_t::activation) {
+        sps.activate(tti_tx_ul, alloc, tbinfo.mcs);
+      }
     }
   } else {
     // retx
@@ -666,10 +702,22 @@ int sched_ue::generate_format0(sched_interface::ul_sched_data_t* data,
     dci->tb.ndi         = h->get_ndi(0);
     dci->cqi_request    = cqi_request;
     dci->freq_hop_fl    = srsran_dci_ul_t::SRSRAN_RA_PUSCH_HOP_DISABLED;
-    dci->tpc_pusch      = cells[enb_cc_idx].tpc_fsm.encode_pusch_tpc();
+    // The TPC field of the SPS activation is zero, see TS 36.213, Table 9.2-1
+    dci->tpc_pusch = sps_grant == sps_grant_t::none ? cells[enb_cc_idx].tpc_fsm.encode_pusch_tpc() : 0;
 
     dci->type2_alloc.riv = srsran_ra_type2_to_riv(alloc.length(), alloc.start(), cell.nof_prb);
 
+    // The activation, the occasions and the retxs of SPS HARQs carry the SPS C-RNTI, which scrambles their PUSCH. See
+    // TS 36.211, 5.3.1. Their DCIs, the activation (NDI=0) and the adaptive retxs (NDI=1), are scrambled with it too.
+    // A C-RNTI grant would make the UE flush the SPS HARQ
+    if (h->is_sps() and tbinfo.tbs_bytes > 0 and sps.get_sps_crnti() != SRSRAN_INVALID_RNTI) {
+      data->sps_crnti = sps.get_sps_crnti();
+      if (needs_pdcch) {
+        dci->tb.ndi = not is_newtx;
+        dci->n_dmrs = 0;
+      }
+    }
+
     // If there are no RE available for ULSCH but there is UCI to transmit, allocate PUSCH becuase
     // resources have been reserved already and in CA it will be used to ACK other carriers
     if (tbinfo.tbs_bytes == 0 && (cqi_request || uci_type != UCI_PUSCH_NONE)) {
@@ -700,6 +748,29 @@ int sched_ue::generate_format0(sched_interface::ul_sched_data_t* data,
   return tbinfo.tbs_bytes;
 }
 
+void sched_ue::generate_sps_release(sched_interface::ul_sched_sps_release_t* data,
+                                    uint32_t                                 enb_cc_idx,
+                                    srsran_dci_location_t                    cce_range)
+{
+  sched_ul_sps&    sps = cells[enb_cc_idx].ul_sps;
+  srsran_dci_ul_t* dci = &data->dci;
+
+  // Fields of the SPS release validation, see TS 36.213, Table 9.2-1A
+  *dci                 = {};
+  dci->location        = cce_range;
+  dci->rnti            = rnti;
+  dci->format          = SRSRAN_DCI_FORMAT0;
+  dci->ue_cc_idx       = cells[enb_cc_idx].get_ue_cc_idx();
+  dci->freq_hop_fl     = srsran_dci_ul_t::SRSRAN_RA_PUSCH_HOP_DISABLED;
+  dci->type2_alloc.riv = std::numeric_limits<uint32_t>::max();
+  dci->tb.mcs_idx      = 31;
+  dci->tb.ndi          = false;
+  dci->tpc_pusch       = 0;
+  dci->n_dmrs          = 0;
+  data->sps_crnti      = sps.get_sps_crnti();
+  sps.release_sent();
+}
+
 /*******************************************************
  *
  * Functions used by scheduler or scheduler metric objects
@@ -870,6 +941,12 @@ uint32_t sched_ue::get_pending_ul_old_data(uint32_t enb_cc_idx)
   return pending_data;
 }
 
+/// Returns the pending bytes of a logical channel group, including the MAC subheaders
+uint32_t sched_ue::get_pending_ul_lcg_data(uint32_t lcg) const
+{
+  return std::max(lch_handler.get_bsr_with_overhead(lcg), 0);
+}
+
 /// Returns the total of all TB bytes allocated to UL HARQs
 uint32_t sched_ue::get_pending_ul_old_data()
 {
@@ -255,13 +255,20 @@ bool ul_harq_proc::has_pending_retx() const
   return has_pending_retx_common(0);
 }
 
-void ul_harq_proc::new_tx(tti_point tti_, int mcs, int tbs, prb_interval alloc, uint32_t max_retx_, bool is_msg3)
+void ul_harq_proc::new_tx(tti_point    tti_,
+                          int          mcs,
+                          int          tbs,
+                          prb_interval alloc,
+                          uint32_t     max_retx_,
+                          bool         is_msg3,
+                          bool         is_sps)
 {
   allocation = alloc;
   new_tx_common(0, tti_point{tti_}, mcs, tbs, max_retx_);
   pending_data    = tbs;
   pending_phich   = true;
   is_msg3_        = is_msg3;
+  is_sps_         = is_sps;
   pdcch_requested = false;
 }
 
@@ -328,6 +335,7 @@ void ul_harq_proc::reset_pending_data()
   reset_pending_data_common();
   pending_data    = 0;
   is_msg3_        = false;
+  is_sps_         = false;
   pdcch_requested = false;
 }
 
@@ -367,8 +375,12 @@ void harq_entity::reset()
   }
 }
 
-void harq_entity::new_tti(tti_point tti_rx)
+void harq_entity::new_tti(tti_point tti_rx, uint32_t nof_ttis)
 {
+  // A UE skips TTIs only while its HARQs are empty, so the skipped TTIs just need to be stamped
+  for (uint32_t i = std::min(nof_ttis, (uint32_t)last_ttis.size()) - 1; i > 0; --i) {
+    last_ttis[(tti_rx - i).to_uint() % last_ttis.size()] = tti_rx - i;
+  }
   last_ttis[tti_rx.to_uint() % last_ttis.size()] = tti_rx;
   get_ul_harq(to_tx_ul(tti_rx))->new_tti();
   for (auto& hdl : dl_harqs) {
@@ -421,6 +433,21 @@ int harq_entity::set_ul_crc(tti_point tti_rx, uint32_t tb_idx, bool ack_)
   return h->set_ack(tb_idx, ack_) ? pid : -1;
 }
 
+bool harq_entity::is_empty() const
+{
+  for (const dl_harq_proc& h : dl_harqs) {
+    if (not h.is_empty()) {
+      return false;
+    }
+  }
+  for (const ul_harq_proc& h : ul_harqs) {
+    if (not h.is_empty() or h.has_pending_phich()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void harq_entity::finish_tti(tti_point tti_rx)
 {
   // Reset UL HARQ if no retxs
@@ -69,14 +69,15 @@ void lch_ue_manager::set_cfg(const sched_interface::ue_cfg_t& cfg)
   config_lcids(cfg.ue_bearers);
 }
 
-void lch_ue_manager::new_tti()
+void lch_ue_manager::new_tti(uint32_t nof_ttis)
 {
-  prio_idx++;
+  prio_idx += nof_ttis;
   for (uint32_t lcid = 0; lcid < sched_interface::MAX_LC; ++lcid) {
     if (is_bearer_active(lcid)) {
       if (channels[lcid].cfg.pbr != pbr_infinity) {
-        channels[lcid].Bj =
-            std::min(channels[lcid].Bj + (int)(channels[lcid].cfg.pbr * tti_duration_ms), channels[lcid].bucket_size);
+        // The bucket saturates, so the TTIs skipped by an idle UE can be accounted for at once
+        int64_t Bj = channels[lcid].Bj + (int64_t)channels[lcid].cfg.pbr * tti_duration_ms * nof_ttis;
+        channels[lcid].Bj = (int)std::min(Bj, (int64_t)channels[lcid].bucket_size);
       }
     }
   }
@@ -53,6 +53,7 @@ sched_ue_cell::sched_ue_cell(uint16_t rnti_, const sched_cell_params_t& cell_cfg
           cell_cfg->sched_cfg->min_tpc_tti_interval,
           cell_cfg->sched_cfg->ul_snr_avg_alpha,
           cell_cfg->sched_cfg->init_ul_snr_value),
+  ul_sps(rnti_),
   fixed_mcs_dl(cell_cfg_.sched_cfg->pdsch_mcs),
   fixed_mcs_ul(cell_cfg_.sched_cfg->pusch_mcs),
   current_tti(current_tti_),
@@ -110,6 +111,9 @@ void sched_ue_cell::set_ue_cfg(const sched_interface::ue_cfg_t& ue_cfg_)
     logger.info("SCHED: Resetting rnti=0x%x, cc=%d HARQs and feedback state", rnti, cell_cfg->enb_cc_idx);
   }
 
+  // UL SPS is only configured in the PCell
+  ul_sps.set_cfg(ue_cc_idx == 0 ? ue_cfg_.ul_sps_cfg : sched_ul_sps::sps_cfg_t{});
+
   // Update carrier state
   if (ue_cc_idx == 0) {
     // PCell is always active
@@ -144,15 +148,15 @@ void sched_ue_cell::set_ue_cfg(const sched_interface::ue_cfg_t& ue_cfg_)
   }
 }
 
-void sched_ue_cell::new_tti(tti_point tti_rx)
+void sched_ue_cell::new_tti(tti_point tti_rx, uint32_t nof_ttis)
 {
   if (not configured()) {
     return;
   }
   current_tti = tti_rx;
 
-  harq_ent.new_tti(tti_rx);
-  tpc_fsm.new_tti();
+  harq_ent.new_tti(tti_rx, nof_ttis);
+  tpc_fsm.new_tti(nof_ttis);
 
   // Check if cell state needs to be updated
   if (ue_cc_idx > 0 and cc_state_ == cc_st::deactivating) {
@@ -181,6 +185,17 @@ void sched_ue_cell::finish_tti(tti_point tti_rx)
   harq_ent.finish_tti(tti_rx);
 }
 
+bool sched_ue_cell::is_idle() const
+{
+  if (not configured()) {
+    return true;
+  }
+  if (cc_state_ == cc_st::activating or cc_state_ == cc_st::deactivating or ul_sps.is_configured()) {
+    return false;
+  }
+  return harq_ent.is_empty();
+}
+
 void sched_ue_cell::check_cc_activation(uint32_t dl_cqi)
 {
   if (ue_cc_idx > 0 and cc_state_ == cc_st::activating and dl_cqi > 0) {
@@ -231,6 +246,8 @@ int sched_ue_cell::set_ul_crc(tti_point tti_rx, bool crc_res)
   }
 
   // Update HARQ process
+  ul_sps.set_ul_crc(tti_rx, crc_res);
+
   int pid = harq_ent.set_ul_crc(tti_rx, 0, crc_res);
   if (pid < 0) {
     logger.warning("SCHED: rnti=0x%x received UL CRC for invalid tti_rx=%d", rnti, (int)tti_rx.to_uint());
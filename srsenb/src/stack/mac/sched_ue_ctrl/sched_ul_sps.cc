@@ -0,0 +1,124 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/mac/sched_ue_ctrl/sched_ul_sps.h"
+#include "srsran/common/string_helpers.h"
+
+namespace srsenb {
+
+sched_ul_sps::sched_ul_sps(uint16_t rnti_) : rnti(rnti_), logger(srslog::fetch_basic_logger("MAC")) {}
+
+void sched_ul_sps::set_cfg(const sps_cfg_t& cfg_)
+{
+  bool changed = cfg_.sps_crnti != cfg.sps_crnti or cfg_.interval_ms != cfg.interval_ms or
+                 cfg_.implicit_release_after != cfg.implicit_release_after or cfg_.lcg != cfg.lcg;
+  if (not changed) {
+    return;
+  }
+  deactivate("SPS reconfiguration");
+  release_crnti = SRSRAN_INVALID_RNTI;
+  cfg           = cfg_;
+  if (is_configured()) {
+    logger.info("SCHED: UL SPS configured for rnti=0x%x, sps-crnti=0x%x, interval=%d, lcg=%d",
+                rnti,
+                cfg.sps_crnti,
+                cfg.interval_ms,
+                cfg.lcg);
+  }
+}
+
+void sched_ul_sps::reset()
+{
+  active           = false;
+  nof_empty_pdus   = 0;
+  nof_crc_failures = 0;
+  release_crnti    = SRSRAN_INVALID_RNTI;
+}
+
+bool sched_ul_sps::is_occasion(tti_point tti_tx_ul) const
+{
+  // Every SPS interval divides the TTI wrap-around, so the occasions are periodic across it
+  return active and (tti_tx_ul.to_uint() + 10240 - start_tti.to_uint()) % cfg.interval_ms == 0;
+}
+
+void sched_ul_sps::activate(tti_point tti_tx_ul, prb_interval alloc_, int mcs_)
+{
+  srsran_assert(is_configured(), "UL SPS activation for rnti=0x%x without SPS configuration", rnti);
+  active           = true;
+  start_tti        = tti_tx_ul;
+  alloc            = alloc_;
+  mcs              = mcs_;
+  nof_empty_pdus   = 0;
+  nof_crc_failures = 0;
+
+  fmt::memory_buffer str_buffer;
+  fmt::format_to(str_buffer,
+                 "SCHED: UL SPS activated rnti=0x{:x}, prb={}, mcs={}, interval={}, tti_tx_ul={}",
+                 rnti,
+                 alloc,
+                 mcs,
+                 cfg.interval_ms,
+                 tti_tx_ul);
+  logger.info("%s", srsran::to_c_str(str_buffer));
+}
+
+void sched_ul_sps::release_sent()
+{
+  logger.info("SCHED: UL SPS release sent to rnti=0x%x, sps-crnti=0x%x", rnti, release_crnti);
+  release_crnti = SRSRAN_INVALID_RNTI;
+  deactivate("release DCI");
+}
+
+void sched_ul_sps::set_ul_crc(tti_point tti_rx, bool crc_res)
+{
+  if (not is_occasion(tti_rx)) {
+    return;
+  }
+  nof_crc_failures = crc_res ? 0 : nof_crc_failures + 1;
+  if (nof_crc_failures >= max_crc_failures and not is_release_pending()) {
+    // The UE keeps transmitting in the SPS occasions until it receives the release DCI
+    logger.info("SCHED: UL SPS of rnti=0x%x to be released after %d consecutive CRC failures", rnti, nof_crc_failures);
+    release_crnti = cfg.sps_crnti;
+  }
+}
+
+void sched_ul_sps::set_ul_pdu(tti_point tti_rx, uint32_t nof_sdus)
+{
+  if (not is_occasion(tti_rx)) {
+    return;
+  }
+  nof_empty_pdus = nof_sdus > 0 ? 0 : nof_empty_pdus + 1;
+  if (nof_empty_pdus >= cfg.implicit_release_after) {
+    deactivate("implicit release");
+  }
+}
+
+void sched_ul_sps::deactivate(const char* cause)
+{
+  if (active) {
+    logger.info("SCHED: UL SPS deactivated for rnti=0x%x. Cause: %s", rnti, cause);
+  }
+  active           = false;
+  nof_empty_pdus   = 0;
+  nof_crc_failures = 0;
+}
+
+} // namespace srsenb
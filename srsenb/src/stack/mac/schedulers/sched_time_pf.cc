@@ -33,16 +33,20 @@ sched_time_pf::sched_time_pf(const sched_cell_params_t& cell_params_, const sche
     fairness_coeff = std::stof(sched_args.sched_policy_args);
   }
 
+  ue_history_db.set_capacity(sched_args.max_nof_ues);
+
   std::vector<ue_ctxt*> dl_storage;
-  dl_storage.reserve(SRSENB_MAX_UES);
+  dl_storage.reserve(sched_args.max_nof_ues);
   dl_queue = ue_dl_queue_t(ue_dl_prio_compare{}, std::move(dl_storage));
 
   std::vector<ue_ctxt*> ul_storage;
-  ul_storage.reserve(SRSENB_MAX_UES);
+  ul_storage.reserve(sched_args.max_nof_ues);
   ul_queue = ue_ul_queue_t(ue_ul_prio_compare{}, std::move(ul_storage));
+
+  ul_idle_list.reserve(sched_args.max_nof_ues);
 }
 
-void sched_time_pf::new_tti(sched_ue_list& ue_db, sf_sched* tti_sched)
+void sched_time_pf::new_tti(const sched_ue_active_list& ue_list, sf_sched* tti_sched)
 {
   while (not dl_queue.empty()) {
     dl_queue.pop();
@@ -50,30 +54,35 @@ void sched_time_pf::new_tti(sched_ue_list& ue_db, sf_sched* tti_sched)
   while (not ul_queue.empty()) {
     ul_queue.pop();
   }
+  ul_idle_list.clear();
   current_tti_rx = tti_point{tti_sched->get_tti_rx()};
-  // remove deleted users from history
-  for (auto it = ue_history_db.begin(); it != ue_history_db.end();) {
-    if (not ue_db.contains(it->first)) {
-      it = ue_history_db.erase(it);
-    } else {
-      ++it;
-    }
-  }
+  tti_count++;
   // add new users to history db, and update priority queues
-  for (auto& u : ue_db) {
-    auto it = ue_history_db.find(u.first);
+  for (sched_ue* u : ue_list) {
+    auto it = ue_history_db.find(u->get_rnti());
     if (it == ue_history_db.end()) {
-      it = ue_history_db.insert(u.first, ue_ctxt{u.first, fairness_coeff}).value();
+      it                        = ue_history_db.insert(u->get_rnti(), ue_ctxt{u->get_rnti(), fairness_coeff}).value();
+      it->second.last_tti_count = tti_count - 1;
     }
-    it->second.new_tti(*cc_cfg, *u.second, tti_sched);
-    if (it->second.dl_newtx_h != nullptr or it->second.dl_retx_h != nullptr) {
+    // Idle UEs are not processed, so their average rates still have to account for the TTIs they skipped
+    it->second.skip_ttis(*cc_cfg, *u, tti_count - it->second.last_tti_count - 1, 0.01);
+    it->second.last_tti_count = tti_count;
+    it->second.new_tti(*cc_cfg, *u, tti_sched);
+    if (it->second.dl_idle) {
+      // The allocation would fail, so idle UEs only update their average rate
+      it->second.save_dl_alloc(0, 0.01);
+    } else if (it->second.dl_newtx_h != nullptr or it->second.dl_retx_h != nullptr) {
       dl_queue.push(&it->second);
     }
     if (it->second.ul_h != nullptr) {
       // Allocate only if UL carrier is enabled
-      for (auto& i : u.second->get_ue_cfg().supported_cc_list) {
+      for (auto& i : u->get_ue_cfg().supported_cc_list) {
         if (i.enb_cc_idx == cc_cfg->enb_cc_idx and not i.ul_disabled) {
-          ul_queue.push(&it->second);
+          if (it->second.ul_idle) {
+            ul_idle_list.push_back(&it->second);
+          } else {
+            ul_queue.push(&it->second);
+          }
           break;
         }
       }
@@ -81,20 +90,25 @@ void sched_time_pf::new_tti(sched_ue_list& ue_db, sf_sched* tti_sched)
   }
 }
 
+void sched_time_pf::rem_ue(uint16_t rnti)
+{
+  ue_history_db.erase(rnti);
+}
+
 /*****************************************************************
  *                         Dowlink
  *****************************************************************/
 
-void sched_time_pf::sched_dl_users(sched_ue_list& ue_db, sf_sched* tti_sched)
+void sched_time_pf::sched_dl_users(const sched_ue_active_list& ue_list, sf_sched* tti_sched)
 {
   srsran::tti_point tti_rx{tti_sched->get_tti_rx()};
   if (current_tti_rx != tti_rx) {
-    new_tti(ue_db, tti_sched);
+    new_tti(ue_list, tti_sched);
   }
 
   while (not dl_queue.empty()) {
     ue_ctxt& ue = *dl_queue.top();
-    ue.save_dl_alloc(try_dl_alloc(ue, *ue_db[ue.rnti], tti_sched), 0.01);
+    ue.save_dl_alloc(try_dl_alloc(ue, *ue.user, tti_sched), 0.01);
     dl_queue.pop();
   }
 }
@@ -124,18 +138,24 @@ uint32_t sched_time_pf::try_dl_alloc(ue_ctxt& ue_ctxt, sched_ue& ue, sf_sched* t
  *                         Uplink
  *****************************************************************/
 
-void sched_time_pf::sched_ul_users(sched_ue_list& ue_db, sf_sched* tti_sched)
+void sched_time_pf::sched_ul_users(const sched_ue_active_list& ue_list, sf_sched* tti_sched)
 {
   srsran::tti_point tti_rx{tti_sched->get_tti_rx()};
   if (current_tti_rx != tti_rx) {
-    new_tti(ue_db, tti_sched);
+    new_tti(ue_list, tti_sched);
   }
 
   while (not ul_queue.empty()) {
     ue_ctxt& ue = *ul_queue.top();
-    ue.save_ul_alloc(try_ul_alloc(ue, *ue_db[ue.rnti], tti_sched), 0.01);
+    ue.save_ul_alloc(try_ul_alloc(ue, *ue.user, tti_sched), 0.01);
     ul_queue.pop();
   }
+
+  // Idle UEs may only have got an UL grant for UCI
+  for (ue_ctxt* ue : ul_idle_list) {
+    ue->save_ul_alloc(tti_sched->is_ul_alloc(ue->rnti) ? ue->ul_h->get_pending_data() : 0, 0.01);
+  }
+  ul_idle_list.clear();
 }
 
 uint32_t sched_time_pf::try_ul_alloc(ue_ctxt& ue_ctxt, sched_ue& ue, sf_sched* tti_sched)
@@ -180,9 +200,12 @@ uint32_t sched_time_pf::try_ul_alloc(ue_ctxt& ue_ctxt, sched_ue& ue, sf_sched* t
 
 void sched_time_pf::ue_ctxt::new_tti(const sched_cell_params_t& cell, sched_ue& ue, sf_sched* tti_sched)
 {
+  user       = &ue;
   dl_retx_h  = nullptr;
   dl_newtx_h = nullptr;
   ul_h       = nullptr;
+  dl_idle    = false;
+  ul_idle    = false;
   dl_prio    = 0;
   ue_cc_idx  = ue.enb_to_ue_cc_idx(cell.enb_cc_idx);
   if (ue_cc_idx < 0) {
@@ -193,7 +216,9 @@ void sched_time_pf::ue_ctxt::new_tti(const sched_cell_params_t& cell, sched_ue&
   // Calculate DL priority
   dl_retx_h  = get_dl_retx_harq(ue, tti_sched);
   dl_newtx_h = get_dl_newtx_harq(ue, tti_sched);
-  if (dl_retx_h != nullptr or dl_newtx_h != nullptr) {
+  dl_idle    = dl_retx_h == nullptr and dl_newtx_h != nullptr and
+            ue.get_requested_dl_bytes(cell.enb_cc_idx).stop() == 0;
+  if (not dl_idle and (dl_retx_h != nullptr or dl_newtx_h != nullptr)) {
     // calculate DL PF priority
     float r = ue.get_expected_dl_bitrate(cell.enb_cc_idx) / 8;
     float R = dl_avg_rate();
@@ -203,9 +228,10 @@ void sched_time_pf::ue_ctxt::new_tti(const sched_cell_params_t& cell, sched_ue&
   // Calculate UL priority
   ul_h = get_ul_retx_harq(ue, tti_sched);
   if (ul_h == nullptr) {
-    ul_h = get_ul_newtx_harq(ue, tti_sched);
+    ul_h    = get_ul_newtx_harq(ue, tti_sched);
+    ul_idle = ul_h != nullptr and ue.get_pending_ul_new_data(tti_sched->get_tti_tx_ul(), cell.enb_cc_idx) == 0;
   }
-  if (ul_h != nullptr) {
+  if (ul_h != nullptr and not ul_idle) {
     float r = ue.get_expected_ul_bitrate(cell.enb_cc_idx) / 8;
     float R = ul_avg_rate();
     ul_prio = (R != 0) ? r / pow(R, fairness_coeff) : (r == 0 ? 0 : std::numeric_limits<float>::max());
@@ -223,6 +249,37 @@ void sched_time_pf::ue_ctxt::save_dl_alloc(uint32_t alloc_bytes, float exp_avg_a
   dl_nof_samples++;
 }
 
+void sched_time_pf::ue_ctxt::skip_ttis(const sched_cell_params_t& cell,
+                                        const sched_ue&            ue_,
+                                        uint32_t                   nof_ttis,
+                                        float                      exp_avg_alpha)
+{
+  if (nof_ttis == 0 or ue_.enb_to_ue_cc_idx(cell.enb_cc_idx) < 0) {
+    return;
+  }
+  // An idle UE would have saved an empty allocation in every TTI it skipped
+  skip_allocs(dl_avg_rate_, dl_nof_samples, nof_ttis, exp_avg_alpha);
+  for (auto& i : ue_.get_ue_cfg().supported_cc_list) {
+    if (i.enb_cc_idx == cell.enb_cc_idx and not i.ul_disabled) {
+      skip_allocs(ul_avg_rate_, ul_nof_samples, nof_ttis, exp_avg_alpha);
+      break;
+    }
+  }
+}
+
+/// Equivalent to saving nof_allocs empty allocations, computed in closed form
+void sched_time_pf::ue_ctxt::skip_allocs(float& avg_rate, uint32_t& nof_samples, uint32_t nof_allocs, float alpha)
+{
+  // fast start
+  uint32_t nof_fast_start = 0;
+  if (nof_samples < 1 / alpha) {
+    nof_fast_start = std::min(nof_allocs, (uint32_t)std::ceil(1 / alpha - nof_samples));
+    avg_rate       = avg_rate * nof_samples / (nof_samples + nof_fast_start);
+  }
+  avg_rate *= std::pow(1 - alpha, (float)(nof_allocs - nof_fast_start));
+  nof_samples += nof_allocs;
+}
+
 void sched_time_pf::ue_ctxt::save_ul_alloc(uint32_t alloc_bytes, float exp_avg_alpha)
 {
   if (ul_nof_samples < 1 / exp_avg_alpha) {
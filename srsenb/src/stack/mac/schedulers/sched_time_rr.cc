@@ -32,27 +32,27 @@ sched_time_rr::sched_time_rr(const sched_cell_params_t& cell_params_, const sche
  *                         Dowlink
  *****************************************************************/
 
-void sched_time_rr::sched_dl_users(sched_ue_list& ue_db, sf_sched* tti_sched)
+void sched_time_rr::sched_dl_users(const sched_ue_active_list& ue_list, sf_sched* tti_sched)
 {
-  if (ue_db.empty()) {
+  if (ue_list.empty()) {
     return;
   }
 
   // give priority in a time-domain RR basis.
-  uint32_t priority_idx = tti_sched->get_tti_tx_dl().to_uint() % (uint32_t)ue_db.size();
-  sched_dl_retxs(ue_db, tti_sched, priority_idx);
-  sched_dl_newtxs(ue_db, tti_sched, priority_idx);
+  uint32_t priority_idx = tti_sched->get_tti_tx_dl().to_uint() % (uint32_t)ue_list.size();
+  sched_dl_retxs(ue_list, tti_sched, priority_idx);
+  sched_dl_newtxs(ue_list, tti_sched, priority_idx);
 }
 
-void sched_time_rr::sched_dl_retxs(sched_ue_list& ue_db, sf_sched* tti_sched, size_t prio_idx)
+void sched_time_rr::sched_dl_retxs(const sched_ue_active_list& ue_list, sf_sched* tti_sched, size_t prio_idx)
 {
-  auto iter = ue_db.begin();
+  auto iter = ue_list.begin();
   std::advance(iter, prio_idx);
-  for (uint32_t ue_count = 0; ue_count < ue_db.size(); ++iter, ++ue_count) {
-    if (iter == ue_db.end()) {
-      iter = ue_db.begin(); // wrap around
+  for (uint32_t ue_count = 0; ue_count < ue_list.size(); ++iter, ++ue_count) {
+    if (iter == ue_list.end()) {
+      iter = ue_list.begin(); // wrap around
     }
-    sched_ue&           user = *iter->second;
+    sched_ue&           user = **iter;
     const dl_harq_proc* h    = get_dl_retx_harq(user, tti_sched);
     // Check if there is a pending retx
     if (h == nullptr) {
@@ -62,15 +62,15 @@ void sched_time_rr::sched_dl_retxs(sched_ue_list& ue_db, sf_sched* tti_sched, si
   }
 }
 
-void sched_time_rr::sched_dl_newtxs(sched_ue_list& ue_db, sf_sched* tti_sched, size_t prio_idx)
+void sched_time_rr::sched_dl_newtxs(const sched_ue_active_list& ue_list, sf_sched* tti_sched, size_t prio_idx)
 {
-  auto iter = ue_db.begin();
+  auto iter = ue_list.begin();
   std::advance(iter, prio_idx);
-  for (uint32_t ue_count = 0; ue_count < ue_db.size(); ++iter, ++ue_count) {
-    if (iter == ue_db.end()) {
-      iter = ue_db.begin(); // wrap around
+  for (uint32_t ue_count = 0; ue_count < ue_list.size(); ++iter, ++ue_count) {
+    if (iter == ue_list.end()) {
+      iter = ue_list.begin(); // wrap around
     }
-    sched_ue& user = *iter->second;
+    sched_ue& user = **iter;
     if (user.enb_to_ue_cc_idx(cc_cfg->enb_cc_idx) < 0) {
       continue;
     }
@@ -89,26 +89,26 @@ void sched_time_rr::sched_dl_newtxs(sched_ue_list& ue_db, sf_sched* tti_sched, s
  *                         Uplink
  *****************************************************************/
 
-void sched_time_rr::sched_ul_users(sched_ue_list& ue_db, sf_sched* tti_sched)
+void sched_time_rr::sched_ul_users(const sched_ue_active_list& ue_list, sf_sched* tti_sched)
 {
-  if (ue_db.empty()) {
+  if (ue_list.empty()) {
     return;
   }
   // give priority in a time-domain RR basis.
-  uint32_t priority_idx = tti_sched->get_tti_tx_ul().to_uint() % (uint32_t)ue_db.size();
-  sched_ul_retxs(ue_db, tti_sched, priority_idx);
-  sched_ul_newtxs(ue_db, tti_sched, priority_idx);
+  uint32_t priority_idx = tti_sched->get_tti_tx_ul().to_uint() % (uint32_t)ue_list.size();
+  sched_ul_retxs(ue_list, tti_sched, priority_idx);
+  sched_ul_newtxs(ue_list, tti_sched, priority_idx);
 }
 
-void sched_time_rr::sched_ul_retxs(sched_ue_list& ue_db, sf_sched* tti_sched, size_t prio_idx)
+void sched_time_rr::sched_ul_retxs(const sched_ue_active_list& ue_list, sf_sched* tti_sched, size_t prio_idx)
 {
-  auto iter = ue_db.begin();
+  auto iter = ue_list.begin();
   std::advance(iter, prio_idx);
-  for (uint32_t ue_count = 0; ue_count < ue_db.size(); ++iter, ++ue_count) {
-    if (iter == ue_db.end()) {
-      iter = ue_db.begin(); // wrap around
+  for (uint32_t ue_count = 0; ue_count < ue_list.size(); ++iter, ++ue_count) {
+    if (iter == ue_list.end()) {
+      iter = ue_list.begin(); // wrap around
     }
-    sched_ue&           user = *iter->second;
+    sched_ue&           user = **iter;
     const ul_harq_proc* h    = get_ul_retx_harq(user, tti_sched);
     // Check if there is a pending retx
     if (h == nullptr) {
@@ -121,15 +121,15 @@ void sched_time_rr::sched_ul_retxs(sched_ue_list& ue_db, sf_sched* tti_sched, si
   }
 }
 
-void sched_time_rr::sched_ul_newtxs(sched_ue_list& ue_db, sf_sched* tti_sched, size_t prio_idx)
+void sched_time_rr::sched_ul_newtxs(const sched_ue_active_list& ue_list, sf_sched* tti_sched, size_t prio_idx)
 {
-  auto iter = ue_db.begin();
+  auto iter = ue_list.begin();
   std::advance(iter, prio_idx);
-  for (uint32_t ue_count = 0; ue_count < ue_db.size(); ++iter, ++ue_count) {
-    if (iter == ue_db.end()) {
-      iter = ue_db.begin(); // wrap around
+  for (uint32_t ue_count = 0; ue_count < ue_list.size(); ++iter, ++ue_count) {
+    if (iter == ue_list.end()) {
+      iter = ue_list.begin(); // wrap around
     }
-    sched_ue&           user = *iter->second;
+    sched_ue&           user = **iter;
     // Allocate only if UL carrier is enabled
     bool ul_disabled = false;
     for (auto& i : user.get_ue_cfg().supported_cc_list) {
@@ -300,7 +300,7 @@ uint32_t ue::set_ta(int ta_)
   return nof_cmd;
 }
 
-void ue::process_pdu(srsran::unique_byte_buffer_t pdu, uint32_t ue_cc_idx, uint32_t grant_nof_prbs)
+void ue::process_pdu(srsran::unique_byte_buffer_t pdu, uint32_t tti_rx, uint32_t ue_cc_idx, uint32_t grant_nof_prbs)
 {
   // Unpack ULSCH MAC PDU
   mac_msg_ul.init_rx(pdu->size(), true);
@@ -322,6 +322,7 @@ void ue::process_pdu(srsran::unique_byte_buffer_t pdu, uint32_t ue_cc_idx, uint3
 
   uint32_t lcid_most_data = 0;
   int      most_data      = -99;
+  uint32_t nof_sdus       = 0;
 
   while (mac_msg_ul.next()) {
     assert(mac_msg_ul.get());
@@ -343,6 +344,7 @@ void ue::process_pdu(srsran::unique_byte_buffer_t pdu, uint32_t ue_cc_idx, uint3
       }
 
       if (route_pdu) {
+        nof_sdus++;
         rlc->write_pdu(rnti,
                        mac_msg_ul.get()->get_sdu_lcid(),
                        mac_msg_ul.get()->get_sdu_ptr(),
@@ -390,6 +392,9 @@ void ue::process_pdu(srsran::unique_byte_buffer_t pdu, uint32_t ue_cc_idx, uint3
     }
   }
 
+  // Empty PDUs in the UL SPS occasions lead to the implicit release of the SPS grant
+  sched->ul_pdu_info(tti_rx, rnti, nof_sdus);
+
   // If BSR is not received means that new data has arrived and there is no space for BSR transmission
   if (!bsr_received && lcid_most_data > 2) {
     // Add BSR to the LCID for which most data was received
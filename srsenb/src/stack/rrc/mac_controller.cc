@@ -65,7 +65,13 @@ void ue_cfg_apply_srb_updates(ue_cfg_t& ue_cfg, const srb_to_add_mod_list_l& srb
  */
 void ue_cfg_apply_reconf_complete_updates(ue_cfg_t&                      ue_cfg,
                                           const rrc_conn_recfg_r8_ies_s& conn_recfg,
-                                          const ue_cell_ded_list&        ue_cell_list);
+                                          const ue_cell_ded_list&        ue_cell_list,
+                                          const rrc_cfg_t&               rrc_cfg);
+
+/**
+ * Adds to sched_interface::ue_cfg_t the UL SPS changes present in the asn1 RRCReconfiguration message
+ */
+void ue_cfg_apply_sps_cfg(ue_cfg_t& ue_cfg, const asn1::rrc::sps_cfg_s& sps_cfg, const rrc_cfg_t& rrc_cfg);
 
 /**
  * Adds to sched_interface::ue_cfg_t the changes present in the asn1 RRCReconfiguration message related to
@@ -173,6 +179,7 @@ int mac_controller::apply_basic_conn_cfg(const asn1::rrc::rr_cfg_ded_s& rr_cfg)
   // Set default configuration
   current_sched_ue_cfg.supported_cc_list[0].dl_cfg.tm = SRSRAN_TM1;
   current_sched_ue_cfg.use_tbs_index_alt              = false;
+  current_sched_ue_cfg.ul_sps_cfg                     = {};
 
   // Apply common PhyConfig updates (e.g. SR/CQI resources, antenna cfg)
   if (rr_cfg.phys_cfg_ded_present) {
@@ -218,7 +225,7 @@ void mac_controller::handle_con_reconf(const asn1::rrc::rrc_conn_recfg_r8_ies_s&
   // Store MAC updates that are applied once RRCReconfigurationComplete is received
   next_sched_ue_cfg = current_sched_ue_cfg;
   ue_cfg_apply_capabilities(next_sched_ue_cfg, *rrc_cfg, uecaps);
-  ue_cfg_apply_reconf_complete_updates(next_sched_ue_cfg, conn_recfg, ue_cell_list);
+  ue_cfg_apply_reconf_complete_updates(next_sched_ue_cfg, conn_recfg, ue_cell_list, *rrc_cfg);
 
   // Temporarily freeze new allocations for DRBs (SRBs are needed to send RRC Reconf Message)
   set_drb_activation(false);
@@ -269,7 +276,7 @@ void mac_controller::handle_target_enb_ho_cmd(const asn1::rrc::rrc_conn_recfg_r8
 
   next_sched_ue_cfg = current_sched_ue_cfg;
   ue_cfg_apply_capabilities(next_sched_ue_cfg, *rrc_cfg, uecaps);
-  ue_cfg_apply_reconf_complete_updates(next_sched_ue_cfg, conn_recfg, ue_cell_list);
+  ue_cfg_apply_reconf_complete_updates(next_sched_ue_cfg, conn_recfg, ue_cell_list, *rrc_cfg);
 
   // Temporarily freeze SRB2 and DRBs. SRB1 is needed to send
   // RRC Reconfiguration and receive RRC Reconfiguration Complete
@@ -292,7 +299,7 @@ void mac_controller::handle_intraenb_ho_cmd(const asn1::rrc::rrc_conn_recfg_r8_i
   }
   ue_cfg_apply_conn_reconf(next_sched_ue_cfg, conn_recfg, *rrc_cfg);
   ue_cfg_apply_capabilities(next_sched_ue_cfg, *rrc_cfg, uecaps);
-  ue_cfg_apply_reconf_complete_updates(next_sched_ue_cfg, conn_recfg, ue_cell_list);
+  ue_cfg_apply_reconf_complete_updates(next_sched_ue_cfg, conn_recfg, ue_cell_list, *rrc_cfg);
 
   // Freeze SCells
   // NOTE: this avoids that the UE receives an HOCmd retx from target cell and do an incorrect RLC-level concatenation
@@ -430,7 +437,8 @@ void ue_cfg_apply_srb_updates(ue_cfg_t& ue_cfg, const srb_to_add_mod_list_l& srb
 
 void ue_cfg_apply_reconf_complete_updates(ue_cfg_t&                      ue_cfg,
                                           const rrc_conn_recfg_r8_ies_s& conn_recfg,
-                                          const ue_cell_ded_list&        ue_cell_list)
+                                          const ue_cell_ded_list&        ue_cell_list,
+                                          const rrc_cfg_t&               rrc_cfg)
 {
   // Configure RadioResourceConfigDedicated
   if (conn_recfg.rr_cfg_ded_present) {
@@ -455,6 +463,11 @@ void ue_cfg_apply_reconf_complete_updates(ue_cfg_t&                      ue_cfg,
     if (conn_recfg.rr_cfg_ded.srb_to_add_mod_list_present) {
       ue_cfg_apply_srb_updates(ue_cfg, conn_recfg.rr_cfg_ded.srb_to_add_mod_list);
     }
+
+    // Apply UL SPS updates
+    if (conn_recfg.rr_cfg_ded.sps_cfg_present) {
+      ue_cfg_apply_sps_cfg(ue_cfg, conn_recfg.rr_cfg_ded.sps_cfg, rrc_cfg);
+    }
   }
 
   // Apply Scell configurations
@@ -498,6 +511,26 @@ void ue_cfg_apply_reconf_complete_updates(ue_cfg_t&                      ue_cfg,
   }
 }
 
+void ue_cfg_apply_sps_cfg(ue_cfg_t& ue_cfg, const asn1::rrc::sps_cfg_s& sps_cfg, const rrc_cfg_t& rrc_cfg)
+{
+  if (not sps_cfg.sps_cfg_ul_present) {
+    return;
+  }
+  ue_cfg.ul_sps_cfg = {};
+  if (sps_cfg.sps_cfg_ul.type().value == setup_opts::setup and sps_cfg.semi_persist_sched_c_rnti_present) {
+    const auto& sps_ul                       = sps_cfg.sps_cfg_ul.setup();
+    ue_cfg.ul_sps_cfg.sps_crnti              = sps_cfg.semi_persist_sched_c_rnti.to_number();
+    ue_cfg.ul_sps_cfg.interval_ms            = sps_ul.semi_persist_sched_interv_ul.to_number();
+    ue_cfg.ul_sps_cfg.implicit_release_after = sps_ul.implicit_release_after.to_number();
+
+    // The SPS grant serves the logical channel group of the SPS QCI
+    auto qci_it = rrc_cfg.qci_cfg.find(rrc_cfg.sps_cfg.qci);
+    if (qci_it != rrc_cfg.qci_cfg.end()) {
+      ue_cfg.ul_sps_cfg.lcg = qci_it->second.lc_cfg.lc_ch_group;
+    }
+  }
+}
+
 void ue_cfg_apply_meas_cfg(ue_cfg_t& ue_cfg, const meas_cfg_s& meas_cfg, const rrc_cfg_t& rrc_cfg)
 {
   if (meas_cfg.meas_gap_cfg_present) {
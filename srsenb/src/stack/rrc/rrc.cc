@@ -725,6 +725,23 @@ void rrc::rem_user(uint16_t rnti)
   }
 }
 
+/// Picks a SPS C-RNTI which is not used by any other UE, starting from one derived from the C-RNTI
+uint16_t rrc::allocate_sps_crnti(uint16_t rnti)
+{
+  for (uint32_t i = 0; i < SRSENB_SPS_NOF_RNTIS; ++i) {
+    uint16_t sps_crnti = SRSENB_SPS_FIRST_RNTI + (rnti + i) % SRSENB_SPS_NOF_RNTIS;
+    bool     is_used   = false;
+    for (auto& user : users) {
+      is_used |= user.second->get_sps_crnti() == sps_crnti;
+    }
+    if (not is_used) {
+      return sps_crnti;
+    }
+  }
+  logger.warning("No SPS C-RNTI available for rnti=0x%x", rnti);
+  return SRSRAN_INVALID_RNTI;
+}
+
 void rrc::config_mac()
 {
   using sched_cell_t = sched_interface::cell_cfg_t;
@@ -95,6 +95,11 @@ int rrc::ue::init()
     rlc_rlf_timer.set(deadline_ms, timer_expire_func);
   }
 
+  // Reserve a SPS C-RNTI, configured once a DRB with the SPS QCI is established
+  if (parent->cfg.sps_cfg.enabled) {
+    current_ue_cfg.sps_crnti = parent->allocate_sps_crnti(rnti);
+  }
+
   mobility_handler = make_rnti_obj<rrc_mobility>(rnti, this);
   if (parent->rrc_nr != nullptr) {
     endc_handler = make_rnti_obj<rrc_endc>(rnti, this, parent->cfg.endc_cfg);
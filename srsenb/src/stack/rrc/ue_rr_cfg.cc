@@ -294,6 +294,65 @@ int fill_phy_cfg_ded_reconf(phys_cfg_ded_s&                      phy_cfg,
   return SRSRAN_SUCCESS;
 }
 
+/***********************************
+ *           SPS-Config
+ **********************************/
+
+/// UL SPS is configured while a DRB with the SPS QCI is established
+bool has_sps_drb(const rrc_cfg_t& enb_cfg, const bearer_cfg_handler& bearers)
+{
+  for (const auto& erab_pair : bearers.get_erabs()) {
+    const bearer_cfg_handler::erab_t& erab = erab_pair.second;
+    if (erab.qos_params.qci != enb_cfg.sps_cfg.qci) {
+      continue;
+    }
+    for (const drb_to_add_mod_s& drb : bearers.get_established_drbs()) {
+      if (drb.lc_ch_id_present and drb.lc_ch_id == erab.lcid) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void fill_sps_cfg_reconf(asn1::rrc::rr_cfg_ded_s&  rr_cfg,
+                         const rr_cfg_ded_s&       current_rr_cfg,
+                         const rrc_cfg_t&          enb_cfg,
+                         const bearer_cfg_handler& bearers,
+                         uint16_t                  sps_crnti)
+{
+  bool sps_configured = current_rr_cfg.sps_cfg_present and current_rr_cfg.sps_cfg.sps_cfg_ul_present and
+                        current_rr_cfg.sps_cfg.sps_cfg_ul.type().value == setup_opts::setup;
+
+  if (not enb_cfg.sps_cfg.enabled or sps_crnti == SRSRAN_INVALID_RNTI or not has_sps_drb(enb_cfg, bearers)) {
+    if (sps_configured) {
+      // Release the UL SPS configuration
+      rr_cfg.sps_cfg_present            = true;
+      rr_cfg.sps_cfg                    = {};
+      rr_cfg.sps_cfg.sps_cfg_ul_present = true;
+      rr_cfg.sps_cfg.sps_cfg_ul.set_release();
+    }
+    return;
+  }
+
+  sps_cfg_s sps_cfg;
+  sps_cfg.semi_persist_sched_c_rnti_present = true;
+  sps_cfg.semi_persist_sched_c_rnti.from_number(sps_crnti);
+  sps_cfg.sps_cfg_ul_present = true;
+
+  sps_cfg_ul_c::setup_s_& sps_ul      = sps_cfg.sps_cfg_ul.set_setup();
+  sps_ul.semi_persist_sched_interv_ul = enb_cfg.sps_cfg.ul_interval;
+  sps_ul.implicit_release_after       = enb_cfg.sps_cfg.implicit_release_after;
+
+  // Only send SPS-Config if it changed
+  const sps_cfg_s& current_sps_cfg = current_rr_cfg.sps_cfg;
+  if (not sps_configured or not(current_sps_cfg.semi_persist_sched_c_rnti == sps_cfg.semi_persist_sched_c_rnti) or
+      current_sps_cfg.sps_cfg_ul != sps_cfg.sps_cfg_ul) {
+    rr_cfg.sps_cfg_present = true;
+    rr_cfg.sps_cfg         = sps_cfg;
+  }
+}
+
 /***********************************
  *   radioResourceConfigDedicated
  **********************************/
@@ -343,7 +402,8 @@ int fill_rr_cfg_ded_reconf(asn1::rrc::rr_cfg_ded_s&             rr_cfg,
                            const ue_cell_ded_list&              ue_cell_list,
                            const bearer_cfg_handler&            bearers,
                            const srsran::rrc_ue_capabilities_t& ue_caps,
-                           bool                                 phy_cfg_updated)
+                           bool                                 phy_cfg_updated,
+                           uint16_t                             sps_crnti)
 {
   // (Re)establish SRBs
   fill_srbs_reconf(rr_cfg.srb_to_add_mod_list, current_rr_cfg.srb_to_add_mod_list, enb_cfg);
@@ -357,6 +417,9 @@ int fill_rr_cfg_ded_reconf(asn1::rrc::rr_cfg_ded_s&             rr_cfg,
   rr_cfg.drb_to_add_mod_list_present = rr_cfg.drb_to_add_mod_list.size() > 0;
   rr_cfg.drb_to_release_list_present = rr_cfg.drb_to_release_list.size() > 0;
 
+  // Setup/Release UL SPS, depending on the established DRBs
+  fill_sps_cfg_reconf(rr_cfg, current_rr_cfg, enb_cfg, bearers, sps_crnti);
+
   // PhysCfgDed update needed
   if (phy_cfg_updated) {
     rr_cfg.phys_cfg_ded_present = true;
@@ -610,8 +673,14 @@ int apply_reconf_updates(asn1::rrc::rrc_conn_recfg_r8_ies_s&  recfg_r8,
 {
   // Compute pending updates and fill reconf msg
   recfg_r8.rr_cfg_ded_present = true;
-  if (fill_rr_cfg_ded_reconf(
-          recfg_r8.rr_cfg_ded, current_ue_cfg.rr_cfg, enb_cfg, ue_cell_list, bearers, ue_caps, phy_cfg_updated)) {
+  if (fill_rr_cfg_ded_reconf(recfg_r8.rr_cfg_ded,
+                             current_ue_cfg.rr_cfg,
+                             enb_cfg,
+                             ue_cell_list,
+                             bearers,
+                             ue_caps,
+                             phy_cfg_updated,
+                             current_ue_cfg.sps_crnti)) {
     return SRSRAN_ERROR;
   }
   fill_scells_reconf(recfg_r8, current_ue_cfg.scells, enb_cfg, ue_cell_list, ue_caps);
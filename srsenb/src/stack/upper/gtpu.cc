@@ -53,6 +53,7 @@ void gtpu_tunnel_manager::init(const gtpu_args_t& args, pdcp_interface_gtpu* pdc
 {
   gtpu_args = &args;
   pdcp      = pdcp_;
+  tunnels.set_capacity(args.max_nof_ues * MAX_TUNNELS_PER_UE);
 }
 
 const gtpu_tunnel_manager::tunnel* gtpu_tunnel_manager::find_tunnel(uint32_t teid)
@@ -0,0 +1,489 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/upper/pdcp_rlc_shards.h"
+#include "srsran/interfaces/enb_mac_interfaces.h"
+#include <future>
+
+namespace srsenb {
+
+pdcp_rlc_shards::shard::shard(uint32_t idx, srslog::basic_logger& pdcp_logger, srslog::basic_logger& rlc_logger) :
+  thread("UPPER" + std::to_string(idx)), task_sched(512, 128), pdcp(&task_sched, pdcp_logger), rlc(rlc_logger)
+{
+  queue = task_sched.make_task_queue();
+}
+
+void pdcp_rlc_shards::shard::start_shard(int prio)
+{
+  running = true;
+  start(prio);
+}
+
+void pdcp_rlc_shards::shard::stop()
+{
+  if (running) {
+    queue.push([this]() {
+      pdcp.stop();
+      rlc.stop();
+      task_sched.stop();
+      running = false;
+    });
+    wait_thread_finish();
+  }
+}
+
+void pdcp_rlc_shards::shard::run_thread()
+{
+  while (running.load(std::memory_order_relaxed)) {
+    task_sched.run_next_task();
+  }
+}
+
+pdcp_rlc_shards::pdcp_rlc_shards(srsran::task_sched_handle stack_task_sched_,
+                                 srslog::basic_logger&     logger_,
+                                 srslog::basic_logger&     pdcp_logger_,
+                                 srslog::basic_logger&     rlc_logger_) :
+  stack_task_sched(stack_task_sched_),
+  logger(logger_),
+  pdcp_logger(pdcp_logger_),
+  rlc_logger(rlc_logger_),
+  pdcp_itf(this),
+  rlc_itf(this),
+  rrc_pdcp_itf(this),
+  rrc_rlc_itf(this),
+  gtpu_itf(this)
+{}
+
+pdcp_rlc_shards::~pdcp_rlc_shards()
+{
+  stop();
+}
+
+void pdcp_rlc_shards::init(uint32_t             nof_shards,
+                           rrc_interface_pdcp*  rrc_pdcp_,
+                           rrc_interface_rlc*   rrc_rlc_,
+                           gtpu_interface_pdcp* gtpu_,
+                           mac_interface_rlc*   mac_)
+{
+  rrc_pdcp    = rrc_pdcp_;
+  rrc_rlc     = rrc_rlc_;
+  gtpu        = gtpu_;
+  stack_queue = stack_task_sched.make_task_queue();
+
+  for (uint32_t i = 0; i < nof_shards; ++i) {
+    shards.emplace_back(new shard(i, pdcp_logger, rlc_logger));
+    shard& s = *shards.back();
+    s.rlc.init(&s.pdcp, &rrc_rlc_itf, mac_, s.task_sched.get_timer_handler());
+    s.pdcp.init(&s.rlc, &rrc_pdcp_itf, &gtpu_itf);
+  }
+  logger.info("PDCP and RLC sharded across %d worker threads", nof_shards);
+}
+
+void pdcp_rlc_shards::start(int prio)
+{
+  for (auto& s : shards) {
+    s->start_shard(prio);
+  }
+}
+
+void pdcp_rlc_shards::stop()
+{
+  for (auto& s : shards) {
+    s->stop();
+  }
+  // Deliver the calls to RRC and GTPU that the shards queued before finishing
+  run_stack_tasks();
+}
+
+void pdcp_rlc_shards::tti_clock()
+{
+  // Run the tasks whose wake-up did not fit in the stack queue
+  run_stack_tasks();
+
+  for (auto& s : shards) {
+    shard* sptr = s.get();
+    sptr->queue.push([sptr]() { sptr->task_sched.tic(); });
+  }
+}
+
+void pdcp_rlc_shards::get_metrics(rlc_metrics_t& rlc_metrics, pdcp_metrics_t& pdcp_metrics, uint32_t nof_tti)
+{
+  // The metrics of each shard are ordered by RNTI. Merge them in RNTI order, as the metrics of the other layers
+  std::map<uint16_t, srsran::rlc_metrics_t>  rlc_ues;
+  std::map<uint16_t, srsran::pdcp_metrics_t> pdcp_ues;
+  for (auto& s : shards) {
+    shard*         sptr = s.get();
+    rlc_metrics_t  shard_rlc;
+    pdcp_metrics_t shard_pdcp;
+    run_sync(sptr, [sptr, &shard_rlc, &shard_pdcp, nof_tti]() {
+      sptr->rlc.get_metrics(shard_rlc, nof_tti);
+      sptr->pdcp.get_metrics(shard_pdcp, nof_tti);
+    });
+
+    auto rlc_rnti_it = sptr->rlc_rntis.begin();
+    for (uint32_t i = 0; i < shard_rlc.ues.size() and rlc_rnti_it != sptr->rlc_rntis.end(); ++i, ++rlc_rnti_it) {
+      rlc_ues[*rlc_rnti_it] = shard_rlc.ues[i];
+    }
+    auto pdcp_rnti_it = sptr->pdcp_rntis.begin();
+    for (uint32_t i = 0; i < shard_pdcp.ues.size() and pdcp_rnti_it != sptr->pdcp_rntis.end(); ++i, ++pdcp_rnti_it) {
+      pdcp_ues[*pdcp_rnti_it] = shard_pdcp.ues[i];
+    }
+  }
+
+  rlc_metrics.ues.clear();
+  for (auto& ue : rlc_ues) {
+    rlc_metrics.ues.push_back(ue.second);
+  }
+  pdcp_metrics.ues.clear();
+  for (auto& ue : pdcp_ues) {
+    pdcp_metrics.ues.push_back(ue.second);
+  }
+}
+
+void pdcp_rlc_shards::run_sync(shard* s, srsran::move_task_t task)
+{
+  if (not s->is_running()) {
+    // The shard thread has finished, so its PDCP/RLC are not accessed concurrently
+    task();
+    return;
+  }
+  std::promise<void> done;
+  std::future<void>  done_fut = done.get_future();
+  s->queue.push([&task, &done]() {
+    task();
+    done.set_value();
+  });
+  done_fut.wait();
+}
+
+void pdcp_rlc_shards::push_stack_task(srsran::move_task_t task)
+{
+  {
+    std::lock_guard<std::mutex> lock(stack_tasks_mutex);
+    stack_tasks.push_back(std::move(task));
+  }
+
+  // A blocking push could deadlock with a stack thread waiting in run_sync() for this shard, so only wake up the
+  // stack thread if there is room. Otherwise, the next tti_clock() runs the task
+  if (not stack_wakeup_pending.exchange(true)) {
+    if (not stack_queue.try_push([this]() { run_stack_tasks(); }).has_value()) {
+      stack_wakeup_pending = false;
+    }
+  }
+}
+
+void pdcp_rlc_shards::run_stack_tasks()
+{
+  stack_wakeup_pending = false;
+
+  std::deque<srsran::move_task_t> tasks;
+  {
+    std::lock_guard<std::mutex> lock(stack_tasks_mutex);
+    tasks.swap(stack_tasks);
+  }
+  for (auto& task : tasks) {
+    task();
+  }
+}
+
+/*******************************************************
+ *            PDCP interface to the stack
+ *******************************************************/
+
+void pdcp_rlc_shards::pdcp_adapter::set_enabled(uint16_t rnti, uint32_t lcid, bool enabled)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti, lcid, enabled]() { s->pdcp.set_enabled(rnti, lcid, enabled); });
+}
+
+void pdcp_rlc_shards::pdcp_adapter::reset(uint16_t rnti)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti]() { s->pdcp.reset(rnti); });
+}
+
+void pdcp_rlc_shards::pdcp_adapter::add_user(uint16_t rnti)
+{
+  shard* s = parent->get_shard(rnti);
+  s->pdcp_rntis.insert(rnti);
+  s->queue.push([s, rnti]() { s->pdcp.add_user(rnti); });
+}
+
+void pdcp_rlc_shards::pdcp_adapter::rem_user(uint16_t rnti)
+{
+  shard* s = parent->get_shard(rnti);
+  s->pdcp_rntis.erase(rnti);
+  s->queue.push([s, rnti]() { s->pdcp.rem_user(rnti); });
+}
+
+void pdcp_rlc_shards::pdcp_adapter::write_sdu(uint16_t                     rnti,
+                                              uint32_t                     lcid,
+                                              srsran::unique_byte_buffer_t sdu,
+                                              int                          pdcp_sn)
+{
+  shard* s    = parent->get_shard(rnti);
+  auto   task = [s, rnti, lcid, pdcp_sn](srsran::unique_byte_buffer_t& sdu) {
+    s->pdcp.write_sdu(rnti, lcid, std::move(sdu), pdcp_sn);
+  };
+  s->queue.push(std::bind(task, std::move(sdu)));
+}
+
+void pdcp_rlc_shards::pdcp_adapter::add_bearer(uint16_t rnti, uint32_t lcid, const srsran::pdcp_config_t& cnfg)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti, lcid, cnfg]() { s->pdcp.add_bearer(rnti, lcid, cnfg); });
+}
+
+void pdcp_rlc_shards::pdcp_adapter::del_bearer(uint16_t rnti, uint32_t lcid)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti, lcid]() { s->pdcp.del_bearer(rnti, lcid); });
+}
+
+void pdcp_rlc_shards::pdcp_adapter::config_security(uint16_t                            rnti,
+                                                    uint32_t                            lcid,
+                                                    const srsran::as_security_config_t& sec_cfg)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti, lcid, sec_cfg]() { s->pdcp.config_security(rnti, lcid, sec_cfg); });
+}
+
+void pdcp_rlc_shards::pdcp_adapter::enable_integrity(uint16_t rnti, uint32_t lcid)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti, lcid]() { s->pdcp.enable_integrity(rnti, lcid); });
+}
+
+void pdcp_rlc_shards::pdcp_adapter::enable_encryption(uint16_t rnti, uint32_t lcid)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti, lcid]() { s->pdcp.enable_encryption(rnti, lcid); });
+}
+
+void pdcp_rlc_shards::pdcp_adapter::send_status_report(uint16_t rnti)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti]() { s->pdcp.send_status_report(rnti); });
+}
+
+void pdcp_rlc_shards::pdcp_adapter::send_status_report(uint16_t rnti, uint32_t lcid)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti, lcid]() { s->pdcp.send_status_report(rnti, lcid); });
+}
+
+bool pdcp_rlc_shards::pdcp_adapter::get_bearer_state(uint16_t rnti, uint32_t lcid, srsran::pdcp_lte_state_t* state)
+{
+  shard* s   = parent->get_shard(rnti);
+  bool   ret = false;
+  parent->run_sync(s, [s, rnti, lcid, state, &ret]() { ret = s->pdcp.get_bearer_state(rnti, lcid, state); });
+  return ret;
+}
+
+bool pdcp_rlc_shards::pdcp_adapter::set_bearer_state(uint16_t                        rnti,
+                                                     uint32_t                        lcid,
+                                                     const srsran::pdcp_lte_state_t& state)
+{
+  shard* s   = parent->get_shard(rnti);
+  bool   ret = false;
+  parent->run_sync(s, [s, rnti, lcid, &state, &ret]() { ret = s->pdcp.set_bearer_state(rnti, lcid, state); });
+  return ret;
+}
+
+void pdcp_rlc_shards::pdcp_adapter::reestablish(uint16_t rnti)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti]() { s->pdcp.reestablish(rnti); });
+}
+
+std::map<uint32_t, srsran::unique_byte_buffer_t> pdcp_rlc_shards::pdcp_adapter::get_buffered_pdus(uint16_t rnti,
+                                                                                                  uint32_t lcid)
+{
+  shard*                                           s = parent->get_shard(rnti);
+  std::map<uint32_t, srsran::unique_byte_buffer_t> ret;
+  parent->run_sync(s, [s, rnti, lcid, &ret]() { ret = s->pdcp.get_buffered_pdus(rnti, lcid); });
+  return ret;
+}
+
+/*******************************************************
+ *            RLC interface to the stack
+ *******************************************************/
+
+void pdcp_rlc_shards::rlc_adapter::clear_buffer(uint16_t rnti)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti]() { s->rlc.clear_buffer(rnti); });
+}
+
+void pdcp_rlc_shards::rlc_adapter::add_user(uint16_t rnti)
+{
+  shard* s = parent->get_shard(rnti);
+  s->rlc_rntis.insert(rnti);
+  s->queue.push([s, rnti]() { s->rlc.add_user(rnti); });
+}
+
+void pdcp_rlc_shards::rlc_adapter::rem_user(uint16_t rnti)
+{
+  shard* s = parent->get_shard(rnti);
+  s->rlc_rntis.erase(rnti);
+  s->queue.push([s, rnti]() { s->rlc.rem_user(rnti); });
+}
+
+void pdcp_rlc_shards::rlc_adapter::add_bearer(uint16_t rnti, uint32_t lcid, const srsran::rlc_config_t& cnfg)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti, lcid, cnfg]() { s->rlc.add_bearer(rnti, lcid, cnfg); });
+}
+
+void pdcp_rlc_shards::rlc_adapter::add_bearer_mrb(uint16_t rnti, uint32_t lcid)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti, lcid]() { s->rlc.add_bearer_mrb(rnti, lcid); });
+}
+
+void pdcp_rlc_shards::rlc_adapter::del_bearer(uint16_t rnti, uint32_t lcid)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti, lcid]() { s->rlc.del_bearer(rnti, lcid); });
+}
+
+void pdcp_rlc_shards::rlc_adapter::write_sdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu)
+{
+  shard* s    = parent->get_shard(rnti);
+  auto   task = [s, rnti, lcid](srsran::unique_byte_buffer_t& sdu) { s->rlc.write_sdu(rnti, lcid, std::move(sdu)); };
+  s->queue.push(std::bind(task, std::move(sdu)));
+}
+
+bool pdcp_rlc_shards::rlc_adapter::has_bearer(uint16_t rnti, uint32_t lcid)
+{
+  shard* s   = parent->get_shard(rnti);
+  bool   ret = false;
+  parent->run_sync(s, [s, rnti, lcid, &ret]() { ret = s->rlc.has_bearer(rnti, lcid); });
+  return ret;
+}
+
+bool pdcp_rlc_shards::rlc_adapter::suspend_bearer(uint16_t rnti, uint32_t lcid)
+{
+  shard* s   = parent->get_shard(rnti);
+  bool   ret = false;
+  parent->run_sync(s, [s, rnti, lcid, &ret]() { ret = s->rlc.suspend_bearer(rnti, lcid); });
+  return ret;
+}
+
+bool pdcp_rlc_shards::rlc_adapter::is_suspended(uint16_t rnti, uint32_t lcid)
+{
+  shard* s   = parent->get_shard(rnti);
+  bool   ret = false;
+  parent->run_sync(s, [s, rnti, lcid, &ret]() { ret = s->rlc.is_suspended(rnti, lcid); });
+  return ret;
+}
+
+bool pdcp_rlc_shards::rlc_adapter::resume_bearer(uint16_t rnti, uint32_t lcid)
+{
+  shard* s   = parent->get_shard(rnti);
+  bool   ret = false;
+  parent->run_sync(s, [s, rnti, lcid, &ret]() { ret = s->rlc.resume_bearer(rnti, lcid); });
+  return ret;
+}
+
+void pdcp_rlc_shards::rlc_adapter::reestablish(uint16_t rnti)
+{
+  shard* s = parent->get_shard(rnti);
+  s->queue.push([s, rnti]() { s->rlc.reestablish(rnti); });
+}
+
+int pdcp_rlc_shards::rlc_adapter::read_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes)
+{
+  // Called from the PHY workers. The RLC of the shard handles the concurrent access
+  return parent->get_shard(rnti)->rlc.read_pdu(rnti, lcid, payload, nof_bytes);
+}
+
+void pdcp_rlc_shards::rlc_adapter::write_pdu(uint16_t rnti, uint32_t lcid, uint8_t* payload, uint32_t nof_bytes)
+{
+  // The payload belongs to the MAC PDU, which is released once it is demultiplexed
+  srsran::unique_byte_buffer_t pdu = srsran::make_byte_buffer();
+  if (pdu == nullptr) {
+    parent->logger.warning("Couldn't allocate PDU in %s().", __FUNCTION__);
+    return;
+  }
+  if (pdu->get_tailroom() < nof_bytes) {
+    parent->logger.error("Discarding RLC PDU rnti=0x%x, lcid=%d. Cause: PDU size %d too large", rnti, lcid, nof_bytes);
+    return;
+  }
+  pdu->append_bytes(payload, nof_bytes);
+
+  shard* s    = parent->get_shard(rnti);
+  auto   task = [s, rnti, lcid](srsran::unique_byte_buffer_t& pdu) {
+    s->rlc.write_pdu(rnti, lcid, pdu->msg, pdu->N_bytes);
+  };
+  s->queue.push(std::bind(task, std::move(pdu)));
+}
+
+/*******************************************************
+ *          RRC and GTPU interfaces to the shards
+ *******************************************************/
+
+void pdcp_rlc_shards::rrc_pdcp_adapter::write_pdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t pdu)
+{
+  rrc_interface_pdcp* rrc  = parent->rrc_pdcp;
+  auto                task = [rrc, rnti, lcid](srsran::unique_byte_buffer_t& pdu) {
+    rrc->write_pdu(rnti, lcid, std::move(pdu));
+  };
+  parent->push_stack_task(std::bind(task, std::move(pdu)));
+}
+
+void pdcp_rlc_shards::rrc_pdcp_adapter::notify_pdcp_integrity_error(uint16_t rnti, uint32_t lcid)
+{
+  rrc_interface_pdcp* rrc = parent->rrc_pdcp;
+  parent->push_stack_task([rrc, rnti, lcid]() { rrc->notify_pdcp_integrity_error(rnti, lcid); });
+}
+
+void pdcp_rlc_shards::rrc_rlc_adapter::max_retx_attempted(uint16_t rnti)
+{
+  rrc_interface_rlc* rrc = parent->rrc_rlc;
+  parent->push_stack_task([rrc, rnti]() { rrc->max_retx_attempted(rnti); });
+}
+
+void pdcp_rlc_shards::rrc_rlc_adapter::protocol_failure(uint16_t rnti)
+{
+  rrc_interface_rlc* rrc = parent->rrc_rlc;
+  parent->push_stack_task([rrc, rnti]() { rrc->protocol_failure(rnti); });
+}
+
+void pdcp_rlc_shards::rrc_rlc_adapter::write_pdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t sdu)
+{
+  rrc_interface_rlc* rrc  = parent->rrc_rlc;
+  auto               task = [rrc, rnti, lcid](srsran::unique_byte_buffer_t& sdu) {
+    rrc->write_pdu(rnti, lcid, std::move(sdu));
+  };
+  parent->push_stack_task(std::bind(task, std::move(sdu)));
+}
+
+void pdcp_rlc_shards::gtpu_adapter::write_pdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t pdu)
+{
+  gtpu_interface_pdcp* gtpu = parent->gtpu;
+  auto                 task = [gtpu, rnti, lcid](srsran::unique_byte_buffer_t& pdu) {
+    gtpu->write_pdu(rnti, lcid, std::move(pdu));
+  };
+  parent->push_stack_task(std::bind(task, std::move(pdu)));
+}
+
+} // namespace srsenb
@@ -27,12 +27,18 @@
 
 namespace srsenb {
 
+const uint16_t first_rnti = 0x46;
+
 struct run_params {
   uint32_t    nof_prbs;
   uint32_t    nof_ues;
+  uint32_t    nof_active_ues; ///< UEs with data to transmit, the others remain connected and idle
   uint32_t    nof_ttis;
   uint32_t    cqi;
   const char* sched_policy;
+  uint32_t    nof_carriers      = 1;
+  bool        carrier_aggr      = false; ///< UEs are configured with all carriers, otherwise one carrier per UE
+  bool        parallel_carriers = false;
 };
 
 struct run_params_range {
@@ -49,7 +55,8 @@ struct run_params_range {
     r.nof_ttis   = nof_ttis;
     r.nof_prbs   = nof_prbs[idx % nof_prbs.size()];
     idx /= nof_prbs.size();
-    r.nof_ues = nof_ues[idx % nof_ues.size()];
+    r.nof_ues        = nof_ues[idx % nof_ues.size()];
+    r.nof_active_ues = r.nof_ues;
     idx /= nof_ues.size();
     r.cqi = cqi[idx % cqi.size()];
     idx /= cqi.size();
@@ -101,15 +108,16 @@ public:
     mac_logger.set_context(tti_rx.to_uint());
     new_tti(tti_rx);
 
+    // The latency of a TTI covers all its carriers
+    std::chrono::time_point<std::chrono::steady_clock> tp = std::chrono::steady_clock::now();
     for (uint32_t cc = 0; cc < get_cell_params().size(); ++cc) {
-      std::chrono::time_point<std::chrono::steady_clock> tp = std::chrono::steady_clock::now();
       TESTASSERT(sched_ptr->dl_sched(to_tx_dl(tti_rx).to_uint(), cc, dl_result[cc]) == SRSRAN_SUCCESS);
       TESTASSERT(sched_ptr->ul_sched(to_tx_ul(tti_rx).to_uint(), cc, ul_result[cc]) == SRSRAN_SUCCESS);
-      std::chrono::time_point<std::chrono::steady_clock> tp2 = std::chrono::steady_clock::now();
-      std::chrono::nanoseconds tdur = std::chrono::duration_cast<std::chrono::nanoseconds>(tp2 - tp);
-      total_stats.avg_latency.push(tdur.count());
-      total_stats.latency_samples.push_back(tdur.count());
     }
+    std::chrono::time_point<std::chrono::steady_clock> tp2 = std::chrono::steady_clock::now();
+    std::chrono::nanoseconds tdur = std::chrono::duration_cast<std::chrono::nanoseconds>(tp2 - tp);
+    total_stats.avg_latency.push(tdur.count());
+    total_stats.latency_samples.push_back(tdur.count());
 
     sf_output_res_t sf_out{get_cell_params(), tti_rx, ul_result, dl_result};
     update(sf_out);
@@ -121,7 +129,7 @@ public:
   void set_external_tti_events(const sim_ue_ctxt_t& ue_ctxt, ue_tti_events& pending_events) override
   {
     // do nothing
-    if (ue_ctxt.conres_rx) {
+    if (ue_ctxt.conres_rx and ue_ctxt.rnti < first_rnti + current_run_params.nof_active_ues) {
       sched_ptr->ul_bsr(ue_ctxt.rnti, 1, dl_bytes_per_tti);
       sched_ptr->dl_rlc_buffer_state(ue_ctxt.rnti, 3, ul_bytes_per_tti, 0);
 
@@ -171,10 +179,30 @@ struct run_data {
 
 int run_benchmark_scenario(run_params params, std::vector<run_data>& run_results)
 {
-  std::vector<sched_interface::cell_cfg_t> cell_list(1, generate_default_cell_cfg(params.nof_prbs));
+  std::vector<sched_interface::cell_cfg_t> cell_list(params.nof_carriers, generate_default_cell_cfg(params.nof_prbs));
   sched_interface::ue_cfg_t                ue_cfg_default = generate_default_ue_cfg();
   sched_interface::sched_args_t            sched_args     = {};
   sched_args.sched_policy                                 = params.sched_policy;
+  sched_args.max_nof_ues                                  = std::max(params.nof_ues, (uint32_t)SRSENB_MAX_UES);
+  sched_args.parallel_carriers                            = params.parallel_carriers;
+  for (uint32_t cc = 0; cc < cell_list.size(); ++cc) {
+    cell_list[cc].cell.id = cc + 1;
+    for (uint32_t scc = 0; params.carrier_aggr and scc < cell_list.size(); ++scc) {
+      if (scc != cc) {
+        cell_list[cc].scell_list.emplace_back();
+        cell_list[cc].scell_list.back().enb_cc_idx = scc;
+        cell_list[cc].scell_list.back().ul_allowed = true;
+      }
+    }
+  }
+  if (params.carrier_aggr) {
+    ue_cfg_default.supported_cc_list.resize(params.nof_carriers, ue_cfg_default.supported_cc_list[0]);
+    for (uint32_t i = 0; i < ue_cfg_default.supported_cc_list.size(); ++i) {
+      ue_cfg_default.supported_cc_list[i].enb_cc_idx                            = i;
+      ue_cfg_default.supported_cc_list[i].dl_cfg.cqi_report.periodic_configured = true;
+      ue_cfg_default.supported_cc_list[i].dl_cfg.cqi_report.pmi_idx             = 37 + i;
+    }
+  }
 
   sched     sched_obj;
   rrc_dummy rrc{};
@@ -185,7 +213,10 @@ int run_benchmark_scenario(run_params params, std::vector<run_data>& run_results
   tester.current_run_params = params;
 
   for (uint32_t ue_idx = 0; ue_idx < params.nof_ues; ++ue_idx) {
-    uint16_t rnti = 0x46 + ue_idx;
+    uint16_t rnti = first_rnti + ue_idx;
+    if (not params.carrier_aggr) {
+      ue_cfg_default.supported_cc_list[0].enb_cc_idx = ue_idx % params.nof_carriers;
+    }
     // Add user (first need to advance to a PRACH TTI)
     while (not srsran_prach_tti_opportunity_config_fdd(
         tester.get_cell_params()[ue_cfg_default.supported_cc_list[0].enb_cc_idx].cfg.prach_config,
@@ -394,6 +425,89 @@ int run_benchmark()
   return SRSRAN_SUCCESS;
 }
 
+/// Per-TTI latency of the scheduler with many connected UEs, of which only a few have data to transmit
+int run_capacity_benchmark()
+{
+  run_params_range      run_param_list{};
+  srslog::basic_logger& mac_logger = srslog::fetch_basic_logger("MAC");
+
+  run_param_list.nof_ttis = 10000;
+  run_param_list.nof_prbs = {25};
+  run_param_list.cqi      = {15};
+  run_param_list.nof_ues  = {64, 256, 1024};
+
+  std::vector<run_data> run_results;
+  size_t                nof_runs = run_param_list.nof_runs();
+  fmt::print("Running Capacity Benchmark\n");
+  for (size_t r = 0; r < nof_runs; ++r) {
+    run_params runparams     = run_param_list.get_params(r);
+    runparams.nof_active_ues = 8;
+
+    mac_logger.info("\n### New run {} ###\n", r);
+    TESTASSERT(run_benchmark_scenario(runparams, run_results) == SRSRAN_SUCCESS);
+  }
+
+  print_benchmark_results(run_results);
+
+  // Idle UEs are not processed in every TTI, so the latency must stay roughly flat as the number of UEs grows
+  for (const run_data& r : run_results) {
+    auto base = std::find_if(run_results.begin(), run_results.end(), [&r, &run_param_list](const run_data& r2) {
+      return strcmp(r2.params.sched_policy, r.params.sched_policy) == 0 and
+             r2.params.nof_ues == run_param_list.nof_ues.front();
+    });
+    TESTASSERT(base != run_results.end());
+    TESTASSERT(r.avg_latency.count() <= 2 * base->avg_latency.count() + 10);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+/// Per-TTI latency of three carriers, scheduled in parallel or not, when the UEs are spread over the carriers and when
+/// all of them use carrier aggregation. Carriers sharing a UE with pending work are scheduled one after the other
+int run_carrier_benchmark()
+{
+  srslog::basic_logger& mac_logger = srslog::fetch_basic_logger("MAC");
+
+  std::vector<run_data> run_results;
+  fmt::print("Running Carrier Benchmark\n");
+  for (bool carrier_aggr : {false, true}) {
+    for (bool parallel_carriers : {false, true}) {
+      run_params runparams        = {};
+      runparams.nof_prbs          = 100;
+      runparams.nof_ues           = 12;
+      runparams.nof_active_ues    = runparams.nof_ues;
+      runparams.nof_ttis          = 10000;
+      runparams.cqi               = 15;
+      runparams.sched_policy      = "time_pf";
+      runparams.nof_carriers      = 3;
+      runparams.carrier_aggr      = carrier_aggr;
+      runparams.parallel_carriers = parallel_carriers;
+
+      mac_logger.info("\n### New run {} ###\n", run_results.size());
+      TESTASSERT(run_benchmark_scenario(runparams, run_results) == SRSRAN_SUCCESS);
+    }
+  }
+
+  srslog::flush();
+  fmt::print("run | Ncc |  CA | parallel | Nue | DL/UL [Mbps] | latency | latency q0.9 [usec]\n");
+  fmt::print("----------------------------------------------------------------------------------\n");
+  for (uint32_t i = 0; i < run_results.size(); ++i) {
+    const run_data& r = run_results[i];
+    fmt::print("{:>3d}{:>6d}{:>6}{:>11}{:>6d}{:>9.2}/{:>4.2}{:>10d}{:12d}\n",
+               i,
+               r.params.nof_carriers,
+               r.params.carrier_aggr ? "yes" : "no",
+               r.params.parallel_carriers ? "yes" : "no",
+               r.params.nof_ues,
+               r.avg_dl_throughput / 1e6,
+               r.avg_ul_throughput / 1e6,
+               r.avg_latency.count(),
+               r.q0_9_latency.count());
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 } // namespace srsenb
 
 int main(int argc, char* argv[])
@@ -424,6 +538,10 @@ int main(int argc, char* argv[])
     TESTASSERT(srsenb::run_rate_test() == SRSRAN_SUCCESS);
   } else if (strcmp(argv[1], "benchmark") == 0) {
     TESTASSERT(srsenb::run_benchmark() == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "capacity") == 0) {
+    TESTASSERT(srsenb::run_capacity_benchmark() == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "carriers") == 0) {
+    TESTASSERT(srsenb::run_carrier_benchmark() == SRSRAN_SUCCESS);
   } else {
     TESTASSERT(srsenb::run_all() == SRSRAN_SUCCESS);
   }
@@ -243,6 +243,9 @@ int test_pdcch_collisions(const sf_output_res_t&                   sf_out,
     }
     try_cce_fill(pusch.dci.location, "UL");
   }
+  for (uint32_t i = 0; i < ul_result.sps_release.size(); ++i) {
+    try_cce_fill(ul_result.sps_release[i].dci.location, "UL SPS release");
+  }
   for (uint32_t i = 0; i < dl_result.data.size(); ++i) {
     try_cce_fill(dl_result.data[i].dci.location, "DL data");
   }
@@ -286,6 +289,20 @@ int test_dci_content_common(const sf_output_res_t& sf_out, uint32_t enb_cc_idx)
       CONDERROR(pusch.dci.format != SRSRAN_DCI_FORMAT0, "Incorrect UL DCI format");
       CONDERROR(pusch.dci.tb.mcs_idx > 28, "Incorrect UL MCS index");
     }
+    if (pusch.sps_crnti != SRSRAN_INVALID_RNTI and not pusch.dci.tb.ndi) {
+      // SPS activation. See TS 36.213, Table 9.2-1
+      CONDERROR(pusch.dci.tb.mcs_idx > 15, "Invalid MCS index for UL SPS activation");
+      CONDERROR(pusch.dci.tpc_pusch != 0, "Invalid TPC for UL SPS activation");
+    }
+  }
+  for (uint32_t i = 0; i < ul_result.sps_release.size(); ++i) {
+    const auto& release = ul_result.sps_release[i];
+    uint16_t    rnti    = release.dci.rnti;
+    CONDERROR(alloc_rntis.count(rnti) > 0, "The user rnti=0x%x got allocated multiple times in UL", rnti);
+    alloc_rntis.insert(rnti);
+    CONDERROR(release.sps_crnti == SRSRAN_INVALID_RNTI, "UL SPS release without SPS C-RNTI");
+    // SPS release validation fields. See TS 36.213, Table 9.2-1A
+    CONDERROR(release.dci.tb.mcs_idx != 31 or release.dci.tb.ndi, "Invalid UL SPS release DCI");
   }
 
   alloc_rntis.clear();
@@ -0,0 +1,365 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "sched_sim_ue.h"
+#include "sched_test_common.h"
+#include "sched_test_utils.h"
+#include "srsenb/hdr/stack/mac/sched.h"
+#include "srsran/common/test_common.h"
+
+using namespace srsenb;
+const uint32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+
+namespace {
+
+const uint16_t first_rnti = 0x46;
+const uint32_t drb_lcid   = drb_to_lcid(lte_drb::drb1);
+
+/// Scheduler simulation whose UE events are drawn from its own random generator. Two instances with the same seed
+/// see the same sequence of events, as long as they take the same scheduling decisions
+class sched_sim_tester : public sched_sim_base
+{
+public:
+  sched_sim_tester(sched*                                          sched_obj_,
+                   const sched_interface::sched_args_t&            sched_args,
+                   const std::vector<sched_interface::cell_cfg_t>& cell_cfg_list,
+                   uint32_t                                        seed_) :
+    sched_sim_base(sched_obj_, sched_args, cell_cfg_list),
+    sched_obj(sched_obj_),
+    rand_gen(seed_),
+    dl_result(cell_cfg_list.size()),
+    ul_result(cell_cfg_list.size())
+  {}
+
+  sched*                                       sched_obj;
+  bool                                         random_events = false;
+  std::vector<sched_interface::dl_sched_res_t> dl_result;
+  std::vector<sched_interface::ul_sched_res_t> ul_result;
+
+  void advance_tti()
+  {
+    tti_point tti_rx = get_tti_rx().is_valid() ? get_tti_rx() + 1 : tti_point(0);
+    new_tti(tti_rx);
+
+    for (uint32_t cc = 0; cc < get_cell_params().size(); ++cc) {
+      TESTASSERT(sched_obj->dl_sched(to_tx_dl(tti_rx).to_uint(), cc, dl_result[cc]) == SRSRAN_SUCCESS);
+      TESTASSERT(sched_obj->ul_sched(to_tx_ul(tti_rx).to_uint(), cc, ul_result[cc]) == SRSRAN_SUCCESS);
+    }
+
+    sf_output_res_t sf_out{get_cell_params(), tti_rx, ul_result, dl_result};
+    update(sf_out);
+  }
+
+  void set_external_tti_events(const sim_ue_ctxt_t& ue_ctxt, ue_tti_events& pending_events) override
+  {
+    if (not ue_ctxt.conres_rx) {
+      return;
+    }
+    if (get_tti_rx().to_uint() % 5 == 0) {
+      for (auto& cc : pending_events.cc_list) {
+        cc.dl_cqi = 15;
+        cc.ul_snr = 40;
+      }
+    }
+    if (not random_events) {
+      return;
+    }
+
+    std::uniform_real_distribution<float>   unif_dist{0, 1};
+    std::uniform_int_distribution<uint32_t> bytes_dist{0, 5000};
+    if (unif_dist(rand_gen) < 0.2) {
+      sched_obj->dl_rlc_buffer_state(ue_ctxt.rnti, drb_lcid, bytes_dist(rand_gen), 0);
+    }
+    if (unif_dist(rand_gen) < 0.2) {
+      sched_obj->ul_bsr(ue_ctxt.rnti, 1, bytes_dist(rand_gen));
+    }
+    for (auto& cc : pending_events.cc_list) {
+      cc.dl_ack = cc.dl_ack and unif_dist(rand_gen) < 0.9;
+      cc.ul_ack = cc.ul_ack and unif_dist(rand_gen) < 0.9;
+      if (cc.dl_cqi >= 0) {
+        cc.dl_cqi = std::uniform_int_distribution<int>{5, 15}(rand_gen);
+      }
+    }
+  }
+
+private:
+  std::mt19937 rand_gen;
+};
+
+std::vector<sched_interface::cell_cfg_t> generate_cell_cfg_list(uint32_t nof_prb, uint32_t nof_ccs)
+{
+  std::vector<sched_interface::cell_cfg_t> cell_cfg_list(nof_ccs, generate_default_cell_cfg(nof_prb));
+  for (uint32_t cc = 0; cc < nof_ccs; ++cc) {
+    cell_cfg_list[cc].cell.id = cc + 1;
+  }
+  return cell_cfg_list;
+}
+
+void test_same_dl_result(const sched_interface::dl_sched_res_t& res, const sched_interface::dl_sched_res_t& res2)
+{
+  TESTASSERT(res.cfi == res2.cfi);
+  TESTASSERT(res.rar.size() == res2.rar.size());
+  TESTASSERT(res.bc.size() == res2.bc.size());
+  TESTASSERT(res.data.size() == res2.data.size());
+  for (uint32_t i = 0; i < res.data.size(); ++i) {
+    const sched_interface::dl_sched_data_t& data  = res.data[i];
+    const sched_interface::dl_sched_data_t& data2 = res2.data[i];
+    TESTASSERT(data.dci.rnti == data2.dci.rnti);
+    TESTASSERT(data.dci.location.L == data2.dci.location.L);
+    TESTASSERT(data.dci.location.ncce == data2.dci.location.ncce);
+    TESTASSERT(data.dci.type0_alloc.rbg_bitmask == data2.dci.type0_alloc.rbg_bitmask);
+    TESTASSERT(data.dci.tb[0].mcs_idx == data2.dci.tb[0].mcs_idx);
+    TESTASSERT(data.dci.tb[0].rv == data2.dci.tb[0].rv);
+    TESTASSERT(data.tbs[0] == data2.tbs[0] and data.tbs[1] == data2.tbs[1]);
+    TESTASSERT(data.nof_pdu_elems[0] == data2.nof_pdu_elems[0]);
+    for (uint32_t j = 0; j < data.nof_pdu_elems[0]; ++j) {
+      TESTASSERT(data.pdu[0][j].lcid == data2.pdu[0][j].lcid);
+      TESTASSERT(data.pdu[0][j].nbytes == data2.pdu[0][j].nbytes);
+    }
+  }
+}
+
+void test_same_ul_result(const sched_interface::ul_sched_res_t& res, const sched_interface::ul_sched_res_t& res2)
+{
+  TESTASSERT(res.pusch.size() == res2.pusch.size());
+  for (uint32_t i = 0; i < res.pusch.size(); ++i) {
+    const sched_interface::ul_sched_data_t& pusch  = res.pusch[i];
+    const sched_interface::ul_sched_data_t& pusch2 = res2.pusch[i];
+    TESTASSERT(pusch.dci.rnti == pusch2.dci.rnti);
+    TESTASSERT(pusch.needs_pdcch == pusch2.needs_pdcch);
+    TESTASSERT(pusch.current_tx_nb == pusch2.current_tx_nb);
+    TESTASSERT(pusch.dci.type2_alloc.riv == pusch2.dci.type2_alloc.riv);
+    TESTASSERT(pusch.dci.tb.mcs_idx == pusch2.dci.tb.mcs_idx);
+    TESTASSERT(pusch.tbs == pusch2.tbs);
+  }
+  TESTASSERT(res.phich.size() == res2.phich.size());
+  for (uint32_t i = 0; i < res.phich.size(); ++i) {
+    TESTASSERT(res.phich[i].rnti == res2.phich[i].rnti);
+    TESTASSERT(res.phich[i].phich == res2.phich[i].phich);
+  }
+}
+
+/**
+ * Runs the same random sequence of UE arrivals, removals, bearer reconfigurations, buffer states and HARQ feedback
+ * through two schedulers with independent carriers, one scheduling them in parallel and the other serially.
+ * - Both schedulers must take the same decisions in every TTI
+ */
+void test_parallel_carriers_same_result()
+{
+  const uint32_t nof_ccs = 3, nof_prb = 25, max_nof_ues = 16, nof_ttis = 2000;
+
+  std::vector<sched_interface::cell_cfg_t> cell_cfg_list = generate_cell_cfg_list(nof_prb, nof_ccs);
+  sched_interface::sched_args_t            sched_args    = {};
+  sched_interface::sched_args_t            sched_args2   = {};
+  sched_args.parallel_carriers                           = true;
+  sched_args2.parallel_carriers                          = false;
+
+  rrc_dummy        rrc{};
+  sched            sched_obj, sched_obj2;
+  sched_obj.init(&rrc, sched_args);
+  sched_obj2.init(&rrc, sched_args2);
+  sched_sim_tester tester(&sched_obj, sched_args, cell_cfg_list, seed);
+  sched_sim_tester tester2(&sched_obj2, sched_args2, cell_cfg_list, seed);
+  tester.random_events  = true;
+  tester2.random_events = true;
+
+  std::mt19937                          rand_gen(seed);
+  std::uniform_real_distribution<float> unif_dist{0, 1};
+  std::vector<uint16_t>                 rntis;
+  uint16_t                              next_rnti = first_rnti;
+  for (uint32_t count = 0; count < nof_ttis; ++count) {
+    tester.advance_tti();
+    tester2.advance_tti();
+    for (uint32_t cc = 0; cc < nof_ccs; ++cc) {
+      test_same_dl_result(tester.dl_result[cc], tester2.dl_result[cc]);
+      test_same_ul_result(tester.ul_result[cc], tester2.ul_result[cc]);
+    }
+
+    // New UE in one of the carriers
+    sched_interface::ue_cfg_t ue_cfg       = generate_default_ue_cfg();
+    ue_cfg.supported_cc_list[0].enb_cc_idx = std::uniform_int_distribution<uint32_t>{0, nof_ccs - 1}(rand_gen);
+    bool prach_occasion                    = srsran_prach_tti_opportunity_config_fdd(
+        cell_cfg_list[ue_cfg.supported_cc_list[0].enb_cc_idx].prach_config, tester.get_tti_rx().to_uint(), -1);
+    if (prach_occasion and rntis.size() < max_nof_ues and unif_dist(rand_gen) < 0.5) {
+      TESTASSERT(tester.add_user(next_rnti, ue_cfg, 16) == SRSRAN_SUCCESS);
+      TESTASSERT(tester2.add_user(next_rnti, ue_cfg, 16) == SRSRAN_SUCCESS);
+      rntis.push_back(next_rnti++);
+    }
+    if (rntis.empty()) {
+      continue;
+    }
+
+    // Removal or bearer reconfiguration of a connected UE
+    uint16_t rnti = rntis[std::uniform_int_distribution<size_t>{0, rntis.size() - 1}(rand_gen)];
+    if (not tester.at(rnti).get_ctxt().conres_rx) {
+      continue;
+    }
+    float p = unif_dist(rand_gen);
+    if (p < 0.005) {
+      TESTASSERT(tester.rem_user(rnti) == SRSRAN_SUCCESS);
+      TESTASSERT(tester2.rem_user(rnti) == SRSRAN_SUCCESS);
+      rntis.erase(std::find(rntis.begin(), rntis.end(), rnti));
+    } else if (p < 0.01) {
+      TESTASSERT(sched_obj.bearer_ue_rem(rnti, drb_lcid) == SRSRAN_SUCCESS);
+      TESTASSERT(sched_obj2.bearer_ue_rem(rnti, drb_lcid) == SRSRAN_SUCCESS);
+      TESTASSERT(tester.bearer_cfg(rnti, drb_lcid, ue_cfg.ue_bearers[drb_lcid]) == SRSRAN_SUCCESS);
+      TESTASSERT(tester2.bearer_cfg(rnti, drb_lcid, ue_cfg.ue_bearers[drb_lcid]) == SRSRAN_SUCCESS);
+    }
+  }
+}
+
+/// Finds the newtx PDU for rnti in the DL result of carrier cc. Returns nullptr if there is none
+const sched_interface::dl_sched_data_t* find_dl_newtx(const sched_sim_tester& tester, uint32_t cc, uint16_t rnti)
+{
+  for (const auto& data : tester.dl_result[cc].data) {
+    if (data.dci.rnti == rnti and data.nof_pdu_elems[0] > 0) {
+      return &data;
+    }
+  }
+  return nullptr;
+}
+
+/// Position of the PDU element with the given lcid, or -1 if not found
+int find_pdu_elem(const sched_interface::dl_sched_data_t& data, uint32_t lcid)
+{
+  for (uint32_t i = 0; i < data.nof_pdu_elems[0]; ++i) {
+    if (data.pdu[0][i].lcid == lcid) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * UE events that arrive in the same TTI take effect in the order of the calls, whether they are deferred (buffer
+ * states, MAC CEs) or not.
+ * - A DL buffer state followed by the removal of the bearer leaves no data to transmit, while the bearer removal
+ *   and setup followed by a buffer state leave data to transmit
+ * - The MAC CEs follow the order of a TA command and of a reconfiguration that activates an SCell
+ */
+void test_ue_event_order(bool ta_before_reconf)
+{
+  const uint16_t rnti = first_rnti;
+
+  std::vector<sched_interface::cell_cfg_t> cell_cfg_list = generate_cell_cfg_list(25, 2);
+  cell_cfg_list[0].scell_list.resize(1);
+  cell_cfg_list[0].scell_list[0].enb_cc_idx = 1;
+  cell_cfg_list[0].scell_list[0].ul_allowed = true;
+  cell_cfg_list[1].scell_list.resize(1);
+  cell_cfg_list[1].scell_list[0].enb_cc_idx = 0;
+  cell_cfg_list[1].scell_list[0].ul_allowed = true;
+  sched_interface::sched_args_t sched_args  = {};
+
+  rrc_dummy rrc{};
+  sched     sched_obj;
+  sched_obj.init(&rrc, sched_args);
+  sched_sim_tester tester(&sched_obj, sched_args, cell_cfg_list, seed);
+
+  sched_interface::ue_cfg_t ue_cfg = generate_default_ue_cfg();
+  while (not srsran_prach_tti_opportunity_config_fdd(
+      cell_cfg_list[0].prach_config, tester.get_tti_rx().is_valid() ? tester.get_tti_rx().to_uint() : 0, -1)) {
+    tester.advance_tti();
+  }
+  TESTASSERT(tester.add_user(rnti, ue_cfg, 16) == SRSRAN_SUCCESS);
+  while (not tester.at(rnti).get_ctxt().conres_rx) {
+    tester.advance_tti();
+  }
+  for (uint32_t i = 0; i < 20; ++i) {
+    tester.advance_tti();
+  }
+
+  // Buffer state followed by the bearer removal in the same TTI
+  TESTASSERT(sched_obj.dl_rlc_buffer_state(rnti, drb_lcid, 1000, 0) == SRSRAN_SUCCESS);
+  TESTASSERT(sched_obj.bearer_ue_rem(rnti, drb_lcid) == SRSRAN_SUCCESS);
+  tester.at(rnti).bearer_cfg(drb_lcid, mac_lc_ch_cfg_t{});
+  for (uint32_t i = 0; i < 10; ++i) {
+    tester.advance_tti();
+    TESTASSERT(find_dl_newtx(tester, 0, rnti) == nullptr);
+  }
+  TESTASSERT(sched_obj.get_dl_buffer(rnti) == 0);
+
+  // Bearer removal and setup followed by a buffer state in the same TTI
+  TESTASSERT(sched_obj.bearer_ue_rem(rnti, drb_lcid) == SRSRAN_SUCCESS);
+  TESTASSERT(tester.bearer_cfg(rnti, drb_lcid, ue_cfg.ue_bearers[drb_lcid]) == SRSRAN_SUCCESS);
+  TESTASSERT(sched_obj.dl_rlc_buffer_state(rnti, drb_lcid, 1000, 0) == SRSRAN_SUCCESS);
+  TESTASSERT(sched_obj.get_dl_buffer(rnti) == 1000);
+  const sched_interface::dl_sched_data_t* data = nullptr;
+  for (uint32_t i = 0; i < 10 and data == nullptr; ++i) {
+    tester.advance_tti();
+    data = find_dl_newtx(tester, 0, rnti);
+  }
+  TESTASSERT(data != nullptr and find_pdu_elem(*data, drb_lcid) >= 0);
+  TESTASSERT(sched_obj.dl_rlc_buffer_state(rnti, drb_lcid, 0, 0) == SRSRAN_SUCCESS);
+  for (uint32_t i = 0; i < 20; ++i) {
+    tester.advance_tti();
+  }
+
+  // TA command and SCell activation in the same TTI
+  sched_interface::ue_cfg_t ue_cfg2 = *tester.get_user_cfg(rnti);
+  ue_cfg2.supported_cc_list.resize(2);
+  ue_cfg2.supported_cc_list[1]            = ue_cfg2.supported_cc_list[0];
+  ue_cfg2.supported_cc_list[1].enb_cc_idx = 1;
+  for (uint32_t i = 0; i < ue_cfg2.supported_cc_list.size(); ++i) {
+    ue_cfg2.supported_cc_list[i].dl_cfg.cqi_report.periodic_configured = true;
+    ue_cfg2.supported_cc_list[i].dl_cfg.cqi_report.pmi_idx             = 37 + i;
+  }
+  if (ta_before_reconf) {
+    TESTASSERT(sched_obj.dl_mac_buffer_state(rnti, (uint32_t)srsran::dl_sch_lcid::TA_CMD, 1) == SRSRAN_SUCCESS);
+    TESTASSERT(tester.ue_recfg(rnti, ue_cfg2) == SRSRAN_SUCCESS);
+  } else {
+    TESTASSERT(tester.ue_recfg(rnti, ue_cfg2) == SRSRAN_SUCCESS);
+    TESTASSERT(sched_obj.dl_mac_buffer_state(rnti, (uint32_t)srsran::dl_sch_lcid::TA_CMD, 1) == SRSRAN_SUCCESS);
+  }
+  data = nullptr;
+  for (uint32_t i = 0; i < 10 and data == nullptr; ++i) {
+    tester.advance_tti();
+    data = find_dl_newtx(tester, 0, rnti);
+  }
+  TESTASSERT(data != nullptr);
+  int ta_pos    = find_pdu_elem(*data, (uint32_t)srsran::dl_sch_lcid::TA_CMD);
+  int scell_pos = find_pdu_elem(*data, (uint32_t)srsran::dl_sch_lcid::SCELL_ACTIVATION);
+  TESTASSERT(ta_pos >= 0 and scell_pos >= 0);
+  TESTASSERT((ta_pos < scell_pos) == ta_before_reconf);
+}
+
+} // namespace
+
+int main()
+{
+  srsenb::set_randseed(seed);
+  srsran::console("This is the chosen seed: %u\n", seed);
+
+  auto& mac_log = srslog::fetch_basic_logger("MAC");
+  mac_log.set_level(srslog::basic_levels::warning);
+  auto& test_log = srslog::fetch_basic_logger("TEST", false);
+  test_log.set_level(srslog::basic_levels::warning);
+
+  // Start the log backend.
+  srslog::init();
+
+  test_parallel_carriers_same_result();
+  test_ue_event_order(true);
+  test_ue_event_order(false);
+
+  srslog::flush();
+
+  srsran::console("Success\n");
+}
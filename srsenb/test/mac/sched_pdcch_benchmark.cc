@@ -0,0 +1,187 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "sched_test_common.h"
+#include "srsenb/hdr/stack/mac/sched_grid.h"
+#include "srsran/common/test_common.h"
+#include <chrono>
+#include <random>
+
+namespace srsenb {
+
+const uint16_t first_rnti = 0x46;
+
+struct run_params {
+  uint32_t nof_prbs;
+  uint32_t nof_ues;
+  uint32_t nof_ttis;
+  uint32_t max_dfs_nodes; ///< 0 for the exhaustive DFS of DCI positions
+};
+
+struct run_data {
+  run_params params;
+  double     avg_latency_us;  ///< Average time to allocate the DCIs of a TTI
+  double     max_latency_us;  ///< Largest time to allocate the DCIs of a TTI
+  double     avg_nof_allocs;  ///< Average number of allocated DCIs per TTI
+  uint64_t   nof_failed_dcis; ///< DCIs that did not fit in the PDCCH
+};
+
+/// Checks that the allocated DCIs do not share CCEs
+int test_pdcch_result(const sf_cch_allocator& pdcch)
+{
+  sf_cch_allocator::alloc_result_t dci_result;
+  pdcch_mask_t                     total_mask, used_mask(pdcch.nof_cces());
+  pdcch.get_allocs(&dci_result, &total_mask);
+  TESTASSERT(dci_result.size() == pdcch.nof_allocs());
+  for (const auto* node : dci_result) {
+    uint32_t cce_start = node->dci_pos.ncce, cce_stop = node->dci_pos.ncce + (1U << node->dci_pos.L);
+    TESTASSERT(cce_stop <= pdcch.nof_cces());
+    TESTASSERT(not used_mask.any(cce_start, cce_stop));
+    used_mask.fill(cce_start, cce_stop);
+  }
+  TESTASSERT(used_mask == total_mask);
+  return SRSRAN_SUCCESS;
+}
+
+/**
+ * Allocates a DL and an UL DCI for every UE in each TTI, up to the maximum number of DCIs of a TTI, and measures the
+ * time spent in the PDCCH allocator. The aggregation levels are random, but the same for every allocator configuration
+ */
+int run_benchmark_scenario(run_params params, std::vector<run_data>& run_results)
+{
+  std::vector<sched_cell_params_t> cell_params(1);
+  sched_interface::ue_cfg_t        ue_cfg   = generate_default_ue_cfg();
+  sched_interface::cell_cfg_t      cell_cfg = generate_default_cell_cfg(params.nof_prbs);
+  sched_interface::sched_args_t    sched_args{};
+  sched_args.max_nof_ctrl_symbols = 3;
+  TESTASSERT(cell_params[0].set_cfg(0, cell_cfg, sched_args));
+
+  std::vector<std::unique_ptr<sched_ue> > ues;
+  for (uint32_t i = 0; i < params.nof_ues; ++i) {
+    ues.emplace_back(new sched_ue{(uint16_t)(first_rnti + i), cell_params, ue_cfg});
+  }
+
+  sf_cch_allocator pdcch;
+  pdcch.init(cell_params[0], params.max_dfs_nodes);
+
+  std::mt19937                          rand_gen(params.nof_prbs * 1000 + params.nof_ues);
+  std::discrete_distribution<uint32_t>  aggr_dist{4, 4, 2, 1};
+  std::chrono::nanoseconds              tot_dur{0}, max_dur{0};
+  uint64_t                              nof_allocs = 0, nof_failed = 0;
+  std::vector<std::array<uint32_t, 2> > aggr_idxs(params.nof_ues);
+  const size_t                          max_nof_dcis = sf_cch_allocator::alloc_result_t{}.capacity();
+  for (uint32_t tti = 0; tti < params.nof_ttis; ++tti) {
+    for (auto& aggr_idx : aggr_idxs) {
+      aggr_idx = {aggr_dist(rand_gen), aggr_dist(rand_gen)};
+    }
+
+    auto tp = std::chrono::steady_clock::now();
+    pdcch.new_tti(tti_point{tti});
+    for (uint32_t i = 0; i < params.nof_ues and pdcch.nof_allocs() + 2 <= max_nof_dcis; ++i) {
+      nof_failed += pdcch.alloc_dci(alloc_type_t::DL_DATA, aggr_idxs[i][0], ues[i].get(), false) ? 0 : 1;
+      nof_failed += pdcch.alloc_dci(alloc_type_t::UL_DATA, aggr_idxs[i][1], ues[i].get(), false) ? 0 : 1;
+    }
+    auto tdur = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tp);
+    tot_dur += tdur;
+    max_dur = std::max(max_dur, tdur);
+
+    nof_allocs += pdcch.nof_allocs();
+    TESTASSERT(test_pdcch_result(pdcch) == SRSRAN_SUCCESS);
+  }
+
+  run_data r        = {};
+  r.params          = params;
+  r.avg_latency_us  = tot_dur.count() / 1000.0 / params.nof_ttis;
+  r.max_latency_us  = max_dur.count() / 1000.0;
+  r.avg_nof_allocs  = nof_allocs / (double)params.nof_ttis;
+  r.nof_failed_dcis = nof_failed;
+  run_results.push_back(r);
+
+  return SRSRAN_SUCCESS;
+}
+
+void print_benchmark_results(const std::vector<run_data>& run_results)
+{
+  srslog::flush();
+  fmt::print("run | Nprb | nof UEs | DFS limit | avg latency | max latency | DCIs per TTI | failed DCIs\n");
+  for (uint32_t i = 0; i < run_results.size(); ++i) {
+    const run_data& r = run_results[i];
+    fmt::print("{:>3d}{:>6d}{:>10d}{:>12d}{:>12.2f}us{:>12.2f}us{:>15.2f}{:>14d}\n",
+               i,
+               r.params.nof_prbs,
+               r.params.nof_ues,
+               r.params.max_dfs_nodes,
+               r.avg_latency_us,
+               r.max_latency_us,
+               r.avg_nof_allocs,
+               r.nof_failed_dcis);
+  }
+}
+
+/// Largest number of UEs for which the exhaustive DFS is benchmarked, as its runtime grows exponentially with the DCIs
+const uint32_t max_exhaustive_nof_ues = 8;
+
+/// Runs the same scenarios with the exhaustive DFS and with the default limit of backtracking steps
+int run_scenarios(const std::vector<uint32_t>& nof_prbs, const std::vector<uint32_t>& nof_ues, uint32_t nof_ttis)
+{
+  std::vector<run_data> run_results;
+  for (uint32_t prbs : nof_prbs) {
+    for (uint32_t ues : nof_ues) {
+      for (uint32_t max_dfs_nodes : {0U, sf_cch_allocator::default_max_dfs_nodes}) {
+        if (max_dfs_nodes == 0 and ues > max_exhaustive_nof_ues) {
+          continue;
+        }
+        run_params params    = {};
+        params.nof_prbs      = prbs;
+        params.nof_ues       = ues;
+        params.nof_ttis      = nof_ttis;
+        params.max_dfs_nodes = max_dfs_nodes;
+        TESTASSERT(run_benchmark_scenario(params, run_results) == SRSRAN_SUCCESS);
+      }
+    }
+  }
+
+  print_benchmark_results(run_results);
+
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsenb
+
+int main(int argc, char* argv[])
+{
+  auto& mac_log = srslog::fetch_basic_logger("MAC");
+  mac_log.set_level(srslog::basic_levels::warning);
+
+  // Start the log backend.
+  srslog::init();
+
+  if (argc == 1 or strcmp(argv[1], "test") == 0) {
+    // Short run for ctest, it checks the allocations of both search modes
+    TESTASSERT(srsenb::run_scenarios({15}, {4, 8}, 10) == SRSRAN_SUCCESS);
+  } else if (strcmp(argv[1], "benchmark") == 0) {
+    TESTASSERT(srsenb::run_scenarios({15, 25}, {4, 8}, 100) == SRSRAN_SUCCESS);
+  } else {
+    TESTASSERT(srsenb::run_scenarios({15, 25, 50, 100}, {4, 8, 16, 32}, 200) == SRSRAN_SUCCESS);
+  }
+
+  return 0;
+}
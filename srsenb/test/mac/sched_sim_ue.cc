@@ -46,6 +46,33 @@ bool sim_ue_ctxt_t::is_last_dl_retx(uint32_t ue_cc_idx, uint32_t pid) const
   return h.nof_retxs + 1 >= ue_cfg.maxharq_tx;
 }
 
+bool sim_ue_ctxt_t::is_ul_sps_occasion(const sched_interface::ul_sched_data_t& pusch, srsran::tti_point tti_rx) const
+{
+  uint32_t interval = ue_cfg.ul_sps_cfg.interval_ms;
+  return ul_sps_tti_rx.is_valid() and interval > 0 and pusch.dci.ue_cc_idx == 0 and not pusch.needs_pdcch and
+         (tti_rx.to_uint() + 10240 - ul_sps_tti_rx.to_uint()) % interval == 0;
+}
+
+/// Checks whether the UE considers the PUSCH grant a new tx. See TS 36.321, 5.4.1
+bool sim_ue_ctxt_t::is_ul_newtx(const sched_interface::ul_sched_data_t& pusch, srsran::tti_point tti_rx) const
+{
+  uint32_t pid = to_tx_ul(tti_rx).to_uint() % (FDD_HARQ_DELAY_UL_MS + FDD_HARQ_DELAY_DL_MS);
+  auto&    h   = cc_list.at(pusch.dci.ue_cc_idx).ul_harqs[pid];
+  if (pusch.needs_pdcch and pusch.sps_crnti != SRSRAN_INVALID_RNTI) {
+    // SPS C-RNTI DCIs are activations if NDI=0 and retxs otherwise
+    return not pusch.dci.tb.ndi;
+  }
+  if (is_ul_sps_occasion(pusch, tti_rx)) {
+    // NDI is considered toggled in the SPS occasions
+    return true;
+  }
+  if (h.is_sps and pusch.needs_pdcch) {
+    // C-RNTI grants for HARQs last used by SPS are new txs
+    return true;
+  }
+  return h.nof_txs == 0 or (not h.is_sps and h.ndi != pusch.dci.tb.ndi);
+}
+
 ue_sim::ue_sim(uint16_t                         rnti_,
                const sched_interface::ue_cfg_t& ue_cfg_,
                srsran::tti_point                prach_tti_rx_,
@@ -60,6 +87,12 @@ ue_sim::ue_sim(uint16_t                         rnti_,
 
 void ue_sim::set_cfg(const sched_interface::ue_cfg_t& ue_cfg_)
 {
+  const auto &prev_sps = ctxt.ue_cfg.ul_sps_cfg, &next_sps = ue_cfg_.ul_sps_cfg;
+  if (prev_sps.sps_crnti != next_sps.sps_crnti or prev_sps.interval_ms != next_sps.interval_ms or
+      prev_sps.implicit_release_after != next_sps.implicit_release_after or prev_sps.lcg != next_sps.lcg) {
+    // SPS reconfigurations clear the SPS grant
+    ctxt.ul_sps_tti_rx = {};
+  }
   ctxt.ue_cfg = ue_cfg_;
   ctxt.cc_list.resize(ue_cfg_.supported_cc_list.size());
   for (auto& cc : ctxt.cc_list) {
@@ -145,6 +178,13 @@ void ue_sim::update_ul_harqs(const sf_output_res_t& sf_out)
       h.active = false;
     }
 
+    // Update UL SPS state with release DCIs
+    for (uint32_t i = 0; i < sf_out.ul_cc_result[cc].sps_release.size(); ++i) {
+      if (ue_cc_idx == 0 and sf_out.ul_cc_result[cc].sps_release[i].dci.rnti == ctxt.rnti) {
+        ctxt.ul_sps_tti_rx = {};
+      }
+    }
+
     // Update UL harqs with PUSCH grants
     bool pusch_found = false;
     for (uint32_t i = 0; i < sf_out.ul_cc_result[cc].pusch.size(); ++i) {
@@ -154,8 +194,13 @@ void ue_sim::update_ul_harqs(const sf_output_res_t& sf_out)
       }
       pusch_found = true;
 
-      if (h.nof_txs == 0 or h.ndi != data.dci.tb.ndi) {
+      if (ctxt.is_ul_newtx(data, sf_out.tti_rx)) {
         // newtx
+        h.is_sps = data.sps_crnti != SRSRAN_INVALID_RNTI or ctxt.is_ul_sps_occasion(data, sf_out.tti_rx);
+        if (data.needs_pdcch and data.sps_crnti != SRSRAN_INVALID_RNTI) {
+          // SPS activation
+          ctxt.ul_sps_tti_rx = sf_out.tti_rx;
+        }
         h.nof_retxs    = 0;
         h.ndi          = data.dci.tb.ndi;
         h.first_tti_rx = sf_out.tti_rx;
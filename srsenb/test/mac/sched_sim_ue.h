@@ -33,6 +33,7 @@ namespace srsenb {
 struct ue_harq_ctxt_t {
   bool                  active    = false;
   bool                  ndi       = false;
+  bool                  is_sps    = false;
   uint32_t              pid       = 0;
   uint32_t              nof_txs   = 0;
   uint32_t              nof_retxs = std::numeric_limits<uint32_t>::max();
@@ -52,12 +53,15 @@ struct sim_ue_ctxt_t {
   srsran::tti_point         prach_tti_rx, rar_tti_rx, msg3_tti_rx, msg4_tti_rx;
   sched_interface::ue_cfg_t ue_cfg;
   std::vector<ue_cc_ctxt_t> cc_list;
+  srsran::tti_point         ul_sps_tti_rx; ///< tti_rx of the UL SPS activation. Invalid if UL SPS is not active
 
   const sched_interface::ue_cfg_t::cc_cfg_t* get_cc_cfg(uint32_t enb_cc_idx) const;
   int                                        enb_to_ue_cc_idx(uint32_t enb_cc_idx) const;
   bool                                       is_msg3_harq(uint32_t ue_cc_idx, uint32_t pid) const;
   bool is_last_ul_retx(uint32_t ue_cc_idx, uint32_t pid, uint32_t maxharq_msg3tx) const;
   bool is_last_dl_retx(uint32_t ue_cc_idx, uint32_t pid) const;
+  bool is_ul_sps_occasion(const sched_interface::ul_sched_data_t& pusch, srsran::tti_point tti_rx) const;
+  bool is_ul_newtx(const sched_interface::ul_sched_data_t& pusch, srsran::tti_point tti_rx) const;
 };
 
 struct sim_enb_ctxt_t {
@@ -0,0 +1,270 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "sched_test_common.h"
+#include "sched_test_utils.h"
+#include "srsenb/hdr/stack/mac/sched_ue_ctrl/sched_ul_sps.h"
+#include "srsran/common/test_common.h"
+
+using namespace srsenb;
+const uint32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+
+sched_ul_sps::sps_cfg_t generate_sps_cfg(uint16_t sps_crnti, uint32_t interval_ms)
+{
+  sched_ul_sps::sps_cfg_t cfg;
+  cfg.sps_crnti              = sps_crnti;
+  cfg.interval_ms            = interval_ms;
+  cfg.implicit_release_after = 2;
+  cfg.lcg                    = 1;
+  return cfg;
+}
+
+/// The SPS occasions repeat every SPS interval from the activation, also across the TTI wrap-around
+int test_ul_sps_occasions()
+{
+  sched_ul_sps sps(0x46);
+  TESTASSERT(not sps.is_configured() and not sps.is_active());
+
+  sps.set_cfg(generate_sps_cfg(0xF046, 20));
+  TESTASSERT(sps.is_configured() and not sps.is_active());
+  TESTASSERT(not sps.is_occasion(tti_point{10230}));
+
+  sps.activate(tti_point{10230}, prb_interval{40, 44}, 10);
+  TESTASSERT(sps.is_active());
+  TESTASSERT(sps.get_alloc() == prb_interval(40, 44));
+  TESTASSERT(sps.get_mcs() == 10);
+  TESTASSERT(sps.get_sps_crnti() == 0xF046);
+  for (uint32_t i = 0; i < 100; ++i) {
+    tti_point tti{10230 + i};
+    TESTASSERT(sps.is_occasion(tti) == (i % 20 == 0));
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+/// Consecutive CRC failures in the SPS occasions trigger a release DCI. The occasions are kept until it is sent
+int test_ul_sps_crc_release()
+{
+  sched_ul_sps sps(0x46);
+  sps.set_cfg(generate_sps_cfg(0xF046, 10));
+  sps.activate(tti_point{0}, prb_interval{0, 2}, 5);
+
+  // CRC results outside of the occasions and interleaved CRC successes do not count
+  uint32_t  nof_occasions = 0;
+  tti_point tti{0};
+  for (; nof_occasions < 2 * sched_ul_sps::max_crc_failures; ++tti) {
+    if (sps.is_occasion(tti)) {
+      sps.set_ul_crc(tti, nof_occasions % sched_ul_sps::max_crc_failures == sched_ul_sps::max_crc_failures - 1);
+      nof_occasions++;
+    } else {
+      sps.set_ul_crc(tti, false);
+    }
+  }
+  TESTASSERT(sps.is_active() and not sps.is_release_pending());
+
+  for (uint32_t i = 0; i < sched_ul_sps::max_crc_failures; ++tti) {
+    if (sps.is_occasion(tti)) {
+      TESTASSERT(not sps.is_release_pending());
+      sps.set_ul_crc(tti, false);
+      i++;
+    }
+  }
+  TESTASSERT(sps.is_release_pending());
+  TESTASSERT(sps.is_active());
+  TESTASSERT(sps.get_sps_crnti() == 0xF046);
+
+  sps.release_sent();
+  TESTASSERT(not sps.is_release_pending());
+  TESTASSERT(not sps.is_active());
+  TESTASSERT(sps.is_configured());
+
+  return SRSRAN_SUCCESS;
+}
+
+/// The UE releases the SPS grant after "implicitReleaseAfter" consecutive empty MAC PDUs in the SPS occasions
+int test_ul_sps_implicit_release()
+{
+  sched_ul_sps sps(0x46);
+  sps.set_cfg(generate_sps_cfg(0xF046, 20));
+  sps.activate(tti_point{5}, prb_interval{0, 2}, 5);
+
+  sps.set_ul_pdu(tti_point{25}, 0);
+  sps.set_ul_pdu(tti_point{26}, 0); // not an occasion
+  sps.set_ul_pdu(tti_point{45}, 1);
+  sps.set_ul_pdu(tti_point{65}, 0);
+  TESTASSERT(sps.is_active());
+  sps.set_ul_pdu(tti_point{85}, 0);
+  TESTASSERT(not sps.is_active());
+  TESTASSERT(not sps.is_release_pending());
+
+  return SRSRAN_SUCCESS;
+}
+
+/// Any change of the SPS configuration deactivates the SPS grant
+int test_ul_sps_reconf()
+{
+  sched_ul_sps sps(0x46);
+  sps.set_cfg(generate_sps_cfg(0xF046, 20));
+  sps.activate(tti_point{0}, prb_interval{0, 2}, 5);
+
+  sps.set_cfg(generate_sps_cfg(0xF046, 20));
+  TESTASSERT(sps.is_active());
+
+  sps.set_cfg(generate_sps_cfg(0xF046, 40));
+  TESTASSERT(not sps.is_active());
+  TESTASSERT(sps.is_configured());
+
+  sps.activate(tti_point{0}, prb_interval{0, 2}, 5);
+  sps.set_cfg({});
+  TESTASSERT(not sps.is_active());
+  TESTASSERT(not sps.is_configured());
+
+  return SRSRAN_SUCCESS;
+}
+
+/**
+ * Test scenario where a UE is configured with UL SPS after the RA procedure, and has UL data.
+ * - The SPS grant is activated with a DCI scrambled with the SPS C-RNTI and NDI=0
+ * - The SPS occasions repeat every SPS interval in the PRBs of the activation, without PDCCH
+ * - The SPS occasions stop once the SPS configuration is removed
+ */
+int test_ul_sps_scenario()
+{
+  const uint16_t rnti1       = 70;
+  const uint16_t sps_crnti   = 0xF046;
+  const uint32_t interval_ms = 20;
+
+  sim_sched_args sim_args;
+  sim_args.cell_cfg                            = {generate_default_cell_cfg(25)};
+  sim_args.default_ue_sim_cfg.ue_cfg           = generate_default_ue_cfg();
+  sim_args.default_ue_sim_cfg.prob_ul_ack_mask = {1};
+
+  sched_sim_event_generator generator;
+  common_sched_tester       tester;
+  TESTASSERT(tester.sim_cfg(sim_args) == SRSRAN_SUCCESS);
+
+  // Event: PRACH, RA procedure and Msg4
+  generator.step_until(1);
+  tti_ev::user_cfg_ev* user = generator.add_new_default_user(2000, sim_args.default_ue_sim_cfg);
+  user->rnti                = rnti1;
+  TESTASSERT(tester.test_next_ttis(generator.tti_events) == SRSRAN_SUCCESS);
+  while (not tester.sched_sim->find_rnti(rnti1)->get_ctxt().msg3_tti_rx.is_valid() or
+         to_tx_ul(tester.sched_sim->find_rnti(rnti1)->get_ctxt().msg3_tti_rx).to_uint() > generator.tti_counter) {
+    generator.step_tti();
+    TESTASSERT(tester.test_next_ttis(generator.tti_events) == SRSRAN_SUCCESS);
+  }
+  generator.step_tti();
+  generator.add_dl_data(rnti1, 40);
+  TESTASSERT(tester.test_next_ttis(generator.tti_events) == SRSRAN_SUCCESS);
+  while (not tester.sched_sim->find_rnti(rnti1)->get_ctxt().conres_rx) {
+    generator.step_tti();
+    TESTASSERT(tester.test_next_ttis(generator.tti_events) == SRSRAN_SUCCESS);
+  }
+
+  // Event: Reconf Complete. UL SPS is configured, and there is no UL data yet
+  generator.step_tti();
+  user                                            = generator.user_reconf(rnti1);
+  user->ue_sim_cfg->ue_cfg                        = *tester.get_current_ue_cfg(rnti1);
+  user->ue_sim_cfg->ue_cfg.ul_sps_cfg.sps_crnti   = sps_crnti;
+  user->ue_sim_cfg->ue_cfg.ul_sps_cfg.interval_ms = interval_ms;
+  user->ue_sim_cfg->ue_cfg.ul_sps_cfg.lcg         = 1;
+  TESTASSERT(tester.test_next_ttis(generator.tti_events) == SRSRAN_SUCCESS);
+
+  // Event: UL data in every TTI. The SPS grant is activated, and then used in every SPS occasion
+  tti_point activation_tti;
+  uint32_t  activation_riv = 0, nof_occasions = 0;
+  for (uint32_t i = 0; i < 10 * interval_ms; ++i) {
+    generator.step_tti();
+    generator.add_ul_data(rnti1, 100);
+    TESTASSERT(tester.test_next_ttis(generator.tti_events) == SRSRAN_SUCCESS);
+
+    const auto& ul_res = tester.tti_info.ul_sched_result[0];
+    TESTASSERT(ul_res.sps_release.empty());
+    for (const auto& pusch : ul_res.pusch) {
+      if (pusch.dci.rnti != rnti1) {
+        continue;
+      }
+      if (pusch.needs_pdcch and pusch.sps_crnti != SRSRAN_INVALID_RNTI) {
+        // SPS activation
+        TESTASSERT(not activation_tti.is_valid());
+        TESTASSERT(pusch.sps_crnti == sps_crnti);
+        TESTASSERT(pusch.needs_pdcch and not pusch.dci.tb.ndi);
+        TESTASSERT(pusch.dci.tb.mcs_idx <= (int)sched_ul_sps::max_mcs);
+        activation_tti = tester.tti_rx;
+        activation_riv = pusch.dci.type2_alloc.riv;
+      } else if (not pusch.needs_pdcch) {
+        // SPS occasion
+        TESTASSERT(activation_tti.is_valid());
+        TESTASSERT((tester.tti_rx - activation_tti) % interval_ms == 0);
+        TESTASSERT(pusch.dci.type2_alloc.riv == activation_riv);
+        TESTASSERT(pusch.sps_crnti == sps_crnti);
+        nof_occasions++;
+      }
+    }
+    if (activation_tti.is_valid() and (tester.tti_rx - activation_tti) % interval_ms == 0) {
+      TESTASSERT(ul_res.pusch.size() == 1 and ul_res.pusch[0].dci.rnti == rnti1);
+    }
+  }
+  TESTASSERT(activation_tti.is_valid());
+  TESTASSERT(nof_occasions >= 8);
+
+  // Event: UL SPS is removed. There are no more SPS occasions or SPS activations
+  generator.step_tti();
+  user                                = generator.user_reconf(rnti1);
+  user->ue_sim_cfg->ue_cfg            = *tester.get_current_ue_cfg(rnti1);
+  user->ue_sim_cfg->ue_cfg.ul_sps_cfg = {};
+  TESTASSERT(tester.test_next_ttis(generator.tti_events) == SRSRAN_SUCCESS);
+  for (uint32_t i = 0; i < 4 * interval_ms; ++i) {
+    generator.step_tti();
+    generator.add_ul_data(rnti1, 100);
+    TESTASSERT(tester.test_next_ttis(generator.tti_events) == SRSRAN_SUCCESS);
+    for (const auto& pusch : tester.tti_info.ul_sched_result[0].pusch) {
+      TESTASSERT(pusch.needs_pdcch and pusch.sps_crnti == SRSRAN_INVALID_RNTI);
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+int main()
+{
+  srsenb::set_randseed(seed);
+  srsran::console("This is the chosen seed: %u\n", seed);
+
+  auto& mac_log = srslog::fetch_basic_logger("MAC");
+  mac_log.set_level(srslog::basic_levels::info);
+  auto& test_log = srslog::fetch_basic_logger("TEST", false);
+  test_log.set_level(srslog::basic_levels::info);
+
+  // Start the log backend.
+  srslog::init();
+
+  TESTASSERT(test_ul_sps_occasions() == SRSRAN_SUCCESS);
+  TESTASSERT(test_ul_sps_crc_release() == SRSRAN_SUCCESS);
+  TESTASSERT(test_ul_sps_implicit_release() == SRSRAN_SUCCESS);
+  TESTASSERT(test_ul_sps_reconf() == SRSRAN_SUCCESS);
+  TESTASSERT(test_ul_sps_scenario() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+
+  srsran::console("Success\n");
+  return SRSRAN_SUCCESS;
+}
@@ -230,15 +230,18 @@ int test_ul_sched_result(const sim_enb_ctxt_t& enb_ctxt, const sf_output_res_t&
         CONDERROR(pusch_ptr->dci.ue_cc_idx != (uint32_t)ue_cc_idx, "Inconsistent enb_cc_idx -> ue_cc_idx mapping");
 
         // TEST: DCI is consistent with current UE UL harq state
-        uint32_t nof_retx = get_nof_retx(pusch_ptr->dci.tb.rv); // 0..3
+        uint32_t nof_retx     = get_nof_retx(pusch_ptr->dci.tb.rv); // 0..3
+        bool     sps_occasion = ue.is_ul_sps_occasion(*pusch_ptr, sf_out.tti_rx);
 
-        if (h.nof_txs == 0 or h.ndi != pusch_ptr->dci.tb.ndi) {
+        if (ue.is_ul_newtx(*pusch_ptr, sf_out.tti_rx)) {
           // newtx
           CONDERROR(nof_retx != 0, "Invalid rv index for new UL tx");
           CONDERROR(pusch_ptr->current_tx_nb != 0, "UL HARQ retxs need to have been previously transmitted");
-          CONDERROR(not h_cleared, "New tx for already active UL HARQ");
-          CONDERROR(not pusch_ptr->needs_pdcch and ue.msg3_tti_rx.is_valid() and sf_out.tti_rx > ue.msg3_tti_rx,
-                    "In case of newtx, PDCCH allocation is required, unless it is Msg3");
+          // SPS occasions override the pending retxs of their HARQ
+          CONDERROR(not h_cleared and not sps_occasion, "New tx for already active UL HARQ");
+          CONDERROR(not pusch_ptr->needs_pdcch and not sps_occasion and ue.msg3_tti_rx.is_valid() and
+                        sf_out.tti_rx > ue.msg3_tti_rx,
+                    "In case of newtx, PDCCH allocation is required, unless it is Msg3 or an SPS occasion");
         } else {
           CONDERROR(pusch_ptr->current_tx_nb == 0, "UL retx has to have nof tx > 0");
           CONDERROR(h.nof_retxs >= max_nof_retxs, "UL max nof retxs exceeded");
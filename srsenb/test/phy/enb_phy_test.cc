@@ -37,6 +37,45 @@ static inline bool dl_ack_value(uint32_t ue_cc_idx, uint32_t tti)
   return (tti % SRSRAN_MAX_CARRIERS) != ue_cc_idx;
 }
 
+/// The PCell UL SPS occasions are offset from the SR subframes
+static inline bool is_ul_sps_occasion(uint32_t tti, uint32_t interval)
+{
+  return interval > 0 and (tti % interval) == (5 % interval);
+}
+
+/// RIV of the largest UL allocation with a valid DFT size, starting at the second PRB
+static inline uint32_t ul_grant_riv(uint32_t nof_prb)
+{
+  uint32_t riv   = 0;
+  uint32_t L_prb = nof_prb - 2;
+  do {
+    if (srsran_dft_precoding_valid_prb(L_prb)) {
+      riv = srsran_ra_type2_to_riv(L_prb, 1, nof_prb);
+    } else {
+      L_prb--;
+    }
+  } while (riv == 0);
+  return riv;
+}
+
+/// UL DCI of the dynamic grants, the UL SPS occasions reuse it as activated grant
+static inline void fill_ul_dci(srsran_dci_ul_t& dci, uint16_t rnti, uint32_t riv)
+{
+  dci.rnti                = rnti;
+  dci.format              = SRSRAN_DCI_FORMAT0;
+  dci.type2_alloc.riv     = riv;
+  dci.type2_alloc.n_prb1a = srsran_ra_type2_t::SRSRAN_RA_TYPE2_NPRB1A_2;
+  dci.type2_alloc.n_gap   = srsran_ra_type2_t::SRSRAN_RA_TYPE2_NG1;
+  dci.type2_alloc.mode    = srsran_ra_type2_t::SRSRAN_RA_TYPE2_LOC;
+  dci.freq_hop_fl         = srsran_dci_ul_t::SRSRAN_RA_PUSCH_HOP_DISABLED;
+  dci.tb.mcs_idx          = 20; // Can't set it too high for grants with CQI and long ACK/NACK
+  dci.tb.rv               = 0;
+  dci.tb.ndi              = false;
+  dci.tb.cw_idx           = 0;
+  dci.n_dmrs              = 0;
+  dci.cqi_request         = false;
+}
+
 #define CALLBACK(NAME)                                                                                                 \
 private:                                                                                                               \
   bool received_##NAME = false;                                                                                        \
@@ -285,6 +324,8 @@ private:
   srsran_softbuffer_rx_t                            softbuffer_rx[SRSRAN_MAX_CARRIERS][SRSRAN_FDD_NOF_HARQ] = {};
   uint8_t*                                          data                                                    = nullptr;
   uint16_t                                          ue_rnti                                                 = 0;
+  uint16_t                                          sps_crnti                                               = 0;
+  uint32_t                                          ul_sps_interval                                         = 0;
   srsran_random_t                                   random_gen                                              = nullptr;
 
   CALLBACK(sr_detected);
@@ -344,9 +385,13 @@ public:
   explicit dummy_stack(const srsenb::phy_cfg_t&                                 phy_cfg_,
                        const srsenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t& phy_rrc_,
                        const std::string&                                       log_level,
-                       uint16_t                                                 rnti_) :
+                       uint16_t                                                 rnti_,
+                       uint16_t                                                 sps_crnti_,
+                       uint32_t                                                 ul_sps_interval_) :
     logger(srslog::fetch_basic_logger("STACK", false)),
     ue_rnti(rnti_),
+    sps_crnti(sps_crnti_),
+    ul_sps_interval(ul_sps_interval_),
     random_gen(srsran_random_init(rnti_)),
     phy_cell_cfg(phy_cfg_.phy_cell_cfg),
     phy_rrc(phy_rrc_)
@@ -387,14 +432,7 @@ public:
     srsran_regs_free(&regs);
 
     // Find a valid UL DCI RIV
-    uint32_t L_prb = phy_cell_cfg[0].cell.nof_prb - 2;
-    do {
-      if (srsran_dft_precoding_valid_prb(L_prb)) {
-        ul_riv = srsran_ra_type2_to_riv(L_prb, 1, phy_cell_cfg[0].cell.nof_prb);
-      } else {
-        L_prb--;
-      }
-    } while (ul_riv == 0);
+    ul_riv = ul_grant_riv(phy_cell_cfg[0].cell.nof_prb);
 
     data = srsran_vec_u8_malloc(150000);
     memset(data, 0, 150000);
@@ -673,33 +711,27 @@ public:
       // Avoid giving grants when SR is expected
       sched &= (tti % 20 != 0);
 
+      // The PCell UL SPS occasions replace the dynamic grants, they have no PDCCH and use the SPS C-RNTI
+      bool sps_occasion = not active_cell_list.empty() and scell_idx == 0 and is_ul_sps_occasion(tti, ul_sps_interval);
+
       // Schedule grant
-      if (sched) {
-        uint32_t              tti_pdcch    = TTI_SUB(tti, FDD_HARQ_DELAY_DL_MS);
-        uint32_t              location_idx = (tti_pdcch + 1) % nof_locations[tti_pdcch % SRSRAN_NOF_SF_X_FRAME];
-        srsran_dci_location_t location     = dci_locations[tti_pdcch % SRSRAN_NOF_SF_X_FRAME][location_idx];
-
-        ul_sched.nof_grants                       = 1;
-        ul_sched.pusch[0]                         = {};
-        ul_sched.pusch[0].dci.rnti                = ue_rnti;
-        ul_sched.pusch[0].dci.format              = SRSRAN_DCI_FORMAT0;
-        ul_sched.pusch[0].dci.location            = location;
-        ul_sched.pusch[0].dci.type2_alloc.riv     = ul_riv;
-        ul_sched.pusch[0].dci.type2_alloc.n_prb1a = srsran_ra_type2_t::SRSRAN_RA_TYPE2_NPRB1A_2;
-        ul_sched.pusch[0].dci.type2_alloc.n_gap   = srsran_ra_type2_t::SRSRAN_RA_TYPE2_NG1;
-        ul_sched.pusch[0].dci.type2_alloc.mode    = srsran_ra_type2_t::SRSRAN_RA_TYPE2_LOC;
-        ul_sched.pusch[0].dci.freq_hop_fl         = srsran_dci_ul_t::SRSRAN_RA_PUSCH_HOP_DISABLED;
-        ul_sched.pusch[0].dci.tb.mcs_idx          = 20; // Can't set it too high for grants with CQI and long ACK/NACK
-        ul_sched.pusch[0].dci.tb.rv               = 0;
-        ul_sched.pusch[0].dci.tb.ndi              = false;
-        ul_sched.pusch[0].dci.tb.cw_idx           = 0;
-        ul_sched.pusch[0].dci.n_dmrs              = 0;
-        ul_sched.pusch[0].dci.cqi_request         = false;
-        ul_sched.pusch[0].data                    = data;
-
-        ul_sched.pusch[0].needs_pdcch   = true;
+      if (sched or sps_occasion) {
+        ul_sched.nof_grants = 1;
+        ul_sched.pusch[0]   = {};
+        fill_ul_dci(ul_sched.pusch[0].dci, ue_rnti, ul_riv);
+        ul_sched.pusch[0].data          = data;
         ul_sched.pusch[0].softbuffer_rx = &softbuffer_rx[scell_idx][tti % SRSRAN_FDD_NOF_HARQ];
 
+        if (sps_occasion) {
+          ul_sched.pusch[0].needs_pdcch = false;
+          ul_sched.pusch[0].sps_crnti   = sps_crnti;
+        } else {
+          uint32_t tti_pdcch             = TTI_SUB(tti, FDD_HARQ_DELAY_DL_MS);
+          uint32_t location_idx          = (tti_pdcch + 1) % nof_locations[tti_pdcch % SRSRAN_NOF_SF_X_FRAME];
+          ul_sched.pusch[0].dci.location = dci_locations[tti_pdcch % SRSRAN_NOF_SF_X_FRAME][location_idx];
+          ul_sched.pusch[0].needs_pdcch  = true;
+        }
+
         // Reset Rx softbuffer
         srsran_softbuffer_rx_reset(ul_sched.pusch[0].softbuffer_rx);
 
@@ -795,29 +827,40 @@ typedef std::unique_ptr<dummy_stack> unique_dummy_stack_t;
 class dummy_ue
 {
 private:
-  std::vector<srsran_ue_dl_t*>                      ue_dl_v       = {};
-  std::vector<srsran_ue_ul_t*>                      ue_ul_v       = {};
-  std::vector<cf_t*>                                buffers       = {};
-  dummy_radio*                                      radio         = nullptr;
-  uint32_t                                          sf_len        = 0;
-  uint32_t                                          nof_ports     = 0;
-  uint16_t                                          rnti          = 0;
-  srsran_dl_sf_cfg_t                                sf_dl_cfg     = {};
-  srsran_ul_sf_cfg_t                                sf_ul_cfg     = {};
-  srsran_softbuffer_tx_t                            softbuffer_tx = {};
-  uint8_t*                                          tx_data       = nullptr;
-  srsenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t phy_rrc_cfg   = {};
+  std::vector<srsran_ue_dl_t*>                      ue_dl_v         = {};
+  std::vector<srsran_ue_ul_t*>                      ue_ul_v         = {};
+  std::vector<cf_t*>                                buffers         = {};
+  dummy_radio*                                      radio           = nullptr;
+  uint32_t                                          sf_len          = 0;
+  uint32_t                                          nof_ports       = 0;
+  uint16_t                                          rnti            = 0;
+  uint16_t                                          sps_crnti       = 0;
+  uint32_t                                          ul_sps_interval = 0;
+  uint32_t                                          ul_riv          = 0;
+  srsran_dl_sf_cfg_t                                sf_dl_cfg       = {};
+  srsran_ul_sf_cfg_t                                sf_ul_cfg       = {};
+  srsran_softbuffer_tx_t                            softbuffer_tx   = {};
+  uint8_t*                                          tx_data         = nullptr;
+  srsenb::phy_interface_rrc_lte::phy_rrc_cfg_list_t phy_rrc_cfg     = {};
   srslog::basic_logger&                             logger;
   std::map<uint32_t, uint32_t>                      last_ri = {};
 
 public:
-  dummy_ue(dummy_radio* _radio, const srsenb::phy_cell_cfg_list_t& cell_list, std::string log_level, uint16_t rnti_) :
+  dummy_ue(dummy_radio*                       _radio,
+           const srsenb::phy_cell_cfg_list_t& cell_list,
+           std::string                        log_level,
+           uint16_t                           rnti_,
+           uint16_t                           sps_crnti_,
+           uint32_t                           ul_sps_interval_) :
     radio(_radio), logger(srslog::fetch_basic_logger("UPHY"))
   {
     // Calculate subframe length
-    nof_ports = cell_list[0].cell.nof_ports;
-    sf_len    = static_cast<uint32_t>(SRSRAN_SF_LEN_PRB(cell_list[0].cell.nof_prb));
-    rnti      = rnti_;
+    nof_ports       = cell_list[0].cell.nof_ports;
+    sf_len          = static_cast<uint32_t>(SRSRAN_SF_LEN_PRB(cell_list[0].cell.nof_prb));
+    rnti            = rnti_;
+    sps_crnti       = sps_crnti_;
+    ul_sps_interval = ul_sps_interval_;
+    ul_riv          = ul_grant_riv(cell_list[0].cell.nof_prb);
 
     logger.set_level(srslog::str_to_basic_level(log_level));
 
@@ -1070,6 +1113,14 @@ public:
       int nof_ul_grants = srsran_ue_dl_find_ul_dci(ue_dl_v[cc_idx], &sf_dl_cfg, &ue_dl_cfg, rnti, dci_ul);
       TESTASSERT(nof_ul_grants >= SRSRAN_SUCCESS);
 
+      // The PCell UL SPS occasions reuse the activated grant and scramble the PUSCH with the SPS C-RNTI
+      if (i == 0 and is_ul_sps_occasion(sf_ul_cfg.tti, ul_sps_interval)) {
+        TESTASSERT(nof_ul_grants == 0);
+        fill_ul_dci(dci_ul[0], rnti, ul_riv);
+        ue_ul_cfg.ul_cfg.pusch.rnti = sps_crnti;
+        nof_ul_grants               = 1;
+      }
+
       srsran_pusch_data_t pusch_data = {};
       pusch_data.ptr                 = tx_data;
 
@@ -1164,6 +1215,8 @@ class phy_test_bench : public srsenb::enb_time_interface
 public:
   struct args_t {
     uint16_t              rnti                = 0x1234;
+    uint16_t              sps_crnti           = 0xF046;
+    uint32_t              ul_sps_interval     = 0;
     uint32_t              duration            = 10240;
     uint32_t              nof_enb_cells       = 1;
     srsran_cell_t         cell                = {};
@@ -1333,7 +1386,8 @@ public:
         new dummy_radio(args.nof_enb_cells * args.cell.nof_ports, args.cell.nof_prb, args.log_level));
 
     /// Create Dummy Stack instance
-    stack = unique_dummy_stack_t(new dummy_stack(phy_cfg, phy_rrc_cfg, args.log_level, args.rnti));
+    stack = unique_dummy_stack_t(
+        new dummy_stack(phy_cfg, phy_rrc_cfg, args.log_level, args.rnti, args.sps_crnti, args.ul_sps_interval));
     stack->set_active_cell_list(args.ue_cell_list);
 
     /// Initiate eNb PHY with the given RNTI
@@ -1345,7 +1399,8 @@ public:
     enb_phy->set_activation_deactivation_scell(args.rnti, activation);
 
     /// Create dummy UE instance
-    ue_phy = unique_dummy_ue_phy_t(new dummy_ue(radio.get(), phy_cfg.phy_cell_cfg, args.log_level, args.rnti));
+    ue_phy = unique_dummy_ue_phy_t(new dummy_ue(
+        radio.get(), phy_cfg.phy_cell_cfg, args.log_level, args.rnti, args.sps_crnti, args.ul_sps_interval));
 
     /// Configure UE with initial configuration
     ue_phy->reconfigure(phy_rrc_cfg);
@@ -1462,6 +1517,7 @@ int parse_args(int argc, char** argv, phy_test_bench::args_t& args)
       ("cell.cp",        bpo::value<bool>(&args.extended_cp)->default_value(false),                      "use extended CP")
       ("tm", bpo::value<uint32_t>(&args.tm_u32)->default_value(args.tm_u32),                             "Transmission mode")
       ("rotation", bpo::value<uint32_t>(&args.period_pcell_rotate),                      "Serving cells rotation period in ms, set to zero to disable")
+      ("ul_sps_interval", bpo::value<uint32_t>(&args.ul_sps_interval),                   "PCell UL SPS interval in ms, set to zero to disable")
       ;
   options.add(common).add_options()("help", "Show this message");
   // clang-format on
@@ -0,0 +1,259 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/common/rnti_pool.h"
+#include "srsenb/hdr/stack/upper/pdcp_rlc_shards.h"
+#include "srsran/common/test_common.h"
+#include "srsran/interfaces/enb_mac_interfaces.h"
+#include <chrono>
+#include <thread>
+
+namespace srsenb {
+
+const uint16_t first_rnti = 0x46;
+const uint32_t drb_lcid   = 3;
+const uint32_t sdu_size   = 1400;
+const uint32_t grant_size = 1500;
+
+struct run_params {
+  uint32_t nof_workers;
+  uint32_t nof_ues;
+  uint32_t nof_sdus; ///< SDUs per UE
+  uint32_t window;   ///< SDUs per UE in flight
+};
+
+struct run_data {
+  run_params params;
+  double     duration_ms;
+  double     throughput_mbps; ///< Throughput of the SDUs across the DL PDCP/RLC and back across the UL RLC/PDCP
+};
+
+class rrc_tester : public rrc_interface_pdcp, public rrc_interface_rlc
+{
+public:
+  void write_pdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t pdu) override {}
+  void notify_pdcp_integrity_error(uint16_t rnti, uint32_t lcid) override {}
+  void max_retx_attempted(uint16_t rnti) override {}
+  void protocol_failure(uint16_t rnti) override {}
+};
+
+class mac_tester : public mac_interface_rlc
+{
+public:
+  int rlc_buffer_state(uint16_t rnti, uint32_t lc_id, uint32_t tx_queue, uint32_t retx_queue) override { return 0; }
+};
+
+/// Checks that the SDUs of every UE are received once and in order. Runs in the stack thread
+class gtpu_tester : public gtpu_interface_pdcp
+{
+public:
+  explicit gtpu_tester(uint32_t nof_ues) : nof_rx_sdus(nof_ues, 0) {}
+
+  void write_pdu(uint16_t rnti, uint32_t lcid, srsran::unique_byte_buffer_t pdu) override
+  {
+    uint32_t ue_idx = rnti - first_rnti;
+    uint32_t count  = 0;
+    memcpy(&count, pdu->msg, sizeof(count));
+    if (ue_idx >= nof_rx_sdus.size() or lcid != drb_lcid or pdu->N_bytes != sdu_size or
+        count != nof_rx_sdus[ue_idx]) {
+      nof_errors++;
+      return;
+    }
+    nof_rx_sdus[ue_idx]++;
+    nof_rx_bytes += pdu->N_bytes;
+  }
+
+  std::vector<uint32_t> nof_rx_sdus;
+  uint64_t              nof_rx_bytes = 0;
+  uint32_t              nof_errors   = 0;
+};
+
+/**
+ * Sends DL SDUs through the sharded PDCP/RLC from the test thread, which plays the stack thread. A MAC thread reads
+ * the RLC PDUs and writes them back as UL PDUs. The PDCP bearers cipher both directions with the same keys, so the UL
+ * SDUs are equal to the DL SDUs
+ */
+int run_benchmark_scenario(run_params params, std::vector<run_data>& run_results)
+{
+  srsran::task_scheduler stack_task_sched;
+  rrc_tester             rrc;
+  mac_tester             mac;
+  gtpu_tester            gtpu(params.nof_ues);
+  pdcp_rlc_shards        shards(&stack_task_sched,
+                         srslog::fetch_basic_logger("STCK", false),
+                         srslog::fetch_basic_logger("PDCP", false),
+                         srslog::fetch_basic_logger("RLC", false));
+  shards.init(params.nof_workers, &rrc, &rrc, &gtpu, &mac);
+  shards.start(-1);
+
+  srsran::as_security_config_t sec_cfg = {};
+  for (uint32_t i = 0; i < sec_cfg.k_up_enc.size(); ++i) {
+    sec_cfg.k_up_enc[i] = i;
+  }
+  sec_cfg.integ_algo  = srsran::INTEGRITY_ALGORITHM_ID_EIA0;
+  sec_cfg.cipher_algo = srsran::CIPHERING_ALGORITHM_ID_128_EEA2;
+  srsran::pdcp_config_t pdcp_cfg{drb_lcid - 2,
+                                 srsran::PDCP_RB_IS_DRB,
+                                 srsran::SECURITY_DIRECTION_DOWNLINK,
+                                 srsran::SECURITY_DIRECTION_DOWNLINK,
+                                 srsran::PDCP_SN_LEN_12,
+                                 srsran::pdcp_t_reordering_t::ms500,
+                                 srsran::pdcp_discard_timer_t::infinity,
+                                 false,
+                                 srsran::srsran_rat_t::lte};
+  for (uint32_t i = 0; i < params.nof_ues; ++i) {
+    uint16_t rnti = first_rnti + i;
+    shards.rlc_rrc()->add_user(rnti);
+    shards.pdcp_rrc()->add_user(rnti);
+    shards.rlc_rrc()->add_bearer(rnti, drb_lcid, srsran::rlc_config_t::default_rlc_um_config());
+    shards.pdcp_rrc()->add_bearer(rnti, drb_lcid, pdcp_cfg);
+    shards.pdcp_rrc()->config_security(rnti, drb_lcid, sec_cfg);
+    shards.pdcp_rrc()->enable_encryption(rnti, drb_lcid);
+  }
+  TESTASSERT(shards.rlc_rrc()->has_bearer(first_rnti + params.nof_ues - 1, drb_lcid));
+
+  std::atomic<bool> mac_running{true};
+  std::thread       mac_thread([&shards, &mac_running, &params]() {
+    std::vector<uint8_t> pdu(grant_size);
+    while (mac_running.load(std::memory_order_relaxed)) {
+      bool pdu_found = false;
+      for (uint32_t i = 0; i < params.nof_ues; ++i) {
+        uint16_t rnti = first_rnti + i;
+        int      n    = shards.rlc_mac()->read_pdu(rnti, drb_lcid, pdu.data(), grant_size);
+        if (n > 0) {
+          shards.rlc_mac()->write_pdu(rnti, drb_lcid, pdu.data(), n);
+          pdu_found = true;
+        }
+      }
+      if (not pdu_found) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::vector<uint32_t> nof_tx_sdus(params.nof_ues, 0);
+  uint64_t              nof_sdus_total = (uint64_t)params.nof_ues * params.nof_sdus;
+  auto                  tp_start       = std::chrono::steady_clock::now();
+  auto                  tp_tti         = tp_start;
+  while (gtpu.nof_rx_bytes < nof_sdus_total * sdu_size and gtpu.nof_errors == 0) {
+    auto tp = std::chrono::steady_clock::now();
+    if (tp - tp_start > std::chrono::seconds(60)) {
+      break;
+    }
+    if (tp - tp_tti >= std::chrono::milliseconds(1)) {
+      tp_tti = tp;
+      shards.tti_clock();
+    }
+
+    bool sdu_sent = false;
+    for (uint32_t i = 0; i < params.nof_ues; ++i) {
+      while (nof_tx_sdus[i] < params.nof_sdus and nof_tx_sdus[i] - gtpu.nof_rx_sdus[i] < params.window) {
+        srsran::unique_byte_buffer_t sdu = srsran::make_byte_buffer();
+        if (sdu == nullptr) {
+          break;
+        }
+        sdu->N_bytes = sdu_size;
+        memset(sdu->msg, 0, sdu_size);
+        memcpy(sdu->msg, &nof_tx_sdus[i], sizeof(uint32_t));
+        shards.pdcp_gtpu()->write_sdu(first_rnti + i, drb_lcid, std::move(sdu));
+        nof_tx_sdus[i]++;
+        sdu_sent = true;
+      }
+    }
+    stack_task_sched.run_pending_tasks();
+    if (not sdu_sent) {
+      std::this_thread::yield();
+    }
+  }
+  auto tdur = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tp_start);
+
+  mac_running = false;
+  mac_thread.join();
+  shards.stop();
+
+  TESTASSERT(gtpu.nof_errors == 0);
+  TESTASSERT(gtpu.nof_rx_bytes == nof_sdus_total * sdu_size);
+
+  run_data r        = {};
+  r.params          = params;
+  r.duration_ms     = tdur.count() / 1000.0;
+  r.throughput_mbps = gtpu.nof_rx_bytes * 8 / (double)tdur.count();
+  run_results.push_back(r);
+
+  return SRSRAN_SUCCESS;
+}
+
+void print_benchmark_results(const std::vector<run_data>& run_results)
+{
+  srslog::flush();
+  fmt::print("run | nof workers | nof UEs | nof SDUs | duration | throughput\n");
+  for (uint32_t i = 0; i < run_results.size(); ++i) {
+    const run_data& r = run_results[i];
+    fmt::print("{:>3d}{:>14d}{:>10d}{:>11d}{:>9.1f}ms{:>8.1f}Mbps\n",
+               i,
+               r.params.nof_workers,
+               r.params.nof_ues,
+               r.params.nof_ues * r.params.nof_sdus,
+               r.duration_ms,
+               r.throughput_mbps);
+  }
+}
+
+int run_scenarios(const std::vector<uint32_t>& nof_workers, const std::vector<uint32_t>& nof_ues, uint32_t nof_sdus)
+{
+  std::vector<run_data> run_results;
+  for (uint32_t ues : nof_ues) {
+    for (uint32_t workers : nof_workers) {
+      run_params params  = {};
+      params.nof_workers = workers;
+      params.nof_ues     = ues;
+      params.nof_sdus    = nof_sdus;
+      params.window      = 32;
+      TESTASSERT(run_benchmark_scenario(params, run_results) == SRSRAN_SUCCESS);
+    }
+  }
+
+  print_benchmark_results(run_results);
+
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace srsenb
+
+int main(int argc, char* argv[])
+{
+  srslog::fetch_basic_logger("PDCP", false).set_level(srslog::basic_levels::warning);
+  srslog::fetch_basic_logger("RLC", false).set_level(srslog::basic_levels::warning);
+  srslog::fetch_basic_logger("STCK", false).set_level(srslog::basic_levels::warning);
+
+  // Start the log backend.
+  srslog::init();
+
+  srsenb::reserve_rnti_memblocks(32);
+
+  if (argc == 1 or strcmp(argv[1], "test") == 0) {
+    TESTASSERT(srsenb::run_scenarios({1, 2}, {8}, 200) == SRSRAN_SUCCESS);
+  } else {
+    TESTASSERT(srsenb::run_scenarios({1, 2, 4, 8}, {8, 32}, 4000) == SRSRAN_SUCCESS);
+  }
+
+  return 0;
+}